@@ -266,6 +266,12 @@ void RawDelegate::createPlotPath(const QModelIndex &index, const QStyleOptionVie
 
     path.moveTo(path.currentPosition().x(), -(y_base + ((*(listPairs[0].first) - channelMean)*dScaleY)));
 
+    //Zoomed out, a path point per sample would only redraw the same pixel columns
+    if(m_dDx < 0.5) {
+        createDecimatedPlotPath(index, path, listPairs, channelMean, dScaleY, y_base);
+        return;
+    }
+
     //plot all rows from list of pairs
     for(qint8 i=0; i < listPairs.size(); ++i) {
         //create lines from one to the next sample
@@ -289,6 +295,50 @@ void RawDelegate::createPlotPath(const QModelIndex &index, const QStyleOptionVie
 }
 
 
+//*************************************************************************************************************
+
+void RawDelegate::createDecimatedPlotPath(const QModelIndex &index, QPainterPath& path, const QList<RowVectorPair>& listPairs, double channelMean, double dScaleY, double dYBase) const
+{
+    const RawModel* t_rawModel = static_cast<const RawModel*>(index.model());
+
+    qint32 iNumSamples = 0;
+    for(qint8 i=0; i < listPairs.size(); ++i)
+        iNumSamples += listPairs[i].second;
+
+    double x_base = path.currentPosition().x();
+    double dLastY = path.currentPosition().y();
+    double dMin, dMax;
+
+    qint32 iNumColumns = (qint32)ceil(iNumSamples*m_dDx);
+
+    for(qint32 iColumn=0; iColumn < iNumColumns; ++iColumn) {
+        qint32 iFirst = (qint32)(iColumn/m_dDx);
+        qint32 iLast = qMin((qint32)((iColumn+1)/m_dDx), iNumSamples);
+
+        if(iFirst >= iLast)
+            continue;
+
+        t_rawModel->getMinMax(index.row(), iFirst, iLast, dMin, dMax);
+
+        double dYMax = -(dYBase + (dMax - channelMean)*dScaleY);
+        double dYMin = -(dYBase + (dMin - channelMean)*dScaleY);
+        double dX = x_base + iColumn + 0.5;
+
+        //start with the extreme which is closer to the end of the previous column
+        if(qAbs(dLastY - dYMax) < qAbs(dLastY - dYMin)) {
+            path.lineTo(dX, dYMax);
+            path.lineTo(dX, dYMin);
+            dLastY = dYMin;
+        }
+        else {
+            path.lineTo(dX, dYMin);
+            path.lineTo(dX, dYMax);
+            dLastY = dYMax;
+        }
+    }
+}
+
+
 //*************************************************************************************************************
 
 void RawDelegate::createGridPath(QPainterPath& path, const QStyleOptionViewItem &option, QList<RowVectorPair>& listPairs) const
@@ -175,6 +175,20 @@ private:
     */
     void createPlotPath(const QModelIndex &index, const QStyleOptionViewItem &option, QPainterPath& path, QList<RowVectorPair>& listPairs, double channelMean) const;
 
+    //=========================================================================================================
+    /**
+    * createDecimatedPlotPath creates the QPointer path for the data plot when more than two samples fall onto one pixel column.
+    * Each pixel column is drawn as a vertical line between the minimum and maximum of its samples.
+    *
+    * @param[in] index QModelIndex for accessing associated data and model object.
+    * @param[in,out] path The QPointerPath to create for the data plot.
+    * @param[in] listPairs The data of all loaded windows.
+    * @param[in] channelMean The mean which is subtracted from the data.
+    * @param[in] dScaleY Pixels per data unit.
+    * @param[in] dYBase The baseline of the plot.
+    */
+    void createDecimatedPlotPath(const QModelIndex &index, QPainterPath& path, const QList<RowVectorPair>& listPairs, double channelMean, double dScaleY, double dYBase) const;
+
     //=========================================================================================================
     /**
     * createGridPath Creates the QPointer path for the grid plot.
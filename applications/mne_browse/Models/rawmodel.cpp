@@ -54,6 +54,14 @@
 #include <unsupported/Eigen/FFT>
 
 
+//*************************************************************************************************************
+//=============================================================================================================
+// STL INCLUDES
+//=============================================================================================================
+
+#include <limits>
+
+
 //*************************************************************************************************************
 //=============================================================================================================
 // USED NAMESPACES
@@ -73,6 +81,9 @@ RawModel::RawModel(QObject *parent)
 , m_bStartReached(false)
 , m_bEndReached(false)
 , m_bReloading(false)
+, m_iReloadGeneration(0)
+, m_blockCache((qint64)MODEL_CACHE_SIZE*1024*1024)
+, m_iOperatorVersion(0)
 , m_bProcessing(false)
 , m_pFiffInfo(new FiffInfo())
 , m_pfiffIO(QSharedPointer<FiffIO>(new FiffIO()))
@@ -123,6 +134,9 @@ RawModel::RawModel(QFile &qFile, QObject *parent)
 , m_bStartReached(false)
 , m_bEndReached(false)
 , m_bReloading(false)
+, m_iReloadGeneration(0)
+, m_blockCache((qint64)MODEL_CACHE_SIZE*1024*1024)
+, m_iOperatorVersion(0)
 , m_bProcessing(false)
 , m_pFiffInfo(new FiffInfo())
 , m_pfiffIO(QSharedPointer<FiffIO>(new FiffIO()))
@@ -161,6 +175,16 @@ RawModel::RawModel(QFile &qFile, QObject *parent)
 }
 
 
+//*************************************************************************************************************
+
+RawModel::~RawModel()
+{
+    //background-threads still read from the fiff file
+    m_prefetchFutureWatcher.waitForFinished();
+    m_reloadFutureWatcher.waitForFinished();
+}
+
+
 //*************************************************************************************************************
 //virtual functions
 int RawModel::rowCount(const QModelIndex & /*parent*/) const
@@ -205,7 +229,7 @@ QVariant RawModel::data(const QModelIndex &index, int role) const
 
                 for(qint16 i=0; i < m_data.size(); ++i) {
                     //if channel is not filtered or background Processing pending...
-                    if(!m_assignedOperators.contains(index.row()) || (m_bProcessing && m_bReloadBefore && i==0) || (m_bProcessing && !m_bReloadBefore && i==m_data.size()-1)) {
+                    if(showRawData(index.row(), i)) {
                         rowVectorPair.first = m_data[i]->dataRaw().data() + index.row()*m_data[i]->dataRaw().cols();
                         rowVectorPair.second  = m_data[i]->dataRaw().cols();
                     }
@@ -406,6 +430,7 @@ bool RawModel::loadFiffData(QFile* qFile)
 
     //set loaded fiff data
     m_data.append(newDataPackage);
+    m_blockCache.insert(m_iAbsFiffCursor, newDataPackage);
 
     loadFiffInfos();
     genStdFilterOps();
@@ -417,6 +442,8 @@ bool RawModel::loadFiffData(QFile* qFile)
     emit fileLoaded(m_pFiffInfo);
     emit assignedOperatorsChanged(m_assignedOperators);
 
+    prefetch(false);
+
     return true;
 }
 
@@ -496,6 +523,11 @@ void RawModel::loadFiffInfos()
 
 void RawModel::clearModel()
 {
+    //background-threads still read from the fiff file
+    m_prefetchFutureWatcher.waitForFinished();
+    m_reloadFutureWatcher.waitForFinished();
+    m_blockCache.clear();
+
     //FiffIO object
     m_pfiffIO.clear();
     m_chInfolist.clear();
@@ -536,34 +568,45 @@ void RawModel::resetPosition(qint32 position)
 
     m_iAbsFiffCursor = firstSample() + mult*m_iWindowSize;
 
-    MatrixXd t_data,t_times; //type is later on (when append to m_data) casted into MatrixXdR (Row-Major)
-
     int start = m_iAbsFiffCursor;
     int end = start + m_iWindowSize - 1;
 
-    m_Mutex.lock();
-    if(!m_pfiffIO->m_qlistRaw[0]->read_raw_segment(t_data, t_times, start, end))
-        qDebug() << "RawModel: Error resetting position of Fiff file!";
-    m_Mutex.unlock();
+    //take the window from the cache if it was loaded or prefetched before
+    QSharedPointer<DataPackage> newDataPackage = m_blockCache.find(start);
 
-    //build data package
-    QSharedPointer<DataPackage> newDataPackage;
-    newDataPackage = QSharedPointer<DataPackage>(new DataPackage((MatrixXdR)t_data, (MatrixXdR)t_times));
+    if(!newDataPackage) {
+        MatrixXd t_data,t_times; //type is later on (when append to m_data) casted into MatrixXdR (Row-Major)
+
+        m_Mutex.lock();
+        if(!m_pfiffIO->m_qlistRaw[0]->read_raw_segment(t_data, t_times, start, end))
+            qDebug() << "RawModel: Error resetting position of Fiff file!";
+        m_Mutex.unlock();
+
+        //build data package
+        newDataPackage = QSharedPointer<DataPackage>(new DataPackage((MatrixXdR)t_data, (MatrixXdR)t_times));
+        m_blockCache.insert(start, newDataPackage);
+    }
 
     //append loaded block
     m_data.append(newDataPackage);
 
-    if(!m_assignedOperators.empty())
-        updateOperators();
+    //only process the window if its cached processed data is outdated
+    if(!m_assignedOperators.empty() && m_blockCache.procVersion(start) != m_iOperatorVersion) {
+        m_bProcessing = true;
+        updateOperatorsConcurrently(0);
+        m_bProcessing = false;
+    }
 
     endResetModel();
 
 //    if(!(m_iAbsFiffCursor<=firstSample()))
 //        updateScrollPos(m_iCurAbsScrollPos-firstSample()); //little hack: if the m_iCurAbsScrollPos is now close to the edge -> force reloading w/o scrolling
 
-    qDebug() << "RawModel: Model Position RESET, samples from " << m_iAbsFiffCursor << "to" << m_iAbsFiffCursor+m_iWindowSize-1 << "reloaded. actual loaded t_data cols: " << t_data.cols();
+    qDebug() << "RawModel: Model Position RESET, samples from " << m_iAbsFiffCursor << "to" << m_iAbsFiffCursor+m_iWindowSize-1 << "reloaded. actual loaded t_data cols: " << newDataPackage->dataRaw().cols();
 
     emit dataChanged(createIndex(0,1),createIndex(m_chInfolist.size(),1));
+
+    prefetch(false);
 }
 
 
@@ -607,7 +650,16 @@ void RawModel::reloadFiffData(bool before)
         }
     }
 
+    //take the window from the cache if it was loaded or prefetched before
+    QSharedPointer<DataPackage> pCachedPackage = m_blockCache.find(start);
+
+    if(pCachedPackage && pCachedPackage->dataRaw().cols() == end - start + 1) {
+        insertReloadedPackage(pCachedPackage);
+        return;
+    }
+
     m_bReloading = true;
+    m_iReloadGeneration = m_blockCache.generation();
 
     //read data with respect to start and end point
     QFuture<QPair<MatrixXd,MatrixXd> > future = QtConcurrent::run(this,&RawModel::readSegment,start,end);
@@ -626,17 +678,146 @@ QPair<MatrixXd,MatrixXd> RawModel::readSegment(fiff_int_t from, fiff_int_t to)
 {
     QPair<MatrixXd,MatrixXd> datatime;
 
-    m_Mutex.lock();
+    QMutexLocker locker(&m_Mutex);
     if(!m_pfiffIO->m_qlistRaw[0]->read_raw_segment(datatime.first, datatime.second, from, to)) {
         printf("RawModel: Error when reading raw data!");
         return datatime;
     }
-    m_Mutex.unlock();
 
     return datatime;
 }
 
 
+//*************************************************************************************************************
+
+void RawModel::prefetch(bool before)
+{
+    if(!m_bFileloaded || m_prefetchFutureWatcher.isRunning())
+        return;
+
+    //collect the windows in scroll direction which are not cached yet
+    QList<QPair<fiff_int_t,fiff_int_t> > listSegments;
+
+    for(int i = 0; i < MODEL_PREFETCH_WINDOWS; ++i) {
+        fiff_int_t start = before ? m_iAbsFiffCursor - (i+1)*m_iWindowSize : m_iAbsFiffCursor + sizeOfPreloadedData() + i*m_iWindowSize;
+        fiff_int_t end = qMin(start + m_iWindowSize - 1, lastSample());
+
+        if(start < firstSample() || start > lastSample())
+            break;
+
+        if(!m_blockCache.contains(start))
+            listSegments.append(QPair<fiff_int_t,fiff_int_t>(start, end));
+    }
+
+    if(listSegments.isEmpty())
+        return;
+
+    //the operators are passed as a copy, so they can be changed while the background-thread is running
+    QFuture<void> future = QtConcurrent::run(this, &RawModel::prefetchSegments,
+                                             listSegments,
+                                             m_assignedOperators,
+                                             m_iOperatorVersion,
+                                             m_iCurrentFFTLength,
+                                             m_blockCache.generation());
+
+    m_prefetchFutureWatcher.setFuture(future);
+}
+
+
+//*************************************************************************************************************
+
+void RawModel::prefetchSegments(QList<QPair<fiff_int_t,fiff_int_t> > listSegments,
+                                QMap<int,QSharedPointer<MNEOperator> > assignedOperators,
+                                int iProcVersion,
+                                int iFFTLength,
+                                int iGeneration)
+{
+    for(int i = 0; i < listSegments.size(); ++i) {
+        QPair<MatrixXd,MatrixXd> datatime = readSegment(listSegments[i].first, listSegments[i].second);
+
+        if(datatime.first.cols() == 0)
+            return;
+
+        QSharedPointer<DataPackage> newDataPackage = QSharedPointer<DataPackage>(new DataPackage((MatrixXdR)datatime.first, (MatrixXdR)datatime.second));
+
+        int iVersion = -1;
+        if(!assignedOperators.empty()) {
+            processDataPackage(newDataPackage, assignedOperators, iFFTLength);
+            iVersion = iProcVersion;
+        }
+
+        //stop if the cache was cleared in the meantime, e.g. because the projectors changed
+        if(!m_blockCache.insert(listSegments[i].first, newDataPackage, iVersion, iGeneration))
+            return;
+    }
+}
+
+
+//*************************************************************************************************************
+
+void RawModel::processDataPackage(QSharedPointer<DataPackage> pDataPackage,
+                                  const QMap<int,QSharedPointer<MNEOperator> >& assignedOperators,
+                                  int iFFTLength)
+{
+    QList<int> listFilteredChs = assignedOperators.uniqueKeys();
+
+    int dataLength = pDataPackage->dataRaw().cols();
+    int cutFront = iFFTLength/4;
+
+    for(int i = 0; i < listFilteredChs.size(); ++i) {
+        QPair<int,RowVectorXd> chdata(listFilteredChs[i], pDataPackage->dataRawOrig().row(listFilteredChs[i]));
+        applyOperators(chdata, assignedOperators);
+
+        int cutBack = iFFTLength/4 + (chdata.second.cols()-iFFTLength/2-dataLength);
+        pDataPackage->setOrigProcData(chdata.second, chdata.first, cutFront, cutBack);
+    }
+}
+
+
+//*************************************************************************************************************
+
+bool RawModel::showRawData(int row, int windowIndex) const
+{
+    //if channel is not filtered or background Processing pending...
+    return !m_assignedOperators.contains(row) || (m_bProcessing && m_bReloadBefore && windowIndex==0) || (m_bProcessing && !m_bReloadBefore && windowIndex==m_data.size()-1);
+}
+
+
+//*************************************************************************************************************
+
+void RawModel::getMinMax(int row, int iFirst, int iLast, double& dMin, double& dMax) const
+{
+    dMin = std::numeric_limits<double>::max();
+    dMax = -std::numeric_limits<double>::max();
+
+    bool bFound = false;
+    int iOffset = 0;
+    double dPartMin, dPartMax;
+
+    //walk through the windows in the same order as they are returned by data()
+    for(int i = 0; i < m_data.size() && iOffset < iLast; ++i) {
+        bool bRaw = showRawData(row, i);
+        const MatrixXdR& data = bRaw ? m_data[i]->dataRaw() : m_data[i]->dataProc();
+        const DISPLIB::MinMaxPyramid& pyramid = bRaw ? m_data[i]->pyramidRaw() : m_data[i]->pyramidProc();
+        int iCols = data.cols();
+
+        if(iFirst < iOffset + iCols && row < data.rows() && pyramid.cols() == iCols) {
+            pyramid.minMax(data.data() + row*iCols, row, iFirst - iOffset, iLast - iOffset, dPartMin, dPartMax);
+            dMin = qMin(dMin, dPartMin);
+            dMax = qMax(dMax, dPartMax);
+            bFound = true;
+        }
+
+        iOffset += iCols;
+    }
+
+    if(!bFound) {
+        dMin = 0.0;
+        dMax = 0.0;
+    }
+}
+
+
 //*************************************************************************************************************
 //public SLOTS
 void RawModel::updateScrollPos(int value)
@@ -653,12 +834,12 @@ void RawModel::updateScrollPos(int value)
 
     //reload data if end of loaded range is reached and no relaoding is currently active
     //front
-    if(!m_bReloading && (m_iCurAbsScrollPos-m_iAbsFiffCursor < m_reloadPos) && !m_bStartReached) {
+    if(!m_bReloading && !m_bProcessing && (m_iCurAbsScrollPos-m_iAbsFiffCursor < m_reloadPos) && !m_bStartReached) {
         qDebug() << "RawModel: Reload requested at FRONT of loaded fiff data, m_iAbsFiffCursor:" << m_iAbsFiffCursor << "m_iCurAbsScrollPos:" << m_iCurAbsScrollPos;
         reloadFiffData(1);
     }
     //end
-    else if(!m_bReloading && m_iCurAbsScrollPos > m_iAbsFiffCursor+sizeOfPreloadedData()-m_reloadPos && !m_bEndReached) {
+    else if(!m_bReloading && !m_bProcessing && m_iCurAbsScrollPos > m_iAbsFiffCursor+sizeOfPreloadedData()-m_reloadPos && !m_bEndReached) {
         qDebug() << "RawModel: Reload requested at END of loaded fiff data, m_iAbsFiffCursor:" << m_iAbsFiffCursor << "m_iCurAbsScrollPos:" << m_iCurAbsScrollPos;
         reloadFiffData(0);
     }
@@ -715,6 +896,7 @@ void RawModel::applyOperator(QModelIndexList chlist, const QSharedPointer<MNEOpe
         }
     }
 
+    ++m_iOperatorVersion;
     m_bProcessing = true;
 
     for(int i=0; i<m_data.size(); i++)
@@ -753,6 +935,7 @@ void RawModel::applyOperator(QModelIndexList chlist, const QSharedPointer<MNEOpe
         }
     }
 
+    ++m_iOperatorVersion;
     m_bProcessing = true;
 
     for(int i=0; i<m_data.size(); i++)
@@ -772,11 +955,17 @@ void RawModel::applyOperator(QModelIndexList chlist, const QSharedPointer<MNEOpe
 
 void RawModel::applyOperatorsConcurrently(QPair<int,RowVectorXd>& chdata) const
 {
-    QSharedPointer<FilterOperator> filter;
+    applyOperators(chdata, m_assignedOperators);
+}
 
-    //QList<int> listFilteredChs = m_assignedOperators.keys();
 
-    QList<QSharedPointer<MNEOperator> > ops = m_assignedOperators.values(chdata.first);
+//*************************************************************************************************************
+
+void RawModel::applyOperators(QPair<int,RowVectorXd>& chdata, const QMap<int,QSharedPointer<MNEOperator> >& assignedOperators)
+{
+    QSharedPointer<FilterOperator> filter;
+
+    QList<QSharedPointer<MNEOperator> > ops = assignedOperators.values(chdata.first);
     for(qint32 i=0; i < ops.size(); ++i) {
         switch(ops[i]->m_OperatorType) {
         case MNEOperator::FILTER: {
@@ -804,6 +993,7 @@ void RawModel::updateOperators(QModelIndex chan)
         }
     }
 
+    ++m_iOperatorVersion;
     m_bProcessing = true;
 
     for(int i=0; i<m_data.size(); i++)
@@ -832,6 +1022,7 @@ void RawModel::updateOperators(QModelIndexList chlist)
         }
     }
 
+    ++m_iOperatorVersion;
     m_bProcessing = true;
 
     for(int i=0; i<m_data.size(); i++)
@@ -877,6 +1068,8 @@ void RawModel::undoFilter(QModelIndexList chlist, const QSharedPointer<MNEOperat
         }
     }
 
+    ++m_iOperatorVersion;
+
     emit assignedOperatorsChanged(m_assignedOperators);
 }
 
@@ -890,6 +1083,8 @@ void RawModel::undoFilter(QModelIndexList chlist)
         qDebug() << "RawModel: All filter operator removed of type for channel" << chlist[i].row();
     }
 
+    ++m_iOperatorVersion;
+
     emit assignedOperatorsChanged(m_assignedOperators);
 }
 
@@ -907,6 +1102,8 @@ void RawModel::undoFilter(const QString &chType)
                 m_assignedOperators.remove(i);
     }
 
+    ++m_iOperatorVersion;
+
     emit assignedOperatorsChanged(m_assignedOperators);
 }
 
@@ -916,6 +1113,7 @@ void RawModel::undoFilter(const QString &chType)
 void RawModel::undoFilter()
 {
     m_assignedOperators.clear();
+    ++m_iOperatorVersion;
 
     emit assignedOperatorsChanged(m_assignedOperators);
 }
@@ -928,6 +1126,10 @@ void RawModel::updateProjections()
     //  Update the SSP projector
     if(m_pFiffInfo)
     {
+        //the cached windows were read with the old projector
+        m_prefetchFutureWatcher.waitForFinished();
+        m_blockCache.clear();
+
         //If a minimum of one projector is active set m_bProjActivated to true so that this model applies the ssp to the incoming data
         bool bProjActivated = false;
         for(qint32 i = 0; i < this->m_pFiffInfo->projs.size(); ++i) {
@@ -992,6 +1194,10 @@ void RawModel::updateCompensator(int to)
     //
     if(m_pFiffInfo)
     {
+        //the cached windows were read with the old compensator
+        m_prefetchFutureWatcher.waitForFinished();
+        m_blockCache.clear();
+
         FiffCtfComp newComp;
 
         if(to != 0) {
@@ -1022,6 +1228,20 @@ void RawModel::insertReloadedData(QPair<MatrixXd,MatrixXd> dataTimesPair)
 {
     QSharedPointer<DataPackage> newDataPackage = QSharedPointer<DataPackage>(new DataPackage((MatrixXdR)dataTimesPair.first, (MatrixXdR)dataTimesPair.second));
 
+    //keep the window for later, unless the cache was cleared while it was read
+    qint32 iFirstSample = m_bReloadBefore ? m_iAbsFiffCursor : m_iAbsFiffCursor + sizeOfPreloadedData();
+    m_blockCache.insert(iFirstSample, newDataPackage, -1, m_iReloadGeneration);
+
+    insertReloadedPackage(newDataPackage);
+
+    qDebug() << "RawModel: Fiff data Reloaded from " << dataTimesPair.second.coeff(0) << "secs to" << dataTimesPair.second.coeff(dataTimesPair.second.cols()-1) << "secs";
+}
+
+
+//*************************************************************************************************************
+
+void RawModel::insertReloadedPackage(QSharedPointer<DataPackage> newDataPackage)
+{
     //extend m_data with reloaded data
     if(m_bReloadBefore) {
         m_data.prepend(newDataPackage);
@@ -1046,7 +1266,7 @@ void RawModel::insertReloadedData(QPair<MatrixXd,MatrixXd> dataTimesPair)
     emit dataChanged(createIndex(0,1),createIndex(m_chInfolist.size()-1,1));
     emit dataReloaded();
 
-    qDebug() << "RawModel: Fiff data Reloaded from " << dataTimesPair.second.coeff(0) << "secs to" << dataTimesPair.second.coeff(dataTimesPair.second.cols()-1) << "secs";
+    prefetch(m_bReloadBefore);
 }
 
 
@@ -1054,6 +1274,15 @@ void RawModel::insertReloadedData(QPair<MatrixXd,MatrixXd> dataTimesPair)
 
 void RawModel::updateOperatorsConcurrently()
 {
+    //the reloaded window was already processed with the current operators, e.g. by the prefetching
+    int windowIndex = m_bReloadBefore ? 0 : m_data.size()-1;
+
+    if(m_blockCache.procVersion(windowFirstSample(windowIndex)) == m_iOperatorVersion) {
+        performOverlapAdd();
+        emit dataChanged(createIndex(0,1),createIndex(m_chInfolist.size()-1,1));
+        return;
+    }
+
     m_bProcessing = true;
 
     QList<int> listFilteredChs = m_assignedOperators.keys();
@@ -1188,6 +1417,8 @@ void RawModel::insertProcessedDataAll(int windowIndex)
     for(int i=0; i < listFilteredChs.size(); ++i)
         m_data[windowIndex]->setOrigProcData(m_listTmpChData[i].second, listFilteredChs[i], cutFront, cutBack);
 
+    m_blockCache.setProcVersion(windowFirstSample(windowIndex), m_iOperatorVersion);
+
     emit dataChanged(createIndex(0,1),createIndex(m_chInfolist.size(),1));
 
     qDebug() << "RawModel: Finished inserting" << listFilteredChs.size() << "channels in window "<<windowIndex;
@@ -1217,6 +1448,8 @@ void RawModel::insertProcessedDataAll()
             m_data.last()->setOrigProcData(m_listTmpChData[i].second, listFilteredChs[i], cutFront, cutBack);
     }
 
+    m_blockCache.setProcVersion(windowFirstSample(m_bReloadBefore ? 0 : m_data.size()-1), m_iOperatorVersion);
+
     performOverlapAdd();
 
     emit dataChanged(createIndex(0,1),createIndex(m_chInfolist.size(),1));
@@ -75,6 +75,7 @@
 #include "../Utils/filteroperator.h"
 #include "../Utils/rawsettings.h"
 #include "../Utils/datapackage.h"
+#include "../Utils/rawblockcache.h"
 
 
 //*************************************************************************************************************
@@ -151,6 +152,7 @@ class RawModel : public QAbstractTableModel
 public:
     RawModel(QObject *parent);
     RawModel(QFile& qFile, QObject *parent);
+    ~RawModel();
 
     //=========================================================================================================
     /**
@@ -179,6 +181,19 @@ public:
     */
     bool writeFiffData(QIODevice *p_IODevice);
 
+    //=========================================================================================================
+    /**
+    * getMinMax returns the minimum and maximum of a sample range of the displayed data of a channel. The samples are
+    * counted over all loaded windows, in the order of the RowVectorPairs returned by data().
+    *
+    * @param row the channel row
+    * @param iFirst first sample of the range
+    * @param iLast sample after the last sample of the range
+    * @param dMin the minimum
+    * @param dMax the maximum
+    */
+    void getMinMax(int row, int iFirst, int iLast, double& dMin, double& dMax) const;
+
     //VARIABLES
     bool                                        m_bFileloaded;  /**< true when a Fiff file is loaded */
     QList<FiffChInfo>                           m_chInfolist;   /**< List of FiffChInfo objects that holds the corresponding channels information */
@@ -232,6 +247,78 @@ private:
     */
     QPair<MatrixXd,MatrixXd> readSegment(fiff_int_t from, fiff_int_t to);
 
+    //=========================================================================================================
+    /**
+    * prefetch loads the windows following the loaded data in scroll direction into m_blockCache in a background-thread
+    *
+    * @param before whether the windows before (true) or after (false) the loaded data are prefetched
+    */
+    void prefetch(bool before);
+
+    //=========================================================================================================
+    /**
+    * prefetchSegments reads and processes segments of the raw fiff file and stores them in m_blockCache. This method runs in a background-thread.
+    *
+    * @param listSegments the first and last samples of the segments to read
+    * @param assignedOperators the operators which are applied to the segments
+    * @param iProcVersion the operator version of assignedOperators
+    * @param iFFTLength the fft length used by the operators
+    * @param iGeneration the generation of m_blockCache when the prefetch was started
+    */
+    void prefetchSegments(QList<QPair<fiff_int_t,fiff_int_t> > listSegments,
+                          QMap<int,QSharedPointer<MNEOperator> > assignedOperators,
+                          int iProcVersion,
+                          int iFFTLength,
+                          int iGeneration);
+
+    //=========================================================================================================
+    /**
+    * processDataPackage applies the operators to all channels of a window and stores the result as its processed data
+    *
+    * @param pDataPackage the window to process
+    * @param assignedOperators the operators to apply
+    * @param iFFTLength the fft length used by the operators
+    */
+    static void processDataPackage(QSharedPointer<DataPackage> pDataPackage,
+                                   const QMap<int,QSharedPointer<MNEOperator> >& assignedOperators,
+                                   int iFFTLength);
+
+    //=========================================================================================================
+    /**
+    * applyOperators applies the operators assigned to a channel to the channel data in-place
+    *
+    * @param chdata[in,out] represents the channel data as a RowVectorXd
+    * @param assignedOperators the operators assigned to the channels
+    */
+    static void applyOperators(QPair<int, RowVectorXd> &chdata, const QMap<int,QSharedPointer<MNEOperator> >& assignedOperators);
+
+    //=========================================================================================================
+    /**
+    * insertReloadedPackage inserts a reloaded window in front of or after m_data and stores it in m_blockCache
+    *
+    * @param pDataPackage the reloaded window
+    */
+    void insertReloadedPackage(QSharedPointer<DataPackage> pDataPackage);
+
+    //=========================================================================================================
+    /**
+    * windowFirstSample returns the first sample of a window in m_data, which is also its key in m_blockCache
+    *
+    * @param windowIndex the index of the window in m_data
+    * @return the first sample of the window
+    */
+    inline qint32 windowFirstSample(int windowIndex) const;
+
+    //=========================================================================================================
+    /**
+    * showRawData returns whether the raw instead of the processed data of a window is displayed for a channel
+    *
+    * @param row the channel row
+    * @param windowIndex the index of the window in m_data
+    * @return true if the raw data is displayed
+    */
+    bool showRawData(int row, int windowIndex) const;
+
     //VARIABLES
     //Reload control
     bool                                    m_bStartReached;            /**< signals, whether the start of the fiff data file is reached. */
@@ -241,6 +328,12 @@ private:
     //Concurrent reloading
     QFutureWatcher<QPair<MatrixXd,MatrixXd> > m_reloadFutureWatcher;    /**< QFutureWatcher for watching process of reloading fiff data. */
     bool                                    m_bReloading;               /**< signals when the reloading is ongoing. */
+    int                                     m_iReloadGeneration;        /**< the generation of m_blockCache when the ongoing reloading was started. */
+
+    //Block cache
+    RawBlockCache                           m_blockCache;               /**< LRU cache of loaded and prefetched windows, keyed by their first sample. */
+    QFutureWatcher<void>                    m_prefetchFutureWatcher;    /**< QFutureWatcher for watching process of prefetching fiff data. */
+    int                                     m_iOperatorVersion;         /**< increased whenever the assigned operators change, cached processed data of older versions is recomputed. */
 
     //Concurrent processing
 //    QFutureWatcher<QPair<int,RowVectorXd> > m_operatorFutureWatcher; /**< QFutureWatcher for watching process of applying Operators to reloaded fiff data. */
@@ -566,6 +659,13 @@ inline qint32 RawModel::absFiffCursor() const {
     return m_iAbsFiffCursor;
 }
 
+
+//*************************************************************************************************************
+
+inline qint32 RawModel::windowFirstSample(int windowIndex) const {
+    return m_iAbsFiffCursor + windowIndex*m_iWindowSize;
+}
+
 } // NAMESPACE
 
 #endif // RAWMODEL_H
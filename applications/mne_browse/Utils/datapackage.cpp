@@ -78,6 +78,8 @@ DataPackage::DataPackage(const MatrixXdR &originalRawData, const MatrixXdR &orig
     //Init mean data
     m_dataRawMean = calculateMatMean(m_dataRawMapped);
     m_dataProcMean = calculateMatMean(m_dataProcMapped);
+
+    m_pyramidProc.build(m_dataProcMapped);
 }
 
 
@@ -99,6 +101,8 @@ void DataPackage::setOrigRawData(const MatrixXdR &originalRawData, int cutFront,
 
     //Calculate mean
     m_dataRawMean = calculateMatMean(m_dataRawMapped);
+
+    m_pyramidRaw.build(m_dataRawMapped);
 }
 
 
@@ -125,6 +129,8 @@ void DataPackage::setOrigRawData(const RowVectorXd &originalRawData, int row, in
 
     //Calculate mean
     m_dataRawMean(row) = calculateRowMean(m_dataRawMapped.row(row));
+
+    m_pyramidRaw.updateRow(m_dataRawMapped.data() + row*m_dataRawMapped.cols(), row, 0, m_dataRawMapped.cols());
 }
 
 
@@ -146,6 +152,8 @@ void DataPackage::setOrigProcData(const MatrixXdR &originalProcData, int cutFron
 
     //Calculate mean
     m_dataProcMean = calculateMatMean(m_dataProcMapped);
+
+    m_pyramidProc.build(m_dataProcMapped);
 }
 
 
@@ -164,6 +172,8 @@ void DataPackage::setMappedProcData(const MatrixXdR &originalProcData, int cutFr
 
     //Calculate mean
     m_dataProcMean = calculateMatMean(m_dataProcMapped);
+
+    m_pyramidProc.build(m_dataProcMapped);
 }
 
 
@@ -190,6 +200,8 @@ void DataPackage::setOrigProcData(const RowVectorXd &originalProcData, int row,
 
     //Calculate mean
     m_dataProcMean(row) = calculateRowMean(m_dataProcMapped.row(row));
+
+    m_pyramidProc.updateRow(m_dataProcMapped.data() + row*m_dataProcMapped.cols(), row, 0, m_dataProcMapped.cols());
 }
 
 
@@ -213,6 +225,8 @@ void DataPackage::setMappedProcData(const RowVectorXd &originalProcData, int row
 
     //Calculate mean
     m_dataProcMean(row) = calculateRowMean(m_dataProcMapped.row(row));
+
+    m_pyramidProc.updateRow(m_dataProcMapped.data() + row*m_dataProcMapped.cols(), row, 0, m_dataProcMapped.cols());
 }
 
 //*************************************************************************************************************
@@ -247,6 +261,22 @@ const MatrixXdR & DataPackage::dataProc()
 }
 
 
+//*************************************************************************************************************
+
+const DISPLIB::MinMaxPyramid & DataPackage::pyramidRaw()
+{
+    return m_pyramidRaw;
+}
+
+
+//*************************************************************************************************************
+
+const DISPLIB::MinMaxPyramid & DataPackage::pyramidProc()
+{
+    return m_pyramidProc;
+}
+
+
 //*************************************************************************************************************
 
 double DataPackage::dataProcMean(int row)
@@ -269,6 +299,21 @@ double DataPackage::dataRawMean(int row)
 }
 
 
+//*************************************************************************************************************
+
+qint64 DataPackage::memorySize() const
+{
+    qint64 iNumValues = m_timeRawMapped.size() + m_timeRawOriginal.size()
+                        + m_dataRawMapped.size() + m_dataRawOriginal.size() + m_dataRawMean.size()
+                        + m_dataProcMapped.size() + m_dataProcOriginal.size() + m_dataProcMean.size();
+
+    //The float pyramids hold a quarter of the samples of their mapped data as min and max values
+    qint64 iNumPyramidBytes = (m_dataRawMapped.size() + m_dataProcMapped.size()) * 2;
+
+    return iNumValues * (qint64)sizeof(double) + iNumPyramidBytes;
+}
+
+
 //*************************************************************************************************************
 
 void DataPackage::applyFFTFilter(int channelNumber, QSharedPointer<FilterOperator> filter, bool useRawData)
@@ -288,6 +333,8 @@ void DataPackage::applyFFTFilter(int channelNumber, QSharedPointer<FilterOperato
 
     //Calculate mean
     m_dataProcMean(channelNumber) = calculateRowMean(m_dataProcMapped);
+
+    m_pyramidProc.updateRow(m_dataProcMapped.data() + channelNumber*m_dataProcMapped.cols(), channelNumber, 0, m_dataProcMapped.cols());
 }
 
 
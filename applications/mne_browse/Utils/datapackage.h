@@ -45,6 +45,8 @@
 #include "filteroperator.h"
 #include "types.h"
 
+#include <disp/viewers/helpers/minmaxpyramid.h>
+
 
 //*************************************************************************************************************
 //=============================================================================================================
@@ -195,6 +197,22 @@ public:
     */
     const MatrixXdR & dataProc();
 
+    //=========================================================================================================
+    /**
+    * Returns the min/max pyramid of the mapped raw data.
+    *
+    * @return the pyramid
+    */
+    const DISPLIB::MinMaxPyramid & pyramidRaw();
+
+    //=========================================================================================================
+    /**
+    * Returns the min/max pyramid of the mapped processed data.
+    *
+    * @return the pyramid
+    */
+    const DISPLIB::MinMaxPyramid & pyramidProc();
+
     //=========================================================================================================
     /**
     * Returns the mean of the processed mapped data.
@@ -213,6 +231,15 @@ public:
     */
     double dataRawMean(int row);
 
+    //=========================================================================================================
+    /**
+    * Returns the approximate number of bytes held by this package, i.e. the original and mapped raw, processed
+    * and time data together with the min/max pyramids.
+    *
+    * @return the size in bytes
+    */
+    qint64 memorySize() const;
+
     //=========================================================================================================
     /**
     * FilterOperator::FilterOperator
@@ -271,11 +298,13 @@ private:
     MatrixXdR   m_dataRawMapped;        /**< The mapped/cut raw data */
     MatrixXdR   m_dataRawOriginal;      /**< The original raw data */
     VectorXd    m_dataRawMean;          /**< The mean of the mapped/cut raw data */
+    DISPLIB::MinMaxPyramid m_pyramidRaw;    /**< The min/max pyramid of the mapped/cut raw data */
 
     //Processed data
     MatrixXdR   m_dataProcOriginal;     /**< The mapped/cut processed/filtered data */
     MatrixXdR   m_dataProcMapped;       /**< The original processed/filtered data */
     VectorXd    m_dataProcMean;         /**< The mean of the mapped/cut processed/filtered data */
+    DISPLIB::MinMaxPyramid m_pyramidProc;   /**< The min/max pyramid of the mapped/cut processed/filtered data */
 
     //Cutting parameters
     int m_iCutFrontRaw;                 /**< The last used cut front value of the raw data */
@@ -0,0 +1,230 @@
+//=============================================================================================================
+/**
+* @file     rawblockcache.cpp
+* @author   agent <agent@local>
+* @version  1.0
+* @date     October, 2026
+*
+* @section  LICENSE
+*
+* Copyright (C) 2026, agent. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+*
+* @brief    Definition of the RawBlockCache Class.
+*
+*/
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "rawblockcache.h"
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QMutexLocker>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// USED NAMESPACES
+//=============================================================================================================
+
+using namespace MNEBROWSE;
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE MEMBER METHODS
+//=============================================================================================================
+
+RawBlockCache::RawBlockCache(qint64 iMemoryBudget)
+: m_iMemoryBudget(iMemoryBudget)
+, m_iMemoryUsage(0)
+, m_iGeneration(0)
+{
+}
+
+
+//*************************************************************************************************************
+
+void RawBlockCache::setMemoryBudget(qint64 iMemoryBudget)
+{
+    QMutexLocker locker(&m_mutex);
+
+    m_iMemoryBudget = iMemoryBudget;
+    evict();
+}
+
+
+//*************************************************************************************************************
+
+bool RawBlockCache::insert(qint32 iFirstSample,
+                           const QSharedPointer<DataPackage>& pDataPackage,
+                           int iProcVersion,
+                           int iGeneration)
+{
+    if(!pDataPackage) {
+        return false;
+    }
+
+    QMutexLocker locker(&m_mutex);
+
+    if(iGeneration >= 0 && iGeneration != m_iGeneration) {
+        return false;
+    }
+
+    if(m_hashEntries.contains(iFirstSample)) {
+        m_iMemoryUsage -= m_hashEntries[iFirstSample].iMemorySize;
+        m_lUsage.removeOne(iFirstSample);
+    }
+
+    CacheEntry entry;
+    entry.pDataPackage = pDataPackage;
+    entry.iProcVersion = iProcVersion;
+    entry.iMemorySize = pDataPackage->memorySize();
+
+    m_hashEntries.insert(iFirstSample, entry);
+    m_lUsage.prepend(iFirstSample);
+    m_iMemoryUsage += entry.iMemorySize;
+
+    evict();
+
+    return true;
+}
+
+
+//*************************************************************************************************************
+
+QSharedPointer<DataPackage> RawBlockCache::find(qint32 iFirstSample)
+{
+    QMutexLocker locker(&m_mutex);
+
+    QHash<qint32, CacheEntry>::const_iterator it = m_hashEntries.constFind(iFirstSample);
+
+    if(it == m_hashEntries.constEnd()) {
+        return QSharedPointer<DataPackage>();
+    }
+
+    if(m_lUsage.first() != iFirstSample) {
+        m_lUsage.removeOne(iFirstSample);
+        m_lUsage.prepend(iFirstSample);
+    }
+
+    return it.value().pDataPackage;
+}
+
+
+//*************************************************************************************************************
+
+bool RawBlockCache::contains(qint32 iFirstSample) const
+{
+    QMutexLocker locker(&m_mutex);
+
+    return m_hashEntries.contains(iFirstSample);
+}
+
+
+//*************************************************************************************************************
+
+int RawBlockCache::procVersion(qint32 iFirstSample) const
+{
+    QMutexLocker locker(&m_mutex);
+
+    QHash<qint32, CacheEntry>::const_iterator it = m_hashEntries.constFind(iFirstSample);
+
+    return it == m_hashEntries.constEnd() ? -1 : it.value().iProcVersion;
+}
+
+
+//*************************************************************************************************************
+
+void RawBlockCache::setProcVersion(qint32 iFirstSample, int iProcVersion)
+{
+    QMutexLocker locker(&m_mutex);
+
+    QHash<qint32, CacheEntry>::iterator it = m_hashEntries.find(iFirstSample);
+
+    if(it != m_hashEntries.end()) {
+        it.value().iProcVersion = iProcVersion;
+    }
+}
+
+
+//*************************************************************************************************************
+
+void RawBlockCache::clear()
+{
+    QMutexLocker locker(&m_mutex);
+
+    m_hashEntries.clear();
+    m_lUsage.clear();
+    m_iMemoryUsage = 0;
+    ++m_iGeneration;
+}
+
+
+//*************************************************************************************************************
+
+int RawBlockCache::generation() const
+{
+    QMutexLocker locker(&m_mutex);
+
+    return m_iGeneration;
+}
+
+
+//*************************************************************************************************************
+
+qint64 RawBlockCache::memoryUsage() const
+{
+    QMutexLocker locker(&m_mutex);
+
+    return m_iMemoryUsage;
+}
+
+
+//*************************************************************************************************************
+
+int RawBlockCache::size() const
+{
+    QMutexLocker locker(&m_mutex);
+
+    return m_hashEntries.size();
+}
+
+
+//*************************************************************************************************************
+
+void RawBlockCache::evict()
+{
+    while(m_iMemoryUsage > m_iMemoryBudget && m_lUsage.size() > 1) {
+        qint32 iFirstSample = m_lUsage.takeLast();
+
+        m_iMemoryUsage -= m_hashEntries.value(iFirstSample).iMemorySize;
+        m_hashEntries.remove(iFirstSample);
+    }
+}
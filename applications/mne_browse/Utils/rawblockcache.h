@@ -0,0 +1,209 @@
+//=============================================================================================================
+/**
+* @file     rawblockcache.h
+* @author   agent <agent@local>
+* @version  1.0
+* @date     October, 2026
+*
+* @section  LICENSE
+*
+* Copyright (C) 2026, agent. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+*
+* @brief    Declaration of the RawBlockCache Class.
+*
+*/
+
+#ifndef RAWBLOCKCACHE_H
+#define RAWBLOCKCACHE_H
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "datapackage.h"
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QHash>
+#include <QLinkedList>
+#include <QMutex>
+#include <QSharedPointer>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE NAMESPACE MNEBROWSE
+//=============================================================================================================
+
+namespace MNEBROWSE
+{
+
+
+//=============================================================================================================
+/**
+* RawBlockCache keeps recently loaded data windows of the RawModel, keyed by their first sample. Windows are
+* evicted in least recently used order as soon as their summed size exceeds the memory budget. Each window
+* remembers the operator version its processed data was computed with, so filtered results can be reused as
+* long as the assigned operators did not change. All methods are thread safe, so windows can be prefetched
+* in a background thread.
+*
+* @brief The RawBlockCache class is a LRU cache of data windows limited by a memory budget.
+*/
+class RawBlockCache
+{
+public:
+    typedef QSharedPointer<RawBlockCache> SPtr;              /**< Shared pointer type for RawBlockCache. */
+    typedef QSharedPointer<const RawBlockCache> ConstSPtr;   /**< Const shared pointer type for RawBlockCache. */
+
+    //=========================================================================================================
+    /**
+    * Constructs a RawBlockCache.
+    *
+    * @param [in] iMemoryBudget     The maximum number of bytes held by the cached windows.
+    */
+    explicit RawBlockCache(qint64 iMemoryBudget = 0);
+
+    //=========================================================================================================
+    /**
+    * Sets the memory budget and evicts windows until it is met.
+    *
+    * @param [in] iMemoryBudget     The maximum number of bytes held by the cached windows.
+    */
+    void setMemoryBudget(qint64 iMemoryBudget);
+
+    //=========================================================================================================
+    /**
+    * Inserts a window or replaces the window with the same first sample. The window is rejected if the cache
+    * was cleared since iGeneration was queried, which drops windows read before a projector or compensator
+    * change.
+    *
+    * @param [in] iFirstSample      The first sample of the window.
+    * @param [in] pDataPackage      The window data.
+    * @param [in] iProcVersion      The operator version the processed data was computed with, -1 if not processed.
+    * @param [in] iGeneration       The generation the window was read in, -1 to skip the check.
+    *
+    * @return true if the window was inserted.
+    */
+    bool insert(qint32 iFirstSample,
+                const QSharedPointer<DataPackage>& pDataPackage,
+                int iProcVersion = -1,
+                int iGeneration = -1);
+
+    //=========================================================================================================
+    /**
+    * Returns the window starting at iFirstSample and marks it as most recently used.
+    *
+    * @param [in] iFirstSample      The first sample of the window.
+    *
+    * @return the window, a null pointer if it is not cached.
+    */
+    QSharedPointer<DataPackage> find(qint32 iFirstSample);
+
+    //=========================================================================================================
+    /**
+    * Returns whether the window starting at iFirstSample is cached.
+    *
+    * @param [in] iFirstSample      The first sample of the window.
+    *
+    * @return true if the window is cached.
+    */
+    bool contains(qint32 iFirstSample) const;
+
+    //=========================================================================================================
+    /**
+    * Returns the operator version the processed data of a window was computed with.
+    *
+    * @param [in] iFirstSample      The first sample of the window.
+    *
+    * @return the operator version, -1 if the window is not cached or not processed.
+    */
+    int procVersion(qint32 iFirstSample) const;
+
+    //=========================================================================================================
+    /**
+    * Stores the operator version the processed data of a cached window was computed with.
+    *
+    * @param [in] iFirstSample      The first sample of the window.
+    * @param [in] iProcVersion      The operator version.
+    */
+    void setProcVersion(qint32 iFirstSample, int iProcVersion);
+
+    //=========================================================================================================
+    /**
+    * Removes all windows and starts a new generation.
+    */
+    void clear();
+
+    //=========================================================================================================
+    /**
+    * Returns the current generation, which is increased by every call to clear().
+    *
+    * @return the generation.
+    */
+    int generation() const;
+
+    //=========================================================================================================
+    /**
+    * Returns the number of bytes held by the cached windows.
+    *
+    * @return the memory usage in bytes.
+    */
+    qint64 memoryUsage() const;
+
+    //=========================================================================================================
+    /**
+    * Returns the number of cached windows.
+    *
+    * @return the number of windows.
+    */
+    int size() const;
+
+private:
+    //=========================================================================================================
+    /**
+    * Evicts least recently used windows until the memory budget is met. The most recently used window is
+    * always kept. The mutex must be locked by the caller.
+    */
+    void evict();
+
+    struct CacheEntry {
+        QSharedPointer<DataPackage>     pDataPackage;   /**< The window data. */
+        int                             iProcVersion;   /**< The operator version of the processed data, -1 if not processed. */
+        qint64                          iMemorySize;    /**< The size of the window in bytes. */
+    };
+
+    mutable QMutex                  m_mutex;            /**< Guards all members. */
+    QHash<qint32, CacheEntry>       m_hashEntries;      /**< The cached windows, keyed by their first sample. */
+    QLinkedList<qint32>             m_lUsage;           /**< The first samples of the cached windows, most recently used first. */
+    qint64                          m_iMemoryBudget;    /**< The maximum number of bytes held by the cached windows. */
+    qint64                          m_iMemoryUsage;     /**< The number of bytes held by the cached windows. */
+    int                             m_iGeneration;      /**< The generation, increased by every call to clear(). */
+};
+
+} // NAMESPACE
+
+#endif // RAWBLOCKCACHE_H
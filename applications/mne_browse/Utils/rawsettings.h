@@ -82,6 +82,8 @@
 #define MODEL_MAX_WINDOWS 3 //number of windows that are at maximum remained in m_data
 #define MODEL_NUM_FILTER_TAPS 80 //number of filter taps, required to take into account because of FFT convolution (zero padding)
 #define MODEL_MAX_NUM_FILTER_TAPS 0 //number of maximal filter taps
+#define MODEL_CACHE_SIZE 512 //memory budget of the cache holding loaded and prefetched windows [in MB]
+#define MODEL_PREFETCH_WINDOWS 2 //number of windows which are prefetched in scroll direction
 
 //RawDelegate
 //Look
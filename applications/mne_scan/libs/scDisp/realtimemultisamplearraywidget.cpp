@@ -95,6 +95,7 @@ RealTimeMultiSampleArrayWidget::RealTimeMultiSampleArrayWidget(QSharedPointer<Re
 , m_pRTMSA(pRTMSA)
 , m_bInitialized(false)
 , m_iMaxFilterTapSize(0)
+, m_iTraceStage(BlockTracer::instance()->registerStage(QString("Display %1").arg(pRTMSA->getName())))
 {
     Q_UNUSED(pTime)
 
@@ -159,17 +160,21 @@ RealTimeMultiSampleArrayWidget::~RealTimeMultiSampleArrayWidget()
 
 void RealTimeMultiSampleArrayWidget::update(SCMEASLIB::Measurement::SPtr)
 {
+    if(BlockTracer::instance()->isEnabled()) {
+        BlockTracer::instance()->record(m_iTraceStage, BlockTracer::Display, m_pRTMSA->getBlockHeader(), BlockTracer::timestamp());
+    }
+
     if(!m_bInitialized) {
         if(m_pRTMSA->isChInit()) {
             m_pFiffInfo = m_pRTMSA->info();
 
-            m_iMaxFilterTapSize = m_pRTMSA->getMultiSampleArray().at(m_pRTMSA->getMultiSampleArray().size()-1).cols();
+            m_iMaxFilterTapSize = m_pRTMSA->getSampleBlocks().last()->cols();
 
             init();
         }
     } else {
         //Add data to table view
-        m_pChannelDataView->addData(m_pRTMSA->getMultiSampleArray());
+        m_pChannelDataView->addData(m_pRTMSA->getSampleBlocks());
     }
 }
 
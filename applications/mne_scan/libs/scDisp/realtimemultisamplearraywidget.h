@@ -187,6 +187,7 @@ private:
 
     bool                                                    m_bInitialized;                 /**< Is Initialized */
     qint32                                                  m_iMaxFilterTapSize;            /**< Maximum number of allowed filter taps. This number depends on the size of the receiving blocks. */
+    quint32                                                 m_iTraceStage;                  /**< The BlockTracer stage id of this display. */
  };
 
 } // NAMESPACE SCDISPLIB
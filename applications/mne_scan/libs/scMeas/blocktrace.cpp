@@ -0,0 +1,628 @@
+//=============================================================================================================
+/**
+* @file     blocktrace.cpp
+* @author   agent <agent@local>
+* @version  1.0
+* @date     October, 2026
+*
+* @section  LICENSE
+*
+* Copyright (C) 2026, agent. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+*
+* @brief    Definition of the BlockTracer Class.
+*
+*/
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "blocktrace.h"
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// Qt INCLUDES
+//=============================================================================================================
+
+#include <QElapsedTimer>
+#include <QFile>
+#include <QDataStream>
+#include <QTextStream>
+#include <QSet>
+#include <QDebug>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// STL INCLUDES
+//=============================================================================================================
+
+#include <algorithm>
+#include <cstring>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// USED NAMESPACES
+//=============================================================================================================
+
+using namespace SCMEASLIB;
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE GLOBAL METHODS
+//=============================================================================================================
+
+namespace
+{
+
+const char      g_sMagic[8] = {'M','N','E','B','T','R','C','1'};   /**< Binary trace file magic. */
+const int       g_iBufferCapacity = 65536;                          /**< Events kept per thread. */
+const int       g_iRetiredCapacity = 4 * g_iBufferCapacity;         /**< Events kept of finished threads. */
+const int       g_iMaxQueuedHeaders = 1024;                         /**< Headers kept per BlockTraceStage. */
+
+bool eventLessThan(const BlockTraceEvent& a, const BlockTraceEvent& b)
+{
+    return a.iTimestampNs < b.iTimestampNs;
+}
+
+const char* phaseName(quint8 iPhase)
+{
+    switch(iPhase) {
+        case BlockTracer::Produce:  return "produce";
+        case BlockTracer::Emit:     return "emit";
+        case BlockTracer::Enqueue:  return "enqueue";
+        case BlockTracer::Dequeue:  return "dequeue";
+        case BlockTracer::Process:  return "process";
+        case BlockTracer::Display:  return "display";
+        default:                    return "unknown";
+    }
+}
+
+QString usec(qint64 iNs)
+{
+    return QString::number(double(iNs) / 1000.0, 'f', 3);
+}
+
+QString escaped(const QString& sText)
+{
+    QString sResult = sText;
+    sResult.replace("\\", "\\\\");
+    sResult.replace("\"", "\\\"");
+    return sResult;
+}
+
+}
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE NAMESPACE SCMEASLIB
+//=============================================================================================================
+
+namespace SCMEASLIB
+{
+
+//=============================================================================================================
+/**
+* DECLARE CLASS BlockTraceBuffer
+*
+* @brief The BlockTraceBuffer class is the ring buffer of one recording thread. When the thread finishes the
+*        buffer hands its events over to the tracer.
+*/
+class BlockTraceBuffer
+{
+public:
+    BlockTraceBuffer(BlockTracer* pTracer, quint16 iThread)
+    : m_pTracer(pTracer)
+    , m_iThread(iThread)
+    , m_iNext(0)
+    {
+        m_vecEvents.resize(g_iBufferCapacity);
+    }
+
+    ~BlockTraceBuffer()
+    {
+        QVector<BlockTraceEvent> vecEvents;
+        copyTo(vecEvents);
+
+        QMutexLocker locker(&m_pTracer->m_mutex);
+        m_pTracer->m_lBuffers.removeAll(this);
+        m_pTracer->retire(vecEvents);
+    }
+
+    inline void append(BlockTraceEvent& event)
+    {
+        event.iThread = m_iThread;
+
+        QMutexLocker locker(&m_mutex);
+        m_vecEvents[int(m_iNext % g_iBufferCapacity)] = event;
+        ++m_iNext;
+    }
+
+    void copyTo(QVector<BlockTraceEvent>& vecEvents)
+    {
+        QMutexLocker locker(&m_mutex);
+
+        quint64 iCount = qMin(m_iNext, quint64(g_iBufferCapacity));
+        for(quint64 i = m_iNext - iCount; i < m_iNext; ++i) {
+            vecEvents.append(m_vecEvents.at(int(i % g_iBufferCapacity)));
+        }
+    }
+
+    void clear()
+    {
+        QMutexLocker locker(&m_mutex);
+        m_iNext = 0;
+    }
+
+private:
+    BlockTracer*                m_pTracer;      /**< The owning tracer. */
+    quint16                     m_iThread;      /**< The id of the recording thread. */
+    QMutex                      m_mutex;        /**< Uncontended except while the tracer collects. */
+    QVector<BlockTraceEvent>    m_vecEvents;    /**< The ring buffer. */
+    quint64                     m_iNext;        /**< Total number of appended events. */
+};
+
+} // NAMESPACE
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE MEMBER METHODS
+//=============================================================================================================
+
+BlockTracer::BlockTracer()
+: m_iEnabled(0)
+, m_iNextBlockId(0)
+, m_iNextThreadId(0)
+, m_iRetiredNext(0)
+{
+    QString sFile = QString::fromLocal8Bit(qgetenv("MNE_SCAN_BLOCK_TRACE"));
+
+    if(!sFile.isEmpty()) {
+        m_sOutputFile = sFile;
+        m_iEnabled.store(1);
+    }
+}
+
+
+//*************************************************************************************************************
+
+BlockTracer* BlockTracer::instance()
+{
+    // Intentionally leaked, per-thread buffers may hand over their events during application shutdown
+    static BlockTracer* pTracer = new BlockTracer;
+    return pTracer;
+}
+
+
+//*************************************************************************************************************
+
+qint64 BlockTracer::timestamp()
+{
+    static QElapsedTimer timer;
+    static bool bStarted = (timer.start(), true);
+    Q_UNUSED(bStarted);
+
+    return timer.nsecsElapsed();
+}
+
+
+//*************************************************************************************************************
+
+void BlockTracer::setEnabled(bool bEnabled)
+{
+    m_iEnabled.store(bEnabled ? 1 : 0);
+}
+
+
+//*************************************************************************************************************
+
+void BlockTracer::setOutputFile(const QString& sFilePath)
+{
+    QMutexLocker locker(&m_mutex);
+    m_sOutputFile = sFilePath;
+}
+
+
+//*************************************************************************************************************
+
+QString BlockTracer::getOutputFile() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_sOutputFile;
+}
+
+
+//*************************************************************************************************************
+
+BlockHeader BlockTracer::createHeader()
+{
+    BlockHeader header;
+
+    if(isEnabled()) {
+        header.iBlockId = m_iNextBlockId.fetchAndAddRelaxed(1) + 1;
+        header.iOriginNs = timestamp();
+    }
+
+    return header;
+}
+
+
+//*************************************************************************************************************
+
+quint32 BlockTracer::registerStage(const QString& sStage)
+{
+    QMutexLocker locker(&m_mutex);
+
+    int iStage = m_lStages.indexOf(sStage);
+
+    if(iStage < 0) {
+        m_lStages.append(sStage);
+        iStage = m_lStages.size() - 1;
+    }
+
+    return quint32(iStage);
+}
+
+
+//*************************************************************************************************************
+
+void BlockTracer::record(quint32 iStage,
+                         Phase phase,
+                         const BlockHeader& header,
+                         qint64 iStartNs,
+                         qint64 iDurationNs)
+{
+    if(!isEnabled() || !header.isValid()) {
+        return;
+    }
+
+    BlockTraceEvent event;
+    event.iTimestampNs = iStartNs;
+    event.iDurationNs = iDurationNs;
+    event.iOriginNs = header.iOriginNs;
+    event.iBlockId = header.iBlockId;
+    event.iStage = iStage;
+    event.iThread = 0;
+    event.iPhase = quint8(phase);
+    event.iReserved = 0;
+
+    threadBuffer()->append(event);
+}
+
+
+//*************************************************************************************************************
+
+void BlockTracer::record(const QString& sStage,
+                         Phase phase,
+                         const BlockHeader& header)
+{
+    if(!isEnabled() || !header.isValid()) {
+        return;
+    }
+
+    record(registerStage(sStage), phase, header, timestamp());
+}
+
+
+//*************************************************************************************************************
+
+void BlockTracer::clear()
+{
+    QMutexLocker locker(&m_mutex);
+
+    for(int i = 0; i < m_lBuffers.size(); ++i) {
+        m_lBuffers.at(i)->clear();
+    }
+
+    m_vecRetired.clear();
+    m_iRetiredNext = 0;
+}
+
+
+//*************************************************************************************************************
+
+bool BlockTracer::save()
+{
+    QString sFile = getOutputFile();
+
+    if(sFile.isEmpty()) {
+        return false;
+    }
+
+    return writeBinary(sFile);
+}
+
+
+//*************************************************************************************************************
+
+bool BlockTracer::writeBinary(const QString& sFilePath)
+{
+    QVector<BlockTraceEvent> vecEvents = collect();
+
+    QStringList lStages;
+    {
+        QMutexLocker locker(&m_mutex);
+        lStages = m_lStages;
+    }
+
+    QFile file(sFilePath);
+    if(!file.open(QIODevice::WriteOnly)) {
+        qWarning() << "BlockTracer::writeBinary - Could not open" << sFilePath;
+        return false;
+    }
+
+    QDataStream stream(&file);
+    stream.setByteOrder(QDataStream::LittleEndian);
+
+    stream.writeRawData(g_sMagic, sizeof(g_sMagic));
+    stream << quint32(sizeof(BlockTraceEvent));
+    stream << lStages;
+    stream << quint64(vecEvents.size());
+
+    // Events are written in native layout, the file is meant to be converted on the acquisition machine
+    stream.writeRawData(reinterpret_cast<const char*>(vecEvents.constData()), vecEvents.size() * int(sizeof(BlockTraceEvent)));
+
+    return stream.status() == QDataStream::Ok;
+}
+
+
+//*************************************************************************************************************
+
+bool BlockTracer::convertToChromeTrace(const QString& sBinaryPath,
+                                       const QString& sJsonPath)
+{
+    QFile fileIn(sBinaryPath);
+    if(!fileIn.open(QIODevice::ReadOnly)) {
+        qWarning() << "BlockTracer::convertToChromeTrace - Could not open" << sBinaryPath;
+        return false;
+    }
+
+    QDataStream streamIn(&fileIn);
+    streamIn.setByteOrder(QDataStream::LittleEndian);
+
+    char sMagic[8];
+    quint32 iEventSize = 0;
+    QStringList lStages;
+    quint64 iNumEvents = 0;
+
+    if(streamIn.readRawData(sMagic, sizeof(sMagic)) != int(sizeof(sMagic)) || memcmp(sMagic, g_sMagic, sizeof(sMagic)) != 0) {
+        qWarning() << "BlockTracer::convertToChromeTrace -" << sBinaryPath << "is not a block trace file";
+        return false;
+    }
+
+    streamIn >> iEventSize >> lStages >> iNumEvents;
+
+    if(iEventSize != sizeof(BlockTraceEvent)) {
+        qWarning() << "BlockTracer::convertToChromeTrace - Event layout of" << sBinaryPath << "does not match";
+        return false;
+    }
+
+    QVector<BlockTraceEvent> vecEvents(int(iNumEvents));
+    if(streamIn.readRawData(reinterpret_cast<char*>(vecEvents.data()), vecEvents.size() * int(sizeof(BlockTraceEvent))) != vecEvents.size() * int(sizeof(BlockTraceEvent))) {
+        qWarning() << "BlockTracer::convertToChromeTrace - Unexpected end of" << sBinaryPath;
+        return false;
+    }
+
+    QFile fileOut(sJsonPath);
+    if(!fileOut.open(QIODevice::WriteOnly | QIODevice::Text)) {
+        qWarning() << "BlockTracer::convertToChromeTrace - Could not open" << sJsonPath;
+        return false;
+    }
+
+    QTextStream out(&fileOut);
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+
+    QSet<quint16> setThreads;
+    bool bFirst = true;
+
+    for(int i = 0; i < vecEvents.size(); ++i) {
+        const BlockTraceEvent& event = vecEvents.at(i);
+        QString sStage = event.iStage < quint32(lStages.size()) ? escaped(lStages.at(int(event.iStage))) : QString("stage %1").arg(event.iStage);
+        QString sCommon = QString("\"pid\":1,\"tid\":%1,\"ts\":%2").arg(event.iThread).arg(usec(event.iTimestampNs));
+        QString sArgs = QString("\"args\":{\"block\":%1,\"age_ms\":%2}").arg(event.iBlockId).arg(double(event.iTimestampNs - event.iOriginNs) / 1.0e6, 0, 'f', 3);
+
+        if(!setThreads.contains(event.iThread)) {
+            setThreads.insert(event.iThread);
+            out << (bFirst ? "" : ",\n")
+                << QString("{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%1,\"args\":{\"name\":\"Thread %1\"}}").arg(event.iThread);
+            bFirst = false;
+        }
+
+        out << (bFirst ? "" : ",\n");
+        bFirst = false;
+
+        if(event.iPhase == Process) {
+            out << QString("{\"name\":\"%1\",\"cat\":\"process\",\"ph\":\"X\",%2,\"dur\":%3,%4}").arg(sStage).arg(sCommon).arg(usec(event.iDurationNs)).arg(sArgs);
+        } else {
+            out << QString("{\"name\":\"%1 %2\",\"cat\":\"%2\",\"ph\":\"i\",\"s\":\"t\",%3,%4}").arg(sStage).arg(phaseName(event.iPhase)).arg(sCommon).arg(sArgs);
+        }
+
+        // Link the time a block waited in the queue of a stage
+        if(event.iPhase == Enqueue || event.iPhase == Dequeue) {
+            out << ",\n"
+                << QString("{\"name\":\"%1 queue\",\"cat\":\"queue\",\"ph\":\"%2\",%3\"id\":\"%4:%5\",%6}")
+                   .arg(sStage)
+                   .arg(event.iPhase == Enqueue ? "s" : "f")
+                   .arg(event.iPhase == Enqueue ? "" : "\"bp\":\"e\",")
+                   .arg(event.iBlockId)
+                   .arg(event.iStage)
+                   .arg(sCommon);
+        }
+    }
+
+    out << "\n]}\n";
+    out.flush();
+
+    return out.status() == QTextStream::Ok;
+}
+
+
+//*************************************************************************************************************
+
+BlockTraceBuffer* BlockTracer::threadBuffer()
+{
+    if(!m_threadBuffers.hasLocalData()) {
+        BlockTraceBuffer* pBuffer = new BlockTraceBuffer(this, quint16(m_iNextThreadId.fetchAndAddRelaxed(1)));
+
+        QMutexLocker locker(&m_mutex);
+        m_lBuffers.append(pBuffer);
+        locker.unlock();
+
+        m_threadBuffers.setLocalData(pBuffer);
+    }
+
+    return m_threadBuffers.localData();
+}
+
+
+//*************************************************************************************************************
+
+QVector<BlockTraceEvent> BlockTracer::collect()
+{
+    QVector<BlockTraceEvent> vecEvents;
+
+    {
+        QMutexLocker locker(&m_mutex);
+
+        quint64 iCount = qMin(m_iRetiredNext, quint64(g_iRetiredCapacity));
+        for(quint64 i = m_iRetiredNext - iCount; i < m_iRetiredNext; ++i) {
+            vecEvents.append(m_vecRetired.at(int(i % g_iRetiredCapacity)));
+        }
+
+        for(int i = 0; i < m_lBuffers.size(); ++i) {
+            m_lBuffers.at(i)->copyTo(vecEvents);
+        }
+    }
+
+    std::stable_sort(vecEvents.begin(), vecEvents.end(), eventLessThan);
+
+    return vecEvents;
+}
+
+
+//*************************************************************************************************************
+
+void BlockTracer::retire(const QVector<BlockTraceEvent>& vecEvents)
+{
+    if(m_vecRetired.isEmpty() && !vecEvents.isEmpty()) {
+        m_vecRetired.resize(g_iRetiredCapacity);
+    }
+
+    for(int i = 0; i < vecEvents.size(); ++i) {
+        m_vecRetired[int(m_iRetiredNext % g_iRetiredCapacity)] = vecEvents.at(i);
+        ++m_iRetiredNext;
+    }
+}
+
+
+//*************************************************************************************************************
+
+BlockTraceStage::BlockTraceStage(const QString& sStage)
+: m_iStage(BlockTracer::instance()->registerStage(sStage))
+, m_iDequeueNs(0)
+{
+}
+
+
+//*************************************************************************************************************
+
+void BlockTraceStage::enqueue(const BlockHeader& header,
+                              const void* pKey)
+{
+    BlockTracer* pTracer = BlockTracer::instance();
+
+    if(!pTracer->isEnabled() || !header.isValid()) {
+        return;
+    }
+
+    pTracer->record(m_iStage, BlockTracer::Enqueue, header, BlockTracer::timestamp());
+
+    if(!pKey) {
+        return;
+    }
+
+    QMutexLocker locker(&m_mutex);
+
+    // Data which the plugin dropped without processing it is never dequeued
+    if(m_hashQueued.size() >= g_iMaxQueuedHeaders) {
+        m_hashQueued.clear();
+    }
+
+    m_hashQueued.insert(pKey, header);
+}
+
+
+//*************************************************************************************************************
+
+BlockHeader BlockTraceStage::take(const void* pKey)
+{
+    if(!BlockTracer::instance()->isEnabled()) {
+        return BlockHeader();
+    }
+
+    QMutexLocker locker(&m_mutex);
+    return m_hashQueued.take(pKey);
+}
+
+
+//*************************************************************************************************************
+
+void BlockTraceStage::dequeue(const BlockHeader& header)
+{
+    BlockTracer* pTracer = BlockTracer::instance();
+
+    if(!pTracer->isEnabled() || !header.isValid()) {
+        return;
+    }
+
+    m_iDequeueNs = BlockTracer::timestamp();
+    pTracer->record(m_iStage, BlockTracer::Dequeue, header, m_iDequeueNs);
+}
+
+
+//*************************************************************************************************************
+
+void BlockTraceStage::processed(const BlockHeader& header)
+{
+    BlockTracer* pTracer = BlockTracer::instance();
+
+    if(!pTracer->isEnabled() || !header.isValid()) {
+        return;
+    }
+
+    pTracer->record(m_iStage, BlockTracer::Process, header, m_iDequeueNs, BlockTracer::timestamp() - m_iDequeueNs);
+}
+
+
+//*************************************************************************************************************
+
+void BlockTraceStage::clear()
+{
+    QMutexLocker locker(&m_mutex);
+    m_hashQueued.clear();
+}
@@ -0,0 +1,408 @@
+//=============================================================================================================
+/**
+* @file     blocktrace.h
+* @author   agent <agent@local>
+* @version  1.0
+* @date     October, 2026
+*
+* @section  LICENSE
+*
+* Copyright (C) 2026, agent. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+*
+* @brief    Declaration of the BlockTracer Class.
+*
+*/
+
+#ifndef BLOCKTRACE_H
+#define BLOCKTRACE_H
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "scmeas_global.h"
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// Qt INCLUDES
+//=============================================================================================================
+
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <QList>
+#include <QHash>
+#include <QMutex>
+#include <QAtomicInt>
+#include <QThreadStorage>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE NAMESPACE SCMEASLIB
+//=============================================================================================================
+
+namespace SCMEASLIB
+{
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// SCMEASLIB FORWARD DECLARATIONS
+//=============================================================================================================
+
+class BlockTraceBuffer;
+
+
+//=============================================================================================================
+/**
+* The BlockHeader travels with a data block through the mne_scan pipeline. It identifies the block and stores
+* the time at which the block entered the pipeline, so every stage can report the age of the block.
+*/
+struct SCMEASSHARED_EXPORT BlockHeader
+{
+    BlockHeader()
+    : iBlockId(0)
+    , iOriginNs(0)
+    {}
+
+    inline bool isValid() const
+    {
+        return iBlockId != 0;
+    }
+
+    quint64     iBlockId;       /**< Unique id of the block, 0 if the block is not traced. */
+    qint64      iOriginNs;      /**< Time stamp in ns at which the block was produced, see BlockTracer::timestamp(). */
+};
+
+
+//=============================================================================================================
+/**
+* A single trace record. Plain data, so records can be written to disk as is.
+*/
+struct BlockTraceEvent
+{
+    qint64      iTimestampNs;   /**< Start of the event in ns. */
+    qint64      iDurationNs;    /**< Duration of the event in ns, 0 for instant events. */
+    qint64      iOriginNs;      /**< Origin time stamp of the block in ns. */
+    quint64     iBlockId;       /**< Id of the block. */
+    quint32     iStage;         /**< Stage id, see BlockTracer::registerStage(). */
+    quint16     iThread;        /**< Id of the recording thread. */
+    quint8      iPhase;         /**< The BlockTracer::Phase. */
+    quint8      iReserved;      /**< Padding. */
+};
+
+
+//=============================================================================================================
+/**
+* DECLARE CLASS BlockTracer
+*
+* @brief The BlockTracer class records the path of data blocks through the mne_scan pipeline. Stages record
+*        when a block is produced, emitted, queued, dequeued, processed and displayed. Records are kept in
+*        per-thread ring buffers and are written to a compact binary file, which can be converted to the
+*        Chrome trace event format (chrome://tracing, Perfetto UI).
+*/
+class SCMEASSHARED_EXPORT BlockTracer
+{
+    friend class BlockTraceBuffer;
+
+public:
+    //=========================================================================================================
+    /**
+    * Trace phases.
+    */
+    enum Phase
+    {
+        Produce = 0,    /**< The block entered the pipeline, usually in a sensor plugin. */
+        Emit,           /**< The block was handed to the output connector of a plugin. */
+        Enqueue,        /**< The block was queued for processing by a plugin. */
+        Dequeue,        /**< The block was taken from the queue of a plugin. */
+        Process,        /**< The block was processed by a plugin (duration event). */
+        Display         /**< The block reached a display widget. */
+    };
+
+    //=========================================================================================================
+    /**
+    * Returns the tracer of the running mne_scan instance. Tracing is enabled on first use if the environment
+    * variable MNE_SCAN_BLOCK_TRACE holds the path of the trace file to write.
+    *
+    * @return the tracer.
+    */
+    static BlockTracer* instance();
+
+    //=========================================================================================================
+    /**
+    * Returns a monotonic time stamp in ns.
+    *
+    * @return the time stamp.
+    */
+    static qint64 timestamp();
+
+    //=========================================================================================================
+    /**
+    * Enables or disables recording.
+    *
+    * @param [in] bEnabled      whether to record.
+    */
+    void setEnabled(bool bEnabled);
+
+    //=========================================================================================================
+    /**
+    * Returns whether recording is enabled. Cheap enough to guard every call site.
+    *
+    * @return true if enabled.
+    */
+    inline bool isEnabled() const;
+
+    //=========================================================================================================
+    /**
+    * Sets the file save() writes to.
+    *
+    * @param [in] sFilePath     the binary trace file.
+    */
+    void setOutputFile(const QString& sFilePath);
+
+    //=========================================================================================================
+    /**
+    * Returns the file save() writes to.
+    *
+    * @return the binary trace file.
+    */
+    QString getOutputFile() const;
+
+    //=========================================================================================================
+    /**
+    * Creates the header of a new block, stamped with the current time.
+    *
+    * @return the new header.
+    */
+    BlockHeader createHeader();
+
+    //=========================================================================================================
+    /**
+    * Returns the id of a stage name, registering it if needed.
+    *
+    * @param [in] sStage        the stage name, e.g. the plugin name.
+    *
+    * @return the stage id.
+    */
+    quint32 registerStage(const QString& sStage);
+
+    //=========================================================================================================
+    /**
+    * Records an event. Does nothing if the tracer is disabled or the header is invalid.
+    *
+    * @param [in] iStage        the stage id.
+    * @param [in] phase         the phase.
+    * @param [in] header        the block header.
+    * @param [in] iStartNs      the start of the event, see timestamp().
+    * @param [in] iDurationNs   the duration of the event, 0 for instant events.
+    */
+    void record(quint32 iStage,
+                Phase phase,
+                const BlockHeader& header,
+                qint64 iStartNs,
+                qint64 iDurationNs = 0);
+
+    //=========================================================================================================
+    /**
+    * Convenience overload which looks up the stage by name and stamps the event with the current time.
+    *
+    * @param [in] sStage        the stage name.
+    * @param [in] phase         the phase.
+    * @param [in] header        the block header.
+    */
+    void record(const QString& sStage,
+                Phase phase,
+                const BlockHeader& header);
+
+    //=========================================================================================================
+    /**
+    * Discards all recorded events.
+    */
+    void clear();
+
+    //=========================================================================================================
+    /**
+    * Writes all recorded events to the output file. Does nothing if no output file is set.
+    *
+    * @return true if successful, false otherwise.
+    */
+    bool save();
+
+    //=========================================================================================================
+    /**
+    * Writes all recorded events to a binary trace file.
+    *
+    * @param [in] sFilePath     the binary trace file.
+    *
+    * @return true if successful, false otherwise.
+    */
+    bool writeBinary(const QString& sFilePath);
+
+    //=========================================================================================================
+    /**
+    * Converts a binary trace file to a Chrome trace event JSON file. Process phases become complete
+    * events, the other phases instant events. Enqueue/Dequeue pairs are linked by flow events, so the
+    * viewer draws an arrow for every queue a block waited in.
+    *
+    * @param [in] sBinaryPath   the binary trace file.
+    * @param [in] sJsonPath     the JSON file to write.
+    *
+    * @return true if successful, false otherwise.
+    */
+    static bool convertToChromeTrace(const QString& sBinaryPath,
+                                     const QString& sJsonPath);
+
+private:
+    //=========================================================================================================
+    /**
+    * Constructs a BlockTracer.
+    */
+    BlockTracer();
+
+    //=========================================================================================================
+    /**
+    * Returns the ring buffer of the calling thread.
+    *
+    * @return the buffer.
+    */
+    BlockTraceBuffer* threadBuffer();
+
+    //=========================================================================================================
+    /**
+    * Collects the events of all buffers sorted by time.
+    *
+    * @return the events.
+    */
+    QVector<BlockTraceEvent> collect();
+
+    //=========================================================================================================
+    /**
+    * Keeps the events of a finished thread. Only the most recent events are kept, older ones are overwritten.
+    * The caller must hold m_mutex.
+    *
+    * @param [in] vecEvents     the events of the finished thread.
+    */
+    void retire(const QVector<BlockTraceEvent>& vecEvents);
+
+    QAtomicInt                          m_iEnabled;         /**< Whether recording is enabled. */
+    QAtomicInteger<quint64>             m_iNextBlockId;     /**< The id of the next block. */
+    QAtomicInt                          m_iNextThreadId;    /**< The id of the next recording thread. */
+
+    mutable QMutex                      m_mutex;            /**< Guards stages, buffers and retired events. */
+    QString                             m_sOutputFile;      /**< The file save() writes to. */
+    QStringList                         m_lStages;          /**< The registered stage names. */
+    QList<BlockTraceBuffer*>            m_lBuffers;         /**< The buffers of the live threads. */
+    QVector<BlockTraceEvent>            m_vecRetired;       /**< Ring buffer of the events of threads which already finished. */
+    quint64                             m_iRetiredNext;     /**< Total number of retired events. */
+    QThreadStorage<BlockTraceBuffer*>   m_threadBuffers;    /**< Per-thread buffer, deleted by Qt on thread exit. */
+};
+
+
+//=============================================================================================================
+/**
+* DECLARE CLASS BlockTraceStage
+*
+* @brief The BlockTraceStage class records the Enqueue, Dequeue and Process events of a plugin which runs its own
+*        processing thread instead of posting its blocks to a PluginBlockHandler. The header of an input block can
+*        be kept together with a key of the queued data, usually the address of the shared sample block, and taken
+*        back when the thread processes the data. The plugin then forwards the header to its output measurement,
+*        so the block keeps its id.
+*/
+class SCMEASSHARED_EXPORT BlockTraceStage
+{
+public:
+    //=========================================================================================================
+    /**
+    * Constructs a BlockTraceStage.
+    *
+    * @param [in] sStage        the stage name, usually the plugin name.
+    */
+    explicit BlockTraceStage(const QString& sStage);
+
+    //=========================================================================================================
+    /**
+    * Records the Enqueue event of a block. If a key is given the header is kept until it is taken by take().
+    *
+    * @param [in] header        the header of the block.
+    * @param [in] pKey          the key of the queued data, Q_NULLPTR if the plugin keeps the header itself.
+    */
+    void enqueue(const BlockHeader& header,
+                 const void* pKey = Q_NULLPTR);
+
+    //=========================================================================================================
+    /**
+    * Takes the header which was kept for queued data.
+    *
+    * @param [in] pKey          the key of the queued data.
+    *
+    * @return the header of the block, invalid if the data was not traced.
+    */
+    BlockHeader take(const void* pKey);
+
+    //=========================================================================================================
+    /**
+    * Records the Dequeue event of a block and starts its Process event, see processed().
+    *
+    * @param [in] header        the header of the block.
+    */
+    void dequeue(const BlockHeader& header);
+
+    //=========================================================================================================
+    /**
+    * Records the Process event of a block, from the last dequeue() on.
+    *
+    * @param [in] header        the header of the block.
+    */
+    void processed(const BlockHeader& header);
+
+    //=========================================================================================================
+    /**
+    * Forgets all queued headers, e.g. when the plugin clears its buffer.
+    */
+    void clear();
+
+private:
+    quint32                             m_iStage;           /**< The BlockTracer stage id. */
+    qint64                              m_iDequeueNs;       /**< Time of the last dequeue(), only used by the processing thread. */
+    QMutex                              m_mutex;            /**< Guards the queued headers. */
+    QHash<const void*, BlockHeader>     m_hashQueued;       /**< The headers of the queued data. */
+};
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INLINE DEFINITIONS
+//=============================================================================================================
+
+inline bool BlockTracer::isEnabled() const
+{
+    return m_iEnabled.load() != 0;
+}
+
+} // NAMESPACE
+
+#endif // BLOCKTRACE_H
@@ -42,6 +42,7 @@
 //=============================================================================================================
 
 #include "scmeas_global.h"
+#include "blocktrace.h"
 
 
 //*************************************************************************************************************
@@ -142,6 +143,23 @@ public:
     */
     inline QList<QSharedPointer<QWidget> > getControlWidgets();
 
+    //=========================================================================================================
+    /**
+    * Returns the header of the current data block. Used to trace blocks through the pipeline.
+    *
+    * @return the block header, invalid if the block is not traced.
+    */
+    inline BlockHeader getBlockHeader() const;
+
+    //=========================================================================================================
+    /**
+    * Sets the header of the current data block. Algorithm plugins forward the header of their input block
+    * before they set the value of their output measurement, so the block keeps its id and origin time.
+    *
+    * @param[in] header     the block header.
+    */
+    inline void setBlockHeader(const BlockHeader& header);
+
 signals:
     void notify();
 
@@ -160,6 +178,7 @@ private:
     QString                             m_qString_Name;     /**< Name of the Measurement */
     bool                                m_bVisibility;      /**< Visibility status */
     QList<QSharedPointer<QWidget> >     m_lControlWidgets;  /**< The control widgets, which should be added to the corresponding real-time visualization. */
+    BlockHeader                         m_blockHeader;      /**< Header of the current data block */
 
 };
 
@@ -238,6 +257,24 @@ inline QList<QSharedPointer<QWidget> > Measurement::getControlWidgets()
     return m_lControlWidgets;
 }
 
+
+//*************************************************************************************************************
+
+inline BlockHeader Measurement::getBlockHeader() const
+{
+    QMutexLocker locker(&m_qMutex);
+    return m_blockHeader;
+}
+
+
+//*************************************************************************************************************
+
+inline void Measurement::setBlockHeader(const BlockHeader& header)
+{
+    QMutexLocker locker(&m_qMutex);
+    m_blockHeader = header;
+}
+
 } //NAMESPACE
 
 Q_DECLARE_METATYPE(SCMEASLIB::Measurement::SPtr)
@@ -68,6 +68,7 @@ RealTimeMultiSampleArray::RealTimeMultiSampleArray(QObject *parent)
 : Measurement(QMetaType::type("RealTimeMultiSampleArray::SPtr"), parent)
 , m_dSamplingRate(0)
 , m_iMultiArraySize(10)
+, m_bSamplesValid(true)
 , m_bChInfoIsInit(false)
 {
     m_slDisplayFlag << "compensators" << "projections" << "filter" << "view" << "triggerdetection" << "scaling" << "sphara" << "colors";
@@ -243,29 +244,48 @@ void RealTimeMultiSampleArray::setValue(const MatrixXd& mat)
     if(!m_bChInfoIsInit)
         return;
 
+    //The only copy of the data on its way through the pipeline
+    setValue(SampleBlock(new MatrixXd(mat)));
+}
+
+
+//*************************************************************************************************************
+
+void RealTimeMultiSampleArray::setValue(const SampleBlock& block)
+{
+    if(!m_bChInfoIsInit || !block)
+        return;
+
     m_qMutex.lock();
     //check vector size
-    if(mat.rows() != m_qListChInfo.size())
+    if(block->rows() != m_qListChInfo.size())
         qCritical() << "Error Occured in RealTimeMultiSampleArrayNew::setVector: Vector size does not match the number of channels! ";
 
-    //ToDo
-//    //Check if maximum exceeded //ToDo speed this up
-//    for(qint32 i = 0; i < v.size(); ++i)
-//    {
-//        if(v[i] < m_qListChInfo[i].getMinValue()) v[i] = m_qListChInfo[i].getMinValue();
-//        else if(v[i] > m_qListChInfo[i].getMaxValue()) v[i] = m_qListChInfo[i].getMaxValue();
-//    }
-
     //Store
-    m_matSamples.push_back(mat);
+    m_lSampleBlocks.push_back(block);
+    m_bSamplesValid = false;
+    bool bNotify = m_lSampleBlocks.size() >= m_iMultiArraySize;
 
     m_qMutex.unlock();
-    if(m_matSamples.size() >= m_iMultiArraySize)
+    if(bNotify)
     {
+        //A block without a forwarded header enters the pipeline here
+        BlockTracer* pTracer = BlockTracer::instance();
+        if(pTracer->isEnabled() && !getBlockHeader().isValid()) {
+            BlockHeader header = pTracer->createHeader();
+            setBlockHeader(header);
+            pTracer->record(getName(), BlockTracer::Produce, header);
+        }
+
+        //All connected inputs receive the same shared blocks, nothing is copied here
         emit notify();
         m_qMutex.lock();
+        m_lSampleBlocks.clear();
         m_matSamples.clear();
+        m_bSamplesValid = true;
         m_qMutex.unlock();
+
+        setBlockHeader(BlockHeader());
     }
 }
 
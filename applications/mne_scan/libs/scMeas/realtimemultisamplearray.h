@@ -78,6 +78,14 @@ namespace SCMEASLIB
 using namespace FIFFLIB;
 
 
+//*************************************************************************************************************
+//=============================================================================================================
+// TYPEDEFS
+//=============================================================================================================
+
+typedef QSharedPointer<const Eigen::MatrixXd> SampleBlock;     /**< Immutable, reference counted sample block which is shared between all connected inputs and displays. */
+
+
 //=========================================================================================================
 /**
 * DECLARE CLASS RealTimeMultiSampleArray -> ToDo check feasibilty of QAbstractTableModel
@@ -227,16 +235,34 @@ public:
     *
     * @return the current multi sample array.
     */
-    inline const QList< MatrixXd >& getMultiSampleArray();
+    inline QList< MatrixXd > getMultiSampleArray();
 
     //=========================================================================================================
     /**
-    * Attaches a value to the sample array list.
+    * Returns the gathered sample blocks. The blocks are shared with every connected input and must not be
+    * modified. A consumer which needs to alter the data has to copy the block first (copy-on-write).
+    * The list is returned by value, the next setValue() may replace the list as soon as the lock is released.
+    *
+    * @return a copy of the current list of shared sample blocks.
+    */
+    inline QList<SampleBlock> getSampleBlocks() const;
+
+    //=========================================================================================================
+    /**
+    * Attaches a value to the sample array list. The matrix is copied once into a shared sample block.
     *
     * @param [in] mat   the value which is attached to the sample array list.
     */
     virtual void setValue(const MatrixXd& mat);
 
+    //=========================================================================================================
+    /**
+    * Attaches an already shared sample block to the sample array list without copying the data.
+    *
+    * @param [in] block     the shared block which is attached to the sample array list.
+    */
+    void setValue(const SampleBlock& block);
+
 private:
     mutable QMutex              m_qMutex;           /**< Mutex to ensure thread safety */
 
@@ -246,7 +272,9 @@ private:
     QString                     m_sXMLLayoutFile;   /**< Layout file name. */
     double                      m_dSamplingRate;    /**< Sampling rate of the RealTimeSampleArray.*/
     qint32                      m_iMultiArraySize;  /**< Sample size of the multi sample array.*/
-    QList<MatrixXd>             m_matSamples;       /**< The multi sample array.*/
+    QList<SampleBlock>          m_lSampleBlocks;    /**< The shared sample blocks of the multi sample array.*/
+    QList<MatrixXd>             m_matSamples;       /**< Materialized copy of the sample blocks, only built on demand by getMultiSampleArray().*/
+    bool                        m_bSamplesValid;    /**< Whether m_matSamples reflects the current sample blocks.*/
     bool                        m_bChInfoIsInit;    /**< If channel info is initialized.*/
 
     QList<RealTimeSampleArrayChInfo> m_qListChInfo; /**< Channel info list.*/
@@ -261,7 +289,9 @@ private:
 inline void RealTimeMultiSampleArray::clear()
 {
     QMutexLocker locker(&m_qMutex);
+    m_lSampleBlocks.clear();
     m_matSamples.clear();
+    m_bSamplesValid = true;
 }
 
 
@@ -379,11 +409,31 @@ qint32 RealTimeMultiSampleArray::getMultiArraySize() const
 
 //*************************************************************************************************************
 
-inline const QList< MatrixXd >& RealTimeMultiSampleArray::getMultiSampleArray()
+inline QList< MatrixXd > RealTimeMultiSampleArray::getMultiSampleArray()
 {
+    QMutexLocker locker(&m_qMutex);
+    //Legacy consumers get a deep copy, which is built at most once per notify
+    if(!m_bSamplesValid) {
+        m_matSamples.clear();
+        m_matSamples.reserve(m_lSampleBlocks.size());
+        for(int i = 0; i < m_lSampleBlocks.size(); ++i) {
+            m_matSamples.append(*m_lSampleBlocks.at(i));
+        }
+        m_bSamplesValid = true;
+    }
+
     return m_matSamples;
 }
 
+
+//*************************************************************************************************************
+
+inline QList<SampleBlock> RealTimeMultiSampleArray::getSampleBlocks() const
+{
+    QMutexLocker locker(&m_qMutex);
+    return m_lSampleBlocks;
+}
+
 } // NAMESPACE
 
 Q_DECLARE_METATYPE(SCMEASLIB::RealTimeMultiSampleArray::SPtr)
@@ -156,9 +156,10 @@ protected:
     /**
     * The starting point for the thread. After calling start(), the newly created thread calls this function.
     * Returning from this method will end the execution of the thread.
-    * Pure virtual method inherited by QThread
+    * Algorithms which execute their blocks on the PluginScheduler do not run a thread loop and keep this
+    * empty default.
     */
-    virtual void run() = 0;
+    virtual inline void run();
 };
 
 //*************************************************************************************************************
@@ -171,6 +172,13 @@ inline bool IAlgorithm::multiInstanceAllowed() const
     return true;
 }
 
+
+//*************************************************************************************************************
+
+inline void IAlgorithm::run()
+{
+}
+
 } // NAMESPACE
 
 Q_DECLARE_INTERFACE(SCSHAREDLIB::IAlgorithm, "scsharedlib/1.0")
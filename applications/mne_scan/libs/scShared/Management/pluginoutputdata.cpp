@@ -73,6 +73,7 @@ namespace SCSHAREDLIB
 template <class T>
 PluginOutputData<T>::PluginOutputData(IPlugin *parent, const QString &name, const QString &descr)
 : PluginOutputConnector(parent, name, descr)
+, m_iTraceStage(SCMEASLIB::BlockTracer::instance()->registerStage(name))
 {
     m_pMeasurement = QSharedPointer<T>(new T);
 
@@ -90,7 +91,13 @@ PluginOutputData<T>::PluginOutputData(IPlugin *parent, const QString &name, cons
 template <class T>
 void PluginOutputData<T>::update()
 {
-    emit notify(qSharedPointerDynamicCast<SCMEASLIB::Measurement>(m_pMeasurement));
+    QSharedPointer<SCMEASLIB::Measurement> pMeasurement = qSharedPointerDynamicCast<SCMEASLIB::Measurement>(m_pMeasurement);
+
+    if(SCMEASLIB::BlockTracer::instance()->isEnabled()) {
+        SCMEASLIB::BlockTracer::instance()->record(m_iTraceStage, SCMEASLIB::BlockTracer::Emit, pMeasurement->getBlockHeader(), SCMEASLIB::BlockTracer::timestamp());
+    }
+
+    emit notify(pMeasurement);
 }
 
 }//Namespace
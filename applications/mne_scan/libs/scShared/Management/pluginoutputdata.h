@@ -115,6 +115,7 @@ public:
 
 private:
     QSharedPointer<T> m_pMeasurement;
+    quint32 m_iTraceStage;      /**< The BlockTracer stage id of this connector. */
 };
 
 //*************************************************************************************************************
@@ -39,6 +39,9 @@
 //=============================================================================================================
 
 #include "pluginscenemanager.h"
+#include "pluginscheduler.h"
+
+#include <scMeas/blocktrace.h>
 
 
 //*************************************************************************************************************
@@ -47,6 +50,7 @@
 //=============================================================================================================
 
 using namespace SCSHAREDLIB;
+using namespace SCMEASLIB;
 
 
 //*************************************************************************************************************
@@ -135,6 +139,9 @@ bool PluginSceneManager::removePlugin(const IPlugin::SPtr pPlugin)
 
 bool PluginSceneManager::startPlugins()
 {
+    // Plugins which post their blocks to the shared scheduler need the worker pool up before data arrives
+    PluginScheduler::instance()->start();
+
     // Start ISensor and IRTAlgorithm plugins first!
     bool bFlag = startSensorPlugins();
 
@@ -211,6 +218,15 @@ void PluginSceneManager::stopPlugins()
         if((*it)->getType() != IPlugin::_ISensor)
             if(!(*it)->stop())
                 qWarning() << "Could not stop IPlugin: " << (*it)->getName();
+
+    // Plugins unregistered their block handlers on stop, the remaining tasks are executed before the pool shuts down
+    PluginScheduler::instance()->stop();
+
+    // Write the block latency trace, if enabled via MNE_SCAN_BLOCK_TRACE
+    BlockTracer* pTracer = BlockTracer::instance();
+    if(pTracer->isEnabled() && pTracer->save()) {
+        BlockTracer::convertToChromeTrace(pTracer->getOutputFile(), pTracer->getOutputFile() + ".json");
+    }
 }
 
 
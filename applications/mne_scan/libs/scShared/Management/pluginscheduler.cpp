@@ -0,0 +1,585 @@
+//=============================================================================================================
+/**
+* @file     pluginscheduler.cpp
+* @author   agent <agent@local>
+* @version  1.0
+* @date     October, 2026
+*
+* @section  LICENSE
+*
+* Copyright (C) 2026, agent. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+*
+* @brief    Definition of the PluginScheduler Class.
+*
+*/
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "pluginscheduler.h"
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QThread>
+#include <QDebug>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// USED NAMESPACES
+//=============================================================================================================
+
+using namespace SCSHAREDLIB;
+using namespace SCMEASLIB;
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE NAMESPACE SCSHAREDLIB
+//=============================================================================================================
+
+namespace SCSHAREDLIB
+{
+
+//=============================================================================================================
+/**
+* DECLARE CLASS PluginSchedulerWorker
+*
+* @brief The PluginSchedulerWorker class is a worker thread of the PluginScheduler pool.
+*/
+class PluginSchedulerWorker : public QThread
+{
+    friend class PluginScheduler;
+
+public:
+    PluginSchedulerWorker(PluginScheduler* pScheduler, int iIndex)
+    : m_pScheduler(pScheduler)
+    , m_iIndex(iIndex)
+    , m_iNestingDepth(0)
+    {
+    }
+
+protected:
+    virtual void run()
+    {
+        PluginScheduler::Task task;
+
+        while(true) {
+            if(m_pScheduler->takeTask(m_iIndex, task)) {
+                task();
+                task = PluginScheduler::Task();
+                continue;
+            }
+
+            QMutexLocker locker(&m_pScheduler->m_mutexState);
+
+            if(m_pScheduler->m_iPending.load() > 0) {
+                continue;
+            }
+
+            if(!m_pScheduler->m_bRunning) {
+                break;
+            }
+
+            m_pScheduler->m_condWork.wait(&m_pScheduler->m_mutexState);
+        }
+    }
+
+private:
+    PluginScheduler*    m_pScheduler;   /**< The owning scheduler. */
+    int                 m_iIndex;       /**< The index of the worker and its task deque. */
+    int                 m_iNestingDepth; /**< The number of nested runPendingTask() calls, only touched by this thread. */
+};
+
+} // NAMESPACE
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE MEMBER METHODS
+//=============================================================================================================
+
+PluginBlockHandler::PluginBlockHandler(PluginScheduler* pScheduler,
+                                       const QString& sName,
+                                       int iCapacity,
+                                       BackpressurePolicy policy)
+: m_pScheduler(pScheduler)
+, m_sName(sName)
+, m_iCapacity(qMax(1, iCapacity))
+, m_iBatchSize(4)
+, m_policy(policy)
+, m_iTraceStage(BlockTracer::instance()->registerStage(sName))
+, m_bScheduled(false)
+, m_bClosed(false)
+, m_iDropped(0)
+{
+}
+
+
+//*************************************************************************************************************
+
+PluginBlockHandler::~PluginBlockHandler()
+{
+}
+
+
+//*************************************************************************************************************
+
+bool PluginBlockHandler::post(const Block &block,
+                              const BlockHeader &header)
+{
+    return enqueue(block, header, true);
+}
+
+
+//*************************************************************************************************************
+
+bool PluginBlockHandler::tryPost(const Block &block,
+                                 const BlockHeader &header)
+{
+    return enqueue(block, header, false);
+}
+
+
+//*************************************************************************************************************
+
+void PluginBlockHandler::flush()
+{
+    if(m_pScheduler->currentWorker() >= 0) {
+        // At the nesting limit the worker only waits for the other workers to drain the queue
+        while(getQueueSize() > 0) {
+            if(!m_pScheduler->canRunPendingTask() || !m_pScheduler->runPendingTask()) {
+                QThread::yieldCurrentThread();
+            }
+        }
+        return;
+    }
+
+    QMutexLocker locker(&m_mutex);
+
+    while(m_bScheduled || !m_queueBlocks.isEmpty()) {
+        m_condIdle.wait(&m_mutex);
+    }
+}
+
+
+//*************************************************************************************************************
+
+void PluginBlockHandler::close()
+{
+    QMutexLocker locker(&m_mutex);
+    m_bClosed = true;
+    m_condNotFull.wakeAll();
+}
+
+
+//*************************************************************************************************************
+
+bool PluginBlockHandler::isClosed() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_bClosed;
+}
+
+
+//*************************************************************************************************************
+
+int PluginBlockHandler::getQueueSize() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_queueBlocks.size();
+}
+
+
+//*************************************************************************************************************
+
+bool PluginBlockHandler::enqueue(const Block &block,
+                                 const BlockHeader &header,
+                                 bool bWait)
+{
+    bool bSchedule = false;
+
+    {
+        QMutexLocker locker(&m_mutex);
+
+        while(!m_bClosed && m_queueBlocks.size() >= m_iCapacity) {
+            if(m_policy == DropOldest) {
+                m_queueBlocks.dequeue();
+                m_iDropped.ref();
+            } else if(!bWait) {
+                m_iDropped.ref();
+                return false;
+            } else if(m_pScheduler->canRunPendingTask()) {
+                // Never park a worker on a full queue, this could starve the pool. Help out instead.
+                locker.unlock();
+                if(!m_pScheduler->runPendingTask()) {
+                    QThread::yieldCurrentThread();
+                }
+                locker.relock();
+            } else if(m_pScheduler->currentWorker() >= 0) {
+                // Nesting limit reached, exceed the capacity rather than growing the worker's stack any further
+                break;
+            } else {
+                m_condNotFull.wait(&m_mutex);
+            }
+        }
+
+        if(m_bClosed) {
+            return false;
+        }
+
+        QueuedBlock queuedBlock;
+        queuedBlock.block = block;
+        queuedBlock.header = header;
+        m_queueBlocks.enqueue(queuedBlock);
+
+        if(header.isValid()) {
+            BlockTracer::instance()->record(m_iTraceStage, BlockTracer::Enqueue, header, BlockTracer::timestamp());
+        }
+
+        if(!m_bScheduled) {
+            m_bScheduled = true;
+            bSchedule = true;
+        }
+    }
+
+    if(bSchedule) {
+        PluginBlockHandler::SPtr pHandler = sharedFromThis();
+        m_pScheduler->submit([pHandler]() { pHandler->drain(); });
+    }
+
+    return true;
+}
+
+
+//*************************************************************************************************************
+
+void PluginBlockHandler::drain()
+{
+    QueuedBlock block;
+
+    for(int i = 0; i < m_iBatchSize; ++i) {
+        {
+            QMutexLocker locker(&m_mutex);
+
+            if(m_queueBlocks.isEmpty()) {
+                m_bScheduled = false;
+                m_condIdle.wakeAll();
+                return;
+            }
+
+            block = m_queueBlocks.dequeue();
+            m_condNotFull.wakeAll();
+        }
+
+        if(!block.header.isValid()) {
+            block.block();
+            continue;
+        }
+
+        BlockTracer* pTracer = BlockTracer::instance();
+        qint64 iStart = BlockTracer::timestamp();
+        pTracer->record(m_iTraceStage, BlockTracer::Dequeue, block.header, iStart);
+
+        block.block();
+
+        pTracer->record(m_iTraceStage, BlockTracer::Process, block.header, iStart, BlockTracer::timestamp() - iStart);
+    }
+
+    // Yield the worker after a batch so that other handlers get their turn
+    {
+        QMutexLocker locker(&m_mutex);
+
+        if(m_queueBlocks.isEmpty()) {
+            m_bScheduled = false;
+            m_condIdle.wakeAll();
+            return;
+        }
+    }
+
+    PluginBlockHandler::SPtr pHandler = sharedFromThis();
+    m_pScheduler->submit([pHandler]() { pHandler->drain(); });
+}
+
+
+//*************************************************************************************************************
+
+PluginScheduler::PluginScheduler(int iNumWorkers)
+: m_iNumWorkers(1)
+, m_iPending(0)
+, m_iNextQueue(0)
+, m_bRunning(false)
+{
+    setNumWorkers(iNumWorkers);
+}
+
+
+//*************************************************************************************************************
+
+PluginScheduler::~PluginScheduler()
+{
+    stop();
+}
+
+
+//*************************************************************************************************************
+
+PluginScheduler* PluginScheduler::instance()
+{
+    static PluginScheduler scheduler;
+    return &scheduler;
+}
+
+
+//*************************************************************************************************************
+
+void PluginScheduler::start()
+{
+    QMutexLocker locker(&m_mutexState);
+
+    if(m_bRunning) {
+        return;
+    }
+
+    for(int i = 0; i < m_iNumWorkers; ++i) {
+        m_lQueues.append(new WorkerQueue);
+    }
+
+    m_bRunning = true;
+
+    for(int i = 0; i < m_iNumWorkers; ++i) {
+        m_lWorkers.append(new PluginSchedulerWorker(this, i));
+    }
+
+    for(int i = 0; i < m_lWorkers.size(); ++i) {
+        m_lWorkers.at(i)->start();
+    }
+}
+
+
+//*************************************************************************************************************
+
+void PluginScheduler::stop()
+{
+    {
+        QMutexLocker locker(&m_mutexState);
+
+        if(!m_bRunning) {
+            return;
+        }
+
+        m_bRunning = false;
+        m_condWork.wakeAll();
+    }
+
+    // Workers leave their loop once all pending tasks are executed
+    for(int i = 0; i < m_lWorkers.size(); ++i) {
+        m_lWorkers.at(i)->wait();
+    }
+
+    QMutexLocker locker(&m_mutexState);
+
+    qDeleteAll(m_lWorkers);
+    m_lWorkers.clear();
+    qDeleteAll(m_lQueues);
+    m_lQueues.clear();
+}
+
+
+//*************************************************************************************************************
+
+bool PluginScheduler::isRunning() const
+{
+    QMutexLocker locker(&m_mutexState);
+    return m_bRunning;
+}
+
+
+//*************************************************************************************************************
+
+void PluginScheduler::setNumWorkers(int iNumWorkers)
+{
+    if(iNumWorkers < 1) {
+        iNumWorkers = QThread::idealThreadCount() - 1;
+    }
+
+    QMutexLocker locker(&m_mutexState);
+    m_iNumWorkers = qMax(1, iNumWorkers);
+}
+
+
+//*************************************************************************************************************
+
+PluginBlockHandler::SPtr PluginScheduler::registerHandler(const QString& sName,
+                                                          int iCapacity,
+                                                          PluginBlockHandler::BackpressurePolicy policy)
+{
+    return PluginBlockHandler::SPtr(new PluginBlockHandler(this, sName, iCapacity, policy));
+}
+
+
+//*************************************************************************************************************
+
+void PluginScheduler::unregisterHandler(PluginBlockHandler::SPtr pHandler)
+{
+    if(!pHandler) {
+        return;
+    }
+
+    pHandler->close();
+    pHandler->flush();
+}
+
+
+//*************************************************************************************************************
+
+void PluginScheduler::submit(const Task& task)
+{
+    QMutexLocker locker(&m_mutexState);
+
+    if(!m_bRunning) {
+        // No pool available, fall back to synchronous execution
+        locker.unlock();
+        task();
+        return;
+    }
+
+    int iWorker = findWorker(QThread::currentThread());
+
+    if(iWorker < 0) {
+        iWorker = (m_iNextQueue.fetchAndAddRelaxed(1) & 0x7fffffff) % m_lQueues.size();
+    }
+
+    {
+        QMutexLocker queueLocker(&m_lQueues.at(iWorker)->mutex);
+        m_lQueues.at(iWorker)->tasks.push_back(task);
+    }
+
+    m_iPending.ref();
+    m_condWork.wakeOne();
+}
+
+
+//*************************************************************************************************************
+
+bool PluginScheduler::takeTask(int iWorker, Task& task)
+{
+    if(m_iPending.load() <= 0) {
+        return false;
+    }
+
+    // Own deque first, newest task (LIFO) for cache locality
+    {
+        WorkerQueue* pQueue = m_lQueues.at(iWorker);
+        QMutexLocker locker(&pQueue->mutex);
+
+        if(!pQueue->tasks.empty()) {
+            task = pQueue->tasks.back();
+            pQueue->tasks.pop_back();
+            m_iPending.deref();
+            return true;
+        }
+    }
+
+    // Steal the oldest task of another worker
+    for(int i = 1; i < m_lQueues.size(); ++i) {
+        WorkerQueue* pQueue = m_lQueues.at((iWorker + i) % m_lQueues.size());
+        QMutexLocker locker(&pQueue->mutex);
+
+        if(!pQueue->tasks.empty()) {
+            task = pQueue->tasks.front();
+            pQueue->tasks.pop_front();
+            m_iPending.deref();
+            return true;
+        }
+    }
+
+    return false;
+}
+
+
+//*************************************************************************************************************
+
+bool PluginScheduler::runPendingTask()
+{
+    int iWorker = currentWorker();
+
+    if(iWorker < 0) {
+        return false;
+    }
+
+    PluginSchedulerWorker* pWorker = m_lWorkers.at(iWorker);
+
+    if(pWorker->m_iNestingDepth >= MaxNestingDepth) {
+        return false;
+    }
+
+    Task task;
+
+    if(takeTask(iWorker, task)) {
+        ++pWorker->m_iNestingDepth;
+        task();
+        --pWorker->m_iNestingDepth;
+        return true;
+    }
+
+    return false;
+}
+
+
+//*************************************************************************************************************
+
+bool PluginScheduler::canRunPendingTask() const
+{
+    int iWorker = currentWorker();
+
+    return iWorker >= 0 && m_lWorkers.at(iWorker)->m_iNestingDepth < MaxNestingDepth;
+}
+
+
+//*************************************************************************************************************
+
+int PluginScheduler::currentWorker() const
+{
+    QMutexLocker locker(&m_mutexState);
+    return findWorker(QThread::currentThread());
+}
+
+
+//*************************************************************************************************************
+
+int PluginScheduler::findWorker(const QThread* pThread) const
+{
+    for(int i = 0; i < m_lWorkers.size(); ++i) {
+        if(m_lWorkers.at(i) == pThread) {
+            return i;
+        }
+    }
+
+    return -1;
+}
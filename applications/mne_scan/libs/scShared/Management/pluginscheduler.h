@@ -0,0 +1,473 @@
+//=============================================================================================================
+/**
+* @file     pluginscheduler.h
+* @author   agent <agent@local>
+* @version  1.0
+* @date     October, 2026
+*
+* @section  LICENSE
+*
+* Copyright (C) 2026, agent. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+*
+* @brief    Declaration of the PluginScheduler Class.
+*
+*/
+
+#ifndef PLUGINSCHEDULER_H
+#define PLUGINSCHEDULER_H
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "../scshared_global.h"
+
+#include <scMeas/blocktrace.h>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QSharedPointer>
+#include <QEnableSharedFromThis>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QQueue>
+#include <QList>
+#include <QString>
+#include <QAtomicInt>
+#include <QThread>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// STL INCLUDES
+//=============================================================================================================
+
+#include <functional>
+#include <deque>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE NAMESPACE SCSHAREDLIB
+//=============================================================================================================
+
+namespace SCSHAREDLIB
+{
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// FORWARD DECLARATIONS
+//=============================================================================================================
+
+class PluginScheduler;
+class PluginSchedulerWorker;
+
+
+//=============================================================================================================
+/**
+* DECLARE CLASS PluginBlockHandler
+*
+* @brief The PluginBlockHandler class is the adapter between a plugin and the PluginScheduler. A plugin posts
+*        data blocks (as closures) to its handler, typically from its input connector's update() slot. The
+*        handler executes the blocks strictly in order, one at a time, on the scheduler's worker pool. The
+*        bounded block queue provides backpressure towards the posting (upstream) plugin.
+*/
+class SCSHAREDSHARED_EXPORT PluginBlockHandler : public QEnableSharedFromThis<PluginBlockHandler>
+{
+    friend class PluginScheduler;
+
+public:
+    typedef QSharedPointer<PluginBlockHandler> SPtr;               /**< Shared pointer type for PluginBlockHandler. */
+    typedef QSharedPointer<const PluginBlockHandler> ConstSPtr;    /**< Const shared pointer type for PluginBlockHandler. */
+
+    typedef std::function<void()> Block;                           /**< A data block bound to its processing routine. */
+
+    //=========================================================================================================
+    /**
+    * Behaviour of post() when the block queue is full.
+    */
+    enum BackpressurePolicy
+    {
+        WaitForSpace,   /**< The posting thread waits until the handler has consumed a block. */
+        DropOldest      /**< The oldest queued block is dropped, e.g. for display-only consumers. */
+    };
+
+    //=========================================================================================================
+    /**
+    * Destroys the PluginBlockHandler.
+    */
+    ~PluginBlockHandler();
+
+    //=========================================================================================================
+    /**
+    * Posts a block to the handler. Blocks are executed in the order they were posted. If the queue is full the
+    * configured BackpressurePolicy is applied. When called from a scheduler worker thread a full queue does not
+    * block the worker; instead the worker executes other pending tasks until space becomes available.
+    *
+    * @param [in] block     the block to execute.
+    * @param [in] header    the header of the data block, used to trace queueing and processing times.
+    *
+    * @return false if the handler was closed and the block was discarded, true otherwise.
+    */
+    bool post(const Block &block,
+              const SCMEASLIB::BlockHeader &header = SCMEASLIB::BlockHeader());
+
+    //=========================================================================================================
+    /**
+    * Posts a block to the handler without waiting. In contrast to post() a full queue with the WaitForSpace
+    * policy discards the block instead of blocking the calling thread. Use this from callbacks which may run
+    * while the handler's own blocks are executed.
+    *
+    * @param [in] block     the block to execute.
+    * @param [in] header    the header of the data block, used to trace queueing and processing times.
+    *
+    * @return false if the handler was closed or its queue was full and the block was discarded, true otherwise.
+    */
+    bool tryPost(const Block &block,
+                 const SCMEASLIB::BlockHeader &header = SCMEASLIB::BlockHeader());
+
+    //=========================================================================================================
+    /**
+    * Waits until all currently queued blocks were executed.
+    */
+    void flush();
+
+    //=========================================================================================================
+    /**
+    * Closes the handler. All subsequent posts are discarded. Queued blocks are still executed.
+    */
+    void close();
+
+    //=========================================================================================================
+    /**
+    * Returns whether the handler was closed.
+    *
+    * @return true if the handler discards new blocks, false otherwise.
+    */
+    bool isClosed() const;
+
+    //=========================================================================================================
+    /**
+    * Returns the name of the handler.
+    *
+    * @return the handler name.
+    */
+    inline QString getName() const;
+
+    //=========================================================================================================
+    /**
+    * Returns the number of currently queued blocks.
+    *
+    * @return the number of queued blocks.
+    */
+    int getQueueSize() const;
+
+    //=========================================================================================================
+    /**
+    * Returns the number of blocks which were dropped due to the DropOldest policy or a full queue in tryPost().
+    *
+    * @return the number of dropped blocks.
+    */
+    inline int getNumDroppedBlocks() const;
+
+private:
+    //=========================================================================================================
+    /**
+    * Constructs a PluginBlockHandler. Handlers are created by PluginScheduler::registerHandler.
+    *
+    * @param [in] pScheduler    the scheduler executing the blocks.
+    * @param [in] sName         the name of the handler, usually the plugin name.
+    * @param [in] iCapacity     the maximum number of queued blocks.
+    * @param [in] policy        the backpressure policy.
+    */
+    PluginBlockHandler(PluginScheduler* pScheduler,
+                       const QString& sName,
+                       int iCapacity,
+                       BackpressurePolicy policy);
+
+    //=========================================================================================================
+    /**
+    * Queues a block and schedules the handler if needed.
+    *
+    * @param [in] block     the block to execute.
+    * @param [in] header    the header of the data block.
+    * @param [in] bWait     whether to wait for space if the queue is full (WaitForSpace policy only).
+    *
+    * @return false if the block was discarded, true otherwise.
+    */
+    bool enqueue(const Block &block,
+                 const SCMEASLIB::BlockHeader &header,
+                 bool bWait);
+
+    //=========================================================================================================
+    /**
+    * Executes up to m_iBatchSize queued blocks and reschedules the handler if blocks are left.
+    */
+    void drain();
+
+    //=========================================================================================================
+    /**
+    * A queued block together with its trace header.
+    */
+    struct QueuedBlock
+    {
+        Block                       block;      /**< The block to execute. */
+        SCMEASLIB::BlockHeader      header;     /**< The trace header of the data block. */
+    };
+
+    PluginScheduler*        m_pScheduler;       /**< The scheduler executing the blocks. */
+    QString                 m_sName;            /**< The handler name. */
+    int                     m_iCapacity;        /**< The maximum number of queued blocks. */
+    int                     m_iBatchSize;       /**< The number of blocks executed per scheduled task before yielding. */
+    BackpressurePolicy      m_policy;           /**< The backpressure policy. */
+    quint32                 m_iTraceStage;      /**< The BlockTracer stage id of this handler. */
+
+    mutable QMutex          m_mutex;            /**< Guards the queue and state flags. */
+    QWaitCondition          m_condNotFull;      /**< Signalled when a block was taken from the queue. */
+    QWaitCondition          m_condIdle;         /**< Signalled when the handler ran out of blocks. */
+    QQueue<QueuedBlock>     m_queueBlocks;      /**< The queued blocks. */
+    bool                    m_bScheduled;       /**< Whether a drain task is queued or running. */
+    bool                    m_bClosed;          /**< Whether the handler accepts new blocks. */
+    QAtomicInt              m_iDropped;         /**< The number of dropped blocks. */
+};
+
+
+//=============================================================================================================
+/**
+* DECLARE CLASS PluginScheduler
+*
+* @brief The PluginScheduler class is a shared dataflow scheduler for mne_scan plugins. Instead of every plugin
+*        running its own busy QThread, plugins register a PluginBlockHandler and post their data blocks to it.
+*        A fixed pool of worker threads with one task deque each executes the handlers. Idle workers steal
+*        tasks from the other workers' deques, so the pool size can be matched to the number of cores
+*        independently of the number of plugins in the pipeline.
+*/
+class SCSHAREDSHARED_EXPORT PluginScheduler
+{
+    friend class PluginBlockHandler;
+    friend class PluginSchedulerWorker;
+
+public:
+    typedef QSharedPointer<PluginScheduler> SPtr;               /**< Shared pointer type for PluginScheduler. */
+    typedef QSharedPointer<const PluginScheduler> ConstSPtr;    /**< Const shared pointer type for PluginScheduler. */
+
+    typedef std::function<void()> Task;                         /**< A unit of work executed by a worker. */
+
+    //=========================================================================================================
+    /**
+    * Constructs a PluginScheduler. The worker threads are started lazily by start().
+    *
+    * @param [in] iNumWorkers   the number of worker threads. Values < 1 select QThread::idealThreadCount() - 1.
+    */
+    explicit PluginScheduler(int iNumWorkers = -1);
+
+    //=========================================================================================================
+    /**
+    * Destroys the PluginScheduler. Stops all workers.
+    */
+    ~PluginScheduler();
+
+    //=========================================================================================================
+    /**
+    * Returns the scheduler shared by all plugins of the running mne_scan instance.
+    *
+    * @return the shared scheduler.
+    */
+    static PluginScheduler* instance();
+
+    //=========================================================================================================
+    /**
+    * Starts the worker threads if they are not running yet.
+    */
+    void start();
+
+    //=========================================================================================================
+    /**
+    * Executes all pending tasks and stops the worker threads.
+    */
+    void stop();
+
+    //=========================================================================================================
+    /**
+    * Returns whether the worker threads are running.
+    *
+    * @return true if running, false otherwise.
+    */
+    bool isRunning() const;
+
+    //=========================================================================================================
+    /**
+    * Sets the number of worker threads. Takes effect on the next start().
+    *
+    * @param [in] iNumWorkers   the number of worker threads. Values < 1 select QThread::idealThreadCount() - 1.
+    */
+    void setNumWorkers(int iNumWorkers);
+
+    //=========================================================================================================
+    /**
+    * Returns the number of worker threads.
+    *
+    * @return the number of worker threads.
+    */
+    inline int getNumWorkers() const;
+
+    //=========================================================================================================
+    /**
+    * Registers a block handler.
+    *
+    * @param [in] sName         the name of the handler, usually the plugin name.
+    * @param [in] iCapacity     the maximum number of queued blocks before backpressure is applied.
+    * @param [in] policy        the backpressure policy.
+    *
+    * @return the new handler.
+    */
+    PluginBlockHandler::SPtr registerHandler(const QString& sName,
+                                             int iCapacity = 16,
+                                             PluginBlockHandler::BackpressurePolicy policy = PluginBlockHandler::WaitForSpace);
+
+    //=========================================================================================================
+    /**
+    * Unregisters a block handler. The handler is closed and all of its queued blocks are executed before
+    * this function returns.
+    *
+    * @param [in] pHandler      the handler to unregister.
+    */
+    void unregisterHandler(PluginBlockHandler::SPtr pHandler);
+
+    //=========================================================================================================
+    /**
+    * Submits a task to the pool. If called from a worker thread the task is pushed to that worker's own deque,
+    * otherwise the workers are fed round robin. If the scheduler is not running the task is executed in place.
+    *
+    * @param [in] task      the task to execute.
+    */
+    void submit(const Task& task);
+
+private:
+    //=========================================================================================================
+    /**
+    * Takes a task for the given worker: first from the back of its own deque, then stolen from the front of
+    * the other workers' deques.
+    *
+    * @param [in] iWorker   the index of the worker asking for work.
+    * @param [out] task     the task.
+    *
+    * @return true if a task was found, false otherwise.
+    */
+    bool takeTask(int iWorker, Task& task);
+
+    //=========================================================================================================
+    /**
+    * Executes one pending task on the calling worker thread, if any. Used to keep a worker busy while it
+    * waits on a full block queue. Nested calls are limited to MaxNestingDepth, see canRunPendingTask().
+    *
+    * @return true if a task was executed, false otherwise.
+    */
+    bool runPendingTask();
+
+    //=========================================================================================================
+    /**
+    * Returns whether the calling thread is a worker which may execute another pending task, i.e. whether the
+    * nesting depth of runPendingTask() calls on this worker is below MaxNestingDepth.
+    *
+    * @return true if runPendingTask() may be called, false otherwise.
+    */
+    bool canRunPendingTask() const;
+
+    //=========================================================================================================
+    /**
+    * Returns the index of the calling worker thread of this scheduler.
+    *
+    * @return the worker index or -1 if the calling thread is not a worker of this scheduler.
+    */
+    int currentWorker() const;
+
+    //=========================================================================================================
+    /**
+    * Returns the index of the given thread among the workers. Requires m_mutexState to be held.
+    *
+    * @param [in] pThread   the thread to look up.
+    *
+    * @return the worker index or -1 if the thread is not a worker of this scheduler.
+    */
+    int findWorker(const QThread* pThread) const;
+
+    //=========================================================================================================
+    /**
+    * Worker task deque. The owning worker pushes and pops at the back, thieves take from the front.
+    */
+    struct WorkerQueue
+    {
+        QMutex              mutex;      /**< Guards the deque. */
+        std::deque<Task>    tasks;      /**< The queued tasks. */
+    };
+
+    static const int                MaxNestingDepth = 8;    /**< The maximum number of nested runPendingTask() calls per worker. */
+
+    int                             m_iNumWorkers;      /**< The number of worker threads. */
+    QList<PluginSchedulerWorker*>   m_lWorkers;         /**< The worker threads. */
+    QList<WorkerQueue*>             m_lQueues;          /**< One task deque per worker. */
+
+    mutable QMutex                  m_mutexState;       /**< Guards the sleep/wake state. */
+    QWaitCondition                  m_condWork;         /**< Signalled when new tasks arrive. */
+    QAtomicInt                      m_iPending;         /**< The number of queued, not yet started tasks. */
+    QAtomicInt                      m_iNextQueue;       /**< Round robin counter for external submits. */
+    bool                            m_bRunning;         /**< Whether the workers are running. */
+};
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INLINE DEFINITIONS
+//=============================================================================================================
+
+inline QString PluginBlockHandler::getName() const
+{
+    return m_sName;
+}
+
+
+//*************************************************************************************************************
+
+inline int PluginBlockHandler::getNumDroppedBlocks() const
+{
+    return m_iDropped.load();
+}
+
+
+//*************************************************************************************************************
+
+inline int PluginScheduler::getNumWorkers() const
+{
+    return m_iNumWorkers;
+}
+
+} // NAMESPACE
+
+#endif // PLUGINSCHEDULER_H
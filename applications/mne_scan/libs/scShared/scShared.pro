@@ -76,7 +76,8 @@ SOURCES += \
     Management/pluginconnectorconnection.cpp \
     Management/pluginconnectorconnectionwidget.cpp \
     Management/pluginscenemanager.cpp \
-    Management/displaymanager.cpp
+    Management/displaymanager.cpp \
+    Management/pluginscheduler.cpp
 
 HEADERS += \
     scshared_global.h \
@@ -93,7 +94,8 @@ HEADERS += \
     Management/pluginconnectorconnection.h \
     Management/pluginconnectorconnectionwidget.h \
     Management/pluginscenemanager.h \
-    Management/displaymanager.h
+    Management/displaymanager.h \
+    Management/pluginscheduler.h
 
 
 INCLUDEPATH += $${EIGEN_INCLUDE_DIR}
@@ -41,8 +41,10 @@ SUBDIRS += \
     libs \
     plugins \
     mne_scan \
+    mne_scan_bench \
 
 # Specify dependencies because of packaging on MacOS
 libs.depends =
 plugins.depends = libs
 mne_scan.depends = libs plugins
+mne_scan_bench.depends = libs plugins
@@ -0,0 +1,245 @@
+//=============================================================================================================
+/**
+* @file     benchmarkmonitor.cpp
+* @author   agent <agent@local>
+* @version  1.0
+* @date     October, 2026
+*
+* @section  LICENSE
+*
+* Copyright (C) 2026, agent. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+*
+* @brief    Definition of the BenchmarkMonitor Class.
+*
+*/
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "benchmarkmonitor.h"
+
+#include <scShared/Management/pluginoutputconnector.h>
+#include <scMeas/realtimemultisamplearray.h>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// STL INCLUDES
+//=============================================================================================================
+
+#include <algorithm>
+#include <stdio.h>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// USED NAMESPACES
+//=============================================================================================================
+
+using namespace MNESCANBENCH;
+using namespace SCSHAREDLIB;
+using namespace SCMEASLIB;
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE GLOBAL METHODS
+//=============================================================================================================
+
+namespace
+{
+
+double percentile(const QVector<double>& vecSorted, double dQuantile)
+{
+    if(vecSorted.isEmpty()) {
+        return 0.0;
+    }
+
+    int iIndex = int(dQuantile * (vecSorted.size() - 1) + 0.5);
+    return vecSorted.at(qBound(0, iIndex, vecSorted.size() - 1));
+}
+
+}
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE MEMBER METHODS
+//=============================================================================================================
+
+BenchmarkMonitor::BenchmarkMonitor()
+: m_iLastOutputNs(0)
+{
+    m_timer.start();
+}
+
+
+//*************************************************************************************************************
+
+void BenchmarkMonitor::start()
+{
+    QMutexLocker locker(&m_mutex);
+
+    m_timer.restart();
+    m_iLastOutputNs = 0;
+    m_vecInjectedSamples.clear();
+    m_vecInjectedNs.clear();
+    m_mapStages.clear();
+}
+
+
+//*************************************************************************************************************
+
+void BenchmarkMonitor::recordInjection(qint64 iNumSamples)
+{
+    QMutexLocker locker(&m_mutex);
+
+    qint64 iTotal = m_vecInjectedSamples.isEmpty() ? 0 : m_vecInjectedSamples.last();
+
+    m_vecInjectedSamples.append(iTotal + iNumSamples);
+    m_vecInjectedNs.append(m_timer.nsecsElapsed());
+}
+
+
+//*************************************************************************************************************
+
+void BenchmarkMonitor::attach(IPlugin::SPtr pPlugin)
+{
+    QString sPlugin = pPlugin->getName();
+
+    for(int i = 0; i < pPlugin->getOutputConnectors().size(); ++i) {
+        QString sStage = QString("%1/%2").arg(sPlugin).arg(pPlugin->getOutputConnectors().at(i)->getName());
+
+        // No context object: the functor is executed directly in the emitting plugin thread
+        QObject::connect(pPlugin->getOutputConnectors().at(i).data(), &PluginOutputConnector::notify,
+                         [this, sStage](Measurement::SPtr pMeasurement) {
+                             recordOutput(sStage, pMeasurement);
+                         });
+    }
+}
+
+
+//*************************************************************************************************************
+
+qint64 BenchmarkMonitor::getIdleTime() const
+{
+    QMutexLocker locker(&m_mutex);
+
+    return (m_timer.nsecsElapsed() - m_iLastOutputNs) / 1000000;
+}
+
+
+//*************************************************************************************************************
+
+void BenchmarkMonitor::report(double dSFreq) const
+{
+    QMutexLocker locker(&m_mutex);
+
+    if(m_vecInjectedNs.isEmpty()) {
+        printf("No blocks were injected.\n");
+        return;
+    }
+
+    double dInjectSec = double(m_vecInjectedNs.last() - m_vecInjectedNs.first()) / 1.0e9;
+    double dInjectedSamples = double(m_vecInjectedSamples.last());
+
+    printf("\nInjected %d blocks, %.0f samples in %.3f s", m_vecInjectedNs.size(), dInjectedSamples, dInjectSec);
+    if(dInjectSec > 0.0 && dSFreq > 0.0) {
+        printf(" (%.1f x real time)", dInjectedSamples / dSFreq / dInjectSec);
+    }
+    printf("\n\n");
+
+    printf("%-48s %8s %12s %10s %10s %10s %10s %10s\n",
+           "Output", "Blocks", "Samples/s", "x RT", "p50 [ms]", "p90 [ms]", "p99 [ms]", "max [ms]");
+
+    QMap<QString, StageStatistics>::const_iterator it = m_mapStages.constBegin();
+    for(; it != m_mapStages.constEnd(); ++it) {
+        const StageStatistics& stats = it.value();
+
+        QVector<double> vecSorted = stats.vecLatencyMs;
+        std::sort(vecSorted.begin(), vecSorted.end());
+
+        double dSec = double(stats.iLastNs - stats.iFirstNs) / 1.0e9;
+        double dSamplesPerSec = (dSec > 0.0 && stats.iNumSamples > 0) ? double(stats.iNumSamples) / dSec : 0.0;
+
+        printf("%-48s %8lld %12.0f %10.1f %10.3f %10.3f %10.3f %10.3f\n",
+               it.key().left(48).toUtf8().constData(),
+               static_cast<long long>(stats.iNumBlocks),
+               dSamplesPerSec,
+               dSFreq > 0.0 ? dSamplesPerSec / dSFreq : 0.0,
+               percentile(vecSorted, 0.5),
+               percentile(vecSorted, 0.9),
+               percentile(vecSorted, 0.99),
+               vecSorted.isEmpty() ? 0.0 : vecSorted.last());
+    }
+
+    printf("\n");
+}
+
+
+//*************************************************************************************************************
+
+void BenchmarkMonitor::recordOutput(const QString& sStage,
+                                    Measurement::SPtr pMeasurement)
+{
+    qint64 iNumSamples = 0;
+
+    if(QSharedPointer<RealTimeMultiSampleArray> pRTMSA = pMeasurement.dynamicCast<RealTimeMultiSampleArray>()) {
+        QList<SampleBlock> lData = pRTMSA->getSampleBlocks();
+        for(int i = 0; i < lData.size(); ++i) {
+            iNumSamples += lData.at(i)->cols();
+        }
+    }
+
+    QMutexLocker locker(&m_mutex);
+
+    qint64 iNow = m_timer.nsecsElapsed();
+    m_iLastOutputNs = iNow;
+
+    if(m_vecInjectedNs.isEmpty()) {
+        return;
+    }
+
+    StageStatistics& stats = m_mapStages[sStage];
+
+    if(stats.iFirstNs < 0) {
+        stats.iFirstNs = iNow;
+    }
+    stats.iLastNs = iNow;
+    stats.iNumBlocks++;
+
+    int iBlock = m_vecInjectedNs.size() - 1;
+
+    if(iNumSamples > 0) {
+        stats.iNumSamples += iNumSamples;
+
+        // Block which holds the last emitted sample
+        QVector<qint64>::const_iterator itBlock = std::upper_bound(m_vecInjectedSamples.constBegin(),
+                                                                   m_vecInjectedSamples.constEnd(),
+                                                                   stats.iNumSamples - 1);
+        iBlock = qMin(int(itBlock - m_vecInjectedSamples.constBegin()), m_vecInjectedNs.size() - 1);
+    }
+
+    stats.vecLatencyMs.append(double(iNow - m_vecInjectedNs.at(iBlock)) / 1.0e6);
+}
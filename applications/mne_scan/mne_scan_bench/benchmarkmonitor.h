@@ -0,0 +1,169 @@
+//=============================================================================================================
+/**
+* @file     benchmarkmonitor.h
+* @author   agent <agent@local>
+* @version  1.0
+* @date     October, 2026
+*
+* @section  LICENSE
+*
+* Copyright (C) 2026, agent. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+*
+* @brief    Declaration of the BenchmarkMonitor Class.
+*
+*/
+
+#ifndef BENCHMARKMONITOR_H
+#define BENCHMARKMONITOR_H
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include <scShared/Interfaces/IPlugin.h>
+#include <scMeas/measurement.h>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QMutex>
+#include <QElapsedTimer>
+#include <QMap>
+#include <QVector>
+#include <QString>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE NAMESPACE MNESCANBENCH
+//=============================================================================================================
+
+namespace MNESCANBENCH
+{
+
+//=============================================================================================================
+/**
+* DECLARE CLASS BenchmarkMonitor
+*
+* @brief The BenchmarkMonitor class timestamps the blocks injected by the BenchmarkSource and every block
+*        emitted by the output connectors of the plugins under test. It reports throughput and latency
+*        percentiles per output connector.
+*
+*        Latencies of RealTimeMultiSampleArray outputs are measured against the injection time of the block
+*        holding the last emitted sample, so they include the time the block waited in the plugin buffers.
+*        Outputs which do not preserve samples (evoked sets, source estimates, ...) are measured against the
+*        most recently injected block.
+*/
+class BenchmarkMonitor
+{
+public:
+    //=========================================================================================================
+    /**
+    * Constructs a BenchmarkMonitor.
+    */
+    BenchmarkMonitor();
+
+    //=========================================================================================================
+    /**
+    * Starts the clock. Call before the pipeline is started.
+    */
+    void start();
+
+    //=========================================================================================================
+    /**
+    * Records the injection of a block into the pipeline.
+    *
+    * @param [in] iNumSamples   the number of samples of the block.
+    */
+    void recordInjection(qint64 iNumSamples);
+
+    //=========================================================================================================
+    /**
+    * Connects to all output connectors of a plugin.
+    *
+    * @param [in] pPlugin       the plugin to monitor.
+    */
+    void attach(SCSHAREDLIB::IPlugin::SPtr pPlugin);
+
+    //=========================================================================================================
+    /**
+    * Returns the time since the last block was emitted by any monitored connector.
+    *
+    * @return the idle time in ms.
+    */
+    qint64 getIdleTime() const;
+
+    //=========================================================================================================
+    /**
+    * Prints the throughput and latency table to stdout.
+    *
+    * @param [in] dSFreq        the sampling frequency of the injected data.
+    */
+    void report(double dSFreq) const;
+
+private:
+    //=========================================================================================================
+    /**
+    * Records a block emitted by a monitored output connector.
+    *
+    * @param [in] sStage        the name of the output connector.
+    * @param [in] pMeasurement  the emitted measurement.
+    */
+    void recordOutput(const QString& sStage,
+                      SCMEASLIB::Measurement::SPtr pMeasurement);
+
+    //=========================================================================================================
+    /**
+    * Statistics of one output connector.
+    */
+    struct StageStatistics
+    {
+        StageStatistics()
+        : iNumBlocks(0)
+        , iNumSamples(0)
+        , iFirstNs(-1)
+        , iLastNs(-1)
+        {}
+
+        qint64              iNumBlocks;     /**< Number of emitted blocks. */
+        qint64              iNumSamples;    /**< Number of emitted samples, 0 for non sample outputs. */
+        qint64              iFirstNs;       /**< Time of the first emitted block. */
+        qint64              iLastNs;        /**< Time of the last emitted block. */
+        QVector<double>     vecLatencyMs;   /**< Latency of every emitted block. */
+    };
+
+    mutable QMutex                      m_mutex;                /**< Guards all members, outputs arrive from the plugin threads. */
+    QElapsedTimer                       m_timer;                /**< The benchmark clock. */
+    qint64                              m_iLastOutputNs;        /**< Time of the last emitted block. */
+    QVector<qint64>                     m_vecInjectedSamples;   /**< Cumulative number of samples after every injected block. */
+    QVector<qint64>                     m_vecInjectedNs;        /**< Injection time of every block. */
+    QMap<QString, StageStatistics>      m_mapStages;            /**< Statistics per output connector. */
+};
+
+} // NAMESPACE
+
+#endif // BENCHMARKMONITOR_H
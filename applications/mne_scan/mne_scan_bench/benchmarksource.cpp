@@ -0,0 +1,252 @@
+//=============================================================================================================
+/**
+* @file     benchmarksource.cpp
+* @author   agent <agent@local>
+* @version  1.0
+* @date     October, 2026
+*
+* @section  LICENSE
+*
+* Copyright (C) 2026, agent. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+*
+* @brief    Definition of the BenchmarkSource Class.
+*
+*/
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "benchmarksource.h"
+#include "benchmarkmonitor.h"
+
+#include <fiff/fiff_raw_data.h>
+#include <fiff/fiff_info.h>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QFile>
+#include <QElapsedTimer>
+#include <QWidget>
+#include <QDebug>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// Eigen INCLUDES
+//=============================================================================================================
+
+#include <Eigen/Core>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// USED NAMESPACES
+//=============================================================================================================
+
+using namespace MNESCANBENCH;
+using namespace SCSHAREDLIB;
+using namespace SCMEASLIB;
+using namespace FIFFLIB;
+using namespace Eigen;
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE MEMBER METHODS
+//=============================================================================================================
+
+BenchmarkSource::BenchmarkSource(const QString& sRawFile,
+                                 int iBlockSize,
+                                 double dSpeed,
+                                 BenchmarkMonitor* pMonitor)
+: m_sRawFile(sRawFile)
+, m_iBlockSize(qMax(1, iBlockSize))
+, m_dSpeed(dSpeed)
+, m_bIsRunning(false)
+, m_pMonitor(pMonitor)
+{
+}
+
+
+//*************************************************************************************************************
+
+BenchmarkSource::~BenchmarkSource()
+{
+    if(this->isRunning()) {
+        stop();
+    }
+}
+
+
+//*************************************************************************************************************
+
+QSharedPointer<IPlugin> BenchmarkSource::clone() const
+{
+    QSharedPointer<BenchmarkSource> pClone(new BenchmarkSource(m_sRawFile, m_iBlockSize, m_dSpeed, m_pMonitor));
+    return pClone;
+}
+
+
+//*************************************************************************************************************
+
+void BenchmarkSource::init()
+{
+    m_pRTMSAOutput = PluginOutputData<RealTimeMultiSampleArray>::create(this, "BenchmarkSourceOut", "Replayed FIFF raw data");
+    m_pRTMSAOutput->data()->setName(this->getName());
+    m_outputConnectors.append(m_pRTMSAOutput);
+
+    QFile t_fileRaw(m_sRawFile);
+    FiffRawData rawData(t_fileRaw);
+
+    if(rawData.isEmpty()) {
+        qWarning() << "BenchmarkSource::init - Could not read" << m_sRawFile;
+        return;
+    }
+
+    // Read all samples up front, the timed replay loop must not include the file access
+    MatrixXd matTimes;
+
+    if(!rawData.read_raw_segment(m_matData, matTimes, rawData.first_samp, rawData.last_samp)) {
+        qWarning() << "BenchmarkSource::init - Could not read the samples of" << m_sRawFile;
+        m_matData.resize(0,0);
+        return;
+    }
+
+    m_pFiffInfo = QSharedPointer<FiffInfo>(new FiffInfo(rawData.info));
+
+    m_pRTMSAOutput->data()->initFromFiffInfo(m_pFiffInfo);
+    m_pRTMSAOutput->data()->setMultiArraySize(1);
+    m_pRTMSAOutput->data()->setVisibility(false);
+}
+
+
+//*************************************************************************************************************
+
+void BenchmarkSource::unload()
+{
+}
+
+
+//*************************************************************************************************************
+
+bool BenchmarkSource::start()
+{
+    if(!m_pFiffInfo || m_matData.cols() == 0) {
+        return false;
+    }
+
+    m_bIsRunning = true;
+
+    QThread::start();
+
+    return true;
+}
+
+
+//*************************************************************************************************************
+
+bool BenchmarkSource::stop()
+{
+    m_bIsRunning = false;
+
+    QThread::wait();
+
+    return true;
+}
+
+
+//*************************************************************************************************************
+
+IPlugin::PluginType BenchmarkSource::getType() const
+{
+    return _ISensor;
+}
+
+
+//*************************************************************************************************************
+
+QString BenchmarkSource::getName() const
+{
+    return "Benchmark Source";
+}
+
+
+//*************************************************************************************************************
+
+QWidget* BenchmarkSource::setupWidget()
+{
+    return new QWidget;
+}
+
+
+//*************************************************************************************************************
+
+double BenchmarkSource::getSamplingFrequency() const
+{
+    if(!m_pFiffInfo) {
+        return 0.0;
+    }
+
+    return m_pFiffInfo->sfreq;
+}
+
+
+//*************************************************************************************************************
+
+void BenchmarkSource::run()
+{
+    MatrixXd matData(m_matData.rows(), m_iBlockSize);
+
+    QElapsedTimer timer;
+    timer.start();
+
+    qint64 iNumSent = 0;
+    double dSFreq = m_pFiffInfo->sfreq;
+
+    // The incomplete last block is dropped, the plugins expect a constant block size
+    for(qint64 from = 0; from + m_iBlockSize <= m_matData.cols() && m_bIsRunning; from += m_iBlockSize) {
+        matData = m_matData.middleCols(from, m_iBlockSize);
+
+        // Pace at the requested multiple of real time
+        if(m_dSpeed > 0.0) {
+            qint64 iDueMs = qint64(1000.0 * double(iNumSent) / dSFreq / m_dSpeed);
+            qint64 iWaitMs = iDueMs - timer.elapsed();
+
+            if(iWaitMs > 0) {
+                msleep(iWaitMs);
+            }
+        }
+
+        m_pMonitor->recordInjection(matData.cols());
+
+        // Blocks when the buffers of the pipeline are full, which throttles the replay to the pipeline throughput
+        m_pRTMSAOutput->data()->setValue(matData);
+
+        iNumSent += matData.cols();
+    }
+}
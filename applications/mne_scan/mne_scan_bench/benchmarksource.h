@@ -0,0 +1,169 @@
+//=============================================================================================================
+/**
+* @file     benchmarksource.h
+* @author   agent <agent@local>
+* @version  1.0
+* @date     October, 2026
+*
+* @section  LICENSE
+*
+* Copyright (C) 2026, agent. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+*
+* @brief    Declaration of the BenchmarkSource Class.
+*
+*/
+
+#ifndef BENCHMARKSOURCE_H
+#define BENCHMARKSOURCE_H
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include <scShared/Interfaces/ISensor.h>
+#include <scShared/Management/pluginoutputdata.h>
+#include <scMeas/realtimemultisamplearray.h>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QSharedPointer>
+#include <QString>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// Eigen INCLUDES
+//=============================================================================================================
+
+#include <Eigen/Core>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// FORWARD DECLARATIONS
+//=============================================================================================================
+
+namespace FIFFLIB {
+    class FiffInfo;
+}
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE NAMESPACE MNESCANBENCH
+//=============================================================================================================
+
+namespace MNESCANBENCH
+{
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// MNESCANBENCH FORWARD DECLARATIONS
+//=============================================================================================================
+
+class BenchmarkMonitor;
+
+
+//=============================================================================================================
+/**
+* DECLARE CLASS BenchmarkSource
+*
+* @brief The BenchmarkSource class is a sensor which replays a FIFF raw file into the pipeline under test.
+*        Blocks are injected as fast as the pipeline consumes them or paced at a multiple of real time.
+*/
+class BenchmarkSource : public SCSHAREDLIB::ISensor
+{
+public:
+    typedef QSharedPointer<BenchmarkSource> SPtr;               /**< Shared pointer type for BenchmarkSource. */
+    typedef QSharedPointer<const BenchmarkSource> ConstSPtr;    /**< Const shared pointer type for BenchmarkSource. */
+
+    //=========================================================================================================
+    /**
+    * Constructs a BenchmarkSource.
+    *
+    * @param [in] sRawFile      the FIFF raw file to replay.
+    * @param [in] iBlockSize    the number of samples per block.
+    * @param [in] dSpeed        the replay speed as a multiple of real time, <= 0 for as fast as possible.
+    * @param [in] pMonitor      the monitor which records the injection times.
+    */
+    BenchmarkSource(const QString& sRawFile,
+                    int iBlockSize,
+                    double dSpeed,
+                    BenchmarkMonitor* pMonitor);
+
+    //=========================================================================================================
+    /**
+    * Destroys the BenchmarkSource.
+    */
+    virtual ~BenchmarkSource();
+
+    //=========================================================================================================
+    /**
+    * ISensor functions
+    */
+    virtual QSharedPointer<SCSHAREDLIB::IPlugin> clone() const;
+    virtual void init();
+    virtual void unload();
+    virtual bool start();
+    virtual bool stop();
+    virtual SCSHAREDLIB::IPlugin::PluginType getType() const;
+    virtual QString getName() const;
+    virtual QWidget* setupWidget();
+
+    //=========================================================================================================
+    /**
+    * Returns the sampling frequency of the replayed file.
+    *
+    * @return the sampling frequency, 0 if the file could not be read.
+    */
+    double getSamplingFrequency() const;
+
+protected:
+    //=========================================================================================================
+    /**
+    * Replays the samples which were read from the file by init().
+    */
+    virtual void run();
+
+private:
+    QString                                     m_sRawFile;         /**< The FIFF raw file to replay. */
+    int                                         m_iBlockSize;       /**< The number of samples per block. */
+    double                                      m_dSpeed;           /**< The replay speed as a multiple of real time. */
+    bool                                        m_bIsRunning;       /**< Whether the replay is running. */
+    BenchmarkMonitor*                           m_pMonitor;         /**< The monitor which records the injection times. */
+
+    QSharedPointer<FIFFLIB::FiffInfo>           m_pFiffInfo;        /**< The measurement info of the raw file. */
+    Eigen::MatrixXd                             m_matData;          /**< All samples of the raw file, read up front so the replay does not measure file access. */
+
+    SCSHAREDLIB::PluginOutputData<SCMEASLIB::RealTimeMultiSampleArray>::SPtr m_pRTMSAOutput;  /**< The output of the replayed data. */
+};
+
+} // NAMESPACE
+
+#endif // BENCHMARKSOURCE_H
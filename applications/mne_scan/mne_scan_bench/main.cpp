@@ -0,0 +1,284 @@
+//=============================================================================================================
+/**
+* @file     main.cpp
+* @author   agent <agent@local>
+* @version  1.0
+* @date     October, 2026
+*
+* @section  LICENSE
+*
+* Copyright (C) 2026, agent. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+*
+* @brief    Implements the headless MNE Scan pipeline benchmark.
+*
+*/
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "benchmarksource.h"
+#include "benchmarkmonitor.h"
+
+#include <scShared/Management/pluginmanager.h>
+#include <scShared/Management/pluginscenemanager.h>
+#include <scShared/Management/pluginconnectorconnection.h>
+#include <scShared/Management/pluginscheduler.h>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QApplication>
+#include <QCommandLineParser>
+#include <QDomDocument>
+#include <QFile>
+#include <QTimer>
+#include <QMap>
+#include <QPair>
+#include <QDebug>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// USED NAMESPACES
+//=============================================================================================================
+
+using namespace MNESCANBENCH;
+using namespace SCSHAREDLIB;
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// MAIN
+//=============================================================================================================
+
+//=============================================================================================================
+/**
+* Reads the plugin names and connections of a pipeline configuration as written by MNE Scan (PluginTree xml).
+*
+* @param [in] sFilePath         the configuration file.
+* @param [out] lPlugins         the plugin names.
+* @param [out] lConnections     the (sender, receiver) pairs.
+*
+* @return true if successful, false otherwise.
+*/
+bool readPipelineConfig(const QString& sFilePath,
+                        QStringList& lPlugins,
+                        QList<QPair<QString,QString> >& lConnections)
+{
+    QDomDocument doc("PluginConfig");
+    QFile file(sFilePath);
+
+    if(!file.open(QIODevice::ReadOnly) || !doc.setContent(&file)) {
+        return false;
+    }
+
+    QDomElement docElem = doc.documentElement();
+    if(docElem.tagName() != "PluginTree") {
+        return false;
+    }
+
+    for(QDomNode nodeTree = docElem.firstChild(); !nodeTree.isNull(); nodeTree = nodeTree.nextSibling()) {
+        QDomElement elementTree = nodeTree.toElement();
+
+        for(QDomNode node = elementTree.firstChild(); !node.isNull(); node = node.nextSibling()) {
+            QDomElement e = node.toElement();
+
+            if(e.isNull()) {
+                continue;
+            }
+
+            if(elementTree.tagName() == "Plugins") {
+                lPlugins << e.attribute("name");
+            } else if(elementTree.tagName() == "Connections") {
+                lConnections << QPair<QString,QString>(e.attribute("sender"), e.attribute("receiver"));
+            }
+        }
+    }
+
+    return true;
+}
+
+
+//=============================================================================================================
+/**
+* The function main marks the entry point of the program.
+* By default, main has the storage class extern.
+*
+* @param [in] argc (argument count) is an integer that indicates how many arguments were entered on the command line when the program was started.
+* @param [in] argv (argument vector) is an array of pointers to arrays of character objects. The array objects are null-terminated strings, representing the arguments that were entered on the command line when the program was started.
+* @return the value that was set to exit() (which is 0 if exit() is called via quit()).
+*/
+int main(int argc, char *argv[])
+{
+    // The plugins create their control widgets on init, but nothing is ever shown
+    if(qgetenv("QT_QPA_PLATFORM").isEmpty()) {
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    }
+
+    QApplication app(argc, argv);
+
+    // Command Line Parser
+    QCommandLineParser parser;
+    parser.setApplicationDescription("MNE Scan headless pipeline benchmark. Replays a FIFF raw file through MNE Scan plugins and reports throughput and latency per plugin output.");
+    parser.addHelpOption();
+
+    QCommandLineOption rawOption("raw", "The FIFF raw file <file> to replay.", "file", QCoreApplication::applicationDirPath() + "/MNE-sample-data/MEG/sample/sample_audvis_raw.fif");
+    QCommandLineOption pipelineOption("pipeline", "MNE Scan pipeline configuration <xml>. Sensor plugins are replaced by the file replay.", "xml");
+    QCommandLineOption pluginsOption("plugins", "Comma separated chain of plugin <names>, used if no pipeline configuration is given.", "names", "Noise Reduction");
+    QCommandLineOption pluginDirOption("pluginDir", "The plugin directory <dir>.", "dir", QCoreApplication::applicationDirPath() + "/mne_scan_plugins");
+    QCommandLineOption blockSizeOption("blockSize", "Number of <samples> per injected block.", "samples", "200");
+    QCommandLineOption speedOption("speed", "Replay speed as multiple <x> of real time, 0 for as fast as the pipeline consumes the data.", "x", "0");
+    QCommandLineOption drainOption("drain", "Stop after the pipeline was idle for <ms> after the last block was injected.", "ms", "2000");
+    QCommandLineOption workersOption("workers", "Number of <threads> of the shared plugin scheduler, 0 for automatic.", "threads", "0");
+
+    parser.addOption(rawOption);
+    parser.addOption(pipelineOption);
+    parser.addOption(pluginsOption);
+    parser.addOption(pluginDirOption);
+    parser.addOption(blockSizeOption);
+    parser.addOption(speedOption);
+    parser.addOption(drainOption);
+    parser.addOption(workersOption);
+    parser.process(app);
+
+    //
+    // Pipeline description
+    //
+    QStringList lPluginNames;
+    QList<QPair<QString,QString> > lConnectionNames;
+
+    BenchmarkMonitor monitor;
+    BenchmarkSource source(parser.value(rawOption),
+                           parser.value(blockSizeOption).toInt(),
+                           parser.value(speedOption).toDouble(),
+                           &monitor);
+
+    if(parser.isSet(pipelineOption)) {
+        if(!readPipelineConfig(parser.value(pipelineOption), lPluginNames, lConnectionNames)) {
+            qCritical() << "Could not read pipeline configuration" << parser.value(pipelineOption);
+            return 1;
+        }
+    } else {
+        QString sPrevious = source.getName();
+        lPluginNames << sPrevious;
+
+        foreach(const QString& sName, parser.value(pluginsOption).split(",", QString::SkipEmptyParts)) {
+            lPluginNames << sName.trimmed();
+            lConnectionNames << QPair<QString,QString>(sPrevious, sName.trimmed());
+            sPrevious = sName.trimmed();
+        }
+    }
+
+    //
+    // Instantiate the plugins
+    //
+    PluginManager pluginManager;
+    pluginManager.loadPlugins(parser.value(pluginDirOption));
+
+    PluginSceneManager sceneManager;
+    PluginScheduler::instance()->setNumWorkers(parser.value(workersOption).toInt());
+
+    IPlugin::SPtr pSource;
+    if(!sceneManager.addPlugin(&source, pSource)) {
+        qCritical() << "Could not add the benchmark source";
+        return 1;
+    }
+
+    QMap<QString, IPlugin::SPtr> mapPlugins;
+
+    foreach(const QString& sName, lPluginNames) {
+        if(mapPlugins.contains(sName)) {
+            continue;
+        }
+
+        int iIndex = pluginManager.findByName(sName);
+
+        if(sName == source.getName() || (iIndex >= 0 && pluginManager.getPlugins().at(iIndex)->getType() == IPlugin::_ISensor)) {
+            mapPlugins.insert(sName, pSource);
+            continue;
+        }
+
+        IPlugin::SPtr pAdded;
+        if(iIndex < 0 || !sceneManager.addPlugin(pluginManager.getPlugins().at(iIndex), pAdded)) {
+            qCritical() << "Could not add plugin" << sName;
+            return 1;
+        }
+
+        mapPlugins.insert(sName, pAdded);
+        monitor.attach(pAdded);
+    }
+
+    //
+    // Connect the plugins
+    //
+    QList<PluginConnectorConnection::SPtr> lConnections;
+
+    for(int i = 0; i < lConnectionNames.size(); ++i) {
+        IPlugin::SPtr pSender = mapPlugins.value(lConnectionNames.at(i).first);
+        IPlugin::SPtr pReceiver = mapPlugins.value(lConnectionNames.at(i).second);
+
+        if(!pSender || !pReceiver) {
+            qWarning() << "Skipping connection" << lConnectionNames.at(i).first << "->" << lConnectionNames.at(i).second;
+            continue;
+        }
+
+        PluginConnectorConnection::SPtr pConnection = PluginConnectorConnection::create(pSender, pReceiver);
+
+        if(!pConnection->isConnected()) {
+            qWarning() << "Could not connect" << lConnectionNames.at(i).first << "->" << lConnectionNames.at(i).second;
+            continue;
+        }
+
+        lConnections << pConnection;
+    }
+
+    //
+    // Run until the file is replayed and the pipeline went idle
+    //
+    double dSFreq = pSource.staticCast<BenchmarkSource>()->getSamplingFrequency();
+    qint64 iDrainMs = parser.value(drainOption).toLongLong();
+
+    monitor.start();
+
+    if(!sceneManager.startPlugins()) {
+        qCritical() << "Could not start the pipeline";
+        return 1;
+    }
+
+    QTimer timer;
+    QObject::connect(&timer, &QTimer::timeout, [&]() {
+        if(pSource->isFinished() && monitor.getIdleTime() > iDrainMs) {
+            timer.stop();
+            sceneManager.stopPlugins();
+            monitor.report(dSFreq);
+            app.quit();
+        }
+    });
+    timer.start(100);
+
+    return app.exec();
+}
@@ -46,6 +46,7 @@
 
 #include <scMeas/realtimeevokedset.h>
 #include <scMeas/realtimemultisamplearray.h>
+#include <scMeas/blocktrace.h>
 
 #include <rtprocessing/rtave.h>
 
@@ -139,6 +140,7 @@ bool Averaging::stop()
         m_pAveragingBuffer->releaseFromPop();
         m_pAveragingBuffer->releaseFromPush();
         m_pAveragingBuffer->clear();
+        m_pTraceStage->clear();
 //        m_pRTMSAOutput->data()->clear();
     }
 
@@ -181,7 +183,7 @@ void Averaging::update(SCMEASLIB::Measurement::SPtr pMeasurement)
     if(pRTMSA) {
         //Check if buffer initialized
         if(!m_pAveragingBuffer) {
-            m_pAveragingBuffer = CircularMatrixBuffer<double>::SPtr(new CircularMatrixBuffer<double>(64, pRTMSA->getNumChannels(), pRTMSA->getMultiSampleArray()[0].cols()));
+            m_pAveragingBuffer = CircularBuffer<SampleBlock>::SPtr(new CircularBuffer<SampleBlock>(64));
         }
 
          //Fiff information
@@ -204,11 +206,14 @@ void Averaging::update(SCMEASLIB::Measurement::SPtr pMeasurement)
             }
         }
 
-        // Append new data
+        // Append new data, the shared blocks are queued without copying them
         if(m_bProcessData) {
-            for(qint32 i = 0; i < pRTMSA->getMultiSampleArray().size(); ++i) {
+            QList<SampleBlock> lBlocks = pRTMSA->getSampleBlocks();
+            BlockHeader header = pRTMSA->getBlockHeader();
+            for(qint32 i = 0; i < lBlocks.size(); ++i) {
                 if(m_pRtAve) {
-                    m_pAveragingBuffer->push(&pRTMSA->getMultiSampleArray()[i]);
+                    m_pTraceStage->enqueue(header, lBlocks.at(i).data());
+                    m_pAveragingBuffer->push(lBlocks.at(i));
                 }
             }
         }
@@ -230,6 +235,8 @@ void Averaging::init()
     m_pAveragingOutput->data()->setName(QString("Plugin/%1").arg(this->getName()));//Provide name to auto store widget settings
     m_outputConnectors.append(m_pAveragingOutput);
 
+    m_pTraceStage = QSharedPointer<BlockTraceStage>::create(this->getName());
+
     //Add control widgets to output data (will be used by QuickControlView by the measurements display)
     m_pAveragingSettingsView = AveragingSettingsView::SPtr::create(QString("Plugin/%1").arg(this->getName()));
 
@@ -460,6 +467,9 @@ void Averaging::run()
 
     m_bProcessData = true;
 
+    //The evoked sets carry the header of the block which was appended last, i.e. the block which completed them
+    BlockHeader lastHeader;
+
     while(true) {
         {
             QMutexLocker locker(&m_qMutex);
@@ -475,13 +485,24 @@ void Averaging::run()
         }
 
         if(doProcessing) {
-            m_pRtAve->append(m_pAveragingBuffer->pop());
+            SampleBlock block = m_pAveragingBuffer->pop();
+            if(block) {
+                BlockHeader header = m_pTraceStage->take(block.data());
+                m_pTraceStage->dequeue(header);
+                m_pRtAve->append(*block);
+                m_pTraceStage->processed(header);
+
+                if(header.isValid()) {
+                    lastHeader = header;
+                }
+            }
 
             // Dispatch the inputs
             m_qMutex.lock();
             if(!m_qVecEvokedData.isEmpty()) {
                 FiffEvokedSet t_fiffEvokedSet = m_qVecEvokedData.takeFirst();
 
+                m_pAveragingOutput->data()->setBlockHeader(lastHeader);
                 m_pAveragingOutput->data()->setValue(t_fiffEvokedSet,
                                                      m_pFiffInfo,
                                                      m_lResponsibleTriggerTypes);
@@ -45,7 +45,7 @@
 #include "averaging_global.h"
 
 #include <scShared/Interfaces/IAlgorithm.h>
-#include <utils/generics/circularmatrixbuffer.h>
+#include <utils/generics/circularbuffer.h>
 
 
 //*************************************************************************************************************
@@ -70,6 +70,7 @@
 namespace SCMEASLIB{
     class RealTimeMultiSampleArray;
     class RealTimeEvokedSet;
+    class BlockTraceStage;
 }
 
 namespace RTPROCESSINGLIB{
@@ -241,7 +242,9 @@ private:
     SCSHAREDLIB::PluginInputData<SCMEASLIB::RealTimeMultiSampleArray>::SPtr     m_pAveragingInput;      /**< The RealTimeSampleArray of the Averaging input.*/
     SCSHAREDLIB::PluginOutputData<SCMEASLIB::RealTimeEvokedSet>::SPtr           m_pAveragingOutput;     /**< The RealTimeEvoked of the Averaging output.*/
 
-    IOBUFFER::CircularMatrixBuffer<double>::SPtr    m_pAveragingBuffer;
+    IOBUFFER::CircularBuffer<QSharedPointer<const Eigen::MatrixXd> >::SPtr    m_pAveragingBuffer;
+
+    QSharedPointer<SCMEASLIB::BlockTraceStage>      m_pTraceStage;                      /**< Traces the queued blocks, the plugin does not use the PluginScheduler. */
 
     QSharedPointer<DISPLIB::AveragingSettingsView>  m_pAveragingSettingsView;           /**< Holds averaging settings widget.*/
     QSharedPointer<DISPLIB::ArtifactSettingsView>   m_pArtifactSettingsView;            /**< Holds artifact settings widget.*/
@@ -82,6 +82,7 @@ using namespace IOBUFFER;
 using namespace SCMEASLIB;
 using namespace DISP3DLIB;
 using namespace DISPLIB;
+using namespace FIFFLIB;
 
 
 //*************************************************************************************************************
@@ -100,7 +101,7 @@ BabyMEG::BabyMEG()
 , m_sFiffCompensators(QCoreApplication::applicationDirPath() + "/resources/mne_scan/plugins/babymeg/compensator.fif")
 , m_sBadChannels(QCoreApplication::applicationDirPath() + "/resources/mne_scan/plugins/babymeg/both.bad")
 , m_iRecordingMSeconds(5*60*1000)
-, m_iSplitCount(0)
+, m_iBlocksDropped(0)
 , m_bDoContinousHPI(false)
 {
     m_pActionSetupProject = new QAction(QIcon(":/images/database.png"), tr("Setup Project"),this);
@@ -345,7 +346,6 @@ QWidget* BabyMEG::setupWidget()
 void BabyMEG::run()
 {
     MatrixXf matValue;
-    qint32 size = 0;
 
     while(m_bIsRunning) {
         if(m_pRawMatrixBuffer) {
@@ -363,20 +363,9 @@ void BabyMEG::run()
             //Create digital trigger information
             createDigTrig(matValue);
 
-            //Write raw data to fif file
-            if(m_bWriteToFile) {
-                size += matValue.rows()*matValue.cols() * 4;
-
-                if(size > MAX_DATA_LEN) {
-                    size = 0;
-                    this->splitRecordingFile();
-                }
-
-                m_mutex.lock();
-                m_pOutfid->write_raw_buffer(matValue.cast<double>());
-                m_mutex.unlock();
-            } else {
-                size = 0;
+            //Queue raw data for writing to fif file
+            if(m_bWriteToFile && m_pRawWriter) {
+                m_pRawWriter->write(matValue);
             }
 
             if(m_pRTMSABabyMEG) {
@@ -716,55 +705,21 @@ void BabyMEG::showSqdCtrlDialog()
 }
 
 
-//*************************************************************************************************************
-
-void BabyMEG::splitRecordingFile()
-{
-    //qDebug() << "Split recording file";
-    ++m_iSplitCount;
-    QString nextFileName = m_sRecordFile.remove("_raw.fif");
-    nextFileName += QString("-%1_raw.fif").arg(m_iSplitCount);
-
-    //Write the link to the next file
-    qint32 data;
-    m_pOutfid->start_block(FIFFB_REF);
-    data = FIFFV_ROLE_NEXT_FILE;
-    m_pOutfid->write_int(FIFF_REF_ROLE,&data);
-    m_pOutfid->write_string(FIFF_REF_FILE_NAME, nextFileName);
-    m_pOutfid->write_id(FIFF_REF_FILE_ID);//ToDo meas_id
-    data = m_iSplitCount - 1;
-    m_pOutfid->write_int(FIFF_REF_FILE_NUM, &data);
-    m_pOutfid->end_block(FIFFB_REF);
-
-    //finish file
-    m_pOutfid->finish_writing_raw();
-
-    //start next file
-    m_qFileOut.setFileName(nextFileName);
-    RowVectorXd cals;
-    MatrixXi sel;
-    m_pOutfid = FiffStream::start_writing_raw(m_qFileOut,
-                                              *m_pFiffInfo,
-                                              cals,
-                                              sel,
-                                              false);
-    fiff_int_t first = 0;
-    m_pOutfid->write_int(FIFF_FIRST_SAMPLE, &first);
-}
-
-
 //*************************************************************************************************************
 
 void BabyMEG::toggleRecordingFile()
 {
     //Setup writing to file
     if(m_bWriteToFile) {
-        m_mutex.lock();
-        m_pOutfid->finish_writing_raw();
-        m_mutex.unlock();
-
         m_bWriteToFile = false;
-        m_iSplitCount = 0;
+
+        //Writes the remaining blocks and finishes the file
+        if(m_pRawWriter) {
+            m_pRawWriter->close();
+            FiffRawWriter::Statistics statistics = m_pRawWriter->statistics();
+
+            qDebug() << "BabyMEG::toggleRecordingFile - Wrote" << statistics.iBlocksWritten << "blocks to" << statistics.iFileCount << "file(s)," << statistics.iBlocksDropped << "blocks dropped";
+        }
 
         //Stop record timer
         m_pRecordTimer->stop();
@@ -773,8 +728,6 @@ void BabyMEG::toggleRecordingFile()
 
         m_pActionRecordFile->setIcon(QIcon(":/images/record.png"));
     } else {
-        m_iSplitCount = 0;
-
         if(!m_pFiffInfo) {
             QMessageBox msgBox;
             msgBox.setText("FiffInfo missing!");
@@ -800,8 +753,7 @@ void BabyMEG::toggleRecordingFile()
             m_sRecordFile = m_pProjectSettingsView->getCurrentFileName();
         }
 
-        m_qFileOut.setFileName(m_sRecordFile);
-        if(m_qFileOut.exists()) {
+        if(QFile::exists(m_sRecordFile)) {
             QMessageBox msgBox;
             msgBox.setText("The file you want to write already exists.");
             msgBox.setInformativeText("Do you want to overwrite this file?");
@@ -819,15 +771,20 @@ void BabyMEG::toggleRecordingFile()
         }
 
         //Start/Prepare writing process. Actual writing is done in run() method.
-        m_mutex.lock();
-        RowVectorXd cals;
-        m_pOutfid = FiffStream::start_writing_raw(m_qFileOut,
-                                                  *m_pFiffInfo,
-                                                  cals);
-        fiff_int_t first = 0;
-        m_pOutfid->write_int(FIFF_FIRST_SAMPLE, &first);
-        m_mutex.unlock();
+        //The writer splits the recording into multiple files at the fif size limit
+        if(!m_pRawWriter) {
+            m_pRawWriter = QSharedPointer<FiffRawWriter>(new FiffRawWriter());
+        }
+
+        if(!m_pRawWriter->open(m_sRecordFile, *m_pFiffInfo)) {
+            QMessageBox msgBox;
+            msgBox.setText("The recording file could not be created.");
+            msgBox.setWindowFlags(Qt::WindowStaysOnTopHint);
+            msgBox.exec();
+            return;
+        }
 
+        m_iBlocksDropped = 0;
         m_bWriteToFile = true;
 
         //Start timers for record button blinking, recording timer and updating the elapsed time in the proj widget
@@ -1031,6 +988,16 @@ void BabyMEG::changeRecordingButton()
 void BabyMEG::onRecordingRemainingTimeChange()
 {
     m_pProjectSettingsView->setRecordingElapsedTime(m_recordingStartedTime.elapsed());
+
+    //Report blocks which did not make it into the file while the recording is still running
+    if(m_pRawWriter) {
+        FiffRawWriter::Statistics statistics = m_pRawWriter->statistics();
+
+        if(statistics.iBlocksDropped > m_iBlocksDropped) {
+            qWarning() << "BabyMEG::onRecordingRemainingTimeChange -" << statistics.iBlocksDropped - m_iBlocksDropped << "blocks could not be written to" << m_sRecordFile << (statistics.bError ? "(write error)" : "");
+            m_iBlocksDropped = statistics.iBlocksDropped;
+        }
+    }
 }
 
 
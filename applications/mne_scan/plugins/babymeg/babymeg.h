@@ -46,7 +46,7 @@
 #include "babymeg_global.h"
 
 #include <fiff/fiff_info.h>
-#include <fiff/fiff_stream.h>
+#include <fiff/fiff_raw_writer.h>
 
 #include <scShared/Interfaces/ISensor.h>
 #include <utils/generics/circularmatrixbuffer.h>
@@ -89,7 +89,6 @@ namespace DISPLIB {
     class ProjectSettingsView;
 }
 
-#define MAX_DATA_LEN    2000000000L
 #define MAX_POS         2000000000L
 
 
@@ -325,12 +324,6 @@ protected:
     */
     void showSqdCtrlDialog();
 
-    //=========================================================================================================
-    /**
-    * Determines current file. And starts a new one.
-    */
-    void splitRecordingFile();
-
     //=========================================================================================================
     /**
     * Starts or stops a file recording depending on the current recording state.
@@ -407,12 +400,12 @@ protected:
     QList<int>                              m_lTriggerChannelIndices;       /**< List of all trigger channel indices. */
 
     FIFFLIB::FiffInfo::SPtr                 m_pFiffInfo;                    /**< Fiff measurement info.*/
-    FIFFLIB::FiffStream::SPtr               m_pOutfid;                      /**< FiffStream to write to.*/
+    QSharedPointer<FIFFLIB::FiffRawWriter>  m_pRawWriter;                   /**< Writes the recording file in a background thread.*/
 
     qint16                                  m_iBlinkStatus;                 /**< The blink status of the recording button.*/
     qint32                                  m_iBufferSize;                  /**< The raw data buffer size.*/
-    qint32                                  m_iSplitCount;                  /**< File split count */
     int                                     m_iRecordingMSeconds;           /**< Recording length in mseconds.*/
+    qint64                                  m_iBlocksDropped;               /**< Number of blocks the raw writer dropped during the current recording.*/
 
     bool                                    m_bWriteToFile;                 /**< Flag for for writing the received samples to a file. Defined by the user via the GUI.*/
     bool                                    m_bUseRecordTimer;              /**< Flag whether to use data recording timer.*/
@@ -423,7 +416,6 @@ protected:
     QString                                 m_sFiffCompensators;            /**< Fiff compensator information */
     QString                                 m_sBadChannels;                 /**< Filename which contains a list of bad channels */
 
-    QFile                                   m_qFileOut;                     /**< QFile for writing to fif file.*/
     QMutex                                  m_mutex;                        /**< Mutex to guarantee thread safety.*/
     QTime                                   m_recordingStartedTime;         /**< The time when the recording started.*/
 
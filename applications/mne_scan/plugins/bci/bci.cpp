@@ -414,8 +414,9 @@ void BCI::updateSensor(SCMEASLIB::NewMeasurement::SPtr pMeasurement)
         {
             MatrixXd t_mat(pRTMSA->getNumChannels(), pRTMSA->getMultiArraySize());
 
+            QList<SampleBlock> lBlocks = pRTMSA->getSampleBlocks();
             for(unsigned char i = 0; i < pRTMSA->getMultiArraySize(); ++i)
-                t_mat.col(i) = pRTMSA->getMultiSampleArray()[i];
+                t_mat.col(i) = *lBlocks.at(i);
 
             m_pBCIBuffer_Sensor->push(&t_mat);
         }
@@ -46,6 +46,7 @@
 #include <utils/generics/circularmatrixbuffer.h>
 #include <scMeas/realtimemultisamplearray.h>
 #include <scMeas/realtimecov.h>
+#include <scShared/Management/pluginscheduler.h>
 #include <rtprocessing/rtcov.h>
 
 #include <fiff/fiff_info.h>
@@ -107,7 +108,7 @@ Covariance::Covariance()
 
 Covariance::~Covariance()
 {
-    if(this->isRunning())
+    if(m_bIsRunning)
         stop();
 }
 
@@ -159,10 +160,14 @@ bool Covariance::start()
 //        QThread::wait();
 //    }
 
-    m_bIsRunning = true;
+    // Blocks are processed on the shared scheduler instead of a dedicated thread
+    {
+        QMutexLocker locker(&m_mutexBlockHandler);
+        m_pBlockHandler = PluginScheduler::instance()->registerHandler(this->getName());
+    }
 
-    // Start threads
-    QThread::start();
+    m_bIsRunning = true;
+    m_bProcessData = true;
 
     return true;
 }
@@ -172,8 +177,18 @@ bool Covariance::start()
 
 bool Covariance::stop()
 {
-    //Wait until this thread is stopped
     m_bIsRunning = false;
+    m_bProcessData = false;
+
+    //Producers which already hold the handler see it closed, wait until all queued blocks are processed
+    PluginBlockHandler::SPtr pBlockHandler;
+    {
+        QMutexLocker locker(&m_mutexBlockHandler);
+        pBlockHandler = m_pBlockHandler;
+        m_pBlockHandler.clear();
+    }
+
+    PluginScheduler::instance()->unregisterHandler(pBlockHandler);
 
     return true;
 }
@@ -234,13 +249,23 @@ void Covariance::update(SCMEASLIB::Measurement::SPtr pMeasurement)
         }
 
 
-        if(m_bProcessData) {
-            MatrixXd t_mat;
+        PluginBlockHandler::SPtr pBlockHandler = blockHandler();
 
-            for(qint32 i = 0; i < pRTMSA->getMultiArraySize(); ++i) {
-                t_mat = pRTMSA->getMultiSampleArray()[i];
-                m_pRtCov->append(t_mat);
-            }
+        if(m_bProcessData && pBlockHandler) {
+            //Keep a reference to the shared blocks, the measurement is reset by the next setValue of the upstream plugin
+            QList<SampleBlock> lData = pRTMSA->getSampleBlocks();
+            BlockHeader header = pRTMSA->getBlockHeader();
+
+            pBlockHandler->post([this, lData, header]() {
+                {
+                    QMutexLocker locker(&m_mutexBlockHandler);
+                    m_lastBlockHeader = header;
+                }
+
+                for(qint32 i = 0; i < lData.size(); ++i) {
+                    m_pRtCov->append(*lData.at(i));
+                }
+            }, header);
         }
     }
 }
@@ -250,8 +275,29 @@ void Covariance::update(SCMEASLIB::Measurement::SPtr pMeasurement)
 
 void Covariance::appendCovariance(const FiffCov& p_pCovariance)
 {
-    QMutexLocker locker(&mutex);
-    m_qVecCovData.push_back(p_pCovariance);
+    PluginBlockHandler::SPtr pBlockHandler;
+    BlockHeader header;
+
+    {
+        QMutexLocker locker(&m_mutexBlockHandler);
+        pBlockHandler = m_pBlockHandler;
+        header = m_lastBlockHeader;
+    }
+
+    if(!pBlockHandler) {
+        return;
+    }
+
+    //Dispatch downstream from the scheduler rather than from the thread which emitted the result. The result can be
+    //emitted from within one of our own blocks, so never wait for queue space here and deliver in place if full.
+    //Once the handler is closed the plugin is stopping and the result is dropped.
+    if(!pBlockHandler->tryPost([this, p_pCovariance, header]() {
+            m_pCovarianceOutput->data()->setBlockHeader(header);
+            m_pCovarianceOutput->data()->setValue(p_pCovariance);
+        }) && !pBlockHandler->isClosed()) {
+        m_pCovarianceOutput->data()->setBlockHeader(header);
+        m_pCovarianceOutput->data()->setValue(p_pCovariance);
+    }
 }
 
 
@@ -268,26 +314,8 @@ void Covariance::changeSamples(qint32 samples)
 
 //*************************************************************************************************************
 
-void Covariance::run()
+PluginBlockHandler::SPtr Covariance::blockHandler()
 {
-    // Read Fiff Info
-    while(!m_pFiffInfo) {
-        msleep(10);// Wait for fiff Info
-    }
-
-    m_pCovarianceOutput->data()->setFiffInfo(m_pFiffInfo);
-
-    // Start processing data
-    m_bProcessData = true;
-
-    while (m_bIsRunning) {
-        if(m_bProcessData) {
-            //Add to covariance estimation
-            QMutexLocker locker(&mutex);
-            if(!m_qVecCovData.isEmpty()) {
-                m_pCovarianceOutput->data()->setValue(m_qVecCovData.takeFirst());
-            }
-        }
-    }
+    QMutexLocker locker(&m_mutexBlockHandler);
+    return m_pBlockHandler;
 }
-
@@ -59,6 +59,7 @@
 //=============================================================================================================
 
 #include <QVector>
+#include <QMutex>
 
 
 //*************************************************************************************************************
@@ -80,6 +81,10 @@ namespace SCMEASLIB {
     class RealTimeCov;
 }
 
+namespace SCSHAREDLIB {
+    class PluginBlockHandler;
+}
+
 
 //*************************************************************************************************************
 //=============================================================================================================
@@ -160,23 +165,28 @@ public:
 
     void changeSamples(qint32 samples);
 
-protected:
-    virtual void run();
-
 private:
-    QMutex      mutex;
+    //=========================================================================================================
+    /**
+    * Returns a reference to the current block handler. stop() may clear the handler from another thread at any
+    * time, so producers have to work on the returned copy.
+    *
+    * @return the block handler, null if the plugin is not running.
+    */
+    QSharedPointer<SCSHAREDLIB::PluginBlockHandler> blockHandler();
 
     bool        m_bIsRunning;                       /**< If thread is running */
     bool        m_bProcessData;                     /**< If data should be received for processing */
 
     qint32      m_iEstimationSamples;
 
-    QVector<FIFFLIB::FiffCov>                       m_qVecCovData;                  /**< Covariance data set */
-
     QAction*                                        m_pActionShowAdjustment;
 
     QSharedPointer<FIFFLIB::FiffInfo>               m_pFiffInfo;                    /**< Fiff measurement info.*/
     QSharedPointer<RTPROCESSINGLIB::RtCov>          m_pRtCov;                       /**< Real-time covariance. */
+    QSharedPointer<SCSHAREDLIB::PluginBlockHandler> m_pBlockHandler;                /**< Executes the incoming blocks on the shared plugin scheduler. */
+    QMutex                                          m_mutexBlockHandler;            /**< Guards m_pBlockHandler and m_lastBlockHeader. */
+    SCMEASLIB::BlockHeader                          m_lastBlockHeader;              /**< Header of the block appended last, forwarded with the covariance it completes. */
 
     QSharedPointer<CovarianceSettingsWidget>        m_pCovarianceWidget;
 
@@ -185,7 +185,7 @@ void DummyToolbox::update(SCMEASLIB::Measurement::SPtr pMeasurement)
     if(pRTMSA) {
         //Check if buffer initialized
         if(!m_pDummyBuffer) {
-            m_pDummyBuffer = CircularMatrixBuffer<double>::SPtr(new CircularMatrixBuffer<double>(64, pRTMSA->getNumChannels(), pRTMSA->getMultiSampleArray()[0].cols()));
+            m_pDummyBuffer = CircularMatrixBuffer<double>::SPtr(new CircularMatrixBuffer<double>(64, pRTMSA->getNumChannels(), pRTMSA->getSampleBlocks().at(0)->cols()));
         }
 
         //Fiff information
@@ -200,8 +200,9 @@ void DummyToolbox::update(SCMEASLIB::Measurement::SPtr pMeasurement)
 
         MatrixXd t_mat;
 
+        QList<SampleBlock> lBlocks = pRTMSA->getSampleBlocks();
         for(unsigned char i = 0; i < pRTMSA->getMultiArraySize(); ++i) {
-            t_mat = pRTMSA->getMultiSampleArray()[i];
+            t_mat = *lBlocks.at(i);
             m_pDummyBuffer->push(&t_mat);
         }
     }
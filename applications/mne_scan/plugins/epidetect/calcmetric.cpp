@@ -84,6 +84,9 @@ CalcMetric::CalcMetric()
     m_iFuzzyEnHistoryPosition = 0;
     m_iFuzzyEnStart = 0;
     m_iFuzzyEnStep = 10;
+    m_dSigmaTolerance = 0.05;
+    m_iChannelCount = 0;
+    m_iDataLength = 0;
     m_bSetNewP2P = false;
     m_bSetNewFuzzyEn = false;
     m_bSetNewKurtosis = false;
@@ -304,13 +307,8 @@ void CalcMetric::calcP2P()
 
     if (m_bSetNewP2P)
     {
-        m_dmatP2PHistory.col(m_iP2PHistoryPosition) = m_dvecP2P;
+        pushHistory(m_dmatP2PHistory, m_iP2PHistoryPosition, m_dvecP2P);
         m_bSetNewP2P = false;
-        m_iP2PHistoryPosition++;
-        if (m_iP2PHistoryPosition>(m_iListLength-1))
-        {
-            m_iP2PHistoryPosition = 0;
-        }
     }
 
     VectorXd max = m_dmatData.rowwise().maxCoeff();
@@ -375,11 +373,8 @@ void CalcMetric::calcKurtosis(int start, int end)
 
     if (m_bSetNewKurtosis)
     {
-        m_dmatKurtosisHistory.col(m_iKurtosisHistoryPosition) = m_dvecKurtosis;
+        pushHistory(m_dmatKurtosisHistory, m_iKurtosisHistoryPosition, m_dvecKurtosis);
         m_bSetNewKurtosis = false;
-        m_iKurtosisHistoryPosition++;
-        if (m_iKurtosisHistoryPosition>(m_iListLength-1))
-            m_iKurtosisHistoryPosition = 0;
     }
 
     m_dvecMean = m_dmatData.rowwise().mean();
@@ -416,12 +411,32 @@ void CalcMetric::calcKurtosis(int start, int end)
 
 //*************************************************************************************************************
 
-void CalcMetric::calcAll(Eigen::MatrixXd input, int dim, double r, double n)
+void CalcMetric::calcAll(Eigen::MatrixXd input, int dim, double r, double n, int iNumNewSamples)
 {
     this->setData(input);
-    this->calcP2P();
-    this->calcKurtosis(0,1000);
-    m_lFuzzyEnUsedChs.clear();
+
+    //Start over if the window layout or the parameters changed
+    if (!m_pSlidingMetric
+            || !m_pSlidingMetric->matches(m_iChannelCount, m_iDataLength, dim, r, n)
+            || iNumNewSamples < 0
+            || iNumNewSamples > m_iDataLength)
+    {
+        //A frozen tolerance avoids the O(window^2) recomputation of the FuzzyEn match sums on every block
+        m_pSlidingMetric = SlidingMetric::SPtr(new SlidingMetric(m_iChannelCount, m_iDataLength, dim, r, n, m_dSigmaTolerance));
+        iNumNewSamples = m_iDataLength;
+    }
+
+    m_pSlidingMetric->append(input, m_iDataLength - iNumNewSamples);
+
+    if (m_bSetNewP2P)
+    {
+        pushHistory(m_dmatP2PHistory, m_iP2PHistoryPosition, m_dvecP2P);
+    }
+
+    if (m_bSetNewKurtosis)
+    {
+        pushHistory(m_dmatKurtosisHistory, m_iKurtosisHistoryPosition, m_dvecKurtosis);
+    }
 
     if (m_iFuzzyEnStart == m_iFuzzyEnStep-1)
     {
@@ -435,33 +450,34 @@ void CalcMetric::calcAll(Eigen::MatrixXd input, int dim, double r, double n)
         }
     }
 
-    QList<QPair<RowVectorXd, QPair<QList<double>, int> > > inputList;
-
-    for (int i = m_iFuzzyEnStart; i< m_iChannelCount; i=i+m_iFuzzyEnStep)
-    {
-        m_lFuzzyEnUsedChs << i;
-        QPair<RowVectorXd, QPair<QList<double>, int> > funcInput = createInputList(input.row(i), dim, r, n, m_dvecMean(i), m_dvecStdDev(i));
-        inputList << funcInput;
-    }
-
-    QList<double> fuzzyEnResults;
-    QFuture<double> fuzzyEnFuture = mapped(inputList, calcFuzzyEn);
-    fuzzyEnFuture.waitForFinished();
-    QFutureIterator<double> futureResult(fuzzyEnFuture);
-    while (futureResult.hasNext())
-        fuzzyEnResults << futureResult.next();
+    m_dvecP2P = m_pSlidingMetric->getP2P();
+    m_dvecKurtosis = m_pSlidingMetric->getKurtosis();
+    m_dvecMean = m_pSlidingMetric->getMean();
+    m_dvecStdDev = m_pSlidingMetric->getStdDev();
+    m_dvecFuzzyEn = m_pSlidingMetric->getFuzzyEn();
+    m_bSetNewP2P = true;
+    m_bSetNewKurtosis = true;
 
-    int j = 0;
+    //FuzzyEn is up to date for every channel
+    m_lFuzzyEnUsedChs.clear();
 
-    for (int i = m_iFuzzyEnStart; i<m_iChannelCount; i=i+m_iFuzzyEnStep)
-    {
-        m_dvecFuzzyEn(i) = fuzzyEnResults[j];
-        j++;
-    }
+    for (int i = 0; i < m_iChannelCount; i++)
+        m_lFuzzyEnUsedChs << i;
 
     if (m_iFuzzyEnStart < m_iFuzzyEnStep-1)
         m_iFuzzyEnStart++;
     else
         m_iFuzzyEnStart = 0;
+}
+
+
+//*************************************************************************************************************
+
+void CalcMetric::pushHistory(MatrixXd& matHistory, int& iPosition, const VectorXd& vecValues)
+{
+    matHistory.col(iPosition) = vecValues;
+    iPosition++;
 
+    if (iPosition > (m_iListLength-1))
+        iPosition = 0;
 }
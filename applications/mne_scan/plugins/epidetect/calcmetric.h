@@ -42,6 +42,8 @@
 // INCLUDES
 //=============================================================================================================
 
+#include "slidingmetric.h"
+
 
 //*************************************************************************************************************
 //=============================================================================================================
@@ -91,14 +93,16 @@ public:
 
     //=========================================================================================================
     /**
-    * Handles calculation of measurements and multithreading.
+    * Handles calculation of measurements and multithreading. The measurements of all channels are updated
+    * incrementally, only the newest samples of the window are processed.
     *
     * @param [in] input matrix containing the newest dataset.
     * @param [in] dim embedding dimension of fuzzy entropy.
     * @param [in] r width of fuzzy exponential function.
     * @param [in] n step of fuzzy exponential function.
+    * @param [in] iNumNewSamples number of columns at the end of input which are new since the last call. -1 if the whole window is new.
     */
-    void calcAll(Eigen::MatrixXd input, int dim, double r, double n);
+    void calcAll(Eigen::MatrixXd input, int dim, double r, double n, int iNumNewSamples = -1);
 
     //=========================================================================================================
     /**
@@ -179,9 +183,20 @@ public:
 
     bool                                    m_bHistoryReady;            /**< True if m_dvecFuzzyEnHistory has no undefined values.*/
     int                                     m_iListLength;              /**< Number of values inside the history matrices for each channel.*/
-    int                                     m_iFuzzyEnStep;             /**< Number of channels which are skipped after every calculation of FuzzyEn.*/
+    int                                     m_iFuzzyEnStep;             /**< Number of calculations between two values stored inside the FuzzyEn history.*/
 
 private:
+    //=========================================================================================================
+    /**
+    * Stores values in a history matrix and advances the position inside the ring.
+    *
+    * @param [in,out] matHistory the history matrix.
+    * @param [in,out] iPosition column where the values are stored.
+    * @param [in] vecValues the values to store.
+    */
+    void pushHistory(Eigen::MatrixXd& matHistory, int& iPosition, const Eigen::VectorXd& vecValues);
+
+    SlidingMetric::SPtr                     m_pSlidingMetric;           /**< Incremental estimator of all measurements over the sliding window.*/
 
     Eigen::MatrixXd                         m_dmatData;                 /**< The currently used data-set.*/
     Eigen::Matrix<bool, Eigen::Dynamic, 1>  m_bFuzzyEnCalc;             /**< Contains information for each channel whether or not FuzzyEn has been calculated.*/
@@ -195,6 +210,8 @@ private:
 
     int                                     m_iFuzzyEnStart;            /**< FuzzyEn calculation begins at this position.*/
 
+    double                                  m_dSigmaTolerance;          /**< Relative drift of the standard deviation before the FuzzyEn match sums are recomputed.*/
+
     bool                                    m_bSetNewP2P;               /**< True if there is a new P2P value to be stored inside m_dmatP2PHistory.*/
     bool                                    m_bSetNewKurtosis;          /**< True if there is a new Kurtosis value to be stored inside m_dmatKurtosisHistory.*/
     bool                                    m_bSetNewFuzzyEn;           /**< True if there is a new FuzzyEn value to be stored inside m_dmatFuzzyEnHistory.*/
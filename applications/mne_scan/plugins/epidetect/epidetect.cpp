@@ -199,7 +199,7 @@ void Epidetect::update(SCMEASLIB::Measurement::SPtr pMeasurement)
     if(pRTMSA) {
         //Check if buffer initialized
         if(!m_pEpidetectBuffer) {
-            m_pEpidetectBuffer = CircularMatrixBuffer<double>::SPtr(new CircularMatrixBuffer<double>(64, pRTMSA->getNumChannels(), pRTMSA->getMultiSampleArray()[0].cols()));
+            m_pEpidetectBuffer = CircularMatrixBuffer<double>::SPtr(new CircularMatrixBuffer<double>(64, pRTMSA->getNumChannels(), pRTMSA->getSampleBlocks().at(0)->cols()));
         }
 
         //Fiff information
@@ -214,8 +214,9 @@ void Epidetect::update(SCMEASLIB::Measurement::SPtr pMeasurement)
 
         MatrixXd t_mat;
 
+        QList<SampleBlock> lBlocks = pRTMSA->getSampleBlocks();
         for(unsigned char i = 0; i < pRTMSA->getMultiArraySize(); ++i) {
-            t_mat = pRTMSA->getMultiSampleArray()[i];
+            t_mat = *lBlocks.at(i);
             m_pEpidetectBuffer->push(&t_mat);
         }
     }
@@ -310,17 +311,23 @@ void Epidetect::run()
         timer.start();
         MatrixXd window;
 
+        //Slide the window by half a block, it always holds the two most recent halves
+        int iHalf = trimmedData.cols()/2;
+        firstHalfTrimmed = lastHalfTrimmed;
+
         if (!overlap)
-        {
-            firstHalfTrimmed = trimmedData.block(0, 0, trimmedData.rows(), (trimmedData.cols()/2));
-            lastHalfTrimmed = trimmedData.block(0,(trimmedData.cols()/2), trimmedData.rows(), (trimmedData.cols()/2));
-            overlap = true;
-        }
+            lastHalfTrimmed = trimmedData.block(0, 0, trimmedData.rows(), iHalf);
         else
+            lastHalfTrimmed = trimmedData.block(0, iHalf, trimmedData.rows(), iHalf);
+
+        overlap = !overlap;
+
+        //No complete window yet, e.g. for the first half block
+        if (firstHalfTrimmed.rows() != lastHalfTrimmed.rows() || firstHalfTrimmed.cols() != lastHalfTrimmed.cols())
         {
-            firstHalfTrimmed = lastHalfTrimmed;
-            lastHalfTrimmed = trimmedData.block(0, 0, trimmedData.rows(), (trimmedData.cols()/2));
-            overlap = false;
+            if (!overlap)
+                m_pEpidetectOutput->data()->setValue(t_mat);
+            continue;
         }
 
         window.resize(firstHalfTrimmed.rows(), (firstHalfTrimmed.cols()+lastHalfTrimmed.cols()));
@@ -336,7 +343,7 @@ void Epidetect::run()
 
         calculator.m_iListLength = m_iListLength;
         calculator.m_iFuzzyEnStep = m_iFuzzyEnStep;
-        calculator.calcAll(window, m_iDim, m_dR , m_iN);
+        calculator.calcAll(window, m_iDim, m_dR , m_iN, lastHalfTrimmed.cols());
         MatrixXd mu;
         MatrixXd p2pHistory =calculator.getP2PHistory();
         MatrixXd kurtosisHistory = calculator.getKurtosisHistory();
@@ -409,7 +416,7 @@ void Epidetect::run()
             }
         }
 
-        if (overlap)
+        if (!overlap)
             m_pEpidetectOutput->data()->setValue(t_mat);
         std::cout << timer.elapsed() << " ms \n";
     }
@@ -72,7 +72,8 @@ SOURCES += \
         FormFiles/epidetectaboutwidget.cpp \
         FormFiles/epidetectwidget.cpp \
         calcmetric.cpp \
-        fuzzymembership.cpp
+        fuzzymembership.cpp \
+        slidingmetric.cpp
 
 HEADERS += \
         epidetect.h\
@@ -81,7 +82,8 @@ HEADERS += \
         FormFiles/epidetectaboutwidget.h \
         FormFiles/epidetectwidget.h \
         calcmetric.h \
-        fuzzymembership.h
+        fuzzymembership.h \
+        slidingmetric.h
 
 FORMS += \
         FormFiles/epidetectsetup.ui \
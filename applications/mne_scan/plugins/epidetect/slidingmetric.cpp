@@ -0,0 +1,485 @@
+//=============================================================================================================
+/**
+* @file     slidingmetric.cpp
+* @author   agent <agent@local>
+* @version  1.0
+* @date     October, 2026
+*
+* @section  LICENSE
+*
+* Copyright (C) 2026, agent. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+*
+* @brief    SlidingMetric class definition.
+*
+*/
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "slidingmetric.h"
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QtConcurrent/QtConcurrent>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// STL INCLUDES
+//=============================================================================================================
+
+#include <cmath>
+#include <limits>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// USED NAMESPACES
+//=============================================================================================================
+
+using namespace Eigen;
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE MEMBER METHODS
+//=============================================================================================================
+
+SlidingMetric::SlidingMetric(int iNumChannels,
+                             int iWindowSize,
+                             int iDim,
+                             double dR,
+                             double dN,
+                             double dSigmaTolerance)
+: m_iWindowSize(iWindowSize)
+, m_iDim(iDim)
+, m_dR(dR)
+, m_dN(dN)
+, m_dSigmaTolerance(dSigmaTolerance)
+, m_iNumSamples(0)
+{
+    ChannelState state;
+    state.vecRing = VectorXd::Zero(m_iWindowSize);
+    state.dShift = 0.0;
+    state.dSigma = 0.0;
+    state.iSinceRefresh = 0;
+
+    for(int i = 0; i < 5; ++i) {
+        state.dSums[i] = 0.0;
+    }
+
+    for(int k = 0; k < 2; ++k) {
+        state.matTemplates[k] = MatrixXd::Zero(m_iDim + k, m_iWindowSize);
+        state.vecMatchSum[k] = VectorXd::Zero(m_iWindowSize);
+        state.iFrontStart[k] = 0;
+        state.iNumTemplates[k] = 0;
+        state.dPhiSum[k] = 0.0;
+    }
+
+    m_vStates.fill(state, iNumChannels);
+}
+
+
+//*************************************************************************************************************
+
+void SlidingMetric::append(const MatrixXd& matData,
+                           int iStart)
+{
+    if(matData.rows() != m_vStates.size() || iStart >= matData.cols()) {
+        return;
+    }
+
+    QVector<int> vChannels(m_vStates.size());
+
+    for(int i = 0; i < vChannels.size(); ++i) {
+        vChannels[i] = i;
+    }
+
+    //The channels are independent, each one only touches its own state
+    QtConcurrent::blockingMap(vChannels, [this, &matData, iStart](const int& iChannel) {
+        appendChannel(iChannel, matData, iStart);
+    });
+
+    m_iNumSamples += matData.cols() - iStart;
+}
+
+
+//*************************************************************************************************************
+
+bool SlidingMetric::matches(int iNumChannels,
+                            int iWindowSize,
+                            int iDim,
+                            double dR,
+                            double dN) const
+{
+    return m_vStates.size() == iNumChannels
+            && m_iWindowSize == iWindowSize
+            && m_iDim == iDim
+            && m_dR == dR
+            && m_dN == dN;
+}
+
+
+//*************************************************************************************************************
+
+bool SlidingMetric::isReady() const
+{
+    return m_iNumSamples >= m_iWindowSize;
+}
+
+
+//*************************************************************************************************************
+
+VectorXd SlidingMetric::getP2P() const
+{
+    VectorXd vecP2P = VectorXd::Zero(m_vStates.size());
+
+    for(int i = 0; i < m_vStates.size(); ++i) {
+        const ChannelState& state = m_vStates.at(i);
+
+        if(!state.dequeMax.empty() && !state.dequeMin.empty()) {
+            vecP2P(i) = sample(state, state.dequeMax.front()) - sample(state, state.dequeMin.front());
+        }
+    }
+
+    return vecP2P;
+}
+
+
+//*************************************************************************************************************
+
+VectorXd SlidingMetric::getKurtosis() const
+{
+    VectorXd vecKurtosis = VectorXd::Zero(m_vStates.size());
+
+    for(int i = 0; i < m_vStates.size(); ++i) {
+        const ChannelState& state = m_vStates.at(i);
+        double dN = state.dSums[0];
+
+        if(dN < 2) {
+            continue;
+        }
+
+        //Central moments from the raw power sums of the shifted samples
+        double dMean = state.dSums[1] / dN;
+        double dMean2 = dMean * dMean;
+        double dM2 = state.dSums[2] / dN - dMean2;
+        double dM4 = state.dSums[4] / dN
+                     - 4.0 * dMean * state.dSums[3] / dN
+                     + 6.0 * dMean2 * state.dSums[2] / dN
+                     - 3.0 * dMean2 * dMean2;
+
+        if(dM2 > 0) {
+            vecKurtosis(i) = dM4 / (dM2 * dM2);
+        }
+    }
+
+    return vecKurtosis;
+}
+
+
+//*************************************************************************************************************
+
+VectorXd SlidingMetric::getMean() const
+{
+    VectorXd vecMean = VectorXd::Zero(m_vStates.size());
+
+    for(int i = 0; i < m_vStates.size(); ++i) {
+        const ChannelState& state = m_vStates.at(i);
+
+        if(state.dSums[0] > 0) {
+            vecMean(i) = state.dShift + state.dSums[1] / state.dSums[0];
+        }
+    }
+
+    return vecMean;
+}
+
+
+//*************************************************************************************************************
+
+VectorXd SlidingMetric::getStdDev() const
+{
+    VectorXd vecStdDev(m_vStates.size());
+
+    for(int i = 0; i < m_vStates.size(); ++i) {
+        vecStdDev(i) = stdDev(m_vStates.at(i));
+    }
+
+    return vecStdDev;
+}
+
+
+//*************************************************************************************************************
+
+VectorXd SlidingMetric::getFuzzyEn() const
+{
+    VectorXd vecFuzzyEn = VectorXd::Zero(m_vStates.size());
+
+    if(!isReady()) {
+        return vecFuzzyEn;
+    }
+
+    double dPhi[2];
+
+    for(int i = 0; i < m_vStates.size(); ++i) {
+        const ChannelState& state = m_vStates.at(i);
+
+        for(int k = 0; k < 2; ++k) {
+            //Same normalization as the block wise FuzzyEn
+            int m = m_iDim + k;
+            dPhi[k] = state.dPhiSum[k] / (double(m_iWindowSize - m - 1) * double(m_iWindowSize - m));
+        }
+
+        vecFuzzyEn(i) = std::log(dPhi[0]) - std::log(dPhi[1]);
+    }
+
+    return vecFuzzyEn;
+}
+
+
+//*************************************************************************************************************
+
+void SlidingMetric::appendChannel(int iChannel,
+                                  const MatrixXd& matData,
+                                  int iStart)
+{
+    ChannelState& state = m_vStates[iChannel];
+    const qint64 iFirst = m_iNumSamples - iStart;
+
+    for(int s = iStart; s < matData.cols(); ++s) {
+        const qint64 t = iFirst + s;
+        const double dValue = matData(iChannel, s);
+
+        if(t == 0) {
+            state.dShift = dValue;
+        }
+
+        //The oldest sample leaves the window
+        if(t >= m_iWindowSize) {
+            const qint64 iOld = t - m_iWindowSize;
+            const double d = sample(state, iOld) - state.dShift;
+            const double d2 = d * d;
+
+            state.dSums[0] -= 1.0;
+            state.dSums[1] -= d;
+            state.dSums[2] -= d2;
+            state.dSums[3] -= d2 * d;
+            state.dSums[4] -= d2 * d2;
+
+            if(!state.dequeMax.empty() && state.dequeMax.front() <= iOld) {
+                state.dequeMax.pop_front();
+            }
+
+            if(!state.dequeMin.empty() && state.dequeMin.front() <= iOld) {
+                state.dequeMin.pop_front();
+            }
+
+            //The template starting at the leaving sample only holds matches with templates inside the window
+            for(int k = 0; k < 2; ++k) {
+                if(state.iNumTemplates[k] > 0 && state.iFrontStart[k] == iOld) {
+                    state.dPhiSum[k] -= 2.0 * state.vecMatchSum[k](iOld % m_iWindowSize);
+                    ++state.iFrontStart[k];
+                    --state.iNumTemplates[k];
+                }
+            }
+        }
+
+        //The new sample enters the window
+        state.vecRing(t % m_iWindowSize) = dValue;
+
+        const double d = dValue - state.dShift;
+        const double d2 = d * d;
+
+        state.dSums[0] += 1.0;
+        state.dSums[1] += d;
+        state.dSums[2] += d2;
+        state.dSums[3] += d2 * d;
+        state.dSums[4] += d2 * d2;
+
+        while(!state.dequeMax.empty() && sample(state, state.dequeMax.back()) <= dValue) {
+            state.dequeMax.pop_back();
+        }
+        state.dequeMax.push_back(t);
+
+        while(!state.dequeMin.empty() && sample(state, state.dequeMin.back()) >= dValue) {
+            state.dequeMin.pop_back();
+        }
+        state.dequeMin.push_back(t);
+
+        //The templates ending at the new sample are matched against all templates inside the window
+        for(int k = 0; k < 2; ++k) {
+            const int m = m_iDim + k;
+            const qint64 iNewStart = t - m + 1;
+
+            if(iNewStart < 0 || m > m_iWindowSize) {
+                continue;
+            }
+
+            //Store the baseline corrected template, its column is free since the template which used it left
+            const int iColumn = iNewStart % m_iWindowSize;
+            double dMean = 0.0;
+
+            for(int l = 0; l < m; ++l) {
+                dMean += sample(state, iNewStart + l);
+            }
+            dMean /= m;
+
+            for(int l = 0; l < m; ++l) {
+                state.matTemplates[k](l, iColumn) = sample(state, iNewStart + l) - dMean;
+            }
+
+            if(state.iNumTemplates[k] == 0) {
+                state.iFrontStart[k] = iNewStart;
+            }
+
+            state.dPhiSum[k] += 2.0 * matchTemplate(state, k, iNewStart, state.iFrontStart[k], state.iNumTemplates[k]);
+            state.vecMatchSum[k](iColumn) = 0.0;
+            ++state.iNumTemplates[k];
+        }
+
+        //Bound the round-off of the incremental power sums
+        if(++state.iSinceRefresh >= m_iWindowSize) {
+            state.iSinceRefresh = 0;
+            refreshSums(state, t + 1);
+        }
+    }
+
+    //Recompute the match sums if the tolerance moved too far
+    double dSigma = stdDev(state);
+
+    if(state.dSigma <= 0 || std::fabs(dSigma - state.dSigma) > m_dSigmaTolerance * state.dSigma) {
+        rebase(state);
+    }
+}
+
+
+//*************************************************************************************************************
+
+double SlidingMetric::matchTemplate(ChannelState& state,
+                                    int k,
+                                    qint64 iTemplate,
+                                    qint64 iFrom,
+                                    int iCount) const
+{
+    if(state.dSigma <= 0 || iCount <= 0) {
+        return 0.0;
+    }
+
+    const VectorXd vecTemplate = state.matTemplates[k].col(iTemplate % m_iWindowSize);
+    const double dScale = 1.0 / state.dSigma;
+    double dTotal = 0.0;
+
+    //The older templates are contiguous in the ring, except for one wrap around
+    int iColumn = iFrom % m_iWindowSize;
+
+    while(iCount > 0) {
+        const int iLength = qMin(iCount, m_iWindowSize - iColumn);
+
+        ArrayXd arrDistance = (state.matTemplates[k].middleCols(iColumn, iLength).colwise() - vecTemplate)
+                              .cwiseAbs().colwise().maxCoeff().transpose().array() * dScale;
+        ArrayXd arrSim = m_dN == 2.0
+                         ? ArrayXd((-arrDistance.square() / m_dR).exp())
+                         : ArrayXd((-arrDistance.pow(m_dN) / m_dR).exp());
+
+        state.vecMatchSum[k].segment(iColumn, iLength) += arrSim.matrix();
+        dTotal += arrSim.sum();
+
+        iCount -= iLength;
+        iColumn = 0;
+    }
+
+    return dTotal;
+}
+
+
+//*************************************************************************************************************
+
+void SlidingMetric::refreshSums(ChannelState& state,
+                                qint64 iNext) const
+{
+    qint64 iNumSamples = qMin(iNext, qint64(m_iWindowSize));
+
+    if(iNumSamples == 0) {
+        return;
+    }
+
+    //Shift by the current mean, which keeps the central moments well conditioned
+    state.dShift += state.dSums[1] / state.dSums[0];
+
+    for(int i = 0; i < 5; ++i) {
+        state.dSums[i] = 0.0;
+    }
+
+    for(qint64 j = iNext - iNumSamples; j < iNext; ++j) {
+        const double d = sample(state, j) - state.dShift;
+        const double d2 = d * d;
+
+        state.dSums[0] += 1.0;
+        state.dSums[1] += d;
+        state.dSums[2] += d2;
+        state.dSums[3] += d2 * d;
+        state.dSums[4] += d2 * d2;
+    }
+}
+
+
+//*************************************************************************************************************
+
+void SlidingMetric::rebase(ChannelState& state) const
+{
+    state.dSigma = stdDev(state);
+
+    //Replay the template insertions in order, which yields the same sums as the incremental updates
+    for(int k = 0; k < 2; ++k) {
+        state.dPhiSum[k] = 0.0;
+        state.vecMatchSum[k].setZero();
+
+        for(int i = 1; i < state.iNumTemplates[k]; ++i) {
+            state.dPhiSum[k] += 2.0 * matchTemplate(state, k, state.iFrontStart[k] + i, state.iFrontStart[k], i);
+        }
+    }
+}
+
+
+//*************************************************************************************************************
+
+double SlidingMetric::stdDev(const ChannelState& state) const
+{
+    double dN = state.dSums[0];
+
+    if(dN < 2) {
+        return 0.0;
+    }
+
+    double dMean = state.dSums[1] / dN;
+    double dVar = (state.dSums[2] - dN * dMean * dMean) / (dN - 1);
+
+    return dVar > 0 ? std::sqrt(dVar) : 0.0;
+}
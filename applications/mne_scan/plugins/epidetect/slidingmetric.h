@@ -0,0 +1,273 @@
+//=============================================================================================================
+/**
+* @file     slidingmetric.h
+* @author   agent <agent@local>
+* @version  1.0
+* @date     October, 2026
+*
+* @section  LICENSE
+*
+* Copyright (C) 2026, agent. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+*
+* @brief    SlidingMetric class declaration.
+*
+*/
+
+#ifndef SLIDINGMETRIC_H
+#define SLIDINGMETRIC_H
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QSharedPointer>
+#include <QVector>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// Eigen INCLUDES
+//=============================================================================================================
+
+#include <Eigen/Core>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// STL INCLUDES
+//=============================================================================================================
+
+#include <deque>
+
+
+//=============================================================================================================
+/**
+* DECLARE CLASS SlidingMetric
+*
+* @brief Incremental peak-to-peak, kurtosis and Fuzzy Entropy estimators over a sliding window.
+*
+* Every new sample updates running power sums (mean, standard deviation, kurtosis), monotonic min/max queues
+* (peak-to-peak) and the template match sums of the Fuzzy Entropy. A template which enters the window is matched
+* against all templates inside the window once, the match sum of a leaving template is removed in O(1). The
+* similarity tolerance is the standard deviation of the window. It is frozen between rebases, which recompute all
+* match sums once the standard deviation drifted by more than the given relative tolerance. A rebase costs
+* O(window^2), so the tolerance should be larger than the usual block to block fluctuation of the standard deviation
+* (e.g. 0.05). A tolerance of zero rebases after every append and gives the same values as the block wise
+* computation.
+*/
+class SlidingMetric
+{
+
+public:
+    typedef QSharedPointer<SlidingMetric> SPtr;            /**< Shared pointer type for SlidingMetric. */
+    typedef QSharedPointer<const SlidingMetric> ConstSPtr; /**< Const shared pointer type for SlidingMetric. */
+
+    //=========================================================================================================
+    /**
+    * Constructs a SlidingMetric object.
+    *
+    * @param [in] iNumChannels      number of channels.
+    * @param [in] iWindowSize       length of the sliding window in samples.
+    * @param [in] iDim              embedding dimension of fuzzy entropy.
+    * @param [in] dR                width of fuzzy exponential function.
+    * @param [in] dN                step of fuzzy exponential function.
+    * @param [in] dSigmaTolerance   relative drift of the standard deviation which triggers a rebase of the match sums.
+    */
+    SlidingMetric(int iNumChannels,
+                  int iWindowSize,
+                  int iDim,
+                  double dR,
+                  double dN,
+                  double dSigmaTolerance = 0.0);
+
+    //=========================================================================================================
+    /**
+    * Slides the window over new samples. All channels are updated concurrently.
+    *
+    * @param [in] matData   matrix containing the new samples (channels x samples).
+    * @param [in] iStart    first column of matData which is new.
+    */
+    void append(const Eigen::MatrixXd& matData,
+                int iStart = 0);
+
+    //=========================================================================================================
+    /**
+    * Returns whether the estimator was set up with the given parameters.
+    *
+    * @param [in] iNumChannels      number of channels.
+    * @param [in] iWindowSize       length of the sliding window in samples.
+    * @param [in] iDim              embedding dimension of fuzzy entropy.
+    * @param [in] dR                width of fuzzy exponential function.
+    * @param [in] dN                step of fuzzy exponential function.
+    *
+    * @return true if all parameters match.
+    */
+    bool matches(int iNumChannels,
+                 int iWindowSize,
+                 int iDim,
+                 double dR,
+                 double dN) const;
+
+    //=========================================================================================================
+    /**
+    * Returns whether the window is completely filled.
+    *
+    * @return true if the window holds iWindowSize samples.
+    */
+    bool isReady() const;
+
+    //=========================================================================================================
+    /**
+    * Returns the peak-to-peak magnitude of the window for each channel.
+    *
+    * @return the peak-to-peak magnitudes.
+    */
+    Eigen::VectorXd getP2P() const;
+
+    //=========================================================================================================
+    /**
+    * Returns the kurtosis of the window for each channel.
+    *
+    * @return the kurtosis values.
+    */
+    Eigen::VectorXd getKurtosis() const;
+
+    //=========================================================================================================
+    /**
+    * Returns the mean of the window for each channel.
+    *
+    * @return the mean values.
+    */
+    Eigen::VectorXd getMean() const;
+
+    //=========================================================================================================
+    /**
+    * Returns the standard deviation of the window for each channel.
+    *
+    * @return the standard deviations.
+    */
+    Eigen::VectorXd getStdDev() const;
+
+    //=========================================================================================================
+    /**
+    * Returns the Fuzzy Entropy of the window for each channel.
+    *
+    * @return the Fuzzy Entropy values.
+    */
+    Eigen::VectorXd getFuzzyEn() const;
+
+private:
+    /**
+    * The state of one channel.
+    */
+    struct ChannelState {
+        Eigen::VectorXd         vecRing;            /**< The samples of the window, indexed by sample modulo window size. */
+        double                  dShift;             /**< Shift of the power sums to reduce cancellation. */
+        double                  dSums[5];           /**< Running sums of the shifted samples to the power of 0 to 4. */
+        std::deque<qint64>      dequeMax;           /**< Sample indices with decreasing values, front is the maximum. */
+        std::deque<qint64>      dequeMin;           /**< Sample indices with increasing values, front is the minimum. */
+        Eigen::MatrixXd         matTemplates[2];    /**< Baseline corrected templates of dimension m and m+1, indexed by their start modulo window size. */
+        Eigen::VectorXd         vecMatchSum[2];     /**< Sum of the similarities of each template to all templates which entered the window later. */
+        qint64                  iFrontStart[2];     /**< Start of the oldest template inside the window. */
+        int                     iNumTemplates[2];   /**< Number of templates inside the window. */
+        double                  dPhiSum[2];         /**< Sum of the similarities of all template pairs of dimension m and m+1. */
+        double                  dSigma;             /**< The tolerance the match sums were computed with. */
+        int                     iSinceRefresh;      /**< Number of samples since the power sums were recomputed. */
+    };
+
+    //=========================================================================================================
+    /**
+    * Slides the window of one channel.
+    *
+    * @param [in] iChannel  the channel index.
+    * @param [in] matData   matrix containing the new samples.
+    * @param [in] iStart    first column of matData which is new.
+    */
+    void appendChannel(int iChannel,
+                       const Eigen::MatrixXd& matData,
+                       int iStart);
+
+    //=========================================================================================================
+    /**
+    * Returns the value of a sample which is inside the window.
+    */
+    inline double sample(const ChannelState& state, qint64 iIndex) const;
+
+    //=========================================================================================================
+    /**
+    * Matches a template against a range of older templates. The similarities are added to the match sums of the
+    * older templates.
+    *
+    * @param [in] state     the channel state.
+    * @param [in] k         0 for dimension m, 1 for dimension m+1.
+    * @param [in] iTemplate start of the template.
+    * @param [in] iFrom     start of the first older template.
+    * @param [in] iCount    number of older templates.
+    *
+    * @return the sum of the similarities.
+    */
+    double matchTemplate(ChannelState& state, int k, qint64 iTemplate, qint64 iFrom, int iCount) const;
+
+    //=========================================================================================================
+    /**
+    * Recomputes the power sums from the window samples.
+    *
+    * @param [in] iNext     index of the next sample which is expected.
+    */
+    void refreshSums(ChannelState& state, qint64 iNext) const;
+
+    //=========================================================================================================
+    /**
+    * Recomputes all template match sums with the current standard deviation.
+    */
+    void rebase(ChannelState& state) const;
+
+    //=========================================================================================================
+    /**
+    * Returns the standard deviation of the window of one channel.
+    */
+    double stdDev(const ChannelState& state) const;
+
+    QVector<ChannelState>   m_vStates;              /**< The state of each channel. */
+    int                     m_iWindowSize;          /**< Length of the sliding window.*/
+    int                     m_iDim;                 /**< Embedding dimension of fuzzy entropy.*/
+    double                  m_dR;                   /**< Width of fuzzy exponential function.*/
+    double                  m_dN;                   /**< Step of fuzzy exponential function.*/
+    double                  m_dSigmaTolerance;      /**< Relative drift of the standard deviation which triggers a rebase.*/
+    qint64                  m_iNumSamples;          /**< Total number of samples seen.*/
+};
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INLINE DEFINITIONS
+//=============================================================================================================
+
+inline double SlidingMetric::sample(const ChannelState& state, qint64 iIndex) const
+{
+    return state.vecRing(iIndex % m_iWindowSize);
+}
+
+
+#endif // SLIDINGMETRIC_H
@@ -92,11 +92,14 @@ MNESetupWidget::MNESetupWidget(MNE* toolbox, QWidget *parent)
     else
         ui.m_qLabel_surfaceStat->setText("loaded");
 
+    ui.m_qCheckBox_FloatKernel->setChecked(m_pMNE->m_bUseFloatKernel);
+
     connect(ui.m_qPushButton_About, &QPushButton::released, this, &MNESetupWidget::showAboutDialog);
     connect(ui.m_qPushButton_FwdFileDialog, &QPushButton::released, this, &MNESetupWidget::showFwdFileDialog);
     connect(ui.m_qPushButton_AtlasDirDialog, &QPushButton::released, this, &MNESetupWidget::showAtlasDirDialog);
     connect(ui.m_qPushButton_SurfaceDirDialog, &QPushButton::released, this, &MNESetupWidget::showSurfaceDirDialog);
     connect(ui.m_qPushButonStartClustering, &QPushButton::released, this, &MNESetupWidget::clusteringTriggered);
+    connect(ui.m_qCheckBox_FloatKernel, &QCheckBox::toggled, m_pMNE, &MNE::onUseFloatKernelChanged);
 }
 
 
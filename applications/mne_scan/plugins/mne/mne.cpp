@@ -61,6 +61,7 @@
 #include <scMeas/realtimemultisamplearray.h>
 #include <scMeas/realtimecov.h>
 #include <scMeas/realtimeevokedset.h>
+#include <scMeas/blocktrace.h>
 
 #include <utils/ioutils.h>
 
@@ -72,6 +73,7 @@
 #include <QtCore/QtPlugin>
 #include <QtConcurrent>
 #include <QDebug>
+#include <QSettings>
 
 
 //*************************************************************************************************************
@@ -99,6 +101,7 @@ MNE::MNE()
 , m_bReceiveData(false)
 , m_bProcessData(false)
 , m_bFinishedClustering(false)
+, m_bUseFloatKernel(false)
 , m_qFileFwdSolution(QCoreApplication::applicationDirPath() + "/MNE-sample-data/MEG/sample/sample_audvis-meg-eeg-oct-6-fwd.fif")
 , m_sAtlasDir(QCoreApplication::applicationDirPath() + "/MNE-sample-data/subjects/sample/label")
 , m_sSurfaceDir(QCoreApplication::applicationDirPath() + "/MNE-sample-data/subjects/sample/surf")
@@ -136,6 +139,9 @@ QSharedPointer<IPlugin> MNE::clone() const
 
 void MNE::init()
 {
+    QSettings settings;
+    m_bUseFloatKernel = settings.value(QString("Plugin/%1/useFloatKernel").arg(this->getName()), false).toBool();
+
     // Inits
     m_pFwd = MNEForwardSolution::SPtr(new MNEForwardSolution(m_qFileFwdSolution, false, true));
     m_pAnnotationSet = AnnotationSet::SPtr(new AnnotationSet(m_sAtlasDir+"/lh.aparc.a2009s.annot", m_sAtlasDir+"/rh.aparc.a2009s.annot"));
@@ -160,6 +166,8 @@ void MNE::init()
     // Output
     m_pRTSEOutput = PluginOutputData<RealTimeSourceEstimate>::create(this, "MNE Out", "MNE output data");
     m_outputConnectors.append(m_pRTSEOutput);
+
+    m_pTraceStage = QSharedPointer<BlockTraceStage>::create(this->getName());
     m_pRTSEOutput->data()->setName(this->getName());//Provide name to auto store widget settings
 
     //Add control widgets to output data (will be used by QuickControlView in RealTimeSourceEstimateWidget)
@@ -186,7 +194,8 @@ void MNE::init()
 
 void MNE::unload()
 {
-
+    QSettings settings;
+    settings.setValue(QString("Plugin/%1/useFloatKernel").arg(this->getName()), m_bUseFloatKernel);
 }
 
 
@@ -258,11 +267,14 @@ void MNE::calcFiffInfo()
             }
         }
 
+        //The channel names were changed in place
+        m_pFiffInfoForward->invalidateChannelIndex();
+
         //Pick only channels which are present in all data structures (covariance, evoked and forward)
         QStringList tmp_pick_ch_names;
         foreach (const QString &ch, m_pFiffInfoForward->ch_names)
         {
-            if(m_pFiffInfoInput->ch_names.contains(ch))
+            if(m_pFiffInfoInput->channelIndex(ch) >= 0)
                 tmp_pick_ch_names << ch;
         }
         m_qListPickChannels.clear();
@@ -344,6 +356,8 @@ bool MNE::stop()
     // Only clear if buffers have been initialised
     if(m_bProcessData) {
         m_qVecFiffEvoked.clear();
+        m_qVecEvokedHeaders.clear();
+        m_pTraceStage->clear();
     }
 
     m_qListCovChNames.clear();
@@ -404,7 +418,7 @@ void MNE::updateRTMSA(SCMEASLIB::Measurement::SPtr pMeasurement)
 
         //Check if buffer initialized
         if(!m_pMatrixDataBuffer) {
-            m_pMatrixDataBuffer = CircularMatrixBuffer<double>::SPtr(new CircularMatrixBuffer<double>(64, pRTMSA->getNumChannels(), pRTMSA->getMultiSampleArray()[0].cols()));
+            m_pMatrixDataBuffer = CircularBuffer<SampleBlock>::SPtr(new CircularBuffer<SampleBlock>(64));
         }
 
         //Fiff Information of the RTMSA
@@ -414,17 +428,20 @@ void MNE::updateRTMSA(SCMEASLIB::Measurement::SPtr pMeasurement)
         }
 
         if(m_bProcessData) {
-            for(qint32 i = 0; i < pRTMSA->getMultiSampleArray().size(); ++i) {
+            QList<SampleBlock> lBlocks = pRTMSA->getSampleBlocks();
+            BlockHeader header = pRTMSA->getBlockHeader();
+            for(qint32 i = 0; i < lBlocks.size(); ++i) {
                 // Check for artifacts                
                 QMap<QString,double> mapReject;
                 mapReject.insert("eog", 150e-06);
 
-                bool bArtifactDetected = MNEEpochDataList::checkForArtifact(pRTMSA->getMultiSampleArray()[i],
+                bool bArtifactDetected = MNEEpochDataList::checkForArtifact(*lBlocks.at(i),
                                                                             *m_pFiffInfoInput,
                                                                             mapReject);
 
                 if(!bArtifactDetected) {
-                    m_pMatrixDataBuffer->push(&pRTMSA->getMultiSampleArray()[i]);
+                    m_pTraceStage->enqueue(header, lBlocks.at(i).data());
+                    m_pMatrixDataBuffer->push(lBlocks.at(i));
                 } else {
                     qDebug() << "MNE::updateRTMSA - Reject data block";
                 }
@@ -501,6 +518,8 @@ void MNE::updateRTE(SCMEASLIB::Measurement::SPtr pMeasurement)
             if(pFiffEvokedSet->evoked.at(i).comment == m_sAvrType) {
                 //qDebug()<<"MNE::updateRTE - average found type" << m_sAvrType;
                 m_qVecFiffEvoked.push_back(pFiffEvokedSet->evoked.at(i).pick_channels(m_qListPickChannels));
+                m_qVecEvokedHeaders.push_back(pRTES->getBlockHeader());
+                m_pTraceStage->enqueue(m_qVecEvokedHeaders.last());
                 break;
             }
         }
@@ -521,12 +540,29 @@ void MNE::updateInvOp(const MNEInverseOperator& invOp)
 
     m_pMinimumNorm = MinimumNorm::SPtr(new MinimumNorm(m_invOp, lambda2, m_sMethod));
 
+    // Single precision halves the memory traffic of the kernel, which is applied to every incoming block
+    m_pMinimumNorm->setUseFloatKernel(m_bUseFloatKernel);
+
     //Set up the inverse according to the parameters
     // Use 1 nave here because in case of evoked data as input the minimum norm will always be updated when the source estimate is calculated (see run method).
     m_pMinimumNorm->doInverseSetup(1,true);
 }
 
 
+//*************************************************************************************************************
+
+void MNE::onUseFloatKernelChanged(bool bUseFloatKernel)
+{
+    QMutexLocker locker(&m_qMutex);
+
+    m_bUseFloatKernel = bUseFloatKernel;
+
+    if(m_pMinimumNorm) {
+        m_pMinimumNorm->setUseFloatKernel(m_bUseFloatKernel);
+    }
+}
+
+
 //*************************************************************************************************************
 
 void MNE::onMethodChanged(const QString& method)
@@ -536,9 +572,8 @@ void MNE::onMethodChanged(const QString& method)
     QMutexLocker locker(&m_qMutex);
 
     if(m_pMinimumNorm) {
-        double snr = 1.0;
-        double lambda2 = 1.0 / pow(snr, 2); //ToDo estimate lambda using covariance
-        m_pMinimumNorm = MinimumNorm::SPtr(new MinimumNorm(m_invOp, lambda2, m_sMethod));
+        // Keep the minimum norm object, so previously prepared kernels are taken from its kernel cache
+        m_pMinimumNorm->setMethod(m_sMethod);
 
         // Set up the inverse according to the parameters.
         // Use 1 nave here because in case of evoked data as input the minimum norm will always be updated when the source estimate is calculated (see run method).
@@ -565,7 +600,9 @@ void MNE::onTimePointValueChanged(int iTimePointMs)
         m_iTimePointSps = m_pFiffInfoInput->sfreq * (float)iTimePointMs * 0.001;
 
         if(m_bProcessData) {
+            //Recomputed for display only, not traced
             m_qVecFiffEvoked.push_back(m_currentEvoked);
+            m_qVecEvokedHeaders.push_back(BlockHeader());
         }
     }
 }
@@ -646,7 +683,8 @@ void MNE::run()
 
     qint32 skip_count = 0;
     qint32 t_evokedSize;
-    MatrixXd rawSegment;
+    SampleBlock rawBlock;
+    BlockHeader header;
     MatrixXd data;
     qint32 j;
     float tmin, tstep;
@@ -659,14 +697,20 @@ void MNE::run()
             //qDebug()<<"MNE::run - Processing RTMSA data";
 
             if(m_pMinimumNorm && ((skip_count % m_iDownSample) == 0)) {
-                rawSegment = m_pMatrixDataBuffer->pop();
+                rawBlock = m_pMatrixDataBuffer->pop();
+                if(!rawBlock) {
+                    continue;
+                }
+                header = m_pTraceStage->take(rawBlock.data());
+                m_pTraceStage->dequeue(header);
+                const MatrixXd& rawSegment = *rawBlock;
 
                 //Pick the same channels as in the inverse operator
                 m_qMutex.lock();
                 data.resize(m_invOp.noise_cov->names.size(), rawSegment.cols());
 
                 for(j = 0; j < m_invOp.noise_cov->names.size(); ++j) {
-                    data.row(j) = rawSegment.row(m_pFiffInfoInput->ch_names.indexOf(m_invOp.noise_cov->names.at(j)));
+                    data.row(j) = rawSegment.row(m_pFiffInfoInput->channelIndex(m_invOp.noise_cov->names.at(j)));
                 }
 
                 tmin = 0.0f;
@@ -680,12 +724,16 @@ void MNE::run()
 
                 m_qMutex.unlock();
 
+                m_pTraceStage->processed(header);
+
                 if(!sourceEstimate.isEmpty()) {
                     //qInfo() << QDateTime::currentDateTime().toString("hh:mm:ss.z") << m_iBlockNumberProcessed++ << "MNE Processed";
+                    m_pRTSEOutput->data()->setBlockHeader(header);
                     m_pRTSEOutput->data()->setValue(sourceEstimate);
                 }
             } else {
-                m_pMatrixDataBuffer->pop();
+                rawBlock = m_pMatrixDataBuffer->pop();
+                m_pTraceStage->take(rawBlock.data());
             }
 
             ++skip_count;
@@ -702,6 +750,8 @@ void MNE::run()
 
                 m_qMutex.lock();
                 m_currentEvoked = m_qVecFiffEvoked.takeFirst();
+                header = m_qVecEvokedHeaders.takeFirst();
+                m_pTraceStage->dequeue(header);
                 QElapsedTimer time;
                 time.start();
                 //qDebug()<<"MNE::run - t_fiffEvoked.data.rows()"<<t_fiffEvoked.data.rows();
@@ -720,6 +770,8 @@ void MNE::run()
 
                 m_qMutex.unlock();
 
+                m_pTraceStage->processed(header);
+
                 if(!sourceEstimate.isEmpty()) {
                     //qInfo() << time.elapsed() << m_iBlockNumberProcessed << "MNE Time";
                     //qInfo() << QDateTime::currentDateTime().toString("hh:mm:ss.z") << m_iBlockNumberProcessed++ << "MNE Processed";
@@ -727,6 +779,7 @@ void MNE::run()
 //                    if(m_iTimePointSps < m_currentEvoked.data.cols()) {
 //                        m_pRTSEOutput->data()->setValue(sourceEstimate.reduce(m_iTimePointSps,1));
 //                    } else {
+                        m_pRTSEOutput->data()->setBlockHeader(header);
                         m_pRTSEOutput->data()->setValue(sourceEstimate);
 //                    }
                 }
@@ -734,6 +787,7 @@ void MNE::run()
             } else {
                 m_qMutex.lock();
                 m_qVecFiffEvoked.pop_front();
+                m_qVecEvokedHeaders.pop_front();
                 m_qMutex.unlock();
             }
 
@@ -46,7 +46,7 @@
 
 #include <scShared/Interfaces/IAlgorithm.h>
 
-#include <utils/generics/circularmatrixbuffer.h>
+#include <utils/generics/circularbuffer.h>
 
 #include <fiff/fiff_evoked.h>
 
@@ -100,6 +100,7 @@ namespace SCMEASLIB {
     class RealTimeMultiSampleArray;
     class RealTimeCov;
     class RealTimeSourceEstimate;
+    class BlockTraceStage;
 }
 
 
@@ -230,13 +231,21 @@ protected:
     */
     void onTimePointValueChanged(int iTimePointMs);
 
+    //=========================================================================================================
+    /**
+    * Slot called when the single precision kernel setting changed.
+    *
+    * @param [in] bUseFloatKernel     Whether to apply the inverse kernel in single precision.
+    */
+    void onUseFloatKernelChanged(bool bUseFloatKernel);
+
     virtual void run();
 
     QSharedPointer<SCSHAREDLIB::PluginInputData<SCMEASLIB::RealTimeMultiSampleArray> >      m_pRTMSAInput;              /**< The RealTimeMultiSampleArray input.*/
     QSharedPointer<SCSHAREDLIB::PluginInputData<SCMEASLIB::RealTimeEvokedSet> >             m_pRTESInput;               /**< The RealTimeEvoked input.*/
     QSharedPointer<SCSHAREDLIB::PluginInputData<SCMEASLIB::RealTimeCov> >                   m_pRTCInput;                /**< The RealTimeCov input.*/
     QSharedPointer<SCSHAREDLIB::PluginOutputData<SCMEASLIB::RealTimeSourceEstimate> >       m_pRTSEOutput;              /**< The RealTimeSourceEstimate output.*/
-    QSharedPointer<IOBUFFER::CircularMatrixBuffer<double> >                                 m_pMatrixDataBuffer;        /**< Holds incoming RealTimeMultiSampleArray data.*/
+    QSharedPointer<IOBUFFER::CircularBuffer<QSharedPointer<const Eigen::MatrixXd> > >      m_pMatrixDataBuffer;        /**< Holds the shared blocks of incoming RealTimeMultiSampleArray data.*/
     QSharedPointer<INVERSELIB::MinimumNorm>                                                 m_pMinimumNorm;             /**< Minimum Norm Estimation. */
     QSharedPointer<RTPROCESSINGLIB::RtInvOp>                                                m_pRtInvOp;                 /**< Real-time inverse operator. */
     QSharedPointer<MNELIB::MNEForwardSolution>                                              m_pFwd;                     /**< Forward solution. */
@@ -253,6 +262,8 @@ protected:
     QFuture<void>                   m_future;                   /**< The future monitoring the clustering. */
 
     QVector<FIFFLIB::FiffEvoked>    m_qVecFiffEvoked;           /**< The list of stored averages. */
+    QVector<SCMEASLIB::BlockHeader> m_qVecEvokedHeaders;        /**< The trace headers of the stored averages. */
+    QSharedPointer<SCMEASLIB::BlockTraceStage>  m_pTraceStage;  /**< Traces the queued blocks, the plugin does not use the PluginScheduler. */
     FIFFLIB::FiffEvoked             m_currentEvoked;
 
     qint32                          m_iNumAverages;             /**< The number of trials/averages to store. */
@@ -263,6 +274,7 @@ protected:
     bool                            m_bReceiveData;             /**< If thread is ready to receive data. */
     bool                            m_bProcessData;             /**< If data should be received for processing. */
     bool                            m_bFinishedClustering;      /**< If clustered forward solution is available. */
+    bool                            m_bUseFloatKernel;          /**< If the inverse kernel is applied in single precision. */
 
     QFile                           m_qFileFwdSolution;         /**< File to forward solution. */
 
@@ -46,6 +46,7 @@
 
 #include <fiff/fiff_dir_node.h>
 #include <fiff/fiff_stream.h>
+#include <fiff/fiff_raw_writer.h>
 #include <scMeas/realtimemultisamplearray.h>
 #include <disp/viewers/projectsettingsview.h>
 #include <fiff/fiff_info.h>
@@ -97,6 +98,7 @@ Neuromag::Neuromag()
 , m_iActiveConnectorId(0)
 , m_bWriteToFile(false)
 , m_iRecordingMSeconds(5*60*1000)
+, m_iBlocksDropped(0)
 {
     m_pActionSetupProject = new QAction(QIcon(":/images/database.png"), tr("Setup Project"),this);
     m_pActionSetupProject->setStatusTip(tr("Setup Project"));
@@ -227,52 +229,21 @@ void Neuromag::showProjectDialog()
 }
 
 
-//*************************************************************************************************************
-
-void Neuromag::splitRecordingFile()
-{
-    qDebug() << "Neuromag::splitRecordingFile - Splitting recording file";
-    ++m_iSplitCount;
-    QString nextFileName = m_sRecordFile.remove("_raw.fif");
-    nextFileName += QString("-%1_raw.fif").arg(m_iSplitCount);
-
-    // Write the link to the next file
-    qint32 data;
-    m_pOutfid->start_block(FIFFB_REF);
-    data = FIFFV_ROLE_NEXT_FILE;
-    m_pOutfid->write_int(FIFF_REF_ROLE,&data);
-    m_pOutfid->write_string(FIFF_REF_FILE_NAME, nextFileName);
-    m_pOutfid->write_id(FIFF_REF_FILE_ID);//ToDo meas_id
-    data = m_iSplitCount - 1;
-    m_pOutfid->write_int(FIFF_REF_FILE_NUM, &data);
-    m_pOutfid->end_block(FIFFB_REF);
-
-    //finish file
-    m_pOutfid->finish_writing_raw();
-
-    //start next file
-    m_qFileOut.setFileName(nextFileName);
-    RowVectorXd cals;
-    m_pOutfid = FiffStream::start_writing_raw(m_qFileOut,
-                                              *m_pFiffInfo,
-                                              cals);
-    fiff_int_t first = 0;
-    m_pOutfid->write_int(FIFF_FIRST_SAMPLE, &first);
-}
-
-
 //*************************************************************************************************************
 
 void Neuromag::toggleRecordingFile()
 {
     //Setup writing to file
     if(m_bWriteToFile) {
-        m_mutex.lock();
-        m_pOutfid->finish_writing_raw();
-        m_mutex.unlock();
-
         m_bWriteToFile = false;
-        m_iSplitCount = 0;
+
+        //Writes the remaining blocks and finishes the file
+        if(m_pRawWriter) {
+            m_pRawWriter->close();
+            FiffRawWriter::Statistics statistics = m_pRawWriter->statistics();
+
+            qDebug() << "Neuromag::toggleRecordingFile - Wrote" << statistics.iBlocksWritten << "blocks to" << statistics.iFileCount << "file(s)," << statistics.iBlocksDropped << "blocks dropped";
+        }
 
         //Stop record timer
         m_pRecordTimer->stop();
@@ -281,8 +252,6 @@ void Neuromag::toggleRecordingFile()
 
         m_pActionRecordFile->setIcon(QIcon(":/images/record.png"));
     } else {
-        m_iSplitCount = 0;
-
         if(!m_pFiffInfo) {
             QMessageBox msgBox;
             msgBox.setText("FiffInfo missing!");
@@ -307,8 +276,7 @@ void Neuromag::toggleRecordingFile()
             m_sRecordFile = m_pProjectSettingsView->getCurrentFileName();
         }
 
-        m_qFileOut.setFileName(m_sRecordFile);
-        if(m_qFileOut.exists()) {
+        if(QFile::exists(m_sRecordFile)) {
             QMessageBox msgBox;
             msgBox.setText("The file you want to write already exists.");
             msgBox.setInformativeText("Do you want to overwrite this file?");
@@ -324,15 +292,20 @@ void Neuromag::toggleRecordingFile()
             m_pFiffInfo->projs[i].active = false;
         }
 
-        m_mutex.lock();
-        RowVectorXd cals;
-        m_pOutfid = FiffStream::start_writing_raw(m_qFileOut,
-                                                  *m_pFiffInfo,
-                                                  cals);
-        fiff_int_t first = 0;
-        m_pOutfid->write_int(FIFF_FIRST_SAMPLE, &first);
-        m_mutex.unlock();
+        //The writer splits the recording into multiple files at the fif size limit
+        if(!m_pRawWriter) {
+            m_pRawWriter = QSharedPointer<FiffRawWriter>(new FiffRawWriter());
+        }
 
+        if(!m_pRawWriter->open(m_sRecordFile, *m_pFiffInfo)) {
+            QMessageBox msgBox;
+            msgBox.setText("The recording file could not be created.");
+            msgBox.setWindowFlags(Qt::WindowStaysOnTopHint);
+            msgBox.exec();
+            return;
+        }
+
+        m_iBlocksDropped = 0;
         m_bWriteToFile = true;
 
         //Start timers for record button blinking, recording timer and updating the elapsed time in the proj widget
@@ -652,29 +625,14 @@ void Neuromag::run()
 {
     MatrixXf matValue;
 
-    qint32 size = 0;
-
     while(m_bIsRunning) {
         if(m_pRawMatrixBuffer_In) {
             //pop matrix
             matValue = m_pRawMatrixBuffer_In->pop();
 
-            //Write raw data to fif file
-            if(m_bWriteToFile) {
-                size += matValue.rows()*matValue.cols() * 4;
-
-                if(size > MAX_DATA_LEN) {
-                    size = 0;
-                    this->splitRecordingFile();
-                }
-
-                m_mutex.lock();
-                if(m_pOutfid) {
-                    m_pOutfid->write_raw_buffer(matValue.cast<double>());
-                }
-                m_mutex.unlock();
-            } else {
-                size = 0;
+            //Queue raw data for writing to fif file
+            if(m_bWriteToFile && m_pRawWriter) {
+                m_pRawWriter->write(matValue);
             }
 
             if(m_pRTMSA_Neuromag) {
@@ -719,6 +677,16 @@ void Neuromag::changeRecordingButton()
 void Neuromag::onRecordingRemainingTimeChange()
 {
     m_pProjectSettingsView->setRecordingElapsedTime(m_recordingStartedTime.elapsed());
+
+    //Report blocks which did not make it into the file while the recording is still running
+    if(m_pRawWriter) {
+        FiffRawWriter::Statistics statistics = m_pRawWriter->statistics();
+
+        if(statistics.iBlocksDropped > m_iBlocksDropped) {
+            qWarning() << "Neuromag::onRecordingRemainingTimeChange -" << statistics.iBlocksDropped - m_iBlocksDropped << "blocks could not be written to" << m_sRecordFile << (statistics.bError ? "(write error)" : "");
+            m_iBlocksDropped = statistics.iBlocksDropped;
+        }
+    }
 }
 
 
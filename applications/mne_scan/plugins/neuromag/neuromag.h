@@ -73,7 +73,6 @@
 // DEFINES
 //=============================================================================================================
 
-#define MAX_DATA_LEN    2000000000L
 #define MAX_POS         2000000000L
 
 
@@ -87,7 +86,7 @@ namespace DISPLIB {
 }
 
 namespace FIFFLIB {
-    class FiffStream;
+    class FiffRawWriter;
     class FiffInfo;
 }
 
@@ -181,12 +180,6 @@ public:
     */
     void showProjectDialog();
 
-    //=========================================================================================================
-    /**
-    * Determines current file. And starts a new one.
-    */
-    void splitRecordingFile();
-
     //=========================================================================================================
     /**
     * Starts or stops a file recording depending on the current recording state.
@@ -297,7 +290,7 @@ protected:
     QSharedPointer<QTimer>                              m_pBlinkingRecordButtonTimer;   /**< timer to control blinking recording button. */
     QSharedPointer<QTimer>                              m_pRecordTimer;                 /**< timer to control recording time. */
     QSharedPointer<DISPLIB::ProjectSettingsView>        m_pProjectSettingsView;         /**< Window to setup the recording tiem and fiel name. */
-    QSharedPointer<FIFFLIB::FiffStream>                 m_pOutfid;                      /**< FiffStream to write to.*/
+    QSharedPointer<FIFFLIB::FiffRawWriter>              m_pRawWriter;                   /**< Writes the recording file in a background thread.*/
     QSharedPointer<FIFFLIB::FiffInfo>                   m_pFiffInfo;                    /**< Fiff measurement info.*/
     QSharedPointer<DISP3DLIB::HpiView>                  m_pHPIWidget;                   /**< HPI widget. */
 
@@ -318,18 +311,16 @@ protected:
     bool                                    m_bUseRecordTimer;              /**< Flag whether to use data recording timer.*/
 
     qint16                                  m_iBlinkStatus;                 /**< The blink status of the recording button.*/
-    qint32                                  m_iSplitCount;                  /**< File split count */
     qint32                                  m_iBufferSize;                  /**< The raw data buffer size.*/
     qint32                                  m_iActiveConnectorId;           /**< The active connector.*/
     int                                     m_iRecordingMSeconds;           /**< Recording length in mseconds.*/
+    qint64                                  m_iBlocksDropped;               /**< Number of blocks the raw writer dropped during the current recording.*/
 
     QMap<qint32, QString>                   m_qMapConnectors;               /**< Connector map.*/
 
     QTimer                                  m_cmdConnectionTimer;           /**< Timer for convinient command client connection. When timer times out a connection is tried to be established. */
     QTime                                   m_recordingStartedTime;         /**< The time when the recording started.*/
 
-    QFile                                   m_qFileOut;                     /**< QFile for writing to fif file.*/
-
     Eigen::RowVectorXd                      m_cals;                         /**< Calibration vector.*/
     Eigen::SparseMatrix<double>             m_sparseMatCals;                /**< Sparse calibration matrix.*/
 
@@ -335,9 +335,10 @@ void NeuronalConnectivity::updateRTMSA(SCMEASLIB::Measurement::SPtr pMeasurement
 
             MatrixXd data;
 
-            for(qint32 i = 0; i < pRTMSA->getMultiSampleArray().size(); ++i) {
-                const MatrixXd& t_mat = pRTMSA->getMultiSampleArray()[i];
-                m_iBlockSize = pRTMSA->getMultiSampleArray()[i].cols();
+            QList<SampleBlock> lBlocks = pRTMSA->getSampleBlocks();
+            for(qint32 i = 0; i < lBlocks.size(); ++i) {
+                const MatrixXd& t_mat = *lBlocks.at(i);
+                m_iBlockSize = lBlocks.at(i)->cols();
 
                 // Check row and colum integrity and restart if necessary
                 if(m_connectivitySettings.size() != 0) {
@@ -254,7 +254,7 @@ void NoiseEstimate::update(SCMEASLIB::Measurement::SPtr pMeasurement)
         m_qMutex.lock();
         if(!m_pBuffer)
         {
-            m_pBuffer = CircularMatrixBuffer<double>::SPtr(new CircularMatrixBuffer<double>(8, pRTMSA->getNumChannels(), pRTMSA->getMultiSampleArray()[0].cols()));
+            m_pBuffer = CircularMatrixBuffer<double>::SPtr(new CircularMatrixBuffer<double>(8, pRTMSA->getNumChannels(), pRTMSA->getSampleBlocks().at(0)->cols()));
         }
 
         //Fiff information
@@ -269,9 +269,10 @@ void NoiseEstimate::update(SCMEASLIB::Measurement::SPtr pMeasurement)
         {
             MatrixXd t_mat;
 
+            QList<SampleBlock> lBlocks = pRTMSA->getSampleBlocks();
             for(qint32 i = 0; i < pRTMSA->getMultiArraySize(); ++i)
             {
-                t_mat = pRTMSA->getMultiSampleArray()[i];
+                t_mat = *lBlocks.at(i);
                 m_pBuffer->push(&t_mat);
             }
         }
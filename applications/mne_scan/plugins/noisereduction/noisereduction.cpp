@@ -50,6 +50,7 @@
 #include <utils/ioutils.h>
 #include <rtprocessing/rtfilter.h>
 #include <scMeas/realtimemultisamplearray.h>
+#include <scMeas/blocktrace.h>
 
 #include "FormFiles/noisereductionsetupwidget.h"
 
@@ -88,12 +89,15 @@ NoiseReduction::NoiseReduction()
 : m_bIsRunning(false)
 , m_pNoiseReductionInput(NULL)
 , m_pNoiseReductionOutput(NULL)
-, m_pNoiseReductionBuffer(CircularMatrixBuffer<double>::SPtr())
+, m_pNoiseReductionBuffer(CircularBuffer<SampleBlock>::SPtr())
 , m_iMaxFilterTapSize(0)
 , m_bSpharaActive(false)
 , m_bFilterActivated(false)
 , m_bProjActivated(false)
 , m_bCompActivated(false)
+, m_bOperatorDirty(true)
+, m_bFusedIsSelection(false)
+, m_bFusedIsSparse(false)
 , m_sCurrentSystem("VectorView")
 , m_pRTMSA(RealTimeMultiSampleArray::SPtr(new RealTimeMultiSampleArray()))
 , m_pRtFilter(RTPROCESSINGLIB::RtFilter::SPtr::create())
@@ -191,8 +195,10 @@ void NoiseReduction::init()
             this, &NoiseReduction::setSpharaOptions);
 
     if(!m_pNoiseReductionBuffer.isNull()) {
-        m_pNoiseReductionBuffer = CircularMatrixBuffer<double>::SPtr();
+        m_pNoiseReductionBuffer = CircularBuffer<SampleBlock>::SPtr();
     }
+
+    m_pTraceStage = QSharedPointer<BlockTraceStage>::create(this->getName());
 }
 
 
@@ -231,6 +237,7 @@ bool NoiseReduction::stop()
     m_pNoiseReductionBuffer->clear();
 
     m_pNoiseReductionBuffer->clear();
+    m_pTraceStage->clear();
 
     return true;
 }
@@ -270,7 +277,7 @@ void NoiseReduction::update(SCMEASLIB::Measurement::SPtr pMeasurement)
     if(m_pRTMSA) {
         //Check if buffer initialized
         if(!m_pNoiseReductionBuffer) {
-            m_pNoiseReductionBuffer = CircularMatrixBuffer<double>::SPtr(new CircularMatrixBuffer<double>(64, m_pRTMSA->getNumChannels(), m_pRTMSA->getMultiSampleArray()[0].cols()));
+            m_pNoiseReductionBuffer = CircularBuffer<SampleBlock>::SPtr(new CircularBuffer<SampleBlock>(64));
         }
 
         //Fiff information
@@ -281,14 +288,10 @@ void NoiseReduction::update(SCMEASLIB::Measurement::SPtr pMeasurement)
             m_matSparseProjMult = SparseMatrix<double>(m_pFiffInfo->chs.size(),m_pFiffInfo->chs.size());
             m_matSparseCompMult = SparseMatrix<double>(m_pFiffInfo->chs.size(),m_pFiffInfo->chs.size());
             m_matSparseSpharaMult = SparseMatrix<double>(m_pFiffInfo->chs.size(),m_pFiffInfo->chs.size());
-            m_matSparseProjCompMult = SparseMatrix<double>(m_pFiffInfo->chs.size(),m_pFiffInfo->chs.size());
-            m_matSparseFull = SparseMatrix<double>(m_pFiffInfo->chs.size(),m_pFiffInfo->chs.size());
 
             m_matSparseProjMult.setIdentity();
             m_matSparseCompMult.setIdentity();
             m_matSparseSpharaMult.setIdentity();
-            m_matSparseProjCompMult.setIdentity();
-            m_matSparseFull.setIdentity();
 
             //Init output - Unocmment this if you also uncommented the m_pNoiseReductionOutput in the constructor above
             m_pNoiseReductionOutput->data()->initFromFiffInfo(m_pFiffInfo);
@@ -296,7 +299,7 @@ void NoiseReduction::update(SCMEASLIB::Measurement::SPtr pMeasurement)
             m_pNoiseReductionOutput->data()->setVisibility(true);            
 
             //Init the filter
-            m_iMaxFilterTapSize = m_pRTMSA->getMultiSampleArray().first().cols();
+            m_iMaxFilterTapSize = m_pRTMSA->getSampleBlocks().first()->cols();
 
             m_pFilterSettingsView->getFilterView()->init(m_pFiffInfo->sfreq);
             m_pFilterSettingsView->getFilterView()->setWindowSize(m_iMaxFilterTapSize);
@@ -308,11 +311,12 @@ void NoiseReduction::update(SCMEASLIB::Measurement::SPtr pMeasurement)
             m_pCompensatorView->setCompensators(m_pFiffInfo->comps);
         }
 
-        MatrixXd t_mat;
-
-        for(unsigned char i = 0; i < m_pRTMSA->getMultiArraySize(); ++i) {
-            t_mat = m_pRTMSA->getMultiSampleArray()[i];
-            m_pNoiseReductionBuffer->push(&t_mat);
+        //The shared blocks are queued without copying them
+        QList<SampleBlock> lBlocks = m_pRTMSA->getSampleBlocks();
+        BlockHeader header = m_pRTMSA->getBlockHeader();
+        for(int i = 0; i < lBlocks.size(); ++i) {
+            m_pTraceStage->enqueue(header, lBlocks.at(i).data());
+            m_pNoiseReductionBuffer->push(lBlocks.at(i));
         }
     }
 }
@@ -324,6 +328,7 @@ void NoiseReduction::setSpharaActive(bool state)
 {
     m_mutex.lock();
     m_bSpharaActive = state;
+    m_bOperatorDirty = true;
     m_mutex.unlock();
 }
 
@@ -365,7 +370,7 @@ void NoiseReduction::updateProjection(const QList<FIFFLIB::FiffProj>& projs)
 
         //set columns of matrix to zero depending on bad channels indexes
         for(qint32 j = 0; j < m_pFiffInfo->bads.size(); ++j) {
-            int index = m_pFiffInfo->ch_names.indexOf(m_pFiffInfo->bads.at(j));
+            int index = m_pFiffInfo->channelIndex(m_pFiffInfo->bads.at(j));
             if(index >= 0 && index<m_pFiffInfo->ch_names.size()) {
                 matProj.col(index).setZero();
             }
@@ -393,10 +398,7 @@ void NoiseReduction::updateProjection(const QList<FIFFLIB::FiffProj>& projs)
         if(tripletList.size() > 0)
             m_matSparseProjMult.setFromTriplets(tripletList.begin(), tripletList.end());
 
-        //Create full multiplication matrix
-        m_matSparseProjCompMult = m_matSparseProjMult * m_matSparseCompMult;
-
-        m_matSparseFull = m_matSparseProjMult * m_matSparseCompMult;
+        m_bOperatorDirty = true;
         m_mutex.unlock();
     }
 }
@@ -409,6 +411,8 @@ void NoiseReduction::updateCompensator(int to)
     // Update the compensator
     if(m_pFiffInfo)
     {
+        QMutexLocker locker(&m_mutex);
+
         if(to == 0) {
             m_bCompActivated = false;
         } else {
@@ -450,10 +454,7 @@ void NoiseReduction::updateCompensator(int to)
             m_matSparseCompMult.setFromTriplets(tripletList.begin(), tripletList.end());
         }
 
-        //Create full multiplication matrix
-        m_matSparseProjCompMult = m_matSparseProjMult * m_matSparseCompMult;
-
-        m_matSparseFull = m_matSparseProjMult * m_matSparseCompMult;
+        m_bOperatorDirty = true;
     }
 }
 
@@ -462,7 +463,10 @@ void NoiseReduction::updateCompensator(int to)
 
 void NoiseReduction::setFilterChannelType(QString sType)
 {
+    QMutexLocker locker(&m_mutex);
+
     m_sFilterChannelType = sType;
+    m_bOperatorDirty = true;
 
     //This version is for when all channels of a type are to be filtered (not only the visible ones).
     //Create channel filter list independent from channelNames
@@ -500,7 +504,10 @@ void NoiseReduction::setFilter(const FilterData& filterData)
 
 void NoiseReduction::setFilterActive(bool state)
 {
+    QMutexLocker locker(&m_mutex);
+
     m_bFilterActivated = state;
+    m_bOperatorDirty = true;
 }
 
 
@@ -638,12 +645,189 @@ void NoiseReduction::createSpharaOperator()
     //Create full multiplication matrix
     m_matSparseSpharaMult = matSparseSpharaMultFirst * matSparseSpharaMultSecond;
 
-    m_matSparseFull = m_matSparseProjMult * m_matSparseCompMult;
+    m_bOperatorDirty = true;
 
     m_mutex.unlock();
 }
 
 
+//*************************************************************************************************************
+
+void NoiseReduction::compileOperator()
+{
+    int nchan = m_pFiffInfo->chs.size();
+
+    //
+    // Spatial stages in front of the filter: compensator, then SSP
+    //
+    MatrixXd matPre = MatrixXd::Identity(nchan, nchan);
+
+    if(m_bCompActivated && m_matSparseCompMult.rows() == nchan) {
+        matPre = m_matSparseCompMult * matPre;
+    }
+
+    if(m_bProjActivated && m_matSparseProjMult.rows() == nchan) {
+        matPre = m_matSparseProjMult * matPre;
+    }
+
+    //
+    // Spatial stages behind the filter: bad channel zeroing, then SPHARA. Zeroing the bad rows before the
+    // SPHARA product equals zeroing the matching columns of the SPHARA operator.
+    //
+    bool bPostActive = m_bSpharaActive && m_matSparseSpharaMult.rows() == nchan;
+    MatrixXd matPost;
+
+    if(bPostActive) {
+        matPost = MatrixXd(m_matSparseSpharaMult);
+
+        for(int i = 0; i < m_pFiffInfo->bads.size(); ++i) {
+            int index = m_pFiffInfo->channelIndex(m_pFiffInfo->bads.at(i));
+            if(index >= 0 && index < nchan) {
+                matPost.col(index).setZero();
+            }
+        }
+    }
+
+    //
+    // Move the filter in front of the spatial stages. Filtered output rows L and delayed rows R give
+    // post * F_L(pre * x) = post(:,L) * pre(L,K) * F(x_K) + post(:,R) * pre(R,J) * D(x_J),
+    // with K and J the input channels feeding the filtered and the delayed rows respectively.
+    //
+    VectorXi vecFiltered = VectorXi::Zero(nchan);
+
+    if(m_bFilterActivated) {
+        for(int i = 0; i < m_lFilterChannelList.size(); ++i) {
+            if(m_lFilterChannelList.at(i) >= 0 && m_lFilterChannelList.at(i) < nchan) {
+                vecFiltered(m_lFilterChannelList.at(i)) = 1;
+            }
+        }
+    }
+
+    QVector<int> lRowsL, lRowsR, lColsK, lColsJ;
+
+    for(int r = 0; r < nchan; ++r) {
+        if(vecFiltered(r)) {
+            lRowsL << r;
+        } else {
+            lRowsR << r;
+        }
+    }
+
+    for(int c = 0; c < nchan; ++c) {
+        bool bFeedsL = false;
+        bool bFeedsR = false;
+
+        for(int r = 0; r < nchan && !(bFeedsL && bFeedsR); ++r) {
+            if(matPre(r,c) != 0.0) {
+                if(vecFiltered(r)) {
+                    bFeedsL = true;
+                } else {
+                    bFeedsR = true;
+                }
+            }
+        }
+
+        if(bFeedsL) {
+            lColsK << c;
+        }
+        if(bFeedsR) {
+            lColsJ << c;
+        }
+    }
+
+    // Gather the filtered input channels first
+    VectorXi vecPrevGatherRows = m_vecGatherRows;
+    m_vecGatherRows.resize(lColsK.size() + lColsJ.size());
+    m_lFusedFilterChannelList.clear();
+
+    for(int i = 0; i < lColsK.size(); ++i) {
+        m_vecGatherRows(i) = lColsK.at(i);
+        m_lFusedFilterChannelList << i;
+    }
+    for(int i = 0; i < lColsJ.size(); ++i) {
+        m_vecGatherRows(lColsK.size() + i) = lColsJ.at(i);
+    }
+
+    // The filter keeps its overlap and delay per gathered row, which now may belong to another channel
+    if(vecPrevGatherRows.size() != m_vecGatherRows.size() || vecPrevGatherRows != m_vecGatherRows) {
+        m_pRtFilter = RTPROCESSINGLIB::RtFilter::SPtr::create();
+    }
+
+    // Fused operator: [post(:,L) * pre(L,K), post(:,R) * pre(R,J)]
+    MatrixXd matPreLK(lRowsL.size(), lColsK.size());
+    for(int r = 0; r < lRowsL.size(); ++r) {
+        for(int c = 0; c < lColsK.size(); ++c) {
+            matPreLK(r,c) = matPre(lRowsL.at(r), lColsK.at(c));
+        }
+    }
+
+    MatrixXd matPreRJ(lRowsR.size(), lColsJ.size());
+    for(int r = 0; r < lRowsR.size(); ++r) {
+        for(int c = 0; c < lColsJ.size(); ++c) {
+            matPreRJ(r,c) = matPre(lRowsR.at(r), lColsJ.at(c));
+        }
+    }
+
+    m_matFused.resize(nchan, m_vecGatherRows.size());
+
+    if(bPostActive) {
+        MatrixXd matPostL(nchan, lRowsL.size());
+        for(int c = 0; c < lRowsL.size(); ++c) {
+            matPostL.col(c) = matPost.col(lRowsL.at(c));
+        }
+
+        MatrixXd matPostR(nchan, lRowsR.size());
+        for(int c = 0; c < lRowsR.size(); ++c) {
+            matPostR.col(c) = matPost.col(lRowsR.at(c));
+        }
+
+        m_matFused.leftCols(lColsK.size()).noalias() = matPostL * matPreLK;
+        m_matFused.rightCols(lColsJ.size()).noalias() = matPostR * matPreRJ;
+    } else {
+        m_matFused.setZero();
+
+        for(int r = 0; r < lRowsL.size(); ++r) {
+            m_matFused.block(lRowsL.at(r), 0, 1, lColsK.size()) = matPreLK.row(r);
+        }
+        for(int r = 0; r < lRowsR.size(); ++r) {
+            m_matFused.block(lRowsR.at(r), lColsK.size(), 1, lColsJ.size()) = matPreRJ.row(r);
+        }
+    }
+
+    // Skip the product altogether if nothing mixes the channels, e.g. filtering without any spatial stage
+    m_bFusedIsSelection = true;
+    m_vecSelectRows.resize(nchan);
+
+    for(int r = 0; r < nchan && m_bFusedIsSelection; ++r) {
+        int iNumOnes = 0;
+
+        for(int c = 0; c < m_matFused.cols(); ++c) {
+            if(m_matFused(r,c) == 1.0) {
+                m_vecSelectRows(r) = c;
+                ++iNumOnes;
+            } else if(m_matFused(r,c) != 0.0) {
+                iNumOnes = 2;
+                break;
+            }
+        }
+
+        m_bFusedIsSelection = (iNumOnes == 1);
+    }
+
+    // Projectors are dense, compensators and SPHARA usually are not
+    qint64 iNonZeros = (m_matFused.array() != 0.0).count();
+    m_bFusedIsSparse = iNonZeros < qint64(m_matFused.size()) / 4;
+
+    if(m_bFusedIsSparse) {
+        m_matSparseFused = m_matFused.sparseView();
+    } else {
+        m_matSparseFused = SparseMatrix<double>();
+    }
+
+    m_bOperatorDirty = false;
+}
+
+
 //*************************************************************************************************************
 
 void NoiseReduction::run()
@@ -662,50 +846,53 @@ void NoiseReduction::run()
     while(m_bIsRunning)
     {
         //Dispatch the inputs
-        MatrixXd t_mat = m_pNoiseReductionBuffer->pop();
+        SampleBlock block = m_pNoiseReductionBuffer->pop();
+
+        if(!block) {
+            continue;
+        }
+
+        BlockHeader header = m_pTraceStage->take(block.data());
+        m_pTraceStage->dequeue(header);
+        const MatrixXd& t_mat = *block;
 
         m_mutex.lock();
 
-        //Do SSP's and compensators here
-        if(m_bCompActivated) {
-            if(m_bProjActivated) {
-                //Comp + Proj
-                t_mat = m_matSparseProjCompMult * t_mat;
-            } else {
-                //Comp
-                t_mat = m_matSparseCompMult * t_mat;
-            }
-        } else {
-            if(m_bProjActivated) {
-                //Proj
-                t_mat = m_matSparseProjMult * t_mat;
-            } else {
-                //None - Raw
-            }
+        if(m_bOperatorDirty) {
+            compileOperator();
         }
 
-        //Do temporal filtering here
+        //Gather the input rows, the channels which need filtering come first
+        m_matGathered.resize(m_vecGatherRows.size(), t_mat.cols());
+
+        for(int i = 0; i < m_vecGatherRows.size(); ++i) {
+            m_matGathered.row(i) = t_mat.row(m_vecGatherRows(i));
+        }
+
+        //Do temporal filtering here, before the spatial stages. Also run it if no gathered row needs filtering, the
+        //filter then delays all rows by half the filter length, which keeps the output timing of all filter settings.
         if(m_bFilterActivated) {
             QList<FilterData> list;
             list << m_filterData;
-            t_mat = m_pRtFilter->filterChannelsConcurrently(t_mat,
-                                                            m_iMaxFilterLength,
-                                                            m_lFilterChannelList,
-                                                            list);
+            m_matGathered = m_pRtFilter->filterChannelsConcurrently(m_matGathered,
+                                                                   m_iMaxFilterLength,
+                                                                   m_lFusedFilterChannelList,
+                                                                   list);
         }
 
-//        qDebug()<<"t_mat dim:"<<t_mat.rows()<<"x"<<t_mat.cols();
-//        qDebug()<<"m_lFilterChannelList.size():"<<m_lFilterChannelList.size();
-//        qDebug()<<"m_filterData.size():"<<m_filterData.size();
+        //Compensators, SSPs, bad channel zeroing and SPHARA in one product
+        if(m_bFusedIsSelection) {
+            m_matOutput.resize(m_vecSelectRows.size(), m_matGathered.cols());
 
-        //Do SPHARA here
-        if(m_bSpharaActive) {
-            //Set bad channels to zero so they do not get smeared into
-            for(int i = 0; i < m_pFiffInfo->bads.size(); ++i) {
-                t_mat.row(m_pFiffInfo->ch_names.indexOf(m_pFiffInfo->bads.at(i))).setZero();
+            for(int i = 0; i < m_vecSelectRows.size(); ++i) {
+                m_matOutput.row(i) = m_matGathered.row(m_vecSelectRows(i));
             }
-
-            t_mat = m_matSparseSpharaMult * t_mat;
+        } else if(m_bFusedIsSparse) {
+            m_matOutput.resize(m_matSparseFused.rows(), m_matGathered.cols());
+            m_matOutput.noalias() = m_matSparseFused * m_matGathered;
+        } else {
+            m_matOutput.resize(m_matFused.rows(), m_matGathered.cols());
+            m_matOutput.noalias() = m_matFused * m_matGathered;
         }
 
 //        //Common average
@@ -732,7 +919,9 @@ void NoiseReduction::run()
 
         m_mutex.unlock();
 
-        //Send the data to the connected plugins and the online display
-        m_pNoiseReductionOutput->data()->setValue(t_mat);
+        //Send the data to the connected plugins and the online display, the block keeps its header
+        m_pTraceStage->processed(header);
+        m_pNoiseReductionOutput->data()->setBlockHeader(header);
+        m_pNoiseReductionOutput->data()->setValue(m_matOutput);
     }
 }
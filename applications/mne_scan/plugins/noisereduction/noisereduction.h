@@ -44,7 +44,7 @@
 
 #include "noisereduction_global.h"
 
-#include <utils/generics/circularmatrixbuffer.h>
+#include <utils/generics/circularbuffer.h>
 #include <utils/filterTools/filterdata.h>
 #include <fiff/fiff_proj.h>
 
@@ -91,6 +91,7 @@ namespace RTPROCESSINGLIB{
 
 namespace SCMEASLIB{
     class RealTimeMultiSampleArray;
+    class BlockTraceStage;
 }
 
 
@@ -235,6 +236,16 @@ protected:
     */
     void createSpharaOperator();
 
+    //=========================================================================================================
+    /**
+    * Compiles the active processing stages into one fused operator. All spatial stages (compensator, SSP,
+    * bad channel zeroing, SPHARA) are linear and the temporal filter acts on every channel independently,
+    * so the filter is moved in front of the spatial stages. It then only runs on the input channels which
+    * contribute to filtered output channels, and each block costs one filter pass plus one product with
+    * the fused spatial operator. Must be called with m_mutex locked.
+    */
+    void compileOperator();
+
     //=========================================================================================================
     /**
     * IAlgorithm function
@@ -249,6 +260,9 @@ private:
     bool                            m_bSpharaActive;                            /**< Flag whether thread is running.*/
     bool                            m_bProjActivated;                           /**< Projections activated */
     bool                            m_bFilterActivated;                         /**< Projections activated */
+    bool                            m_bOperatorDirty;                           /**< Whether the fused operator needs to be recompiled */
+    bool                            m_bFusedIsSelection;                        /**< Whether the fused spatial operator only selects rows */
+    bool                            m_bFusedIsSparse;                           /**< Whether the fused spatial operator is stored in sparse format */
 
     int                             m_iNBaseFctsFirst;                          /**< The number of grad/inner base functions to use for calculating the sphara opreator.*/
     int                             m_iNBaseFctsSecond;                         /**< The number of grad/outer base functions to use for calculating the sphara opreator.*/
@@ -267,10 +281,14 @@ private:
     Eigen::VectorXi                 m_vecIndicesFirstEEG;                       /**< The indices of the channels to pick for the second SPHARA operator in case of an EEG system.*/
 
     Eigen::SparseMatrix<double>     m_matSparseSpharaMult;                      /**< The final sparse SPHARA operator .*/
-    Eigen::SparseMatrix<double>     m_matSparseProjCompMult;                    /**< The final sparse projection + compensator operator.*/
     Eigen::SparseMatrix<double>     m_matSparseProjMult;                        /**< The final sparse SSP projector */
     Eigen::SparseMatrix<double>     m_matSparseCompMult;                        /**< The final sparse compensator matrix */
-    Eigen::SparseMatrix<double>     m_matSparseFull;                            /**< The final sparse full multiplication matrix  */
+    Eigen::SparseMatrix<double>     m_matSparseFused;                           /**< The fused spatial operator in sparse format */
+    Eigen::MatrixXd                 m_matFused;                                 /**< The fused spatial operator in dense format */
+    Eigen::MatrixXd                 m_matGathered;                              /**< Preallocated buffer holding the gathered (filtered first) input rows */
+    Eigen::MatrixXd                 m_matOutput;                                /**< Preallocated output buffer */
+    Eigen::VectorXi                 m_vecGatherRows;                            /**< The input rows gathered into m_matGathered, filtered rows first */
+    Eigen::VectorXi                 m_vecSelectRows;                            /**< The rows of m_matGathered forming the output if the fused operator only selects rows */
 
     Eigen::MatrixXd                 m_matSpharaVVGradLoaded;                    /**< The loaded VectorView gradiometer basis functions.*/
     Eigen::MatrixXd                 m_matSpharaVVMagLoaded;                     /**< The loaded VectorView magnetometer basis functions.*/
@@ -279,10 +297,12 @@ private:
     Eigen::MatrixXd                 m_matSpharaEEGLoaded;                       /**< The loaded EEG basis functions.*/
 
     QVector<int>                    m_lFilterChannelList;                       /**< The indices of the channels to be filtered.*/
+    QVector<int>                    m_lFusedFilterChannelList;                  /**< The indices of the filtered rows in m_matGathered.*/
 
     QSharedPointer<FIFFLIB::FiffInfo>                               m_pFiffInfo;                /**< Fiff measurement info.*/
 
-    IOBUFFER::CircularMatrixBuffer<double>::SPtr                    m_pNoiseReductionBuffer;    /**< Holds incoming data.*/
+    QSharedPointer<IOBUFFER::CircularBuffer<QSharedPointer<const Eigen::MatrixXd> > >   m_pNoiseReductionBuffer;    /**< Holds the shared blocks of incoming data.*/
+    QSharedPointer<SCMEASLIB::BlockTraceStage>                      m_pTraceStage;              /**< Traces the queued blocks, the plugin does not use the PluginScheduler. */
 
     QSharedPointer<RTPROCESSINGLIB::RtFilter>                       m_pRtFilter;                /**< Real time filter object. */
 
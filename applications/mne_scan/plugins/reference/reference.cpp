@@ -187,7 +187,7 @@ void Reference::update(SCMEASLIB::Measurement::SPtr pMeasurement)
     if(pRTMSA) {
         //Check if buffer initialized
         if(!m_pRefBuffer) {
-            m_pRefBuffer = CircularMatrixBuffer<double>::SPtr(new _double_CircularMatrixBuffer(64, pRTMSA->getNumChannels(), pRTMSA->getMultiSampleArray()[0].cols()));
+            m_pRefBuffer = CircularMatrixBuffer<double>::SPtr(new _double_CircularMatrixBuffer(64, pRTMSA->getNumChannels(), pRTMSA->getSampleBlocks().at(0)->cols()));
         }
 
         //Fiff information
@@ -204,8 +204,9 @@ void Reference::update(SCMEASLIB::Measurement::SPtr pMeasurement)
 
         MatrixXd t_mat;
 
+        QList<SampleBlock> lBlocks = pRTMSA->getSampleBlocks();
         for(unsigned char i = 0; i < pRTMSA->getMultiArraySize(); ++i) {
-            t_mat = pRTMSA->getMultiSampleArray()[i];
+            t_mat = *lBlocks.at(i);
             m_pRefBuffer->push(&t_mat);
         }
     }
@@ -225,7 +225,7 @@ void RtHpi::update(SCMEASLIB::Measurement::SPtr pMeasurement)
         m_qMutex.lock();
         //Check if buffer initialized
         if(!m_pRtHpiBuffer)
-            m_pRtHpiBuffer = CircularMatrixBuffer<double>::SPtr(new CircularMatrixBuffer<double>(8, pRTMSA->getNumChannels(), pRTMSA->getMultiSampleArray()[0].cols()));
+            m_pRtHpiBuffer = CircularMatrixBuffer<double>::SPtr(new CircularMatrixBuffer<double>(8, pRTMSA->getNumChannels(), pRTMSA->getSampleBlocks().at(0)->cols()));
 
         //Fiff information
         if(!m_pFiffInfo)
@@ -239,9 +239,10 @@ void RtHpi::update(SCMEASLIB::Measurement::SPtr pMeasurement)
         {
             MatrixXd t_mat;
 
+            QList<SampleBlock> lBlocks = pRTMSA->getSampleBlocks();
             for(qint32 i = 0; i < pRTMSA->getMultiArraySize(); ++i)
             {
-                t_mat = pRTMSA->getMultiSampleArray()[i];
+                t_mat = *lBlocks.at(i);
                 m_pRtHpiBuffer->push(&t_mat);
             }
         }
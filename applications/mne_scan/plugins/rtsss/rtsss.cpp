@@ -274,7 +274,7 @@ void RtSss::update(SCMEASLIB::Measurement::SPtr pMeasurement)
     {
         //Check if buffer initialized
         if(!m_pRtSssBuffer)
-            m_pRtSssBuffer = CircularMatrixBuffer<double>::SPtr(new CircularMatrixBuffer<double>(32, pRTMSA->getNumChannels(), pRTMSA->getMultiSampleArray()[0].cols()));
+            m_pRtSssBuffer = CircularMatrixBuffer<double>::SPtr(new CircularMatrixBuffer<double>(32, pRTMSA->getNumChannels(), pRTMSA->getSampleBlocks().at(0)->cols()));
 
         //Fiff information
         if(!m_pFiffInfo)
@@ -283,9 +283,10 @@ void RtSss::update(SCMEASLIB::Measurement::SPtr pMeasurement)
         if(m_bProcessData)
         {
             MatrixXd in_mat;
+            QList<SampleBlock> lBlocks = pRTMSA->getSampleBlocks();
             for(unsigned char i = 0; i < pRTMSA->getMultiArraySize(); ++i)
             {
-                in_mat = pRTMSA->getMultiSampleArray()[i];
+                in_mat = *lBlocks.at(i);
                 m_pRtSssBuffer->push(&in_mat);
             }
         }
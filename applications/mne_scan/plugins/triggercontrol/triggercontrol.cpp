@@ -339,7 +339,7 @@ void TriggerControl::update(SCMEASLIB::Measurement::SPtr pMeasurement)
     {
         //Check if buffer initialized
         if(!m_pDataMatrixBuffer)
-            m_pDataMatrixBuffer = CircularMatrixBuffer<double>::SPtr(new CircularMatrixBuffer<double>(64, pRTMSA->getNumChannels(), pRTMSA->getMultiSampleArray()[0].cols()));
+            m_pDataMatrixBuffer = CircularMatrixBuffer<double>::SPtr(new CircularMatrixBuffer<double>(64, pRTMSA->getNumChannels(), pRTMSA->getSampleBlocks().at(0)->cols()));
 
 //        MatrixXd t_mat;
 
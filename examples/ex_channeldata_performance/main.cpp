@@ -0,0 +1,239 @@
+//=============================================================================================================
+/**
+* @file     main.cpp
+* @author   agent <agent@local>
+* @version  1.0
+* @date     October, 2026
+*
+* @section  LICENSE
+*
+* Copyright (C) 2026, agent. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+*
+* @brief    Benchmarks the offscreen rendering of the real-time channel data view
+*
+*/
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include <math.h>
+
+#include <fiff/fiff_info.h>
+#include <fiff/fiff_constants.h>
+
+#include <disp/viewers/helpers/channeldatamodel.h>
+#include <disp/viewers/helpers/channeldatadelegate.h>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QApplication>
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QImage>
+#include <QPainter>
+#include <QPainterPath>
+#include <QStyleOptionViewItem>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// Eigen INCLUDES
+//=============================================================================================================
+
+#include <Eigen/Core>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// USED NAMESPACES
+//=============================================================================================================
+
+using namespace FIFFLIB;
+using namespace DISPLIB;
+using namespace Eigen;
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// MAIN
+//=============================================================================================================
+
+//=============================================================================================================
+/**
+* Renders a filled real-time channel data model offscreen into a QImage, once with the channel data delegate and
+* once with a reference path holding one point per sample, and reports the time per frame of both.
+*
+* @param [in] argc (argument count) is an integer that indicates how many arguments were entered on the command line when the program was started.
+* @param [in] argv (argument vector) is an array of pointers to arrays of character objects. The array objects are null-terminated strings, representing the arguments that were entered on the command line when the program was started.
+* @return the value that was set to exit() (which is 0 if exit() is called via quit()).
+*/
+int main(int argc, char *argv[])
+{
+    //Render without a display server unless a platform was chosen explicitly
+    if(qgetenv("QT_QPA_PLATFORM").isEmpty()) {
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    }
+
+    QApplication app(argc, argv);
+
+    // Command Line Parser
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Channel Data View Performance Example");
+    parser.addHelpOption();
+
+    QCommandLineOption channelsOption("channels", "The <number> of channels.", "number", "306");
+    QCommandLineOption sfreqOption("sfreq", "The sampling <frequency> in Hz.", "frequency", "5000");
+    QCommandLineOption secondsOption("seconds", "The displayed time window in <seconds>.", "seconds", "10");
+    QCommandLineOption widthOption("width", "The <width> of the rendered image in pixels.", "width", "1600");
+    QCommandLineOption rowHeightOption("rowHeight", "The <height> of a channel row in pixels.", "height", "30");
+    QCommandLineOption repetitionsOption("repetitions", "The <number> of rendered frames.", "number", "10");
+
+    parser.addOption(channelsOption);
+    parser.addOption(sfreqOption);
+    parser.addOption(secondsOption);
+    parser.addOption(widthOption);
+    parser.addOption(rowHeightOption);
+    parser.addOption(repetitionsOption);
+
+    parser.process(app);
+
+    int iNumChannels = qMax(1, parser.value(channelsOption).toInt());
+    float fSFreq = qMax(1.0f, parser.value(sfreqOption).toFloat());
+    int iSeconds = qMax(1, parser.value(secondsOption).toInt());
+    int iWidth = qMax(1, parser.value(widthOption).toInt());
+    int iRowHeight = qMax(1, parser.value(rowHeightOption).toInt());
+    int iRepetitions = qMax(1, parser.value(repetitionsOption).toInt());
+
+    //Synthetic measurement info with one magnetometer per gradiometer pair
+    QSharedPointer<FiffInfo> pFiffInfo = QSharedPointer<FiffInfo>(new FiffInfo());
+    pFiffInfo->sfreq = fSFreq;
+
+    for(int i = 0; i < iNumChannels; ++i) {
+        FiffChInfo chInfo;
+        chInfo.kind = FIFFV_MEG_CH;
+        chInfo.unit = (i % 3 == 2) ? FIFF_UNIT_T : FIFF_UNIT_T_M;
+        chInfo.ch_name = QString("MEG %1").arg(i, 4, 10, QChar('0'));
+
+        pFiffInfo->chs.append(chInfo);
+        pFiffInfo->ch_names.append(chInfo.ch_name);
+    }
+
+    pFiffInfo->nchan = iNumChannels;
+
+    QMap<qint32,float> qMapChScaling;
+    qMapChScaling.insert(FIFF_UNIT_T_M, 4e-11f);
+    qMapChScaling.insert(FIFF_UNIT_T, 1.2e-12f);
+
+    ChannelDataModel model;
+    model.setFiffInfo(pFiffInfo);
+    model.setSamplingInfo(fSFreq, iSeconds, true);
+    model.setScaling(qMapChScaling);
+
+    //Fill the whole time window with noisy sinusoids, block by block as in the real-time pipeline
+    int iBlockSize = qMax(1, (int)(fSFreq / 10.0f));
+    int iNumBlocks = (model.getMaxSamples() + iBlockSize - 1) / iBlockSize;
+
+    for(int b = 0; b < iNumBlocks; ++b) {
+        MatrixXd matBlock = MatrixXd::Random(iNumChannels, iBlockSize);
+
+        for(int i = 0; i < iNumChannels; ++i) {
+            double dScale = pFiffInfo->chs[i].unit == FIFF_UNIT_T ? 1e-12 : 3e-11;
+            double dFreq = 1.0 + (i % 40);
+
+            for(int j = 0; j < iBlockSize; ++j) {
+                double t = (b * iBlockSize + j) / fSFreq;
+                matBlock(i,j) = dScale * (0.6 * sin(2.0 * M_PI * dFreq * t) + 0.3 * matBlock(i,j));
+            }
+        }
+
+        model.addData(QList<MatrixXd>() << matBlock);
+    }
+
+    ChannelDataDelegate delegate;
+    delegate.initPainterPaths(&model);
+
+    QImage image(iWidth, iRowHeight * iNumChannels, QImage::Format_ARGB32_Premultiplied);
+    QElapsedTimer timer;
+
+    //Render with the delegate, which draws a min/max envelope when there are more samples than pixels
+    timer.start();
+
+    for(int r = 0; r < iRepetitions; ++r) {
+        image.fill(Qt::white);
+        QPainter painter(&image);
+
+        for(int i = 0; i < iNumChannels; ++i) {
+            QStyleOptionViewItem option;
+            option.rect = QRect(0, i * iRowHeight, iWidth, iRowHeight);
+            delegate.paint(&painter, option, model.index(i, 1));
+        }
+    }
+
+    qint64 iTimeDelegate = timer.elapsed();
+
+    //Render the reference path with one point per sample
+    double dDx = (double)iWidth / (double)model.getMaxSamples();
+
+    timer.restart();
+
+    for(int r = 0; r < iRepetitions; ++r) {
+        image.fill(Qt::white);
+        QPainter painter(&image);
+        painter.setRenderHint(QPainter::Antialiasing, true);
+
+        for(int i = 0; i < iNumChannels; ++i) {
+            QModelIndex index = model.index(i, 1);
+            RowVectorPair data = model.data(index, Qt::DisplayRole).value<RowVectorPair>();
+            float fMaxValue = qMapChScaling.value(pFiffInfo->chs[i].unit);
+            double dScaleY = iRowHeight / (2.0 * fMaxValue);
+            double dYBase = i * iRowHeight + iRowHeight / 2.0;
+
+            if(data.second <= 0) {
+                continue;
+            }
+
+            QPainterPath path(QPointF(0.0, dYBase - data.first[0] * dScaleY));
+
+            for(int j = 1; j < data.second; ++j) {
+                path.lineTo(j * dDx, dYBase - data.first[j] * dScaleY);
+            }
+
+            painter.drawPath(path);
+        }
+    }
+
+    qint64 iTimeReference = timer.elapsed();
+
+    printf("%d channels, %d samples per channel, %d x %d pixels, %d frames\n", iNumChannels, model.getMaxSamples(), iWidth, iRowHeight * iNumChannels, iRepetitions);
+    printf("delegate:  %.1f ms per frame\n", (double)iTimeDelegate / iRepetitions);
+    printf("reference: %.1f ms per frame\n", (double)iTimeReference / iRepetitions);
+    printf("speedup: %.2f\n", (double)iTimeReference / qMax(iTimeDelegate, (qint64)1));
+
+    return 0;
+}
@@ -0,0 +1,189 @@
+//=============================================================================================================
+/**
+* @file     main.cpp
+* @author   agent <agent@local>
+* @version  1.0
+* @date     October, 2026
+*
+* @section  LICENSE
+*
+* Copyright (C) 2026, agent. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+*
+* @brief    Benchmarks the double and single precision minimum norm kernel application.
+*
+*/
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include <iostream>
+#include <math.h>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// MNE INCLUDES
+//=============================================================================================================
+
+#include <fiff/fiff_evoked.h>
+#include <mne/mne_inverse_operator.h>
+#include <mne/mne_sourceestimate.h>
+#include <inverse/minimumNorm/minimumnorm.h>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QtCore/QCoreApplication>
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// USED NAMESPACES
+//=============================================================================================================
+
+using namespace FIFFLIB;
+using namespace MNELIB;
+using namespace INVERSELIB;
+using namespace Eigen;
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// MAIN
+//=============================================================================================================
+
+//=============================================================================================================
+/**
+* Applies the inverse kernel to blocks of data in double and single precision and reports the throughput and the
+* error of the single precision path against the double precision path.
+*
+* @param [in] argc (argument count) is an integer that indicates how many arguments were entered on the command line when the program was started.
+* @param [in] argv (argument vector) is an array of pointers to arrays of character objects. The array objects are null-terminated strings, representing the arguments that were entered on the command line when the program was started.
+* @return the value that was set to exit() (which is 0 if exit() is called via quit()).
+*/
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+
+    // Command Line Parser
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Inverse MNE Performance Example");
+    parser.addHelpOption();
+
+    QCommandLineOption evokedFileOption("ave", "Path to evoked <file>.", "file", QCoreApplication::applicationDirPath() + "/MNE-sample-data/MEG/sample/sample_audvis-ave.fif");
+    QCommandLineOption invFileOption("inv", "Path to inverse operator <file>.", "file", QCoreApplication::applicationDirPath() + "/MNE-sample-data/MEG/sample/sample_audvis-meg-eeg-oct-6-meg-eeg-inv.fif");
+    QCommandLineOption snrOption("snr", "The <snr> value used for computation.", "snr", "1.0");
+    QCommandLineOption methodOption("method", "Inverse estimation <method>, i.e., 'MNE', 'dSPM' or 'sLORETA'.", "method", "dSPM");
+    QCommandLineOption blockSizeOption("blockSize", "The <size> of the data blocks in samples.", "size", "100");
+    QCommandLineOption repetitionsOption("repetitions", "The <number> of applied blocks.", "number", "200");
+
+    parser.addOption(evokedFileOption);
+    parser.addOption(invFileOption);
+    parser.addOption(snrOption);
+    parser.addOption(methodOption);
+    parser.addOption(blockSizeOption);
+    parser.addOption(repetitionsOption);
+    parser.process(app);
+
+    QFile t_fileEvoked(parser.value(evokedFileOption));
+    QFile t_fileInv(parser.value(invFileOption));
+
+    float snr = parser.value(snrOption).toFloat();
+    QString method(parser.value(methodOption));
+    qint32 iBlockSize = parser.value(blockSizeOption).toInt();
+    qint32 iRepetitions = parser.value(repetitionsOption).toInt();
+
+    double lambda2 = 1.0 / pow(snr, 2);
+
+    //
+    //   Read the data
+    //
+    fiff_int_t setno = 0;
+    QPair<QVariant, QVariant> baseline(QVariant(), 0);
+    FiffEvoked evoked(t_fileEvoked, setno, baseline);
+    if(evoked.isEmpty())
+        return 1;
+
+    MNEInverseOperator inverse_operator(t_fileInv);
+
+    //
+    //   Setup both paths
+    //
+    MinimumNorm minimumNormDouble(inverse_operator, lambda2, method);
+    MinimumNorm minimumNormFloat(inverse_operator, lambda2, method);
+    minimumNormFloat.setUseFloatKernel(true);
+
+    minimumNormDouble.calculateInverse(evoked);
+    minimumNormFloat.calculateInverse(evoked);
+
+    FiffEvoked pickedEvoked = evoked.pick_channels(minimumNormDouble.getPreparedInverseOperator().noise_cov->names);
+
+    // Build the data block by repeating the evoked data
+    MatrixXd matBlock(pickedEvoked.data.rows(), iBlockSize);
+    for(qint32 i = 0; i < iBlockSize; ++i) {
+        matBlock.col(i) = pickedEvoked.data.col(i % pickedEvoked.data.cols());
+    }
+
+    float tstep = 1.0f / pickedEvoked.info.sfreq;
+
+    //
+    //   Benchmark
+    //
+    QElapsedTimer timer;
+    MNESourceEstimate stcDouble, stcFloat;
+
+    timer.start();
+    for(qint32 i = 0; i < iRepetitions; ++i) {
+        stcDouble = minimumNormDouble.calculateInverse(matBlock, 0.0f, tstep, false);
+    }
+    qint64 iTimeDouble = timer.elapsed();
+
+    timer.restart();
+    for(qint32 i = 0; i < iRepetitions; ++i) {
+        stcFloat = minimumNormFloat.calculateInverse(matBlock, 0.0f, tstep, false);
+    }
+    qint64 iTimeFloat = timer.elapsed();
+
+    //
+    //   Results
+    //
+    double dSamples = (double)iRepetitions * iBlockSize;
+    double dMaxAbs = stcDouble.data.cwiseAbs().maxCoeff();
+    double dMaxError = (stcFloat.data - stcDouble.data).cwiseAbs().maxCoeff();
+    double dRelError = (stcFloat.data - stcDouble.data).norm() / stcDouble.data.norm();
+
+    printf("Kernel %ld x %ld, method %s, %d blocks of %d samples\n", (long)minimumNormDouble.getKernel().rows(), (long)minimumNormDouble.getKernel().cols(), method.toUtf8().constData(), iRepetitions, iBlockSize);
+    printf("double: %lld ms, %.1f samples/s\n", iTimeDouble, 1000.0 * dSamples / qMax(iTimeDouble, (qint64)1));
+    printf("float:  %lld ms, %.1f samples/s\n", iTimeFloat, 1000.0 * dSamples / qMax(iTimeFloat, (qint64)1));
+    printf("speedup: %.2f\n", (double)iTimeDouble / qMax(iTimeFloat, (qint64)1));
+    printf("max abs error: %e (max abs value %e), relative error (Frobenius): %e\n", dMaxError, dMaxAbs, dRelError);
+
+    return 0;
+}
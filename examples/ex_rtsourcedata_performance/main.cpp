@@ -0,0 +1,183 @@
+//=============================================================================================================
+/**
+* @file     main.cpp
+* @author   agent <agent@local>
+* @version  1.0
+* @date     October, 2026
+*
+* @section  LICENSE
+*
+* Copyright (C) 2026, agent. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+*
+* @brief    Example measuring the frame rate of the real-time source data color streaming.
+*
+*/
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include <disp3D/engine/model/workers/rtSourceLoc/rtsourcedataworker.h>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QVector3D>
+#include <QDebug>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// Eigen INCLUDES
+//=============================================================================================================
+
+#include <Eigen/Core>
+#include <Eigen/SparseCore>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// USED NAMESPACES
+//=============================================================================================================
+
+using namespace DISP3DLIB;
+using namespace Eigen;
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// MAIN
+//=============================================================================================================
+
+//=============================================================================================================
+/**
+* Creates a random interpolation matrix with a fixed number of weights per vertex.
+*
+* @param[in] iNumVert       The number of vertices.
+* @param[in] iNumSources    The number of sources.
+* @param[in] iNumWeights    The number of weights per vertex.
+*
+* @return The interpolation matrix.
+*/
+QSharedPointer<SparseMatrix<float> > createInterpolationMatrix(int iNumVert,
+                                                               int iNumSources,
+                                                               int iNumWeights)
+{
+    QVector<Triplet<float> > vecTriplets;
+    vecTriplets.reserve(iNumVert * iNumWeights);
+
+    for(int i = 0; i < iNumVert; ++i) {
+        for(int j = 0; j < iNumWeights; ++j) {
+            vecTriplets.append(Triplet<float>(i, qrand() % iNumSources, 1.0f / iNumWeights));
+        }
+    }
+
+    QSharedPointer<SparseMatrix<float> > pMatInterpolation = QSharedPointer<SparseMatrix<float> >(new SparseMatrix<float>(iNumVert, iNumSources));
+    pMatInterpolation->setFromTriplets(vecTriplets.begin(), vecTriplets.end());
+
+    return pMatInterpolation;
+}
+
+
+//=============================================================================================================
+/**
+* Streams random source activity through the real-time source data worker without any rendering and reports
+* the number of color frames per second the worker produces for both hemispheres.
+*
+* @param [in] argc (argument count) is an integer that indicates how many arguments were entered on the command line when the program was started.
+* @param [in] argv (argument vector) is an array of pointers to arrays of character objects. The array objects are null-terminated strings, representing the arguments that were entered on the command line when the program was started.
+* @return the value that was set to exit() (which is 0 if exit() is called via quit()).
+*/
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+
+    // Command Line Parser
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Real-Time Source Data Performance Example");
+    parser.addHelpOption();
+
+    QCommandLineOption vertOption("vertices", "The number of <vertices> per hemisphere.", "vertices", "150000");
+    QCommandLineOption sourceOption("sources", "The number of <sources> per hemisphere.", "sources", "4000");
+    QCommandLineOption weightOption("weights", "The number of interpolation <weights> per vertex.", "weights", "3");
+    QCommandLineOption frameOption("frames", "The number of <frames> to stream.", "frames", "500");
+    QCommandLineOption colormapOption("colormap", "The <colormap> to use.", "colormap", "Hot");
+
+    parser.addOption(vertOption);
+    parser.addOption(sourceOption);
+    parser.addOption(weightOption);
+    parser.addOption(frameOption);
+    parser.addOption(colormapOption);
+
+    parser.process(app);
+
+    int iNumVert = qMax(1, parser.value(vertOption).toInt());
+    int iNumSources = qMax(1, parser.value(sourceOption).toInt());
+    int iNumWeights = qMax(1, parser.value(weightOption).toInt());
+    int iNumFrames = qMax(1, parser.value(frameOption).toInt());
+
+    //Setup the worker the same way RtSourceDataController does
+    RtSourceDataWorker worker;
+    worker.setSFreq(1000.0);
+    worker.setLoopState(true);
+    worker.setNumberAverages(1);
+    worker.setStreamSmoothedData(true);
+    worker.setColormapType(parser.value(colormapOption));
+    worker.setThresholds(QVector3D(0.1f, 0.5f, 0.9f));
+    worker.setSurfaceColor(MatrixX4f::Constant(iNumVert, 4, 0.5f),
+                           MatrixX4f::Constant(iNumVert, 4, 0.5f));
+    worker.setInterpolationMatrixLeft(createInterpolationMatrix(iNumVert, iNumSources, iNumWeights));
+    worker.setInterpolationMatrixRight(createInterpolationMatrix(iNumVert, iNumSources, iNumWeights));
+    worker.addData(MatrixXd::Random(2 * iNumSources, 1000));
+
+    int iFrameCount = 0;
+    qint64 iBytes = 0;
+
+    QObject::connect(&worker, &RtSourceDataWorker::newRtSmoothedData,
+                     [&](const QByteArray &arrayColorsLeftHemi, const QByteArray &arrayColorsRightHemi) {
+        ++iFrameCount;
+        iBytes += arrayColorsLeftHemi.size() + arrayColorsRightHemi.size();
+    });
+
+    QElapsedTimer timer;
+    timer.start();
+
+    for(int i = 0; i < iNumFrames; ++i) {
+        worker.streamData();
+    }
+
+    qint64 iTime = qMax(qint64(1), timer.elapsed());
+
+    qDebug() << "Vertices per hemisphere:" << iNumVert << ", sources per hemisphere:" << iNumSources;
+    qDebug() << "Streamed" << iFrameCount << "frames in" << iTime << "ms";
+    qDebug() << "Frames per second:" << 1000.0 * iFrameCount / iTime;
+    qDebug() << "Color data per frame:" << (iFrameCount > 0 ? iBytes / iFrameCount : 0) << "bytes";
+
+    return 0;
+}
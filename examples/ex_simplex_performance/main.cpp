@@ -0,0 +1,250 @@
+//=============================================================================================================
+/**
+* @file     main.cpp
+* @author   agent <agent@local>
+* @version  1.0
+* @date     October, 2026
+*
+* @section  LICENSE
+*
+* Copyright (C) 2026, agent. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+*
+* @brief    Benchmark of the fixed-size and batched against the dynamic simplex minimization
+*
+*/
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include <utils/simplex_algorithm.h>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QDebug>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// Eigen INCLUDES
+//=============================================================================================================
+
+#include <Eigen/Core>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// USED NAMESPACES
+//=============================================================================================================
+
+using namespace UTILSLIB;
+using namespace Eigen;
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE GLOBAL METHODS
+//=============================================================================================================
+
+namespace {
+
+//=============================================================================================================
+/**
+* Sphere center cost as evaluated by the dynamic simplex, with temporaries for the differences and distances.
+*/
+float sphereEvalDynamic(const VectorXf& r0, const void* user_data)
+{
+    const MatrixXf& rr = *static_cast<const MatrixXf*>(user_data);
+
+    MatrixXf diff = rr.rowwise() - r0.transpose();
+    VectorXf one = diff.rowwise().norm();
+
+    double sum = one.cast<double>().sum();
+    double sum2 = one.cast<double>().squaredNorm();
+
+    return static_cast<float>(sum2 - sum*sum/rr.rows());
+}
+
+//=============================================================================================================
+/**
+* The same cost as functor for the fixed-size simplex.
+*/
+struct SphereCost {
+    const MatrixXf* pPoints;    /**< The n x 3 points. */
+
+    float operator()(const Vector3f& r0) const
+    {
+        const MatrixXf& rr = *pPoints;
+        double sum = 0.0;
+        double sum2 = 0.0;
+
+        for(int i = 0; i < rr.rows(); ++i) {
+            const double dist = (rr.row(i).transpose() - r0).norm();
+            sum += dist;
+            sum2 += dist * dist;
+        }
+
+        return static_cast<float>(sum2 - sum*sum/rr.rows());
+    }
+};
+
+}
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// MAIN
+//=============================================================================================================
+
+//=============================================================================================================
+/**
+* Fits sphere centers to many synthetic head shapes once with the dynamic simplex, once with the fixed-size simplex
+* and once with the batched fixed-size simplex, and reports the computation times and the largest difference of
+* the fitted centers.
+*
+* @param [in] argc (argument count) is an integer that indicates how many arguments were entered on the command line when the program was started.
+* @param [in] argv (argument vector) is an array of pointers to arrays of character objects. The array objects are null-terminated strings, representing the arguments that were entered on the command line when the program was started.
+* @return the value that was set to exit() (which is 0 if exit() is called via quit()).
+*/
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+
+    // Command Line Parser
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Simplex Performance Example");
+    parser.addHelpOption();
+
+    QCommandLineOption fitsOption("fits", "The number of <fits>.", "fits", "2000");
+    QCommandLineOption pointsOption("points", "The number of <points> per fit.", "points", "100");
+
+    parser.addOption(fitsOption);
+    parser.addOption(pointsOption);
+
+    parser.process(app);
+
+    int iNumFits = qMax(1, parser.value(fitsOption).toInt());
+    int iNumPoints = qMax(4, parser.value(pointsOption).toInt());
+
+    //Noisy upper half spheres around slightly different centers
+    std::vector<MatrixXf> vecPoints(iNumFits);
+
+    for(int s = 0; s < iNumFits; ++s) {
+        Vector3f vecCenter = 0.01f * Vector3f::Random() + Vector3f(0.0f, 0.0f, 0.04f);
+        float fRadius = 0.09f;
+
+        vecPoints[s].resize(iNumPoints, 3);
+        for(int i = 0; i < iNumPoints; ++i) {
+            Vector3f vecDir = Vector3f::Random();
+            vecDir(2) = std::fabs(vecDir(2));
+            vecDir.normalize();
+
+            vecPoints[s].row(i) = (vecCenter + (fRadius + 0.001f * Vector3f::Random()(0)) * vecDir).transpose();
+        }
+    }
+
+    //The same initial simplex around the centroid for all variants
+    std::vector<Matrix<float,4,3>, aligned_allocator<Matrix<float,4,3> > > vecSimplices(iNumFits);
+    std::vector<Vector4f, aligned_allocator<Vector4f> > vecVals(iNumFits);
+    std::vector<SphereCost> vecCosts(iNumFits);
+
+    for(int s = 0; s < iNumFits; ++s) {
+        Vector3f vecCm = vecPoints[s].colwise().mean().transpose();
+
+        vecCosts[s].pPoints = &vecPoints[s];
+        for(int k = 0; k < 4; ++k) {
+            vecSimplices[s].row(k) = vecCm.transpose();
+            if(k > 0) {
+                vecSimplices[s](k, k - 1) += 0.02f;
+            }
+            vecVals[s](k) = vecCosts[s](vecSimplices[s].row(k).transpose());
+        }
+    }
+
+    QElapsedTimer timer;
+    const float ftol = 1e-5f;
+    const int max_eval = 500;
+
+    //Dynamic simplex with a function pointer
+    std::vector<Vector3f, aligned_allocator<Vector3f> > vecCentersDyn(iNumFits);
+
+    timer.start();
+    for(int s = 0; s < iNumFits; ++s) {
+        MatrixXf matSimplex = vecSimplices[s];
+        VectorXf vecVal = vecVals[s];
+        int neval = 0;
+
+        SimplexAlgorithm::simplex_minimize<float>(matSimplex, vecVal, ftol, sphereEvalDynamic, &vecPoints[s], max_eval, neval, -1, NULL);
+
+        VectorXf::Index iBest;
+        vecVal.minCoeff(&iBest);
+        vecCentersDyn[s] = matSimplex.row(iBest).transpose();
+    }
+    qint64 iTimeDynamic = timer.elapsed();
+
+    //Fixed-size simplex, one fit after the other
+    std::vector<Vector3f, aligned_allocator<Vector3f> > vecCentersFixed(iNumFits);
+
+    timer.restart();
+    for(int s = 0; s < iNumFits; ++s) {
+        Matrix<float,4,3> matSimplex = vecSimplices[s];
+        Vector4f vecVal = vecVals[s];
+        int neval = 0;
+
+        SimplexAlgorithm::simplex_minimize<float,3>(matSimplex, vecVal, ftol, vecCosts[s], max_eval, neval);
+
+        vecCentersFixed[s] = matSimplex.row(0).transpose();
+    }
+    qint64 iTimeFixed = timer.elapsed();
+
+    //Fixed-size simplex, all fits in parallel
+    QVector<int> vecNeval;
+
+    timer.restart();
+    SimplexAlgorithm::simplex_minimize_batch<float,3>(vecSimplices, vecVals, vecCosts, ftol, max_eval, vecNeval);
+    qint64 iTimeBatch = timer.elapsed();
+
+    float fMaxDiffFixed = 0.0f;
+    float fMaxDiffBatch = 0.0f;
+
+    for(int s = 0; s < iNumFits; ++s) {
+        fMaxDiffFixed = qMax(fMaxDiffFixed, (vecCentersFixed[s] - vecCentersDyn[s]).norm());
+        fMaxDiffBatch = qMax(fMaxDiffBatch, (vecSimplices[s].row(0).transpose() - vecCentersFixed[s]).norm());
+    }
+
+    qDebug() << iNumFits << "sphere fits with" << iNumPoints << "points each";
+    qDebug() << "Dynamic simplex:" << iTimeDynamic << "ms";
+    qDebug() << "Fixed-size simplex:" << iTimeFixed << "ms, speedup" << double(iTimeDynamic) / qMax(qint64(1), iTimeFixed);
+    qDebug() << "Batched fixed-size simplex:" << iTimeBatch << "ms, speedup" << double(iTimeDynamic) / qMax(qint64(1), iTimeBatch);
+    qDebug() << "Largest center difference fixed-size vs dynamic:" << 1000.0f * fMaxDiffFixed << "mm";
+    qDebug() << "Largest center difference batched vs fixed-size:" << 1000.0f * fMaxDiffBatch << "mm";
+
+    return 0;
+}
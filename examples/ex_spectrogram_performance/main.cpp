@@ -0,0 +1,145 @@
+//=============================================================================================================
+/**
+* @file     main.cpp
+* @author   agent <agent@local>
+* @version  1.0
+* @date     October, 2026
+*
+* @section  LICENSE
+*
+* Copyright (C) 2026, agent. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+*
+* @brief    Benchmark of the short-time against the full-length spectrogram
+*
+*/
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include <math.h>
+
+#include <utils/spectrogram.h>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QDebug>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// Eigen INCLUDES
+//=============================================================================================================
+
+#include <Eigen/Core>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// USED NAMESPACES
+//=============================================================================================================
+
+using namespace UTILSLIB;
+using namespace Eigen;
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// MAIN
+//=============================================================================================================
+
+//=============================================================================================================
+/**
+* Computes the spectrogram of a synthetic chirp once with the full-length transform per sample and once with the
+* short-time transform, and reports the computation times and the relative difference of both results.
+*
+* @param [in] argc (argument count) is an integer that indicates how many arguments were entered on the command line when the program was started.
+* @param [in] argv (argument vector) is an array of pointers to arrays of character objects. The array objects are null-terminated strings, representing the arguments that were entered on the command line when the program was started.
+* @return the value that was set to exit() (which is 0 if exit() is called via quit()).
+*/
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+
+    // Command Line Parser
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Spectrogram Performance Example");
+    parser.addHelpOption();
+
+    QCommandLineOption sfreqOption("sfreq", "The sampling <frequency> in Hz.", "frequency", "1000");
+    QCommandLineOption secondsOption("seconds", "The signal length in <seconds>.", "seconds", "4");
+    QCommandLineOption windowOption("window", "The window <size> in samples (0 for a fifteenth of the signal length).", "size", "0");
+    QCommandLineOption hopOption("hop", "The hop <size> of the short-time transform in samples (0 for an eighth of the window size).", "size", "0");
+    QCommandLineOption skipReferenceOption("skipReference", "Only compute the short-time transform, e.g. for long signals.");
+
+    parser.addOption(sfreqOption);
+    parser.addOption(secondsOption);
+    parser.addOption(windowOption);
+    parser.addOption(hopOption);
+    parser.addOption(skipReferenceOption);
+
+    parser.process(app);
+
+    double dSFreq = qMax(1.0, parser.value(sfreqOption).toDouble());
+    double dSeconds = qMax(0.1, parser.value(secondsOption).toDouble());
+    int iWindowSize = qMax(0, parser.value(windowOption).toInt());
+    int iHopSize = qMax(0, parser.value(hopOption).toInt());
+
+    //Linear chirp from 10 Hz to a quarter of the sampling frequency plus a constant line and some noise
+    int iSamples = qMax(2, (int)(dSFreq * dSeconds));
+    VectorXd vecSignal = 0.1 * VectorXd::Random(iSamples);
+    double dChirpRate = (dSFreq / 4.0 - 10.0) / dSeconds;
+
+    for(int i = 0; i < iSamples; ++i) {
+        double t = i / dSFreq;
+        vecSignal(i) += sin(2.0 * M_PI * (10.0 + 0.5 * dChirpRate * t) * t) + 0.3 * sin(2.0 * M_PI * dSFreq / 8.0 * t);
+    }
+
+    QElapsedTimer timer;
+
+    timer.start();
+    MatrixXd matShortTime = Spectrogram::makeShortTimeSpectrogram(vecSignal, iWindowSize, iHopSize);
+    qint64 iTimeShortTime = timer.elapsed();
+
+    qDebug() << "Signal with" << iSamples << "samples, spectrogram of size" << matShortTime.rows() << "x" << matShortTime.cols();
+    qDebug() << "Short-time transform:" << iTimeShortTime << "ms";
+
+    if(!parser.isSet(skipReferenceOption)) {
+        timer.restart();
+        MatrixXd matReference = Spectrogram::makeSpectrogram(vecSignal, iWindowSize);
+        qint64 iTimeReference = timer.elapsed();
+
+        qDebug() << "Full-length transform per sample:" << iTimeReference << "ms";
+        qDebug() << "Speedup:" << double(iTimeReference) / qMax(qint64(1), iTimeShortTime);
+        qDebug() << "Relative difference:" << (matShortTime - matReference).norm() / matReference.norm();
+    }
+
+    return 0;
+}
@@ -47,6 +47,7 @@ SUBDIRS += \
     ex_fiff_io \
     ex_find_evoked \
     ex_inverse_mne \
+    ex_inverse_mne_performance \
     ex_make_inverse_operator \
     ex_make_layout \
     ex_read_bem \
@@ -55,10 +56,13 @@ SUBDIRS += \
     ex_read_fwd \
     ex_read_raw \
     ex_read_write_raw \
+    ex_simplex_performance \
+    ex_spectrogram_performance \
 
 !contains(MNECPP_CONFIG, minimalVersion) {
     qtHaveModule(charts) {
         SUBDIRS += \
+            ex_channeldata_performance \
             ex_clustered_inverse_mne \
             ex_clustered_inverse_mne_raw \
             ex_clustered_inverse_pwl_rap_music_raw \
@@ -74,6 +78,7 @@ SUBDIRS += \
             ex_inverse_pwl_rap_music \
             ex_inverse_rap_music \
             ex_read_fwd_disp_3D \
+            ex_rtsourcedata_performance \
             ex_roi_clustered_inverse_pwl_rap_music \
             ex_st_clustered_inverse_pwl_rap_music \
             ex_interpolation \
@@ -140,6 +140,7 @@ SOURCES += \
     viewers/helpers/frequencyspectrummodel.cpp \
     viewers/helpers/channeldatamodel.cpp \
     viewers/helpers/channeldatadelegate.cpp \
+    viewers/helpers/minmaxpyramid.cpp \
 
 HEADERS += \
     disp_global.h \
@@ -186,6 +187,7 @@ HEADERS += \
     viewers/helpers/frequencyspectrummodel.h \
     viewers/helpers/channeldatamodel.h \
     viewers/helpers/channeldatadelegate.h \
+    viewers/helpers/minmaxpyramid.h \
 
 qtHaveModule(charts) {
     SOURCES += \
@@ -184,6 +184,14 @@ void ChannelDataView::addData(const QList<Eigen::MatrixXd> &data)
 }
 
 
+//*************************************************************************************************************
+
+void ChannelDataView::addData(const QList<QSharedPointer<const Eigen::MatrixXd> > &data)
+{
+    m_pModel->addData(data);
+}
+
+
 //*************************************************************************************************************
 
 MatrixXd ChannelDataView::getLastBlock()
@@ -145,6 +145,14 @@ public:
     */
     void addData(const QList<Eigen::MatrixXd>& data);
 
+    //=========================================================================================================
+    /**
+    * Add shared data blocks to the view without copying them.
+    *
+    * @param [in] data    The new shared data blocks.
+    */
+    void addData(const QList<QSharedPointer<const Eigen::MatrixXd> >& data);
+
     //=========================================================================================================
     /**
     * Get the latest data block from the underlying model.
@@ -51,6 +51,15 @@
 #include <QPainter>
 
 
+//*************************************************************************************************************
+//=============================================================================================================
+// STL INCLUDES
+//=============================================================================================================
+
+#include <cmath>
+#include <limits>
+
+
 //*************************************************************************************************************
 //=============================================================================================================
 // Eigen INCLUDES
@@ -595,6 +604,24 @@ void ChannelDataDelegate::createPlotPath(const QModelIndex &index,
         path.moveTo(qSamplePosition);
     }
 
+    //Zoomed out, a path point per sample would only redraw the same pixel columns
+    if(dDx < 0.5) {
+        createDecimatedPlotPath(index, path, data, dScaleY, dDx);
+
+        qint32 iMarkerSample = (qint32)(m_markerPosition.x()/dDx);
+
+        if(iMarkerSample >= 0 && iMarkerSample < data.second) {
+            double dOffset = iMarkerSample < currentSampleIndex ? *(data.first) : lastFirstValue;
+
+            ellipsePos.setX(option.rect.x()+(iMarkerSample+1)*dDx);
+            ellipsePos.setY(y_base-(*(data.first+iMarkerSample)-dOffset)*dScaleY);
+
+            amplitude = QString::number(*(data.first+iMarkerSample));
+        }
+
+        return;
+    }
+
     double val;
 
     for(qint32 j=0; j < data.second; ++j)
@@ -624,6 +651,70 @@ void ChannelDataDelegate::createPlotPath(const QModelIndex &index,
 }
 
 
+//*************************************************************************************************************
+
+void ChannelDataDelegate::createDecimatedPlotPath(const QModelIndex &index,
+                                                  QPainterPath& path,
+                                                  const RowVectorPair &data,
+                                                  double dScaleY,
+                                                  double dDx) const
+{
+    const ChannelDataModel* t_pModel = static_cast<const ChannelDataModel*>(index.model());
+
+    int currentSampleIndex = t_pModel->getCurrentSampleIndex();
+    double firstValue = *(data.first);
+    double lastFirstValue = t_pModel->getLastBlockFirstValue(index.row());
+
+    double x_base = path.currentPosition().x();
+    double y_base = path.currentPosition().y();
+    double dLastY = y_base;
+    double dMin, dMax, dPartMin, dPartMax;
+
+    int iNumColumns = (int)ceil(data.second*dDx);
+
+    for(int iColumn = 0; iColumn < iNumColumns; ++iColumn) {
+        int iFirst = (int)(iColumn/dDx);
+        int iLast = qMin((int)((iColumn+1)/dDx), (int)data.second);
+
+        if(iFirst >= iLast) {
+            continue;
+        }
+
+        //Samples before the current position are offset by the first sample, the others by the first value of the last block
+        dMin = std::numeric_limits<double>::max();
+        dMax = -std::numeric_limits<double>::max();
+
+        if(iFirst < currentSampleIndex) {
+            t_pModel->getMinMax(index.row(), iFirst, qMin(iLast, currentSampleIndex), dPartMin, dPartMax);
+            dMin = dPartMin - firstValue;
+            dMax = dPartMax - firstValue;
+        }
+
+        if(iLast > currentSampleIndex) {
+            t_pModel->getMinMax(index.row(), qMax(iFirst, currentSampleIndex), iLast, dPartMin, dPartMax);
+            dMin = qMin(dMin, dPartMin - lastFirstValue);
+            dMax = qMax(dMax, dPartMax - lastFirstValue);
+        }
+
+        //Reverse direction -> plot the right way
+        double dYMax = y_base - dMax*dScaleY;
+        double dYMin = y_base - dMin*dScaleY;
+        double dX = x_base + iColumn + 0.5;
+
+        //Start with the extreme which is closer to the end of the previous column
+        if(qAbs(dLastY - dYMax) < qAbs(dLastY - dYMin)) {
+            path.lineTo(dX, dYMax);
+            path.lineTo(dX, dYMin);
+            dLastY = dYMin;
+        } else {
+            path.lineTo(dX, dYMin);
+            path.lineTo(dX, dYMax);
+            dLastY = dYMax;
+        }
+    }
+}
+
+
 //*************************************************************************************************************
 
 void ChannelDataDelegate::createCurrentPositionMarkerPath(const QModelIndex &index, const QStyleOptionViewItem &option, QPainterPath& path) const
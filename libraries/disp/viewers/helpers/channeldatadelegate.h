@@ -191,6 +191,23 @@ private:
                         QString &amplitude,
                         DISPLIB::RowVectorPair &data) const;
 
+    //=========================================================================================================
+    /**
+    * createDecimatedPlotPath creates the QPointer path for the data plot when more than two samples fall onto one
+    * pixel column. Each pixel column is drawn as a vertical line between the minimum and maximum of its samples.
+    *
+    * @param[in] index      Used to locate data in a data model.
+    * @param[in,out] path   The QPointerPath to create for the data plot.
+    * @param[in] data       Current data for the given row.
+    * @param[in] dScaleY    Pixels per data unit.
+    * @param[in] dDx        Pixels per sample.
+    */
+    void createDecimatedPlotPath(const QModelIndex &index,
+                                 QPainterPath& path,
+                                 const DISPLIB::RowVectorPair &data,
+                                 double dScaleY,
+                                 double dDx) const;
+
     //=========================================================================================================
     /**
     * createCurrentPositionMarkerPath Creates the QPointer path for the current marker position plot.
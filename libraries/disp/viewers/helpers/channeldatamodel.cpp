@@ -321,6 +321,9 @@ void ChannelDataModel::setFiffInfo(QSharedPointer<FIFFLIB::FiffInfo> &p_pFiffInf
         m_matDataFiltered.conservativeResize(m_pFiffInfo->chs.size(), m_iMaxSamples);
         m_matDataFiltered.setZero();
 
+        m_pyramidRaw.build(m_matDataRaw);
+        m_pyramidFiltered.build(m_matDataFiltered);
+
         m_vecLastBlockFirstValuesFiltered.conservativeResize(m_pFiffInfo->chs.size());
         m_vecLastBlockFirstValuesFiltered.setZero();
 
@@ -401,6 +404,9 @@ void ChannelDataModel::setSamplingInfo(float sps, int T, bool bSetZero)
         m_iCurrentSample = 0;
     }
 
+    m_pyramidRaw.build(m_matDataRaw);
+    m_pyramidFiltered.build(m_matDataFiltered);
+
     endResetModel();
 }
 
@@ -421,148 +427,234 @@ MatrixXd ChannelDataModel::getLastBlock()
 
 void ChannelDataModel::addData(const QList<MatrixXd> &data)
 {
-    //SSP
-    bool doProj = m_bProjActivated && m_matDataRaw.cols() > 0 && m_matDataRaw.rows() == m_matProj.cols() ? true : false;
-
-    //Compensator
-    bool doComp = m_bCompActivated && m_matDataRaw.cols() > 0 && m_matDataRaw.rows() == m_matComp.cols() ? true : false;
-
-    //SPHARA
-    bool doSphara = m_bSpharaActivated && m_matSparseSpharaMult.cols() > 0 && m_matDataRaw.rows() == m_matSparseSpharaMult.cols() ? true : false;
+    bool doProj, doComp, doSphara;
+    getActiveOperators(doProj, doComp, doSphara);
 
     //Copy new data into the global data matrix
     for(qint32 b = 0; b < data.size(); ++b) {
-        int nCol = data.at(b).cols();
-        int nRow = data.at(b).rows();
+        if(!addBlock(data.at(b), doProj, doComp, doSphara)) {
+            return;
+        }
+    }
+
+    emitDataChanged();
+}
 
-        if(nRow != m_matDataRaw.rows()) {
-            qDebug()<<"incoming data does not match internal data row size. Returning...";
+
+//*************************************************************************************************************
+
+void ChannelDataModel::addData(const QList<QSharedPointer<const MatrixXd> > &data)
+{
+    bool doProj, doComp, doSphara;
+    getActiveOperators(doProj, doComp, doSphara);
+
+    //The shared blocks are only read, they are never copied or altered
+    for(qint32 b = 0; b < data.size(); ++b) {
+        if(!data.at(b) || !addBlock(*data.at(b), doProj, doComp, doSphara)) {
             return;
         }
+    }
 
-        //Reset m_iCurrentSample and start filling the data matrix from the beginning again. Also add residual amount of data to the end of the matrix.
-        if(m_iCurrentSample+nCol > m_matDataRaw.cols()) {
-            m_iResidual = nCol - ((m_iCurrentSample+nCol) % m_matDataRaw.cols());
+    emitDataChanged();
+}
 
-            if(m_iResidual == nCol) {
-                m_iResidual = 0;
-            }
 
-//            std::cout<<"incoming data exceeds internal data cols by: "<<(m_iCurrentSample+nCol) % m_matDataRaw.cols()<<std::endl;
-//            std::cout<<"m_iCurrentSample+nCol: "<<m_iCurrentSample+nCol<<std::endl;
-//            std::cout<<"m_matDataRaw.cols(): "<<m_matDataRaw.cols()<<std::endl;
-//            std::cout<<"nCol-m_iResidual: "<<nCol-m_iResidual<<std::endl<<std::endl;
+//*************************************************************************************************************
 
-            if(doComp) {
-                if(doProj) {
-                    //Comp + Proj
-                    m_matDataRaw.block(0, m_iCurrentSample, nRow, m_iResidual) = m_matSparseProjCompMult * data.at(b).block(0,0,nRow,m_iResidual);
-                } else {
-                    //Comp
-                    m_matDataRaw.block(0, m_iCurrentSample, nRow, m_iResidual) = m_matSparseCompMult * data.at(b).block(0,0,nRow,m_iResidual);
-                }
-            } else {
-                if(doProj)
-                {
-                    //Proj
-                    m_matDataRaw.block(0, m_iCurrentSample, nRow, m_iResidual) = m_matSparseProjMult * data.at(b).block(0,0,nRow,m_iResidual);
-                } else {
-                    //None - Raw
-                    m_matDataRaw.block(0, m_iCurrentSample, nRow, m_iResidual) = data.at(b).block(0,0,nRow,m_iResidual);
-                }
-            }
+void ChannelDataModel::getActiveOperators(bool& doProj, bool& doComp, bool& doSphara) const
+{
+    //SSP
+    doProj = m_bProjActivated && m_matDataRaw.cols() > 0 && m_matDataRaw.rows() == m_matProj.cols() ? true : false;
+
+    //Compensator
+    doComp = m_bCompActivated && m_matDataRaw.cols() > 0 && m_matDataRaw.rows() == m_matComp.cols() ? true : false;
 
-            m_iCurrentSample = 0;
+    //SPHARA
+    doSphara = m_bSpharaActivated && m_matSparseSpharaMult.cols() > 0 && m_matDataRaw.rows() == m_matSparseSpharaMult.cols() ? true : false;
+}
 
-            if(!m_bIsFreezed) {
-                m_vecLastBlockFirstValuesFiltered = m_matDataFiltered.col(0);
-                m_vecLastBlockFirstValuesRaw = m_matDataRaw.col(0);
-            }
 
-            //Store old detected triggers
-            m_qMapDetectedTriggerOld = m_qMapDetectedTrigger;
+//*************************************************************************************************************
 
-            //Clear detected triggers
-            if(m_bTriggerDetectionActive) {
-                QMutableMapIterator<int,QList<QPair<int,double> > > i(m_qMapDetectedTrigger);
-                while (i.hasNext()) {
-                    i.next();
-                    i.value().clear();
-                }
-            }
-        } else {
+bool ChannelDataModel::addBlock(const MatrixXd &data, bool doProj, bool doComp, bool doSphara)
+{
+    int nCol = data.cols();
+    int nRow = data.rows();
+
+    if(nRow != m_matDataRaw.rows()) {
+        qDebug()<<"incoming data does not match internal data row size. Returning...";
+        return false;
+    }
+
+    //Reset m_iCurrentSample and start filling the data matrix from the beginning again. Also add residual amount of data to the end of the matrix.
+    if(m_iCurrentSample+nCol > m_matDataRaw.cols()) {
+        m_iResidual = nCol - ((m_iCurrentSample+nCol) % m_matDataRaw.cols());
+
+        if(m_iResidual == nCol) {
             m_iResidual = 0;
         }
 
-        //std::cout<<"incoming data is ok"<<std::endl;
+//        std::cout<<"incoming data exceeds internal data cols by: "<<(m_iCurrentSample+nCol) % m_matDataRaw.cols()<<std::endl;
+//        std::cout<<"m_iCurrentSample+nCol: "<<m_iCurrentSample+nCol<<std::endl;
+//        std::cout<<"m_matDataRaw.cols(): "<<m_matDataRaw.cols()<<std::endl;
+//        std::cout<<"nCol-m_iResidual: "<<nCol-m_iResidual<<std::endl<<std::endl;
 
         if(doComp) {
             if(doProj) {
                 //Comp + Proj
-                m_matDataRaw.block(0, m_iCurrentSample, nRow, nCol) = m_matSparseProjCompMult * data.at(b);
+                m_matDataRaw.block(0, m_iCurrentSample, nRow, m_iResidual) = m_matSparseProjCompMult * data.block(0,0,nRow,m_iResidual);
             } else {
                 //Comp
-                m_matDataRaw.block(0, m_iCurrentSample, nRow, nCol) = m_matSparseCompMult * data.at(b);
+                m_matDataRaw.block(0, m_iCurrentSample, nRow, m_iResidual) = m_matSparseCompMult * data.block(0,0,nRow,m_iResidual);
             }
         } else {
-            if(doProj) {
+            if(doProj)
+            {
                 //Proj
-                m_matDataRaw.block(0, m_iCurrentSample, nRow, nCol) = m_matSparseProjMult * data.at(b);
+                m_matDataRaw.block(0, m_iCurrentSample, nRow, m_iResidual) = m_matSparseProjMult * data.block(0,0,nRow,m_iResidual);
             } else {
                 //None - Raw
-                m_matDataRaw.block(0, m_iCurrentSample, nRow, nCol) = data.at(b);
+                m_matDataRaw.block(0, m_iCurrentSample, nRow, m_iResidual) = data.block(0,0,nRow,m_iResidual);
             }
         }
 
-        //Filter if neccessary else set filtered data matrix to zero
-        if(!m_filterData.isEmpty() && m_bPerformFiltering) {
-            filterChannelsConcurrently(m_matDataRaw.block(0, m_iCurrentSample, nRow, nCol), m_iCurrentSample);
+        m_iCurrentSample = 0;
 
-            //Perform SPHARA on filtered data after actual filtering - SPHARA should be applied on the best possible data
-            if(doSphara) {
-                if(m_iCurrentSample-m_iMaxFilterLength/2 >= 0) {
-                    m_matDataFiltered.block(0, m_iCurrentSample-m_iMaxFilterLength/2, nRow, nCol) = m_matSparseSpharaMult * m_matDataFiltered.block(0, m_iCurrentSample-m_iMaxFilterLength/2, nRow, nCol);
-                }
-                else {
-                    if(m_iCurrentSample-m_iMaxFilterLength/2 < 0) {
-                        m_matDataFiltered.block(0, 0, nRow, nCol) = m_matSparseSpharaMult * m_matDataFiltered.block(0, 0, nRow, nCol);
-                        int iResidual = m_iResidual+m_iMaxFilterLength/2;
-                        m_matDataFiltered.block(0, m_matDataFiltered.cols()-iResidual, nRow, iResidual) = m_matSparseSpharaMult * m_matDataFiltered.block(0, m_matDataFiltered.cols()-iResidual, nRow, iResidual);
-                    }
-                }
+        if(!m_bIsFreezed) {
+            m_vecLastBlockFirstValuesFiltered = m_matDataFiltered.col(0);
+            m_vecLastBlockFirstValuesRaw = m_matDataRaw.col(0);
+        }
+
+        //Store old detected triggers
+        m_qMapDetectedTriggerOld = m_qMapDetectedTrigger;
+
+        //Clear detected triggers
+        if(m_bTriggerDetectionActive) {
+            QMutableMapIterator<int,QList<QPair<int,double> > > i(m_qMapDetectedTrigger);
+            while (i.hasNext()) {
+                i.next();
+                i.value().clear();
             }
+        }
+    } else {
+        m_iResidual = 0;
+    }
+
+    //std::cout<<"incoming data is ok"<<std::endl;
+
+    if(doComp) {
+        if(doProj) {
+            //Comp + Proj
+            m_matDataRaw.block(0, m_iCurrentSample, nRow, nCol) = m_matSparseProjCompMult * data;
+        } else {
+            //Comp
+            m_matDataRaw.block(0, m_iCurrentSample, nRow, nCol) = m_matSparseCompMult * data;
+        }
+    } else {
+        if(doProj) {
+            //Proj
+            m_matDataRaw.block(0, m_iCurrentSample, nRow, nCol) = m_matSparseProjMult * data;
         } else {
-            m_matDataFiltered.block(0, m_iCurrentSample, nRow, nCol).setZero();// = m_matDataRaw.block(0, m_iCurrentSample, nRow, nCol);
+            //None - Raw
+            m_matDataRaw.block(0, m_iCurrentSample, nRow, nCol) = data;
+        }
+    }
+
+    //Filter if neccessary else set filtered data matrix to zero
+    if(!m_filterData.isEmpty() && m_bPerformFiltering) {
+        filterChannelsConcurrently(m_matDataRaw.block(0, m_iCurrentSample, nRow, nCol), m_iCurrentSample);
 
-            //Perform SPHARA on raw data data
-            if(doSphara) {
-                m_matDataRaw.block(0, m_iCurrentSample, nRow, nCol) = m_matSparseSpharaMult * m_matDataRaw.block(0, m_iCurrentSample, nRow, nCol);
+        //Perform SPHARA on filtered data after actual filtering - SPHARA should be applied on the best possible data
+        if(doSphara) {
+            if(m_iCurrentSample-m_iMaxFilterLength/2 >= 0) {
+                m_matDataFiltered.block(0, m_iCurrentSample-m_iMaxFilterLength/2, nRow, nCol) = m_matSparseSpharaMult * m_matDataFiltered.block(0, m_iCurrentSample-m_iMaxFilterLength/2, nRow, nCol);
             }
+            else {
+                if(m_iCurrentSample-m_iMaxFilterLength/2 < 0) {
+                    m_matDataFiltered.block(0, 0, nRow, nCol) = m_matSparseSpharaMult * m_matDataFiltered.block(0, 0, nRow, nCol);
+                    int iResidual = m_iResidual+m_iMaxFilterLength/2;
+                    m_matDataFiltered.block(0, m_matDataFiltered.cols()-iResidual, nRow, iResidual) = m_matSparseSpharaMult * m_matDataFiltered.block(0, m_matDataFiltered.cols()-iResidual, nRow, iResidual);
+                }
+            }
+        }
+    } else {
+        m_matDataFiltered.block(0, m_iCurrentSample, nRow, nCol).setZero();// = m_matDataRaw.block(0, m_iCurrentSample, nRow, nCol);
+
+        //Perform SPHARA on raw data data
+        if(doSphara) {
+            m_matDataRaw.block(0, m_iCurrentSample, nRow, nCol) = m_matSparseSpharaMult * m_matDataRaw.block(0, m_iCurrentSample, nRow, nCol);
         }
+    }
 
-        m_iCurrentSample += nCol;
-        m_iCurrentBlockSize = nCol;
+    m_iCurrentSample += nCol;
+    m_iCurrentBlockSize = nCol;
 
-        //detect the trigger flanks in the trigger channels
-        if(m_bTriggerDetectionActive) {
-            int iOldDetectedTriggers = m_qMapDetectedTrigger[m_iCurrentTriggerChIndex].size();
+    //The overlap add filtering also changes the samples up to one filter length around the new block
+    int iMargin = !m_filterData.isEmpty() && m_bPerformFiltering ? m_iMaxFilterLength : 0;
+
+    if(m_iResidual > 0) {
+        updatePyramids(m_matDataRaw.cols() - m_iResidual - iMargin, m_iResidual + iMargin);
+    }
 
-            QList<QPair<int,double> > qMapDetectedTrigger = DetectTrigger::detectTriggerFlanksMax(data.at(b), m_iCurrentTriggerChIndex, m_iCurrentSample-nCol, m_dTriggerThreshold, true, 500);
-            //QList<QPair<int,double> > qMapDetectedTrigger = DetectTrigger::detectTriggerFlanksGrad(data.at(b), m_iCurrentTriggerChIndex, m_iCurrentSample-nCol, m_dTriggerThreshold, false, "Rising");
+    updatePyramids(m_iCurrentSample - nCol - iMargin, nCol + 2 * iMargin);
 
-            //Append results to already found triggers
-            m_qMapDetectedTrigger[m_iCurrentTriggerChIndex].append(qMapDetectedTrigger);
+    //detect the trigger flanks in the trigger channels
+    if(m_bTriggerDetectionActive) {
+        int iOldDetectedTriggers = m_qMapDetectedTrigger[m_iCurrentTriggerChIndex].size();
 
-            //Compute newly counted triggers
-            int newTriggers = m_qMapDetectedTrigger[m_iCurrentTriggerChIndex].size() - iOldDetectedTriggers;
+        QList<QPair<int,double> > qMapDetectedTrigger = DetectTrigger::detectTriggerFlanksMax(data, m_iCurrentTriggerChIndex, m_iCurrentSample-nCol, m_dTriggerThreshold, true, 500);
+        //QList<QPair<int,double> > qMapDetectedTrigger = DetectTrigger::detectTriggerFlanksGrad(data, m_iCurrentTriggerChIndex, m_iCurrentSample-nCol, m_dTriggerThreshold, false, "Rising");
 
-            if(newTriggers!=0) {
-                m_iDetectedTriggers += newTriggers;
-                emit triggerDetected(m_iDetectedTriggers, m_qMapDetectedTrigger);
-            }
+        //Append results to already found triggers
+        m_qMapDetectedTrigger[m_iCurrentTriggerChIndex].append(qMapDetectedTrigger);
+
+        //Compute newly counted triggers
+        int newTriggers = m_qMapDetectedTrigger[m_iCurrentTriggerChIndex].size() - iOldDetectedTriggers;
+
+        if(newTriggers!=0) {
+            m_iDetectedTriggers += newTriggers;
+            emit triggerDetected(m_iDetectedTriggers, m_qMapDetectedTrigger);
         }
     }
 
+    return true;
+}
+
+
+//*************************************************************************************************************
+
+void ChannelDataModel::updatePyramids(int iFirstCol, int iNumCols)
+{
+    int iCols = m_matDataRaw.cols();
+
+    if(iCols == 0 || iNumCols <= 0) {
+        return;
+    }
+
+    if(iNumCols >= iCols) {
+        m_pyramidRaw.update(m_matDataRaw, 0, iCols);
+        m_pyramidFiltered.update(m_matDataFiltered, 0, iCols);
+        return;
+    }
+
+    //Split the range where it wraps around the end of the data matrices
+    iFirstCol = ((iFirstCol % iCols) + iCols) % iCols;
+    int iHead = qMin(iNumCols, iCols - iFirstCol);
+
+    m_pyramidRaw.update(m_matDataRaw, iFirstCol, iHead);
+    m_pyramidFiltered.update(m_matDataFiltered, iFirstCol, iHead);
+
+    if(iHead < iNumCols) {
+        m_pyramidRaw.update(m_matDataRaw, 0, iNumCols - iHead);
+        m_pyramidFiltered.update(m_matDataFiltered, 0, iNumCols - iHead);
+    }
+}
+
+
+//*************************************************************************************************************
+
+void ChannelDataModel::emitDataChanged()
+{
     //Update data content
     QModelIndex topLeft = this->index(0,1);
     QModelIndex bottomRight = this->index(m_pFiffInfo->ch_names.size()-1,1);
@@ -611,6 +703,44 @@ fiff_int_t ChannelDataModel::getCoil(qint32 row) const
 }
 
 
+//*************************************************************************************************************
+
+void ChannelDataModel::getMinMax(int row, int iFirst, int iLast, double& dMin, double& dMax) const
+{
+    qint32 chRow = m_qMapIdxRowSelection.value(row,0);
+
+    //Same data selection as in data()
+    const MatrixXdR* pData;
+    const MinMaxPyramid* pPyramid;
+
+    if(m_bIsFreezed) {
+        if(!m_filterData.isEmpty() && m_bPerformFiltering) {
+            pData = &m_matDataFilteredFreeze;
+            pPyramid = &m_pyramidFilteredFreeze;
+        } else {
+            pData = &m_matDataRawFreeze;
+            pPyramid = &m_pyramidRawFreeze;
+        }
+    } else {
+        if(!m_filterData.isEmpty() && m_bPerformFiltering) {
+            pData = &m_matDataFiltered;
+            pPyramid = &m_pyramidFiltered;
+        } else {
+            pData = &m_matDataRaw;
+            pPyramid = &m_pyramidRaw;
+        }
+    }
+
+    if(chRow >= pData->rows() || pPyramid->cols() != pData->cols()) {
+        dMin = 0.0;
+        dMax = 0.0;
+        return;
+    }
+
+    pPyramid->minMax(pData->data() + chRow*pData->cols(), chRow, iFirst, iLast, dMin, dMax);
+}
+
+
 //*************************************************************************************************************
 
 void ChannelDataModel::selectRows(const QList<qint32> &selection)
@@ -676,6 +806,8 @@ void ChannelDataModel::toggleFreeze(const QModelIndex &)
     if(m_bIsFreezed) {
         m_matDataRawFreeze = m_matDataRaw;
         m_matDataFilteredFreeze = m_matDataFiltered;
+        m_pyramidRawFreeze = m_pyramidRaw;
+        m_pyramidFilteredFreeze = m_pyramidFiltered;
         m_qMapDetectedTriggerFreeze = m_qMapDetectedTrigger;
         m_qMapDetectedTriggerOldFreeze = m_qMapDetectedTriggerOld;
 
@@ -1207,6 +1339,8 @@ void ChannelDataModel::filterChannelsConcurrently()
         m_vecLastBlockFirstValuesFiltered = m_matDataFiltered.col(0);
     }
 
+    m_pyramidFiltered.build(m_matDataFiltered);
+
     //std::cout<<"END ChannelDataModel::filterChannelsConcurrently"<<std::endl;
 }
 
@@ -1342,5 +1476,10 @@ void ChannelDataModel::clearModel()
     m_vecLastBlockFirstValuesRaw.setZero();
     m_matOverlap.setZero();
 
+    m_pyramidRaw.build(m_matDataRaw);
+    m_pyramidFiltered.build(m_matDataFiltered);
+    m_pyramidRawFreeze.build(m_matDataRawFreeze);
+    m_pyramidFilteredFreeze.build(m_matDataFilteredFreeze);
+
     endResetModel();
 }
@@ -43,6 +43,7 @@
 //=============================================================================================================
 
 #include "../../disp_global.h"
+#include "minmaxpyramid.h"
 
 #include <fiff/fiff_types.h>
 #include <fiff/fiff_proj.h>
@@ -204,6 +205,14 @@ public:
     */
     void addData(const QList<Eigen::MatrixXd> &data);
 
+    //=========================================================================================================
+    /**
+    * Adds multiple shared, immutable data blocks. The blocks are read in place and are not copied.
+    *
+    * @param[in] data       shared data blocks to add (Time points of channel samples)
+    */
+    void addData(const QList<QSharedPointer<const Eigen::MatrixXd> > &data);
+
     //=========================================================================================================
     /**
     * Returns the kind of a given channel number
@@ -260,6 +269,19 @@ public:
     */
     inline double getLastBlockFirstValue(int row) const;
 
+    //=========================================================================================================
+    /**
+    * Returns the minimum and maximum of a sample range of the displayed data of a row. The values are looked up in
+    * the min/max pyramid which is kept up to date with the data.
+    *
+    * @param[in] row        row for which the range is to be evaluated
+    * @param[in] iFirst     first sample of the range
+    * @param[in] iLast      sample after the last sample of the range
+    * @param[out] dMin      the minimum
+    * @param[out] dMax      the maximum
+    */
+    void getMinMax(int row, int iFirst, int iLast, double& dMin, double& dMax) const;
+
     //=========================================================================================================
     /**
     * Returns a map which conatins the channel idx and its corresponding selection status
@@ -547,6 +569,45 @@ private:
     */
     void clearModel();
 
+    //=========================================================================================================
+    /**
+    * Determines which of the projection, compensation and SPHARA operators are applied to incoming data.
+    *
+    * @param [out] doProj       whether the SSP projectors are applied
+    * @param [out] doComp       whether the compensator is applied
+    * @param [out] doSphara     whether SPHARA is applied
+    */
+    void getActiveOperators(bool& doProj, bool& doComp, bool& doSphara) const;
+
+    //=========================================================================================================
+    /**
+    * Writes one data block into the global data matrix, filters it and detects triggers.
+    *
+    * @param [in] data          data block to add
+    * @param [in] doProj        whether the SSP projectors are applied
+    * @param [in] doComp        whether the compensator is applied
+    * @param [in] doSphara      whether SPHARA is applied
+    *
+    * @return false if the block does not match the number of channels.
+    */
+    bool addBlock(const Eigen::MatrixXd &data, bool doProj, bool doComp, bool doSphara);
+
+    //=========================================================================================================
+    /**
+    * Notifies the views that the data content changed.
+    */
+    void emitDataChanged();
+
+    //=========================================================================================================
+    /**
+    * Recomputes the min/max pyramids of the raw and filtered data for a column range. The range wraps around the
+    * data matrices like the data itself.
+    *
+    * @param [in] iFirstCol     first column which changed
+    * @param [in] iNumCols      number of columns which changed
+    */
+    void updatePyramids(int iFirstCol, int iNumCols);
+
     bool                                m_bProjActivated;                           /**< Projections activated */
     bool                                m_bCompActivated;                           /**< Compensator activated */
     bool                                m_bSpharaActivated;                         /**< Sphara activated */
@@ -581,6 +642,10 @@ private:
     MatrixXdR                           m_matDataFiltered;                          /**< The filtered data */
     MatrixXdR                           m_matDataRawFreeze;                         /**< The raw data in freeze mode */
     MatrixXdR                           m_matDataFilteredFreeze;                    /**< The raw filtered data in freeze mode */
+    MinMaxPyramid                       m_pyramidRaw;                               /**< The min/max pyramid of the raw data */
+    MinMaxPyramid                       m_pyramidFiltered;                          /**< The min/max pyramid of the filtered data */
+    MinMaxPyramid                       m_pyramidRawFreeze;                         /**< The min/max pyramid of the raw data in freeze mode */
+    MinMaxPyramid                       m_pyramidFilteredFreeze;                    /**< The min/max pyramid of the filtered data in freeze mode */
     Eigen::MatrixXd                     m_matOverlap;                               /**< Last overlap block for the back */
 
     Eigen::VectorXi                     m_vecIndicesFirstVV;                        /**< The indices of the channels to pick for the first SPHARA operator in case of a VectorView system.*/
@@ -0,0 +1,248 @@
+//=============================================================================================================
+/**
+* @file     minmaxpyramid.cpp
+* @author   agent <agent@local>
+* @version  1.0
+* @date     October, 2026
+*
+* @section  LICENSE
+*
+* Copyright (C) 2026, agent. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+*
+* @brief    Definition of the MinMaxPyramid Class.
+*
+*/
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "minmaxpyramid.h"
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// STL INCLUDES
+//=============================================================================================================
+
+#include <limits>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// USED NAMESPACES
+//=============================================================================================================
+
+using namespace DISPLIB;
+using namespace Eigen;
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE MEMBER METHODS
+//=============================================================================================================
+
+MinMaxPyramid::MinMaxPyramid(int iBinSize)
+: m_iBinSize(qMax(1, iBinSize))
+, m_iNumRows(0)
+, m_iNumCols(0)
+{
+}
+
+
+//*************************************************************************************************************
+
+void MinMaxPyramid::resize(int iNumRows, int iNumCols)
+{
+    m_iNumRows = qMax(0, iNumRows);
+    m_iNumCols = qMax(0, iNumCols);
+
+    m_vMin.clear();
+    m_vMax.clear();
+
+    if(m_iNumRows == 0 || m_iNumCols == 0) {
+        return;
+    }
+
+    //Halve the number of bins until a single bin covers all columns
+    int iNumBins = (m_iNumCols + m_iBinSize - 1) / m_iBinSize;
+
+    while(true) {
+        m_vMin.append(MatrixXfR::Zero(m_iNumRows, iNumBins));
+        m_vMax.append(MatrixXfR::Zero(m_iNumRows, iNumBins));
+
+        if(iNumBins == 1) {
+            break;
+        }
+
+        iNumBins = (iNumBins + 1) / 2;
+    }
+}
+
+
+//*************************************************************************************************************
+
+void MinMaxPyramid::build(const MatrixXdR& matData)
+{
+    resize(matData.rows(), matData.cols());
+    update(matData, 0, matData.cols());
+}
+
+
+//*************************************************************************************************************
+
+void MinMaxPyramid::update(const MatrixXdR& matData,
+                           int iFirstCol,
+                           int iNumCols)
+{
+    if(matData.rows() != m_iNumRows || matData.cols() != m_iNumCols) {
+        return;
+    }
+
+    for(int i = 0; i < m_iNumRows; ++i) {
+        updateRow(matData.data() + i * matData.cols(), i, iFirstCol, iNumCols);
+    }
+}
+
+
+//*************************************************************************************************************
+
+void MinMaxPyramid::updateRow(const double* pRowData,
+                              int iRow,
+                              int iFirstCol,
+                              int iNumCols)
+{
+    int iLastCol = qMin(m_iNumCols, iFirstCol + iNumCols);
+    iFirstCol = qMax(0, iFirstCol);
+
+    if(iRow < 0 || iRow >= m_iNumRows || iFirstCol >= iLastCol) {
+        return;
+    }
+
+    //Level 0 from the data
+    int iFirstBin = iFirstCol / m_iBinSize;
+    int iLastBin = (iLastCol - 1) / m_iBinSize + 1;
+
+    for(int b = iFirstBin; b < iLastBin; ++b) {
+        int iStart = b * m_iBinSize;
+        int iEnd = qMin(iStart + m_iBinSize, m_iNumCols);
+        double dMin = pRowData[iStart];
+        double dMax = dMin;
+
+        for(int j = iStart + 1; j < iEnd; ++j) {
+            dMin = qMin(dMin, pRowData[j]);
+            dMax = qMax(dMax, pRowData[j]);
+        }
+
+        m_vMin[0](iRow, b) = float(dMin);
+        m_vMax[0](iRow, b) = float(dMax);
+    }
+
+    //Merge the changed bins upwards
+    for(int l = 1; l < m_vMin.size(); ++l) {
+        const MatrixXfR& matMinBelow = m_vMin.at(l-1);
+        const MatrixXfR& matMaxBelow = m_vMax.at(l-1);
+        int iNumBinsBelow = matMinBelow.cols();
+
+        iFirstBin /= 2;
+        iLastBin = (iLastBin + 1) / 2;
+
+        for(int b = iFirstBin; b < iLastBin; ++b) {
+            float fMin = matMinBelow(iRow, 2*b);
+            float fMax = matMaxBelow(iRow, 2*b);
+
+            if(2*b + 1 < iNumBinsBelow) {
+                fMin = qMin(fMin, matMinBelow(iRow, 2*b + 1));
+                fMax = qMax(fMax, matMaxBelow(iRow, 2*b + 1));
+            }
+
+            m_vMin[l](iRow, b) = fMin;
+            m_vMax[l](iRow, b) = fMax;
+        }
+    }
+}
+
+
+//*************************************************************************************************************
+
+void MinMaxPyramid::minMax(const double* pRowData,
+                           int iRow,
+                           int iFirstCol,
+                           int iLastCol,
+                           double& dMin,
+                           double& dMax) const
+{
+    iFirstCol = qMax(0, iFirstCol);
+    iLastCol = qMin(m_iNumCols, iLastCol);
+
+    if(iRow < 0 || iRow >= m_iNumRows || iFirstCol >= iLastCol) {
+        dMin = 0.0;
+        dMax = 0.0;
+        return;
+    }
+
+    dMin = std::numeric_limits<double>::max();
+    dMax = -std::numeric_limits<double>::max();
+
+    int iFirstBin = (iFirstCol + m_iBinSize - 1) / m_iBinSize;
+    int iLastBin = iLastCol / m_iBinSize;
+
+    //The range does not cover a complete bin
+    if(iFirstBin >= iLastBin) {
+        for(int j = iFirstCol; j < iLastCol; ++j) {
+            dMin = qMin(dMin, pRowData[j]);
+            dMax = qMax(dMax, pRowData[j]);
+        }
+        return;
+    }
+
+    //Partial bins at the borders
+    for(int j = iFirstCol; j < iFirstBin * m_iBinSize; ++j) {
+        dMin = qMin(dMin, pRowData[j]);
+        dMax = qMax(dMax, pRowData[j]);
+    }
+
+    for(int j = iLastBin * m_iBinSize; j < iLastCol; ++j) {
+        dMin = qMin(dMin, pRowData[j]);
+        dMax = qMax(dMax, pRowData[j]);
+    }
+
+    //Complete bins, climb the levels while the borders are aligned
+    for(int l = 0; l < m_vMin.size() && iFirstBin < iLastBin; ++l) {
+        if(iFirstBin & 1) {
+            dMin = qMin(dMin, double(m_vMin.at(l)(iRow, iFirstBin)));
+            dMax = qMax(dMax, double(m_vMax.at(l)(iRow, iFirstBin)));
+            ++iFirstBin;
+        }
+
+        if(iLastBin & 1) {
+            --iLastBin;
+            dMin = qMin(dMin, double(m_vMin.at(l)(iRow, iLastBin)));
+            dMax = qMax(dMax, double(m_vMax.at(l)(iRow, iLastBin)));
+        }
+
+        iFirstBin /= 2;
+        iLastBin /= 2;
+    }
+}
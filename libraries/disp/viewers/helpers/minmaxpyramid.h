@@ -0,0 +1,208 @@
+//=============================================================================================================
+/**
+* @file     minmaxpyramid.h
+* @author   agent <agent@local>
+* @version  1.0
+* @date     October, 2026
+*
+* @section  LICENSE
+*
+* Copyright (C) 2026, agent. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+*
+* @brief    Declaration of the MinMaxPyramid Class.
+*
+*/
+
+#ifndef MINMAXPYRAMID_H
+#define MINMAXPYRAMID_H
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "../../disp_global.h"
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// Qt INCLUDES
+//=============================================================================================================
+
+#include <QSharedPointer>
+#include <QVector>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// Eigen INCLUDES
+//=============================================================================================================
+
+#include <Eigen/Core>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE NAMESPACE DISPLIB
+//=============================================================================================================
+
+namespace DISPLIB
+{
+
+
+//=============================================================================================================
+/**
+* DECLARE CLASS MinMaxPyramid
+*
+* @brief The MinMaxPyramid class holds decimated minimum and maximum values of row wise stored data.
+*
+* Level 0 holds the minimum and maximum of bins of iBinSize samples, every further level merges two bins of the
+* level below. The minimum and maximum of any sample range are found with O(log n) bin lookups plus at most two
+* partial bins which are scanned in the data itself. The values are stored in single precision, which is plenty
+* for drawing and keeps the pyramid at a fraction of the size of the data.
+*/
+class DISPSHARED_EXPORT MinMaxPyramid
+{
+public:
+    typedef QSharedPointer<MinMaxPyramid> SPtr;              /**< Shared pointer type for MinMaxPyramid. */
+    typedef QSharedPointer<const MinMaxPyramid> ConstSPtr;   /**< Const shared pointer type for MinMaxPyramid. */
+
+    typedef Eigen::Matrix<double,Eigen::Dynamic,Eigen::Dynamic,Eigen::RowMajor> MatrixXdR;
+    typedef Eigen::Matrix<float,Eigen::Dynamic,Eigen::Dynamic,Eigen::RowMajor> MatrixXfR;
+
+    //=========================================================================================================
+    /**
+    * Constructs an empty MinMaxPyramid.
+    *
+    * @param[in] iBinSize   number of samples per bin of the finest level.
+    */
+    explicit MinMaxPyramid(int iBinSize = 8);
+
+    //=========================================================================================================
+    /**
+    * Resizes the pyramid to hold the given data layout. All bins are reset.
+    *
+    * @param[in] iNumRows   number of rows (channels).
+    * @param[in] iNumCols   number of columns (samples).
+    */
+    void resize(int iNumRows, int iNumCols);
+
+    //=========================================================================================================
+    /**
+    * Resizes the pyramid to the size of the data and computes all bins.
+    *
+    * @param[in] matData    the data.
+    */
+    void build(const MatrixXdR& matData);
+
+    //=========================================================================================================
+    /**
+    * Recomputes all bins which cover the given column range of all rows. The range is clipped to the data.
+    *
+    * @param[in] matData    the data, which must have the size the pyramid was set up with.
+    * @param[in] iFirstCol  first column which changed.
+    * @param[in] iNumCols   number of columns which changed.
+    */
+    void update(const MatrixXdR& matData,
+                int iFirstCol,
+                int iNumCols);
+
+    //=========================================================================================================
+    /**
+    * Recomputes all bins which cover the given column range of one row. The range is clipped to the data.
+    *
+    * @param[in] pRowData   pointer to the first sample of the row.
+    * @param[in] iRow       the row index.
+    * @param[in] iFirstCol  first column which changed.
+    * @param[in] iNumCols   number of columns which changed.
+    */
+    void updateRow(const double* pRowData,
+                   int iRow,
+                   int iFirstCol,
+                   int iNumCols);
+
+    //=========================================================================================================
+    /**
+    * Returns the minimum and maximum of a column range of one row. Both are set to zero for an empty range.
+    *
+    * @param[in] pRowData   pointer to the first sample of the row, used for the partial bins at the range borders.
+    * @param[in] iRow       the row index.
+    * @param[in] iFirstCol  first column of the range.
+    * @param[in] iLastCol   column after the last column of the range.
+    * @param[out] dMin      the minimum.
+    * @param[out] dMax      the maximum.
+    */
+    void minMax(const double* pRowData,
+                int iRow,
+                int iFirstCol,
+                int iLastCol,
+                double& dMin,
+                double& dMax) const;
+
+    //=========================================================================================================
+    /**
+    * Returns the number of rows.
+    *
+    * @return the number of rows.
+    */
+    inline int rows() const;
+
+    //=========================================================================================================
+    /**
+    * Returns the number of columns.
+    *
+    * @return the number of columns.
+    */
+    inline int cols() const;
+
+private:
+    int                     m_iBinSize;     /**< Number of samples per bin of level 0. */
+    int                     m_iNumRows;     /**< Number of rows. */
+    int                     m_iNumCols;     /**< Number of columns. */
+
+    QVector<MatrixXfR>      m_vMin;         /**< The minima of all levels (rows x bins). */
+    QVector<MatrixXfR>      m_vMax;         /**< The maxima of all levels (rows x bins). */
+};
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INLINE DEFINITIONS
+//=============================================================================================================
+
+inline int MinMaxPyramid::rows() const
+{
+    return m_iNumRows;
+}
+
+
+//*************************************************************************************************************
+
+inline int MinMaxPyramid::cols() const
+{
+    return m_iNumCols;
+}
+
+} // NAMESPACE DISPLIB
+
+#endif // MINMAXPYRAMID_H
@@ -115,6 +115,7 @@ SOURCES += \
     engine/model/workers/rtSensorData/rtsensorinterpolationmatworker.cpp \
     engine/model/3dhelpers/renderable3Dentity.cpp \
     engine/model/3dhelpers/custommesh.cpp \
+    engine/model/3dhelpers/colormaplut.cpp \
     engine/model/materials/pervertexphongalphamaterial.cpp \
     engine/model/materials/pervertextessphongalphamaterial.cpp \
     engine/model/materials/shownormalsmaterial.cpp \
@@ -169,6 +170,7 @@ HEADERS += \
     engine/model/workers/rtSensorData/rtsensorinterpolationmatworker.h \
     engine/model/3dhelpers/renderable3Dentity.h \
     engine/model/3dhelpers/custommesh.h \
+    engine/model/3dhelpers/colormaplut.h \
     engine/model/items/common/types.h \
     engine/model/materials/pervertexphongalphamaterial.h \
     engine/model/materials/pervertextessphongalphamaterial.h \
@@ -0,0 +1,125 @@
+//=============================================================================================================
+/**
+* @file     colormaplut.cpp
+* @author   agent <agent@local>
+* @version  1.0
+* @date     October, 2026
+*
+* @section  LICENSE
+*
+* Copyright (C) 2026, agent. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+*
+* @brief    ColorMapLut class definition.
+*
+*/
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "colormaplut.h"
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QtGlobal>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// USED NAMESPACES
+//=============================================================================================================
+
+using namespace DISP3DLIB;
+using namespace Eigen;
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE MEMBER METHODS
+//=============================================================================================================
+
+ColorMapLut::ColorMapLut(int iSize)
+: m_iSize(qMax(2, iSize))
+, m_fScale(0.0f)
+{
+}
+
+
+//*************************************************************************************************************
+
+void ColorMapLut::setColormap(const QString& sColormapType,
+                              QRgb (*functionHandlerColorMap)(double v, const QString& sColorMap))
+{
+    if(!m_vecLut.isEmpty() && sColormapType == m_sColormapType) {
+        return;
+    }
+
+    m_vecLut.resize(m_iSize);
+    m_fScale = static_cast<float>(m_iSize - 1);
+
+    for(int i = 0; i < m_iSize; ++i) {
+        QRgb qRgb = functionHandlerColorMap(double(i) / double(m_iSize - 1), sColormapType);
+        m_vecLut[i] = packRgba(qRed(qRgb), qGreen(qRgb), qBlue(qRgb), 255);
+    }
+
+    m_sColormapType = sColormapType;
+}
+
+
+//*************************************************************************************************************
+
+const QString& ColorMapLut::colormapType() const
+{
+    return m_sColormapType;
+}
+
+
+//*************************************************************************************************************
+
+QByteArray ColorMapLut::toRgba8(const MatrixX4f& matColors,
+                                int iAlpha)
+{
+    QByteArray arrayColors;
+    arrayColors.resize(matColors.rows() * 4);
+    uchar *rawColorArray = reinterpret_cast<uchar *>(arrayColors.data());
+
+    int idxColor = 0;
+
+    for(int i = 0; i < matColors.rows(); ++i) {
+        for(int c = 0; c < 3; ++c) {
+            rawColorArray[idxColor++] = static_cast<uchar>(qBound(0.0f, matColors(i,c), 1.0f) * 255.0f + 0.5f);
+        }
+
+        if(iAlpha < 0) {
+            rawColorArray[idxColor++] = static_cast<uchar>(qBound(0.0f, matColors(i,3), 1.0f) * 255.0f + 0.5f);
+        } else {
+            rawColorArray[idxColor++] = static_cast<uchar>(qMin(iAlpha, 255));
+        }
+    }
+
+    return arrayColors;
+}
@@ -0,0 +1,211 @@
+//=============================================================================================================
+/**
+* @file     colormaplut.h
+* @author   agent <agent@local>
+* @version  1.0
+* @date     October, 2026
+*
+* @section  LICENSE
+*
+* Copyright (C) 2026, agent. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+*
+* @brief    ColorMapLut class declaration.
+*
+*/
+
+#ifndef DISP3DLIB_COLORMAPLUT_H
+#define DISP3DLIB_COLORMAPLUT_H
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "../../../disp3D_global.h"
+
+#include <disp/plots/helpers/colormap.h>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QByteArray>
+#include <QRgb>
+#include <QSharedPointer>
+#include <QString>
+#include <QVector>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// Eigen INCLUDES
+//=============================================================================================================
+
+#include <Eigen/Core>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// STL INCLUDES
+//=============================================================================================================
+
+#include <cstring>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE NAMESPACE DISP3DLIB
+//=============================================================================================================
+
+namespace DISP3DLIB
+{
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DISP3DLIB FORWARD DECLARATIONS
+//=============================================================================================================
+
+
+//=============================================================================================================
+/**
+* Holds a colormap sampled at a fixed number of values in [0,1] as packed RGBA8 colors, so that the real-time
+* workers can color each vertex with a table lookup instead of evaluating the colormap function. RGBA8 buffers
+* store the four bytes of each vertex in R, G, B, A memory order, as uploaded to the color attribute of CustomMesh.
+*
+* @brief Quantized colormap lookup table producing RGBA8 vertex colors.
+*/
+class DISP3DSHARED_EXPORT ColorMapLut
+{
+
+public:
+    typedef QSharedPointer<ColorMapLut> SPtr;             /**< Shared pointer type for ColorMapLut. */
+    typedef QSharedPointer<const ColorMapLut> ConstSPtr;  /**< Const shared pointer type for ColorMapLut. */
+
+    //=========================================================================================================
+    /**
+    * Default constructor.
+    *
+    * @param[in] iSize      The number of table entries.
+    */
+    explicit ColorMapLut(int iSize = 1024);
+
+    //=========================================================================================================
+    /**
+    * Samples a new colormap into the table. Does nothing if the colormap did not change.
+    *
+    * @param[in] sColormapType              The colormap name as understood by the colormap function.
+    * @param[in] functionHandlerColorMap    The function which converts scalar values in [0,1] to rgb.
+    */
+    void setColormap(const QString& sColormapType,
+                     QRgb (*functionHandlerColorMap)(double v, const QString& sColorMap) = DISPLIB::ColorMap::valueToColor);
+
+    //=========================================================================================================
+    /**
+    * Returns the name of the sampled colormap.
+    *
+    * @return The colormap name.
+    */
+    const QString& colormapType() const;
+
+    //=========================================================================================================
+    /**
+    * Returns the opaque color of a value. Values outside [0,1] are clamped.
+    *
+    * @param[in] fValue     The normalized value.
+    *
+    * @return The packed RGBA8 color.
+    */
+    inline quint32 rgba(float fValue) const;
+
+    //=========================================================================================================
+    /**
+    * Packs a color so that its bytes are in R, G, B, A memory order.
+    *
+    * @param[in] r      Red.
+    * @param[in] g      Green.
+    * @param[in] b      Blue.
+    * @param[in] a      Alpha.
+    *
+    * @return The packed RGBA8 color.
+    */
+    static inline quint32 packRgba(uchar r, uchar g, uchar b, uchar a);
+
+    //=========================================================================================================
+    /**
+    * Converts float vertex colors to a RGBA8 buffer.
+    *
+    * @param[in] matColors  The vertex colors with components in [0,1].
+    * @param[in] iAlpha     Alpha for all vertices in [0,255], -1 to take it from matColors.
+    *
+    * @return The RGBA8 buffer with four bytes per vertex.
+    */
+    static QByteArray toRgba8(const Eigen::MatrixX4f& matColors,
+                              int iAlpha = -1);
+
+private:
+    QVector<quint32>    m_vecLut;               /**< The packed opaque colors. */
+    QString             m_sColormapType;        /**< The sampled colormap. */
+    int                 m_iSize;                /**< The number of table entries. */
+    float               m_fScale;               /**< Scales a value in [0,1] to a table index. */
+};
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INLINE DEFINITIONS
+//=============================================================================================================
+
+inline quint32 ColorMapLut::rgba(float fValue) const
+{
+    if(m_vecLut.isEmpty()) {
+        return packRgba(0, 0, 0, 255);
+    }
+
+    int iIdx = static_cast<int>(fValue * m_fScale + 0.5f);
+
+    if(iIdx < 0) {
+        iIdx = 0;
+    } else if(iIdx >= m_vecLut.size()) {
+        iIdx = m_vecLut.size() - 1;
+    }
+
+    return m_vecLut.at(iIdx);
+}
+
+
+//*************************************************************************************************************
+
+inline quint32 ColorMapLut::packRgba(uchar r, uchar g, uchar b, uchar a)
+{
+    const uchar rgba[4] = {r, g, b, a};
+    quint32 iPacked;
+    memcpy(&iPacked, rgba, sizeof(iPacked));
+
+    return iPacked;
+}
+
+} // NAMESPACE DISP3DLIB
+
+#endif // DISP3DLIB_COLORMAPLUT_H
@@ -39,6 +39,7 @@
 //=============================================================================================================
 
 #include "custommesh.h"
+#include "colormaplut.h"
 
 
 //*************************************************************************************************************
@@ -141,10 +142,10 @@ void CustomMesh::init()
 
     m_pColorAttribute = new Qt3DRender::QAttribute();
     m_pColorAttribute->setAttributeType(Qt3DRender::QAttribute::VertexAttribute);
-    m_pColorAttribute->setDataType(Qt3DRender::QAttribute::Float);
+    m_pColorAttribute->setDataType(Qt3DRender::QAttribute::UnsignedByte);
     m_pColorAttribute->setDataSize(4);
     m_pColorAttribute->setByteOffset(0);
-    m_pColorAttribute->setByteStride(4 * sizeof(float));
+    m_pColorAttribute->setByteStride(4 * sizeof(uchar));
     m_pColorAttribute->setName(Qt3DRender::QAttribute::defaultColorAttributeName());
     m_pColorAttribute->setBuffer(m_pColorDataBuffer);
 
@@ -175,24 +176,57 @@ CustomMesh::~CustomMesh()
 
 void CustomMesh::setColor(const Eigen::MatrixX4f& tMatColors)
 {
-    QByteArray colorBufferData;
-    colorBufferData.resize(tMatColors.rows() * 4 * (int)sizeof(float));
-    float *rawColorArray = reinterpret_cast<float *>(colorBufferData.data());
+    //Colors are uploaded as normalized unsigned bytes
+    setColor(ColorMapLut::toRgba8(tMatColors));
+}
+
+
+//*************************************************************************************************************
+
+void CustomMesh::setColor(const QByteArray& arrayColorsRgba8)
+{
+    int iNumVert = arrayColorsRgba8.size() / 4;
+
+    if(arrayColorsRgba8.size() != m_arrayColors.size()) {
+        //Update color
+        m_pColorDataBuffer->setData(arrayColorsRgba8);
+
+        //m_pColorAttribute->setBuffer(m_pColorDataBuffer);
+        m_pColorAttribute->setCount(iNumVert);
 
-    int idxColor = 0;
+        m_arrayColors = arrayColorsRgba8;
+        return;
+    }
+
+    //Find the range of vertices whose colors changed
+    const quint32 *pNewColors = reinterpret_cast<const quint32 *>(arrayColorsRgba8.constData());
+    const quint32 *pOldColors = reinterpret_cast<const quint32 *>(m_arrayColors.constData());
+
+    int iFirst = 0;
+    while(iFirst < iNumVert && pNewColors[iFirst] == pOldColors[iFirst]) {
+        ++iFirst;
+    }
 
-    for(int i = 0; i < tMatColors.rows(); ++i) {
-        rawColorArray[idxColor++] = tMatColors(i,0);
-        rawColorArray[idxColor++] = tMatColors(i,1);
-        rawColorArray[idxColor++] = tMatColors(i,2);
-        rawColorArray[idxColor++] = tMatColors(i,3);
+    if(iFirst == iNumVert) {
+        m_arrayColors = arrayColorsRgba8;
+        return;
     }
 
-    //Update color
-    m_pColorDataBuffer->setData(colorBufferData);
+    int iLast = iNumVert - 1;
+    while(iLast > iFirst && pNewColors[iLast] == pOldColors[iLast]) {
+        --iLast;
+    }
+
+    //Upload only the changed range, or everything if that is most of the buffer anyway
+    int iNumChanged = iLast - iFirst + 1;
+
+    if(2 * iNumChanged > iNumVert) {
+        m_pColorDataBuffer->setData(arrayColorsRgba8);
+    } else {
+        m_pColorDataBuffer->updateData(4 * iFirst, arrayColorsRgba8.mid(4 * iFirst, 4 * iNumChanged));
+    }
 
-    //m_pColorAttribute->setBuffer(m_pColorDataBuffer);
-    m_pColorAttribute->setCount(tMatColors.rows());
+    m_arrayColors = arrayColorsRgba8;
 }
 
 
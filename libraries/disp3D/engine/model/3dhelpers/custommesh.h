@@ -50,6 +50,7 @@
 //=============================================================================================================
 
 #include <Qt3DRender/QGeometryRenderer>
+#include <QByteArray>
 #include <QPointer>
 
 
@@ -136,6 +137,15 @@ public:
     */
     void setColor(const Eigen::MatrixX4f &tMatColors);
 
+    //=========================================================================================================
+    /**
+    * Set the vertices colors of the mesh from packed RGBA8 values, see ColorMapLut. Only the range of vertices
+    * whose colors differ from the previously set ones is uploaded.
+    *
+    * @param[in] arrayColorsRgba8   New color information for the vertices, four bytes per vertex.
+    */
+    void setColor(const QByteArray &arrayColorsRgba8);
+
     //=========================================================================================================
     /**
     * Set the normals the mesh.
@@ -203,6 +213,8 @@ protected:
     QPointer<Qt3DRender::QAttribute>    m_pNormalAttribute;        /**< The normal attribute. */
     QPointer<Qt3DRender::QAttribute>    m_pColorAttribute;         /**< The color attribute. */
 
+    QByteArray                          m_arrayColors;              /**< The RGBA8 colors currently in the color buffer. */
+
     int                                 m_iNumVert;                 /**< The total number of set vertices. */
 };
 
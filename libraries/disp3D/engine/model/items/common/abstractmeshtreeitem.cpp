@@ -103,6 +103,16 @@ void AbstractMeshTreeItem::setVertColor(const MatrixX4f& vertColor)
 }
 
 
+//*************************************************************************************************************
+
+void AbstractMeshTreeItem::setVertColorRgba8(const QByteArray& arrayVertColor)
+{
+    if(m_pCustomMesh) {
+        m_pCustomMesh->setColor(arrayVertColor);
+    }
+}
+
+
 //*************************************************************************************************************
 
 void AbstractMeshTreeItem::initItem()
@@ -53,6 +53,7 @@
 
 #include <Qt3DRender/QGeometryRenderer>
 #include <QPointer>
+#include <QByteArray>
 
 
 //*************************************************************************************************************
@@ -161,6 +162,15 @@ public:
     */
     virtual void setVertColor(const Eigen::MatrixX4f &vertColor);
 
+    //=========================================================================================================
+    /**
+    * Set new vertices colors to the mesh from packed RGBA8 values, see ColorMapLut. The colors are passed
+    * directly to the mesh and not stored as item data, which makes this the preferred call for streamed colors.
+    *
+    * @param[in] arrayVertColor  New colors, four bytes per vertex.
+    */
+    virtual void setVertColorRgba8(const QByteArray &arrayVertColor);
+
 protected:
     //=========================================================================================================
     /**
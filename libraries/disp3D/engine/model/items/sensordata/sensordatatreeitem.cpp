@@ -617,11 +617,11 @@ void SensorDataTreeItem::onNewRtRawDataAvailable(const VectorXd &vecDataVector)
 
 //*************************************************************************************************************
 
-void SensorDataTreeItem::onNewRtSmoothedDataAvailable(const MatrixX4f &matColorMatrix)
+void SensorDataTreeItem::onNewRtSmoothedDataAvailable(const QByteArray &arrayColors)
 {
     if(m_pInterpolationItemCPU)
     {
-        m_pInterpolationItemCPU->setVertColor(matColorMatrix);
+        m_pInterpolationItemCPU->setVertColorRgba8(arrayColors);
     }
 }
 
@@ -49,6 +49,7 @@
 //=============================================================================================================
 
 #include <QPointer>
+#include <QByteArray>
 
 
 //*************************************************************************************************************
@@ -303,9 +304,9 @@ protected:
     /**
     * This function gets called whenever this item receives new color values for each estimated source.
     *
-    * @param[in] sourceColorSamples         The color values for the streamed data.
+    * @param[in] arrayColors         The RGBA8 color values for the streamed data.
     */
-    virtual void onNewRtSmoothedDataAvailable(const Eigen::MatrixX4f &matColorMatrix);
+    virtual void onNewRtSmoothedDataAvailable(const QByteArray &arrayColors);
 
     //=========================================================================================================
     /**
@@ -727,15 +727,15 @@ void MneDataTreeItem::onCheckStateWorkerChanged(const Qt::CheckState& checkState
 
 //*************************************************************************************************************
 
-void MneDataTreeItem::onNewRtSmoothedDataAvailable(const Eigen::MatrixX4f &matColorMatrixLeftHemi,
-                                                   const Eigen::MatrixX4f &matColorMatrixRightHemi)
+void MneDataTreeItem::onNewRtSmoothedDataAvailable(const QByteArray &arrayColorsLeftHemi,
+                                                   const QByteArray &arrayColorsRightHemi)
 {
     if(m_pInterpolationItemLeftCPU) {
-        m_pInterpolationItemLeftCPU->setVertColor(matColorMatrixLeftHemi);
+        m_pInterpolationItemLeftCPU->setVertColorRgba8(arrayColorsLeftHemi);
     }
 
     if(m_pInterpolationItemRightCPU) {
-        m_pInterpolationItemRightCPU->setVertColor(matColorMatrixRightHemi);
+        m_pInterpolationItemRightCPU->setVertColorRgba8(arrayColorsRightHemi);
     }
 }
 
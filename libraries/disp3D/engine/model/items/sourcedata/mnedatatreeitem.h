@@ -53,6 +53,7 @@
 //=============================================================================================================
 
 #include <QPointer>
+#include <QByteArray>
 #include <Qt3DCore/QTransform>
 
 
@@ -332,11 +333,11 @@ protected:
     /**
     * This function gets called whenever this item receives new color values for each estimated source.
     *
-    * @param[in] matColorMatrixLeftHemi          The new streamed interpolated raw data in form of RGB colors per vertex for the left hemisphere.
-    * @param[in] matColorMatrixRightHemi         The new streamed interpolated raw data in form of RGB colors per vertex for the right hemisphere.
+    * @param[in] arrayColorsLeftHemi          The new streamed interpolated raw data in form of RGBA8 colors per vertex for the left hemisphere.
+    * @param[in] arrayColorsRightHemi         The new streamed interpolated raw data in form of RGBA8 colors per vertex for the right hemisphere.
     */
-    void onNewRtSmoothedDataAvailable(const Eigen::MatrixX4f &matColorMatrixLeftHemi,
-                                      const Eigen::MatrixX4f &matColorMatrixRightHemi);
+    void onNewRtSmoothedDataAvailable(const QByteArray &arrayColorsLeftHemi,
+                                      const QByteArray &arrayColorsRightHemi);
 
     //=========================================================================================================
     /**
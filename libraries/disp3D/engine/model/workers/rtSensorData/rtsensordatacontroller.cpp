@@ -291,9 +291,9 @@ void RtSensorDataController::onNewRtRawData(const VectorXd &vecDataVector)
 
 //*************************************************************************************************************
 
-void RtSensorDataController::onNewSmoothedRtRawData(const MatrixX4f &matColorMatrix)
+void RtSensorDataController::onNewSmoothedRtRawData(const QByteArray &arrayColors)
 {
-    emit newRtSmoothedDataAvailable(matColorMatrix);
+    emit newRtSmoothedDataAvailable(arrayColors);
 }
 
 
@@ -53,6 +53,7 @@
 #include <QTimer>
 #include <QPointer>
 #include <QThread>
+#include <QByteArray>
 
 
 //*************************************************************************************************************
@@ -249,9 +250,9 @@ protected:
     /**
     * Call this function whenever new interpolated raw data is available to be dispatched.
     *
-    * @param[in] matColorMatrix         The new interpolated data as RGB colors per vertex.
+    * @param[in] arrayColors         The new interpolated data as RGBA8 colors per vertex.
     */
-    void onNewSmoothedRtRawData(const Eigen::MatrixX4f &matColorMatrix);
+    void onNewSmoothedRtRawData(const QByteArray &arrayColors);
 
     //=========================================================================================================
     /**
@@ -403,9 +404,9 @@ signals:
     /**
     * Emit this signal whenever a new interpolated raw data is streamed.
     *
-    * @param[in] matColorMatrix          The new streamed interpolated raw data in form of RGB colors per vertex.
+    * @param[in] arrayColors          The new streamed interpolated raw data in form of RGBA8 colors per vertex.
     */
-    void newRtSmoothedDataAvailable(const Eigen::MatrixX4f &matColorMatrix);
+    void newRtSmoothedDataAvailable(const QByteArray &arrayColors);
 };
 
 } // NAMESPACE
@@ -73,6 +73,14 @@ using namespace DISPLIB;
 using namespace FIFFLIB;
 
 
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINES
+//=============================================================================================================
+
+#define MAX_INTERPOLATED_BLOCK_VALUES 16777216 //Upper bound for the number of precomputed interpolated values (64MB)
+
+
 //*************************************************************************************************************
 //=============================================================================================================
 // DEFINE MEMBER METHODS
@@ -85,6 +93,8 @@ RtSensorDataWorker::RtSensorDataWorker()
 , m_bStreamSmoothedData(true)
 , m_iCurrentSample(0)
 , m_pMatInterpolationMatrix(QSharedPointer<SparseMatrix<float> >(new SparseMatrix<float>()))
+, m_iInterpolatedBlockColumn(0)
+, m_bInterpolatedBlockDirty(true)
 {
 }
 
@@ -109,6 +119,7 @@ void RtSensorDataWorker::addData(const MatrixXd& data)
     }
 
     m_lDataLoopQ = m_lDataQ;
+    m_bInterpolatedBlockDirty = true;
 }
 
 
@@ -118,7 +129,7 @@ void RtSensorDataWorker::setNumberVertices(int iNumberVerts)
 {
 //    m_lVisualizationInfo.matOriginalVertColor.resize(iNumberVerts,3);
 //    m_lVisualizationInfo.matOriginalVertColor.setZero();
-    m_lVisualizationInfo.matOriginalVertColor = AbstractMeshTreeItem::createVertColor(iNumberVerts);
+    m_lVisualizationInfo.arrayOriginalVertColor = ColorMapLut::toRgba8(AbstractMeshTreeItem::createVertColor(iNumberVerts));
 }
 
 
@@ -127,6 +138,7 @@ void RtSensorDataWorker::setNumberVertices(int iNumberVerts)
 void RtSensorDataWorker::setNumberAverages(int iNumAvr)
 {
     m_iAverageSamples = iNumAvr;
+    m_bInterpolatedBlockDirty = true;
 }
 
 
@@ -135,6 +147,7 @@ void RtSensorDataWorker::setNumberAverages(int iNumAvr)
 void RtSensorDataWorker::setStreamSmoothedData(bool bStreamSmoothedData)
 {
     m_bStreamSmoothedData = bStreamSmoothedData;
+    m_bInterpolatedBlockDirty = true;
 }
 
 
@@ -161,6 +174,7 @@ void RtSensorDataWorker::setThresholds(const QVector3D& vecThresholds)
 void RtSensorDataWorker::setLoopState(bool bLoopState)
 {
     m_bIsLooping = bLoopState;
+    m_bInterpolatedBlockDirty = true;
 }
 
 
@@ -176,6 +190,8 @@ void RtSensorDataWorker::setSFreq(const double dSFreq)
 
 void RtSensorDataWorker::setInterpolationMatrix(QSharedPointer<SparseMatrix<float> > pMatInterpolationMatrix) {
     m_pMatInterpolationMatrix = pMatInterpolationMatrix;
+    m_matInterpolationMatrixCsr = *pMatInterpolationMatrix;
+    m_bInterpolatedBlockDirty = true;
 }
 
 
@@ -188,50 +204,22 @@ void RtSensorDataWorker::streamData()
 //    timer.start();
 
     if(m_iAverageSamples != 0 && !m_lDataLoopQ.isEmpty()) {
-        int iSampleCtr = 0;
-
-        //Perform the actual interpolation and send signal
-        while((iSampleCtr <= m_iAverageSamples)) {
-            if(m_lDataQ.isEmpty()) {
-                if(m_bIsLooping && !m_lDataLoopQ.isEmpty()) {
-                    if(m_vecAverage.rows() != m_lDataLoopQ.front().rows()) {
-                        m_vecAverage = m_lDataLoopQ.front();
-                        m_iCurrentSample++;
-                        iSampleCtr++;
-                    } else if (m_iCurrentSample < m_lDataLoopQ.size()){
-                        m_vecAverage += m_lDataLoopQ.at(m_iCurrentSample);
-                        m_iCurrentSample++;
-                        iSampleCtr++;
-                    }
-
-                    //Set iterator back to the front if needed
-                    if(m_iCurrentSample >= m_lDataLoopQ.size()) {
-                        m_iCurrentSample = 0;
-                        break;
-                    }
-                } else {
+        if(m_bStreamSmoothedData && m_bIsLooping && m_lDataQ.isEmpty()) {
+            //Loop playback: stream the precomputed frames and interpolate the next ones in one go when they run out
+            if(m_bInterpolatedBlockDirty || m_iInterpolatedBlockColumn >= m_matInterpolatedBlock.cols()) {
+                if(!interpolateNextBlock()) {
                     return;
                 }
-            } else {
-                if(m_vecAverage.rows() != m_lDataQ.front().rows()) {
-                    m_vecAverage = m_lDataQ.takeFirst();
-                    m_iCurrentSample++;
-                    iSampleCtr++;
-                } else {
-                    m_vecAverage += m_lDataQ.takeFirst();
-                    m_iCurrentSample++;
-                    iSampleCtr++;
-                }
-
-                //Set iterator back to the front if needed
-                if(m_iCurrentSample >= m_lDataQ.size()) {
-                    m_iCurrentSample = 0;
-                    break;
-                }
             }
+
+            emit newRtSmoothedData(generateColorsFromInterpolatedValues(m_matInterpolatedBlock.col(m_iInterpolatedBlockColumn++)));
+            return;
+        }
+
+        if(!computeNextAverage()) {
+            return;
         }
 
-        m_vecAverage /= (double)m_iAverageSamples;
         if(m_bStreamSmoothedData) {
             emit newRtSmoothedData(generateColorsFromSensorValues(m_vecAverage));
         } else {
@@ -251,85 +239,181 @@ void RtSensorDataWorker::streamData()
 
 //*************************************************************************************************************
 
-MatrixX4f RtSensorDataWorker::generateColorsFromSensorValues(const VectorXd& vecSensorValues)
+bool RtSensorDataWorker::computeNextAverage()
+{
+    int iSampleCtr = 0;
+
+    //Sum up the samples of the next frame
+    while((iSampleCtr <= m_iAverageSamples)) {
+        if(m_lDataQ.isEmpty()) {
+            if(m_bIsLooping && !m_lDataLoopQ.isEmpty()) {
+                if(m_vecAverage.rows() != m_lDataLoopQ.front().rows()) {
+                    m_vecAverage = m_lDataLoopQ.front();
+                    m_iCurrentSample++;
+                    iSampleCtr++;
+                } else if (m_iCurrentSample < m_lDataLoopQ.size()){
+                    m_vecAverage += m_lDataLoopQ.at(m_iCurrentSample);
+                    m_iCurrentSample++;
+                    iSampleCtr++;
+                }
+
+                //Set iterator back to the front if needed
+                if(m_iCurrentSample >= m_lDataLoopQ.size()) {
+                    m_iCurrentSample = 0;
+                    break;
+                }
+            } else {
+                return false;
+            }
+        } else {
+            if(m_vecAverage.rows() != m_lDataQ.front().rows()) {
+                m_vecAverage = m_lDataQ.takeFirst();
+                m_iCurrentSample++;
+                iSampleCtr++;
+            } else {
+                m_vecAverage += m_lDataQ.takeFirst();
+                m_iCurrentSample++;
+                iSampleCtr++;
+            }
+
+            //Set iterator back to the front if needed
+            if(m_iCurrentSample >= m_lDataQ.size()) {
+                m_iCurrentSample = 0;
+                break;
+            }
+        }
+    }
+
+    m_vecAverage /= (double)m_iAverageSamples;
+
+    return true;
+}
+
+
+//*************************************************************************************************************
+
+bool RtSensorDataWorker::interpolateNextBlock()
+{
+    if(m_lDataLoopQ.front().rows() != m_matInterpolationMatrixCsr.cols()) {
+        qDebug() << "RtSensorDataWorker::interpolateNextBlock - Number of sensors (" << m_lDataLoopQ.front().rows() << ") do not match with previously set number of sensors (" << m_matInterpolationMatrixCsr.cols() << "). Returning...";
+        return false;
+    }
+
+    //Precompute one loop pass if it fits, but bound the memory for dense surfaces
+    int iNumFrames = (m_lDataLoopQ.size() + m_iAverageSamples - 1) / m_iAverageSamples;
+    iNumFrames = qBound(1, iNumFrames, MAX_INTERPOLATED_BLOCK_VALUES / qMax(1, int(m_matInterpolationMatrixCsr.rows())));
+
+    MatrixXf matAverages(m_matInterpolationMatrixCsr.cols(), iNumFrames);
+
+    for(int i = 0; i < iNumFrames; ++i) {
+        computeNextAverage();
+        matAverages.col(i) = m_vecAverage.cast<float>();
+        m_vecAverage.setZero(m_vecAverage.rows());
+    }
+
+    m_matInterpolatedBlock = Interpolation::interpolateSignals(m_matInterpolationMatrixCsr, matAverages);
+    m_iInterpolatedBlockColumn = 0;
+    m_bInterpolatedBlockDirty = false;
+
+    return true;
+}
+
+
+//*************************************************************************************************************
+
+const QByteArray& RtSensorDataWorker::generateColorsFromSensorValues(const VectorXd& vecSensorValues)
 {
     if(vecSensorValues.rows() != m_pMatInterpolationMatrix->cols()) {
         qDebug() << "RtSensorDataWorker::generateColorsFromSensorValues - Number of new vertex colors (" << vecSensorValues.rows() << ") do not match with previously set number of sensors (" << m_pMatInterpolationMatrix->cols() << "). Returning...";
-        MatrixX4f matColor = m_lVisualizationInfo.matOriginalVertColor;
-        return matColor;
+        return m_lVisualizationInfo.arrayOriginalVertColor;
     }
 
     // interpolate sensor signals
     VectorXf vecIntrpltdVals = Interpolation::interpolateSignal(*m_pMatInterpolationMatrix, vecSensorValues.cast<float>());
 
-    // Reset to original color as default
-    m_lVisualizationInfo.matFinalVertColor = m_lVisualizationInfo.matOriginalVertColor;
+    return generateColorsFromInterpolatedValues(vecIntrpltdVals);
+}
+
+
+//*************************************************************************************************************
+
+const QByteArray& RtSensorDataWorker::generateColorsFromInterpolatedValues(const VectorXf& vecIntrpltdVals)
+{
+    // Sample the colormap if it changed since the last frame
+    m_lVisualizationInfo.colorMapLut.setColormap(m_lVisualizationInfo.sColormapType,
+                                                 m_lVisualizationInfo.functionHandlerColorMap);
+
+    // Write into the buffer of the frame before the last one. Its receivers are done with it by now, so it is
+    // usually not shared anymore and can be overwritten without a new allocation.
+    qSwap(m_lVisualizationInfo.arrayFinalVertColor, m_lVisualizationInfo.arrayPreviousVertColor);
 
     //Generate color data for vertices
     normalizeAndTransformToColor(vecIntrpltdVals,
-                                 m_lVisualizationInfo.matFinalVertColor,
+                                 m_lVisualizationInfo.arrayOriginalVertColor,
+                                 m_lVisualizationInfo.arrayFinalVertColor,
                                  m_lVisualizationInfo.dThresholdX,
                                  m_lVisualizationInfo.dThresholdZ,
-                                 m_lVisualizationInfo.functionHandlerColorMap,
-                                 m_lVisualizationInfo.sColormapType);
+                                 m_lVisualizationInfo.colorMapLut);
 
-    return m_lVisualizationInfo.matFinalVertColor;
+    return m_lVisualizationInfo.arrayFinalVertColor;
 }
 
 
 //*************************************************************************************************************
 
 void RtSensorDataWorker::normalizeAndTransformToColor(const VectorXf& vecData,
-                                                      MatrixX4f& matFinalVertColor,
+                                                      const QByteArray& arrayOriginalVertColor,
+                                                      QByteArray& arrayFinalVertColor,
                                                       double dThresholdX,
                                                       double dThreholdZ,
-                                                      QRgb (*functionHandlerColorMap)(double v, const QString& sColorMap),
-                                                      const QString& sColorMap)
+                                                      const ColorMapLut& colorMapLut)
 {
     //Note: This function needs to be implemented extremly efficient.
-    if(vecData.rows() != matFinalVertColor.rows()) {
-        qDebug() << "RtSensorDataWorker::normalizeAndTransformToColor - Sizes of input data (" << vecData.rows() <<") do not match output data ("<< matFinalVertColor.rows() <<"). Returning ...";
+    if(vecData.rows() * 4 != arrayOriginalVertColor.size()) {
+        qDebug() << "RtSensorDataWorker::normalizeAndTransformToColor - Sizes of input data (" << vecData.rows() <<") do not match output data ("<< arrayOriginalVertColor.size() / 4 <<"). Returning ...";
+        arrayFinalVertColor = arrayOriginalVertColor;
         return;
     }
 
+    if(arrayFinalVertColor.size() != arrayOriginalVertColor.size()) {
+        arrayFinalVertColor.resize(arrayOriginalVertColor.size());
+    }
+
+    const quint32* pOriginalVertColor = reinterpret_cast<const quint32*>(arrayOriginalVertColor.constData());
+    quint32* pFinalVertColor = reinterpret_cast<quint32*>(arrayFinalVertColor.data());
+
+    const float fThresholdX = static_cast<float>(dThresholdX);
+    const float fThreholdZ = static_cast<float>(dThreholdZ);
+    const float fTresholdDiff = fThreholdZ - fThresholdX;
     float fSample;
-    QRgb qRgb;
-    const double dTresholdDiff = dThreholdZ - dThresholdX;
 
     for(int r = 0; r < vecData.rows(); ++r) {
         //Take the absolute values because the histogram threshold is also calcualted using the absolute values
         fSample = std::fabs(vecData(r));
 
-        if(fSample >= dThresholdX) {
-            matFinalVertColor(r,3) = 1.0f;
-
+        if(fSample >= fThresholdX) {
             //Check lower and upper thresholds and normalize to one
-            if(fSample >= dThreholdZ) {
+            if(fSample >= fThreholdZ) {
                 if(vecData(r) < 0) {
-                    fSample = 0.0;
+                    fSample = 0.0f;
                 } else {
-                    fSample = 1.0;
+                    fSample = 1.0f;
                 }
-                //fSample = 1.0f;
             } else {
-                if(fSample != 0.0f && dTresholdDiff != 0.0 ) {
+                if(fSample != 0.0f && fTresholdDiff != 0.0f) {
                     if(vecData(r) < 0) {
-                        fSample = 0.5 - (fSample - dThresholdX) / (dTresholdDiff * 2);
+                        fSample = 0.5f - (fSample - fThresholdX) / (fTresholdDiff * 2.0f);
                     } else {
-                        fSample = 0.5 + (fSample - dThresholdX) / (dTresholdDiff * 2);
+                        fSample = 0.5f + (fSample - fThresholdX) / (fTresholdDiff * 2.0f);
                     }
                 } else {
                     fSample = 0.0f;
                 }
             }
 
-            qRgb = functionHandlerColorMap(fSample, sColorMap);
-
-            matFinalVertColor(r,0) = (float)qRed(qRgb)/255.0f;
-            matFinalVertColor(r,1) = (float)qGreen(qRgb)/255.0f;
-            matFinalVertColor(r,2) = (float)qBlue(qRgb)/255.0f;
+            pFinalVertColor[r] = colorMapLut.rgba(fSample);
         } else {
-            //matFinalVertColor(r,3) = 0.0f;
+            pFinalVertColor[r] = pOriginalVertColor[r];
         }
     }
 }
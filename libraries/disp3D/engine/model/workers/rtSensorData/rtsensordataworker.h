@@ -44,6 +44,7 @@
 //=============================================================================================================
 
 #include "../../../../disp3D_global.h"
+#include "../../3dhelpers/colormaplut.h"
 
 #include <disp/plots/helpers/colormap.h>
 
@@ -54,6 +55,7 @@
 //=============================================================================================================
 
 #include <QRgb>
+#include <QByteArray>
 #include <QSharedPointer>
 #include <QLinkedList>
 
@@ -194,22 +196,22 @@ public:
 protected:
     //=========================================================================================================
     /**
-    * @brief normalizeAndTransformToColor  This method normalizes final values for all vertices of the mesh and converts them to rgb using the specified color converter
+    * @brief normalizeAndTransformToColor  This method normalizes final values for all vertices of the mesh and converts them to RGBA8 using the colormap lookup table
     *
     * @param[in] vecData                       The final values for each vertex of the surface
-    * @param[in,out] matFinalVertColor         The color matrix which the results are to be written to
+    * @param[in] arrayOriginalVertColor        The RGBA8 colors used for vertices below the lower threshold
+    * @param[in,out] arrayFinalVertColor       The RGBA8 buffer which the results are to be written to
     * @param[in] dThresholdX                   Lower threshold for normalizing
     * @param[in] dThreholdZ                    Upper threshold for normalizing
-    * @param[in] functionHandlerColorMap       The pointer to the function which converts scalar values to rgb
-    * @param[in] sColorMap                     The color map to us
+    * @param[in] colorMapLut                   The sampled colormap
     *
     */
     void normalizeAndTransformToColor(const Eigen::VectorXf& vecData,
-                                      Eigen::MatrixX4f &matFinalVertColor,
+                                      const QByteArray& arrayOriginalVertColor,
+                                      QByteArray& arrayFinalVertColor,
                                       double dThresholdX,
                                       double dThreholdZ,
-                                      QRgb (*functionHandlerColorMap)(double v, const QString& sColorMap),
-                                      const QString& sColorMap);
+                                      const ColorMapLut& colorMapLut);
 
     //=========================================================================================================
     /**
@@ -217,15 +219,46 @@ protected:
     *
     * @param[in] vecSensorValues                   A vector of sensor signals
     *
-    * @return The final color values for the underlying mesh surface
+    * @return The final RGBA8 color values for the underlying mesh surface
     */
-    Eigen::MatrixX4f generateColorsFromSensorValues(const Eigen::VectorXd& vecSensorValues);
+    const QByteArray& generateColorsFromSensorValues(const Eigen::VectorXd& vecSensorValues);
+
+    //=========================================================================================================
+    /**
+    * @brief generateColorsFromInterpolatedValues  Produces the final color matrix from already interpolated values
+    *
+    * @param[in] vecIntrpltdVals                   The interpolated value of each vertex
+    *
+    * @return The final RGBA8 color values for the underlying mesh surface
+    */
+    const QByteArray& generateColorsFromInterpolatedValues(const Eigen::VectorXf& vecIntrpltdVals);
+
+    //=========================================================================================================
+    /**
+    * @brief computeNextAverage     Sums up the next samples of the data or loop queue into m_vecAverage
+    *
+    * @return Whether a new average is available
+    */
+    bool computeNextAverage();
+
+    //=========================================================================================================
+    /**
+    * @brief interpolateNextBlock   Averages the next frames of the loop queue and interpolates all of them with one
+    *                               sparse-dense product. Loop playback is deterministic, so the frames are known in advance.
+    *
+    * @return Whether the block could be interpolated
+    */
+    bool interpolateNextBlock();
 
     QList<Eigen::VectorXd>                              m_lDataQ;                           /**< List that holds the fiff matrix data <n_channels x n_samples>. */
     QList<Eigen::VectorXd>                              m_lDataLoopQ;                       /**< List that holds the matrix data <n_channels x n_samples> for looping. */
 
     Eigen::VectorXd                                     m_vecAverage;                       /**< The averaged data to be streamed. */
     QSharedPointer<Eigen::SparseMatrix<float> >         m_pMatInterpolationMatrix;          /**< The interpolation matrix. */
+    Eigen::SparseMatrix<float, Eigen::RowMajor>         m_matInterpolationMatrixCsr;        /**< The interpolation matrix in row-major layout, used for the parallel block interpolation. */
+    Eigen::MatrixXf                                     m_matInterpolatedBlock;             /**< The interpolated values of the next loop frames <n_vertices x n_frames>. */
+    int                                                 m_iInterpolatedBlockColumn;         /**< The column of m_matInterpolatedBlock which is streamed next. */
+    bool                                                m_bInterpolatedBlockDirty;          /**< Flag whether m_matInterpolatedBlock needs to be recomputed because the data or settings changed. */
 
     bool                                                m_bIsLooping;                       /**< Flag if this thread should repeat sending the same data over and over again. */
     bool                                                m_bStreamSmoothedData;              /**< Flag if this thread's streams the raw or already smoothed data. Latter are produced by multiplying the smoothing operator here in this thread. */
@@ -243,11 +276,13 @@ protected:
         double                      dThresholdX;
         double                      dThresholdZ;
 
-        Eigen::MatrixX4f            matOriginalVertColor;
-        Eigen::MatrixX4f            matFinalVertColor;
+        QByteArray                  arrayOriginalVertColor;             /**< The RGBA8 surface colors. */
+        QByteArray                  arrayFinalVertColor;                /**< The RGBA8 colors of the current frame. */
+        QByteArray                  arrayPreviousVertColor;             /**< The RGBA8 colors of the previous frame. Reused as output of the next frame. */
 
         QString sColormapType;
         QRgb (*functionHandlerColorMap)(double v, const QString& sColorMap) = DISPLIB::ColorMap::valueToColor;
+        ColorMapLut                 colorMapLut;                        /**< The sampled colormap. */
     } m_lVisualizationInfo;               /**< Container for the visualization info. */
 
 
@@ -264,9 +299,9 @@ signals:
     /**
     * Emit this signal whenever this item should stream interpolated raw data to its listeners.
     *
-    * @param[in] matColorMatrix     The interpolated raw data in form of rgb colors for each vertex.
+    * @param[in] arrayColors     The interpolated raw data in form of RGBA8 colors for each vertex.
     */
-    void newRtSmoothedData(const Eigen::MatrixX4f &matColorMatrix);
+    void newRtSmoothedData(const QByteArray &arrayColors);
 };
 
 } // NAMESPACE
@@ -372,11 +372,11 @@ void RtSourceDataController::onNewRtRawData(const VectorXd &vecDataVectorLeftHem
 
 //*************************************************************************************************************
 
-void RtSourceDataController::onNewSmoothedRtRawData(const MatrixX4f &matColorMatrixLeftHemi,
-                                                    const MatrixX4f &matColorMatrixRightHemi)
+void RtSourceDataController::onNewSmoothedRtRawData(const QByteArray &arrayColorsLeftHemi,
+                                                    const QByteArray &arrayColorsRightHemi)
 {
-    emit newRtSmoothedDataAvailable(matColorMatrixLeftHemi,
-                                    matColorMatrixRightHemi);
+    emit newRtSmoothedDataAvailable(arrayColorsLeftHemi,
+                                    arrayColorsRightHemi);
 }
 
 
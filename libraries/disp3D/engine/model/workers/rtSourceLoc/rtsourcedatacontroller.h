@@ -53,6 +53,7 @@
 #include <QTimer>
 #include <QPointer>
 #include <QThread>
+#include <QByteArray>
 
 
 //*************************************************************************************************************
@@ -278,11 +279,11 @@ protected:
     /**
     * Call this function whenever new interpolated raw data is available to be dispatched.
     *
-    * @param[in] matColorMatrixLeftHemi          The new streamed interpolated raw data in form of RGB colors per vertex for the left hemisphere.
-    * @param[in] matColorMatrixRightHemi         The new streamed interpolated raw data in form of RGB colors per vertex for the right hemisphere.
+    * @param[in] arrayColorsLeftHemi          The new streamed interpolated raw data in form of RGBA8 colors per vertex for the left hemisphere.
+    * @param[in] arrayColorsRightHemi         The new streamed interpolated raw data in form of RGBA8 colors per vertex for the right hemisphere.
     */
-    void onNewSmoothedRtRawData(const Eigen::MatrixX4f &matColorMatrixLeftHemi,
-                                const Eigen::MatrixX4f &matColorMatrixRightHemi);
+    void onNewSmoothedRtRawData(const QByteArray &arrayColorsLeftHemi,
+                                const QByteArray &arrayColorsRightHemi);
 
     //=========================================================================================================
     /**
@@ -481,11 +482,11 @@ signals:
     /**
     * Emit this signal whenever a new interpolated raw data is streamed.
     *
-    * @param[in] matColorMatrixLeftHemi          The new streamed interpolated raw data in form of RGB colors per vertex for the left hemisphere.
-    * @param[in] matColorMatrixRightHemi         The new streamed interpolated raw data in form of RGB colors per vertex for the right hemisphere.
+    * @param[in] arrayColorsLeftHemi          The new streamed interpolated raw data in form of RGBA8 colors per vertex for the left hemisphere.
+    * @param[in] arrayColorsRightHemi         The new streamed interpolated raw data in form of RGBA8 colors per vertex for the right hemisphere.
     */
-    void newRtSmoothedDataAvailable(const Eigen::MatrixX4f &matColorMatrixLeftHemi,
-                                    const Eigen::MatrixX4f &matColorMatrixRightHemi);
+    void newRtSmoothedDataAvailable(const QByteArray &arrayColorsLeftHemi,
+                                    const QByteArray &arrayColorsRightHemi);
 };
 
 } // NAMESPACE
@@ -74,6 +74,14 @@ using namespace DISPLIB;
 using namespace FIFFLIB;
 
 
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINES
+//=============================================================================================================
+
+#define MAX_INTERPOLATED_BLOCK_VALUES 16777216 //Upper bound for the number of precomputed interpolated values (64MB)
+
+
 //*************************************************************************************************************
 //=============================================================================================================
 // DEFINE MEMBER METHODS
@@ -85,6 +93,7 @@ RtSourceDataWorker::RtSourceDataWorker()
 , m_dSFreq(1000.0)
 , m_bStreamSmoothedData(true)
 , m_iCurrentSample(0)
+, m_bInterpolatedBlockDirty(true)
 {
     VisualizationInfo leftHemiInfo;
     VisualizationInfo rightHemiInfo;
@@ -114,6 +123,7 @@ void RtSourceDataWorker::addData(const MatrixXd& data)
     }
 
     m_lDataLoopQ = m_lDataQ;
+    m_bInterpolatedBlockDirty = true;
 }
 
 
@@ -122,8 +132,9 @@ void RtSourceDataWorker::addData(const MatrixXd& data)
 void RtSourceDataWorker::setSurfaceColor(const MatrixX4f &matColorLeft,
                                          const MatrixX4f &matColorRight)
 {
-    m_lHemiVisualizationInfo[0].matOriginalVertColor = matColorLeft;
-    m_lHemiVisualizationInfo[1].matOriginalVertColor = matColorRight;
+    //Vertices below threshold keep their surface color but are not plotted
+    m_lHemiVisualizationInfo[0].arrayOriginalVertColor = ColorMapLut::toRgba8(matColorLeft, 0);
+    m_lHemiVisualizationInfo[1].arrayOriginalVertColor = ColorMapLut::toRgba8(matColorRight, 0);
 }
 
 
@@ -132,6 +143,7 @@ void RtSourceDataWorker::setSurfaceColor(const MatrixX4f &matColorLeft,
 void RtSourceDataWorker::setNumberAverages(int iNumAvr)
 {
     m_iAverageSamples = iNumAvr;
+    m_bInterpolatedBlockDirty = true;
 }
 
 
@@ -140,6 +152,7 @@ void RtSourceDataWorker::setNumberAverages(int iNumAvr)
 void RtSourceDataWorker::setStreamSmoothedData(bool bStreamSmoothedData)
 {
     m_bStreamSmoothedData = bStreamSmoothedData;
+    m_bInterpolatedBlockDirty = true;
 }
 
 
@@ -169,6 +182,7 @@ void RtSourceDataWorker::setThresholds(const QVector3D& vecThresholds)
 void RtSourceDataWorker::setLoopState(bool bLoopState)
 {
     m_bIsLooping = bLoopState;
+    m_bInterpolatedBlockDirty = true;
 }
 
 
@@ -185,6 +199,7 @@ void RtSourceDataWorker::setSFreq(const double dSFreq)
 void RtSourceDataWorker::setInterpolationMatrixLeft(QSharedPointer<Eigen::SparseMatrix<float> > pMatInterpolationMatrixLeft)
 {
     m_lHemiVisualizationInfo[0].pMatInterpolationMatrix = pMatInterpolationMatrixLeft;
+    m_bInterpolatedBlockDirty = true;
 }
 
 
@@ -193,7 +208,7 @@ void RtSourceDataWorker::setInterpolationMatrixLeft(QSharedPointer<Eigen::Sparse
 void RtSourceDataWorker::setInterpolationMatrixRight(QSharedPointer<Eigen::SparseMatrix<float> > pMatInterpolationMatrixRight)
 {
     m_lHemiVisualizationInfo[1].pMatInterpolationMatrix = pMatInterpolationMatrixRight;
-
+    m_bInterpolatedBlockDirty = true;
 }
 
 
@@ -206,47 +221,29 @@ void RtSourceDataWorker::streamData()
 //    timer.start();
 
     if(m_iAverageSamples != 0 && !m_lDataLoopQ.isEmpty()) {
-        int iSampleCtr = 0;
-
-        //Perform the actual interpolation and send signal
-        while((iSampleCtr <= m_iAverageSamples)) {
-            if(m_lDataQ.isEmpty()) {
-                if(m_bIsLooping && !m_lDataLoopQ.isEmpty()) {
-                    if(m_vecAverage.rows() != m_lDataLoopQ.front().rows()) {
-                        m_vecAverage = m_lDataLoopQ.front();
-                        m_iCurrentSample++;
-                        iSampleCtr++;
-                    } else if (m_iCurrentSample < m_lDataLoopQ.size()){
-                        m_vecAverage += m_lDataLoopQ.at(m_iCurrentSample);
-                        m_iCurrentSample++;
-                        iSampleCtr++;
-                    }
-
-                    //Set iterator back to the front if needed
-                    if(m_iCurrentSample >= m_lDataLoopQ.size()) {
-                        m_iCurrentSample = 0;
-                        break;
-                    }
-                } else {
+        if(m_bStreamSmoothedData && m_bIsLooping && m_lDataQ.isEmpty()
+           && m_lHemiVisualizationInfo[0].pMatInterpolationMatrix->cols() != 0
+           && m_lHemiVisualizationInfo[1].pMatInterpolationMatrix->cols() != 0) {
+            //Loop playback: stream the precomputed frames and interpolate the next ones in one go when they run out
+            if(m_bInterpolatedBlockDirty
+               || m_lHemiVisualizationInfo[0].iInterpolatedBlockColumn >= m_lHemiVisualizationInfo[0].matInterpolatedBlock.cols()) {
+                if(!interpolateNextBlock()) {
                     return;
                 }
-            } else {
-                if(m_vecAverage.rows() != m_lDataQ.front().rows()) {
-                    m_vecAverage = m_lDataQ.takeFirst();
-                    m_iCurrentSample++;
-                    iSampleCtr++;
-                } else {
-                    m_vecAverage += m_lDataQ.takeFirst();
-                    m_iCurrentSample++;
-                    iSampleCtr++;
-                }
-
-                //Set iterator back to the front if needed
-                if(m_iCurrentSample >= m_lDataQ.size()) {
-                    m_iCurrentSample = 0;
-                    break;
-                }
             }
+
+            //Do calculations for both hemispheres in parallel
+            QFuture<void> result = QtConcurrent::map(m_lHemiVisualizationInfo,
+                                                     generateColorsFromInterpolatedBlock);
+            result.waitForFinished();
+
+            emit newRtSmoothedData(m_lHemiVisualizationInfo[0].arrayFinalVertColor,
+                                   m_lHemiVisualizationInfo[1].arrayFinalVertColor);
+            return;
+        }
+
+        if(!computeNextAverage()) {
+            return;
         }
 
         if(m_lHemiVisualizationInfo[0].pMatInterpolationMatrix->cols() != 0
@@ -263,8 +260,8 @@ void RtSourceDataWorker::streamData()
                                                          generateColorsFromSensorValues);
                 result.waitForFinished();
 
-                emit newRtSmoothedData(m_lHemiVisualizationInfo[0].matFinalVertColor,
-                                       m_lHemiVisualizationInfo[1].matFinalVertColor);
+                emit newRtSmoothedData(m_lHemiVisualizationInfo[0].arrayFinalVertColor,
+                                       m_lHemiVisualizationInfo[1].arrayFinalVertColor);
             } else {
                 emit newRtRawData(m_vecAverage.segment(0, m_lHemiVisualizationInfo[0].pMatInterpolationMatrix->cols()),
                                   m_vecAverage.segment(m_lHemiVisualizationInfo[0].pMatInterpolationMatrix->cols(), m_lHemiVisualizationInfo[1].pMatInterpolationMatrix->cols()));
@@ -282,6 +279,97 @@ void RtSourceDataWorker::streamData()
 }
 
 
+//*************************************************************************************************************
+
+bool RtSourceDataWorker::computeNextAverage()
+{
+    int iSampleCtr = 0;
+
+    //Sum up the samples of the next frame
+    while((iSampleCtr <= m_iAverageSamples)) {
+        if(m_lDataQ.isEmpty()) {
+            if(m_bIsLooping && !m_lDataLoopQ.isEmpty()) {
+                if(m_vecAverage.rows() != m_lDataLoopQ.front().rows()) {
+                    m_vecAverage = m_lDataLoopQ.front();
+                    m_iCurrentSample++;
+                    iSampleCtr++;
+                } else if (m_iCurrentSample < m_lDataLoopQ.size()){
+                    m_vecAverage += m_lDataLoopQ.at(m_iCurrentSample);
+                    m_iCurrentSample++;
+                    iSampleCtr++;
+                }
+
+                //Set iterator back to the front if needed
+                if(m_iCurrentSample >= m_lDataLoopQ.size()) {
+                    m_iCurrentSample = 0;
+                    break;
+                }
+            } else {
+                return false;
+            }
+        } else {
+            if(m_vecAverage.rows() != m_lDataQ.front().rows()) {
+                m_vecAverage = m_lDataQ.takeFirst();
+                m_iCurrentSample++;
+                iSampleCtr++;
+            } else {
+                m_vecAverage += m_lDataQ.takeFirst();
+                m_iCurrentSample++;
+                iSampleCtr++;
+            }
+
+            //Set iterator back to the front if needed
+            if(m_iCurrentSample >= m_lDataQ.size()) {
+                m_iCurrentSample = 0;
+                break;
+            }
+        }
+    }
+
+    return true;
+}
+
+
+//*************************************************************************************************************
+
+bool RtSourceDataWorker::interpolateNextBlock()
+{
+    const int iNumSourcesLeft = m_lHemiVisualizationInfo[0].pMatInterpolationMatrix->cols();
+    const int iNumSourcesRight = m_lHemiVisualizationInfo[1].pMatInterpolationMatrix->cols();
+
+    if(m_lDataLoopQ.front().rows() < iNumSourcesLeft + iNumSourcesRight) {
+        qDebug() << "RtSourceDataWorker::interpolateNextBlock - Number of sources (" << m_lDataLoopQ.front().rows() << ") do not match with previously set number of sources (" << iNumSourcesLeft + iNumSourcesRight << "). Returning...";
+        return false;
+    }
+
+    //Precompute one loop pass if it fits, but bound the memory for dense surfaces
+    const int iNumVert = m_lHemiVisualizationInfo[0].pMatInterpolationMatrix->rows() + m_lHemiVisualizationInfo[1].pMatInterpolationMatrix->rows();
+    int iNumFrames = (m_lDataLoopQ.size() + m_iAverageSamples - 1) / m_iAverageSamples;
+    iNumFrames = qBound(1, iNumFrames, MAX_INTERPOLATED_BLOCK_VALUES / qMax(1, iNumVert));
+
+    MatrixXf matAverages(iNumSourcesLeft + iNumSourcesRight, iNumFrames);
+
+    for(int i = 0; i < iNumFrames; ++i) {
+        computeNextAverage();
+        m_vecAverage /= (double)m_iAverageSamples;
+        matAverages.col(i) = m_vecAverage.head(iNumSourcesLeft + iNumSourcesRight).cast<float>();
+        m_vecAverage.setZero(m_vecAverage.rows());
+    }
+
+    m_lHemiVisualizationInfo[0].matSensorValuesBlock = matAverages.topRows(iNumSourcesLeft);
+    m_lHemiVisualizationInfo[1].matSensorValuesBlock = matAverages.bottomRows(iNumSourcesRight);
+
+    //Do calculations for both hemispheres in parallel
+    QFuture<void> result = QtConcurrent::map(m_lHemiVisualizationInfo,
+                                             interpolateBlock);
+    result.waitForFinished();
+
+    m_bInterpolatedBlockDirty = false;
+
+    return true;
+}
+
+
 //*************************************************************************************************************
 
 void RtSourceDataWorker::generateColorsFromSensorValues(VisualizationInfo &visualizationInfoHemi)
@@ -294,75 +382,102 @@ void RtSourceDataWorker::generateColorsFromSensorValues(VisualizationInfo &visua
     // interpolate sensor signals
     VectorXf vecIntrpltdVals = Interpolation::interpolateSignal(*visualizationInfoHemi.pMatInterpolationMatrix, visualizationInfoHemi.vecSensorValues.cast<float>());
 
-    // Reset to original color as default
-    visualizationInfoHemi.matFinalVertColor = visualizationInfoHemi.matOriginalVertColor;
+    generateColorsFromInterpolatedValues(vecIntrpltdVals,
+                                         visualizationInfoHemi);
+}
+
+
+//*************************************************************************************************************
+
+void RtSourceDataWorker::generateColorsFromInterpolatedBlock(VisualizationInfo &visualizationInfoHemi)
+{
+    generateColorsFromInterpolatedValues(visualizationInfoHemi.matInterpolatedBlock.col(visualizationInfoHemi.iInterpolatedBlockColumn),
+                                         visualizationInfoHemi);
+
+    visualizationInfoHemi.iInterpolatedBlockColumn++;
+}
+
+
+//*************************************************************************************************************
+
+void RtSourceDataWorker::interpolateBlock(VisualizationInfo &visualizationInfoHemi)
+{
+    visualizationInfoHemi.matInterpolatedBlock = Interpolation::interpolateSignals(*visualizationInfoHemi.pMatInterpolationMatrix,
+                                                                                   visualizationInfoHemi.matSensorValuesBlock);
+    visualizationInfoHemi.iInterpolatedBlockColumn = 0;
+}
+
+
+//*************************************************************************************************************
+
+void RtSourceDataWorker::generateColorsFromInterpolatedValues(const VectorXf& vecIntrpltdVals,
+                                                              VisualizationInfo &visualizationInfoHemi)
+{
+    // Sample the colormap if it changed since the last frame
+    visualizationInfoHemi.colorMapLut.setColormap(visualizationInfoHemi.sColormapType,
+                                                  visualizationInfoHemi.functionHandlerColorMap);
+
+    // Write into the buffer of the frame before the last one. Its receivers are done with it by now, so it is
+    // usually not shared anymore and can be overwritten without a new allocation.
+    qSwap(visualizationInfoHemi.arrayFinalVertColor, visualizationInfoHemi.arrayPreviousVertColor);
 
     //Generate color data for vertices
     normalizeAndTransformToColor(vecIntrpltdVals,
-                                 visualizationInfoHemi.matFinalVertColor,
+                                 visualizationInfoHemi.arrayOriginalVertColor,
+                                 visualizationInfoHemi.arrayFinalVertColor,
                                  visualizationInfoHemi.dThresholdX,
                                  visualizationInfoHemi.dThresholdZ,
-                                 visualizationInfoHemi.functionHandlerColorMap,
-                                 visualizationInfoHemi.sColormapType);
+                                 visualizationInfoHemi.colorMapLut);
 }
 
 
 //*************************************************************************************************************
 
 void RtSourceDataWorker::normalizeAndTransformToColor(const VectorXf& vecData,
-                                                      MatrixX4f& matFinalVertColor,
+                                                      const QByteArray& arrayOriginalVertColor,
+                                                      QByteArray& arrayFinalVertColor,
                                                       double dThresholdX,
                                                       double dThresholdZ,
-                                                      QRgb (*functionHandlerColorMap)(double v, const QString& sColorMap),
-                                                      const QString& sColorMap)
+                                                      const ColorMapLut& colorMapLut)
 {
     //Note: This function needs to be implemented extremly efficient.
-    if(vecData.rows() != matFinalVertColor.rows()) {
-        qDebug() << "RtSourceDataWorker::normalizeAndTransformToColor - Sizes of input data (" << vecData.rows() <<") do not match output data ("<< matFinalVertColor.rows() <<"). Returning ...";
+    if(vecData.rows() * 4 != arrayOriginalVertColor.size()) {
+        qDebug() << "RtSourceDataWorker::normalizeAndTransformToColor - Sizes of input data (" << vecData.rows() <<") do not match output data ("<< arrayOriginalVertColor.size() / 4 <<"). Returning ...";
+        arrayFinalVertColor = arrayOriginalVertColor;
         return;
     }
 
+    if(arrayFinalVertColor.size() != arrayOriginalVertColor.size()) {
+        arrayFinalVertColor.resize(arrayOriginalVertColor.size());
+    }
+
+    const quint32* pOriginalVertColor = reinterpret_cast<const quint32*>(arrayOriginalVertColor.constData());
+    quint32* pFinalVertColor = reinterpret_cast<quint32*>(arrayFinalVertColor.data());
+
+    const float fThresholdX = static_cast<float>(dThresholdX);
+    const float fThresholdZ = static_cast<float>(dThresholdZ);
+    const float fTresholdDiff = fThresholdZ - fThresholdX;
     float fSample;
-    QRgb qRgb;
-    const double dTresholdDiff = dThresholdZ - dThresholdX;
 
     for(int r = 0; r < vecData.rows(); ++r) {
         //Take the absolute values because the histogram threshold is also calcualted using the absolute values
         fSample = std::fabs(vecData(r));
 
-        if(fSample >= dThresholdX) {
+        if(fSample >= fThresholdX) {
             //Check lower and upper thresholds and normalize to one
-            if(fSample >= dThresholdZ) {
+            if(fSample >= fThresholdZ) {
                 fSample = 1.0f;
             } else {
-                if(fSample != 0.0f && dTresholdDiff != 0.0 ) {
-                    fSample = (fSample - dThresholdX) / (dTresholdDiff);
+                if(fSample != 0.0f && fTresholdDiff != 0.0f) {
+                    fSample = (fSample - fThresholdX) / fTresholdDiff;
                 } else {
                     fSample = 0.0f;
                 }
             }
 
-            qRgb = functionHandlerColorMap(fSample, sColorMap);
-
-            QColor color(qRgb);
-//            QColor color (matFinalVertColor(r,0) * 255 * (1.0-0.60) + (float)qRed(qRgb)*0.60,
-//                          matFinalVertColor(r,1) * 255 * (1.0-0.60) + (float)qGreen(qRgb)*0.60,
-//                          matFinalVertColor(r,2) * 255 * (1.0-0.60) + (float)qBlue(qRgb)*0.60,
-//                          255.0 + 0.75 * (255.0-255.0));
-
-            //qDebug() << "RtSourceDataWorker::normalizeAndTransformToColor color" << color;
-
-            matFinalVertColor(r,0) = color.redF();
-            matFinalVertColor(r,1) = color.greenF();
-            matFinalVertColor(r,2) = color.blueF();
-            matFinalVertColor(r,3) = color.alphaF();
-
-//            matFinalVertColor(r,0) = (float)qRed(qRgb)/255.0f;
-//            matFinalVertColor(r,1) = (float)qGreen(qRgb)/255.0f;
-//            matFinalVertColor(r,2) = (float)qBlue(qRgb)/255.0f;
-//            matFinalVertColor(r,3) = 1.0f;
+            pFinalVertColor[r] = colorMapLut.rgba(fSample);
         } else {
-            matFinalVertColor(r,3) = 0.0f; //Use this if you want only vertices with activation to be plotted
+            pFinalVertColor[r] = pOriginalVertColor[r]; //Use this if you want only vertices with activation to be plotted
         }
     }
 }
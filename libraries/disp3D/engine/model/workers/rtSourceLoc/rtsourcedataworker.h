@@ -44,6 +44,7 @@
 //=============================================================================================================
 
 #include "../../../../disp3D_global.h"
+#include "../../3dhelpers/colormaplut.h"
 
 #include <disp/plots/helpers/colormap.h>
 
@@ -54,6 +55,7 @@
 //=============================================================================================================
 
 #include <QRgb>
+#include <QByteArray>
 #include <QSharedPointer>
 #include <QLinkedList>
 
@@ -85,13 +87,19 @@ struct VisualizationInfo {
     double                      dThresholdZ;
 
     Eigen::VectorXd             vecSensorValues;
-    Eigen::MatrixX4f            matOriginalVertColor;
-    Eigen::MatrixX4f            matFinalVertColor;
+    QByteArray                  arrayOriginalVertColor;                         /**< The RGBA8 surface colors with zero alpha. */
+    QByteArray                  arrayFinalVertColor;                            /**< The RGBA8 colors of the current frame. */
+    QByteArray                  arrayPreviousVertColor;                         /**< The RGBA8 colors of the previous frame. Reused as output of the next frame. */
 
     QSharedPointer<Eigen::SparseMatrix<float> >  pMatInterpolationMatrix;         /**< The interpolation matrix. */
 
     QString sColormapType;
     QRgb (*functionHandlerColorMap)(double v, const QString& sColorMap) = DISPLIB::ColorMap::valueToColor;
+    ColorMapLut                 colorMapLut;                                    /**< The sampled colormap. */
+
+    Eigen::MatrixXf             matSensorValuesBlock;                           /**< The averaged values of the next loop frames <n_sources x n_frames>. */
+    Eigen::MatrixXf             matInterpolatedBlock;                           /**< The interpolated values of the next loop frames <n_vertices x n_frames>. */
+    int                         iInterpolatedBlockColumn = 0;                   /**< The column of matInterpolatedBlock which is colored next. */
 }; /**< The struct specifing visualization info. */
 
 struct ColorComputationInfo {
@@ -228,21 +236,21 @@ public:
 protected:
     //=========================================================================================================
     /**
-    * @brief normalizeAndTransformToColor  This method normalizes final values for all vertices of the mesh and converts them to rgb using the specified color converter
+    * @brief normalizeAndTransformToColor  This method normalizes final values for all vertices of the mesh and converts them to RGBA8 using the colormap lookup table
     *
     * @param[in] vecData                       The final values for each vertex of the surface
-    * @param[in,out] matFinalVertColor         The color matrix which the results are to be written to
+    * @param[in] arrayOriginalVertColor        The RGBA8 colors used for vertices below the lower threshold
+    * @param[in,out] arrayFinalVertColor       The RGBA8 buffer which the results are to be written to
     * @param[in] dThresholdX                   Lower threshold for normalizing
     * @param[in] dThresholdZ                   Upper threshold for normalizing
-    * @param[in] functionHandlerColorMap       The pointer to the function which converts scalar values to rgb
-    * @param[in] sColorMap                     The color map to use
+    * @param[in] colorMapLut                   The sampled colormap
     */
     static void normalizeAndTransformToColor(const Eigen::VectorXf& vecData,
-                                             Eigen::MatrixX4f &matFinalVertColor,
+                                             const QByteArray& arrayOriginalVertColor,
+                                             QByteArray& arrayFinalVertColor,
                                              double dThresholdX,
                                              double dThresholdZ,
-                                             QRgb (*functionHandlerColorMap)(double v, const QString& sColorMap),
-                                             const QString& sColorMap);
+                                             const ColorMapLut& colorMapLut);
 
     //=========================================================================================================
     /**
@@ -252,12 +260,56 @@ protected:
     */
     static void generateColorsFromSensorValues(VisualizationInfo &visualizationInfoHemi);
 
+    //=========================================================================================================
+    /**
+    * @brief generateColorsFromInterpolatedBlock    Produces the final color matrix of the next precomputed loop frame
+    *
+    * @param[in/out] visualizationInfoHemi          The needed visualization info
+    */
+    static void generateColorsFromInterpolatedBlock(VisualizationInfo &visualizationInfoHemi);
+
+    //=========================================================================================================
+    /**
+    * @brief generateColorsFromInterpolatedValues   Produces the final color matrix from already interpolated values
+    *
+    * @param[in] vecIntrpltdVals                    The interpolated value of each vertex
+    * @param[in/out] visualizationInfoHemi          The needed visualization info
+    */
+    static void generateColorsFromInterpolatedValues(const Eigen::VectorXf& vecIntrpltdVals,
+                                                     VisualizationInfo &visualizationInfoHemi);
+
+    //=========================================================================================================
+    /**
+    * @brief interpolateBlock       Interpolates all frames of matSensorValuesBlock with one sparse-dense product
+    *
+    * @param[in/out] visualizationInfoHemi          The needed visualization info
+    */
+    static void interpolateBlock(VisualizationInfo &visualizationInfoHemi);
+
+    //=========================================================================================================
+    /**
+    * @brief computeNextAverage     Sums up the next samples of the data or loop queue into m_vecAverage
+    *
+    * @return Whether a new sum is available
+    */
+    bool computeNextAverage();
+
+    //=========================================================================================================
+    /**
+    * @brief interpolateNextBlock   Averages the next frames of the loop queue and interpolates all of them per hemisphere
+    *                               with one sparse-dense product. Loop playback is deterministic, so the frames are known in advance.
+    *
+    * @return Whether the block could be interpolated
+    */
+    bool interpolateNextBlock();
+
     QList<Eigen::VectorXd>                              m_lDataQ;                           /**< List that holds the matrix data <n_channels x n_samples>. */
     QList<Eigen::VectorXd>                              m_lDataLoopQ;                       /**< List that holds the matrix data <n_channels x n_samples> for looping. */
     Eigen::VectorXd                                     m_vecAverage;                       /**< The averaged data to be streamed. */
 
     bool                                                m_bIsLooping;                       /**< Flag if this thread should repeat sending the same data over and over again. */
     bool                                                m_bStreamSmoothedData;              /**< Flag if this thread's streams the raw or already smoothed data. Latter are produced by multiplying the smoothing operator here in this thread. */
+    bool                                                m_bInterpolatedBlockDirty;          /**< Flag whether the precomputed loop frames need to be recomputed because the data or settings changed. */
 
     int                                                 m_iCurrentSample;                   /**< Iterator to current sample which is/was streamed. */
     int                                                 m_iAverageSamples;                  /**< Number of average to compute. */
@@ -282,11 +334,11 @@ signals:
     /**
     * Emit this signal whenever this item should stream interpolated raw data to its listeners.
     *
-    * @param[in] matColorMatrixLeftHemi          The new streamed interpolated raw data in form of RGB colors per vertex for the left hemisphere.
-    * @param[in] matColorMatrixRightHemi         The new streamed interpolated raw data in form of RGB colors per vertex for the right hemisphere.
+    * @param[in] arrayColorsLeftHemi          The new streamed interpolated raw data in form of RGBA8 colors per vertex for the left hemisphere.
+    * @param[in] arrayColorsRightHemi         The new streamed interpolated raw data in form of RGBA8 colors per vertex for the right hemisphere.
     */
-    void newRtSmoothedData(const Eigen::MatrixX4f &matColorMatrixLeftHemi,
-                           const Eigen::MatrixX4f &matColorMatrixRightHemi);
+    void newRtSmoothedData(const QByteArray &arrayColorsLeftHemi,
+                           const QByteArray &arrayColorsRightHemi);
 };
 
 } // NAMESPACE
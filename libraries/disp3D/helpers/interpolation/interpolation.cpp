@@ -48,6 +48,8 @@
 
 #include <QSet>
 #include <QDebug>
+#include <QThread>
+#include <QtConcurrent>
 
 
 //*************************************************************************************************************
@@ -182,6 +184,58 @@ VectorXf Interpolation::interpolateSignal(const SparseMatrix<float> &matInterpol
 }
 
 
+//*************************************************************************************************************
+
+MatrixXf Interpolation::interpolateSignals(const SparseMatrix<float> &matInterpolationMatrix,
+                                           const MatrixXf &matMeasurementData)
+{
+    if (matInterpolationMatrix.cols() != matMeasurementData.rows()) {
+        qDebug() << "[WARNING] Interpolation::interpolateSignals - Dimension mismatch. Return empty matrix...";
+        return MatrixXf();
+    }
+
+    MatrixXf matOut = matInterpolationMatrix * matMeasurementData;
+
+    return matOut;
+}
+
+
+//*************************************************************************************************************
+
+MatrixXf Interpolation::interpolateSignals(const SparseMatrix<float, RowMajor> &matInterpolationMatrix,
+                                           const MatrixXf &matMeasurementData)
+{
+    if (matInterpolationMatrix.cols() != matMeasurementData.rows()) {
+        qDebug() << "[WARNING] Interpolation::interpolateSignals - Dimension mismatch. Return empty matrix...";
+        return MatrixXf();
+    }
+
+    MatrixXf matOut(matInterpolationMatrix.rows(), matMeasurementData.cols());
+
+    //Split the vertices into one contiguous range per thread. Small products are not worth the scheduling.
+    const int iNumRows = matInterpolationMatrix.rows();
+    const int iNumRanges = qBound(1, qMin(QThread::idealThreadCount(), iNumRows / 1024), 64);
+    const int iRangeSize = (iNumRows + iNumRanges - 1) / qMax(1, iNumRanges);
+
+    if(iNumRanges <= 1) {
+        matOut.noalias() = matInterpolationMatrix * matMeasurementData;
+        return matOut;
+    }
+
+    QVector<int> vecRangeStarts;
+    for(int i = 0; i < iNumRows; i += iRangeSize) {
+        vecRangeStarts.append(i);
+    }
+
+    QtConcurrent::blockingMap(vecRangeStarts, [&](const int& iStart) {
+        const int iRows = qMin(iRangeSize, iNumRows - iStart);
+        matOut.middleRows(iStart, iRows).noalias() = matInterpolationMatrix.middleRows(iStart, iRows) * matMeasurementData;
+    });
+
+    return matOut;
+}
+
+
 //*************************************************************************************************************
 
 double Interpolation::linear(const double dIn)
@@ -164,6 +164,33 @@ public:
     static Eigen::VectorXf interpolateSignal(const Eigen::SparseMatrix<float> &matInterpolationMatrix,
                                              const Eigen::VectorXf &vecMeasurementData);
 
+    //=========================================================================================================
+    /**
+    * Interpolates a whole block of samples with one sparse-dense matrix product, which is considerably faster
+    * than calling <i>interpolateSignal</i> for each sample because the weight matrix is traversed only once.
+    *
+    * @param[in] matInterpolationMatrix    The weight matrix which should be used for multiplying
+    * @param[in] matMeasurementData        The measured sensor data <n_sensors x n_samples>
+    *
+    * @return                              Interpolated values for all vertices of the mesh <n_vertices x n_samples>
+    */
+    static Eigen::MatrixXf interpolateSignals(const Eigen::SparseMatrix<float> &matInterpolationMatrix,
+                                              const Eigen::MatrixXf &matMeasurementData);
+
+    //=========================================================================================================
+    /**
+    * Interpolates a whole block of samples with a weight matrix in row-major (CSR) layout. The vertices are split
+    * into contiguous ranges which are multiplied in parallel. Convert the weight matrix once, e.g. via
+    * Eigen::SparseMatrix<float, Eigen::RowMajor> matCsr = *createInterpolationMat(...), and reuse it for all blocks.
+    *
+    * @param[in] matInterpolationMatrix    The weight matrix in row-major layout
+    * @param[in] matMeasurementData        The measured sensor data <n_sensors x n_samples>
+    *
+    * @return                              Interpolated values for all vertices of the mesh <n_vertices x n_samples>
+    */
+    static Eigen::MatrixXf interpolateSignals(const Eigen::SparseMatrix<float, Eigen::RowMajor> &matInterpolationMatrix,
+                                              const Eigen::MatrixXf &matMeasurementData);
+
     //=========================================================================================================
     /**
     * Serves as a placeholder for other functions and is needed in case a linear interpolation is wanted when calling <i>createInterplationMat</i>.Returns input argument unchanged.
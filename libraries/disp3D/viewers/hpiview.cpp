@@ -485,9 +485,10 @@ void HpiView::onBtnDoSingleFit()
     }
 
     //Generate/Update current dev/head transfomration. We do not need to make use of rtHPI plugin here since the fitting is only needed once here.
-    //rt head motion correction will be performed using the rtHPI plugin.
+    //rt head motion correction will be performed using the rtHPI plugin. The single fit bypasses the continuous
+    //demodulation, which already received this block in setData().
     if(m_pFiffInfo) {
-        m_pRtHPI->append(m_matValue);
+        m_pRtHPI->fitSingle(m_matValue);
     }
 }
 
@@ -559,6 +560,12 @@ void HpiView::onDoContinousHPI()
        return;
     }
 
+    //Continuous mode demodulates incrementally and warm starts each fit from the last accepted positions
+    m_pRtHPI->setContinuousFitting(ui->m_checkBox_continousHPI->isChecked(),
+                                   -1,
+                                   -1,
+                                   m_dMaxHPIFitError);
+
     emit continousHPIToggled(ui->m_checkBox_continousHPI->isChecked());
 }
 
@@ -568,6 +575,13 @@ void HpiView::onDoContinousHPI()
 void HpiView::onContinousHPIMaxDistChanged()
 {
     m_dMaxHPIFitError = ui->m_doubleSpinBox_maxHPIContinousDist->value() * 0.001;
+
+    if(ui->m_checkBox_continousHPI->isChecked()) {
+        m_pRtHPI->setContinuousFitting(true,
+                                       -1,
+                                       -1,
+                                       m_dMaxHPIFitError);
+    }
 }
 
 
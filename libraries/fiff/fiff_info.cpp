@@ -314,6 +314,8 @@ FiffInfo FiffInfo::pick_info(const RowVectorXi &sel) const
     //ToDo when pointer List do delation
     res.chs.clear();
     res.ch_names.clear();
+    res.chs.reserve(sel.size());
+    res.ch_names.reserve(sel.size());
 
     qint32 idx;
     for(qint32 i = 0; i < sel.size(); ++i)
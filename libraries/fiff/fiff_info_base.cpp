@@ -43,6 +43,15 @@
 #include <iostream>
 
 
+//*************************************************************************************************************
+//=============================================================================================================
+// Qt INCLUDES
+//=============================================================================================================
+
+#include <QMutexLocker>
+#include <QSet>
+
+
 //*************************************************************************************************************
 //=============================================================================================================
 // USED NAMESPACES
@@ -89,6 +98,27 @@ FiffInfoBase::~FiffInfoBase()
 }
 
 
+//*************************************************************************************************************
+
+FiffInfoBase& FiffInfoBase::operator= (const FiffInfoBase& rhs)
+{
+    if(this != &rhs) {
+        filename = rhs.filename;
+        bads = rhs.bads;
+        meas_id = rhs.meas_id;
+        nchan = rhs.nchan;
+        chs = rhs.chs;
+        ch_names = rhs.ch_names;
+        dev_head_t = rhs.dev_head_t;
+        ctf_head_t = rhs.ctf_head_t;
+
+        invalidateChannelIndex();
+    }
+
+    return *this;
+}
+
+
 //*************************************************************************************************************
 
 QString FiffInfoBase::channel_type(qint32 idx) const
@@ -124,6 +154,38 @@ QString FiffInfoBase::channel_type(qint32 idx) const
 }
 
 
+//*************************************************************************************************************
+
+qint32 FiffInfoBase::channelIndex(const QString& chName) const
+{
+    return channelIndexTables()->hashNames.value(chName, -1);
+}
+
+
+//*************************************************************************************************************
+
+int FiffInfoBase::channelTypeFlags(qint32 idx) const
+{
+    QSharedPointer<const ChannelIndex> pIndex = channelIndexTables();
+
+    if(idx < 0 || idx >= pIndex->vecTypeFlags.size()) {
+        return 0;
+    }
+
+    return pIndex->vecTypeFlags.at(idx);
+}
+
+
+//*************************************************************************************************************
+
+void FiffInfoBase::invalidateChannelIndex()
+{
+    QMutexLocker locker(&m_mutexChannelIndex);
+
+    m_pChannelIndex.clear();
+}
+
+
 //*************************************************************************************************************
 
 void FiffInfoBase::clear()
@@ -136,6 +198,8 @@ void FiffInfoBase::clear()
     dev_head_t.clear();
     ctf_head_t.clear();
     bads.clear();
+
+    invalidateChannelIndex();
 }
 
 
@@ -145,25 +209,27 @@ RowVectorXi FiffInfoBase::pick_types(const QString meg, bool eeg, bool stim, con
 {
     RowVectorXi pick = RowVectorXi::Zero(this->nchan);
 
-    fiff_int_t kind;
+    int typeMask = 0;
+    if(meg.compare("all") == 0) {
+        typeMask |= MegChannel;
+    } else if(meg.compare("grad") == 0) {
+        typeMask |= GradChannel;
+    } else if(meg.compare("mag") == 0) {
+        typeMask |= MagChannel;
+    }
+    if(eeg) {
+        typeMask |= EegChannel;
+    }
+    if(stim) {
+        typeMask |= StimChannel;
+    }
+
+    QSharedPointer<const ChannelIndex> pIndex = channelIndexTables();
+
     qint32 k;
-    for(k = 0; k < this->nchan; ++k)
+    for(k = 0; k < this->nchan && k < pIndex->vecTypeFlags.size(); ++k)
     {
-        kind = this->chs[k].kind;
-
-        if ((kind == FIFFV_MEG_CH || kind == FIFFV_REF_MEG_CH))
-        {
-            if(meg.compare("all") == 0) {
-                pick(k) = 1;
-            } else if(meg.compare("grad") == 0 && this->chs[k].unit == FIFF_UNIT_T_M) {
-                pick(k) = 1;
-            } else if(meg.compare("mag") == 0 && this->chs[k].unit == FIFF_UNIT_T) {
-                pick(k) = 1;
-            }
-        }
-        else if (kind == FIFFV_EEG_CH && eeg)
-            pick(k) = 1;
-        else if (kind == FIFFV_STIM_CH && stim)
+        if(pIndex->vecTypeFlags.at(k) & typeMask)
             pick(k) = 1;
     }
 
@@ -213,19 +279,22 @@ RowVectorXi FiffInfoBase::pick_channels(const QStringList& ch_names, const QStri
 {
     RowVectorXi sel = RowVectorXi::Zero(ch_names.size());
 
-    QStringList t_includedSelection;
+    //Hashed lookups keep this linear for large include and exclude lists
+    QSet<QString> t_include = include.toSet();
+    QSet<QString> t_exclude = exclude.toSet();
+    QSet<QString> t_includedSelection;
 
     qint32 count = 0;
     for(qint32 k = 0; k < ch_names.size(); ++k)
     {
-        if( (include.size() == 0 || include.contains(ch_names[k])) && !exclude.contains(ch_names[k]))
+        if( (include.size() == 0 || t_include.contains(ch_names[k])) && !t_exclude.contains(ch_names[k]))
         {
             //make sure channel is unique
             if(!t_includedSelection.contains(ch_names[k]))
             {
                 sel[count] = k;
                 ++count;
-                t_includedSelection << ch_names[k];
+                t_includedSelection.insert(ch_names[k]);
             }
         }
     }
@@ -245,6 +314,8 @@ FiffInfoBase FiffInfoBase::pick_info(const RowVectorXi* sel) const
     //ToDo when pointer List do deletion
     res.chs.clear();
     res.ch_names.clear();
+    res.chs.reserve(sel->size());
+    res.ch_names.reserve(sel->size());
 
     qint32 idx;
     for(qint32 i = 0; i < sel->size(); ++i)
@@ -257,3 +328,51 @@ FiffInfoBase FiffInfoBase::pick_info(const RowVectorXi* sel) const
 
     return res;
 }
+
+
+//*************************************************************************************************************
+
+QSharedPointer<const FiffInfoBase::ChannelIndex> FiffInfoBase::channelIndexTables() const
+{
+    QMutexLocker locker(&m_mutexChannelIndex);
+
+    if(m_pChannelIndex
+       && m_pChannelIndex->iNumNames == this->ch_names.size()
+       && m_pChannelIndex->vecTypeFlags.size() == this->chs.size()) {
+        return m_pChannelIndex;
+    }
+
+    QSharedPointer<ChannelIndex> pIndex = QSharedPointer<ChannelIndex>(new ChannelIndex);
+    pIndex->iNumNames = this->ch_names.size();
+
+    //Insert backwards, so that the first of duplicate names wins as with QStringList::indexOf
+    pIndex->hashNames.reserve(this->ch_names.size());
+    for(qint32 i = this->ch_names.size() - 1; i >= 0; --i) {
+        pIndex->hashNames.insert(this->ch_names.at(i), i);
+    }
+
+    pIndex->vecTypeFlags.resize(this->chs.size());
+    for(qint32 i = 0; i < this->chs.size(); ++i) {
+        const FiffChInfo& chInfo = this->chs.at(i);
+        int flags = 0;
+
+        if(chInfo.kind == FIFFV_MEG_CH || chInfo.kind == FIFFV_REF_MEG_CH) {
+            flags |= MegChannel;
+            if(chInfo.unit == FIFF_UNIT_T_M) {
+                flags |= GradChannel;
+            } else if(chInfo.unit == FIFF_UNIT_T) {
+                flags |= MagChannel;
+            }
+        } else if(chInfo.kind == FIFFV_EEG_CH) {
+            flags |= EegChannel;
+        } else if(chInfo.kind == FIFFV_STIM_CH) {
+            flags |= StimChannel;
+        }
+
+        pIndex->vecTypeFlags[i] = flags;
+    }
+
+    m_pChannelIndex = pIndex;
+
+    return m_pChannelIndex;
+}
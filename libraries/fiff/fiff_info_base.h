@@ -56,9 +56,12 @@
 // Qt INCLUDES
 //=============================================================================================================
 
+#include <QHash>
 #include <QList>
+#include <QMutex>
 #include <QStringList>
 #include <QSharedPointer>
+#include <QVector>
 
 
 //*************************************************************************************************************
@@ -89,6 +92,17 @@ public:
     typedef QSharedPointer<FiffInfoBase> SPtr;              /**< Shared pointer type for FiffInfoBase. */
     typedef QSharedPointer<const FiffInfoBase> ConstSPtr;   /**< Const shared pointer type for FiffInfoBase. */
 
+    /**
+    * Channel type flags, as used by pick_types.
+    */
+    enum ChannelType {
+        MegChannel  = 0x01,     /**< MEG or MEG reference channel. */
+        GradChannel = 0x02,     /**< MEG or MEG reference channel measured in T/m. */
+        MagChannel  = 0x04,     /**< MEG or MEG reference channel measured in T. */
+        EegChannel  = 0x08,     /**< EEG channel. */
+        StimChannel = 0x10      /**< Stimulus channel. */
+    };
+
     //=========================================================================================================
     /**
     * Constructors the light fiff measurement file information.
@@ -109,6 +123,16 @@ public:
     */
     ~FiffInfoBase();
 
+    //=========================================================================================================
+    /**
+    * Assignment operator. The channel lookup tables are not copied, they are rebuilt on the next lookup.
+    *
+    * @param[in] rhs    light FIFF measurement information which should be assigned
+    *
+    * @return this light FIFF measurement information
+    */
+    FiffInfoBase& operator= (const FiffInfoBase& rhs);
+
     //=========================================================================================================
     /**
     * Initializes light FIFF measurement information.
@@ -125,6 +149,34 @@ public:
     */
     QString channel_type(qint32 idx) const;
 
+    //=========================================================================================================
+    /**
+    * Returns the index of a channel in ch_names. The lookup uses a name to index hash, which is built on first use.
+    * Call invalidateChannelIndex after ch_names or chs were modified.
+    *
+    * @param[in] chName     The channel name.
+    *
+    * @return Index of the (first) channel with this name, -1 if there is none
+    */
+    qint32 channelIndex(const QString& chName) const;
+
+    //=========================================================================================================
+    /**
+    * Returns the channel type flags of a channel, see ChannelType. Cached together with the channel name index.
+    *
+    * @param[in] idx    Index of channel
+    *
+    * @return The channel type flags, 0 if the channel is of none of the types
+    */
+    int channelTypeFlags(qint32 idx) const;
+
+    //=========================================================================================================
+    /**
+    * Discards the channel lookup tables of channelIndex and channelTypeFlags. Has to be called after ch_names or
+    * chs were modified in place. Changes of the number of channels are detected without it.
+    */
+    void invalidateChannelIndex();
+
     //=========================================================================================================
     /**
     * True if FIFF measurement file information is empty.
@@ -222,6 +274,27 @@ public:
     QStringList ch_names;       /**< List of all channel names. */
     FiffCoordTrans dev_head_t;  /**< Coordinate transformation ToDo... */
     FiffCoordTrans ctf_head_t;  /**< Coordinate transformation ToDo... */
+
+private:
+    /**
+    * Lookup tables over the channels.
+    */
+    struct ChannelIndex {
+        qint32 iNumNames;                   /**< Number of indexed channel names. */
+        QHash<QString, qint32> hashNames;   /**< Channel name to index. */
+        QVector<int> vecTypeFlags;          /**< Channel type flags per channel. */
+    };
+
+    //=========================================================================================================
+    /**
+    * Returns the channel lookup tables, (re)building them if they were invalidated or the number of channels changed.
+    *
+    * @return The current channel lookup tables
+    */
+    QSharedPointer<const ChannelIndex> channelIndexTables() const;
+
+    mutable QSharedPointer<const ChannelIndex> m_pChannelIndex;     /**< Cached channel lookup tables. */
+    mutable QMutex m_mutexChannelIndex;                             /**< Guards the lazy (re)build of the lookup tables, infos are shared between threads. */
 };
 
 //*************************************************************************************************************
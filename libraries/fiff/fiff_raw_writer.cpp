@@ -0,0 +1,493 @@
+//=============================================================================================================
+/**
+* @file     fiff_raw_writer.cpp
+* @author   agent <agent@local>
+* @version  1.0
+* @date     October, 2026
+*
+* @section  LICENSE
+*
+* Copyright (C) 2026, agent. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+*
+* @brief    Definition of the FiffRawWriter Class.
+*
+*/
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "fiff_raw_writer.h"
+#include "fiff_file.h"
+#include "fiff_constants.h"
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// Qt INCLUDES
+//=============================================================================================================
+
+#include <QFileInfo>
+#include <QMutexLocker>
+#include <QtEndian>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// STL INCLUDES
+//=============================================================================================================
+
+#include <cstring>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// USED NAMESPACES
+//=============================================================================================================
+
+using namespace FIFFLIB;
+using namespace Eigen;
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE MEMBER METHODS
+//=============================================================================================================
+
+FiffRawWriter::FiffRawWriter(QObject *parent)
+: QThread(parent)
+, m_bOpen(false)
+, m_bStop(false)
+, m_bDropWhenFull(false)
+, m_iMaxQueueSize(256*1024*1024)
+, m_iMaxFileSize(2000000000L)
+, m_statistics(Statistics())
+, m_iFirstSample(0)
+, m_bResetRange(true)
+, m_iFileSize(0)
+{
+}
+
+
+//*************************************************************************************************************
+
+FiffRawWriter::~FiffRawWriter()
+{
+    if(isOpen()) {
+        close();
+    }
+}
+
+
+//*************************************************************************************************************
+
+bool FiffRawWriter::open(const QString& sFileName,
+                         const FiffInfo& info,
+                         fiff_int_t iFirstSample,
+                         bool bApplyCals,
+                         bool bResetRange)
+{
+    if(isOpen()) {
+        printf("FiffRawWriter::open - A file is already open.\n");
+        return false;
+    }
+
+    m_info = info;
+    m_sFileName = sFileName;
+    m_iFirstSample = iFirstSample;
+    m_bResetRange = bResetRange;
+
+    {
+        QMutexLocker locker(&m_mutex);
+        m_statistics = Statistics();
+    }
+
+    RowVectorXd cals;
+    if(!startFile(sFileName, iFirstSample, cals)) {
+        return false;
+    }
+
+    if(bApplyCals) {
+        m_vecInvCals = cals.cwiseInverse().cast<float>();
+    } else {
+        m_vecInvCals.resize(0);
+    }
+
+    {
+        QMutexLocker locker(&m_mutex);
+        m_bStop = false;
+        m_bOpen = true;
+    }
+
+    start();
+
+    return true;
+}
+
+
+//*************************************************************************************************************
+
+bool FiffRawWriter::write(const MatrixXf& matData)
+{
+    qint64 iBytes = matData.size() * (qint64)sizeof(float);
+
+    QMutexLocker locker(&m_mutex);
+
+    if(!m_bOpen || m_bStop) {
+        return false;
+    }
+
+    if(m_statistics.bError || (m_vecInvCals.size() > 0 && m_vecInvCals.size() != matData.rows())) {
+        ++m_statistics.iBlocksDropped;
+        return false;
+    }
+
+    //A block which is larger than the queue is accepted if the queue is empty
+    while(m_statistics.iQueuedBytes > 0 && m_statistics.iQueuedBytes + iBytes > m_iMaxQueueSize) {
+        if(m_bDropWhenFull || m_bStop) {
+            ++m_statistics.iBlocksDropped;
+            return false;
+        }
+
+        m_condNotFull.wait(&m_mutex);
+    }
+
+    m_queueBlocks.enqueue(matData);
+
+    ++m_statistics.iQueuedBlocks;
+    m_statistics.iQueuedBytes += iBytes;
+    m_statistics.iMaxQueuedBytes = qMax(m_statistics.iMaxQueuedBytes, m_statistics.iQueuedBytes);
+
+    m_condNotEmpty.wakeOne();
+
+    return true;
+}
+
+
+//*************************************************************************************************************
+
+bool FiffRawWriter::write(const MatrixXd& matData)
+{
+    return write(MatrixXf(matData.cast<float>()));
+}
+
+
+//*************************************************************************************************************
+
+bool FiffRawWriter::close()
+{
+    {
+        QMutexLocker locker(&m_mutex);
+
+        if(!m_bOpen) {
+            return false;
+        }
+
+        m_bStop = true;
+        m_condNotEmpty.wakeAll();
+        m_condNotFull.wakeAll();
+    }
+
+    //The worker thread writes the remaining blocks before it returns
+    wait();
+
+    if(m_pStream) {
+        m_pStream->finish_writing_raw();
+        m_pStream.clear();
+    }
+
+    QMutexLocker locker(&m_mutex);
+    m_bOpen = false;
+
+    return !m_statistics.bError;
+}
+
+
+//*************************************************************************************************************
+
+bool FiffRawWriter::isOpen() const
+{
+    QMutexLocker locker(&m_mutex);
+
+    return m_bOpen;
+}
+
+
+//*************************************************************************************************************
+
+void FiffRawWriter::setMaxQueueSize(qint64 iMaxQueueSize)
+{
+    QMutexLocker locker(&m_mutex);
+
+    m_iMaxQueueSize = iMaxQueueSize;
+    m_condNotFull.wakeAll();
+}
+
+
+//*************************************************************************************************************
+
+void FiffRawWriter::setDropWhenFull(bool bDropWhenFull)
+{
+    QMutexLocker locker(&m_mutex);
+
+    m_bDropWhenFull = bDropWhenFull;
+    m_condNotFull.wakeAll();
+}
+
+
+//*************************************************************************************************************
+
+void FiffRawWriter::setMaxFileSize(qint64 iMaxFileSize)
+{
+    if(isOpen()) {
+        printf("FiffRawWriter::setMaxFileSize - The maximum file size can not be changed while a file is open.\n");
+        return;
+    }
+
+    m_iMaxFileSize = iMaxFileSize;
+}
+
+
+//*************************************************************************************************************
+
+FiffRawWriter::Statistics FiffRawWriter::statistics() const
+{
+    QMutexLocker locker(&m_mutex);
+
+    return m_statistics;
+}
+
+
+//*************************************************************************************************************
+
+QString FiffRawWriter::splitFileName(const QString& sFileName, int iSplit)
+{
+    if(iSplit <= 0) {
+        return sFileName;
+    }
+
+    if(sFileName.endsWith("_raw.fif")) {
+        return sFileName.left(sFileName.size() - 8) + QString("-%1_raw.fif").arg(iSplit);
+    }
+
+    if(sFileName.endsWith(".fif")) {
+        return sFileName.left(sFileName.size() - 4) + QString("-%1.fif").arg(iSplit);
+    }
+
+    return sFileName + QString("-%1").arg(iSplit);
+}
+
+
+//*************************************************************************************************************
+
+void FiffRawWriter::run()
+{
+    QList<MatrixXf> lBlocks;
+    QByteArray baBuffer;
+    qint64 iSamplesWritten = 0;
+
+    forever {
+        //Take all queued blocks at once, so they are written with a single call
+        {
+            QMutexLocker locker(&m_mutex);
+
+            while(m_queueBlocks.isEmpty() && !m_bStop) {
+                m_condNotEmpty.wait(&m_mutex);
+            }
+
+            if(m_queueBlocks.isEmpty()) {
+                return;
+            }
+
+            while(!m_queueBlocks.isEmpty()) {
+                lBlocks.append(m_queueBlocks.dequeue());
+            }
+
+            m_statistics.iQueuedBlocks = 0;
+            m_statistics.iQueuedBytes = 0;
+            m_condNotFull.wakeAll();
+        }
+
+        bool bError = false;
+        int iBlocksInBuffer = 0;
+        qint64 iSamplesInBuffer = 0;
+        int iBlocksWritten = 0;
+        qint64 iBytesWritten = 0;
+        baBuffer.resize(0);
+
+        for(int i = 0; i < lBlocks.size() && !bError; ++i) {
+            qint64 iTagSize = 16 + lBlocks[i].size() * 4;
+
+            //Continue in the next file if this block would exceed the maximum file size
+            if(m_iFileSize + baBuffer.size() > 0 && m_iFileSize + baBuffer.size() + iTagSize > m_iMaxFileSize) {
+                if(!writeBuffer(baBuffer)) {
+                    bError = true;
+                    break;
+                }
+
+                iBlocksWritten += iBlocksInBuffer;
+                iBytesWritten += baBuffer.size();
+                iSamplesWritten += iSamplesInBuffer;
+                iBlocksInBuffer = 0;
+                iSamplesInBuffer = 0;
+                baBuffer.resize(0);
+
+                if(!splitFile(m_iFirstSample + iSamplesWritten)) {
+                    bError = true;
+                    break;
+                }
+            }
+
+            encodeBlock(lBlocks[i], baBuffer);
+            ++iBlocksInBuffer;
+            iSamplesInBuffer += lBlocks[i].cols();
+        }
+
+        if(!bError && !baBuffer.isEmpty()) {
+            if(writeBuffer(baBuffer)) {
+                iBlocksWritten += iBlocksInBuffer;
+                iBytesWritten += baBuffer.size();
+                iSamplesWritten += iSamplesInBuffer;
+            } else {
+                bError = true;
+            }
+        }
+
+        {
+            QMutexLocker locker(&m_mutex);
+
+            m_statistics.iBlocksWritten += iBlocksWritten;
+            m_statistics.iBytesWritten += iBytesWritten;
+            m_statistics.iSamplesWritten = iSamplesWritten;
+
+            if(bError) {
+                m_statistics.bError = true;
+                m_statistics.iBlocksDropped += lBlocks.size() - iBlocksWritten;
+            }
+        }
+
+        lBlocks.clear();
+    }
+}
+
+
+//*************************************************************************************************************
+
+bool FiffRawWriter::startFile(const QString& sFileName, fiff_int_t iFirstSample, RowVectorXd& cals)
+{
+    m_file.setFileName(sFileName);
+
+    m_pStream = FiffStream::start_writing_raw(m_file, m_info, cals, defaultMatrixXi, m_bResetRange);
+
+    if(!m_pStream) {
+        printf("FiffRawWriter::startFile - Could not create %s.\n", sFileName.toUtf8().constData());
+        return false;
+    }
+
+    m_pStream->write_int(FIFF_FIRST_SAMPLE, &iFirstSample);
+    m_iFileSize = 0;
+
+    QMutexLocker locker(&m_mutex);
+    ++m_statistics.iFileCount;
+
+    return true;
+}
+
+
+//*************************************************************************************************************
+
+bool FiffRawWriter::splitFile(fiff_int_t iFirstSample)
+{
+    int iSplit;
+
+    {
+        QMutexLocker locker(&m_mutex);
+        iSplit = m_statistics.iFileCount;
+    }
+
+    QString sNextFileName = splitFileName(m_sFileName, iSplit);
+
+    //Write the link to the next file
+    fiff_int_t data;
+    m_pStream->start_block(FIFFB_REF);
+    data = FIFFV_ROLE_NEXT_FILE;
+    m_pStream->write_int(FIFF_REF_ROLE, &data);
+    m_pStream->write_string(FIFF_REF_FILE_NAME, QFileInfo(sNextFileName).fileName());
+    m_pStream->write_id(FIFF_REF_FILE_ID);
+    data = iSplit;
+    m_pStream->write_int(FIFF_REF_FILE_NUM, &data);
+    m_pStream->end_block(FIFFB_REF);
+
+    m_pStream->finish_writing_raw();
+
+    RowVectorXd cals;
+    return startFile(sNextFileName, iFirstSample, cals);
+}
+
+
+//*************************************************************************************************************
+
+void FiffRawWriter::encodeBlock(const MatrixXf& matData, QByteArray& baBuffer) const
+{
+    int iOffset = baBuffer.size();
+    qint32 iNumValues = matData.size();
+
+    baBuffer.resize(iOffset + 16 + iNumValues * 4);
+    uchar* pDest = reinterpret_cast<uchar*>(baBuffer.data() + iOffset);
+
+    //Tag header
+    qToBigEndian<qint32>(FIFF_DATA_BUFFER, pDest);
+    qToBigEndian<qint32>(FIFFT_FLOAT, pDest + 4);
+    qToBigEndian<qint32>(iNumValues * 4, pDest + 8);
+    qToBigEndian<qint32>(FIFFV_NEXT_SEQ, pDest + 12);
+    pDest += 16;
+
+    //The samples are stored one after another, each with the values of all channels
+    bool bApplyCals = m_vecInvCals.size() == matData.rows();
+    quint32 iBits;
+    float fValue;
+
+    for(int j = 0; j < matData.cols(); ++j) {
+        for(int i = 0; i < matData.rows(); ++i) {
+            fValue = bApplyCals ? matData(i,j) * m_vecInvCals[i] : matData(i,j);
+            std::memcpy(&iBits, &fValue, sizeof(float));
+            qToBigEndian<quint32>(iBits, pDest);
+            pDest += 4;
+        }
+    }
+}
+
+
+//*************************************************************************************************************
+
+bool FiffRawWriter::writeBuffer(const QByteArray& baBuffer)
+{
+    if(m_pStream->device()->write(baBuffer) != baBuffer.size()) {
+        printf("FiffRawWriter::writeBuffer - Could not write to %s.\n", m_file.fileName().toUtf8().constData());
+        return false;
+    }
+
+    m_iFileSize += baBuffer.size();
+
+    return true;
+}
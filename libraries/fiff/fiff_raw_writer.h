@@ -0,0 +1,303 @@
+//=============================================================================================================
+/**
+* @file     fiff_raw_writer.h
+* @author   agent <agent@local>
+* @version  1.0
+* @date     October, 2026
+*
+* @section  LICENSE
+*
+* Copyright (C) 2026, agent. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+*
+* @brief    FiffRawWriter class declaration.
+*
+*/
+
+#ifndef FIFF_RAW_WRITER_H
+#define FIFF_RAW_WRITER_H
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "fiff_global.h"
+#include "fiff_info.h"
+#include "fiff_stream.h"
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// Eigen INCLUDES
+//=============================================================================================================
+
+#include <Eigen/Core>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// Qt INCLUDES
+//=============================================================================================================
+
+#include <QFile>
+#include <QMutex>
+#include <QQueue>
+#include <QSharedPointer>
+#include <QThread>
+#include <QWaitCondition>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE NAMESPACE FIFFLIB
+//=============================================================================================================
+
+namespace FIFFLIB
+{
+
+
+//=============================================================================================================
+/**
+* FiffRawWriter writes raw data blocks to a fif file from a worker thread, so that acquisition threads do not
+* block on disk I/O. Blocks are kept in a queue which is bounded by a memory budget. When the queue is full,
+* write() waits until the worker thread took the queued blocks, so no data is lost. Dropping blocks instead can be
+* enabled with setDropWhenFull. Dropped blocks are not marked in the file, so the samples after them are shifted in
+* time. Callers which enable it should report statistics().iBlocksDropped. The worker thread encodes the
+* FIFF_DATA_BUFFER tags of all queued blocks into one buffer and writes it at once. When a file would exceed
+* the maximum file size, the writer links the next file via a FIFFB_REF block and continues in a new file
+* named <name>-<n>_raw.fif.
+*
+* @brief Asynchronous writer for fif raw data files.
+*/
+class FIFFSHARED_EXPORT FiffRawWriter : public QThread
+{
+    Q_OBJECT
+
+public:
+    typedef QSharedPointer<FiffRawWriter> SPtr;             /**< Shared pointer type for FiffRawWriter. */
+    typedef QSharedPointer<const FiffRawWriter> ConstSPtr;  /**< Const shared pointer type for FiffRawWriter. */
+
+    //=========================================================================================================
+    /**
+    * The writer statistics.
+    */
+    struct Statistics {
+        qint64  iBlocksWritten;     /**< Number of blocks written to file. */
+        qint64  iBlocksDropped;     /**< Number of blocks dropped because the queue was full or writing failed. */
+        qint64  iSamplesWritten;    /**< Number of samples (columns) written to file. */
+        qint64  iBytesWritten;      /**< Number of bytes of data buffer tags written to file. */
+        int     iQueuedBlocks;      /**< Number of blocks currently waiting in the queue. */
+        qint64  iQueuedBytes;       /**< Number of bytes currently waiting in the queue. */
+        qint64  iMaxQueuedBytes;    /**< Maximum number of bytes which were waiting in the queue at once. */
+        int     iFileCount;         /**< Number of files which were started. */
+        bool    bError;             /**< Whether writing to file failed. */
+    };
+
+    //=========================================================================================================
+    /**
+    * Constructs a FiffRawWriter.
+    *
+    * @param[in] parent     Parent QObject (optional).
+    */
+    explicit FiffRawWriter(QObject *parent = 0);
+
+    //=========================================================================================================
+    /**
+    * Destroys the FiffRawWriter. An open file is finished.
+    */
+    ~FiffRawWriter();
+
+    //=========================================================================================================
+    /**
+    * Creates the file, writes the measurement info and starts the worker thread.
+    *
+    * @param[in] sFileName      The name of the fif file to write.
+    * @param[in] info           The measurement info to write.
+    * @param[in] iFirstSample   The first sample of the recording.
+    * @param[in] bApplyCals     Whether the blocks are divided by the channel calibrations before they are written.
+    * @param[in] bResetRange    Whether the channel ranges are reset to 1.0, see FiffStream::start_writing_raw.
+    *
+    * @return true if the file was created.
+    */
+    bool open(const QString& sFileName,
+              const FiffInfo& info,
+              fiff_int_t iFirstSample = 0,
+              bool bApplyCals = false,
+              bool bResetRange = true);
+
+    //=========================================================================================================
+    /**
+    * Queues a data block (channels x samples) for writing. Waits while the queue is full, unless
+    * setDropWhenFull was enabled.
+    *
+    * @param[in] matData    The data block.
+    *
+    * @return true if the block was queued, false if it was dropped or no file is open.
+    */
+    bool write(const Eigen::MatrixXf& matData);
+
+    //=========================================================================================================
+    /**
+    * Queues a data block (channels x samples) for writing. The data is stored in single precision, as it is
+    * written to file.
+    *
+    * @param[in] matData    The data block.
+    *
+    * @return true if the block was queued, false if it was dropped or no file is open.
+    */
+    bool write(const Eigen::MatrixXd& matData);
+
+    //=========================================================================================================
+    /**
+    * Writes all queued blocks, finishes the current file and stops the worker thread.
+    *
+    * @return true if all blocks were written without errors.
+    */
+    bool close();
+
+    //=========================================================================================================
+    /**
+    * Returns whether a file is open.
+    *
+    * @return true if a file is open.
+    */
+    bool isOpen() const;
+
+    //=========================================================================================================
+    /**
+    * Sets the maximum number of bytes held by the queue. Default is 256 MB.
+    *
+    * @param[in] iMaxQueueSize  The maximum queue size in bytes.
+    */
+    void setMaxQueueSize(qint64 iMaxQueueSize);
+
+    //=========================================================================================================
+    /**
+    * Sets whether blocks are dropped when the queue is full. Otherwise write() waits until there is space in
+    * the queue. Default is false. Dropped blocks leave a gap which is not marked in the file.
+    *
+    * @param[in] bDropWhenFull  Whether to drop blocks when the queue is full.
+    */
+    void setDropWhenFull(bool bDropWhenFull);
+
+    //=========================================================================================================
+    /**
+    * Sets the maximum number of data bytes in a single file, after which the recording continues in the next
+    * file. Default is 2,000,000,000 bytes, which leaves room for the measurement info below the 2 GB fif limit.
+    * Must be set before open().
+    *
+    * @param[in] iMaxFileSize   The maximum number of data bytes per file.
+    */
+    void setMaxFileSize(qint64 iMaxFileSize);
+
+    //=========================================================================================================
+    /**
+    * Returns the current statistics.
+    *
+    * @return the statistics.
+    */
+    Statistics statistics() const;
+
+    //=========================================================================================================
+    /**
+    * Returns the name of the file the n-th split of the recording is written to.
+    *
+    * @param[in] sFileName  The name of the first file.
+    * @param[in] iSplit     The split number, 0 for the first file.
+    *
+    * @return the file name.
+    */
+    static QString splitFileName(const QString& sFileName, int iSplit);
+
+protected:
+    //=========================================================================================================
+    /**
+    * The worker thread, which writes the queued blocks.
+    */
+    virtual void run();
+
+private:
+    //=========================================================================================================
+    /**
+    * Starts a new file and writes the measurement info and the first sample.
+    *
+    * @param[in] sFileName      The name of the file.
+    * @param[in] iFirstSample   The first sample of the file.
+    * @param[out] cals          The channel calibrations.
+    *
+    * @return true if the file was created.
+    */
+    bool startFile(const QString& sFileName, fiff_int_t iFirstSample, Eigen::RowVectorXd& cals);
+
+    //=========================================================================================================
+    /**
+    * Links the next file, finishes the current file and starts the next one.
+    *
+    * @param[in] iFirstSample   The first sample of the next file.
+    *
+    * @return true if the next file was created.
+    */
+    bool splitFile(fiff_int_t iFirstSample);
+
+    //=========================================================================================================
+    /**
+    * Appends the FIFF_DATA_BUFFER tag of a block to a buffer, in big endian byte order.
+    *
+    * @param[in] matData        The data block.
+    * @param[in, out] baBuffer  The buffer to append to.
+    */
+    void encodeBlock(const Eigen::MatrixXf& matData, QByteArray& baBuffer) const;
+
+    //=========================================================================================================
+    /**
+    * Writes an encoded buffer to the current file.
+    *
+    * @param[in] baBuffer   The buffer.
+    *
+    * @return true if the buffer was written completely.
+    */
+    bool writeBuffer(const QByteArray& baBuffer);
+
+    mutable QMutex              m_mutex;                /**< Guards the queue and the statistics. */
+    QWaitCondition              m_condNotEmpty;         /**< Signaled when a block was queued or the writer is closed. */
+    QWaitCondition              m_condNotFull;          /**< Signaled when blocks were taken from the queue. */
+    QQueue<Eigen::MatrixXf>     m_queueBlocks;          /**< The queued blocks. */
+    bool                        m_bOpen;                /**< Whether a file is open. */
+    bool                        m_bStop;                /**< Whether the worker thread should stop once the queue is empty. */
+    bool                        m_bDropWhenFull;        /**< Whether blocks are dropped when the queue is full. */
+    qint64                      m_iMaxQueueSize;        /**< The maximum number of bytes held by the queue. */
+    qint64                      m_iMaxFileSize;         /**< The maximum number of data bytes in a single file. */
+    Statistics                  m_statistics;           /**< The statistics. */
+
+    QFile                       m_file;                 /**< The current file. Only accessed by the worker thread while it is running. */
+    FiffStream::SPtr            m_pStream;              /**< The stream of the current file. Only accessed by the worker thread while it is running. */
+    FiffInfo                    m_info;                 /**< The measurement info written to every file. */
+    QString                     m_sFileName;            /**< The name of the first file. */
+    Eigen::RowVectorXf          m_vecInvCals;           /**< The inverse calibrations, empty if the blocks are written as they are. */
+    fiff_int_t                  m_iFirstSample;         /**< The first sample of the recording. */
+    bool                        m_bResetRange;          /**< Whether the channel ranges are reset to 1.0 in every file. */
+    qint64                      m_iFileSize;            /**< The number of data bytes written to the current file. */
+};
+
+} // NAMESPACE
+
+#endif // FIFF_RAW_WRITER_H
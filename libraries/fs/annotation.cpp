@@ -43,6 +43,8 @@
 #include "label.h"
 #include "surface.h"
 
+#include <utils/mappedfilereader.h>
+
 
 //*************************************************************************************************************
 //=============================================================================================================
@@ -58,8 +60,6 @@
 //=============================================================================================================
 
 #include <QDebug>
-#include <QFile>
-#include <QDataStream>
 #include <QFileInfo>
 
 
@@ -69,6 +69,7 @@
 //=============================================================================================================
 
 using namespace FSLIB;
+using namespace UTILSLIB;
 
 
 //*************************************************************************************************************
@@ -170,52 +171,53 @@ bool Annotation::read(const QString& p_sFileName, Annotation &p_Annotation)
     p_Annotation.clear();
 
     printf("Reading annotation...\n");
-    QFile t_File(p_sFileName);
-    QFileInfo fileInfo(t_File.fileName());
+    MappedFileReader t_Reader(p_sFileName);
+    QFileInfo fileInfo(p_sFileName);
 
     p_Annotation.m_sFileName = fileInfo.fileName();
     p_Annotation.m_sFilePath = fileInfo.filePath();
 
-    if (!t_File.open(QIODevice::ReadOnly))
+    if (!t_Reader.isOpen())
     {
         printf("\tError: Couldn't open the file\n");
         return false;
     }
 
-    QDataStream t_Stream(&t_File);
-    t_Stream.setByteOrder(QDataStream::BigEndian);
-
-    qint32 numEl;
-    t_Stream >> numEl;
+    qint32 numEl = 0;
+    t_Reader.readInt32(numEl);
 
-    p_Annotation.m_Vertices = VectorXi(numEl);
-    p_Annotation.m_LabelIds = VectorXi(numEl);
-
-    for(qint32 i = 0; i < numEl; ++i)
+    if(numEl < 0 || 8 * qint64(numEl) > t_Reader.size() - t_Reader.pos())
     {
-        t_Stream >> p_Annotation.m_Vertices[i];
-        t_Stream >> p_Annotation.m_LabelIds[i];
+        printf("\tError: The annotation file is too short\n");
+        return false;
     }
 
-    qint32 hasColortable;
-    t_Stream >> hasColortable;
+    //Vertices and label ids are stored interleaved, decode them in one pass and split afterwards
+    Matrix<qint32, Dynamic, 2, RowMajor> matVertLabel(numEl, 2);
+    t_Reader.readInt32Array(matVertLabel.data(), 2 * qint64(numEl));
+
+    p_Annotation.m_Vertices = matVertLabel.col(0);
+    p_Annotation.m_LabelIds = matVertLabel.col(1);
+
+    qint32 hasColortable = 0;
+    t_Reader.readInt32(hasColortable);
     if (hasColortable)
     {
         p_Annotation.m_Colortable.clear();
 
         //Read colortable
         qint32 numEntries;
-        t_Stream >> numEntries;
+        t_Reader.readInt32(numEntries);
         qint32 len;
         if(numEntries > 0)
         {
 
             printf("\tReading from Original Version\n");
             p_Annotation.m_Colortable.numEntries = numEntries;
-            t_Stream >> len;
+            t_Reader.readInt32(len);
             QByteArray tmp;
             tmp.resize(len);
-            t_Stream.readRawData(tmp.data(),len);
+            t_Reader.readRaw(tmp.data(),len);
             p_Annotation.m_Colortable.orig_tab = tmp;
 
             for(qint32 i = 0; i < numEntries; ++i)
@@ -225,14 +227,14 @@ bool Annotation::read(const QString& p_sFileName, Annotation &p_Annotation)
 
             for(qint32 i = 0; i < numEntries; ++i)
             {
-                t_Stream >> len;
+                t_Reader.readInt32(len);
                 tmp.resize(len);
-                t_Stream.readRawData(tmp.data(),len);
+                t_Reader.readRaw(tmp.data(),len);
 
                 p_Annotation.m_Colortable.struct_names[i]= tmp;
 
                 for(qint32 j = 0; j < 4; ++j)
-                    t_Stream >> p_Annotation.m_Colortable.table(i,j);
+                    t_Reader.readInt32(p_Annotation.m_Colortable.table(i,j));
 
                 p_Annotation.m_Colortable.table(i,4) = p_Annotation.m_Colortable.table(i,0)
                         + p_Annotation.m_Colortable.table(i,1) * 256       //(2^8)
@@ -248,13 +250,13 @@ bool Annotation::read(const QString& p_sFileName, Annotation &p_Annotation)
             else
                 printf("\tReading from version %d\n", version);
 
-            t_Stream >> numEntries;
+            t_Reader.readInt32(numEntries);
             p_Annotation.m_Colortable.numEntries = numEntries;
 
-            t_Stream >> len;
+            t_Reader.readInt32(len);
             QByteArray tmp;
             tmp.resize(len);
-            t_Stream.readRawData(tmp.data(),len);
+            t_Reader.readRaw(tmp.data(),len);
             p_Annotation.m_Colortable.orig_tab = tmp;
 
             for(qint32 i = 0; i < numEntries; ++i)
@@ -263,27 +265,27 @@ bool Annotation::read(const QString& p_sFileName, Annotation &p_Annotation)
             p_Annotation.m_Colortable.table = MatrixXi(numEntries,5);
 
             qint32 numEntriesToRead;
-            t_Stream >> numEntriesToRead;
+            t_Reader.readInt32(numEntriesToRead);
 
             qint32 structure;
             for(qint32 i = 0; i < numEntriesToRead; ++i)
             {
 
-                t_Stream >> structure;
+                t_Reader.readInt32(structure);
                 if (structure < 0)
                     printf("\tError! Read entry, index %d\n", structure);
 
                 if(!p_Annotation.m_Colortable.struct_names[structure].isEmpty())
                     printf("Error! Duplicate Structure %d", structure);
 
-                t_Stream >> len;
+                t_Reader.readInt32(len);
                 tmp.resize(len);
-                t_Stream.readRawData(tmp.data(),len);
+                t_Reader.readRaw(tmp.data(),len);
 
                 p_Annotation.m_Colortable.struct_names[structure]= tmp;
 
                 for(qint32 j = 0; j < 4; ++j)
-                    t_Stream >> p_Annotation.m_Colortable.table(structure,j);
+                    t_Reader.readInt32(p_Annotation.m_Colortable.table(structure,j));
 
                 p_Annotation.m_Colortable.table(structure,4) = p_Annotation.m_Colortable.table(structure,0)
                         + p_Annotation.m_Colortable.table(structure,1) * 256       //(2^8)
@@ -299,15 +301,13 @@ bool Annotation::read(const QString& p_sFileName, Annotation &p_Annotation)
     }
 
     // hemi info
-    if(t_File.fileName().contains("lh."))
+    if(p_sFileName.contains("lh."))
         p_Annotation.m_iHemi = 0;
     else
         p_Annotation.m_iHemi = 1;
 
     printf("[done]\n");
 
-    t_File.close();
-
     return true;
 }
 
@@ -39,9 +39,10 @@
 //=============================================================================================================
 
 #include "surface.h"
-#include <utils/ioutils.h>
+#include <utils/mappedfilereader.h>
 
 #include <iostream>
+#include <cstring>
 
 
 //*************************************************************************************************************
@@ -50,7 +51,11 @@
 //=============================================================================================================
 
 #include <QFile>
-#include <QDataStream>
+#include <QFileInfo>
+#include <QDir>
+#include <QDateTime>
+#include <QSaveFile>
+#include <QCryptographicHash>
 #include <QTextStream>
 
 
@@ -63,6 +68,43 @@ using namespace UTILSLIB;
 using namespace FSLIB;
 
 
+//*************************************************************************************************************
+//=============================================================================================================
+// LOCAL DEFINITIONS
+//=============================================================================================================
+
+namespace {
+
+const char SURFACE_CACHE_MAGIC[8] = {'M','N','E','S','U','R','F','1'};  /**< Identifies surface cache files and their version. */
+const quint32 SURFACE_CACHE_BYTE_ORDER = 0x01020304;                   /**< Reads differently on hosts with another byte order. */
+
+//=============================================================================================================
+/**
+* Header of a surface cache file. It is followed by the vertices, triangles and normals in the native byte order
+* and the column-major layout of the Eigen matrices.
+*/
+struct SurfaceCacheHeader {
+    char    magic[8];           /**< SURFACE_CACHE_MAGIC. */
+    quint32 byteOrder;          /**< SURFACE_CACHE_BYTE_ORDER as written by the host. */
+    qint32  nvert;              /**< Number of vertices. */
+    qint32  ntri;               /**< Number of triangles. */
+    qint32  reserved;           /**< Padding, zero. */
+    qint64  sourceSize;         /**< Size of the surface file in bytes. */
+    qint64  sourceModified;     /**< Modification time of the surface file in ms since epoch. */
+};
+
+}
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INITIALIZE STATIC MEMBER
+//=============================================================================================================
+
+QString Surface::s_sCacheDir;
+QMutex Surface::s_cacheMutex;
+
+
 //*************************************************************************************************************
 //=============================================================================================================
 // DEFINE MEMBER METHODS
@@ -223,9 +265,9 @@ bool Surface::read(const QString &p_sFile, Surface &p_Surface, bool p_bLoadCurva
 {
     p_Surface.clear();
 
-    QFile t_File(p_sFile);
+    QFileInfo t_FileInfo(p_sFile);
 
-    if (!t_File.open(QIODevice::ReadOnly))
+    if (!t_FileInfo.exists())
     {
         printf("\tError: Couldn't open the surface file\n");
         return false;
@@ -245,8 +287,138 @@ bool Surface::read(const QString &p_sFile, Surface &p_Surface, bool p_bLoadCurva
     p_Surface.m_sFilePath = p_sFile.mid(0,t_NameIdx);
     p_Surface.m_sFileName = p_sFile.mid(t_NameIdx,p_sFile.size()-t_NameIdx);
 
-    QDataStream t_DataStream(&t_File);
-    t_DataStream.setByteOrder(QDataStream::BigEndian);
+    QString t_sCacheFile = cacheFileName(t_FileInfo);
+
+    if(!t_sCacheFile.isEmpty() && readCache(t_sCacheFile, t_FileInfo, p_Surface))
+    {
+        printf("\tRead %s from cache %s\n", p_sFile.toUtf8().constData(), t_sCacheFile.toUtf8().constData());
+    }
+    else
+    {
+        if(!readGeometry(p_sFile, p_Surface))
+            return false;
+
+        //-> not needed since qglbuilder is doing that for us
+        p_Surface.m_matNN = compute_normals(p_Surface.m_matRR, p_Surface.m_matTris);
+
+        if(!t_sCacheFile.isEmpty())
+            writeCache(t_sCacheFile, t_FileInfo, p_Surface);
+    }
+
+    // hemi info
+    if(t_FileInfo.fileName().contains("lh."))
+        p_Surface.m_iHemi = 0;
+    else if(t_FileInfo.fileName().contains("rh."))
+        p_Surface.m_iHemi = 1;
+    else
+    {
+        p_Surface.m_iHemi = -1;
+        return false;
+    }
+
+    //Loaded surface
+    p_Surface.m_sSurf = p_sFile.mid((t_NameIdx+3),p_sFile.size() - (t_NameIdx+3));
+
+    //Load curvature
+    if(p_bLoadCurvature)
+    {
+        QString t_sCurvatureFile = QString("%1%2.curv").arg(p_Surface.m_sFilePath).arg(p_Surface.m_iHemi == 0 ? "lh" : "rh");
+        printf("\t");
+        p_Surface.m_vecCurv = Surface::read_curv(t_sCurvatureFile);
+    }
+
+    printf("\tRead a surface with %d vertices from %s\n[done]\n",(int)p_Surface.m_matRR.rows(),p_sFile.toUtf8().constData());
+
+    return true;
+}
+
+
+//*************************************************************************************************************
+
+VectorXf Surface::read_curv(const QString &p_sFileName)
+{
+    VectorXf curv;
+
+    printf("Reading curvature...");
+    MappedFileReader t_Reader(p_sFileName);
+
+    if (!t_Reader.isOpen())
+    {
+        printf("\tError: Couldn't open the curvature file\n");
+        return curv;
+    }
+
+    qint32 vnum = 0;
+    t_Reader.readInt24(vnum);
+    qint32 NEW_VERSION_MAGIC_NUMBER = 16777215;
+
+    if(vnum == NEW_VERSION_MAGIC_NUMBER)
+    {
+        qint32 fnum, vals_per_vertex;
+        if(!t_Reader.readInt32(vnum) || !t_Reader.readInt32(fnum) || !t_Reader.readInt32(vals_per_vertex))
+        {
+            printf("\tError: The curvature file is too short\n");
+            return VectorXf();
+        }
+
+        curv.resize(vnum, 1);
+        if(!t_Reader.readFloatArray(curv.data(), vnum))
+        {
+            printf("\tError: The curvature file is too short\n");
+            return VectorXf();
+        }
+    }
+    else
+    {
+        qint32 fnum = 0;
+        t_Reader.readInt24(fnum);
+        Q_UNUSED(fnum)
+
+        Matrix<qint16, Dynamic, 1> vecVals(vnum);
+        if(!t_Reader.readInt16Array(vecVals.data(), vnum))
+        {
+            printf("\tError: The curvature file is too short\n");
+            return VectorXf();
+        }
+
+        curv = vecVals.cast<float>() / 100;
+    }
+
+    printf("[done]\n");
+
+    return curv;
+}
+
+
+//*************************************************************************************************************
+
+void Surface::setCacheDir(const QString &p_sCacheDir)
+{
+    QMutexLocker locker(&s_cacheMutex);
+    s_sCacheDir = p_sCacheDir;
+}
+
+
+//*************************************************************************************************************
+
+QString Surface::cacheDir()
+{
+    QMutexLocker locker(&s_cacheMutex);
+    return s_sCacheDir;
+}
+
+
+//*************************************************************************************************************
+
+bool Surface::readGeometry(const QString &p_sFile, Surface &p_Surface)
+{
+    MappedFileReader t_Reader(p_sFile);
+
+    if (!t_Reader.isOpen())
+    {
+        printf("\tError: Couldn't open the surface file\n");
+        return false;
+    }
 
     //
     //   Magic numbers to identify QUAD and TRIANGLE files
@@ -258,18 +430,20 @@ bool Surface::read(const QString &p_sFile, Surface &p_Surface, bool p_bLoadCurva
     qint32 TRIANGLE_FILE_MAGIC_NUMBER =  16777214;
     qint32 QUAD_FILE_MAGIC_NUMBER     =  16777215;
 
-    qint32 magic = IOUtils::fread3(t_DataStream);
+    qint32 magic = 0;
+    t_Reader.readInt24(magic);
 
     qint32 nvert = 0;
     qint32 nquad = 0;
     qint32 nface = 0;
-    MatrixXf verts;
-    MatrixXi faces;
+    Matrix<float, Dynamic, 3, RowMajor> verts;
+    Matrix<int, Dynamic, 3, RowMajor> faces;
+    bool t_bComplete = true;
 
     if(magic == QUAD_FILE_MAGIC_NUMBER || magic == NEW_QUAD_FILE_MAGIC_NUMBER)
     {
-        nvert = IOUtils::fread3(t_DataStream);
-        nquad = IOUtils::fread3(t_DataStream);
+        t_Reader.readInt24(nvert);
+        t_Reader.readInt24(nquad);
         if(magic == QUAD_FILE_MAGIC_NUMBER)
             printf("\t%s is a quad file (nvert = %d nquad = %d)\n", p_sFile.toUtf8().constData(),nvert,nquad);
         else
@@ -279,44 +453,25 @@ bool Surface::read(const QString &p_sFile, Surface &p_Surface, bool p_bLoadCurva
         verts.resize(nvert, 3);
         if(magic == QUAD_FILE_MAGIC_NUMBER)
         {
-            qint16 iVal;
-            for(qint32 i = 0; i < nvert; ++i)
-            {
-                for(qint32 j = 0; j < 3; ++j)
-                {
-                    t_DataStream >> iVal;
-                    IOUtils::swap_short(iVal);
-                    verts(i,j) = ((float)iVal) / 100;
-                }
-            }
+            Matrix<qint16, Dynamic, 3, RowMajor> iVerts(nvert, 3);
+            t_bComplete = t_Reader.readInt16Array(iVerts.data(), 3 * qint64(nvert));
+            verts = iVerts.cast<float>() / 100;
         }
         else
         {
-            t_DataStream.readRawData((char *)verts.data(), nvert*3*sizeof(float));
-            for(qint32 i = 0; i < nvert; ++i)
-                for(qint32 j = 0; j < 3; ++j)
-                    IOUtils::swap_floatp(&verts(i,j));
+            t_bComplete = t_Reader.readFloatArray(verts.data(), 3 * qint64(nvert));
         }
 
-        MatrixXi quads = IOUtils::fread3_many(t_DataStream, nquad*4);
-        MatrixXi quads_new(4, nquad);
-        qint32 count = 0;
-        for(qint32 j = 0; j < quads.cols(); ++j)
-        {
-            for(qint32 i = 0; i < quads.rows(); ++i)
-            {
-                quads_new(i,j) = quads(count, 0);
-                ++count;
-            }
-        }
-        quads = quads_new.transpose();
+        Matrix<int, Dynamic, 4, RowMajor> quads(nquad, 4);
+        t_bComplete = t_bComplete && t_Reader.readInt24Array(quads.data(), 4 * qint64(nquad));
+
         //
         //  Face splitting follows
         //
-        faces = MatrixXi::Zero(2*nquad,3);
+        faces = Matrix<int, Dynamic, 3, RowMajor>::Zero(2*nquad,3);
         for(qint32 k = 0; k < nquad; ++k)
         {
-            RowVectorXi quad = quads.row(k);
+            RowVector4i quad = quads.row(k);
             if ((quad[0] % 2) == 0)
             {
                 faces(nface,0) = quad[0];
@@ -345,36 +500,28 @@ bool Surface::read(const QString &p_sFile, Surface &p_Surface, bool p_bLoadCurva
     }
     else if(magic == TRIANGLE_FILE_MAGIC_NUMBER)
     {
-        QString s = t_File.readLine();
-        t_File.readLine();
+        QString s = t_Reader.readLine();
+        t_Reader.readLine();
 
-        t_DataStream >> nvert;
-        t_DataStream >> nface;
-        IOUtils::swap_int(nvert);
-        IOUtils::swap_int(nface);
+        t_Reader.readInt32(nvert);
+        t_Reader.readInt32(nface);
 
         printf("\t%s is a triangle file (nvert = %d ntri = %d)\n", p_sFile.toUtf8().constData(), nvert, nface);
         printf("\t%s", s.toUtf8().constData());
 
+        if(nvert < 0 || nface < 0 || 12 * (qint64(nvert) + qint64(nface)) > t_Reader.size() - t_Reader.pos())
+        {
+            qWarning("Surface file %s is too short",p_sFile.toUtf8().constData());
+            return false;
+        }
+
         //vertices
-        verts.resize(3, nvert);
-        t_DataStream.readRawData((char *)verts.data(), nvert*3*sizeof(float));
-        for(qint32 i = 0; i < 3; ++i)
-            for(qint32 j = 0; j < nvert; ++j)
-                IOUtils::swap_floatp(&verts(i,j));
+        verts.resize(nvert, 3);
+        t_bComplete = t_Reader.readFloatArray(verts.data(), 3 * qint64(nvert));
 
         //faces
         faces.resize(nface, 3);
-        qint32 iVal;
-        for(qint32 i = 0; i < nface; ++i)
-        {
-            for(qint32 j = 0; j < 3; ++j)
-            {
-                t_DataStream >> iVal;
-                IOUtils::swap_int(iVal);
-                faces(i,j) = iVal;
-            }
-        }
+        t_bComplete = t_bComplete && t_Reader.readInt32Array(faces.data(), 3 * qint64(nface));
     }
     else
     {
@@ -382,94 +529,100 @@ bool Surface::read(const QString &p_sFile, Surface &p_Surface, bool p_bLoadCurva
         return false;
     }
 
-    verts.transposeInPlace();
-    verts.array() *= 0.001f;
-
-    p_Surface.m_matRR = verts.block(0,0,verts.rows(),3);
-    p_Surface.m_matTris = faces.block(0,0,faces.rows(),3);
-
-    //-> not needed since qglbuilder is doing that for us
-    p_Surface.m_matNN = compute_normals(p_Surface.m_matRR, p_Surface.m_matTris);
-
-    // hemi info
-    if(t_File.fileName().contains("lh."))
-        p_Surface.m_iHemi = 0;
-    else if(t_File.fileName().contains("rh."))
-        p_Surface.m_iHemi = 1;
-    else
+    if(!t_bComplete)
     {
-        p_Surface.m_iHemi = -1;
+        qWarning("Surface file %s is too short",p_sFile.toUtf8().constData());
         return false;
     }
 
-    //Loaded surface
-    p_Surface.m_sSurf = t_File.fileName().mid((t_NameIdx+3),t_File.fileName().size() - (t_NameIdx+3));
+    p_Surface.m_matRR = verts * 0.001f;
+    p_Surface.m_matTris = faces;
 
-    //Load curvature
-    if(p_bLoadCurvature)
-    {
-        QString t_sCurvatureFile = QString("%1%2.curv").arg(p_Surface.m_sFilePath).arg(p_Surface.m_iHemi == 0 ? "lh" : "rh");
-        printf("\t");
-        p_Surface.m_vecCurv = Surface::read_curv(t_sCurvatureFile);
-    }
+    return true;
+}
 
-    t_File.close();
-    printf("\tRead a surface with %d vertices from %s\n[done]\n",nvert,p_sFile.toUtf8().constData());
 
-    return true;
+//*************************************************************************************************************
+
+QString Surface::cacheFileName(const QFileInfo &p_FileInfo)
+{
+    QString t_sCacheDir = cacheDir();
+
+    if(t_sCacheDir.isEmpty())
+        return QString();
+
+    //One cache file per source file, independent of the working directory
+    QByteArray t_Hash = QCryptographicHash::hash(p_FileInfo.absoluteFilePath().toUtf8(), QCryptographicHash::Md5).toHex();
+
+    return QString("%1/%2-%3.surfcache").arg(t_sCacheDir).arg(p_FileInfo.fileName()).arg(QString::fromLatin1(t_Hash));
 }
 
 
 //*************************************************************************************************************
 
-VectorXf Surface::read_curv(const QString &p_sFileName)
+bool Surface::readCache(const QString &p_sCacheFile, const QFileInfo &p_FileInfo, Surface &p_Surface)
 {
-    VectorXf curv;
+    MappedFileReader t_Reader(p_sCacheFile);
 
-    printf("Reading curvature...");
-    QFile t_File(p_sFileName);
+    if(!t_Reader.isOpen())
+        return false;
 
-    if (!t_File.open(QIODevice::ReadOnly))
-    {
-        printf("\tError: Couldn't open the curvature file\n");
-        return curv;
-    }
+    SurfaceCacheHeader t_Header;
+    if(!t_Reader.readRaw(&t_Header, sizeof(t_Header)))
+        return false;
 
-    QDataStream t_DataStream(&t_File);
-    t_DataStream.setByteOrder(QDataStream::BigEndian);
+    //The cache is stale if the source changed since it was written
+    if(memcmp(t_Header.magic, SURFACE_CACHE_MAGIC, sizeof(t_Header.magic)) != 0
+       || t_Header.byteOrder != SURFACE_CACHE_BYTE_ORDER
+       || t_Header.sourceSize != p_FileInfo.size()
+       || t_Header.sourceModified != p_FileInfo.lastModified().toMSecsSinceEpoch()
+       || t_Header.nvert < 0 || t_Header.ntri < 0)
+        return false;
 
-    qint32 vnum = IOUtils::fread3(t_DataStream);
-    qint32 NEW_VERSION_MAGIC_NUMBER = 16777215;
+    MatrixX3f rr(t_Header.nvert, 3);
+    MatrixX3i tris(t_Header.ntri, 3);
+    MatrixX3f nn(t_Header.nvert, 3);
 
-    if(vnum == NEW_VERSION_MAGIC_NUMBER)
-    {
-        qint32 fnum, vals_per_vertex;
-        t_DataStream >> vnum;
+    if(!t_Reader.readRaw(rr.data(), rr.size() * sizeof(float))
+       || !t_Reader.readRaw(tris.data(), tris.size() * sizeof(int))
+       || !t_Reader.readRaw(nn.data(), nn.size() * sizeof(float)))
+        return false;
 
-        t_DataStream >> fnum;
-        t_DataStream >> vals_per_vertex;
+    p_Surface.m_matRR = rr;
+    p_Surface.m_matTris = tris;
+    p_Surface.m_matNN = nn;
 
-        curv.resize(vnum, 1);
-        t_DataStream.readRawData((char *)curv.data(), vnum*sizeof(float));
-        for(qint32 i = 0; i < vnum; ++i)
-           IOUtils::swap_floatp(&curv(i));
-    }
-    else
+    return true;
+}
+
+
+//*************************************************************************************************************
+
+bool Surface::writeCache(const QString &p_sCacheFile, const QFileInfo &p_FileInfo, const Surface &p_Surface)
+{
+    QDir().mkpath(QFileInfo(p_sCacheFile).absolutePath());
+
+    //Write to a temporary file first, so concurrent readers never see a partial cache
+    QSaveFile t_File(p_sCacheFile);
+    if(!t_File.open(QIODevice::WriteOnly))
     {
-        qint32 fnum = IOUtils::fread3(t_DataStream);
-        Q_UNUSED(fnum)
-        qint16 iVal;
-        curv.resize(vnum, 1);
-        for(qint32 i = 0; i < vnum; ++i)
-        {
-            t_DataStream >> iVal;
-            IOUtils::swap_short(iVal);
-            curv(i) = ((float)iVal) / 100;
-        }
+        printf("\tWarning: Couldn't write the surface cache %s\n", p_sCacheFile.toUtf8().constData());
+        return false;
     }
-    t_File.close();
 
-    printf("[done]\n");
-
-    return curv;
+    SurfaceCacheHeader t_Header;
+    memset(&t_Header, 0, sizeof(t_Header));
+    memcpy(t_Header.magic, SURFACE_CACHE_MAGIC, sizeof(t_Header.magic));
+    t_Header.byteOrder = SURFACE_CACHE_BYTE_ORDER;
+    t_Header.sourceSize = p_FileInfo.size();
+    t_Header.sourceModified = p_FileInfo.lastModified().toMSecsSinceEpoch();
+    t_Header.nvert = p_Surface.m_matRR.rows();
+    t_Header.ntri = p_Surface.m_matTris.rows();
+
+    t_File.write(reinterpret_cast<const char*>(&t_Header), sizeof(t_Header));
+    t_File.write(reinterpret_cast<const char*>(p_Surface.m_matRR.data()), p_Surface.m_matRR.size() * sizeof(float));
+    t_File.write(reinterpret_cast<const char*>(p_Surface.m_matTris.data()), p_Surface.m_matTris.size() * sizeof(int));
+    t_File.write(reinterpret_cast<const char*>(p_Surface.m_matNN.data()), p_Surface.m_matNN.size() * sizeof(float));
+
+    return t_File.commit();
 }
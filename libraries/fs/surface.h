@@ -50,6 +50,8 @@
 //=============================================================================================================
 
 #include <QSharedPointer>
+#include <QMutex>
+#include <QFileInfo>
 
 
 //*************************************************************************************************************
@@ -222,6 +224,25 @@ public:
     */
     static VectorXf read_curv(const QString &p_sFileName);
 
+    //=========================================================================================================
+    /**
+    * Sets the directory in which read() keeps a native binary copy of each surface file it parsed, together with
+    * the computed normals. Later reads of an unchanged surface load this copy instead of decoding the FreeSurfer
+    * file. A cache entry is discarded when the size or the modification time of the surface file changes.
+    * An empty directory, which is the default, disables the cache.
+    *
+    * @param[in] p_sCacheDir    The cache directory. It is created on first use.
+    */
+    static void setCacheDir(const QString &p_sCacheDir);
+
+    //=========================================================================================================
+    /**
+    * Returns the surface cache directory.
+    *
+    * @return the cache directory, empty if the cache is disabled
+    */
+    static QString cacheDir();
+
     //=========================================================================================================
     /**
     * Efficiently compute vertex normals for triangulated surface
@@ -298,6 +319,54 @@ public:
     inline QString fileName() const;
 
 private:
+    //=========================================================================================================
+    /**
+    * Decodes the vertices and triangles of a FreeSurfer surface file.
+    *
+    * @param[in] p_sFile        The surface file
+    * @param[out] p_Surface     The surface receiving the vertices and triangles
+    *
+    * @return true if read sucessful, false otherwise
+    */
+    static bool readGeometry(const QString &p_sFile, Surface &p_Surface);
+
+    //=========================================================================================================
+    /**
+    * Returns the name of the cache file belonging to a surface file.
+    *
+    * @param[in] p_FileInfo     The surface file
+    *
+    * @return the cache file name, empty if the cache is disabled
+    */
+    static QString cacheFileName(const QFileInfo &p_FileInfo);
+
+    //=========================================================================================================
+    /**
+    * Reads the vertices, triangles and normals from a cache file if it is up to date with the surface file.
+    *
+    * @param[in] p_sCacheFile   The cache file
+    * @param[in] p_FileInfo     The surface file the cache was written for
+    * @param[out] p_Surface     The surface receiving the vertices, triangles and normals
+    *
+    * @return true if the cache was valid and read, false otherwise
+    */
+    static bool readCache(const QString &p_sCacheFile, const QFileInfo &p_FileInfo, Surface &p_Surface);
+
+    //=========================================================================================================
+    /**
+    * Writes the vertices, triangles and normals of a surface to a cache file.
+    *
+    * @param[in] p_sCacheFile   The cache file
+    * @param[in] p_FileInfo     The surface file the cache is written for
+    * @param[in] p_Surface      The surface to store
+    *
+    * @return true if written sucessful, false otherwise
+    */
+    static bool writeCache(const QString &p_sCacheFile, const QFileInfo &p_FileInfo, const Surface &p_Surface);
+
+    static QString s_sCacheDir;     /**< Directory of the surface cache, empty if disabled. */
+    static QMutex s_cacheMutex;     /**< Guards s_sCacheDir. */
+
     QString m_sFilePath;    /**< Path to surf directory. */
     QString m_sFileName;    /**< Surface file name. */
     qint32 m_iHemi;         /**< Hemisphere (lh = 0; rh = 1) */
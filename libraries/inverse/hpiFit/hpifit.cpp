@@ -66,6 +66,15 @@
 
 #include <QFuture>
 #include <QtConcurrent/QtConcurrent>
+#include <QDebug>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// STL INCLUDES
+//=============================================================================================================
+
+#include <limits>
 
 
 //*************************************************************************************************************
@@ -109,32 +118,23 @@ void HPIFit::fitHPI(const MatrixXd& t_mat,
 {
     //Check if data was passed
     if(t_mat.rows() == 0 || t_mat.cols() == 0 ) {
-        std::cout<<std::endl<< "HPIFit::fitHPI - No data passed. Returning.";
+        qWarning() << "HPIFit::fitHPI - No data passed. Returning.";
+        return;
     }
 
     //Check if projector was passed
     if(t_matProjectors.rows() == 0 || t_matProjectors.cols() == 0 ) {
-        std::cout<<std::endl<< "HPIFit::fitHPI - No projector passed. Returning.";
+        qWarning() << "HPIFit::fitHPI - No projector passed. Returning.";
+        return;
     }
 
     vGof.clear();
 
-    struct SensorInfo sensors;
-    struct CoilParam coil;
-    int numCh = pFiffInfo->nchan;
     int samF = pFiffInfo->sfreq;
-    int samLoc = t_mat.cols(); // minimum samples required to localize numLoc times in a second
 
     //Get HPI coils from digitizers and set number of coils
-    int numCoils = 0;
-    QList<FiffDigPoint> lHPIPoints;
-
-    for(int i = 0; i < pFiffInfo->dig.size(); ++i) {
-        if(pFiffInfo->dig[i].kind == FIFFV_POINT_HPI) {
-            numCoils++;
-            lHPIPoints.append(pFiffInfo->dig[i]);
-        }
-    }
+    Eigen::MatrixXd headHPI = getDigitizedHPI(pFiffInfo);
+    int numCoils = headHPI.rows();
 
     //Set coil frequencies
     Eigen::VectorXd coilfreq(numCoils);
@@ -145,63 +145,109 @@ void HPIFit::fitHPI(const MatrixXd& t_mat,
             //std::cout<<std::endl << coilfreq[i] << "Hz";
         }
     } else {
-        std::cout<<std::endl<< "HPIFit::fitHPI - Not enough coil frequencies specified. Returning.";
+        qWarning() << "HPIFit::fitHPI - Not enough coil frequencies specified. Returning.";
         return;
     }
 
-    // Initialize HPI coils location and moment
-    coil.pos = Eigen::MatrixXd::Zero(numCoils,3);
-    coil.mom = Eigen::MatrixXd::Zero(numCoils,3);
-    coil.dpfiterror = Eigen::VectorXd::Zero(numCoils);
-    coil.dpfitnumitr = Eigen::VectorXd::Zero(numCoils);
+    // Get the indices of inner layer channels and exclude bad channels.
+    QVector<int> innerind = getHPIChannels(pFiffInfo);
 
-    // Generate simulated data
-    Eigen::MatrixXd simsig(samLoc,numCoils*2);
-    Eigen::VectorXd time(samLoc);
+    // Get the data from inner layer channels
+    Eigen::MatrixXd innerdata(innerind.size(), t_mat.cols());
 
-    for (int i = 0; i < samLoc; ++i) {
-        time[i] = i*1.0/samF;
+    for(int j = 0; j < innerind.size(); ++j) {
+        innerdata.row(j) << t_mat.row(innerind[j]);
     }
 
-    for(int i = 0; i < numCoils; ++i) {
-        for(int j = 0; j < samLoc; ++j) {
-            simsig(j,i) = sin(2*M_PI*coilfreq[i]*time[j]);
-            simsig(j,i+numCoils) = cos(2*M_PI*coilfreq[i]*time[j]);
-        }
-    }
+    // Demodulate the coil signals
+    Eigen::MatrixXd amp = computeCoilAmplitudes(innerdata, vFreqs.mid(0, numCoils), samF); // amp: # of good inner channel x 4
 
-    // Create digitized HPI coil position matrix
-    Eigen::MatrixXd headHPI(numCoils,3);
-
-    // check the pFiffInfo->dig information. If dig is empty, set the headHPI is 0;
-    if (lHPIPoints.size() > 0) {
-        for (int i = 0; i < lHPIPoints.size(); ++i) {
-            headHPI(i,0) = lHPIPoints.at(i).r[0];
-            headHPI(i,1) = lHPIPoints.at(i).r[1];
-            headHPI(i,2) = lHPIPoints.at(i).r[2];
-        }
-    } else {
-        for (int i = 0; i < numCoils; ++i) {
-            headHPI(i,0) = 0;
-            headHPI(i,1) = 0;
-            headHPI(i,2) = 0;
+    // Perform actual localization, starting from the seed points
+    Eigen::MatrixXd coilPosFitted;
+
+    // Single fits do not warm start, keep the fitted positions for the debug output in any case
+    fitHPIAmplitudes(amp,
+                     t_matProjectors,
+                     transDevHead,
+                     vGof,
+                     fittedPointSet,
+                     pFiffInfo,
+                     coilPosFitted,
+                     std::numeric_limits<double>::infinity());
+
+    if(bDoDebug && coilPosFitted.rows() == numCoils) {
+        VectorXi chIdcs;
+        Eigen::MatrixXd coilPos = computeSeedPoints(amp, innerind, pFiffInfo, chIdcs);
+        Eigen::Matrix4d trans = transDevHead.trans.cast<double>();
+
+        MatrixXd temp = coilPosFitted;
+        temp.conservativeResize(coilPosFitted.rows(),coilPosFitted.cols()+1);
+
+        temp.block(0,3,numCoils,1).setOnes();
+        temp.transposeInPlace();
+
+        MatrixXd testPos = trans * temp;
+        MatrixXd diffPos = testPos.block(0,0,3,numCoils) - headHPI.transpose();
+
+        // DEBUG HPI fitting and write debug results
+        std::cout << std::endl << std::endl << "HPIFit::fitHPI - Initial seed point for HPI coils" << std::endl << coilPos << std::endl;
+        std::cout << std::endl << std::endl << "HPIFit::fitHPI - Fitted HPI coils" << std::endl << coilPosFitted << std::endl;
+        std::cout << std::endl << std::endl << "HPIFit::fitHPI - temp" << std::endl << temp << std::endl;
+        std::cout << std::endl << std::endl << "HPIFit::fitHPI - testPos" << std::endl << testPos << std::endl;
+        std::cout << std::endl << std::endl << "HPIFit::fitHPI - Diff fitted - original" << std::endl << diffPos << std::endl;
+        std::cout << std::endl << std::endl << "HPIFit::fitHPI - dev/head trans" << std::endl << trans << std::endl;
+
+        QString sTimeStamp = QDateTime::currentDateTime().toString("yyMMdd_hhmmss");
+
+        if(!QDir(sHPIResourceDir).exists()) {
+            QDir().mkdir(sHPIResourceDir);
         }
+
+        UTILSLIB::IOUtils::write_eigen_matrix(coilPos, QString("%1/%2_coilPosSeed_mat").arg(sHPIResourceDir).arg(sTimeStamp));
+
+        UTILSLIB::IOUtils::write_eigen_matrix(coilPosFitted, QString("%1/%2_coilPos_mat").arg(sHPIResourceDir).arg(sTimeStamp));
+
+        UTILSLIB::IOUtils::write_eigen_matrix(headHPI, QString("%1/%2_headHPI_mat").arg(sHPIResourceDir).arg(sTimeStamp));
+
+        MatrixXd testPosCut = testPos.transpose();//block(0,0,3,4);
+        UTILSLIB::IOUtils::write_eigen_matrix(testPosCut, QString("%1/%2_testPos_mat").arg(sHPIResourceDir).arg(sTimeStamp));
+
+        MatrixXi idx_mat(chIdcs.rows(),1);
+        idx_mat.col(0) = chIdcs;
+        UTILSLIB::IOUtils::write_eigen_matrix(idx_mat, QString("%1/%2_idx_mat").arg(sHPIResourceDir).arg(sTimeStamp));
+
+        MatrixXd coilFreq_mat(coilfreq.rows(),1);
+        coilFreq_mat.col(0) = coilfreq;
+        UTILSLIB::IOUtils::write_eigen_matrix(coilFreq_mat, QString("%1/%2_coilFreq_mat").arg(sHPIResourceDir).arg(sTimeStamp));
+
+        UTILSLIB::IOUtils::write_eigen_matrix(diffPos, QString("%1/%2_diffPos_mat").arg(sHPIResourceDir).arg(sTimeStamp));
+
+        UTILSLIB::IOUtils::write_eigen_matrix(amp, QString("%1/%2_amp_mat").arg(sHPIResourceDir).arg(sTimeStamp));
     }
+}
 
-    // Get the indices of inner layer channels and exclude bad channels.
-    //TODO: Only supports babymeg and vectorview gradiometeres for hpi fitting.
-    QVector<int> innerind(0);
 
-    for (int i = 0; i < numCh; ++i) {
-        if(pFiffInfo->chs[i].chpos.coil_type == FIFFV_COIL_BABY_MAG ||
-                pFiffInfo->chs[i].chpos.coil_type == FIFFV_COIL_VV_PLANAR_T1 ||
-                pFiffInfo->chs[i].chpos.coil_type == FIFFV_COIL_VV_PLANAR_T2 ||
-                pFiffInfo->chs[i].chpos.coil_type == FIFFV_COIL_VV_PLANAR_T3) {
-            // Check if the sensor is bad, if not append to innerind
-            if(!(pFiffInfo->bads.contains(pFiffInfo->ch_names.at(i)))) {
-                innerind.append(i);
-            }
-        }
+//*************************************************************************************************************
+
+void HPIFit::fitHPIAmplitudes(const MatrixXd& matAmplitudes,
+                              const MatrixXd& t_matProjectors,
+                              FiffCoordTrans& transDevHead,
+                              QVector<double>& vGof,
+                              FiffDigPointSet& fittedPointSet,
+                              FiffInfo::SPtr pFiffInfo,
+                              MatrixXd& matCoilPos,
+                              double dMaxError)
+{
+    vGof.clear();
+
+    Eigen::MatrixXd headHPI = getDigitizedHPI(pFiffInfo);
+    int numCoils = headHPI.rows();
+
+    QVector<int> innerind = getHPIChannels(pFiffInfo);
+
+    if(numCoils == 0 || matAmplitudes.cols() != numCoils || matAmplitudes.rows() != innerind.size()) {
+        qWarning() << "HPIFit::fitHPIAmplitudes - Amplitudes do not match the HPI coils and channels. Returning.";
+        return;
     }
 
     //Create new projector based on the excluded channels, first exclude the rows then the columns
@@ -216,10 +262,8 @@ void HPIFit::fitHPI(const MatrixXd& t_mat,
         matProjectorsInnerind.col(i) = matProjectorsRows.col(innerind.at(i));
     }
 
-    //UTILSLIB::IOUtils::write_eigen_matrix(matProjectorsInnerind, "matProjectorsInnerind.txt");
-    //UTILSLIB::IOUtils::write_eigen_matrix(t_matProjectors, "t_matProjectors.txt");
-
     // Initialize inner layer sensors
+    struct SensorInfo sensors;
     sensors.coilpos = Eigen::MatrixXd::Zero(innerind.size(),3);
     sensors.coilori = Eigen::MatrixXd::Zero(innerind.size(),3);
     sensors.tra = Eigen::MatrixXd::Identity(innerind.size(),innerind.size());
@@ -233,83 +277,24 @@ void HPIFit::fitHPI(const MatrixXd& t_mat,
         sensors.coilori(i,2) = pFiffInfo->chs[innerind.at(i)].chpos.ez[2];
     }
 
-    Eigen::MatrixXd topo(innerind.size(), numCoils*2);
-    Eigen::MatrixXd amp(innerind.size(), numCoils);
-    Eigen::MatrixXd ampC(innerind.size(), numCoils);
-
-    // Get the data from inner layer channels
-    Eigen::MatrixXd innerdata(innerind.size(), t_mat.cols());
-
-    for(int j = 0; j < innerind.size(); ++j) {
-        innerdata.row(j) << t_mat.row(innerind[j]);
-    }
-
-    // Calculate topo
-    topo = innerdata * UTILSLIB::MNEMath::pinv(simsig).transpose(); // topo: # of good inner channel x 8
-
-    // Select sine or cosine component depending on the relative size
-    amp  = topo.leftCols(numCoils); // amp: # of good inner channel x 4
-    ampC = topo.rightCols(numCoils);
-
-    for(int j = 0; j < numCoils; ++j) {
-       float nS = 0.0;
-       float nC = 0.0;
-       for(int i = 0; i < innerind.size(); ++i) {
-           nS += amp(i,j)*amp(i,j);
-           nC += ampC(i,j)*ampC(i,j);
-       }
-
-       if(nC > nS) {
-         for(int i = 0; i < innerind.size(); ++i) {
-           amp(i,j) = ampC(i,j);
-         }
-       }
-    }
-
-    //Find good seed point/starting point for the coil position in 3D space
-    //Find biggest amplitude per pickup coil (sensor) and store corresponding sensor channel index
-    VectorXi chIdcs(numCoils);
-
-    for (int j = 0; j < numCoils; j++) {
-        double maxVal = 0;
-        int chIdx = 0;
-
-        for (int i = 0; i < amp.rows(); ++i) {
-            if(std::fabs(amp(i,j)) > maxVal) {
-                maxVal = std::fabs(amp(i,j));
-
-                if(chIdx < innerind.size()) {
-                    chIdx = innerind.at(i);
-                }
-            }
-        }
-
-        chIdcs(j) = chIdx;
-    }
-
-    //Generate seed point by projection the found channel position 3cm inwards
-    Eigen::MatrixXd coilPos = Eigen::MatrixXd::Zero(numCoils,3);
-
-    for (int j = 0; j < chIdcs.rows(); ++j) {
-        int chIdx = chIdcs(j);
-
-        if(chIdx < pFiffInfo->chs.size()) {
-            double x = pFiffInfo->chs.at(chIdcs(j)).chpos.r0[0];
-            double y = pFiffInfo->chs.at(chIdcs(j)).chpos.r0[1];
-            double z = pFiffInfo->chs.at(chIdcs(j)).chpos.r0[2];
-
-            coilPos(j,0) = -1 * pFiffInfo->chs.at(chIdcs(j)).chpos.ez[0] * 0.03 + x;
-            coilPos(j,1) = -1 * pFiffInfo->chs.at(chIdcs(j)).chpos.ez[1] * 0.03 + y;
-            coilPos(j,2) = -1 * pFiffInfo->chs.at(chIdcs(j)).chpos.ez[2] * 0.03 + z;
-        }
+    // Initialize HPI coils location and moment
+    struct CoilParam coil;
+    coil.mom = Eigen::MatrixXd::Zero(numCoils,3);
+    coil.dpfiterror = Eigen::VectorXd::Zero(numCoils);
+    coil.dpfitnumitr = Eigen::VectorXd::Zero(numCoils);
 
-        //std::cout << "HPIFit::fitHPI - Coil " << j << " max value index " << chIdx << std::endl;
+    if(matCoilPos.rows() == numCoils && matCoilPos.cols() == 3) {
+        //Warm start from the previous head position
+        coil.pos = matCoilPos;
+    } else {
+        VectorXi chIdcs;
+        coil.pos = computeSeedPoints(matAmplitudes, innerind, pFiffInfo, chIdcs);
     }
 
-    coil.pos = coilPos;
-
     // Perform actual localization
-    coil = dipfit(coil, sensors, amp, numCoils, matProjectorsInnerind);
+    coil = dipfit(coil, sensors, matAmplitudes, numCoils, matProjectorsInnerind);
+
+    matCoilPos = coil.pos;
 
     Eigen::Matrix4d trans = computeTransformation(headHPI, coil.pos);
     //Eigen::Matrix4d trans = computeTransformation(coil.pos, headHPI);
@@ -338,8 +323,16 @@ void HPIFit::fitHPI(const MatrixXd& t_mat,
     MatrixXd testPos = trans * temp;
     MatrixXd diffPos = testPos.block(0,0,3,numCoils) - headHPI.transpose();
 
+    double dMeanGof = 0.0;
+
     for(int i = 0; i < diffPos.cols(); ++i) {
         vGof.append(diffPos.col(i).norm());
+        dMeanGof += vGof.last() / diffPos.cols();
+    }
+
+    //Do not warm start the next fit from a failed fit, it would start from the wrong positions again
+    if(!(dMeanGof <= dMaxError) || !coil.pos.allFinite()) {
+        matCoilPos.resize(0,3);
     }
 
     //Generate final fitted points and store in digitizer set
@@ -353,43 +346,77 @@ void HPIFit::fitHPI(const MatrixXd& t_mat,
 
         fittedPointSet << digPoint;
     }
+}
 
-    if(bDoDebug) {
-        // DEBUG HPI fitting and write debug results
-        std::cout << std::endl << std::endl << "HPIFit::fitHPI - dpfiterror" << coil.dpfiterror << std::endl << coil.pos << std::endl;
-        std::cout << std::endl << std::endl << "HPIFit::fitHPI - Initial seed point for HPI coils" << std::endl << coil.pos << std::endl;
-        std::cout << std::endl << std::endl << "HPIFit::fitHPI - temp" << std::endl << temp << std::endl;
-        std::cout << std::endl << std::endl << "HPIFit::fitHPI - testPos" << std::endl << testPos << std::endl;
-        std::cout << std::endl << std::endl << "HPIFit::fitHPI - Diff fitted - original" << std::endl << diffPos << std::endl;
-        std::cout << std::endl << std::endl << "HPIFit::fitHPI - dev/head trans" << std::endl << trans << std::endl;
 
-        QString sTimeStamp = QDateTime::currentDateTime().toString("yyMMdd_hhmmss");
+//*************************************************************************************************************
 
-        if(!QDir(sHPIResourceDir).exists()) {
-            QDir().mkdir(sHPIResourceDir);
+MatrixXd HPIFit::computeCoilAmplitudes(const MatrixXd& matData,
+                                       const QVector<int>& vFreqs,
+                                       double dSFreq)
+{
+    int numCoils = vFreqs.size();
+    int samLoc = matData.cols();
+
+    // Generate simulated data
+    Eigen::MatrixXd simsig(samLoc,numCoils*2);
+    Eigen::VectorXd time(samLoc);
+
+    for (int i = 0; i < samLoc; ++i) {
+        time[i] = i*1.0/dSFreq;
+    }
+
+    for(int i = 0; i < numCoils; ++i) {
+        for(int j = 0; j < samLoc; ++j) {
+            simsig(j,i) = sin(2*M_PI*vFreqs.at(i)*time[j]);
+            simsig(j,i+numCoils) = cos(2*M_PI*vFreqs.at(i)*time[j]);
         }
+    }
 
-        UTILSLIB::IOUtils::write_eigen_matrix(coilPos, QString("%1/%2_coilPosSeed_mat").arg(sHPIResourceDir).arg(sTimeStamp));
+    // Calculate topo
+    Eigen::MatrixXd topo = matData * UTILSLIB::MNEMath::pinv(simsig).transpose(); // topo: # of channels x 2*coils
 
-        UTILSLIB::IOUtils::write_eigen_matrix(coil.pos, QString("%1/%2_coilPos_mat").arg(sHPIResourceDir).arg(sTimeStamp));
+    // Select sine or cosine component depending on the relative size
+    Eigen::MatrixXd amp = topo.leftCols(numCoils);
+    Eigen::MatrixXd ampC = topo.rightCols(numCoils);
 
-        UTILSLIB::IOUtils::write_eigen_matrix(headHPI, QString("%1/%2_headHPI_mat").arg(sHPIResourceDir).arg(sTimeStamp));
+    for(int j = 0; j < numCoils; ++j) {
+       float nS = 0.0;
+       float nC = 0.0;
+       for(int i = 0; i < amp.rows(); ++i) {
+           nS += amp(i,j)*amp(i,j);
+           nC += ampC(i,j)*ampC(i,j);
+       }
 
-        MatrixXd testPosCut = testPos.transpose();//block(0,0,3,4);
-        UTILSLIB::IOUtils::write_eigen_matrix(testPosCut, QString("%1/%2_testPos_mat").arg(sHPIResourceDir).arg(sTimeStamp));
+       if(nC > nS) {
+         amp.col(j) = ampC.col(j);
+       }
+    }
 
-        MatrixXi idx_mat(chIdcs.rows(),1);
-        idx_mat.col(0) = chIdcs;
-        UTILSLIB::IOUtils::write_eigen_matrix(idx_mat, QString("%1/%2_idx_mat").arg(sHPIResourceDir).arg(sTimeStamp));
+    return amp;
+}
 
-        MatrixXd coilFreq_mat(coilfreq.rows(),1);
-        coilFreq_mat.col(0) = coilfreq;
-        UTILSLIB::IOUtils::write_eigen_matrix(coilFreq_mat, QString("%1/%2_coilFreq_mat").arg(sHPIResourceDir).arg(sTimeStamp));
 
-        UTILSLIB::IOUtils::write_eigen_matrix(diffPos, QString("%1/%2_diffPos_mat").arg(sHPIResourceDir).arg(sTimeStamp));
+//*************************************************************************************************************
 
-        UTILSLIB::IOUtils::write_eigen_matrix(amp, QString("%1/%2_amp_mat").arg(sHPIResourceDir).arg(sTimeStamp));
+QVector<int> HPIFit::getHPIChannels(FiffInfo::SPtr pFiffInfo)
+{
+    //TODO: Only supports babymeg and vectorview gradiometeres for hpi fitting.
+    QVector<int> innerind(0);
+
+    for (int i = 0; i < pFiffInfo->nchan; ++i) {
+        if(pFiffInfo->chs[i].chpos.coil_type == FIFFV_COIL_BABY_MAG ||
+                pFiffInfo->chs[i].chpos.coil_type == FIFFV_COIL_VV_PLANAR_T1 ||
+                pFiffInfo->chs[i].chpos.coil_type == FIFFV_COIL_VV_PLANAR_T2 ||
+                pFiffInfo->chs[i].chpos.coil_type == FIFFV_COIL_VV_PLANAR_T3) {
+            // Check if the sensor is bad, if not append to innerind
+            if(!(pFiffInfo->bads.contains(pFiffInfo->ch_names.at(i)))) {
+                innerind.append(i);
+            }
+        }
     }
+
+    return innerind;
 }
 
 
@@ -505,3 +532,79 @@ Eigen::Matrix4d HPIFit::computeTransformation(Eigen::MatrixXd NH, Eigen::MatrixX
 
     return transFinal;
 }
+
+
+//*************************************************************************************************************
+
+Eigen::MatrixXd HPIFit::computeSeedPoints(const Eigen::MatrixXd& matAmplitudes,
+                                          const QVector<int>& vChannels,
+                                          FiffInfo::SPtr pFiffInfo,
+                                          Eigen::VectorXi& vecChIdcs)
+{
+    int numCoils = matAmplitudes.cols();
+
+    //Find good seed point/starting point for the coil position in 3D space
+    //Find biggest amplitude per pickup coil (sensor) and store corresponding sensor channel index
+    vecChIdcs.resize(numCoils);
+
+    for (int j = 0; j < numCoils; j++) {
+        double maxVal = 0;
+        int chIdx = 0;
+
+        for (int i = 0; i < matAmplitudes.rows(); ++i) {
+            if(std::fabs(matAmplitudes(i,j)) > maxVal) {
+                maxVal = std::fabs(matAmplitudes(i,j));
+
+                if(chIdx < vChannels.size()) {
+                    chIdx = vChannels.at(i);
+                }
+            }
+        }
+
+        vecChIdcs(j) = chIdx;
+    }
+
+    //Generate seed point by projection the found channel position 3cm inwards
+    Eigen::MatrixXd coilPos = Eigen::MatrixXd::Zero(numCoils,3);
+
+    for (int j = 0; j < vecChIdcs.rows(); ++j) {
+        int chIdx = vecChIdcs(j);
+
+        if(chIdx < pFiffInfo->chs.size()) {
+            double x = pFiffInfo->chs.at(chIdx).chpos.r0[0];
+            double y = pFiffInfo->chs.at(chIdx).chpos.r0[1];
+            double z = pFiffInfo->chs.at(chIdx).chpos.r0[2];
+
+            coilPos(j,0) = -1 * pFiffInfo->chs.at(chIdx).chpos.ez[0] * 0.03 + x;
+            coilPos(j,1) = -1 * pFiffInfo->chs.at(chIdx).chpos.ez[1] * 0.03 + y;
+            coilPos(j,2) = -1 * pFiffInfo->chs.at(chIdx).chpos.ez[2] * 0.03 + z;
+        }
+    }
+
+    return coilPos;
+}
+
+
+//*************************************************************************************************************
+
+Eigen::MatrixXd HPIFit::getDigitizedHPI(FiffInfo::SPtr pFiffInfo)
+{
+    QList<FiffDigPoint> lHPIPoints;
+
+    for(int i = 0; i < pFiffInfo->dig.size(); ++i) {
+        if(pFiffInfo->dig[i].kind == FIFFV_POINT_HPI) {
+            lHPIPoints.append(pFiffInfo->dig[i]);
+        }
+    }
+
+    // Create digitized HPI coil position matrix
+    Eigen::MatrixXd headHPI(lHPIPoints.size(),3);
+
+    for (int i = 0; i < lHPIPoints.size(); ++i) {
+        headHPI(i,0) = lHPIPoints.at(i).r[0];
+        headHPI(i,1) = lHPIPoints.at(i).r[1];
+        headHPI(i,2) = lHPIPoints.at(i).r[2];
+    }
+
+    return headHPI;
+}
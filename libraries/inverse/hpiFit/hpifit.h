@@ -58,6 +58,7 @@
 //=============================================================================================================
 
 #include <QSharedPointer>
+#include <QVector>
 
 
 //*************************************************************************************************************
@@ -145,6 +146,59 @@ public:
                        bool bDoDebug = false,
                        const QString& sHPIResourceDir = QString("./HPIFittingDebug"));
 
+    //=========================================================================================================
+    /**
+    * Perform one HPI fit on already demodulated coil amplitudes, e.g. as provided by HPILockIn. If the coil
+    * positions of a previous fit are passed, they are used as the starting points of the dipole fits (warm start),
+    * which lets continuous head position tracking converge within few iterations.
+    *
+    * @param[in]    matAmplitudes   The coil amplitudes (channels x coils), rows ordered as getHPIChannels.
+    * @param[in]    t_matProjectors The projectors to apply. Bad channels are still included.
+    * @param[out]   transDevHead    The final dev head transformation matrix
+    * @param[out]   vGof            The goodness of fit in mm for each fitted HPI coil.
+    * @param[out]   fittedPointSet  The final fitted positions in form of a digitizer set.
+    * @param[in]    p_pFiffInfo     Associated Fiff Information.
+    * @param[in,out] matCoilPos     The coil positions in device coordinates (coils x 3) to start from. An empty
+    *                               matrix starts from seed points below the strongest channels. Holds the fitted
+    *                               coil positions on return if the fit passed the error check, otherwise it is
+    *                               cleared so that the next fit does not start from a failed fit.
+    * @param[in]    dMaxError       The maximum mean goodness of fit in m for which the fitted positions are kept.
+    */
+    static void fitHPIAmplitudes(const Eigen::MatrixXd& matAmplitudes,
+                                 const Eigen::MatrixXd& t_matProjectors,
+                                 FIFFLIB::FiffCoordTrans &transDevHead,
+                                 QVector<double> &vGof,
+                                 FIFFLIB::FiffDigPointSet& fittedPointSet,
+                                 QSharedPointer<FIFFLIB::FiffInfo> pFiffInfo,
+                                 Eigen::MatrixXd& matCoilPos,
+                                 double dMaxError = 0.01);
+
+    //=========================================================================================================
+    /**
+    * Demodulates the coil signals of a data block, as done by fitHPI. Sine and cosine references with phase zero
+    * at the first sample are fitted to the data by least squares. For each coil the component with the larger
+    * norm, sine or cosine, is kept.
+    *
+    * @param[in]    matData         The data block (channels x samples).
+    * @param[in]    vFreqs          The frequencies for each coil in Hz.
+    * @param[in]    dSFreq          The sampling frequency in Hz.
+    *
+    * @return The coil amplitudes (channels x coils).
+    */
+    static Eigen::MatrixXd computeCoilAmplitudes(const Eigen::MatrixXd& matData,
+                                                 const QVector<int>& vFreqs,
+                                                 double dSFreq);
+
+    //=========================================================================================================
+    /**
+    * Returns the channels which are used for HPI fitting, i.e. the good inner layer gradiometers and magnetometers.
+    *
+    * @param[in] p_pFiffInfo    Associated Fiff Information.
+    *
+    * @return The channel indices.
+    */
+    static QVector<int> getHPIChannels(QSharedPointer<FIFFLIB::FiffInfo> pFiffInfo);
+
 protected:
     //=========================================================================================================
     /**
@@ -171,6 +225,33 @@ protected:
     */
     static Eigen::Matrix4d computeTransformation(Eigen::MatrixXd NH, Eigen::MatrixXd BT);
 
+    //=========================================================================================================
+    /**
+    * Generates seed points for the coil positions by projecting the channel with the biggest amplitude of each
+    * coil 3cm inwards.
+    *
+    * @param[in] matAmplitudes  The coil amplitudes (channels x coils).
+    * @param[in] vChannels      The channel indices of the amplitude rows.
+    * @param[in] p_pFiffInfo    Associated Fiff Information.
+    * @param[out] vecChIdcs     The channel index used for each coil.
+    *
+    * @return Returns the seed points (coils x 3).
+    */
+    static Eigen::MatrixXd computeSeedPoints(const Eigen::MatrixXd& matAmplitudes,
+                                             const QVector<int>& vChannels,
+                                             QSharedPointer<FIFFLIB::FiffInfo> pFiffInfo,
+                                             Eigen::VectorXi& vecChIdcs);
+
+    //=========================================================================================================
+    /**
+    * Returns the digitized HPI coil positions in head coordinates.
+    *
+    * @param[in] p_pFiffInfo    Associated Fiff Information.
+    *
+    * @return The digitized positions (coils x 3).
+    */
+    static Eigen::MatrixXd getDigitizedHPI(QSharedPointer<FIFFLIB::FiffInfo> pFiffInfo);
+
     static QString         m_sHPIResourceDir;      /**< Hold the resource folder to store the debug information in. */
 };
 
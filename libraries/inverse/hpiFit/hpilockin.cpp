@@ -0,0 +1,242 @@
+//=============================================================================================================
+/**
+* @file     hpilockin.cpp
+* @author   agent <agent@local>
+* @version  1.0
+* @date     October, 2026
+*
+* @section  LICENSE
+*
+* Copyright (C) 2026, agent. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+*
+* @brief    HPILockIn class defintion.
+*
+*/
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "hpilockin.h"
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// Eigen INCLUDES
+//=============================================================================================================
+
+#include <Eigen/Dense>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// STL INCLUDES
+//=============================================================================================================
+
+#include <cmath>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// USED NAMESPACES
+//=============================================================================================================
+
+using namespace Eigen;
+using namespace INVERSELIB;
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE MEMBER METHODS
+//=============================================================================================================
+
+HPILockIn::HPILockIn(const QVector<int>& vFreqs,
+                     double dSFreq,
+                     const QVector<int>& vChannels,
+                     int iWindowSize)
+: m_vFreqs(vFreqs)
+, m_vChannels(vChannels)
+, m_iNumCoils(vFreqs.size())
+, m_iWindowSize(iWindowSize > 0 ? iWindowSize : 1)
+, m_iNumSamples(0)
+, m_iWritePos(0)
+, m_iSamplesSinceRefresh(0)
+{
+    //The phase increments are computed once, the oscillators are advanced by complex rotation afterwards
+    m_vecStepSin.resize(m_iNumCoils);
+    m_vecStepCos.resize(m_iNumCoils);
+
+    for(int i = 0; i < m_iNumCoils; ++i) {
+        double dPhaseStep = 2.0 * M_PI * m_vFreqs.at(i) / dSFreq;
+        m_vecStepSin(i) = std::sin(dPhaseStep);
+        m_vecStepCos(i) = std::cos(dPhaseStep);
+    }
+
+    m_matDataWindow.resize(m_vChannels.size(), m_iWindowSize);
+    m_matRefWindow.resize(2 * m_iNumCoils, m_iWindowSize);
+
+    reset();
+}
+
+
+//*************************************************************************************************************
+
+void HPILockIn::append(const MatrixXd& matData,
+                       int iStart,
+                       int iNumSamples)
+{
+    if(iNumSamples < 0) {
+        iNumSamples = matData.cols() - iStart;
+    }
+
+    if(iStart < 0 || iStart + iNumSamples > matData.cols() || m_iNumCoils == 0) {
+        return;
+    }
+
+    VectorXd vecSample(m_vChannels.size());
+    VectorXd vecRef(2 * m_iNumCoils);
+    VectorXd vecSin(m_iNumCoils);
+
+    for(int s = iStart; s < iStart + iNumSamples; ++s) {
+        for(int i = 0; i < m_vChannels.size(); ++i) {
+            vecSample(i) = matData(m_vChannels.at(i), s);
+        }
+
+        vecRef.head(m_iNumCoils) = m_vecOscSin;
+        vecRef.tail(m_iNumCoils) = m_vecOscCos;
+
+        //Remove the sample which leaves the window
+        if(m_iNumSamples >= m_iWindowSize) {
+            m_matCorr.noalias() -= m_matDataWindow.col(m_iWritePos) * m_matRefWindow.col(m_iWritePos).transpose();
+            m_matGram.noalias() -= m_matRefWindow.col(m_iWritePos) * m_matRefWindow.col(m_iWritePos).transpose();
+        } else {
+            ++m_iNumSamples;
+        }
+
+        m_matCorr.noalias() += vecSample * vecRef.transpose();
+        m_matGram.noalias() += vecRef * vecRef.transpose();
+
+        m_matDataWindow.col(m_iWritePos) = vecSample;
+        m_matRefWindow.col(m_iWritePos) = vecRef;
+
+        m_iWritePos = (m_iWritePos + 1) % m_iWindowSize;
+
+        //Advance the oscillators: (cos + i*sin) * (stepCos + i*stepSin)
+        vecSin.noalias() = m_vecOscSin.cwiseProduct(m_vecStepCos) + m_vecOscCos.cwiseProduct(m_vecStepSin);
+        m_vecOscCos = m_vecOscCos.cwiseProduct(m_vecStepCos) - m_vecOscSin.cwiseProduct(m_vecStepSin);
+        m_vecOscSin.swap(vecSin);
+
+        if(++m_iSamplesSinceRefresh >= m_iWindowSize) {
+            refresh();
+        }
+    }
+
+    //Keep the oscillators on the unit circle
+    for(int i = 0; i < m_iNumCoils; ++i) {
+        double dNorm = std::sqrt(m_vecOscSin(i) * m_vecOscSin(i) + m_vecOscCos(i) * m_vecOscCos(i));
+        m_vecOscSin(i) /= dNorm;
+        m_vecOscCos(i) /= dNorm;
+    }
+}
+
+
+//*************************************************************************************************************
+
+MatrixXd HPILockIn::getAmplitudes() const
+{
+    MatrixXd matSine, matCosine;
+    getQuadratureAmplitudes(matSine, matCosine);
+
+    //Select the sine or cosine component depending on the relative size, see HPIFit::computeCoilAmplitudes
+    for(int j = 0; j < m_iNumCoils; ++j) {
+        if(matCosine.col(j).squaredNorm() > matSine.col(j).squaredNorm()) {
+            matSine.col(j) = matCosine.col(j);
+        }
+    }
+
+    return matSine;
+}
+
+
+//*************************************************************************************************************
+
+void HPILockIn::getQuadratureAmplitudes(MatrixXd& matSine,
+                                        MatrixXd& matCosine) const
+{
+    if(m_iNumSamples == 0) {
+        matSine = MatrixXd::Zero(m_vChannels.size(), m_iNumCoils);
+        matCosine = MatrixXd::Zero(m_vChannels.size(), m_iNumCoils);
+        return;
+    }
+
+    //Least squares amplitudes: topo = corr * gram^-1
+    MatrixXd matTopo = m_matGram.ldlt().solve(m_matCorr.transpose()).transpose();
+
+    //The oscillators run on, rotate the amplitudes onto the phase of the oldest sample in the window:
+    //a*sin(t+p) + b*cos(t+p) = (a*cos(p) - b*sin(p))*sin(t) + (a*sin(p) + b*cos(p))*cos(t)
+    int iOldest = m_iNumSamples >= m_iWindowSize ? m_iWritePos : 0;
+
+    matSine.resize(m_vChannels.size(), m_iNumCoils);
+    matCosine.resize(m_vChannels.size(), m_iNumCoils);
+
+    for(int j = 0; j < m_iNumCoils; ++j) {
+        double dSinPhase = m_matRefWindow(j, iOldest);
+        double dCosPhase = m_matRefWindow(m_iNumCoils + j, iOldest);
+
+        matSine.col(j) = dCosPhase * matTopo.col(j) - dSinPhase * matTopo.col(m_iNumCoils + j);
+        matCosine.col(j) = dSinPhase * matTopo.col(j) + dCosPhase * matTopo.col(m_iNumCoils + j);
+    }
+}
+
+
+//*************************************************************************************************************
+
+void HPILockIn::reset()
+{
+    m_iNumSamples = 0;
+    m_iWritePos = 0;
+    m_iSamplesSinceRefresh = 0;
+
+    m_vecOscSin = VectorXd::Zero(m_iNumCoils);
+    m_vecOscCos = VectorXd::Ones(m_iNumCoils);
+
+    m_matCorr = MatrixXd::Zero(m_vChannels.size(), 2 * m_iNumCoils);
+    m_matGram = MatrixXd::Zero(2 * m_iNumCoils, 2 * m_iNumCoils);
+}
+
+
+//*************************************************************************************************************
+
+void HPILockIn::refresh()
+{
+    m_iSamplesSinceRefresh = 0;
+
+    if(m_iNumSamples < m_iWindowSize) {
+        //The window is not full yet, the running sums are exact sums without removals
+        return;
+    }
+
+    m_matCorr.noalias() = m_matDataWindow * m_matRefWindow.transpose();
+    m_matGram.noalias() = m_matRefWindow * m_matRefWindow.transpose();
+}
@@ -0,0 +1,238 @@
+//=============================================================================================================
+/**
+* @file     hpilockin.h
+* @author   agent <agent@local>
+* @version  1.0
+* @date     October, 2026
+*
+* @section  LICENSE
+*
+* Copyright (C) 2026, agent. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+*
+* @brief    HPILockIn class declaration.
+*
+*/
+
+#ifndef HPILOCKIN_H
+#define HPILOCKIN_H
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "../inverse_global.h"
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// EIGEN INCLUDES
+//=============================================================================================================
+
+#include <Eigen/Core>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QSharedPointer>
+#include <QVector>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE NAMESPACE INVERSELIB
+//=============================================================================================================
+
+namespace INVERSELIB
+{
+
+
+//=============================================================================================================
+/**
+* Streaming lock-in demodulation of the HPI coil signals. Every incoming sample is correlated with cached sine and
+* cosine oscillators of all coil frequencies. The correlations and the Gram matrix of the references are kept as
+* running sums over a sliding window, so the per coil quadrature amplitudes are available at any time with a cost
+* which is constant per sample. The amplitudes are referred to the phase of the first sample in the window, so they
+* equal the amplitudes HPIFit::computeCoilAmplitudes (and therefore HPIFit::fitHPI) computes from the window.
+*
+* @brief Streaming lock-in amplifier for the HPI coil amplitudes.
+*/
+class INVERSESHARED_EXPORT HPILockIn
+{
+
+public:
+    typedef QSharedPointer<HPILockIn> SPtr;             /**< Shared pointer type for HPILockIn. */
+    typedef QSharedPointer<const HPILockIn> ConstSPtr;  /**< Const shared pointer type for HPILockIn. */
+
+    //=========================================================================================================
+    /**
+    * Constructs the lock-in amplifier.
+    *
+    * @param[in] vFreqs         The frequencies for each coil in Hz.
+    * @param[in] dSFreq         The sampling frequency in Hz.
+    * @param[in] vChannels      The channel (row) indices of the incoming data which are demodulated.
+    * @param[in] iWindowSize    The length of the sliding integration window in samples.
+    */
+    HPILockIn(const QVector<int>& vFreqs,
+              double dSFreq,
+              const QVector<int>& vChannels,
+              int iWindowSize);
+
+    //=========================================================================================================
+    /**
+    * Demodulates the samples of a data block. Only the configured channels are read.
+    *
+    * @param[in] matData        The data block (channels x samples).
+    * @param[in] iStart         The first sample (column) to process.
+    * @param[in] iNumSamples    The number of samples to process. -1 processes all samples starting at iStart.
+    */
+    void append(const Eigen::MatrixXd& matData,
+                int iStart = 0,
+                int iNumSamples = -1);
+
+    //=========================================================================================================
+    /**
+    * Returns the coil amplitudes of the current window. As in HPIFit::fitHPI, the sine or the cosine component
+    * is selected for each coil, whichever has the larger norm.
+    *
+    * @return The amplitudes (channels x coils).
+    */
+    Eigen::MatrixXd getAmplitudes() const;
+
+    //=========================================================================================================
+    /**
+    * Returns the quadrature amplitudes of the current window. The sine and cosine references start with phase
+    * zero at the first sample of the window.
+    *
+    * @param[out] matSine       The amplitudes of the sine components (channels x coils).
+    * @param[out] matCosine     The amplitudes of the cosine components (channels x coils).
+    */
+    void getQuadratureAmplitudes(Eigen::MatrixXd& matSine,
+                                 Eigen::MatrixXd& matCosine) const;
+
+    //=========================================================================================================
+    /**
+    * Resets the window and the oscillators.
+    */
+    void reset();
+
+    //=========================================================================================================
+    /**
+    * Returns whether the sliding window is completely filled.
+    *
+    * @return true if the window holds iWindowSize samples.
+    */
+    inline bool isReady() const;
+
+    //=========================================================================================================
+    /**
+    * Returns the length of the sliding window.
+    *
+    * @return the window size in samples.
+    */
+    inline int getWindowSize() const;
+
+    //=========================================================================================================
+    /**
+    * Returns the demodulated channel indices.
+    *
+    * @return the channel indices.
+    */
+    inline const QVector<int>& getChannels() const;
+
+    //=========================================================================================================
+    /**
+    * Returns the coil frequencies.
+    *
+    * @return the coil frequencies in Hz.
+    */
+    inline const QVector<int>& getFrequencies() const;
+
+private:
+    //=========================================================================================================
+    /**
+    * Recomputes the running sums from the stored window. This bounds the round-off error which the
+    * incremental add and remove updates accumulate.
+    */
+    void refresh();
+
+    QVector<int>        m_vFreqs;                   /**< The coil frequencies in Hz. */
+    QVector<int>        m_vChannels;                /**< The demodulated channel indices. */
+    int                 m_iNumCoils;                /**< The number of coils. */
+    int                 m_iWindowSize;              /**< The length of the sliding window in samples. */
+    int                 m_iNumSamples;              /**< The number of samples currently in the window. */
+    int                 m_iWritePos;                /**< The window column which is written next. */
+    int                 m_iSamplesSinceRefresh;     /**< The number of incremental updates since the last refresh. */
+
+    Eigen::VectorXd     m_vecOscSin;                /**< The current sine value of each coil oscillator. */
+    Eigen::VectorXd     m_vecOscCos;                /**< The current cosine value of each coil oscillator. */
+    Eigen::VectorXd     m_vecStepSin;               /**< The sine of the phase increment per sample of each coil. */
+    Eigen::VectorXd     m_vecStepCos;               /**< The cosine of the phase increment per sample of each coil. */
+
+    Eigen::MatrixXd     m_matDataWindow;            /**< The demodulated channels of the window (channels x window). */
+    Eigen::MatrixXd     m_matRefWindow;             /**< The references of the window, sines first (2*coils x window). */
+    Eigen::MatrixXd     m_matCorr;                  /**< Running correlation of data and references (channels x 2*coils). */
+    Eigen::MatrixXd     m_matGram;                  /**< Running Gram matrix of the references (2*coils x 2*coils). */
+};
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INLINE DEFINITIONS
+//=============================================================================================================
+
+inline bool HPILockIn::isReady() const
+{
+    return m_iNumSamples >= m_iWindowSize;
+}
+
+
+//*************************************************************************************************************
+
+inline int HPILockIn::getWindowSize() const
+{
+    return m_iWindowSize;
+}
+
+
+//*************************************************************************************************************
+
+inline const QVector<int>& HPILockIn::getChannels() const
+{
+    return m_vChannels;
+}
+
+
+//*************************************************************************************************************
+
+inline const QVector<int>& HPILockIn::getFrequencies() const
+{
+    return m_vFreqs;
+}
+
+} //NAMESPACE
+
+#endif // HPILOCKIN_H
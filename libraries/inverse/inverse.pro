@@ -100,7 +100,8 @@ SOURCES += \
     c/mne_meas_data.cpp \
     c/mne_meas_data_set.cpp \
     hpiFit/hpifit.cpp \
-    hpiFit/hpifitdata.cpp
+    hpiFit/hpifitdata.cpp \
+    hpiFit/hpilockin.cpp
 
 
 HEADERS +=\
@@ -122,7 +123,8 @@ HEADERS +=\
     c/mne_meas_data.h \
     c/mne_meas_data_set.h \
     hpiFit/hpifit.h \
-    hpiFit/hpifitdata.h
+    hpiFit/hpifitdata.h \
+    hpiFit/hpilockin.h
 
 RESOURCE_FILES +=\
     $${ROOT_DIR}/resources/general/coilDefinitions/coil_def.dat \
@@ -58,6 +58,16 @@
 //=============================================================================================================
 
 #include <Eigen/Core>
+#include <Eigen/SVD>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QHash>
+#include <QCryptographicHash>
 
 
 //*************************************************************************************************************
@@ -67,6 +77,7 @@
 
 using namespace Eigen;
 using namespace MNELIB;
+using namespace FSLIB;
 using namespace INVERSELIB;
 
 
@@ -78,7 +89,10 @@ using namespace INVERSELIB;
 MinimumNorm::MinimumNorm(const MNEInverseOperator &p_inverseOperator, float lambda, const QString method)
 : m_inverseOperator(p_inverseOperator)
 , inverseSetup(false)
+, m_bUseFloatKernel(false)
+, m_pKernel(new MinimumNormKernel)
 {
+    m_cacheKernels.setMaxCost(1024);
     this->setRegularization(lambda);
     this->setMethod(method);
 }
@@ -88,7 +102,10 @@ MinimumNorm::MinimumNorm(const MNEInverseOperator &p_inverseOperator, float lamb
 MinimumNorm::MinimumNorm(const MNEInverseOperator &p_inverseOperator, float lambda, bool dSPM, bool sLORETA)
 : m_inverseOperator(p_inverseOperator)
 , inverseSetup(false)
+, m_bUseFloatKernel(false)
+, m_pKernel(new MinimumNormKernel)
 {
+    m_cacheKernels.setMaxCost(1024);
     this->setRegularization(lambda);
     this->setMethod(dSPM, sLORETA);
 }
@@ -113,7 +130,7 @@ MNESourceEstimate MinimumNorm::calculateInverse(const FiffEvoked &p_fiffEvoked,
     //
     //   Pick the correct channels from the data
     //
-    FiffEvoked t_fiffEvoked = p_fiffEvoked.pick_channels(inv.noise_cov->names);
+    FiffEvoked t_fiffEvoked = p_fiffEvoked.pick_channels(m_pKernel->inv.noise_cov->names);
 
     printf("Picked %d channels from the data\n",t_fiffEvoked.info.nchan);
 
@@ -200,51 +217,128 @@ MNESourceEstimate MinimumNorm::calculateInverse(const MatrixXd &data, float tmin
         return MNESourceEstimate();
     }
 
-    if(K.cols() != data.rows()) {
-        qWarning() << "MinimumNorm::calculateInverse - Dimension mismatch between K.cols() and data.rows() -" << K.cols() << "and" << data.rows();
+    const MinimumNormKernel &kernel = *m_pKernel;
+
+    if(kernel.KFused.cols() != data.rows()) {
+        qWarning() << "MinimumNorm::calculateInverse - Dimension mismatch between K.cols() and data.rows() -" << kernel.KFused.cols() << "and" << data.rows();
         return MNESourceEstimate();
     }
 
-    MatrixXd sol = K * data; //apply imaging kernel
-
+    //apply imaging kernel, the noise normalization (dSPM, sLORETA) is already folded into the kernel
+    MatrixXd sol;
+    if(m_bUseFloatKernel && kernel.KFusedFloat.size() > 0) {
+        MatrixXf solFloat = kernel.KFusedFloat * data.cast<float>();
+        sol = solFloat.cast<double>();
+    } else {
+        sol = kernel.KFused * data;
+    }
 
-    if (inv.source_ori == FIFFV_MNE_FREE_ORI && pick_normal == false)
+    if (kernel.inv.source_ori == FIFFV_MNE_FREE_ORI && pick_normal == false)
     {
+        if(sol.rows() % 3 != 0) {
+            qWarning() << "MinimumNorm::calculateInverse - The free orientation kernel has" << sol.rows() << "rows, which is not a multiple of 3. Returning empty source estimate.";
+            return MNESourceEstimate();
+        }
+
         printf("combining the current components...\n");
 
+        // Norm over the consecutive x, y, z rows of every source and time point
         MatrixXd sol1(sol.rows()/3,sol.cols());
-        for(qint32 i = 0; i < sol.cols(); ++i)
-        {
-            VectorXd* tmp = MNEMath::combine_xyz(sol.col(i));
-            sol1.block(0,i,sol.rows()/3,1) = tmp->cwiseSqrt();
-            delete tmp;
-        }
-        sol.resize(sol1.rows(),sol1.cols());
-        sol = sol1;
+        Map<const MatrixXd> solXyz(sol.data(), 3, sol.size()/3);
+        Map<RowVectorXd>(sol1.data(), sol1.size()) = solXyz.colwise().norm();
+        sol.swap(sol1);
     }
 
-    if (m_bdSPM)
-    {
-        printf("(dSPM)...");
-        sol = inv.noisenorm*sol;
-    }
-    else if (m_bsLORETA)
-    {
-        printf("(sLORETA)...");
-        sol = inv.noisenorm*sol;
-    }
     printf("[done]\n");
 
     //Results
-    VectorXi p_vecVertices(inv.src[0].vertno.size() + inv.src[1].vertno.size());
-    p_vecVertices << inv.src[0].vertno, inv.src[1].vertno;
+    return MNESourceEstimate(sol, kernel.vecVertices, tmin, tstep);
+}
 
-//    VectorXi p_vecVertices();
-//    for(qint32 h = 0; h < inv.src.size(); ++h)
-//        t_qListVertices.push_back(inv.src[h].vertno);
 
-    return MNESourceEstimate(sol, p_vecVertices, tmin, tstep);
+//*************************************************************************************************************
+
+MatrixXd MinimumNorm::calculateInverseRoi(const MatrixXd &data,
+                                          qint32 nave,
+                                          const AnnotationSet &p_annotationSet,
+                                          const QStringList &p_lRoiNames,
+                                          const QString &sMode,
+                                          QStringList &p_lRoiNamesOut)
+{
+    p_lRoiNamesOut.clear();
+
+    QString t_sMode = sMode;
+    if(t_sMode != "mean" && t_sMode != "mean_flip" && t_sMode != "pca_flip") {
+        qWarning() << "MinimumNorm::calculateInverseRoi - Mode" << sMode << "not recognized. Using mean.";
+        t_sMode = "mean";
+    }
+
+    //
+    //   Identify the configuration, the rows are only assembled again if it changed
+    //
+    QString sAnnotationKey;
+    for(qint32 h = 0; h < p_annotationSet.size(); ++h) {
+        VectorXi vecLabelIds = p_annotationSet[h].getLabelIds();
+        sAnnotationKey += QString("%1_%2_").arg(vecLabelIds.size()).arg(vecLabelIds.cast<qint64>().sum());
+    }
+
+    QString sKey = QString("%1_%2_%3_%4").arg(kernelCacheKey(nave, false)).arg(sAnnotationKey).arg(p_lRoiNames.join(",")).arg(t_sMode);
+
+    if(!m_pRoiKernel || m_pRoiKernel->sKey != sKey) {
+        m_pRoiKernel = assembleRoiKernel(nave, p_annotationSet, p_lRoiNames, t_sMode, sKey);
+    }
+
+    if(!m_pRoiKernel) {
+        return MatrixXd();
+    }
+
+    const MinimumNormRoiKernel &roiKernel = *m_pRoiKernel;
+
+    //
+    //   Linear modes: one aggregated kernel row per parcel
+    //
+    if(roiKernel.matAggregatedKernel.size() > 0) {
+        if(roiKernel.matAggregatedKernel.cols() != data.rows()) {
+            qWarning() << "MinimumNorm::calculateInverseRoi - Dimension mismatch between K.cols() and data.rows() -" << roiKernel.matAggregatedKernel.cols() << "and" << data.rows();
+            return MatrixXd();
+        }
 
+        p_lRoiNamesOut = roiKernel.lRoiNames;
+        return roiKernel.matAggregatedKernel * data;
+    }
+
+    //
+    //   Non linear modes: apply the kernel rows of each parcel
+    //
+    MatrixXd matRoiData(roiKernel.lKernels.size(), data.cols());
+
+    for(qint32 r = 0; r < roiKernel.lKernels.size(); ++r) {
+        const MatrixXd &matKernel = roiKernel.lKernels[r];
+
+        if(matKernel.cols() != data.rows()) {
+            qWarning() << "MinimumNorm::calculateInverseRoi - Dimension mismatch between K.cols() and data.rows() -" << matKernel.cols() << "and" << data.rows();
+            return MatrixXd();
+        }
+
+        MatrixXd matSourceData = matKernel * data;
+        qint32 iNumSources = matSourceData.rows() / roiKernel.iRowsPerSource;
+
+        if(roiKernel.iRowsPerSource == 3) {
+            // Mean of the current magnitudes
+            Map<const MatrixXd> matXyz(matSourceData.data(), 3, matSourceData.size()/3);
+            RowVectorXd vecMagnitude = matXyz.colwise().norm();
+            matRoiData.row(r) = Map<MatrixXd>(vecMagnitude.data(), iNumSources, data.cols()).colwise().mean();
+        } else {
+            // First principal component, scaled and sign aligned with the flipped sources
+            JacobiSVD<MatrixXd> svd(matSourceData, ComputeThinU | ComputeThinV);
+            double dSign = svd.matrixU().col(0).dot(roiKernel.lFlips[r]) < 0.0 ? -1.0 : 1.0;
+            double dScale = svd.singularValues().norm() / sqrt((double)iNumSources);
+            matRoiData.row(r) = dSign * dScale * svd.matrixV().col(0).transpose();
+        }
+    }
+
+    p_lRoiNamesOut = roiKernel.lRoiNames;
+    return matRoiData;
 }
 
 
@@ -252,20 +346,217 @@ MNESourceEstimate MinimumNorm::calculateInverse(const MatrixXd &data, float tmin
 
 void MinimumNorm::doInverseSetup(qint32 nave, bool pick_normal)
 {
+    QString sKey = kernelCacheKey(nave, pick_normal);
+
+    if(MinimumNormKernel::SPtr* pCachedKernel = m_cacheKernels.object(sKey)) {
+        m_pKernel = *pCachedKernel;
+        m_sKernelKey = sKey;
+        m_matKernel.resize(0,0);
+        if(m_bUseFloatKernel && m_pKernel->KFusedFloat.size() == 0) {
+            m_pKernel->KFusedFloat = m_pKernel->KFused.cast<float>();
+            cacheKernel(sKey, m_pKernel);
+        } else if(!m_bUseFloatKernel && m_pKernel->KFusedFloat.size() > 0) {
+            m_pKernel->KFusedFloat = MatrixXf();
+            cacheKernel(sKey, m_pKernel);
+        }
+        inverseSetup = true;
+        return;
+    }
+
+    MinimumNormKernel::SPtr pKernel(new MinimumNormKernel);
+
     //
     //   Set up the inverse according to the parameters
     //
-    inv = m_inverseOperator.prepare_inverse_operator(nave, m_fLambda, m_bdSPM, m_bsLORETA);
+    pKernel->inv = m_inverseOperator.prepare_inverse_operator(nave, m_fLambda, m_bdSPM, m_bsLORETA);
 
     printf("Computing inverse...\n");
-    inv.assemble_kernel(label, m_sMethod, pick_normal, K, noise_norm, vertno);
+    pKernel->inv.assemble_kernel(label, m_sMethod, pick_normal, pKernel->KFused, pKernel->noise_norm, pKernel->vertno);
 
-    std::cout << "K " << K.rows() << " x " << K.cols() << std::endl;
+    std::cout << "K " << pKernel->KFused.rows() << " x " << pKernel->KFused.cols() << std::endl;
 
+    //
+    //   Fold the noise normalization into the kernel. The factors are positive and one per source location,
+    //   so they commute with combining the current components. Only the fused kernel is kept.
+    //
+    if((m_bdSPM || m_bsLORETA) && pKernel->noise_norm.rows() > 0
+       && pKernel->KFused.rows() % pKernel->noise_norm.rows() == 0) {
+        qint32 iRowsPerSource = pKernel->KFused.rows() / pKernel->noise_norm.rows();
+        VectorXd vecNoiseNorm = pKernel->noise_norm.diagonal();
+
+        for(qint32 i = 0; i < pKernel->KFused.rows(); ++i) {
+            pKernel->KFused.row(i) *= vecNoiseNorm[i / iRowsPerSource];
+        }
+    } else {
+        if((m_bdSPM || m_bsLORETA) && pKernel->noise_norm.rows() > 0) {
+            qWarning() << "MinimumNorm::doInverseSetup - Dimension mismatch between K and noise normalization -" << pKernel->KFused.rows() << "and" << pKernel->noise_norm.rows();
+        }
+        pKernel->noise_norm = SparseMatrix<double>();
+    }
+
+    if(m_bUseFloatKernel) {
+        pKernel->KFusedFloat = pKernel->KFused.cast<float>();
+    }
+
+    qint32 iNumVertices = 0;
+    for(qint32 h = 0; h < pKernel->vertno.size(); ++h) {
+        iNumVertices += pKernel->vertno[h].size();
+    }
+    pKernel->vecVertices.resize(iNumVertices);
+    iNumVertices = 0;
+    for(qint32 h = 0; h < pKernel->vertno.size(); ++h) {
+        pKernel->vecVertices.segment(iNumVertices, pKernel->vertno[h].size()) = pKernel->vertno[h];
+        iNumVertices += pKernel->vertno[h].size();
+    }
+
+    cacheKernel(sKey, pKernel);
+
+    m_pKernel = pKernel;
+    m_sKernelKey = sKey;
+    m_matKernel.resize(0,0);
     inverseSetup = true;
 }
 
 
+//*************************************************************************************************************
+
+MinimumNormRoiKernel::SPtr MinimumNorm::assembleRoiKernel(qint32 nave,
+                                                          const AnnotationSet &p_annotationSet,
+                                                          const QStringList &p_lRoiNames,
+                                                          const QString &sMode,
+                                                          const QString &sKey) const
+{
+    //
+    //   Prepare without noise normalization, the factors are only computed for the sources within the parcels
+    //
+    MNEInverseOperator t_inv = m_inverseOperator.prepare_inverse_operator(nave, m_fLambda, false, false);
+
+    if(!t_inv.eigen_leads || !t_inv.source_cov) {
+        qWarning("MinimumNorm::assembleRoiKernel - Inverse operator could not be prepared.");
+        return MinimumNormRoiKernel::SPtr();
+    }
+
+    MinimumNormRoiKernel::SPtr pRoiKernel(new MinimumNormRoiKernel);
+    pRoiKernel->sKey = sKey;
+
+    bool bFreeOri = t_inv.source_ori == FIFFV_MNE_FREE_ORI;
+    bool bLoose = bFreeOri && t_inv.orient_prior && (0 < t_inv.orient_prior->data(0,0)) && (t_inv.orient_prior->data(0,0) < 1);
+    pRoiKernel->iRowsPerSource = (bFreeOri && !bLoose) ? 3 : 1;
+
+    if(pRoiKernel->iRowsPerSource == 3 && sMode != "mean") {
+        qWarning() << "MinimumNorm::assembleRoiKernel - Mode" << sMode << "needs signed source time courses. Using the mean of the current magnitudes.";
+    }
+
+    // The channel transformation is shared by the kernel rows of all parcels
+    MatrixXd matTrans = t_inv.compute_kernel_trans();
+
+    qint32 iOffset = 0;
+    for(qint32 h = 0; h < t_inv.src.size() && h < p_annotationSet.size(); ++h) {
+        const MNEHemisphere &hemisphere = t_inv.src[h];
+        Annotation annotation = p_annotationSet[h];
+        Colortable colortable = annotation.getColortable();
+        VectorXi vecLabelIds = colortable.getLabelIds();
+        const VectorXi &vecVertexLabelIds = annotation.getLabelIds();
+        QString sHemi = h == 0 ? "lh" : "rh";
+
+        // Sources per label id
+        QHash<qint32, QList<qint32> > hashSources;
+        for(qint32 i = 0; i < hemisphere.vertno.size(); ++i) {
+            if(hemisphere.vertno[i] < vecVertexLabelIds.size()) {
+                hashSources[vecVertexLabelIds[hemisphere.vertno[i]]].append(i);
+            }
+        }
+
+        for(qint32 l = 0; l < vecLabelIds.size(); ++l) {
+            if(vecLabelIds[l] == 0 || l >= colortable.struct_names.size()) {
+                continue;
+            }
+
+            QString sName = QString("%1-%2").arg(colortable.struct_names[l]).arg(sHemi);
+            if(!p_lRoiNames.isEmpty() && !p_lRoiNames.contains(sName)) {
+                continue;
+            }
+
+            const QList<qint32> lSources = hashSources.value(vecLabelIds[l]);
+            if(lSources.isEmpty()) {
+                continue;
+            }
+
+            qint32 iNumSources = lSources.size();
+            VectorXi vecSources(iNumSources);
+            VectorXi vecRows(iNumSources * pRoiKernel->iRowsPerSource);
+            MatrixXd matNormals(iNumSources, 3);
+
+            for(qint32 j = 0; j < iNumSources; ++j) {
+                vecSources[j] = iOffset + lSources[j];
+
+                if(pRoiKernel->iRowsPerSource == 3) {
+                    vecRows.segment(3*j, 3) << 3*vecSources[j], 3*vecSources[j]+1, 3*vecSources[j]+2;
+                } else {
+                    // Normal component for free orientations with loose constraint
+                    vecRows[j] = bFreeOri ? 3*vecSources[j]+2 : vecSources[j];
+                }
+
+                if(hemisphere.vertno[lSources[j]] < hemisphere.nn.rows()) {
+                    matNormals.row(j) = hemisphere.nn.row(hemisphere.vertno[lSources[j]]).cast<double>();
+                } else {
+                    matNormals.row(j).setZero();
+                }
+            }
+
+            MatrixXd matKernel;
+            if(!t_inv.assemble_kernel_rows(vecRows, matTrans, matKernel)) {
+                return MinimumNormRoiKernel::SPtr();
+            }
+
+            if(m_bdSPM || m_bsLORETA) {
+                VectorXd vecNoiseNorm = t_inv.compute_noise_norm(vecSources, m_fLambda, m_bdSPM);
+                for(qint32 r = 0; r < matKernel.rows(); ++r) {
+                    matKernel.row(r) *= vecNoiseNorm[r / pRoiKernel->iRowsPerSource];
+                }
+            }
+
+            // Sign flips aligning the source normals with the dominant orientation of the parcel
+            JacobiSVD<MatrixXd> svd(matNormals, ComputeThinV);
+            VectorXd vecFlip = matNormals * svd.matrixV().col(0);
+            for(qint32 j = 0; j < iNumSources; ++j) {
+                vecFlip[j] = vecFlip[j] < 0.0 ? -1.0 : 1.0;
+            }
+            if(vecFlip.sum() < 0.0) {
+                vecFlip *= -1.0;
+            }
+
+            pRoiKernel->lRoiNames.append(sName);
+            pRoiKernel->lKernels.append(matKernel);
+            pRoiKernel->lFlips.append(vecFlip);
+        }
+
+        iOffset += hemisphere.vertno.size();
+    }
+
+    //
+    //   Linear modes are reduced to one kernel row per parcel
+    //
+    if(pRoiKernel->iRowsPerSource == 1 && (sMode == "mean" || sMode == "mean_flip") && !pRoiKernel->lKernels.isEmpty()) {
+        pRoiKernel->matAggregatedKernel.resize(pRoiKernel->lKernels.size(), pRoiKernel->lKernels.first().cols());
+
+        for(qint32 r = 0; r < pRoiKernel->lKernels.size(); ++r) {
+            if(sMode == "mean") {
+                pRoiKernel->matAggregatedKernel.row(r) = pRoiKernel->lKernels[r].colwise().mean();
+            } else {
+                pRoiKernel->matAggregatedKernel.row(r) = (pRoiKernel->lFlips[r].transpose() * pRoiKernel->lKernels[r]) / pRoiKernel->lKernels[r].rows();
+            }
+        }
+
+        pRoiKernel->lKernels.clear();
+    }
+
+    printf("Assembled region of interest kernel for %d parcels.\n", pRoiKernel->lRoiNames.size());
+
+    return pRoiKernel;
+}
+
+
 //*************************************************************************************************************
 
 const char* MinimumNorm::getName() const
@@ -333,3 +624,99 @@ void MinimumNorm::setRegularization(float lambda)
 {
     m_fLambda = lambda;
 }
+
+
+//*************************************************************************************************************
+
+void MinimumNorm::setLabel(const Label &p_label)
+{
+    label = p_label;
+}
+
+
+//*************************************************************************************************************
+
+void MinimumNorm::setMaxCacheSize(int iMaxCacheSizeMB)
+{
+    m_cacheKernels.setMaxCost(iMaxCacheSizeMB);
+}
+
+
+//*************************************************************************************************************
+
+void MinimumNorm::setUseFloatKernel(bool bUseFloatKernel)
+{
+    m_bUseFloatKernel = bUseFloatKernel;
+
+    if(m_bUseFloatKernel && inverseSetup && m_pKernel->KFusedFloat.size() == 0) {
+        m_pKernel->KFusedFloat = m_pKernel->KFused.cast<float>();
+        cacheKernel(m_sKernelKey, m_pKernel);
+    }
+
+    if(!m_bUseFloatKernel) {
+        // Release the single precision copies, the current kernel might not be part of the cache
+        m_pKernel->KFusedFloat = MatrixXf();
+
+        foreach(const QString& sKey, m_cacheKernels.keys()) {
+            MinimumNormKernel::SPtr pKernel = *m_cacheKernels.object(sKey);
+            if(pKernel->KFusedFloat.size() > 0) {
+                pKernel->KFusedFloat = MatrixXf();
+                cacheKernel(sKey, pKernel);
+            }
+        }
+    }
+}
+
+
+//*************************************************************************************************************
+
+MatrixXd& MinimumNorm::getKernel()
+{
+    if(m_matKernel.size() == 0 && inverseSetup) {
+        m_matKernel = m_pKernel->KFused;
+
+        if(m_pKernel->noise_norm.rows() > 0) {
+            qint32 iRowsPerSource = m_matKernel.rows() / m_pKernel->noise_norm.rows();
+            VectorXd vecNoiseNorm = m_pKernel->noise_norm.diagonal();
+
+            for(qint32 i = 0; i < m_matKernel.rows(); ++i) {
+                m_matKernel.row(i) /= vecNoiseNorm[i / iRowsPerSource];
+            }
+        }
+    }
+
+    return m_matKernel;
+}
+
+
+//*************************************************************************************************************
+
+void MinimumNorm::clearCache()
+{
+    m_cacheKernels.clear();
+}
+
+
+//*************************************************************************************************************
+
+QString MinimumNorm::kernelCacheKey(qint32 nave, bool pick_normal) const
+{
+    QString sLabelKey("all");
+    if(!label.isEmpty()) {
+        // The vertex count and sum of two labels can agree, so the key holds a digest of the vertex list
+        QByteArray baVertices(reinterpret_cast<const char*>(label.vertices.data()), label.vertices.size() * sizeof(int));
+        sLabelKey = QString("%1_%2_%3_%4").arg(label.hemi).arg(label.label_id).arg(label.name).arg(QString(QCryptographicHash::hash(baVertices, QCryptographicHash::Sha1).toHex()));
+    }
+
+    return QString("%1_%2_%3_%4_%5").arg(nave).arg(m_fLambda, 0, 'g', 10).arg(m_sMethod).arg(pick_normal).arg(sLabelKey);
+}
+
+
+//*************************************************************************************************************
+
+void MinimumNorm::cacheKernel(const QString& sKey, const MinimumNormKernel::SPtr& pKernel)
+{
+    // Cost in MB, kernels larger than the cache are not stored. Inserting an existing key replaces the entry.
+    int iCost = 1 + (int)((pKernel->KFused.size() * sizeof(double) + pKernel->KFusedFloat.size() * sizeof(float)) / (1024 * 1024));
+    m_cacheKernels.insert(sKey, new MinimumNormKernel::SPtr(pKernel), iCost);
+}
@@ -46,8 +46,11 @@
 
 #include <mne/mne_inverse_operator.h>
 #include <fs/label.h>
+#include <fs/annotationset.h>
 
 #include <QSharedPointer>
+#include <QCache>
+#include <QString>
 
 
 //*************************************************************************************************************
@@ -73,6 +76,48 @@ using namespace MNELIB;
 using namespace FSLIB;
 
 
+//=============================================================================================================
+/**
+* Holds everything which results from one inverse setup (prepare_inverse_operator and assemble_kernel), i.e.
+* one entry of the MinimumNorm kernel cache.
+*
+* @brief Prepared minimum norm kernel
+*/
+struct MinimumNormKernel
+{
+    typedef QSharedPointer<MinimumNormKernel> SPtr;             /**< Shared pointer type for MinimumNormKernel. */
+    typedef QSharedPointer<const MinimumNormKernel> ConstSPtr;  /**< Const shared pointer type for MinimumNormKernel. */
+
+    MNEInverseOperator inv;                 /**< The setup inverse operator */
+    MatrixXd KFused;                        /**< Imaging kernel with the noise normalization folded in */
+    MatrixXf KFusedFloat;                   /**< Single precision copy of KFused, only present if the float path is used */
+    SparseMatrix<double> noise_norm;        /**< The noise normalization folded into KFused, empty if none was applied */
+    QList<VectorXi> vertno;                 /**< The vertices numbers */
+    VectorXi vecVertices;                   /**< The concatenated vertices numbers */
+};
+
+
+//=============================================================================================================
+/**
+* Holds the kernel rows of the sources within a set of regions of interest (parcels) together with the
+* pre-aggregated kernels used for the linear aggregation modes.
+*
+* @brief Prepared region of interest minimum norm kernel
+*/
+struct MinimumNormRoiKernel
+{
+    typedef QSharedPointer<MinimumNormRoiKernel> SPtr;              /**< Shared pointer type for MinimumNormRoiKernel. */
+    typedef QSharedPointer<const MinimumNormRoiKernel> ConstSPtr;   /**< Const shared pointer type for MinimumNormRoiKernel. */
+
+    QString sKey;                           /**< The configuration the kernel was assembled for */
+    QStringList lRoiNames;                  /**< The names of the parcels ("name-lh" | "name-rh") */
+    qint32 iRowsPerSource;                  /**< 1 for fixed or normal orientation, 3 for the free orientation magnitude */
+    QList<MatrixXd> lKernels;               /**< The noise normalized kernel rows of the sources of each parcel */
+    QList<VectorXd> lFlips;                 /**< The sign flips (+1/-1) of the sources of each parcel */
+    MatrixXd matAggregatedKernel;           /**< One aggregated kernel row per parcel for the linear modes */
+};
+
+
 //=============================================================================================================
 /**
 * Minimum norm estimation algorithm ToDo: Paper references.
@@ -127,6 +172,30 @@ public:
 
     virtual MNESourceEstimate calculateInverse(const MatrixXd &data, float tmin, float tstep, bool pick_normal = false) const;
 
+    //=========================================================================================================
+    /**
+    * Computes the time courses of regions of interest (parcels of an annotation set) directly from sensor data.
+    * Only the kernel rows of the sources inside the requested parcels are assembled and the full kernel is
+    * never built, so the cost is proportional to the number of sources within the parcels. The assembled rows
+    * are kept until the configuration (nave, lambda, method, parcels, mode) changes. For free orientation
+    * operators with loose orientation constraint the normal component is used, otherwise the magnitude.
+    *
+    * @param[in] data           The sensor data (picked as the inverse operator channels) channels x times.
+    * @param[in] nave           Number of averages to use.
+    * @param[in] p_annotationSet    The parcellation.
+    * @param[in] p_lRoiNames    The parcels to evaluate ("name-lh" | "name-rh"). All parcels if empty.
+    * @param[in] sMode          The aggregation within a parcel: "mean", "mean_flip" or "pca_flip".
+    * @param[out] p_lRoiNamesOut    The names of the returned rows.
+    *
+    * @return the parcel time courses (parcels x times)
+    */
+    MatrixXd calculateInverseRoi(const MatrixXd &data,
+                                 qint32 nave,
+                                 const AnnotationSet &p_annotationSet,
+                                 const QStringList &p_lRoiNames,
+                                 const QString &sMode,
+                                 QStringList &p_lRoiNamesOut);
+
     //=========================================================================================================
     /**
     * Perform the inverse setup: Prepares this inverse operator and assembles the kernel.
@@ -188,13 +257,98 @@ public:
 
     //=========================================================================================================
     /**
-    * Get the assembled kernel
+    * Restricts the kernel to a label. An empty label (default) uses all sources.
+    *
+    * @param[in] p_label   The label
+    */
+    void setLabel(const Label &p_label);
+
+    //=========================================================================================================
+    /**
+    * Sets the maximal memory used by the kernel cache. Prepared kernels are kept in a least recently used cache
+    * keyed on (nave, lambda, method, pick_normal, label) so switching between them does not need another
+    * prepare_inverse_operator/assemble_kernel run. Default is 1024 MB.
+    *
+    * @param[in] iMaxCacheSizeMB   The maximal cache size in MB. 0 disables the cache.
+    */
+    void setMaxCacheSize(int iMaxCacheSizeMB);
+
+    //=========================================================================================================
+    /**
+    * Enables the single precision kernel application. The kernel is stored additionally as float and
+    * calculateInverse casts the data to float, so the product is computed and accumulated in single precision
+    * and only converted to double afterwards. This halves the memory traffic of the kernel and roughly doubles
+    * the GEMM throughput. Only the combination of the current components is done in double precision. The
+    * relative error grows with the number of channels, it is in the order of 1e-6 for typical MEG/EEG setups.
+    * Disabling it releases the float copies of the current and the cached kernels. Default is false.
+    *
+    * @param[in] bUseFloatKernel    Whether to apply the kernel in single precision.
+    */
+    void setUseFloatKernel(bool bUseFloatKernel);
+
+    //=========================================================================================================
+    /**
+    * Returns whether the single precision kernel application is enabled.
+    *
+    * @return true if the kernel is applied in single precision.
+    */
+    inline bool getUseFloatKernel() const;
+
+    //=========================================================================================================
+    /**
+    * Removes all prepared kernels from the cache. Has to be called if the inverse operator data is changed.
+    */
+    void clearCache();
+
+    //=========================================================================================================
+    /**
+    * Get the assembled kernel without the noise normalization. Only the fused kernel is cached, so this kernel is
+    * restored from it on the first call after each inverse setup.
     *
     * @return the assembled kernel
     */
-    inline MatrixXd& getKernel();
+    MatrixXd& getKernel();
 
 private:
+    //=========================================================================================================
+    /**
+    * Creates the key of the kernel cache.
+    *
+    * @param[in] nave           Number of averages.
+    * @param[in] pick_normal    Whether only the normal components are used.
+    *
+    * @return the cache key
+    */
+    QString kernelCacheKey(qint32 nave, bool pick_normal) const;
+
+    //=========================================================================================================
+    /**
+    * Inserts a kernel into the kernel cache with its current memory as cost. Has to be called again whenever the
+    * memory of a cached kernel grows, e.g., when the single precision copy is added.
+    *
+    * @param[in] sKey       The cache key.
+    * @param[in] pKernel    The kernel.
+    */
+    void cacheKernel(const QString& sKey, const MinimumNormKernel::SPtr& pKernel);
+
+    //=========================================================================================================
+    /**
+    * Assembles the kernel rows and aggregated kernels of the requested parcels.
+    *
+    * @param[in] nave               Number of averages to use.
+    * @param[in] p_annotationSet    The parcellation.
+    * @param[in] p_lRoiNames        The parcels to evaluate. All parcels if empty.
+    * @param[in] sMode              The aggregation mode.
+    * @param[in] sKey               The key of the configuration.
+    *
+    * @return the region of interest kernel
+    */
+    MinimumNormRoiKernel::SPtr assembleRoiKernel(qint32 nave,
+                                                 const AnnotationSet &p_annotationSet,
+                                                 const QStringList &p_lRoiNames,
+                                                 const QString &sMode,
+                                                 const QString &sKey) const;
+
     MNEInverseOperator m_inverseOperator;   /**< The inverse operator */
     float m_fLambda;                        /**< Regularization parameter */
     QString m_sMethod;                      /**< Selected method */
@@ -202,12 +356,14 @@ private:
     bool m_bdSPM;                           /**< Do dSPM method */
 
     bool inverseSetup;                      /**< Inverse Setup Calcluated */
-    MNEInverseOperator inv;                 /**< The setup inverse operator */
-    SparseMatrix<double> noise_norm;        /**< The noise normalization */
-    QList<VectorXi> vertno;                 /**< The vertices numbers */
+    bool m_bUseFloatKernel;                 /**< Apply the kernel in single precision */
     Label label;                            /**< The corresponding labels */
-    MatrixXd K;                             /**< Imaging kernel */
 
+    MinimumNormKernel::SPtr m_pKernel;                          /**< The current prepared kernel */
+    MatrixXd m_matKernel;                                       /**< The current kernel without noise normalization, restored on demand */
+    QString m_sKernelKey;                                       /**< The cache key of the current prepared kernel */
+    QCache<QString, MinimumNormKernel::SPtr> m_cacheKernels;    /**< LRU cache of prepared kernels, cost in MB */
+    MinimumNormRoiKernel::SPtr m_pRoiKernel;                    /**< The current region of interest kernel */
 };
 
 //*************************************************************************************************************
@@ -215,17 +371,17 @@ private:
 // INLINE DEFINITIONS
 //=============================================================================================================
 
-inline MatrixXd& MinimumNorm::getKernel()
+inline MNEInverseOperator& MinimumNorm::getPreparedInverseOperator()
 {
-    return K;
+    return m_pKernel->inv;
 }
 
 
 //*************************************************************************************************************
 
-inline MNEInverseOperator& MinimumNorm::getPreparedInverseOperator()
+inline bool MinimumNorm::getUseFloatKernel() const
 {
-    return inv;
+    return m_bUseFloatKernel;
 }
 
 } //NAMESPACE
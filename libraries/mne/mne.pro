@@ -75,6 +75,9 @@ SOURCES += \
     mne_sourcespace.cpp \
     mne_forwardsolution.cpp \
     mne_sourceestimate.cpp \
+    mne_chunked_stc_reader.cpp \
+    mne_chunked_stc_writer.cpp \
+    mne_source_morph.cpp \
     mne_hemisphere.cpp \
     mne_inverse_operator.cpp \
     mne_epoch_data.cpp \
@@ -126,6 +129,9 @@ HEADERS += \
     mne_hemisphere.h \
     mne_forwardsolution.h \
     mne_sourceestimate.h \
+    mne_chunked_stc_reader.h \
+    mne_chunked_stc_writer.h \
+    mne_source_morph.h \
     mne_inverse_operator.h \
     mne_epoch_data.h \
     mne_epoch_data_list.h \
@@ -0,0 +1,354 @@
+//=============================================================================================================
+/**
+* @file     mne_chunked_stc_reader.cpp
+* @author   agent <agent@local>
+* @version  1.0
+* @date     October, 2026
+*
+* @section  LICENSE
+*
+* Copyright (C) 2026, agent. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+*
+* @brief    Definition of the MNEChunkedStcReader Class.
+*
+*/
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "mne_chunked_stc_reader.h"
+
+#include <cstring>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// Qt INCLUDES
+//=============================================================================================================
+
+#include <QtEndian>
+#include <QDebug>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// USED NAMESPACES
+//=============================================================================================================
+
+using namespace MNELIB;
+using namespace Eigen;
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE GLOBAL METHODS
+//=============================================================================================================
+
+namespace {
+
+//=============================================================================================================
+/**
+* Copies little endian 32 bit values and converts them to the host byte order.
+*/
+template<typename T>
+void fromLittleEndian32(const uchar* pSrc, T* pDest, qint64 iCount)
+{
+    for(qint64 i = 0; i < iCount; ++i) {
+        quint32 iValue;
+        memcpy(&iValue, pSrc + 4 * i, 4);
+        iValue = qFromLittleEndian(iValue);
+        memcpy(pDest + i, &iValue, 4);
+    }
+}
+
+}
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE MEMBER METHODS
+//=============================================================================================================
+
+MNEChunkedStcReader::MNEChunkedStcReader(const QString& sFileName)
+: m_file(sFileName)
+, m_pMap(Q_NULLPTR)
+, m_iMappedSize(0)
+, m_iScanOffset(0)
+, m_fTmin(0)
+, m_fTstep(-1)
+, m_bCompressed(false)
+, m_bIsOpen(false)
+, m_iSamples(0)
+, m_iCachedChunk(-1)
+{
+    if(!m_file.open(QIODevice::ReadOnly)) {
+        qWarning() << "MNEChunkedStcReader - Could not open" << sFileName;
+        return;
+    }
+
+    if(!readHeader()) {
+        qWarning() << "MNEChunkedStcReader -" << sFileName << "is not a chunked source estimate file";
+        m_file.close();
+        return;
+    }
+
+    m_bIsOpen = true;
+
+    refresh();
+}
+
+
+//*************************************************************************************************************
+
+MNEChunkedStcReader::~MNEChunkedStcReader()
+{
+    if(m_pMap) {
+        m_file.unmap(m_pMap);
+    }
+}
+
+
+//*************************************************************************************************************
+
+bool MNEChunkedStcReader::refresh()
+{
+    if(!m_bIsOpen) {
+        return false;
+    }
+
+    QMutexLocker locker(&m_mutex);
+
+    qint64 iFileSize = m_file.size();
+
+    //Index the completely written chunks behind the last indexed one
+    while(m_iScanOffset + 8 <= iFileSize) {
+        uchar chunkHeader[8];
+        if(!m_file.seek(m_iScanOffset) || m_file.read(reinterpret_cast<char*>(chunkHeader), 8) != 8) {
+            break;
+        }
+
+        qint32 iChunkHeader[2];
+        fromLittleEndian32(chunkHeader, iChunkHeader, 2);
+
+        ChunkInfo chunk;
+        chunk.iOffset = m_iScanOffset + 8;
+        chunk.iFirstSample = m_iSamples;
+        chunk.iSamples = iChunkHeader[0];
+        chunk.iBytes = iChunkHeader[1];
+
+        if(chunk.iSamples <= 0 || chunk.iBytes < 0 || chunk.iOffset + chunk.iBytes > iFileSize) {
+            break;
+        }
+
+        if(!m_bCompressed && qint64(chunk.iBytes) != 4 * qint64(chunk.iSamples) * m_vecVertices.size()) {
+            qWarning() << "MNEChunkedStcReader::refresh - Chunk at offset" << m_iScanOffset << "has an invalid size";
+            break;
+        }
+
+        m_vecChunks.append(chunk);
+        m_iSamples += chunk.iSamples;
+        m_iScanOffset = chunk.iOffset + chunk.iBytes;
+    }
+
+    //Remap to cover the new chunks
+    if(m_iScanOffset > m_iMappedSize) {
+        if(m_pMap) {
+            m_file.unmap(m_pMap);
+        }
+        m_pMap = m_file.map(0, m_iScanOffset);
+        m_iMappedSize = m_pMap ? m_iScanOffset : 0;
+    }
+
+    return true;
+}
+
+
+//*************************************************************************************************************
+
+MatrixXd MNEChunkedStcReader::readWindow(qint64 iStart, qint64 iSamples) const
+{
+    VectorXi vecRows(m_vecVertices.size());
+    for(int i = 0; i < vecRows.size(); ++i) {
+        vecRows(i) = i;
+    }
+
+    return readWindow(iStart, iSamples, vecRows);
+}
+
+
+//*************************************************************************************************************
+
+MatrixXd MNEChunkedStcReader::readWindow(qint64 iStart, qint64 iSamples, const VectorXi& vecRows) const
+{
+    QMutexLocker locker(&m_mutex);
+
+    if(iStart < 0 || iSamples <= 0 || iStart + iSamples > m_iSamples) {
+        qWarning() << "MNEChunkedStcReader::readWindow - Window" << iStart << "+" << iSamples << "exceeds the" << m_iSamples << "available samples";
+        return MatrixXd();
+    }
+
+    const int iVertices = m_vecVertices.size();
+
+    for(int i = 0; i < vecRows.size(); ++i) {
+        if(vecRows(i) < 0 || vecRows(i) >= iVertices) {
+            qWarning() << "MNEChunkedStcReader::readWindow - Row" << vecRows(i) << "is out of range";
+            return MatrixXd();
+        }
+    }
+
+    const bool bAllRows = vecRows.size() == iVertices && (vecRows.array() == VectorXi::LinSpaced(iVertices, 0, iVertices - 1).array()).all();
+
+    MatrixXd matWindow(vecRows.size(), iSamples);
+    qint64 iCol = 0;
+
+    for(int iChunk = chunkOfSample(iStart); iChunk < m_vecChunks.size() && iCol < iSamples; ++iChunk) {
+        const ChunkInfo& chunk = m_vecChunks.at(iChunk);
+
+        const float* pData = chunkData(iChunk);
+        if(!pData) {
+            return MatrixXd();
+        }
+
+        Map<const MatrixXf> matChunk(pData, iVertices, chunk.iSamples);
+
+        qint64 iFirst = iStart + iCol - chunk.iFirstSample;
+        qint64 iCount = qMin(qint64(chunk.iSamples) - iFirst, iSamples - iCol);
+
+        if(bAllRows) {
+            matWindow.middleCols(iCol, iCount) = matChunk.middleCols(iFirst, iCount).cast<double>();
+        } else {
+            for(qint64 j = 0; j < iCount; ++j) {
+                for(int i = 0; i < vecRows.size(); ++i) {
+                    matWindow(i, iCol + j) = matChunk(vecRows(i), iFirst + j);
+                }
+            }
+        }
+
+        iCol += iCount;
+    }
+
+    return matWindow;
+}
+
+
+//*************************************************************************************************************
+
+bool MNEChunkedStcReader::readHeader()
+{
+    char magic[MNE_CHUNKED_STC_MAGIC_SIZE];
+    uchar header[16];
+
+    if(m_file.read(magic, MNE_CHUNKED_STC_MAGIC_SIZE) != MNE_CHUNKED_STC_MAGIC_SIZE
+       || memcmp(magic, MNE_CHUNKED_STC_MAGIC, MNE_CHUNKED_STC_MAGIC_SIZE) != 0
+       || m_file.read(reinterpret_cast<char*>(header), 16) != 16) {
+        return false;
+    }
+
+    qint32 iVertices, iFlags;
+    fromLittleEndian32(header, &iVertices, 1);
+    fromLittleEndian32(header + 4, &iFlags, 1);
+    fromLittleEndian32(header + 8, &m_fTmin, 1);
+    fromLittleEndian32(header + 12, &m_fTstep, 1);
+
+    if(iVertices < 0) {
+        return false;
+    }
+
+    QByteArray arrayVertices = m_file.read(4 * qint64(iVertices));
+    if(arrayVertices.size() != 4 * iVertices) {
+        return false;
+    }
+
+    m_vecVertices.resize(iVertices);
+    fromLittleEndian32(reinterpret_cast<const uchar*>(arrayVertices.constData()), m_vecVertices.data(), iVertices);
+
+    m_bCompressed = iFlags & MNE_CHUNKED_STC_COMPRESSED;
+    m_iScanOffset = m_file.pos();
+
+    return true;
+}
+
+
+//*************************************************************************************************************
+
+const float* MNEChunkedStcReader::chunkData(int iChunk) const
+{
+    const ChunkInfo& chunk = m_vecChunks.at(iChunk);
+
+#if Q_BYTE_ORDER == Q_LITTLE_ENDIAN
+    if(!m_bCompressed && m_pMap && chunk.iOffset + chunk.iBytes <= m_iMappedSize) {
+        return reinterpret_cast<const float*>(m_pMap + chunk.iOffset);
+    }
+#endif
+
+    if(iChunk == m_iCachedChunk) {
+        return reinterpret_cast<const float*>(m_arrayChunkCache.constData());
+    }
+
+    QByteArray arrayPayload;
+    if(m_pMap && chunk.iOffset + chunk.iBytes <= m_iMappedSize) {
+        arrayPayload = QByteArray::fromRawData(reinterpret_cast<const char*>(m_pMap + chunk.iOffset), chunk.iBytes);
+    } else if(m_file.seek(chunk.iOffset)) {
+        arrayPayload = m_file.read(chunk.iBytes);
+    }
+
+    if(m_bCompressed) {
+        arrayPayload = qUncompress(arrayPayload);
+    }
+
+    const qint64 iValues = qint64(m_vecVertices.size()) * chunk.iSamples;
+
+    if(arrayPayload.size() != 4 * iValues) {
+        qWarning() << "MNEChunkedStcReader::chunkData - Could not read chunk" << iChunk;
+        m_iCachedChunk = -1;
+        return Q_NULLPTR;
+    }
+
+    m_arrayChunkCache.resize(arrayPayload.size());
+    fromLittleEndian32(reinterpret_cast<const uchar*>(arrayPayload.constData()), reinterpret_cast<float*>(m_arrayChunkCache.data()), iValues);
+    m_iCachedChunk = iChunk;
+
+    return reinterpret_cast<const float*>(m_arrayChunkCache.constData());
+}
+
+
+//*************************************************************************************************************
+
+int MNEChunkedStcReader::chunkOfSample(qint64 iSample) const
+{
+    //Binary search for the last chunk starting at or before the sample
+    int iLow = 0;
+    int iHigh = m_vecChunks.size() - 1;
+
+    while(iLow < iHigh) {
+        int iMid = (iLow + iHigh + 1) / 2;
+        if(m_vecChunks.at(iMid).iFirstSample <= iSample) {
+            iLow = iMid;
+        } else {
+            iHigh = iMid - 1;
+        }
+    }
+
+    return iLow;
+}
@@ -0,0 +1,296 @@
+//=============================================================================================================
+/**
+* @file     mne_chunked_stc_reader.h
+* @author   agent <agent@local>
+* @version  1.0
+* @date     October, 2026
+*
+* @section  LICENSE
+*
+* Copyright (C) 2026, agent. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+*
+* @brief    MNEChunkedStcReader class declaration.
+*
+*/
+
+#ifndef MNE_CHUNKED_STC_READER_H
+#define MNE_CHUNKED_STC_READER_H
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "mne_global.h"
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// Eigen INCLUDES
+//=============================================================================================================
+
+#include <Eigen/Core>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// Qt INCLUDES
+//=============================================================================================================
+
+#include <QSharedPointer>
+#include <QFile>
+#include <QVector>
+#include <QByteArray>
+#include <QMutex>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINES
+//=============================================================================================================
+
+#define MNE_CHUNKED_STC_MAGIC           "MNESTCC1"  /**< File identifier and format version of chunked source estimates. */
+#define MNE_CHUNKED_STC_MAGIC_SIZE      8           /**< Length of MNE_CHUNKED_STC_MAGIC without the terminating zero. */
+#define MNE_CHUNKED_STC_COMPRESSED      0x1         /**< Header flag: the chunk payloads are compressed with qCompress. */
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE NAMESPACE MNELIB
+//=============================================================================================================
+
+namespace MNELIB
+{
+
+
+//=============================================================================================================
+/**
+* Random access reader of chunked source estimate files as written by MNEChunkedStcWriter.
+*
+* All values are little endian. The header holds MNE_CHUNKED_STC_MAGIC, the number of vertices, the flags, tmin
+* and tstep in seconds (float) and the vertex indices. It is followed by the chunks. Each chunk holds the number
+* of samples and the payload size (int32), followed by the payload: the float32 values of all vertices, one sample
+* after the other, optionally compressed.
+*
+* The file is memory mapped and only the chunks overlapping a requested time window are decoded, so windows of
+* arbitrarily long recordings can be read without loading the whole source estimate. refresh() picks up chunks
+* which were appended after the file was opened, e.g. by a writer which is still computing.
+*
+* @brief Random access reader of chunked source estimate files
+*/
+class MNESHARED_EXPORT MNEChunkedStcReader
+{
+public:
+    typedef QSharedPointer<MNEChunkedStcReader> SPtr;             /**< Shared pointer type for MNEChunkedStcReader. */
+    typedef QSharedPointer<const MNEChunkedStcReader> ConstSPtr;  /**< Const shared pointer type for MNEChunkedStcReader. */
+
+    //=========================================================================================================
+    /**
+    * Opens a chunked source estimate file and indexes its chunks.
+    *
+    * @param[in] sFileName      The file to read.
+    */
+    explicit MNEChunkedStcReader(const QString& sFileName);
+
+    //=========================================================================================================
+    /**
+    * Destroys the reader and unmaps the file.
+    */
+    ~MNEChunkedStcReader();
+
+    //=========================================================================================================
+    /**
+    * Returns whether the file was opened and its header is valid.
+    *
+    * @return true if the file is open, false otherwise
+    */
+    bool isOpen() const;
+
+    //=========================================================================================================
+    /**
+    * Returns the vertex indices, one for each row of the source estimate.
+    *
+    * @return the vertex indices
+    */
+    const Eigen::VectorXi& vertices() const;
+
+    //=========================================================================================================
+    /**
+    * Returns the time of the first sample in seconds.
+    *
+    * @return the start time
+    */
+    float tmin() const;
+
+    //=========================================================================================================
+    /**
+    * Returns the sampling interval in seconds.
+    *
+    * @return the time step
+    */
+    float tstep() const;
+
+    //=========================================================================================================
+    /**
+    * Returns the number of samples in the indexed chunks.
+    *
+    * @return the number of samples
+    */
+    qint64 samples() const;
+
+    //=========================================================================================================
+    /**
+    * Indexes chunks which were appended to the file since it was opened or last refreshed. A chunk which was
+    * not completely written yet is left for the next refresh.
+    *
+    * @return true if the file could be read, false otherwise
+    */
+    bool refresh();
+
+    //=========================================================================================================
+    /**
+    * Reads a time window of all vertices.
+    *
+    * @param[in] iStart     The first sample of the window.
+    * @param[in] iSamples   The number of samples of the window.
+    *
+    * @return the window of shape [n_vertices x iSamples], empty if the window exceeds the indexed samples
+    */
+    Eigen::MatrixXd readWindow(qint64 iStart, qint64 iSamples) const;
+
+    //=========================================================================================================
+    /**
+    * Reads a time window of a subset of the vertices.
+    *
+    * @param[in] iStart     The first sample of the window.
+    * @param[in] iSamples   The number of samples of the window.
+    * @param[in] vecRows    The rows, i.e. positions in vertices(), to read.
+    *
+    * @return the window of shape [vecRows.size() x iSamples], empty if the window exceeds the indexed samples
+    */
+    Eigen::MatrixXd readWindow(qint64 iStart, qint64 iSamples, const Eigen::VectorXi& vecRows) const;
+
+private:
+    //=========================================================================================================
+    /**
+    * Position and extent of a chunk within the file.
+    */
+    struct ChunkInfo {
+        qint64  iOffset;        /**< File offset of the payload. */
+        qint64  iFirstSample;   /**< Index of the first sample of the chunk. */
+        qint32  iSamples;       /**< Number of samples in the chunk. */
+        qint32  iBytes;         /**< Size of the payload in bytes. */
+    };
+
+    //=========================================================================================================
+    /**
+    * Reads the header.
+    *
+    * @return true if the header is valid, false otherwise
+    */
+    bool readHeader();
+
+    //=========================================================================================================
+    /**
+    * Returns the decoded values of a chunk. Uncompressed chunks are returned from the file mapping without a copy
+    * on little endian hosts, all others are decoded into the chunk cache. Must be called with m_mutex locked.
+    *
+    * @param[in] iChunk     The chunk index.
+    *
+    * @return the values of the chunk, Q_NULLPTR if the chunk could not be read
+    */
+    const float* chunkData(int iChunk) const;
+
+    //=========================================================================================================
+    /**
+    * Returns the index of the chunk holding a sample.
+    *
+    * @param[in] iSample    The sample.
+    *
+    * @return the chunk index
+    */
+    int chunkOfSample(qint64 iSample) const;
+
+    mutable QFile           m_file;             /**< The chunked source estimate file. */
+    uchar*                  m_pMap;             /**< Mapping of the file, Q_NULLPTR if the file could not be mapped. */
+    qint64                  m_iMappedSize;      /**< Size of the mapping in bytes. */
+    qint64                  m_iScanOffset;      /**< File offset at which the next chunk is expected. */
+
+    Eigen::VectorXi         m_vecVertices;      /**< The vertex indices. */
+    float                   m_fTmin;            /**< Time of the first sample in seconds. */
+    float                   m_fTstep;           /**< Sampling interval in seconds. */
+    bool                    m_bCompressed;      /**< Whether the chunk payloads are compressed. */
+    bool                    m_bIsOpen;          /**< Whether the header was read successfully. */
+    qint64                  m_iSamples;         /**< Number of samples in the indexed chunks. */
+    QVector<ChunkInfo>      m_vecChunks;        /**< The indexed chunks in time order. */
+
+    mutable QMutex          m_mutex;            /**< Guards the mapping and the chunk cache. */
+    mutable QByteArray      m_arrayChunkCache;  /**< The last decoded chunk. */
+    mutable int             m_iCachedChunk;     /**< Index of the chunk in m_arrayChunkCache, -1 if none. */
+};
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INLINE DEFINITIONS
+//=============================================================================================================
+
+inline bool MNEChunkedStcReader::isOpen() const
+{
+    return m_bIsOpen;
+}
+
+
+//*************************************************************************************************************
+
+inline const Eigen::VectorXi& MNEChunkedStcReader::vertices() const
+{
+    return m_vecVertices;
+}
+
+
+//*************************************************************************************************************
+
+inline float MNEChunkedStcReader::tmin() const
+{
+    return m_fTmin;
+}
+
+
+//*************************************************************************************************************
+
+inline float MNEChunkedStcReader::tstep() const
+{
+    return m_fTstep;
+}
+
+
+//*************************************************************************************************************
+
+inline qint64 MNEChunkedStcReader::samples() const
+{
+    return m_iSamples;
+}
+
+} // NAMESPACE MNELIB
+
+#endif // MNE_CHUNKED_STC_READER_H
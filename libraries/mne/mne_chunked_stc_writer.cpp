@@ -0,0 +1,231 @@
+//=============================================================================================================
+/**
+* @file     mne_chunked_stc_writer.cpp
+* @author   agent <agent@local>
+* @version  1.0
+* @date     October, 2026
+*
+* @section  LICENSE
+*
+* Copyright (C) 2026, agent. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+*
+* @brief    Definition of the MNEChunkedStcWriter Class.
+*
+*/
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "mne_chunked_stc_writer.h"
+#include "mne_chunked_stc_reader.h"
+
+#include <cstring>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// Qt INCLUDES
+//=============================================================================================================
+
+#include <QtEndian>
+#include <QByteArray>
+#include <QDebug>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// USED NAMESPACES
+//=============================================================================================================
+
+using namespace MNELIB;
+using namespace Eigen;
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE GLOBAL METHODS
+//=============================================================================================================
+
+namespace {
+
+//=============================================================================================================
+/**
+* Appends 32 bit values in little endian byte order to a byte array.
+*/
+template<typename T>
+void appendLittleEndian32(QByteArray& array, const T* pSrc, qint64 iCount)
+{
+    int iOffset = array.size();
+    array.resize(iOffset + 4 * iCount);
+    uchar* pDest = reinterpret_cast<uchar*>(array.data()) + iOffset;
+
+    for(qint64 i = 0; i < iCount; ++i) {
+        quint32 iValue;
+        memcpy(&iValue, pSrc + i, 4);
+        iValue = qToLittleEndian(iValue);
+        memcpy(pDest + 4 * i, &iValue, 4);
+    }
+}
+
+}
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE MEMBER METHODS
+//=============================================================================================================
+
+MNEChunkedStcWriter::MNEChunkedStcWriter(const QString& sFileName,
+                                         const VectorXi& vecVertices,
+                                         float fTmin,
+                                         float fTstep,
+                                         int iChunkSize,
+                                         bool bCompress)
+: m_file(sFileName)
+, m_iChunkSize(qMax(1, iChunkSize))
+, m_bCompress(bCompress)
+, m_matBuffer(vecVertices.size(), qMax(1, iChunkSize))
+, m_iBufferedSamples(0)
+, m_iSamples(0)
+{
+    if(!m_file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        qWarning() << "MNEChunkedStcWriter - Could not open" << sFileName << "for writing";
+        return;
+    }
+
+    qint32 iHeader[2];
+    iHeader[0] = vecVertices.size();
+    iHeader[1] = bCompress ? MNE_CHUNKED_STC_COMPRESSED : 0;
+
+    QByteArray arrayHeader(MNE_CHUNKED_STC_MAGIC, MNE_CHUNKED_STC_MAGIC_SIZE);
+    appendLittleEndian32(arrayHeader, iHeader, 2);
+    appendLittleEndian32(arrayHeader, &fTmin, 1);
+    appendLittleEndian32(arrayHeader, &fTstep, 1);
+    appendLittleEndian32(arrayHeader, vecVertices.data(), vecVertices.size());
+
+    if(m_file.write(arrayHeader) != arrayHeader.size()) {
+        qWarning() << "MNEChunkedStcWriter - Could not write the header of" << sFileName;
+        m_file.close();
+    }
+}
+
+
+//*************************************************************************************************************
+
+MNEChunkedStcWriter::~MNEChunkedStcWriter()
+{
+    close();
+}
+
+
+//*************************************************************************************************************
+
+bool MNEChunkedStcWriter::append(const MatrixXd& matData)
+{
+    if(!m_file.isOpen()) {
+        return false;
+    }
+
+    if(matData.rows() != m_matBuffer.rows()) {
+        qWarning() << "MNEChunkedStcWriter::append - Expected" << m_matBuffer.rows() << "rows, got" << matData.rows();
+        return false;
+    }
+
+    qint64 iCol = 0;
+
+    while(iCol < matData.cols()) {
+        int iCount = qMin(qint64(m_iChunkSize - m_iBufferedSamples), qint64(matData.cols()) - iCol);
+
+        m_matBuffer.middleCols(m_iBufferedSamples, iCount) = matData.middleCols(iCol, iCount).cast<float>();
+        m_iBufferedSamples += iCount;
+        iCol += iCount;
+
+        if(m_iBufferedSamples == m_iChunkSize && !writeChunk()) {
+            return false;
+        }
+    }
+
+    m_iSamples += matData.cols();
+
+    return true;
+}
+
+
+//*************************************************************************************************************
+
+bool MNEChunkedStcWriter::flush()
+{
+    if(!m_file.isOpen()) {
+        return false;
+    }
+
+    if(m_iBufferedSamples > 0 && !writeChunk()) {
+        return false;
+    }
+
+    return m_file.flush();
+}
+
+
+//*************************************************************************************************************
+
+void MNEChunkedStcWriter::close()
+{
+    if(m_file.isOpen()) {
+        flush();
+        m_file.close();
+    }
+}
+
+
+//*************************************************************************************************************
+
+bool MNEChunkedStcWriter::writeChunk()
+{
+    QByteArray arrayPayload;
+    appendLittleEndian32(arrayPayload, m_matBuffer.data(), qint64(m_matBuffer.rows()) * m_iBufferedSamples);
+
+    if(m_bCompress) {
+        arrayPayload = qCompress(arrayPayload);
+    }
+
+    qint32 iChunkHeader[2];
+    iChunkHeader[0] = m_iBufferedSamples;
+    iChunkHeader[1] = arrayPayload.size();
+
+    QByteArray arrayChunk;
+    arrayChunk.reserve(8 + arrayPayload.size());
+    appendLittleEndian32(arrayChunk, iChunkHeader, 2);
+    arrayChunk.append(arrayPayload);
+
+    m_iBufferedSamples = 0;
+
+    if(m_file.write(arrayChunk) != arrayChunk.size()) {
+        qWarning() << "MNEChunkedStcWriter::writeChunk - Could not write to" << m_file.fileName();
+        m_file.close();
+        return false;
+    }
+
+    return true;
+}
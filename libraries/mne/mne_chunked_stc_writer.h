@@ -0,0 +1,189 @@
+//=============================================================================================================
+/**
+* @file     mne_chunked_stc_writer.h
+* @author   agent <agent@local>
+* @version  1.0
+* @date     October, 2026
+*
+* @section  LICENSE
+*
+* Copyright (C) 2026, agent. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+*
+* @brief    MNEChunkedStcWriter class declaration.
+*
+*/
+
+#ifndef MNE_CHUNKED_STC_WRITER_H
+#define MNE_CHUNKED_STC_WRITER_H
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "mne_global.h"
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// Eigen INCLUDES
+//=============================================================================================================
+
+#include <Eigen/Core>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// Qt INCLUDES
+//=============================================================================================================
+
+#include <QSharedPointer>
+#include <QFile>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE NAMESPACE MNELIB
+//=============================================================================================================
+
+namespace MNELIB
+{
+
+
+//=============================================================================================================
+/**
+* Writes source estimates incrementally into the chunked file format read by MNEChunkedStcReader. Samples can be
+* appended while they are computed. Full chunks are written as soon as they are complete, so the memory needed
+* does not grow with the length of the recording.
+*
+* @brief Incremental writer of chunked source estimate files
+*/
+class MNESHARED_EXPORT MNEChunkedStcWriter
+{
+public:
+    typedef QSharedPointer<MNEChunkedStcWriter> SPtr;             /**< Shared pointer type for MNEChunkedStcWriter. */
+    typedef QSharedPointer<const MNEChunkedStcWriter> ConstSPtr;  /**< Const shared pointer type for MNEChunkedStcWriter. */
+
+    //=========================================================================================================
+    /**
+    * Creates the file and writes the header.
+    *
+    * @param[in] sFileName      The file to write. An existing file is replaced.
+    * @param[in] vecVertices    The vertex indices, one for each row of the appended data.
+    * @param[in] fTmin          Time of the first sample in seconds.
+    * @param[in] fTstep         Sampling interval in seconds.
+    * @param[in] iChunkSize     Number of samples per chunk.
+    * @param[in] bCompress      Whether to compress each chunk with qCompress.
+    */
+    MNEChunkedStcWriter(const QString& sFileName,
+                        const Eigen::VectorXi& vecVertices,
+                        float fTmin,
+                        float fTstep,
+                        int iChunkSize = 1000,
+                        bool bCompress = false);
+
+    //=========================================================================================================
+    /**
+    * Writes the remaining samples and closes the file.
+    */
+    ~MNEChunkedStcWriter();
+
+    //=========================================================================================================
+    /**
+    * Returns whether the file is open for writing.
+    *
+    * @return true if the file is open, false otherwise
+    */
+    bool isOpen() const;
+
+    //=========================================================================================================
+    /**
+    * Appends samples. Every chunk which is completed by the new samples is written to the file.
+    *
+    * @param[in] matData    The samples of shape [n_vertices x n_samples].
+    *
+    * @return true if successful, false otherwise
+    */
+    bool append(const Eigen::MatrixXd& matData);
+
+    //=========================================================================================================
+    /**
+    * Writes the buffered samples as a possibly shorter chunk and flushes the file, so that readers can access all
+    * samples appended so far.
+    *
+    * @return true if successful, false otherwise
+    */
+    bool flush();
+
+    //=========================================================================================================
+    /**
+    * Writes the buffered samples and closes the file.
+    */
+    void close();
+
+    //=========================================================================================================
+    /**
+    * Returns the number of samples appended so far.
+    *
+    * @return the number of samples
+    */
+    qint64 samples() const;
+
+private:
+    //=========================================================================================================
+    /**
+    * Writes the buffered samples as one chunk.
+    *
+    * @return true if successful, false otherwise
+    */
+    bool writeChunk();
+
+    QFile               m_file;                 /**< The chunked source estimate file. */
+    int                 m_iChunkSize;           /**< Number of samples per chunk. */
+    bool                m_bCompress;            /**< Whether the chunks are compressed. */
+    Eigen::MatrixXf     m_matBuffer;            /**< The samples of the chunk in progress. */
+    int                 m_iBufferedSamples;     /**< Number of samples in m_matBuffer. */
+    qint64              m_iSamples;             /**< Number of samples appended so far. */
+};
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INLINE DEFINITIONS
+//=============================================================================================================
+
+inline bool MNEChunkedStcWriter::isOpen() const
+{
+    return m_file.isOpen();
+}
+
+
+//*************************************************************************************************************
+
+inline qint64 MNEChunkedStcWriter::samples() const
+{
+    return m_iSamples;
+}
+
+} // NAMESPACE MNELIB
+
+#endif // MNE_CHUNKED_STC_WRITER_H
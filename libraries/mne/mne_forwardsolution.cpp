@@ -73,6 +73,12 @@
 #include <iostream>
 #include <QtConcurrent>
 #include <QFuture>
+#include <QHash>
+#include <QSet>
+#include <QCryptographicHash>
+#include <QSaveFile>
+#include <QDir>
+#include <QFileInfo>
 
 
 //*************************************************************************************************************
@@ -85,6 +91,183 @@ using namespace UTILSLIB;
 using namespace FSLIB;
 
 
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE GLOBAL METHODS
+//=============================================================================================================
+
+namespace {
+
+const quint32 CLUSTER_CACHE_MAGIC = 0x4d4e4543;     /**< "MNEC", identifies cluster cache files. */
+const qint32 CLUSTER_CACHE_VERSION = 1;             /**< Version of the cluster cache format. */
+
+//=============================================================================================================
+/**
+* Adds the dimensions and the content of a matrix to a hash.
+*/
+template<typename T, int Rows, int Cols>
+void addToHash(QCryptographicHash& hash, const Matrix<T,Rows,Cols>& mat)
+{
+    qint64 dims[2] = {mat.rows(), mat.cols()};
+    hash.addData(reinterpret_cast<const char*>(dims), sizeof(dims));
+
+    //addData takes an int length, so feed large matrices in chunks
+    const char* pData = reinterpret_cast<const char*>(mat.data());
+    qint64 iBytes = qint64(mat.size()) * sizeof(T);
+    const qint64 iChunk = 1 << 30;
+
+    for(qint64 i = 0; i < iBytes; i += iChunk)
+        hash.addData(pData + i, int(qMin(iChunk, iBytes - i)));
+}
+
+//=============================================================================================================
+/**
+* Writes a matrix to a cluster cache stream.
+*/
+template<typename T, int Rows, int Cols>
+void writeMatrix(QDataStream& stream, const Matrix<T,Rows,Cols>& mat)
+{
+    stream << qint32(mat.rows()) << qint32(mat.cols());
+
+    for(Index i = 0; i < mat.size(); ++i)
+        stream << mat.data()[i];
+}
+
+//=============================================================================================================
+/**
+* Reads a matrix from a cluster cache stream, returns false if the stream is corrupt or too short.
+*/
+template<typename T, int Rows, int Cols>
+bool readMatrix(QDataStream& stream, Matrix<T,Rows,Cols>& mat)
+{
+    qint32 rows = 0;
+    qint32 cols = 0;
+    stream >> rows >> cols;
+
+    if(stream.status() != QDataStream::Ok || rows < 0 || cols < 0 || (Cols == 1 && cols != 1)
+            || qint64(rows) * qint64(cols) * qint64(sizeof(T)) > stream.device()->bytesAvailable())
+        return false;
+
+    mat.resize(rows, cols);
+
+    for(Index i = 0; i < mat.size(); ++i)
+        stream >> mat.data()[i];
+
+    return stream.status() == QDataStream::Ok;
+}
+
+//=============================================================================================================
+/**
+* Reshapes the gain of the given sources to one row per source, with the x, y and z gain of each sensor next to
+* each other. The three gain columns of a source are copied as one contiguous block.
+*/
+MatrixXd reshapeRegionGain(const MatrixXd& matG, const VectorXi& idcs, qint32 offset)
+{
+    const Index nSens = matG.rows();
+    MatrixXd matBlocks(3*nSens, idcs.rows());
+
+    for(Index j = 0; j < idcs.rows(); ++j)
+        Map<MatrixXd>(matBlocks.col(j).data(), 3, nSens) = matG.middleCols((idcs[j] + offset)*3, 3).transpose();
+
+    return matBlocks.transpose();
+}
+
+//=============================================================================================================
+/**
+* Reads the clustering results of all regions from a cache file. The results are only accepted if they fit the
+* regions to be clustered.
+*/
+bool readClusterCache(const QString& sCacheFile, const QList<RegionData>& qListRegionDataIn, QList<RegionDataOut>& qListRegionDataOut)
+{
+    QFile t_File(sCacheFile);
+    if(!t_File.open(QIODevice::ReadOnly))
+        return false;
+
+    QDataStream t_Stream(&t_File);
+
+    quint32 t_iMagic = 0;
+    qint32 t_iVersion = 0;
+    qint32 t_iNumRegions = 0;
+    t_Stream >> t_iMagic >> t_iVersion >> t_iNumRegions;
+
+    if(t_iMagic != CLUSTER_CACHE_MAGIC || t_iVersion != CLUSTER_CACHE_VERSION || t_iNumRegions != qListRegionDataIn.size())
+        return false;
+
+    QList<RegionDataOut> t_qListRegionDataOut;
+
+    for(qint32 r = 0; r < t_iNumRegions; ++r)
+    {
+        const RegionData& t_In = qListRegionDataIn[r];
+        RegionDataOut t_Out;
+
+        t_Stream >> t_Out.iLabelIdxOut;
+
+        if(!readMatrix(t_Stream, t_Out.roiIdx) || !readMatrix(t_Stream, t_Out.ctrs)
+                || !readMatrix(t_Stream, t_Out.sumd) || !readMatrix(t_Stream, t_Out.D))
+            return false;
+
+        if(t_Out.iLabelIdxOut != t_In.iLabelIdxIn
+                || t_Out.roiIdx.rows() != t_In.idcs.rows()
+                || t_Out.ctrs.cols() != t_In.matRoiG.cols()
+                || t_Out.D.rows() != t_In.idcs.rows()
+                || t_Out.D.cols() != t_Out.ctrs.rows()
+                || (t_Out.roiIdx.size() > 0 && (t_Out.roiIdx.minCoeff() < 0 || t_Out.roiIdx.maxCoeff() >= t_Out.ctrs.rows())))
+            return false;
+
+        t_qListRegionDataOut.append(t_Out);
+    }
+
+    qListRegionDataOut = t_qListRegionDataOut;
+
+    return true;
+}
+
+//=============================================================================================================
+/**
+* Writes the clustering results of all regions to a cache file.
+*/
+bool writeClusterCache(const QString& sCacheFile, const QList<RegionDataOut>& qListRegionDataOut)
+{
+    QDir().mkpath(QFileInfo(sCacheFile).absolutePath());
+
+    //Write to a temporary file first, so concurrent readers never see a partial cache
+    QSaveFile t_File(sCacheFile);
+    if(!t_File.open(QIODevice::WriteOnly))
+    {
+        printf("\tWarning: Couldn't write the cluster cache %s\n", sCacheFile.toUtf8().constData());
+        return false;
+    }
+
+    QDataStream t_Stream(&t_File);
+
+    t_Stream << CLUSTER_CACHE_MAGIC << CLUSTER_CACHE_VERSION << qint32(qListRegionDataOut.size());
+
+    for(qint32 r = 0; r < qListRegionDataOut.size(); ++r)
+    {
+        const RegionDataOut& t_Out = qListRegionDataOut[r];
+
+        t_Stream << t_Out.iLabelIdxOut;
+        writeMatrix(t_Stream, t_Out.roiIdx);
+        writeMatrix(t_Stream, t_Out.ctrs);
+        writeMatrix(t_Stream, t_Out.sumd);
+        writeMatrix(t_Stream, t_Out.D);
+    }
+
+    return t_File.commit();
+}
+
+}
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INITIALIZE STATIC MEMBER
+//=============================================================================================================
+
+QString MNEForwardSolution::s_sClusterCacheDir;
+QMutex MNEForwardSolution::s_clusterCacheMutex;
+
+
 //*************************************************************************************************************
 //=============================================================================================================
 // DEFINE MEMBER METHODS
@@ -185,6 +368,25 @@ MNEForwardSolution MNEForwardSolution::cluster_forward_solution(const Annotation
                                                                 const FiffCov &p_pNoise_cov,
                                                                 const FiffInfo &p_pInfo,
                                                                 QString p_sMethod) const
+{
+    SparseMatrix<double> t_D;
+
+    MNEForwardSolution p_fwdOut = cluster_forward_solution(p_AnnotationSet, p_iClusterSize, t_D, p_pNoise_cov, p_pInfo, p_sMethod);
+
+    p_D = MatrixXd(t_D);
+
+    return p_fwdOut;
+}
+
+
+//*************************************************************************************************************
+
+MNEForwardSolution MNEForwardSolution::cluster_forward_solution(const AnnotationSet &p_AnnotationSet,
+                                                                qint32 p_iClusterSize,
+                                                                SparseMatrix<double>& p_D,
+                                                                const FiffCov &p_pNoise_cov,
+                                                                const FiffInfo &p_pInfo,
+                                                                QString p_sMethod) const
 {
     printf("Cluster forward solution using %s.\n", p_sMethod.toUtf8().constData());
 
@@ -201,8 +403,6 @@ MNEForwardSolution MNEForwardSolution::cluster_forward_solution(const Annotation
         }
     }
 
-//    qDebug() << "this->sol->data" << this->sol->data.rows() << "x" << this->sol->data.cols();
-
     //
     // Check consisty
     //
@@ -212,15 +412,6 @@ MNEForwardSolution MNEForwardSolution::cluster_forward_solution(const Annotation
         return p_fwdOut;
     }
 
-//    for(qint32 h = 0; h < this->src.hemispheres.size(); ++h )//obj.sizeForwardSolution)
-//    {
-//        if(this->src[h]->vertno.rows() !=  t_listAnnotation[h]->getLabel()->rows())
-//        {
-//            printf("Error: Annotation doesn't fit to Forward Solution: Vertice number is different!");
-//            return false;
-//        }
-//    }
-
     MatrixXd t_G_Whitened(0,0);
     bool t_bUseWhitened = false;
     //
@@ -240,25 +431,21 @@ MNEForwardSolution MNEForwardSolution::cluster_forward_solution(const Annotation
         t_bUseWhitened = true;
     }
 
+    QString t_sMethod = p_sMethod.isEmpty() ? QString("cityblock") : p_sMethod;
 
     //
-    // Assemble input data
+    // Assemble input data of all labels of both hemispheres, so they are clustered in one pass
     //
-    qint32 count;
-    qint32 offset;
-
-    MatrixXd t_G_new;
+    QList<RegionData> t_qListRegionDataIn;
+    QList<qint32> t_qListRegionHemi;
+    QCryptographicHash t_AnnotationHash(QCryptographicHash::Md5);
 
     for(qint32 h = 0; h < this->src.size(); ++h )
     {
-
-        count = 0;
-        offset = 0;
-
         // Offset for continuous indexing;
-        if(h > 0)
-            for(qint32 j = 0; j < h; ++j)
-                offset += this->src[j].nuse;
+        qint32 offset = 0;
+        for(qint32 j = 0; j < h; ++j)
+            offset += this->src[j].nuse;
 
         if(h == 0)
             printf("Cluster Left Hemisphere\n");
@@ -269,14 +456,31 @@ MNEForwardSolution MNEForwardSolution::cluster_forward_solution(const Annotation
         VectorXi label_ids = t_CurrentColorTable.getLabelIds();
 
         // Get label ids for every vertex
+        const VectorXi t_vecAnnotLabelIds = p_AnnotationSet[h].getLabelIds();
         VectorXi vertno_labeled = VectorXi::Zero(this->src[h].vertno.rows());
 
         //ToDo make this more universal -> using Label instead of annotations - obsolete when using Labels
         for(qint32 i = 0; i < vertno_labeled.rows(); ++i)
-            vertno_labeled[i] = p_AnnotationSet[h].getLabelIds()[this->src[h].vertno[i]];
+            vertno_labeled[i] = t_vecAnnotLabelIds[this->src[h].vertno[i]];
+
+        addToHash(t_AnnotationHash, label_ids);
+        addToHash(t_AnnotationHash, vertno_labeled);
+
+        //
+        // Sort the sources into their labels in one pass over the sources
+        //
+        QHash<qint32, qint32> t_qHashLabelIdx;
+        for(qint32 i = 0; i < label_ids.rows(); ++i)
+            if(label_ids[i] != 0)
+                t_qHashLabelIdx.insert(label_ids[i], i);
 
-        //Qt Concurrent List
-        QList<RegionData> m_qListRegionDataIn;
+        QVector<QVector<qint32> > t_qVecLabelSources(label_ids.rows());
+        for(qint32 j = 0; j < vertno_labeled.rows(); ++j)
+        {
+            QHash<qint32, qint32>::const_iterator it = t_qHashLabelIdx.constFind(vertno_labeled[j]);
+            if(it != t_qHashLabelIdx.constEnd())
+                t_qVecLabelSources[it.value()].append(j);
+        }
 
         //
         // Generate cluster input data
@@ -288,70 +492,30 @@ MNEForwardSolution MNEForwardSolution::cluster_forward_solution(const Annotation
                 QString curr_name = t_CurrentColorTable.struct_names[i];//obj.label2AtlasName(label(i));
                 printf("\tCluster %d / %ld %s...", i+1, label_ids.rows(), curr_name.toUtf8().constData());
 
-                //
-                // Get source space indeces
-                //
-                VectorXi idcs = VectorXi::Zero(vertno_labeled.rows());
-                qint32 c = 0;
-
-                //Select ROIs //change this use label info with a hash tabel
-                for(qint32 j = 0; j < vertno_labeled.rows(); ++j)
-                {
-                    if(vertno_labeled[j] == label_ids[i])
-                    {
-                        idcs[c] = j;
-                        ++c;
-                    }
-                }
-                idcs.conservativeResize(c);
-
-                //get selected G
-                MatrixXd t_G(this->sol->data.rows(), idcs.rows()*3);
-                MatrixXd t_G_Whitened_Roi(t_G_Whitened.rows(), idcs.rows()*3);
-
-                for(qint32 j = 0; j < idcs.rows(); ++j)
-                {
-                    t_G.block(0, j*3, t_G.rows(), 3) = this->sol->data.block(0, (idcs[j]+offset)*3, t_G.rows(), 3);
-                    if(t_bUseWhitened)
-                        t_G_Whitened_Roi.block(0, j*3, t_G_Whitened_Roi.rows(), 3) = t_G_Whitened.block(0, (idcs[j]+offset)*3, t_G_Whitened_Roi.rows(), 3);
-                }
-
-                qint32 nSens = t_G.rows();
-                qint32 nSources = t_G.cols()/3;
+                const QVector<qint32>& t_qVecSources = t_qVecLabelSources[i];
+                qint32 nSources = t_qVecSources.size();
 
                 if (nSources > 0)
                 {
                     RegionData t_sensG;
 
-                    t_sensG.idcs = idcs;
+                    t_sensG.idcs = Map<const VectorXi>(t_qVecSources.constData(), nSources);
                     t_sensG.iLabelIdxIn = i;
                     t_sensG.nClusters = ceil((double)nSources/(double)p_iClusterSize);
 
-                    t_sensG.matRoiGOrig = t_G;
-//                    if(t_bUseWhitened)
-//                        t_sensG.matRoiGOrigWhitened = t_G_Whitened_Roi;
-
                     printf("%d Cluster(s)... ", t_sensG.nClusters);
 
                     // Reshape Input data -> sources rows; sensors columns
-                    t_sensG.matRoiG = MatrixXd(t_G.cols()/3, 3*nSens);
+                    t_sensG.matRoiG = reshapeRegionGain(this->sol->data, t_sensG.idcs, offset);
                     if(t_bUseWhitened)
-                        t_sensG.matRoiGWhitened = MatrixXd(t_G_Whitened_Roi.cols()/3, 3*nSens);
-
-                    for(qint32 j = 0; j < nSens; ++j)
-                    {
-                        for(qint32 k = 0; k < t_sensG.matRoiG.rows(); ++k)
-                            t_sensG.matRoiG.block(k,j*3,1,3) = t_G.block(j,k*3,1,3);
-                        if(t_bUseWhitened)
-                            for(qint32 k = 0; k < t_sensG.matRoiGWhitened.rows(); ++k)
-                                t_sensG.matRoiGWhitened.block(k,j*3,1,3) = t_G_Whitened_Roi.block(j,k*3,1,3);
-                    }
+                        t_sensG.matRoiGWhitened = reshapeRegionGain(t_G_Whitened, t_sensG.idcs, offset);
 
                     t_sensG.bUseWhitened = t_bUseWhitened;
 
-                    t_sensG.sDistMeasure = p_sMethod;
+                    t_sensG.sDistMeasure = t_sMethod;
 
-                    m_qListRegionDataIn.append(t_sensG);
+                    t_qListRegionDataIn.append(t_sensG);
+                    t_qListRegionHemi.append(h);
 
                     printf("[added]\n");
                 }
@@ -361,60 +525,100 @@ MNEForwardSolution MNEForwardSolution::cluster_forward_solution(const Annotation
                 }
             }
         }
+    }
 
+    //
+    // Calculate clusters, or read them from the cache if this forward solution was clustered with these labels before
+    //
+    QString t_sCacheFile;
+    QString t_sCacheDir = clusterCacheDir();
 
-        //
-        // Calculate clusters
-        //
+    if(!t_sCacheDir.isEmpty())
+    {
+        QCryptographicHash t_ForwardHash(QCryptographicHash::Md5);
+        addToHash(t_ForwardHash, this->sol->data);
+        if(t_bUseWhitened)
+            addToHash(t_ForwardHash, t_G_Whitened);
+
+        t_sCacheFile = QString("%1/fwd-%2-annot-%3-%4-%5.clustercache").arg(t_sCacheDir)
+                                                                     .arg(QString::fromLatin1(t_ForwardHash.result().toHex()))
+                                                                     .arg(QString::fromLatin1(t_AnnotationHash.result().toHex()))
+                                                                     .arg(p_iClusterSize)
+                                                                     .arg(t_sMethod);
+    }
+
+    QList<RegionDataOut> t_qListRegionDataOut;
+
+    if(!t_sCacheFile.isEmpty() && readClusterCache(t_sCacheFile, t_qListRegionDataIn, t_qListRegionDataOut))
+    {
+        printf("Read clusters from %s\n", t_sCacheFile.toUtf8().constData());
+    }
+    else
+    {
         printf("Clustering... ");
         QFuture< RegionDataOut > res;
-        res = QtConcurrent::mapped(m_qListRegionDataIn, &RegionData::cluster);
+        res = QtConcurrent::mapped(t_qListRegionDataIn, &RegionData::cluster);
         res.waitForFinished();
 
-        //
-        // Assign results
-        //
-        MatrixXd t_G_partial;
-
-        qint32 nClusters;
-        qint32 nSens;
-        QList<RegionData>::const_iterator itIn;
-        itIn = m_qListRegionDataIn.begin();
-        QFuture<RegionDataOut>::const_iterator itOut;
-        for (itOut = res.constBegin(); itOut != res.constEnd(); ++itOut)
-        {
-            nClusters = itOut->ctrs.rows();
-            nSens = itOut->ctrs.cols()/3;
-            t_G_partial = MatrixXd::Zero(nSens, nClusters*3);
+        t_qListRegionDataOut = res.results();
 
-//            std::cout << "Number of Clusters: " << nClusters << " x " << nSens << std::endl;//itOut->iLabelIdcsOut << std::endl;
+        if(!t_sCacheFile.isEmpty())
+            writeClusterCache(t_sCacheFile, t_qListRegionDataOut);
 
-            //
-            // Assign the centroid for each cluster to the partial G
-            //
-            //ToDo change this use indeces found with whitened data
-            for(qint32 j = 0; j < nSens; ++j)
-                for(qint32 k = 0; k < nClusters; ++k)
-                    t_G_partial.block(j, k*3, 1, 3) = itOut->ctrs.block(k,j*3,1,3);
+        printf("[done]\n");
+    }
+
+    //
+    // Assign results: the clustered gain matrix, the cluster information and the cluster operator D (sources x
+    // clusters) are assembled in one pass
+    //
+    qint32 nSens = this->sol->data.rows();
+    qint32 totalNumOfClust = 0;
+    for(qint32 r = 0; r < t_qListRegionDataOut.size(); ++r)
+        totalNumOfClust += t_qListRegionDataOut[r].ctrs.rows();
+
+    MatrixXd t_G_new(nSens, totalNumOfClust*3);
+    std::vector< Triplet<double> > t_vecTriplets;
+    t_vecTriplets.reserve(this->sol->data.cols());
+
+    qint32 currentCluster = 0;
+
+    for(qint32 h = 0; h < this->src.size(); ++h)
+    {
+        qint32 count = 0;
+
+        Colortable t_CurrentColorTable = p_AnnotationSet[h].getColortable();
+        VectorXi label_ids = t_CurrentColorTable.getLabelIds();
+        QStringList label_names = t_CurrentColorTable.getNames();
+
+        qint32 rrOffset = h == 0 ? 0 : this->src[0].nuse;
+        qint32 hemiOffset = h == 0 ? 0 : this->src[0].vertno.size();
+
+        for(qint32 r = 0; r < t_qListRegionDataIn.size(); ++r)
+        {
+            if(t_qListRegionHemi[r] != h)
+                continue;
+
+            const RegionData& t_In = t_qListRegionDataIn[r];
+            const RegionDataOut& t_Out = t_qListRegionDataOut[r];
+            qint32 nClusters = t_Out.ctrs.rows();
 
             //
             // Get cluster indizes and its distances to the centroid
             //
             for(qint32 j = 0; j < nClusters; ++j)
             {
-                VectorXi clusterIdcs = VectorXi::Zero(itOut->roiIdx.rows());
-                VectorXd clusterDistance = VectorXd::Zero(itOut->roiIdx.rows());
-                MatrixX3f clusterSource_rr = MatrixX3f::Zero(itOut->roiIdx.rows(), 3);
+                VectorXi clusterIdcs = VectorXi::Zero(t_Out.roiIdx.rows());
+                VectorXd clusterDistance = VectorXd::Zero(t_Out.roiIdx.rows());
+                MatrixX3f clusterSource_rr = MatrixX3f::Zero(t_Out.roiIdx.rows(), 3);
                 qint32 nClusterIdcs = 0;
-                for(qint32 k = 0; k < itOut->roiIdx.rows(); ++k)
+                for(qint32 k = 0; k < t_Out.roiIdx.rows(); ++k)
                 {
-                    if(itOut->roiIdx[k] == j)
+                    if(t_Out.roiIdx[k] == j)
                     {
-                        clusterIdcs[nClusterIdcs] = itIn->idcs[k];
-
-                        qint32 offset = h == 0 ? 0 : this->src[0].nuse;
-                        clusterSource_rr.row(nClusterIdcs) = this->source_rr.row(offset + itIn->idcs[k]);
-                        clusterDistance[nClusterIdcs] = itOut->D(k,j);
+                        clusterIdcs[nClusterIdcs] = t_In.idcs[k];
+                        clusterSource_rr.row(nClusterIdcs) = this->source_rr.row(rrOffset + t_In.idcs[k]);
+                        clusterDistance[nClusterIdcs] = t_Out.D(k,j);
                         ++nClusterIdcs;
                     }
                 }
@@ -426,304 +630,88 @@ MNEForwardSolution MNEForwardSolution::cluster_forward_solution(const Annotation
                 for(qint32 k = 0; k < clusterVertnos.size(); ++k)
                     clusterVertnos(k) = this->src[h].vertno[clusterIdcs(k)];
 
-
                 p_fwdOut.src[h].cluster_info.clusterVertnos.append(clusterVertnos);
                 p_fwdOut.src[h].cluster_info.clusterSource_rr.append(clusterSource_rr);
                 p_fwdOut.src[h].cluster_info.clusterDistances.append(clusterDistance);
-                p_fwdOut.src[h].cluster_info.clusterLabelIds.append(label_ids[itOut->iLabelIdxOut]);
-                p_fwdOut.src[h].cluster_info.clusterLabelNames.append(t_CurrentColorTable.getNames()[itOut->iLabelIdxOut]);
-            }
+                p_fwdOut.src[h].cluster_info.clusterLabelIds.append(label_ids[t_Out.iLabelIdxOut]);
+                p_fwdOut.src[h].cluster_info.clusterLabelNames.append(label_names[t_Out.iLabelIdxOut]);
 
+                //
+                // The cluster averages its sources, for x, y and z separately (free orientation)
+                //
+                double selectWeight = 1.0/nClusterIdcs;
+                qint32 clustOffset = currentCluster*3;
+                for(qint32 k = 0; k < nClusterIdcs; ++k)
+                {
+                    qint32 idx_sel_Offset = (hemiOffset + clusterIdcs[k])*3;
+                    t_vecTriplets.push_back(Triplet<double>(idx_sel_Offset, clustOffset, selectWeight));
+                    t_vecTriplets.push_back(Triplet<double>(idx_sel_Offset+1, clustOffset+1, selectWeight));
+                    t_vecTriplets.push_back(Triplet<double>(idx_sel_Offset+2, clustOffset+2, selectWeight));
+                }
+                ++currentCluster;
+            }
 
             //
-            // Assign partial G to new LeadField
+            // Assign the centroid for each cluster to the new LeadField and map it to the closest rr
             //
-            if(t_G_partial.rows() > 0 && t_G_partial.cols() > 0)
+            MatrixXd t_ctrsT = t_Out.ctrs.transpose();
+            for(qint32 k = 0; k < nClusters; ++k)
             {
-                t_G_new.conservativeResize(t_G_partial.rows(), t_G_new.cols() + t_G_partial.cols());
-                t_G_new.block(0, t_G_new.cols() - t_G_partial.cols(), t_G_new.rows(), t_G_partial.cols()) = t_G_partial;
-
-                // Map the centroids to the closest rr
-                for(qint32 k = 0; k < nClusters; ++k)
-                {
-                    qint32 j = 0;
+                qint32 iCol = (currentCluster - nClusters + k)*3;
+                t_G_new.middleCols(iCol, 3) = Map<const MatrixXd>(t_ctrsT.col(k).data(), 3, nSens).transpose();
 
-                    double sqec = sqrt((itIn->matRoiGOrig.block(0, j*3, itIn->matRoiGOrig.rows(), 3) - t_G_partial.block(0, k*3, t_G_partial.rows(), 3)).array().pow(2).sum());
-                    double sqec_min = sqec;
-                    qint32 j_min = 0;
-//                    MatrixXd matGainDiff;
-                    for(qint32 j = 1; j < itIn->idcs.rows(); ++j)
-                    {
-                        sqec = sqrt((itIn->matRoiGOrig.block(0, j*3, itIn->matRoiGOrig.rows(), 3) - t_G_partial.block(0, k*3, t_G_partial.rows(), 3)).array().pow(2).sum());
-
-                        if(sqec < sqec_min)
-                        {
-                            sqec_min = sqec;
-                            j_min = j;
-//                            matGainDiff = itIn->matRoiGOrig.block(0, j*3, itIn->matRoiGOrig.rows(), 3) - t_G_partial.block(0, k*3, t_G_partial.rows(), 3);
-                        }
-                    }
+                // Take the closest coordinates, the rows of matRoiG hold the original gain of each source
+                MatrixXd::Index j_min = 0;
+                (t_In.matRoiG.rowwise() - t_Out.ctrs.row(k)).rowwise().squaredNorm().minCoeff(&j_min);
 
-//                    qListGainDist.append(matGainDiff);
+                qint32 sel_idx = t_In.idcs[j_min];
 
-                    // Take the closest coordinates
-                    qint32 sel_idx = itIn->idcs[j_min];
+                p_fwdOut.src[h].cluster_info.centroidVertno.append(this->src[h].vertno[sel_idx]);
+                p_fwdOut.src[h].cluster_info.centroidSource_rr.append(this->src[h].rr.row(this->src[h].vertno[sel_idx]));
 
-                    p_fwdOut.src[h].cluster_info.centroidVertno.append(this->src[h].vertno[sel_idx]);
-                    p_fwdOut.src[h].cluster_info.centroidSource_rr.append(this->src[h].rr.row(this->src[h].vertno[sel_idx]));
-//                    p_fwdOut.src[h].nn.row(count) = MatrixXd::Zero(1,3);
+                // Label ID instead of the closest vertno
+                p_fwdOut.src[h].vertno[count] = p_fwdOut.src[h].cluster_info.clusterLabelIds[count];
 
-//                    // Option 1 closest vertno
-//                    p_fwdOut.src[h].vertno[count] = this->src[h].vertno[sel_idx]; //ToDo resizing necessary?
-                    // Option 2 label ID
-                    p_fwdOut.src[h].vertno[count] = p_fwdOut.src[h].cluster_info.clusterLabelIds[count];
-
-
-
-//                    //vertices
-//                    std::cout << this->src[h].vertno[sel_idx] << ", ";
-
-                    ++count;
-                }
+                ++count;
             }
-
-            ++itIn;
         }
 
         //
         // Assemble new hemisphere information
         //
-//        p_fwdOut.src[h].rr.conservativeResize(count, 3);
-//        p_fwdOut.src[h].nn.conservativeResize(count, 3);
         p_fwdOut.src[h].vertno.conservativeResize(count);
-
-        printf("[done]\n");
     }
 
+    p_D.resize(this->sol->data.cols(), totalNumOfClust*3);
+    p_D.setFromTriplets(t_vecTriplets.begin(), t_vecTriplets.end());
 
     //
-    // Cluster operator D (sources x clusters)
+    // Put it all together
     //
-    qint32 totalNumOfClust = 0;
-    for (qint32 h = 0; h < 2; ++h)
-        totalNumOfClust += p_fwdOut.src[h].cluster_info.clusterVertnos.size();
-
-    if(this->isFixedOrient())
-        p_D = MatrixXd::Zero(this->sol->data.cols(), totalNumOfClust);
-    else
-        p_D = MatrixXd::Zero(this->sol->data.cols(), totalNumOfClust*3);
-
-    QList<VectorXi> t_vertnos = this->src.get_vertno();
-
-//    qDebug() << "Size: " << t_vertnos[0].size()  << t_vertnos[1].size();
-//    qDebug() << "this->sol->data.cols(): " << this->sol->data.cols();
-
-    qint32 currentCluster = 0;
-    for (qint32 h = 0; h < 2; ++h)
-    {
-        int hemiOffset = h == 0 ? 0 : t_vertnos[0].size();
-        for(qint32 i = 0; i < p_fwdOut.src[h].cluster_info.clusterVertnos.size(); ++i)
-        {
-            VectorXi idx_sel;
-            MNEMath::intersect(t_vertnos[h], p_fwdOut.src[h].cluster_info.clusterVertnos[i], idx_sel);
-
-//            std::cout << "\nVertnos:\n" << t_vertnos[h] << std::endl;
-
-//            std::cout << "clusterVertnos[i]:\n" << p_fwdOut.src[h].cluster_info.clusterVertnos[i] << std::endl;
-
-            idx_sel.array() += hemiOffset;
-
-//            std::cout << "idx_sel]:\n" << idx_sel << std::endl;
-
-
-
-            double selectWeight = 1.0/idx_sel.size();
-            if(this->isFixedOrient())
-            {
-                for(qint32 j = 0; j < idx_sel.size(); ++j)
-                    p_D.col(currentCluster)[idx_sel(j)] = selectWeight;
-            }
-            else
-            {
-                qint32 clustOffset = currentCluster*3;
-                for(qint32 j = 0; j < idx_sel.size(); ++j)
-                {
-                    qint32 idx_sel_Offset = idx_sel(j)*3;
-                    //x
-                    p_D(idx_sel_Offset,clustOffset) = selectWeight;
-                    //y
-                    p_D(idx_sel_Offset+1, clustOffset+1) = selectWeight;
-                    //z
-                    p_D(idx_sel_Offset+2, clustOffset+2) = selectWeight;
-                }
-            }
-            ++currentCluster;
-        }
-    }
-
-//    std::cout << "D:\n" << D.row(0) << std::endl << D.row(1) << std::endl << D.row(2) << std::endl << D.row(3) << std::endl << D.row(4) << std::endl << D.row(5) << std::endl;
-
-
-//    //
-//    // get mean and std of original gain matrix
-//    //
-//    double mean = 0;
-//    qint32 c = 0;
-//    for(qint32 i = 0; i < this->sol->data.rows(); ++i)
-//    {
-//        if(i % 3 == 1 || i%3 == 2)
-//        {
-//            for(qint32 j = 0; j < this->sol->data.cols(); ++j)
-//            {
-//                mean += this->sol->data(i,j);
-//                ++c;
-//            }
-//        }
-//    }
-
-//    mean /= c;
-//    double var = 0;
-//    c = 0;
-//    for(qint32 i = 0; i < this->sol->data.rows(); ++i)
-//    {
-//        if(i % 3 == 1 || i%3 == 2)
-//        {
-//            for(qint32 j = 0; j < this->sol->data.cols(); ++j)
-//            {
-//                var += pow(this->sol->data(i,j) - mean,2);
-//                ++c;
-//            }
-//        }
-//    }
-//    var /= c - 1;
-//    var = sqrt(var);
-//    std::cout << "Original gain matrix (gradiometer):\n    mean: " << mean << "\n    var: " << var << std::endl;
-
-//    mean = 0;
-//    c = 0;
-//    for(qint32 i = 0; i < this->sol->data.rows(); ++i)
-//    {
-//        if(i % 3 == 0)
-//        {
-//            for(qint32 j = 0; j < this->sol->data.cols(); ++j)
-//            {
-//                mean += this->sol->data(i,j);
-//                ++c;
-//            }
-//        }
-//    }
-//    mean /= c;
-
-//    var = 0;
-//    c = 0;
-//    for(qint32 i = 0; i < this->sol->data.rows(); ++i)
-//    {
-//        if(i % 3 == 0)
-//        {
-//            for(qint32 j = 0; j < this->sol->data.cols(); ++j)
-//            {
-//                var += pow(this->sol->data(i,j) - mean,2);
-//                ++c;
-//            }
-//        }
-//    }
-//    var /= c - 1;
-//    var = sqrt(var);
-//    std::cout << "Original gain matrix (magnetometer):\n    mean: " << mean << "\n    var: " << var << std::endl;
-
-//    //
-//    // get mean and std of original gain matrix mapping
-//    //
-//    mean = 0;
-//    c = 0;
-//    for(qint32 h = 0; h < qListGainDist.size(); ++h)
-//    {
-//        for(qint32 i = 0; i < qListGainDist[h].rows(); ++i)
-//        {
-//            if(i % 3 == 1 || i%3 == 2)
-//            {
-//                for(qint32 j = 0; j < qListGainDist[h].cols(); ++j)
-//                {
-//                    mean += qListGainDist[h](i,j);
-//                    ++c;
-//                }
-//            }
-//        }
-//    }
-//    mean /= c;
-
-//    var = 0;
-//    c = 0;
-//    for(qint32 h = 0; h < qListGainDist.size(); ++h)
-//    {
-//        for(qint32 i = 0; i < qListGainDist[h].rows(); ++i)
-//        {
-//            if(i % 3 == 1 || i%3 == 2)
-//            {
-//                for(qint32 j = 0; j < qListGainDist[h].cols(); ++j)
-//                {
-//                    var += pow(qListGainDist[i](i,j) - mean,2);
-//                    ++c;
-//                }
-//            }
-//        }
-//    }
-
-//    var /= c - 1;
-//    var = sqrt(var);
-
-//    std::cout << "Gain matrix offset mapping (gradiometer):\n    mean: " << mean << "\n    var: " << var << std::endl;
+    p_fwdOut.sol->data = t_G_new;
+    p_fwdOut.sol->ncol = t_G_new.cols();
 
-//    mean = 0;
-//    c = 0;
-//    for(qint32 h = 0; h < qListGainDist.size(); ++h)
-//    {
-//        for(qint32 i = 0; i < qListGainDist[h].rows(); ++i)
-//        {
-//            if(i % 3 == 0)
-//            {
-//                for(qint32 j = 0; j < qListGainDist[h].cols(); ++j)
-//                {
-//                    mean += qListGainDist[h](i,j);
-//                    ++c;
-//                }
-//            }
-//        }
-//    }
-//    mean /= c;
+    p_fwdOut.nsource = p_fwdOut.sol->ncol/3;
 
-//    var = 0;
-//    c = 0;
-//    for(qint32 h = 0; h < qListGainDist.size(); ++h)
-//    {
-//        for(qint32 i = 0; i < qListGainDist[h].rows(); ++i)
-//        {
-//            if(i % 3 == 0)
-//            {
-//                for(qint32 j = 0; j < qListGainDist[h].cols(); ++j)
-//                {
-//                    var += pow(qListGainDist[i](i,j) - mean,2);
-//                    ++c;
-//                }
-//            }
-//        }
-//    }
+    return p_fwdOut;
+}
 
-//    var /= c - 1;
-//    var = sqrt(var);
 
-//    std::cout << "Gain matrix offset mapping (magnetometer):\n    mean: " << mean << "\n    var: " << var << std::endl;
+//*************************************************************************************************************
 
+void MNEForwardSolution::setClusterCacheDir(const QString &p_sCacheDir)
+{
+    QMutexLocker locker(&s_clusterCacheMutex);
+    s_sClusterCacheDir = p_sCacheDir;
+}
 
-    //
-    // Put it all together
-    //
-    p_fwdOut.sol->data = t_G_new;
-    p_fwdOut.sol->ncol = t_G_new.cols();
 
-    p_fwdOut.nsource = p_fwdOut.sol->ncol/3;
+//*************************************************************************************************************
 
-    return p_fwdOut;
+QString MNEForwardSolution::clusterCacheDir()
+{
+    QMutexLocker locker(&s_clusterCacheMutex);
+    return s_sClusterCacheDir;
 }
 
 
@@ -1036,10 +1024,12 @@ MNEForwardSolution MNEForwardSolution::pick_channels(const QStringList& include,
         chs.append(fwd.info.chs[sel(i)]);
     fwd.info.chs = chs;
     fwd.info.nchan = nuse;
+    fwd.info.invalidateChannelIndex();
 
+    QSet<QString> t_chNames = ch_names.toSet();
     QStringList bads;
     for(qint32 i = 0; i < fwd.info.bads.size(); ++i)
-        if(ch_names.contains(fwd.info.bads[i]))
+        if(t_chNames.contains(fwd.info.bads[i]))
             bads.append(fwd.info.bads[i]);
     fwd.info.bads = bads;
 
@@ -1137,16 +1127,19 @@ void MNEForwardSolution::prepare_forward(const FiffInfo &p_info,
                                          MatrixXd &p_outWhitener,
                                          qint32 &p_outNumNonZero) const
 {
-    QStringList fwd_ch_names, ch_names;
-    for(qint32 i = 0; i < this->info.chs.size(); ++i)
-        fwd_ch_names << this->info.chs[i].ch_name;
+    //Hashed channel lookups, the row names of a picked forward solution are kept in its chs only
+    QHash<QString, qint32> fwd_ch_idx;
+    for(qint32 i = this->info.chs.size() - 1; i >= 0; --i)
+        fwd_ch_idx.insert(this->info.chs[i].ch_name, i);
 
-    ch_names.clear();
+    QSet<QString> t_bads = p_info.bads.toSet() + p_noise_cov.bads.toSet();
+    QSet<QString> t_covNames = p_noise_cov.names.toSet();
+
+    QStringList ch_names;
     for(qint32 i = 0; i < p_info.chs.size(); ++i)
-        if(!p_info.bads.contains(p_info.chs[i].ch_name)
-            && !p_noise_cov.bads.contains(p_info.chs[i].ch_name)
-            && p_noise_cov.names.contains(p_info.chs[i].ch_name)
-            && fwd_ch_names.contains(p_info.chs[i].ch_name))
+        if(!t_bads.contains(p_info.chs[i].ch_name)
+            && t_covNames.contains(p_info.chs[i].ch_name)
+            && fwd_ch_idx.contains(p_info.chs[i].ch_name))
             ch_names << p_info.chs[i].ch_name;
 
     qint32 n_chan = ch_names.size();
@@ -1200,13 +1193,13 @@ void MNEForwardSolution::prepare_forward(const FiffInfo &p_info,
     qint32 count_info_idx = 0;
     for(qint32 i = 0; i < ch_names.size(); ++i)
     {
-        idx = fwd_ch_names.indexOf(ch_names[i]);
+        idx = fwd_ch_idx.value(ch_names[i], -1);
         if(idx > -1)
         {
             fwd_idx[count_fwd_idx] = idx;
             ++count_fwd_idx;
         }
-        idx = p_info.ch_names.indexOf(ch_names[i]);
+        idx = p_info.channelIndex(ch_names[i]);
         if(idx > -1)
         {
             info_idx[count_info_idx] = idx;
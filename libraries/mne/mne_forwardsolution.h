@@ -65,6 +65,7 @@
 //=============================================================================================================
 
 #include <Eigen/Core>
+#include <Eigen/SparseCore>
 
 
 //*************************************************************************************************************
@@ -75,6 +76,8 @@
 #include <QFile>
 #include <QSharedPointer>
 #include <QDataStream>
+#include <QMutex>
+#include <QString>
 
 
 //*************************************************************************************************************
@@ -120,9 +123,6 @@ struct RegionData
     MatrixXd    matRoiGWhitened;    /**< Reshaped whitened region gain matrix sources x sensors(x,y,z)*/
     bool        bUseWhitened;       /**< Wheather indeces of whitened gain matrix should be used to calculate centroids */
 
-    MatrixXd    matRoiGOrig;            /**< Region gain matrix sensors x sources(x,y,z)*/
-//    MatrixXd    matRoiGOrigWhitened;    /**< Whitened region gain matrix sensors x sources(x,y,z)*/
-
     qint32      nClusters;      /**< Number of clusters within this region */
 
     VectorXi    idcs;           /**< Get source space indeces */
@@ -259,6 +259,48 @@ public:
                                                 const FiffInfo &p_pInfo = defaultInfo,
                                                 QString p_sMethod = "cityblock") const;
 
+    //=========================================================================================================
+    /**
+    * Cluster the forward solution and stores the result to p_fwdOut.
+    * The labels of both hemispheres are clustered in parallel in one pass. The cluster operator is returned as
+    * sparse matrix, which is built together with the clustered gain matrix. If a cluster cache directory is set,
+    * the clustering result is stored there and reused for the same gain matrix, whitening, labels, cluster size
+    * and distance measure.
+    *
+    * @param[in]    p_AnnotationSet     Annotation set containing the annotation of left & right hemisphere
+    * @param[in]    p_iClusterSize      Maximal cluster size per roi
+    * @param[out]   p_D                 The sparse cluster operator (sources x clusters)
+    * @param[in]    p_pNoise_cov
+    * @param[in]    p_pInfo
+    * @param[in]    p_sMethod           "cityblock" or "sqeuclidean"
+    *
+    * @return clustered MNE forward solution
+    */
+    MNEForwardSolution cluster_forward_solution(const AnnotationSet &p_AnnotationSet,
+                                                qint32 p_iClusterSize,
+                                                SparseMatrix<double>& p_D,
+                                                const FiffCov &p_pNoise_cov = defaultCov,
+                                                const FiffInfo &p_pInfo = defaultInfo,
+                                                QString p_sMethod = "cityblock") const;
+
+    //=========================================================================================================
+    /**
+    * Sets the directory in which cluster_forward_solution keeps the clustering results. The k-means clustering
+    * is the expensive part of clustering a forward solution, with a cache it runs only once per forward solution
+    * and annotation. An empty directory, which is the default, disables the cache.
+    *
+    * @param[in] p_sCacheDir    The cache directory. It is created on first use.
+    */
+    static void setClusterCacheDir(const QString &p_sCacheDir);
+
+    //=========================================================================================================
+    /**
+    * Returns the cluster cache directory.
+    *
+    * @return the cache directory, empty if the cache is disabled
+    */
+    static QString clusterCacheDir();
+
     //=========================================================================================================
     /**
     * Compute orientation prior
@@ -530,6 +572,9 @@ private:
     */
     static bool read_one(FiffStream::SPtr& p_pStream, const FiffDirNode::SPtr& p_Node, MNEForwardSolution& one);
 
+    static QString s_sClusterCacheDir;      /**< Directory of the cluster cache, empty if disabled. */
+    static QMutex s_clusterCacheMutex;      /**< Guards s_sClusterCacheDir. */
+
 public:
     FiffInfoBase info;                  /**< light weighted measurement info */
     fiff_int_t source_ori;              /**< Source orientation: fixed or free */
@@ -315,6 +315,95 @@ bool MNEInverseOperator::assemble_kernel(const Label &label, QString method, boo
 }
 
 
+//*************************************************************************************************************
+
+bool MNEInverseOperator::assemble_kernel_rows(const VectorXi &vecRows, MatrixXd &K) const
+{
+    MatrixXd trans = compute_kernel_trans();
+    if(trans.size() == 0) {
+        qWarning("MNEInverseOperator::assemble_kernel_rows - Inverse operator is not prepared.");
+        return false;
+    }
+
+    return assemble_kernel_rows(vecRows, trans, K);
+}
+
+
+//*************************************************************************************************************
+
+bool MNEInverseOperator::assemble_kernel_rows(const VectorXi &vecRows, const MatrixXd &trans, MatrixXd &K) const
+{
+    if(!eigen_leads || trans.rows() != eigen_leads->data.cols()) {
+        qWarning("MNEInverseOperator::assemble_kernel_rows - Inverse operator is not prepared or transformation does not match.");
+        return false;
+    }
+
+    MatrixXd t_eigen_leads(vecRows.size(), eigen_leads->data.cols());
+    for(qint32 i = 0; i < vecRows.size(); ++i) {
+        if(vecRows[i] < 0 || vecRows[i] >= eigen_leads->data.rows()) {
+            qWarning("MNEInverseOperator::assemble_kernel_rows - Row index %d out of range.", vecRows[i]);
+            return false;
+        }
+
+        t_eigen_leads.row(i) = eigen_leads->data.row(vecRows[i]);
+
+        //
+        //     R^0.5 has to factored in
+        //
+        if(!eigen_leads_weighted) {
+            t_eigen_leads.row(i) *= sqrt(source_cov->data(vecRows[i],0));
+        }
+    }
+
+    K = t_eigen_leads * trans;
+
+    return true;
+}
+
+
+//*************************************************************************************************************
+
+MatrixXd MNEInverseOperator::compute_kernel_trans() const
+{
+    if(!eigen_leads || !eigen_fields || reginv.size() == 0) {
+        return MatrixXd();
+    }
+
+    return reginv.asDiagonal() * (eigen_fields->data * (whitener * proj));
+}
+
+
+//*************************************************************************************************************
+
+VectorXd MNEInverseOperator::compute_noise_norm(const VectorXi &vecSources, float lambda2, bool dSPM) const
+{
+    VectorXd noise_weight;
+    if(dSPM) {
+        noise_weight = reginv;
+    } else {
+        VectorXd tmp = (VectorXd::Constant(sing.size(), 1) + sing.cwiseProduct(sing)/lambda2);
+        noise_weight = reginv.cwiseProduct(tmp.cwiseSqrt());
+    }
+
+    qint32 iRowsPerSource = source_ori == FIFFV_MNE_FREE_ORI ? 3 : 1;
+    VectorXd vecNoiseNorm(vecSources.size());
+
+    for(qint32 i = 0; i < vecSources.size(); ++i) {
+        double dSquaredNorm = 0.0;
+
+        for(qint32 j = 0; j < iRowsPerSource; ++j) {
+            qint32 k = vecSources[i] * iRowsPerSource + j;
+            double c = eigen_leads_weighted ? 1.0 : sqrt(source_cov->data(k,0));
+            dSquaredNorm += (c * eigen_leads->data.row(k).transpose().cwiseProduct(noise_weight)).squaredNorm();
+        }
+
+        vecNoiseNorm[i] = dSquaredNorm > 0.0 ? 1.0 / sqrt(dSquaredNorm) : 0.0;
+    }
+
+    return vecNoiseNorm;
+}
+
+
 //*************************************************************************************************************
 
 bool MNEInverseOperator::check_ch_names(const FiffInfo &info) const
@@ -342,11 +431,9 @@ bool MNEInverseOperator::check_ch_names(const FiffInfo &info) const
         return false;
     }
 
-    QStringList data_ch_names = info.ch_names;
-
     QStringList missing_ch_names;
     for(qint32 i = 0; i < inv_ch_names.size(); ++i)
-        if(!data_ch_names.contains(inv_ch_names[i]))
+        if(info.channelIndex(inv_ch_names[i]) < 0)
             missing_ch_names.append(inv_ch_names[i]);
 
     qint32 n_missing = missing_ch_names.size();
@@ -888,7 +975,7 @@ MNEInverseOperator MNEInverseOperator::make_inverse_operator(const FiffInfo &inf
     qint32 count = 0;
     for(qint32 i = 0; i < info.chs.size(); ++i)
     {
-        if(gain_info.ch_names.contains(info.chs[i].ch_name))
+        if(gain_info.channelIndex(info.chs[i].ch_name) >= 0)
         {
             ch_idx[count] = i;
             ++count;
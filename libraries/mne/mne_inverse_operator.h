@@ -236,6 +236,58 @@ public:
     */
     bool assemble_kernel(const Label &label, QString method, bool pick_normal, MatrixXd &K, SparseMatrix<double> &noise_norm, QList<VectorXi> &vertno);
 
+    //=========================================================================================================
+    /**
+    * Assembles only the requested rows of the (not noise normalized) kernel. In contrast to assemble_kernel the
+    * cost is proportional to the number of requested rows. Has to be called on a prepared inverse operator
+    * (see prepare_inverse_operator).
+    *
+    * @param[in] vecRows        The kernel rows, i.e. the source index for fixed orientations and
+    *                           3*source+component for free orientations.
+    * @param[out] K             The kernel rows (rows x channels).
+    *
+    * @return true when successful, false otherwise
+    */
+    bool assemble_kernel_rows(const VectorXi &vecRows, MatrixXd &K) const;
+
+    //=========================================================================================================
+    /**
+    * Assembles only the requested rows of the (not noise normalized) kernel with a precomputed channel
+    * transformation (see compute_kernel_trans). Use this when rows are assembled repeatedly from the same
+    * prepared inverse operator.
+    *
+    * @param[in] vecRows        The kernel rows, i.e. the source index for fixed orientations and
+    *                           3*source+component for free orientations.
+    * @param[in] trans          The channel transformation returned by compute_kernel_trans.
+    * @param[out] K             The kernel rows (rows x channels).
+    *
+    * @return true when successful, false otherwise
+    */
+    bool assemble_kernel_rows(const VectorXi &vecRows, const MatrixXd &trans, MatrixXd &K) const;
+
+    //=========================================================================================================
+    /**
+    * Computes the channel transformation reginv * eigen_fields * whitener * proj shared by all kernel rows.
+    * Has to be called on a prepared inverse operator (see prepare_inverse_operator).
+    *
+    * @return the transformation (components x channels), empty if the operator is not prepared
+    */
+    MatrixXd compute_kernel_trans() const;
+
+    //=========================================================================================================
+    /**
+    * Computes the dSPM or sLORETA noise-normalization factors of the requested sources only (see
+    * prepare_inverse_operator for the computation over all sources). Has to be called on a prepared inverse
+    * operator. For free orientations one factor per source location is returned.
+    *
+    * @param[in] vecSources     The source indices.
+    * @param[in] lambda2        The regularization factor the operator was prepared with.
+    * @param[in] dSPM           Compute the factors for dSPM (true) or sLORETA (false).
+    *
+    * @return the noise-normalization factors (1/noise norm) of the requested sources
+    */
+    VectorXd compute_noise_norm(const VectorXi &vecSources, float lambda2, bool dSPM) const;
+
     //=========================================================================================================
     /**
     * Check that channels in inverse operator are measurements.
@@ -0,0 +1,847 @@
+//=============================================================================================================
+/**
+* @file     mne_source_morph.cpp
+* @author   agent <agent@local>
+* @version  1.0
+* @date     October, 2026
+*
+* @section  LICENSE
+*
+* Copyright (C) 2026, agent. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+*
+* @brief    MNESourceMorph class definition.
+*
+*/
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "mne_source_morph.h"
+
+#include <fs/surface.h>
+#include <fiff/fiff_stream.h>
+#include <fiff/fiff_tag.h>
+#include <fiff/fiff_dir_node.h>
+#include <fiff/fiff_constants.h>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// Qt INCLUDES
+//=============================================================================================================
+
+#include <QtConcurrent>
+#include <QMutexLocker>
+#include <QThread>
+#include <QVector>
+#include <QFile>
+#include <QDir>
+#include <QDebug>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// STL INCLUDES
+//=============================================================================================================
+
+#include <vector>
+#include <cmath>
+#include <limits>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// USED NAMESPACES
+//=============================================================================================================
+
+using namespace MNELIB;
+using namespace FSLIB;
+using namespace FIFFLIB;
+using namespace Eigen;
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE GLOBAL METHODS
+//=============================================================================================================
+
+namespace {
+
+//=============================================================================================================
+/**
+* Uniform grid over the vertices of a unit sphere for nearest vertex queries.
+*/
+class SphereGrid
+{
+public:
+    explicit SphereGrid(const MatrixX3f& matRr)
+    : m_matRr(matRr)
+    {
+        // About four vertices per occupied cell
+        m_fCellSize = 2.0f * std::sqrt(4.0f * float(EIGEN_PI) / float(qMax(1, int(matRr.rows()))));
+        m_iCells = qBound(1, int(std::ceil(2.0f / m_fCellSize)), 512);
+        m_fCellSize = 2.0f / m_iCells;
+
+        m_vecCellStart.fill(0, m_iCells * m_iCells * m_iCells + 1);
+        QVector<int> vecCell(matRr.rows());
+
+        for(int i = 0; i < matRr.rows(); ++i) {
+            vecCell[i] = cellIndex(cell(matRr(i,0)), cell(matRr(i,1)), cell(matRr(i,2)));
+            ++m_vecCellStart[vecCell[i] + 1];
+        }
+        for(int c = 0; c < m_iCells * m_iCells * m_iCells; ++c) {
+            m_vecCellStart[c + 1] += m_vecCellStart[c];
+        }
+
+        QVector<int> vecFill = m_vecCellStart;
+        m_vecItems.resize(matRr.rows());
+        for(int i = 0; i < matRr.rows(); ++i) {
+            m_vecItems[vecFill[vecCell[i]]++] = i;
+        }
+    }
+
+    int nearest(const Vector3f& vecPoint) const
+    {
+        const int ix = cell(vecPoint.x());
+        const int iy = cell(vecPoint.y());
+        const int iz = cell(vecPoint.z());
+
+        int iBest = -1;
+        float fBestDist = std::numeric_limits<float>::max();
+
+        // Search shells of cells with growing Chebyshev distance. Cells beyond shell r are at least r cell sizes
+        // away, so the search stops as soon as the best vertex is closer than that.
+        for(int r = 0; r < m_iCells; ++r) {
+            for(int dx = -r; dx <= r; ++dx) {
+                for(int dy = -r; dy <= r; ++dy) {
+                    for(int dz = -r; dz <= r; ++dz) {
+                        if(qMax(qAbs(dx), qMax(qAbs(dy), qAbs(dz))) != r) {
+                            continue;
+                        }
+                        const int cx = ix + dx, cy = iy + dy, cz = iz + dz;
+                        if(cx < 0 || cy < 0 || cz < 0 || cx >= m_iCells || cy >= m_iCells || cz >= m_iCells) {
+                            continue;
+                        }
+                        const int c = cellIndex(cx, cy, cz);
+                        for(int k = m_vecCellStart[c]; k < m_vecCellStart[c + 1]; ++k) {
+                            const float fDist = (m_matRr.row(m_vecItems[k]).transpose() - vecPoint).squaredNorm();
+                            if(fDist < fBestDist) {
+                                fBestDist = fDist;
+                                iBest = m_vecItems[k];
+                            }
+                        }
+                    }
+                }
+            }
+
+            if(iBest >= 0 && std::sqrt(fBestDist) <= r * m_fCellSize) {
+                break;
+            }
+        }
+
+        return iBest;
+    }
+
+private:
+    int cell(float fValue) const
+    {
+        return qBound(0, int((fValue + 1.0f) / m_fCellSize), m_iCells - 1);
+    }
+
+    int cellIndex(int ix, int iy, int iz) const
+    {
+        return (ix * m_iCells + iy) * m_iCells + iz;
+    }
+
+    const MatrixX3f&    m_matRr;
+    float               m_fCellSize;
+    int                 m_iCells;
+    QVector<int>        m_vecCellStart;
+    QVector<int>        m_vecItems;
+};
+
+
+//=============================================================================================================
+/**
+* Returns the squared distance of a point to the triangle (a, b, c) and the barycentric weights of the closest
+* point on the triangle (Ericson, Real-Time Collision Detection, 5.1.5).
+*/
+float closestPointWeights(const Vector3f& p, const Vector3f& a, const Vector3f& b, const Vector3f& c, Vector3f& vecWeights)
+{
+    const Vector3f ab = b - a;
+    const Vector3f ac = c - a;
+    const Vector3f ap = p - a;
+    const float d1 = ab.dot(ap);
+    const float d2 = ac.dot(ap);
+
+    if(d1 <= 0.0f && d2 <= 0.0f) {
+        vecWeights << 1.0f, 0.0f, 0.0f;
+    } else {
+        const Vector3f bp = p - b;
+        const float d3 = ab.dot(bp);
+        const float d4 = ac.dot(bp);
+        const Vector3f cp = p - c;
+        const float d5 = ab.dot(cp);
+        const float d6 = ac.dot(cp);
+        const float vc = d1 * d4 - d3 * d2;
+        const float vb = d5 * d2 - d1 * d6;
+        const float va = d3 * d6 - d5 * d4;
+
+        if(d3 >= 0.0f && d4 <= d3) {
+            vecWeights << 0.0f, 1.0f, 0.0f;
+        } else if(vc <= 0.0f && d1 >= 0.0f && d3 <= 0.0f) {
+            const float v = d1 / (d1 - d3);
+            vecWeights << 1.0f - v, v, 0.0f;
+        } else if(d6 >= 0.0f && d5 <= d6) {
+            vecWeights << 0.0f, 0.0f, 1.0f;
+        } else if(vb <= 0.0f && d2 >= 0.0f && d6 <= 0.0f) {
+            const float w = d2 / (d2 - d6);
+            vecWeights << 1.0f - w, 0.0f, w;
+        } else if(va <= 0.0f && (d4 - d3) >= 0.0f && (d5 - d6) >= 0.0f) {
+            const float w = (d4 - d3) / ((d4 - d3) + (d5 - d6));
+            vecWeights << 0.0f, 1.0f - w, w;
+        } else {
+            const float fDenom = 1.0f / (va + vb + vc);
+            const float v = vb * fDenom;
+            const float w = vc * fDenom;
+            vecWeights << 1.0f - v - w, v, w;
+        }
+    }
+
+    return (vecWeights(0) * a + vecWeights(1) * b + vecWeights(2) * c - p).squaredNorm();
+}
+
+
+//=============================================================================================================
+/**
+* Returns the adjacency of the mesh vertices including the vertices themselves, all values set to one.
+*/
+SparseMatrix<double, RowMajor> meshAdjacency(const MatrixX3i& matTris, int iNumVertices)
+{
+    std::vector<Triplet<double> > vecTriplets;
+    vecTriplets.reserve(6 * matTris.rows() + iNumVertices);
+
+    for(int i = 0; i < iNumVertices; ++i) {
+        vecTriplets.push_back(Triplet<double>(i, i, 1.0));
+    }
+    for(int t = 0; t < matTris.rows(); ++t) {
+        for(int k = 0; k < 3; ++k) {
+            vecTriplets.push_back(Triplet<double>(matTris(t,k), matTris(t,(k + 1) % 3), 1.0));
+            vecTriplets.push_back(Triplet<double>(matTris(t,(k + 1) % 3), matTris(t,k), 1.0));
+        }
+    }
+
+    SparseMatrix<double, RowMajor> matAdj(iNumVertices, iNumVertices);
+    matAdj.setFromTriplets(vecTriplets.begin(), vecTriplets.end());
+
+    // Shared edges were summed up
+    for(int k = 0; k < matAdj.outerSize(); ++k) {
+        for(SparseMatrix<double, RowMajor>::InnerIterator it(matAdj, k); it; ++it) {
+            it.valueRef() = 1.0;
+        }
+    }
+
+    return matAdj;
+}
+
+
+//=============================================================================================================
+/**
+* Checks whether all vertex indices are in range.
+*/
+bool verticesInRange(const VectorXi& vecVertices, int iNumVertices)
+{
+    return vecVertices.size() == 0 || (vecVertices.minCoeff() >= 0 && vecVertices.maxCoeff() < iNumVertices);
+}
+
+}
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INITIALIZE STATIC MEMBER
+//=============================================================================================================
+
+QHash<QString, QList<SparseMatrix<double> > > MNESourceMorph::s_hashMorphMaps;
+QMutex MNESourceMorph::s_morphMapMutex;
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE MEMBER METHODS
+//=============================================================================================================
+
+MNESourceMorph::MNESourceMorph()
+{
+}
+
+
+//*************************************************************************************************************
+
+bool MNESourceMorph::compute(const QString& sSubjectFrom,
+                             const QString& sSubjectTo,
+                             const QString& sSubjectsDir,
+                             const QList<VectorXi>& lVerticesFrom,
+                             const QList<VectorXi>& lVerticesTo,
+                             int iSmoothSteps)
+{
+    m_matOperator = SparseMatrix<double, RowMajor>();
+    m_vecVerticesFrom = VectorXi();
+    m_vecVerticesTo = VectorXi();
+
+    QList<SparseMatrix<double> > lMorphMaps;
+    if(!morphMaps(sSubjectFrom, sSubjectTo, sSubjectsDir, lMorphMaps)) {
+        return false;
+    }
+
+    QList<SparseMatrix<double, RowMajor> > lOperators;
+    QList<VectorXi> lFrom, lTo;
+    int iRows = 0, iCols = 0, iNonZeros = 0;
+
+    for(int h = 0; h < 2; ++h) {
+        lFrom.append(h < lVerticesFrom.size() ? lVerticesFrom.at(h) : VectorXi());
+        lTo.append(h < lVerticesTo.size() ? lVerticesTo.at(h) : VectorXi());
+
+        if(lFrom.last().size() == 0 && lTo.last().size() == 0) {
+            lOperators.append(SparseMatrix<double, RowMajor>());
+            continue;
+        }
+
+        // The registered sphere shares its triangulation with the other surfaces of the subject
+        Surface t_surface;
+        if(!Surface::read(sSubjectFrom, h, "sphere.reg", sSubjectsDir, t_surface, false)) {
+            qWarning() << "MNESourceMorph::compute - Could not read the sphere of" << sSubjectFrom;
+            return false;
+        }
+
+        lOperators.append(makeMorphOperator(lMorphMaps.at(h), t_surface.tris(), lFrom.last(), lTo.last(), iSmoothSteps));
+        if(lOperators.last().rows() != lTo.last().size() || lOperators.last().cols() != lFrom.last().size()) {
+            return false;
+        }
+
+        iRows += lTo.last().size();
+        iCols += lFrom.last().size();
+        iNonZeros += lOperators.last().nonZeros();
+    }
+
+    // Assemble the block diagonal operator of both hemispheres
+    std::vector<Triplet<double> > vecTriplets;
+    vecTriplets.reserve(iNonZeros);
+    m_vecVerticesFrom.resize(iCols);
+    m_vecVerticesTo.resize(iRows);
+
+    int iRowOffset = 0, iColOffset = 0;
+    for(int h = 0; h < 2; ++h) {
+        for(int k = 0; k < lOperators.at(h).outerSize(); ++k) {
+            for(SparseMatrix<double, RowMajor>::InnerIterator it(lOperators.at(h), k); it; ++it) {
+                vecTriplets.push_back(Triplet<double>(iRowOffset + it.row(), iColOffset + it.col(), it.value()));
+            }
+        }
+
+        m_vecVerticesTo.segment(iRowOffset, lTo.at(h).size()) = lTo.at(h);
+        m_vecVerticesFrom.segment(iColOffset, lFrom.at(h).size()) = lFrom.at(h);
+        iRowOffset += lTo.at(h).size();
+        iColOffset += lFrom.at(h).size();
+    }
+
+    m_matOperator.resize(iRows, iCols);
+    m_matOperator.setFromTriplets(vecTriplets.begin(), vecTriplets.end());
+
+    return true;
+}
+
+
+//*************************************************************************************************************
+
+bool MNESourceMorph::isEmpty() const
+{
+    return m_matOperator.rows() == 0;
+}
+
+
+//*************************************************************************************************************
+
+const SparseMatrix<double, RowMajor>& MNESourceMorph::morphOperator() const
+{
+    return m_matOperator;
+}
+
+
+//*************************************************************************************************************
+
+const VectorXi& MNESourceMorph::verticesFrom() const
+{
+    return m_vecVerticesFrom;
+}
+
+
+//*************************************************************************************************************
+
+const VectorXi& MNESourceMorph::verticesTo() const
+{
+    return m_vecVerticesTo;
+}
+
+
+//*************************************************************************************************************
+
+MatrixXd MNESourceMorph::apply(const MatrixXd& matData) const
+{
+    if(isEmpty() || m_matOperator.cols() != matData.rows()) {
+        qWarning() << "MNESourceMorph::apply - Dimension mismatch. Returning empty matrix.";
+        return MatrixXd();
+    }
+
+    MatrixXd matOut(m_matOperator.rows(), matData.cols());
+
+    //Split the vertices into one contiguous range per thread. Small products are not worth the scheduling.
+    const int iNumRows = m_matOperator.rows();
+    const int iNumRanges = qBound(1, qMin(QThread::idealThreadCount(), iNumRows / 1024), 64);
+    const int iRangeSize = (iNumRows + iNumRanges - 1) / iNumRanges;
+
+    if(iNumRanges <= 1) {
+        matOut.noalias() = m_matOperator * matData;
+        return matOut;
+    }
+
+    QVector<int> vecRangeStarts;
+    for(int i = 0; i < iNumRows; i += iRangeSize) {
+        vecRangeStarts.append(i);
+    }
+
+    QtConcurrent::blockingMap(vecRangeStarts, [&](const int& iStart) {
+        const int iRows = qMin(iRangeSize, iNumRows - iStart);
+        matOut.middleRows(iStart, iRows).noalias() = m_matOperator.middleRows(iStart, iRows) * matData;
+    });
+
+    return matOut;
+}
+
+
+//*************************************************************************************************************
+
+MNESourceEstimate MNESourceMorph::apply(const MNESourceEstimate& sourceEstimate, int iBlockSize) const
+{
+    if(isEmpty() || sourceEstimate.vertices.size() != m_vecVerticesFrom.size()
+       || sourceEstimate.vertices != m_vecVerticesFrom) {
+        qWarning() << "MNESourceMorph::apply - The vertices of the source estimate do not match. Returning empty source estimate.";
+        return MNESourceEstimate();
+    }
+
+    if(!sourceEstimate.isLazy()) {
+        return MNESourceEstimate(apply(sourceEstimate.data), m_vecVerticesTo, sourceEstimate.tmin, sourceEstimate.tstep);
+    }
+
+    // Morph window by window, so that only one window of the unmorphed data is held in memory
+    const int iSamples = sourceEstimate.samples();
+    const int iStep = qMax(1, iBlockSize);
+    MatrixXd matData(m_vecVerticesTo.size(), iSamples);
+
+    for(int iStart = 0; iStart < iSamples; iStart += iStep) {
+        const int n = qMin(iStep, iSamples - iStart);
+        MatrixXd matWindow = sourceEstimate.getData(iStart, n);
+
+        if(matWindow.cols() != n) {
+            qWarning() << "MNESourceMorph::apply - Could not read samples" << iStart << "to" << iStart + n - 1 << "of the lazy source estimate. Returning empty source estimate.";
+            return MNESourceEstimate();
+        }
+
+        matData.middleCols(iStart, n) = apply(matWindow);
+    }
+
+    return MNESourceEstimate(matData, m_vecVerticesTo, sourceEstimate.tmin, sourceEstimate.tstep);
+}
+
+
+//*************************************************************************************************************
+
+bool MNESourceMorph::morphMaps(const QString& sSubjectFrom,
+                               const QString& sSubjectTo,
+                               const QString& sSubjectsDir,
+                               QList<SparseMatrix<double> >& lMorphMaps)
+{
+    const QString sKey = sSubjectsDir + "/" + sSubjectFrom + "->" + sSubjectTo;
+    const QString sKeyReverse = sSubjectsDir + "/" + sSubjectTo + "->" + sSubjectFrom;
+
+    {
+        QMutexLocker locker(&s_morphMapMutex);
+        if(s_hashMorphMaps.contains(sKey)) {
+            lMorphMaps = s_hashMorphMaps.value(sKey);
+            return true;
+        }
+    }
+
+    // MNE-C and MNE-Python store the maps of both directions in the file of either direction
+    const QString sMorphDir = sSubjectsDir + "/morph-maps";
+    const QString sFileName = QString("%1/%2-%3-morph.fif").arg(sMorphDir).arg(sSubjectFrom).arg(sSubjectTo);
+    const QString sFileNameReverse = QString("%1/%2-%3-morph.fif").arg(sMorphDir).arg(sSubjectTo).arg(sSubjectFrom);
+
+    QList<SparseMatrix<double> > lMaps;
+    bool bFound = (QFile::exists(sFileName) && readMorphMaps(sFileName, sSubjectFrom, sSubjectTo, lMaps))
+                  || (QFile::exists(sFileNameReverse) && readMorphMaps(sFileNameReverse, sSubjectFrom, sSubjectTo, lMaps));
+
+    if(!bFound) {
+        QList<SparseMatrix<double> > lMapsReverse;
+        lMaps.clear();
+
+        for(int h = 0; h < 2; ++h) {
+            Surface t_surfFrom, t_surfTo;
+            if(!Surface::read(sSubjectFrom, h, "sphere.reg", sSubjectsDir, t_surfFrom, false)
+               || !Surface::read(sSubjectTo, h, "sphere.reg", sSubjectsDir, t_surfTo, false)) {
+                qWarning() << "MNESourceMorph::morphMaps - Could not read the spheres of" << sSubjectFrom << "and" << sSubjectTo;
+                return false;
+            }
+
+            if(sSubjectFrom == sSubjectTo) {
+                SparseMatrix<double> matIdentity(t_surfFrom.rr().rows(), t_surfFrom.rr().rows());
+                matIdentity.setIdentity();
+                lMaps.append(matIdentity);
+            } else {
+                printf("Creating morph maps %s <-> %s (%s)...", sSubjectFrom.toUtf8().constData(), sSubjectTo.toUtf8().constData(), h == 0 ? "lh" : "rh");
+                lMaps.append(makeMorphMap(t_surfFrom.rr(), t_surfFrom.tris(), t_surfTo.rr()));
+                lMapsReverse.append(makeMorphMap(t_surfTo.rr(), t_surfTo.tris(), t_surfFrom.rr()));
+                printf("[done]\n");
+            }
+        }
+
+        if(sSubjectFrom != sSubjectTo) {
+            if(!QDir().mkpath(sMorphDir) || !writeMorphMaps(sFileName, sSubjectFrom, sSubjectTo, lMaps, lMapsReverse)) {
+                qWarning() << "MNESourceMorph::morphMaps - Could not write" << sFileName;
+            }
+
+            QMutexLocker locker(&s_morphMapMutex);
+            s_hashMorphMaps.insert(sKeyReverse, lMapsReverse);
+        }
+    }
+
+    QMutexLocker locker(&s_morphMapMutex);
+    s_hashMorphMaps.insert(sKey, lMaps);
+    lMorphMaps = lMaps;
+
+    return true;
+}
+
+
+//*************************************************************************************************************
+
+void MNESourceMorph::clearCache()
+{
+    QMutexLocker locker(&s_morphMapMutex);
+    s_hashMorphMaps.clear();
+}
+
+
+//*************************************************************************************************************
+
+bool MNESourceMorph::readMorphMaps(const QString& sFileName,
+                                   const QString& sSubjectFrom,
+                                   const QString& sSubjectTo,
+                                   QList<SparseMatrix<double> >& lMorphMaps)
+{
+    QFile t_file(sFileName);
+    FiffStream::SPtr t_pStream(new FiffStream(&t_file));
+
+    if(!t_pStream->open()) {
+        return false;
+    }
+
+    QList<FiffDirNode::SPtr> lNodes = t_pStream->dirtree()->dir_tree_find(FIFFB_MNE_MORPH_MAP);
+    FiffTag::SPtr t_pTag;
+
+    for(int i = 0; i < lNodes.size(); ++i) {
+        QString sFrom, sTo;
+        QList<SparseMatrix<double> > lMaps;
+
+        for(int k = 0; k < lNodes[i]->nent(); ++k) {
+            const fiff_int_t kind = lNodes[i]->dir[k]->kind;
+            const fiff_int_t pos = lNodes[i]->dir[k]->pos;
+
+            if(kind == FIFF_MNE_MORPH_MAP_FROM) {
+                t_pStream->read_tag(t_pTag, pos);
+                sFrom = t_pTag->toString();
+            } else if(kind == FIFF_MNE_MORPH_MAP_TO) {
+                t_pStream->read_tag(t_pTag, pos);
+                sTo = t_pTag->toString();
+            } else if(kind == FIFF_MNE_MORPH_MAP) {
+                // The left hemisphere is stored first
+                t_pStream->read_tag(t_pTag, pos);
+                lMaps.append(t_pTag->toSparseFloatMatrix());
+            }
+        }
+
+        if(sFrom == sSubjectFrom && sTo == sSubjectTo && lMaps.size() == 2) {
+            lMorphMaps = lMaps;
+            t_pStream->close();
+            return true;
+        }
+    }
+
+    t_pStream->close();
+
+    return false;
+}
+
+
+//*************************************************************************************************************
+
+bool MNESourceMorph::writeMorphMaps(const QString& sFileName,
+                                    const QString& sSubjectFrom,
+                                    const QString& sSubjectTo,
+                                    const QList<SparseMatrix<double> >& lMorphMaps,
+                                    const QList<SparseMatrix<double> >& lMorphMapsReverse)
+{
+    if(lMorphMaps.size() != 2 || lMorphMapsReverse.size() != 2) {
+        return false;
+    }
+
+    QFile t_file(sFileName);
+    FiffStream::SPtr t_pStream = FiffStream::start_file(t_file);
+
+    if(!t_pStream) {
+        return false;
+    }
+
+    // The from -> to block is followed by the to -> from block, the left hemisphere is stored first
+    for(int d = 0; d < 2; ++d) {
+        const QList<SparseMatrix<double> >& lMaps = d == 0 ? lMorphMaps : lMorphMapsReverse;
+
+        t_pStream->start_block(FIFFB_MNE_MORPH_MAP);
+        t_pStream->write_string(FIFF_MNE_MORPH_MAP_FROM, d == 0 ? sSubjectFrom : sSubjectTo);
+        t_pStream->write_string(FIFF_MNE_MORPH_MAP_TO, d == 0 ? sSubjectTo : sSubjectFrom);
+        for(int h = 0; h < 2; ++h) {
+            t_pStream->write_float_sparse_rcs(FIFF_MNE_MORPH_MAP, lMaps.at(h).cast<float>());
+        }
+        t_pStream->end_block(FIFFB_MNE_MORPH_MAP);
+    }
+    t_pStream->end_file();
+
+    return true;
+}
+
+
+//*************************************************************************************************************
+
+SparseMatrix<double> MNESourceMorph::makeMorphMap(const MatrixX3f& matRrFrom,
+                                                  const MatrixX3i& matTrisFrom,
+                                                  const MatrixX3f& matRrTo)
+{
+    const int iNumFrom = matRrFrom.rows();
+    const int iNumTo = matRrTo.rows();
+
+    if(iNumFrom == 0 || matTrisFrom.rows() == 0
+       || matTrisFrom.minCoeff() < 0 || matTrisFrom.maxCoeff() >= iNumFrom) {
+        qWarning() << "MNESourceMorph::makeMorphMap - Invalid surface. Returning empty map.";
+        return SparseMatrix<double>();
+    }
+
+    // The registered spheres have a radius of about 100 mm
+    const MatrixX3f matFrom = matRrFrom.rowwise().normalized();
+    const MatrixX3f matTo = matRrTo.rowwise().normalized();
+
+    // Triangles of each vertex
+    QVector<int> vecTriStart(iNumFrom + 1, 0);
+    for(int t = 0; t < matTrisFrom.rows(); ++t) {
+        for(int k = 0; k < 3; ++k) {
+            ++vecTriStart[matTrisFrom(t,k) + 1];
+        }
+    }
+    for(int i = 0; i < iNumFrom; ++i) {
+        vecTriStart[i + 1] += vecTriStart[i];
+    }
+    QVector<int> vecTris(vecTriStart[iNumFrom]);
+    QVector<int> vecFill = vecTriStart;
+    for(int t = 0; t < matTrisFrom.rows(); ++t) {
+        for(int k = 0; k < 3; ++k) {
+            vecTris[vecFill[matTrisFrom(t,k)]++] = t;
+        }
+    }
+
+    const SphereGrid grid(matFrom);
+
+    // The closest triangle is searched among the triangles of the nearest vertex, as done by MNE-C
+    MatrixX3i matIdx(iNumTo, 3);
+    MatrixX3f matWeights(iNumTo, 3);
+
+    const int iNumRanges = qBound(1, qMin(QThread::idealThreadCount(), iNumTo / 1024), 64);
+    const int iRangeSize = (iNumTo + iNumRanges - 1) / iNumRanges;
+
+    QVector<int> vecRangeStarts;
+    for(int i = 0; i < iNumTo; i += iRangeSize) {
+        vecRangeStarts.append(i);
+    }
+
+    QtConcurrent::blockingMap(vecRangeStarts, [&](const int& iStart) {
+        const int iEnd = qMin(iStart + iRangeSize, iNumTo);
+        Vector3f vecWeights;
+
+        for(int i = iStart; i < iEnd; ++i) {
+            const Vector3f vecPoint = matTo.row(i).transpose();
+            const int iNearest = grid.nearest(vecPoint);
+
+            float fBestDist = std::numeric_limits<float>::max();
+            matIdx.row(i).setConstant(iNearest);
+            matWeights.row(i) << 1.0f, 0.0f, 0.0f;
+
+            for(int k = vecTriStart[iNearest]; k < vecTriStart[iNearest + 1]; ++k) {
+                const int t = vecTris[k];
+                const float fDist = closestPointWeights(vecPoint,
+                                                        matFrom.row(matTrisFrom(t,0)).transpose(),
+                                                        matFrom.row(matTrisFrom(t,1)).transpose(),
+                                                        matFrom.row(matTrisFrom(t,2)).transpose(),
+                                                        vecWeights);
+                if(fDist < fBestDist) {
+                    fBestDist = fDist;
+                    matIdx.row(i) = matTrisFrom.row(t);
+                    matWeights.row(i) = vecWeights.transpose();
+                }
+            }
+        }
+    });
+
+    std::vector<Triplet<double> > vecTriplets;
+    vecTriplets.reserve(3 * iNumTo);
+
+    for(int i = 0; i < iNumTo; ++i) {
+        for(int k = 0; k < 3; ++k) {
+            if(matWeights(i,k) > 0.0f) {
+                vecTriplets.push_back(Triplet<double>(i, matIdx(i,k), matWeights(i,k)));
+            }
+        }
+    }
+
+    SparseMatrix<double> matMorphMap(iNumTo, iNumFrom);
+    matMorphMap.setFromTriplets(vecTriplets.begin(), vecTriplets.end());
+
+    return matMorphMap;
+}
+
+
+//*************************************************************************************************************
+
+SparseMatrix<double, RowMajor> MNESourceMorph::makeMorphOperator(const SparseMatrix<double>& matMorphMap,
+                                                                 const MatrixX3i& matTrisFrom,
+                                                                 const VectorXi& vecVerticesFrom,
+                                                                 const VectorXi& vecVerticesTo,
+                                                                 int iSmoothSteps)
+{
+    const int iNumVertices = matMorphMap.cols();
+
+    if(!verticesInRange(vecVerticesFrom, iNumVertices) || !verticesInRange(vecVerticesTo, matMorphMap.rows())
+       || (matTrisFrom.rows() > 0 && (matTrisFrom.minCoeff() < 0 || matTrisFrom.maxCoeff() >= iNumVertices))) {
+        qWarning() << "MNESourceMorph::makeMorphOperator - Vertex indices out of range. Returning empty operator.";
+        return SparseMatrix<double, RowMajor>();
+    }
+
+    const SparseMatrix<double, RowMajor> matAdj = meshAdjacency(matTrisFrom, iNumVertices);
+
+    // Position of each vertex within the vertices which carry data, -1 for the others
+    VectorXi vecPos = VectorXi::Constant(iNumVertices, -1);
+    int iNumUsed = 0;
+    for(int i = 0; i < vecVerticesFrom.size(); ++i) {
+        if(vecPos[vecVerticesFrom[i]] < 0) {
+            vecPos[vecVerticesFrom[i]] = iNumUsed++;
+        }
+    }
+
+    // The smoothing steps are accumulated in one operator from the source vertices to the vertices reached so far
+    SparseMatrix<double, RowMajor> matSmooth(iNumUsed, vecVerticesFrom.size());
+    {
+        std::vector<Triplet<double> > vecTriplets;
+        for(int i = 0; i < vecVerticesFrom.size(); ++i) {
+            vecTriplets.push_back(Triplet<double>(vecPos[vecVerticesFrom[i]], i, 1.0));
+        }
+        matSmooth.setFromTriplets(vecTriplets.begin(), vecTriplets.end());
+    }
+
+    const int iMaxSteps = iSmoothSteps < 1 ? 99 : iSmoothSteps;
+
+    for(int k = 0; k < iMaxSteps && iNumUsed > 0; ++k) {
+        if(iSmoothSteps < 1 && iNumUsed == iNumVertices) {
+            break;
+        }
+
+        VectorXi vecPosNew = VectorXi::Constant(iNumVertices, -1);
+        int iNumUsedNew = 0;
+        std::vector<Triplet<double> > vecTriplets;
+        vecTriplets.reserve(matAdj.nonZeros());
+
+        for(int r = 0; r < iNumVertices; ++r) {
+            int iCount = 0;
+            for(SparseMatrix<double, RowMajor>::InnerIterator it(matAdj, r); it; ++it) {
+                if(vecPos[it.col()] >= 0) {
+                    ++iCount;
+                }
+            }
+
+            if(iCount == 0) {
+                continue;
+            }
+
+            vecPosNew[r] = iNumUsedNew++;
+            for(SparseMatrix<double, RowMajor>::InnerIterator it(matAdj, r); it; ++it) {
+                if(vecPos[it.col()] >= 0) {
+                    vecTriplets.push_back(Triplet<double>(vecPosNew[r], vecPos[it.col()], 1.0 / iCount));
+                }
+            }
+        }
+
+        SparseMatrix<double, RowMajor> matStep(iNumUsedNew, iNumUsed);
+        matStep.setFromTriplets(vecTriplets.begin(), vecTriplets.end());
+
+        matSmooth = (matStep * matSmooth).pruned();
+        vecPos = vecPosNew;
+        iNumUsed = iNumUsedNew;
+    }
+
+    // Select the rows of the morph map and drop the columns of vertices which did not receive any data
+    const SparseMatrix<double, RowMajor> matMapRows = matMorphMap;
+    SparseMatrix<double, RowMajor> matMap(vecVerticesTo.size(), iNumUsed);
+    {
+        std::vector<Triplet<double> > vecTriplets;
+        vecTriplets.reserve(3 * vecVerticesTo.size());
+        for(int i = 0; i < vecVerticesTo.size(); ++i) {
+            for(SparseMatrix<double, RowMajor>::InnerIterator it(matMapRows, vecVerticesTo[i]); it; ++it) {
+                if(vecPos[it.col()] >= 0) {
+                    vecTriplets.push_back(Triplet<double>(i, vecPos[it.col()], it.value()));
+                }
+            }
+        }
+        matMap.setFromTriplets(vecTriplets.begin(), vecTriplets.end());
+    }
+
+    SparseMatrix<double, RowMajor> matOperator = (matMap * matSmooth).pruned();
+
+    int iNumEmpty = 0;
+    for(int i = 0; i < matOperator.rows(); ++i) {
+        if(matOperator.outerIndexPtr()[i + 1] == matOperator.outerIndexPtr()[i]) {
+            ++iNumEmpty;
+        }
+    }
+    if(iNumEmpty > 0 && vecVerticesFrom.size() > 0) {
+        qWarning() << "MNESourceMorph::makeMorphOperator -" << iNumEmpty << "vertices do not receive any data. Consider more smoothing steps.";
+    }
+
+    return matOperator;
+}
@@ -0,0 +1,280 @@
+//=============================================================================================================
+/**
+* @file     mne_source_morph.h
+* @author   agent <agent@local>
+* @version  1.0
+* @date     October, 2026
+*
+* @section  LICENSE
+*
+* Copyright (C) 2026, agent. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+*
+* @brief    MNESourceMorph class declaration.
+*
+*/
+
+#ifndef MNE_SOURCE_MORPH_H
+#define MNE_SOURCE_MORPH_H
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "mne_global.h"
+#include "mne_sourceestimate.h"
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// Eigen INCLUDES
+//=============================================================================================================
+
+#include <Eigen/Core>
+#include <Eigen/SparseCore>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// Qt INCLUDES
+//=============================================================================================================
+
+#include <QSharedPointer>
+#include <QString>
+#include <QList>
+#include <QHash>
+#include <QMutex>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE NAMESPACE MNELIB
+//=============================================================================================================
+
+namespace MNELIB
+{
+
+
+//=============================================================================================================
+/**
+* Morphs source estimates from the source space of one subject to the source space of another subject, e.g.,
+* fsaverage. The morph maps between the registered spheres (?h.sphere.reg) are read from or written to
+* $SUBJECTS_DIR/morph-maps as done by MNE-C and MNE-Python, and are cached in memory per subject pair. The smoothing
+* steps and the morph maps of both hemispheres are combined once into a single sparse operator, which is then
+* applied to blocks of samples in parallel.
+*
+* @brief Sparse morphing of source estimates between subjects
+*/
+class MNESHARED_EXPORT MNESourceMorph
+{
+public:
+    typedef QSharedPointer<MNESourceMorph> SPtr;            /**< Shared pointer type for MNESourceMorph. */
+    typedef QSharedPointer<const MNESourceMorph> ConstSPtr; /**< Const shared pointer type for MNESourceMorph. */
+
+    //=========================================================================================================
+    /**
+    * Constructs an empty morph, which has to be set up with compute().
+    */
+    MNESourceMorph();
+
+    //=========================================================================================================
+    /**
+    * Sets up the morph operator between two subjects.
+    *
+    * @param[in] sSubjectFrom       The subject the source estimates belong to.
+    * @param[in] sSubjectTo         The subject to morph to, e.g., fsaverage.
+    * @param[in] sSubjectsDir       The FreeSurfer subjects directory.
+    * @param[in] lVerticesFrom      The source vertices of the left and right hemisphere of sSubjectFrom. An empty
+    *                               vector excludes the hemisphere.
+    * @param[in] lVerticesTo        The vertices of the left and right hemisphere of sSubjectTo to morph to.
+    * @param[in] iSmoothSteps       The number of smoothing steps on the surface of sSubjectFrom. If smaller than
+    *                               one, the data is smoothed until every vertex of the surface is reached.
+    *
+    * @return true if successful, false otherwise.
+    */
+    bool compute(const QString& sSubjectFrom,
+                 const QString& sSubjectTo,
+                 const QString& sSubjectsDir,
+                 const QList<Eigen::VectorXi>& lVerticesFrom,
+                 const QList<Eigen::VectorXi>& lVerticesTo,
+                 int iSmoothSteps = 5);
+
+    //=========================================================================================================
+    /**
+    * Returns whether the morph operator was set up.
+    *
+    * @return true if compute() was successful, false otherwise.
+    */
+    bool isEmpty() const;
+
+    //=========================================================================================================
+    /**
+    * Returns the combined morph operator of shape [n_vertices_to x n_vertices_from].
+    *
+    * @return The morph operator.
+    */
+    const Eigen::SparseMatrix<double, Eigen::RowMajor>& morphOperator() const;
+
+    //=========================================================================================================
+    /**
+    * Returns the source vertices of both hemispheres of the subject to morph from, left hemisphere first.
+    *
+    * @return The vertices the operator expects.
+    */
+    const Eigen::VectorXi& verticesFrom() const;
+
+    //=========================================================================================================
+    /**
+    * Returns the vertices of both hemispheres of the subject to morph to, left hemisphere first.
+    *
+    * @return The vertices the operator produces.
+    */
+    const Eigen::VectorXi& verticesTo() const;
+
+    //=========================================================================================================
+    /**
+    * Morphs data. The rows of the result are computed in blocks on all available cores.
+    *
+    * @param[in] matData    The data of shape [n_vertices_from x n_samples].
+    *
+    * @return The morphed data of shape [n_vertices_to x n_samples], empty if the shape does not match.
+    */
+    Eigen::MatrixXd apply(const Eigen::MatrixXd& matData) const;
+
+    //=========================================================================================================
+    /**
+    * Morphs a source estimate. Lazy source estimates are read and morphed in windows of iBlockSize samples.
+    *
+    * @param[in] sourceEstimate     The source estimate with the vertices returned by verticesFrom().
+    * @param[in] iBlockSize         The number of samples read at once from lazy source estimates.
+    *
+    * @return The morphed source estimate, empty if the vertices do not match.
+    */
+    MNESourceEstimate apply(const MNESourceEstimate& sourceEstimate, int iBlockSize = 1000) const;
+
+    //=========================================================================================================
+    /**
+    * Returns the morph maps of both hemispheres from one subject to another. The maps are taken from the memory
+    * cache, read from $SUBJECTS_DIR/morph-maps or created from the registered spheres and written there, in
+    * this order.
+    *
+    * @param[in] sSubjectFrom       The subject to morph from.
+    * @param[in] sSubjectTo         The subject to morph to.
+    * @param[in] sSubjectsDir       The FreeSurfer subjects directory.
+    * @param[out] lMorphMaps        The maps of the left and right hemisphere of shape [n_vertices_to x n_vertices_from].
+    *
+    * @return true if successful, false otherwise.
+    */
+    static bool morphMaps(const QString& sSubjectFrom,
+                          const QString& sSubjectTo,
+                          const QString& sSubjectsDir,
+                          QList<Eigen::SparseMatrix<double> >& lMorphMaps);
+
+    //=========================================================================================================
+    /**
+    * Clears the memory cache of morph maps.
+    */
+    static void clearCache();
+
+    //=========================================================================================================
+    /**
+    * Reads the morph maps of both hemispheres from a morph map file.
+    *
+    * @param[in] sFileName          The morph map file, e.g., $SUBJECTS_DIR/morph-maps/sample-fsaverage-morph.fif.
+    * @param[in] sSubjectFrom       The subject to morph from.
+    * @param[in] sSubjectTo         The subject to morph to.
+    * @param[out] lMorphMaps        The maps of the left and right hemisphere.
+    *
+    * @return true if the file contains the maps, false otherwise.
+    */
+    static bool readMorphMaps(const QString& sFileName,
+                              const QString& sSubjectFrom,
+                              const QString& sSubjectTo,
+                              QList<Eigen::SparseMatrix<double> >& lMorphMaps);
+
+    //=========================================================================================================
+    /**
+    * Writes the morph maps of both hemispheres and both directions to a morph map file. As in MNE-C and
+    * MNE-Python the file holds one FIFFB_MNE_MORPH_MAP block per direction.
+    *
+    * @param[in] sFileName          The file to write.
+    * @param[in] sSubjectFrom       The subject to morph from.
+    * @param[in] sSubjectTo         The subject to morph to.
+    * @param[in] lMorphMaps         The maps of the left and right hemisphere from sSubjectFrom to sSubjectTo.
+    * @param[in] lMorphMapsReverse  The maps of the left and right hemisphere from sSubjectTo to sSubjectFrom.
+    *
+    * @return true if successful, false otherwise.
+    */
+    static bool writeMorphMaps(const QString& sFileName,
+                               const QString& sSubjectFrom,
+                               const QString& sSubjectTo,
+                               const QList<Eigen::SparseMatrix<double> >& lMorphMaps,
+                               const QList<Eigen::SparseMatrix<double> >& lMorphMapsReverse);
+
+    //=========================================================================================================
+    /**
+    * Creates the morph map of one hemisphere. Each vertex of the target sphere is mapped onto the closest
+    * triangle of the source sphere and interpolated with its barycentric weights. The vertices are processed in
+    * parallel.
+    *
+    * @param[in] matRrFrom      The vertices of the registered sphere to morph from.
+    * @param[in] matTrisFrom    The triangles of the registered sphere to morph from.
+    * @param[in] matRrTo        The vertices of the registered sphere to morph to.
+    *
+    * @return The morph map of shape [n_vertices_to x n_vertices_from].
+    */
+    static Eigen::SparseMatrix<double> makeMorphMap(const Eigen::MatrixX3f& matRrFrom,
+                                                    const Eigen::MatrixX3i& matTrisFrom,
+                                                    const Eigen::MatrixX3f& matRrTo);
+
+    //=========================================================================================================
+    /**
+    * Combines the smoothing steps and the morph map of one hemisphere into a single operator. Each smoothing step
+    * averages the values of a vertex and its neighbors which already carry data, so that the data spreads from
+    * the source vertices over the surface.
+    *
+    * @param[in] matMorphMap        The morph map of the hemisphere.
+    * @param[in] matTrisFrom        The triangles of the surface to morph from.
+    * @param[in] vecVerticesFrom    The source vertices to morph from.
+    * @param[in] vecVerticesTo      The vertices to morph to.
+    * @param[in] iSmoothSteps       The number of smoothing steps, see compute().
+    *
+    * @return The operator of shape [n_vertices_to x n_vertices_from].
+    */
+    static Eigen::SparseMatrix<double, Eigen::RowMajor> makeMorphOperator(const Eigen::SparseMatrix<double>& matMorphMap,
+                                                                          const Eigen::MatrixX3i& matTrisFrom,
+                                                                          const Eigen::VectorXi& vecVerticesFrom,
+                                                                          const Eigen::VectorXi& vecVerticesTo,
+                                                                          int iSmoothSteps);
+
+private:
+    Eigen::SparseMatrix<double, Eigen::RowMajor>    m_matOperator;      /**< The combined morph operator. */
+    Eigen::VectorXi                                 m_vecVerticesFrom;  /**< The vertices to morph from, left hemisphere first. */
+    Eigen::VectorXi                                 m_vecVerticesTo;    /**< The vertices to morph to, left hemisphere first. */
+
+    static QHash<QString, QList<Eigen::SparseMatrix<double> > > s_hashMorphMaps;    /**< The morph maps per subject pair. */
+    static QMutex                                               s_morphMapMutex;    /**< Guards s_hashMorphMaps. */
+};
+
+} // NAMESPACE MNELIB
+
+#endif // MNE_SOURCE_MORPH_H
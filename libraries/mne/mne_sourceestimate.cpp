@@ -39,6 +39,7 @@
 //=============================================================================================================
 
 #include "mne_sourceestimate.h"
+#include "mne_chunked_stc_writer.h"
 
 
 //*************************************************************************************************************
@@ -94,6 +95,7 @@ MNESourceEstimate::MNESourceEstimate(const MNESourceEstimate& p_SourceEstimate)
 , times(p_SourceEstimate.times)
 , tmin(p_SourceEstimate.tmin)
 , tstep(p_SourceEstimate.tstep)
+, m_pChunkedReader(p_SourceEstimate.m_pChunkedReader)
 {
 
 }
@@ -122,6 +124,7 @@ void MNESourceEstimate::clear()
     times = RowVectorXf();
     tmin = 0;
     tstep = 0;
+    m_pChunkedReader.clear();
 }
 
 
@@ -131,10 +134,14 @@ MNESourceEstimate MNESourceEstimate::reduce(qint32 start, qint32 n)
 {
     MNESourceEstimate p_sourceEstimateReduced;
 
-    qint32 rows = this->data.rows();
+    if(isLazy()) {
+        p_sourceEstimateReduced.data = this->getData(start, n);
+    } else {
+        qint32 rows = this->data.rows();
 
-    p_sourceEstimateReduced.data = MatrixXd::Zero(rows,n);
-    p_sourceEstimateReduced.data = this->data.block(0, start, rows, n);
+        p_sourceEstimateReduced.data = MatrixXd::Zero(rows,n);
+        p_sourceEstimateReduced.data = this->data.block(0, start, rows, n);
+    }
     p_sourceEstimateReduced.vertices = this->vertices;
     p_sourceEstimateReduced.times = RowVectorXf::Zero(n);
     p_sourceEstimateReduced.times = this->times.block(0,start,1,n);
@@ -236,12 +243,33 @@ bool MNESourceEstimate::write(QIODevice &p_IODevice)
     for(qint32 i = 0; i < this->vertices.size(); ++i)
         *t_pStream << (quint32)this->vertices[i];
     // write the number of timepts
-    *t_pStream << (quint32)this->data.cols();
+    *t_pStream << (quint32)this->samples();
     //
     // write the data
     //
-    for(qint32 i = 0; i < this->data.array().size(); ++i)
-        *t_pStream << (float)this->data.array()(i);
+    if(isLazy())
+    {
+        // Lazy estimates are streamed window by window, the samples are stored time point after time point
+        const qint32 iStep = 1000;
+        for(qint32 j = 0; j < this->samples(); j += iStep)
+        {
+            MatrixXd matWindow = this->getData(j, qMin(iStep, this->samples() - j));
+            if(matWindow.size() == 0)
+            {
+                t_pStream->device()->close();
+                printf("[failed]\n");
+                return false;
+            }
+
+            for(qint32 i = 0; i < matWindow.array().size(); ++i)
+                *t_pStream << (float)matWindow.array()(i);
+        }
+    }
+    else
+    {
+        for(qint32 i = 0; i < this->data.array().size(); ++i)
+            *t_pStream << (float)this->data.array()(i);
+    }
 
     // close the file
     t_pStream->device()->close();
@@ -251,13 +279,111 @@ bool MNESourceEstimate::write(QIODevice &p_IODevice)
 }
 
 
+//*************************************************************************************************************
+
+bool MNESourceEstimate::readChunked(const QString &sFileName, MNESourceEstimate& p_stc)
+{
+    MNEChunkedStcReader::SPtr pReader = MNEChunkedStcReader::SPtr(new MNEChunkedStcReader(sFileName));
+
+    if(!pReader->isOpen())
+        return false;
+
+    p_stc.clear();
+    p_stc.vertices = pReader->vertices();
+    p_stc.tmin = pReader->tmin();
+    p_stc.tstep = pReader->tstep();
+    p_stc.m_pChunkedReader = pReader;
+
+    p_stc.update_times();
+
+    return true;
+}
+
+
+//*************************************************************************************************************
+
+bool MNESourceEstimate::writeChunked(const QString &sFileName, int iChunkSize, bool bCompress) const
+{
+    MNEChunkedStcWriter writer(sFileName, this->vertices, this->tmin, this->tstep, iChunkSize, bCompress);
+
+    if(!writer.isOpen())
+        return false;
+
+    //Lazy estimates are copied window by window, so they are never loaded completely
+    const qint32 iSamples = this->samples();
+    const qint32 iStep = qMax(1, iChunkSize);
+
+    for(qint32 i = 0; i < iSamples; i += iStep)
+    {
+        qint32 n = qMin(iStep, iSamples - i);
+        if(!writer.append(isLazy() ? this->getData(i, n) : MatrixXd(this->data.middleCols(i, n))))
+            return false;
+    }
+
+    if(!writer.flush())
+        return false;
+
+    writer.close();
+
+    return true;
+}
+
+
+//*************************************************************************************************************
+
+bool MNESourceEstimate::refresh()
+{
+    if(!isLazy())
+        return false;
+
+    if(!m_pChunkedReader->refresh())
+        return false;
+
+    update_times();
+
+    return true;
+}
+
+
+//*************************************************************************************************************
+
+MatrixXd MNESourceEstimate::getData(qint32 start, qint32 n, const VectorXi &vecRows) const
+{
+    if(isLazy()) {
+        if(vecRows.size() == 0) {
+            return m_pChunkedReader->readWindow(start, n);
+        }
+
+        return m_pChunkedReader->readWindow(start, n, vecRows);
+    }
+
+    if(start < 0 || n < 0 || start + n > this->data.cols()) {
+        qWarning() << "MNESourceEstimate::getData - Window" << start << "+" << n << "exceeds the" << this->data.cols() << "available samples";
+        return MatrixXd();
+    }
+
+    if(vecRows.size() == 0) {
+        return this->data.middleCols(start, n);
+    }
+
+    MatrixXd matData(vecRows.size(), n);
+    for(qint32 i = 0; i < vecRows.size(); ++i) {
+        matData.row(i) = this->data.row(vecRows(i)).segment(start, n);
+    }
+
+    return matData;
+}
+
+
 //*************************************************************************************************************
 
 void MNESourceEstimate::update_times()
 {
-    if(data.cols() > 0)
+    const qint32 iSamples = isLazy() ? m_pChunkedReader->samples() : data.cols();
+
+    if(iSamples > 0)
     {
-        this->times = RowVectorXf(data.cols());
+        this->times = RowVectorXf(iSamples);
         this->times[0] = this->tmin;
         for(float i = 1; i < this->times.size(); ++i)
             this->times[i] = this->times[i-1] + this->tstep;
@@ -278,6 +404,7 @@ MNESourceEstimate& MNESourceEstimate::operator= (const MNESourceEstimate &rhs)
         times = rhs.times;
         tmin = rhs.tmin;
         tstep = rhs.tstep;
+        m_pChunkedReader = rhs.m_pChunkedReader;
     }
     // to support chained assignment operators (a=b=c), always return *this
     return *this;
@@ -288,6 +415,10 @@ MNESourceEstimate& MNESourceEstimate::operator= (const MNESourceEstimate &rhs)
 
 int MNESourceEstimate::samples() const
 {
+    //Lazy estimates keep the length they had when they were opened or last refreshed
+    if(isLazy())
+        return times.size();
+
     return data.cols();
 }
 
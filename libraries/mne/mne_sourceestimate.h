@@ -42,6 +42,7 @@
 //=============================================================================================================
 
 #include "mne_global.h"
+#include "mne_chunked_stc_reader.h"
 
 #include <fs/label.h>
 
@@ -163,12 +164,68 @@ public:
     /**
     * mne_write_stc_file
     *
-    * Writes a stc file
+    * Writes a stc file. Lazy source estimates are read and written window by window.
     *
     * @param [in] p_IODevice   IO device to write the stc to.
     */
     bool write(QIODevice &p_IODevice);
 
+    //=========================================================================================================
+    /**
+    * Opens a chunked source estimate file as a lazy source estimate. Only vertices, tmin, tstep and times are
+    * set, data stays empty. The samples are read on demand by getData() and reduce(). samples() and times cover
+    * the samples which were in the file when it was opened, see refresh().
+    *
+    * @param [in] sFileName     The chunked source estimate file, see MNEChunkedStcReader.
+    * @param [out] p_stc        The lazy source estimate.
+    *
+    * @return true if successful, false otherwise
+    */
+    static bool readChunked(const QString &sFileName, MNESourceEstimate& p_stc);
+
+    //=========================================================================================================
+    /**
+    * Writes the source estimate to a chunked source estimate file, see MNEChunkedStcWriter.
+    *
+    * @param [in] sFileName     The file to write.
+    * @param [in] iChunkSize    Number of samples per chunk.
+    * @param [in] bCompress     Whether to compress each chunk.
+    *
+    * @return true if successful, false otherwise
+    */
+    bool writeChunked(const QString &sFileName, int iChunkSize = 1000, bool bCompress = false) const;
+
+    //=========================================================================================================
+    /**
+    * Returns whether the samples are read on demand from a chunked source estimate file instead of being held
+    * in data.
+    *
+    * @return true if the source estimate is lazy, false otherwise
+    */
+    inline bool isLazy() const;
+
+    //=========================================================================================================
+    /**
+    * Picks up samples which were appended to the chunked source estimate file of a lazy source estimate since it
+    * was opened or last refreshed, and updates samples() and times accordingly. Copies share the file, but keep
+    * their samples() and times until they are refreshed themselves.
+    *
+    * @return true if the source estimate is lazy and the file could be read, false otherwise
+    */
+    bool refresh();
+
+    //=========================================================================================================
+    /**
+    * Returns a time window of the data. Lazy source estimates read only the requested window from the file.
+    *
+    * @param[in] start      The first sample of the window.
+    * @param[in] n          The number of samples of the window.
+    * @param[in] vecRows    The rows to return, all rows if empty.
+    *
+    * @return the window of shape [n_rows x n], empty if the window is out of range
+    */
+    Eigen::MatrixXd getData(qint32 start, qint32 n, const Eigen::VectorXi &vecRows = Eigen::VectorXi()) const;
+
     //=========================================================================================================
     /**
     * Returns whether SourceEstimate is empty.
@@ -207,7 +264,7 @@ public:
     Eigen::VectorXi getIndicesByLabel(const QList<FSLIB::Label> &lPickedLabels, bool bIsClustered) const;
 
 public:
-    Eigen::MatrixXd data;           /**< Matrix of shape [n_dipoles x n_times] which contains the data in source space. */
+    Eigen::MatrixXd data;           /**< Matrix of shape [n_dipoles x n_times] which contains the data in source space. Empty for lazy source estimates, use getData(). */
     Eigen::VectorXi vertices;       /**< The indices of the dipoles in the different source spaces. */ //ToDo define is_clustered_result; in clustered case vertices holds the ROI idcs
     Eigen::RowVectorXf times;       /**< The time vector with n_times steps. */
     float tmin;                     /**< Time starting point. */
@@ -219,6 +276,8 @@ private:
     * Update the times attribute after changing tmin, tmax, or tstep
     */
     void update_times();
+
+    MNEChunkedStcReader::SPtr m_pChunkedReader;     /**< Source of the samples of a lazy source estimate, otherwise null. */
 };
 
 
@@ -232,6 +291,14 @@ inline bool MNESourceEstimate::isEmpty() const
     return tstep == -1;
 }
 
+
+//*************************************************************************************************************
+
+inline bool MNESourceEstimate::isLazy() const
+{
+    return !m_pChunkedReader.isNull();
+}
+
 } //NAMESPACE
 
 #endif // MNESOURCEESTIMATE_H
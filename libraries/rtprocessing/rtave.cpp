@@ -250,8 +250,13 @@ void RtAveWorker::setBaselineTo(int toSamp, int toMSec)
 
 void RtAveWorker::doAveraging(const MatrixXd& rawSegment)
 {
-    //Detect trigger
-    QList<QPair<int,double> > lDetectedTriggers = DetectTrigger::detectTriggerFlanksMax(rawSegment, m_iTriggerChIndex, 0, m_fTriggerThreshold, true);
+    //Detect trigger, flanks on the first sample of the block are found since the detector keeps the last trigger code
+    const QVector<DetectTrigger::TriggerEvent>& vecEvents = m_triggerDetector.detectTriggerEvents(rawSegment);
+
+    QList<QPair<int,double> > lDetectedTriggers;
+    for(int i = 0; i < vecEvents.size(); ++i) {
+        lDetectedTriggers.append(qMakePair(vecEvents.at(i).iSample, double(vecEvents.at(i).iValue)));
+    }
 
     //TODO: This does not permit the same trigger type twice in one data block
     for(int i = 0; i < lDetectedTriggers.size(); ++i) {
@@ -551,6 +556,10 @@ void RtAveWorker::reset()
     m_iPostStimSamples = m_iNewPostStimSamples;
     m_iTriggerChIndex = m_iNewTriggerIndex;
 
+    //The threshold is fixed to 0.5, so every sample above it rounds to a non-zero trigger code
+    m_triggerDetector.clearTriggerChannels();
+    m_triggerDetector.addTriggerChannel(m_iTriggerChIndex, m_fTriggerThreshold);
+
     //Clear all evoked data information
     m_stimEvokedSet.evoked.clear();
 
@@ -47,6 +47,8 @@
 #include <fiff/fiff_evoked_set.h>
 #include <fiff/fiff_info.h>
 
+#include <utils/detecttrigger.h>
+
 
 //*************************************************************************************************************
 //=============================================================================================================
@@ -256,6 +258,8 @@ protected:
 
     float                                           m_fTriggerThreshold;        /**< Threshold to detect trigger */
 
+    UTILSLIB::DetectTrigger                         m_triggerDetector;          /**< Detects the trigger flanks, keeps the trigger state across data blocks. */
+
     bool                                            m_bActivateThreshold;       /**< Whether to do threshold artifact reduction or not. */
 
     bool                                            m_bDoBaselineCorrection;    /**< Whether to perform baseline correction. */
@@ -45,13 +45,21 @@
 #include <fiff/fiff_cov.h>
 
 
+//*************************************************************************************************************
+//=============================================================================================================
+// STL INCLUDES
+//=============================================================================================================
+
+#include <cmath>
+#include <limits>
+
+
 //*************************************************************************************************************
 //=============================================================================================================
 // QT INCLUDES
 //=============================================================================================================
 
 #include <QDebug>
-#include <QtConcurrent>
 
 
 //*************************************************************************************************************
@@ -61,98 +69,172 @@
 
 using namespace RTPROCESSINGLIB;
 using namespace FIFFLIB;
+using namespace Eigen;
 
 
 //*************************************************************************************************************
 //=============================================================================================================
-// DEFINE MEMBER METHODS RtCovWorker
+// DEFINE MEMBER METHODS RtCovAccumulator
 //=============================================================================================================
 
-void RtCovWorker::doWork(const RtCovInput &inputData)
+RtCovAccumulator::RtCovAccumulator(double dForgettingFactor)
+: m_dForgettingFactor(1.0)
+, m_dWeight(0.0)
+, m_iNumSamples(0)
 {
-    if(this->thread()->isInterruptionRequested()) {
+    setForgettingFactor(dForgettingFactor);
+}
+
+
+//*************************************************************************************************************
+
+void RtCovAccumulator::append(const MatrixXd &matDataSegment)
+{
+    const qint32 iNumSamples = matDataSegment.cols();
+
+    if(iNumSamples == 0) {
         return;
     }
 
-    QFuture<RtCovComputeResult> result = QtConcurrent::mappedReduced(inputData.lData,
-                                                                     compute,
-                                                                     reduce);
-
-    result.waitForFinished();
+    if(m_iNumSamples > 0 && matDataSegment.rows() != m_vecMean.rows()) {
+        qWarning() << "RtCovAccumulator::append - Number of channels changed. Resetting accumulator.";
+        reset();
+    }
 
-    RtCovComputeResult finalResult = result.result();
+    // Statistics of the new block, centered with its own mean for numerical stability
+    VectorXd vecBlockMean = matDataSegment.rowwise().mean();
+    MatrixXd matCentered = matDataSegment.colwise() - vecBlockMean;
 
-    //Final computation
-    FiffCov computedCov;
-    computedCov.data = finalResult.matData;
+    if(m_iNumSamples == 0) {
+        m_vecMean = vecBlockMean;
+        m_matM2 = MatrixXd::Zero(matDataSegment.rows(), matDataSegment.rows());
+        m_matM2.selfadjointView<Lower>().rankUpdate(matCentered);
+        m_dWeight = iNumSamples;
+        m_iNumSamples = iNumSamples;
+        return;
+    }
 
-    QStringList exclude;
-    for(int i = 0; i<inputData.fiffInfo.chs.size(); i++) {
-        if(inputData.fiffInfo.chs.at(i).kind != FIFFV_MEG_CH &&
-           inputData.fiffInfo.chs.at(i).kind != FIFFV_EEG_CH) {
-            exclude << inputData.fiffInfo.chs.at(i).ch_name;
-        }
+    // Exponential forgetting of the old state (Chan et al. pairwise merge with a down-weighted first set)
+    if(m_dForgettingFactor < 1.0) {
+        double dDecay = std::pow(m_dForgettingFactor, iNumSamples);
+        m_dWeight *= dDecay;
+        m_matM2.triangularView<Lower>() *= dDecay;
     }
-    bool doProj = true;
 
-    if(inputData.iSamples > 0) {
-        finalResult.mu /= (float)inputData.iSamples;
-        computedCov.data.array() -= inputData.iSamples * (finalResult.mu * finalResult.mu.transpose()).array();
-        computedCov.data.array() /= (inputData.iSamples - 1);
+    double dWeightNew = m_dWeight + iNumSamples;
+    VectorXd vecDelta = vecBlockMean - m_vecMean;
 
-        computedCov.kind = FIFFV_MNE_NOISE_COV;
-        computedCov.diag = false;
-        computedCov.dim = computedCov.data.rows();
+    m_matM2.selfadjointView<Lower>().rankUpdate(matCentered);
+    m_matM2.selfadjointView<Lower>().rankUpdate(vecDelta, m_dWeight * iNumSamples / dWeightNew);
+    m_vecMean += vecDelta * (iNumSamples / dWeightNew);
+
+    m_dWeight = dWeightNew;
+    m_iNumSamples += iNumSamples;
+}
 
-        //ToDo do picks
-        computedCov.names = inputData.fiffInfo.ch_names;
-        computedCov.projs = inputData.fiffInfo.projs;
-        computedCov.bads = inputData.fiffInfo.bads;
-        computedCov.nfree = inputData.iSamples;
 
-        // regularize noise covariance
-        computedCov = computedCov.regularize(inputData.fiffInfo, 0.05, 0.05, 0.1, doProj, exclude);
+//*************************************************************************************************************
 
-//            qint32 samples = rawSegment.cols();
-//            VectorXf mu = rawSegment.rowwise().sum().array() / (float)samples;
+void RtCovAccumulator::reset()
+{
+    m_dWeight = 0.0;
+    m_iNumSamples = 0;
+    m_vecMean.resize(0);
+    m_matM2.resize(0,0);
+}
 
-//            MatrixXf noise_covariance = rawSegment * rawSegment.transpose();// noise_covariance == raw_covariance
-//            noise_covariance.array() -= samples * (mu * mu.transpose()).array();
-//            noise_covariance.array() /= (samples - 1);
 
-//            std::cout << "Noise Covariance:\n" << noise_covariance.block(0,0,10,10) << std::endl;
+//*************************************************************************************************************
 
-//            printf("%d raw buffer (%d x %d) generated\r\n", count, tmp.rows(), tmp.cols());
-        emit resultReady(computedCov);
-    } else {
-        qDebug() << "RtCovWorker::doWork - Number of samples equals zero. Regularization not possible. Returning without result.";
+void RtCovAccumulator::setForgettingFactor(double dForgettingFactor)
+{
+    if(dForgettingFactor <= 0.0 || dForgettingFactor > 1.0) {
+        qWarning() << "RtCovAccumulator::setForgettingFactor - Forgetting factor" << dForgettingFactor << "out of range (0,1]. Clamping.";
     }
 
+    m_dForgettingFactor = qBound(std::numeric_limits<double>::epsilon(), dForgettingFactor, 1.0);
 }
 
 
 //*************************************************************************************************************
 
-RtCovComputeResult RtCovWorker::compute(const MatrixXd &matData)
+MatrixXd RtCovAccumulator::getCovariance() const
 {
-    RtCovComputeResult result;
-    result.mu = matData.rowwise().sum();
-    result.matData = matData * matData.transpose();
-    return result;
+    if(m_dWeight <= 1.0) {
+        return MatrixXd();
+    }
+
+    MatrixXd matCov = m_matM2.selfadjointView<Lower>();
+    matCov /= (m_dWeight - 1.0);
+
+    return matCov;
 }
 
 
 //*************************************************************************************************************
 
-void RtCovWorker::reduce(RtCovComputeResult& finalResult, const RtCovComputeResult &tempResult)
+FiffCov RtCovAccumulator::getFiffCov(const FiffInfo &fiffInfo) const
 {
-    if(finalResult.matData.size() == 0 || finalResult.mu.size() == 0) {
-        finalResult.mu = tempResult.mu;
-        finalResult.matData = tempResult.matData;
-    } else {
-        finalResult.mu += tempResult.mu;
-        finalResult.matData += tempResult.matData;
+    FiffCov computedCov;
+    computedCov.data = getCovariance();
+
+    computedCov.kind = FIFFV_MNE_NOISE_COV;
+    computedCov.diag = false;
+    computedCov.dim = computedCov.data.rows();
+
+    //ToDo do picks
+    computedCov.names = fiffInfo.ch_names;
+    computedCov.projs = fiffInfo.projs;
+    computedCov.bads = fiffInfo.bads;
+    computedCov.nfree = static_cast<fiff_int_t>(m_dWeight);
+
+    return computedCov;
+}
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE MEMBER METHODS RtCovWorker
+//=============================================================================================================
+
+void RtCovWorker::doWork(const RtCovInput &inputData)
+{
+    if(this->thread()->isInterruptionRequested()) {
+        return;
+    }
+
+    if(inputData.iSamples <= 1 || inputData.matCov.size() == 0) {
+        qDebug() << "RtCovWorker::doWork - Number of samples too small. Regularization not possible. Returning without result.";
+        return;
+    }
+
+    //Final computation
+    FiffCov computedCov;
+    computedCov.data = inputData.matCov;
+
+    QStringList exclude;
+    for(int i = 0; i<inputData.fiffInfo.chs.size(); i++) {
+        if(inputData.fiffInfo.chs.at(i).kind != FIFFV_MEG_CH &&
+           inputData.fiffInfo.chs.at(i).kind != FIFFV_EEG_CH) {
+            exclude << inputData.fiffInfo.chs.at(i).ch_name;
+        }
     }
+    bool doProj = true;
+
+    computedCov.kind = FIFFV_MNE_NOISE_COV;
+    computedCov.diag = false;
+    computedCov.dim = computedCov.data.rows();
+
+    //ToDo do picks
+    computedCov.names = inputData.fiffInfo.ch_names;
+    computedCov.projs = inputData.fiffInfo.projs;
+    computedCov.bads = inputData.fiffInfo.bads;
+    computedCov.nfree = inputData.iSamples;
+
+    // regularize noise covariance
+    computedCov = computedCov.regularize(inputData.fiffInfo, 0.05, 0.05, 0.1, doProj, exclude);
+
+    emit resultReady(computedCov);
 }
 
 
@@ -203,23 +285,47 @@ void RtCov::setSamples(qint32 samples)
 }
 
 
+//*************************************************************************************************************
+
+void RtCov::setForgettingFactor(double dForgettingFactor)
+{
+    m_covAccumulator.setForgettingFactor(dForgettingFactor);
+}
+
+
 //*************************************************************************************************************
 
 void RtCov::append(const MatrixXd &matDataSegment)
 {
-    m_lData.append(matDataSegment);
+    m_covAccumulator.append(matDataSegment);
     m_iSamples += matDataSegment.cols();
 
     if(m_iSamples >= m_iMaxSamples) {
-        RtCovInput inputData;
-        inputData.lData = m_lData;
-        inputData.fiffInfo = FiffInfo(*m_pFiffInfo);
-        inputData.iSamples = m_iSamples;
+        requestCovariance();
+    }
+}
+
+
+//*************************************************************************************************************
+
+void RtCov::requestCovariance()
+{
+    if(m_covAccumulator.getEffectiveSamples() <= 1.0) {
+        return;
+    }
+
+    RtCovInput inputData;
+    inputData.matCov = m_covAccumulator.getCovariance();
+    inputData.fiffInfo = FiffInfo(*m_pFiffInfo);
+    inputData.iSamples = static_cast<int>(m_covAccumulator.getEffectiveSamples());
+
+    emit operate(inputData);
 
-        emit operate(inputData);
+    m_iSamples = 0;
 
-        m_iSamples = 0;
-        m_lData.clear();
+    // Without forgetting consecutive estimates are computed from disjoint chunks
+    if(m_covAccumulator.getForgettingFactor() >= 1.0) {
+        m_covAccumulator.reset();
     }
 }
 
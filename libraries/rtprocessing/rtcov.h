@@ -87,13 +87,8 @@ namespace RTPROCESSINGLIB
 // RTPROCESSINGLIB FORWARD DECLARATIONS
 //=============================================================================================================
 
-struct RtCovComputeResult {
-    Eigen::VectorXd mu;
-    Eigen::MatrixXd matData;
-};
-
 struct RtCovInput {
-    QList<Eigen::MatrixXd>      lData;
+    Eigen::MatrixXd             matCov;
     FIFFLIB::FiffInfo           fiffInfo;
     int                         iSamples;
 };
@@ -101,42 +96,130 @@ struct RtCovInput {
 
 //=============================================================================================================
 /**
-* Real-time covariance worker.
+* Streaming covariance accumulator. Incoming blocks are merged into a running mean and a running sum of
+* centered outer products (Welford/Chan update), so the covariance can be read out at any time without keeping
+* or re-touching old samples. An optional exponential forgetting factor (per sample) turns the estimate into an
+* adaptive noise covariance. Within a block all samples are weighted equally, the forgetting is applied to the
+* previously accumulated state.
 *
-* @brief Real-time covariance worker.
+* @brief Streaming covariance accumulator.
 */
-class RTPROCESINGSHARED_EXPORT RtCovWorker : public QObject
+class RTPROCESINGSHARED_EXPORT RtCovAccumulator
 {
-    Q_OBJECT
 
 public:
+    typedef QSharedPointer<RtCovAccumulator> SPtr;             /**< Shared pointer type for RtCovAccumulator. */
+    typedef QSharedPointer<const RtCovAccumulator> ConstSPtr;  /**< Const shared pointer type for RtCovAccumulator. */
+
     //=========================================================================================================
     /**
-    * Perform actual covariance estimation.
+    * Constructs the accumulator.
     *
-    * @param[in] inputData  Data to estimate the covariance from.
+    * @param[in] dForgettingFactor  Per sample forgetting factor in (0,1]. 1.0 means no forgetting (default).
     */
-    void doWork(const RtCovInput &inputData);
+    explicit RtCovAccumulator(double dForgettingFactor = 1.0);
+
+    //=========================================================================================================
+    /**
+    * Merges a new data block (channels x samples) into the running estimate.
+    *
+    * @param[in] matDataSegment     The data block.
+    */
+    void append(const Eigen::MatrixXd &matDataSegment);
+
+    //=========================================================================================================
+    /**
+    * Discards all accumulated samples.
+    */
+    void reset();
 
-protected:
     //=========================================================================================================
     /**
-    * Computer multiplication with transposed.
+    * Sets the per sample forgetting factor. Values outside (0,1] are clamped.
     *
-    * @param[in] matData  Data to self multiply with.
+    * @param[in] dForgettingFactor  The forgetting factor.
+    */
+    void setForgettingFactor(double dForgettingFactor);
+
+    //=========================================================================================================
+    /**
+    * Returns the per sample forgetting factor.
     *
-    * @return   The multiplication result.
+    * @return The forgetting factor.
     */
-    static RtCovComputeResult compute(const Eigen::MatrixXd &matData);
+    inline double getForgettingFactor() const;
 
     //=========================================================================================================
     /**
-    * Computer multiplication with transposed.
+    * Returns the number of samples appended since the last reset.
     *
-    * @param[out]   finalResult     The final covariance estimation.
-    * @param[in]    tempResult      The intermediate result from the compute function
+    * @return The number of appended samples.
     */
-    static void reduce(RtCovComputeResult& finalResult, const RtCovComputeResult &tempResult);
+    inline qint64 getNumSamples() const;
+
+    //=========================================================================================================
+    /**
+    * Returns the effective (forgetting weighted) number of samples. Equals getNumSamples() without forgetting.
+    *
+    * @return The effective number of samples.
+    */
+    inline double getEffectiveSamples() const;
+
+    //=========================================================================================================
+    /**
+    * Returns the running mean.
+    *
+    * @return The running mean (empty if no data was appended).
+    */
+    inline const Eigen::VectorXd& getMean() const;
+
+    //=========================================================================================================
+    /**
+    * Returns the current (unbiased) covariance estimate. Returns an empty matrix if less than two effective
+    * samples were accumulated.
+    *
+    * @return The covariance matrix.
+    */
+    Eigen::MatrixXd getCovariance() const;
+
+    //=========================================================================================================
+    /**
+    * Returns the current estimate as non-regularized noise covariance using the channel names, projectors and
+    * bads of the given measurement info.
+    *
+    * @param[in] fiffInfo   The measurement info associated with the data.
+    *
+    * @return The covariance.
+    */
+    FIFFLIB::FiffCov getFiffCov(const FIFFLIB::FiffInfo &fiffInfo) const;
+
+private:
+    double              m_dForgettingFactor;    /**< Per sample forgetting factor. */
+    double              m_dWeight;              /**< Effective (weighted) number of samples. */
+    qint64              m_iNumSamples;          /**< Number of appended samples since the last reset. */
+    Eigen::VectorXd     m_vecMean;              /**< Running mean. */
+    Eigen::MatrixXd     m_matM2;                /**< Running sum of centered outer products, lower triangle only. */
+};
+
+
+//=============================================================================================================
+/**
+* Real-time covariance worker.
+*
+* @brief Real-time covariance worker.
+*/
+class RTPROCESINGSHARED_EXPORT RtCovWorker : public QObject
+{
+    Q_OBJECT
+
+public:
+    //=========================================================================================================
+    /**
+    * Finalizes and regularizes the accumulated covariance estimate.
+    *
+    * @param[in] inputData  The accumulated covariance estimate.
+    */
+    void doWork(const RtCovInput &inputData);
 
 signals:
     //=========================================================================================================
@@ -189,6 +272,22 @@ public:
     */
     void append(const Eigen::MatrixXd &matDataSegment);
 
+    //=========================================================================================================
+    /**
+    * Sets the per sample forgetting factor. With 1.0 (default) the accumulator is reset after each estimate,
+    * i.e. consecutive estimates are based on disjoint chunks of iMaxSamples. With values below 1.0 the
+    * accumulator keeps running and an adaptive, exponentially weighted estimate is emitted every iMaxSamples.
+    *
+    * @param[in] dForgettingFactor    The forgetting factor in (0,1].
+    */
+    void setForgettingFactor(double dForgettingFactor);
+
+    //=========================================================================================================
+    /**
+    * Emits the covariance of the currently accumulated samples immediately, without waiting for iMaxSamples.
+    */
+    void requestCovariance();
+
     //=========================================================================================================
     /**
     * Set number of estimation samples
@@ -220,9 +319,9 @@ protected:
 
     qint32                  m_iMaxSamples;              /**< Maximal amount of samples received, before covariance is estimated.*/
     qint32                  m_iNewMaxSamples;           /**< New maximal amount of samples received, before covariance is estimated.*/
-    int                     m_iSamples;                 /**< The number of stored samples. */
+    int                     m_iSamples;                 /**< The number of samples received since the last estimate. */
 
-    QList<Eigen::MatrixXd>  m_lData;                    /**< The stored data blocks. */
+    RtCovAccumulator        m_covAccumulator;           /**< The streaming covariance accumulator. */
 
     QSharedPointer<FIFFLIB::FiffInfo>  m_pFiffInfo;     /**< Holds the fiff measurement information. */
 
@@ -237,9 +336,9 @@ signals:
 
     //=========================================================================================================
     /**
-    * Emit this signal whenver the worker should process a new batch of stored data blocks.
+    * Emit this signal whenver the worker should regularize a new covariance estimate.
     *
-    * @param[in] inputData  The new batch of stored data.
+    * @param[in] inputData  The new covariance estimate.
     */
     void operate(const RtCovInput &inputData);
 
@@ -250,6 +349,35 @@ signals:
 // INLINE DEFINITIONS
 //=============================================================================================================
 
+inline double RtCovAccumulator::getForgettingFactor() const
+{
+    return m_dForgettingFactor;
+}
+
+
+//*************************************************************************************************************
+
+inline qint64 RtCovAccumulator::getNumSamples() const
+{
+    return m_iNumSamples;
+}
+
+
+//*************************************************************************************************************
+
+inline double RtCovAccumulator::getEffectiveSamples() const
+{
+    return m_dWeight;
+}
+
+
+//*************************************************************************************************************
+
+inline const Eigen::VectorXd& RtCovAccumulator::getMean() const
+{
+    return m_vecMean;
+}
+
 } // NAMESPACE
 
 #endif // RTCOV_H
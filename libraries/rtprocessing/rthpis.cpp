@@ -45,6 +45,7 @@
 #include "rthpis.h"
 
 #include <inverse/hpiFit/hpifit.h>
+#include <inverse/hpiFit/hpilockin.h>
 #include <fiff/fiff_info.h>
 
 
@@ -79,6 +80,14 @@ using namespace INVERSELIB;
 // DEFINE MEMBER METHODS RtHPISWorker
 //=============================================================================================================
 
+RtHPISWorker::RtHPISWorker()
+: m_iSamplesSinceFit(0)
+{
+}
+
+
+//*************************************************************************************************************
+
 void RtHPISWorker::doWork(const Eigen::MatrixXd& matData,
                           const Eigen::MatrixXd& matProjectors,
                           const QVector<int>& vFreqs,
@@ -105,6 +114,82 @@ void RtHPISWorker::doWork(const Eigen::MatrixXd& matData,
 }
 
 
+//*************************************************************************************************************
+
+void RtHPISWorker::doContinuousWork(const Eigen::MatrixXd& matData,
+                                    const Eigen::MatrixXd& matProjectors,
+                                    const QVector<int>& vFreqs,
+                                    QSharedPointer<FIFFLIB::FiffInfo> pFiffInfo,
+                                    int iWindowSize,
+                                    int iFitInterval,
+                                    double dMaxFitError)
+{
+    if(this->thread()->isInterruptionRequested()) {
+        return;
+    }
+
+    QVector<int> vChannels = HPIFit::getHPIChannels(pFiffInfo);
+
+    //(Re)create the lock-in if the coils, the channels or the window changed. The warm start is dropped as well.
+    if(!m_pLockIn
+            || m_pLockIn->getFrequencies() != vFreqs
+            || m_pLockIn->getChannels() != vChannels
+            || m_pLockIn->getWindowSize() != iWindowSize) {
+        m_pLockIn = HPILockIn::SPtr(new HPILockIn(vFreqs, pFiffInfo->sfreq, vChannels, iWindowSize));
+        m_matCoilPos.resize(0,3);
+        m_iSamplesSinceFit = 0;
+    }
+
+    if(iFitInterval <= 0) {
+        iFitInterval = iWindowSize;
+    }
+
+    if(m_iSamplesSinceFit >= iFitInterval) {
+        m_iSamplesSinceFit = 0;
+    }
+
+    int iPos = 0;
+
+    while(iPos < matData.cols()) {
+        int iNumSamples = qMin(int(matData.cols()) - iPos, iFitInterval - m_iSamplesSinceFit);
+
+        m_pLockIn->append(matData, iPos, iNumSamples);
+        iPos += iNumSamples;
+        m_iSamplesSinceFit += iNumSamples;
+
+        if(m_iSamplesSinceFit < iFitInterval) {
+            continue;
+        }
+
+        m_iSamplesSinceFit = 0;
+
+        //Wait until the demodulation window is filled
+        if(!m_pLockIn->isReady()) {
+            continue;
+        }
+
+        if(this->thread()->isInterruptionRequested()) {
+            return;
+        }
+
+        FittingResult fitResult;
+        fitResult.devHeadTrans.from = 1;
+        fitResult.devHeadTrans.to = 4;
+
+        HPIFit::fitHPIAmplitudes(m_pLockIn->getAmplitudes(),
+                                 matProjectors,
+                                 fitResult.devHeadTrans,
+                                 fitResult.errorDistances,
+                                 fitResult.fittedCoils,
+                                 pFiffInfo,
+                                 m_matCoilPos,
+                                 dMaxFitError);
+
+        emit resultReady(fitResult);
+    }
+}
+
+
 //*************************************************************************************************************
 //=============================================================================================================
 // DEFINE MEMBER METHODS RtHPIS
@@ -113,6 +198,10 @@ void RtHPISWorker::doWork(const Eigen::MatrixXd& matData,
 RtHPIS::RtHPIS(FiffInfo::SPtr p_pFiffInfo, QObject *parent)
 : QObject(parent)
 , m_pFiffInfo(p_pFiffInfo)
+, m_bContinuous(false)
+, m_iWindowSize(-1)
+, m_iFitInterval(-1)
+, m_dMaxFitError(0.01)
 {
     qRegisterMetaType<RTPROCESSINGLIB::FittingResult>("RTPROCESSINGLIB::FittingResult");
     qRegisterMetaType<QVector<int> >("QVector<int>");
@@ -127,6 +216,9 @@ RtHPIS::RtHPIS(FiffInfo::SPtr p_pFiffInfo, QObject *parent)
     connect(this, &RtHPIS::operate,
             worker, &RtHPISWorker::doWork);
 
+    connect(this, &RtHPIS::operateContinuous,
+            worker, &RtHPISWorker::doContinuousWork);
+
     connect(worker, &RtHPISWorker::resultReady,
             this, &RtHPIS::handleResults);
 
@@ -145,6 +237,27 @@ RtHPIS::~RtHPIS()
 //*************************************************************************************************************
 
 void RtHPIS::append(const MatrixXd &data)
+{
+    if(m_bContinuous) {
+        emit operateContinuous(data,
+                               m_matProjectors,
+                               m_vCoilFreqs,
+                               m_pFiffInfo,
+                               m_iWindowSize,
+                               m_iFitInterval,
+                               m_dMaxFitError);
+    } else {
+        emit operate(data,
+                     m_matProjectors,
+                     m_vCoilFreqs,
+                     m_pFiffInfo);
+    }
+}
+
+
+//*************************************************************************************************************
+
+void RtHPIS::fitSingle(const MatrixXd &data)
 {
     emit operate(data,
                  m_matProjectors,
@@ -169,6 +282,23 @@ void RtHPIS::setProjectionMatrix(const Eigen::MatrixXd& matProjectors)
 }
 
 
+//*************************************************************************************************************
+
+void RtHPIS::setContinuousFitting(bool bContinuous,
+                                  int iWindowSize,
+                                  int iFitInterval,
+                                  double dMaxFitError)
+{
+    m_bContinuous = bContinuous;
+    m_dMaxFitError = dMaxFitError;
+
+    double dSFreq = m_pFiffInfo ? m_pFiffInfo->sfreq : 1000.0;
+
+    m_iWindowSize = iWindowSize > 0 ? iWindowSize : qRound(0.2 * dSFreq);
+    m_iFitInterval = iFitInterval > 0 ? iFitInterval : qRound(dSFreq / 20.0);
+}
+
+
 //*************************************************************************************************************
 
 void RtHPIS::handleResults(const RTPROCESSINGLIB::FittingResult& fitResult)
@@ -192,6 +322,9 @@ void RtHPIS::restart()
     connect(this, &RtHPIS::operate,
             worker, &RtHPISWorker::doWork);
 
+    connect(this, &RtHPIS::operateContinuous,
+            worker, &RtHPISWorker::doContinuousWork);
+
     connect(worker, &RtHPISWorker::resultReady,
             this, &RtHPIS::handleResults);
 
@@ -80,6 +80,10 @@ namespace FIFFLIB{
     class FiffInfo;
 }
 
+namespace INVERSELIB{
+    class HPILockIn;
+}
+
 
 //*************************************************************************************************************
 //=============================================================================================================
@@ -114,6 +118,12 @@ class RTPROCESINGSHARED_EXPORT RtHPISWorker : public QObject
     Q_OBJECT
 
 public:
+    //=========================================================================================================
+    /**
+    * Constructs the real-time HPI worker.
+    */
+    RtHPISWorker();
+
     //=========================================================================================================
     /**
     * Perform one single HPI fit.
@@ -128,6 +138,31 @@ public:
                 const QVector<int>& vFreqs,
                 QSharedPointer<FIFFLIB::FiffInfo> pFiffInfo);
 
+    //=========================================================================================================
+    /**
+    * Feeds the data into the lock-in demodulation and performs a warm-started HPI fit every iFitInterval samples.
+    *
+    * @param[in] matData            Data to estimate the HPI positions from
+    * @param[in] matProjectors      The projectors to apply. Bad channels are still included.
+    * @param[in] vFreqs             The frequencies for each coil.
+    * @param[in] pFiffInfo          Associated Fiff Information.
+    * @param[in] iWindowSize        The length of the demodulation window in samples.
+    * @param[in] iFitInterval       The number of samples between two fits.
+    * @param[in] dMaxFitError       The maximum mean fit error in m. Worse fits do not warm start the next fit.
+    */
+    void doContinuousWork(const Eigen::MatrixXd& matData,
+                          const Eigen::MatrixXd& matProjectors,
+                          const QVector<int>& vFreqs,
+                          QSharedPointer<FIFFLIB::FiffInfo> pFiffInfo,
+                          int iWindowSize,
+                          int iFitInterval,
+                          double dMaxFitError);
+
+protected:
+    QSharedPointer<INVERSELIB::HPILockIn>   m_pLockIn;              /**< The lock-in demodulation of the continuous mode. */
+    Eigen::MatrixXd                         m_matCoilPos;           /**< The coil positions of the last fit, used as warm start. */
+    int                                     m_iSamplesSinceFit;     /**< The number of samples demodulated since the last fit. */
+
 signals:
     void resultReady(const RTPROCESSINGLIB::FittingResult &fitResult);
 };
@@ -170,6 +205,15 @@ public:
     */
     void append(const Eigen::MatrixXd &data);
 
+    //=========================================================================================================
+    /**
+    * Fits the HPI positions once to the given data block. In contrast to append() the block is never fed into
+    * the continuous mode's demodulation, so it can be used while the head position is tracked continuously.
+    *
+    * @param[in] data  Data to estimate the HPI positions from
+    */
+    void fitSingle(const Eigen::MatrixXd &data);
+
     //=========================================================================================================
     /**
     * Set the coil frequencies.
@@ -186,6 +230,23 @@ public:
     */
     void setProjectionMatrix(const Eigen::MatrixXd& matProjectors);
 
+    //=========================================================================================================
+    /**
+    * Switches between block wise fitting and continuous head position tracking. In continuous mode the incoming
+    * data is demodulated sample by sample and the coils are refitted every iFitInterval samples, starting from
+    * the previously fitted positions.
+    *
+    * @param[in] bContinuous    Whether to track the head position continuously.
+    * @param[in] iWindowSize    The length of the demodulation window in samples. -1 uses 200 ms.
+    * @param[in] iFitInterval   The number of samples between two fits. -1 fits with 20 Hz.
+    * @param[in] dMaxFitError   The maximum mean fit error in m. The next fit starts from the seed points again
+    *                           after a fit exceeded it.
+    */
+    void setContinuousFitting(bool bContinuous,
+                              int iWindowSize = -1,
+                              int iFitInterval = -1,
+                              double dMaxFitError = 0.01);
+
     //=========================================================================================================
     /**
     * Restarts the thread by interrupting its computation queue, quitting, waiting and then starting it again.
@@ -210,6 +271,10 @@ protected:
     QThread             m_workerThread;         /**< The worker thread. */
     QVector<int>        m_vCoilFreqs;           /**< Vector contains the HPI coil frequencies. */
     Eigen::MatrixXd     m_matProjectors;        /**< Holds the matrix with the SSP and compensator projectors.*/
+    bool                m_bContinuous;          /**< Whether the head position is tracked continuously. */
+    int                 m_iWindowSize;          /**< The demodulation window in samples of the continuous mode. */
+    int                 m_iFitInterval;         /**< The number of samples between two fits of the continuous mode. */
+    double              m_dMaxFitError;         /**< The maximum mean fit error in m of the continuous mode. */
 
 signals:
     void newFittingResultAvailable(const RTPROCESSINGLIB::FittingResult &fitResult);
@@ -217,6 +282,13 @@ signals:
                  const Eigen::MatrixXd& matProjectors,
                  const QVector<int>& vFreqs,
                  QSharedPointer<FIFFLIB::FiffInfo> pFiffInfo);
+    void operateContinuous(const Eigen::MatrixXd& matData,
+                           const Eigen::MatrixXd& matProjectors,
+                           const QVector<int>& vFreqs,
+                           QSharedPointer<FIFFLIB::FiffInfo> pFiffInfo,
+                           int iWindowSize,
+                           int iFitInterval,
+                           double dMaxFitError);
 };
 
 //*************************************************************************************************************
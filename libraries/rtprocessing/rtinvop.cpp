@@ -61,6 +61,7 @@
 //=============================================================================================================
 
 #include <Eigen/Core>
+#include <Eigen/Eigenvalues>
 
 
 //*************************************************************************************************************
@@ -71,6 +72,7 @@
 using namespace RTPROCESSINGLIB;
 using namespace Eigen;
 using namespace MNELIB;
+using namespace FIFFLIB;
 
 
 //*************************************************************************************************************
@@ -84,19 +86,179 @@ void RtInvOpWorker::doWork(const RtInvOpInput &inputData)
         return;
     }
 
+    MNEInverseOperator invOpMeg;
+
+    if(updateInverseOperator(inputData, invOpMeg)) {
+        m_invOpLast = invOpMeg;
+        emit resultReady(invOpMeg);
+        return;
+    }
+
     // Restrict forward solution as necessary for MEG
     MNEForwardSolution forwardMeg = inputData.pFwd->pick_types(true, false);
 
-    MNEInverseOperator invOpMeg(*inputData.pFiffInfo.data(),
-                                forwardMeg,
-                                inputData.noiseCov,
-                                0.2f,
-                                0.8f);
+    invOpMeg = MNEInverseOperator(*inputData.pFiffInfo.data(),
+                                  forwardMeg,
+                                  inputData.noiseCov,
+                                  0.2f,
+                                  0.8f);
+
+    cacheFactors(inputData, forwardMeg, invOpMeg);
 
     emit resultReady(invOpMeg);
 }
 
 
+//*************************************************************************************************************
+
+void RtInvOpWorker::cacheFactors(const RtInvOpInput &inputData,
+                                 const MNEForwardSolution &forwardMeg,
+                                 const MNEInverseOperator &invOp)
+{
+    m_invOpLast = invOp;
+    m_pFwdCached.clear();
+    m_lChNamesCached.clear();
+    m_setFwdChNames.clear();
+    m_matGainWeighted.resize(0,0);
+    m_vecSourceCov.resize(0);
+
+    if(!invOp.source_cov || !invOp.eigen_fields || invOp.source_cov->data.rows() != forwardMeg.sol->data.cols()) {
+        return;
+    }
+
+    // Same channel selection and gain as used by make_inverse_operator
+    FiffInfo gainInfo;
+    MatrixXd matGain, matWhitener;
+    FiffCov noiseCovPrepared;
+    qint32 iNumNonZero;
+    forwardMeg.prepare_forward(*inputData.pFiffInfo, inputData.noiseCov, false, gainInfo, matGain, noiseCovPrepared, matWhitener, iNumNonZero);
+
+    if(gainInfo.ch_names != invOp.eigen_fields->col_names) {
+        return;
+    }
+
+    // The source covariance is only defined up to the scaling which is recomputed for each noise covariance
+    m_vecSourceCov = invOp.source_cov->data.col(0);
+    m_matGainWeighted = matGain * m_vecSourceCov.cwiseSqrt().asDiagonal();
+    m_lChNamesCached = gainInfo.ch_names;
+    m_pFwdCached = inputData.pFwd;
+
+    for(qint32 i = 0; i < forwardMeg.info.chs.size(); ++i) {
+        m_setFwdChNames.insert(forwardMeg.info.chs[i].ch_name);
+    }
+}
+
+
+//*************************************************************************************************************
+
+bool RtInvOpWorker::updateInverseOperator(const RtInvOpInput &inputData,
+                                          MNEInverseOperator &invOp)
+{
+    if(!m_pFwdCached || m_pFwdCached != inputData.pFwd || m_lChNamesCached.isEmpty()) {
+        return false;
+    }
+
+    // Select the channels like MNEForwardSolution::prepare_forward, the selection has to match the cached gain matrix
+    const FiffInfo &info = *inputData.pFiffInfo;
+    QStringList lChNames;
+    for(qint32 i = 0; i < info.chs.size(); ++i) {
+        const QString &sChName = info.chs[i].ch_name;
+        if(!info.bads.contains(sChName)
+           && !inputData.noiseCov.bads.contains(sChName)
+           && inputData.noiseCov.names.contains(sChName)
+           && m_setFwdChNames.contains(sChName)) {
+            lChNames << sChName;
+        }
+    }
+
+    if(lChNames != m_lChNamesCached) {
+        qDebug() << "RtInvOpWorker::updateInverseOperator - Channel selection changed. Recomputing full inverse operator.";
+        return false;
+    }
+
+    //
+    // Whitener (non pca, see MNEForwardSolution::prepare_forward)
+    //
+    FiffCov noiseCovPrepared = inputData.noiseCov.prepare_noise_cov(info, lChNames);
+
+    qint32 iNumChan = lChNames.size();
+    qint32 iNumNonZero = 0;
+    MatrixXd matWhitener = MatrixXd::Zero(iNumChan, iNumChan);
+    for(qint32 i = 0; i < noiseCovPrepared.eig.rows(); ++i) {
+        if(noiseCovPrepared.eig[i] > 0) {
+            matWhitener(i,i) = 1.0 / sqrt(noiseCovPrepared.eig(i));
+            ++iNumNonZero;
+        }
+    }
+
+    if(iNumNonZero == 0) {
+        qWarning() << "RtInvOpWorker::updateInverseOperator - Noise covariance has rank zero.";
+        return false;
+    }
+
+    matWhitener *= noiseCovPrepared.eigvec;
+
+    //
+    // Whiten and scale the weighted gain so that trace(G*R*G') equals the number of non zero channels
+    //
+    MatrixXd matGainWhitened = matWhitener * m_matGainWeighted;
+    double dTraceGRGT = matGainWhitened.squaredNorm();
+    double dScalingSourceCov = (double)iNumNonZero / dTraceGRGT;
+    matGainWhitened *= sqrt(dScalingSourceCov);
+
+    //
+    // Truncated decomposition G = U*S*V' from the Gram matrix G*G' = U*S^2*U'
+    //
+    qint32 iRank = iNumNonZero;
+    if(inputData.iRank > 0) {
+        iRank = std::min(iRank, inputData.iRank);
+    }
+
+    MatrixXd matGram = MatrixXd::Zero(iNumChan, iNumChan);
+    matGram.selfadjointView<Lower>().rankUpdate(matGainWhitened);
+
+    SelfAdjointEigenSolver<MatrixXd> eigSolver(matGram.selfadjointView<Lower>());
+    if(eigSolver.info() != Success) {
+        qWarning() << "RtInvOpWorker::updateInverseOperator - Eigen decomposition failed.";
+        return false;
+    }
+
+    // Eigenvalues are sorted ascending, keep the iRank largest in descending order
+    VectorXd vecSing = eigSolver.eigenvalues().tail(iRank).reverse().cwiseMax(0.0).cwiseSqrt();
+    MatrixXd matU = eigSolver.eigenvectors().rightCols(iRank).rowwise().reverse();
+
+    VectorXd vecSingInv = VectorXd::Zero(iRank);
+    for(qint32 i = 0; i < iRank; ++i) {
+        if(vecSing[i] > 0) {
+            vecSingInv[i] = 1.0 / vecSing[i];
+        }
+    }
+    MatrixXd matV = (matGainWhitened.transpose() * matU) * vecSingInv.asDiagonal();
+
+    //
+    // Assemble the updated operator
+    //
+    invOp = m_invOpLast;
+    invOp.sing = vecSing;
+    invOp.eigen_fields = FiffNamedMatrix::SDPtr(new FiffNamedMatrix(matU.cols(),
+                                                                     matU.rows(),
+                                                                     defaultQStringList,
+                                                                     lChNames,
+                                                                     matU.transpose()));
+    invOp.eigen_leads = FiffNamedMatrix::SDPtr(new FiffNamedMatrix(matV.rows(),
+                                                                    matV.cols(),
+                                                                    defaultQStringList,
+                                                                    defaultQStringList,
+                                                                    matV));
+    invOp.source_cov->data.col(0) = m_vecSourceCov * dScalingSourceCov;
+    invOp.noise_cov = FiffCov::SDPtr(new FiffCov(noiseCovPrepared));
+    invOp.projs = info.projs;
+    invOp.info.bads = info.bads;
+
+    return true;
+}
+
+
 //*************************************************************************************************************
 //=============================================================================================================
 // DEFINE MEMBER METHODS RtInvOp
@@ -108,6 +270,7 @@ RtInvOp::RtInvOp(FiffInfo::SPtr &p_pFiffInfo,
 : QObject(parent)
 , m_pFiffInfo(p_pFiffInfo)
 , m_pFwd(p_pFwd)
+, m_iRank(-1)
 {
     RtInvOpWorker *worker = new RtInvOpWorker;
     worker->moveToThread(&m_workerThread);
@@ -143,11 +306,20 @@ void RtInvOp::append(const FIFFLIB::FiffCov &noiseCov)
     inputData.noiseCov = noiseCov;
     inputData.pFiffInfo = m_pFiffInfo;
     inputData.pFwd = m_pFwd;
+    inputData.iRank = m_iRank;
 
     emit operate(inputData);
 }
 
 
+//*************************************************************************************************************
+
+void RtInvOp::setRank(qint32 iRank)
+{
+    m_iRank = iRank;
+}
+
+
 //*************************************************************************************************************
 
 void RtInvOp::handleResults(const MNELIB::MNEInverseOperator& invOp)
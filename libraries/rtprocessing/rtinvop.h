@@ -45,6 +45,8 @@
 
 #include <fiff/fiff_cov.h>
 
+#include <mne/mne_inverse_operator.h>
+
 
 //*************************************************************************************************************
 //=============================================================================================================
@@ -53,6 +55,16 @@
 
 #include <QThread>
 #include <QSharedPointer>
+#include <QStringList>
+#include <QSet>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// Eigen INCLUDES
+//=============================================================================================================
+
+#include <Eigen/Core>
 
 
 //*************************************************************************************************************
@@ -66,7 +78,6 @@ namespace FIFFLIB {
 
 namespace MNELIB {
     class MNEForwardSolution;
-    class MNEInverseOperator;
 }
 
 
@@ -88,6 +99,7 @@ struct RtInvOpInput {
     QSharedPointer<FIFFLIB::FiffInfo>           pFiffInfo;
     QSharedPointer<MNELIB::MNEForwardSolution>  pFwd;
     FIFFLIB::FiffCov                            noiseCov;
+    qint32                                      iRank;          /**< Truncation rank of the decomposition in the update path, -1 for the full noise rank. */
 };
 
 
@@ -110,6 +122,42 @@ public:
     */
     void doWork(const RtInvOpInput &inputData);
 
+protected:
+    //=========================================================================================================
+    /**
+    * Stores the noise independent factors (channel selection, gain matrix weighted with the source standard
+    * deviations) of a freshly computed inverse operator, so that subsequent noise covariances can take the
+    * update path.
+    *
+    * @param[in] inputData      The data the inverse operator was computed from.
+    * @param[in] forwardMeg     The MEG restricted forward solution.
+    * @param[in] invOp          The inverse operator computed with make_inverse_operator.
+    */
+    void cacheFactors(const RtInvOpInput &inputData,
+                      const MNELIB::MNEForwardSolution &forwardMeg,
+                      const MNELIB::MNEInverseOperator &invOp);
+
+    //=========================================================================================================
+    /**
+    * Updates the last inverse operator for a new noise covariance. Only the whitener, the source covariance
+    * scaling and a truncated decomposition of the whitened gain matrix are recomputed. The decomposition is
+    * obtained from the eigen decomposition of the small channel x channel Gram matrix of the whitened gain.
+    *
+    * @param[in] inputData      The data holding the new noise covariance.
+    * @param[out] invOp         The updated inverse operator.
+    *
+    * @return Returns false if the cached factors can not be used (e.g. a channel was marked bad or good again).
+    */
+    bool updateInverseOperator(const RtInvOpInput &inputData,
+                               MNELIB::MNEInverseOperator &invOp);
+
+    MNELIB::MNEInverseOperator                  m_invOpLast;            /**< The last computed inverse operator. */
+    QSharedPointer<MNELIB::MNEForwardSolution>  m_pFwdCached;           /**< The forward solution the factors were computed from. */
+    QStringList                                 m_lChNamesCached;       /**< The channel names the factors were computed for. */
+    QSet<QString>                               m_setFwdChNames;        /**< The channels of the MEG restricted forward solution, i.e. all candidates of the channel selection. */
+    Eigen::MatrixXd                             m_matGainWeighted;      /**< Gain matrix weighted with the (unscaled) source standard deviations. */
+    Eigen::VectorXd                             m_vecSourceCov;         /**< The (unscaled) source covariance diagonal. */
+
 signals:
     //=========================================================================================================
     /**
@@ -159,6 +207,15 @@ public:
     */
     void append(const FIFFLIB::FiffCov &noiseCov);
 
+    //=========================================================================================================
+    /**
+    * Sets the truncation rank of the decomposition used when the inverse operator is updated for a new noise
+    * covariance. Components beyond the rank are dropped. Default is -1, i.e. the full rank of the noise covariance.
+    *
+    * @param[in] iRank     The truncation rank.
+    */
+    void setRank(qint32 iRank);
+
     //=========================================================================================================
     /**
     * Restarts the thread by interrupting its computation queue, quitting, waiting and then starting it again.
@@ -182,6 +239,7 @@ protected:
     QSharedPointer<MNELIB::MNEForwardSolution>  m_pFwd;             /**< The forward solution. */
 
     QThread                                     m_workerThread;     /**< The worker thread. */
+    qint32                                      m_iRank;            /**< The truncation rank of the update path. */
 
 signals:
     //=========================================================================================================
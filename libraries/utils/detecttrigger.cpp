@@ -47,6 +47,7 @@
 //=============================================================================================================
 
 #include <iostream>
+#include <algorithm>
 
 
 //*************************************************************************************************************
@@ -73,11 +74,128 @@ using namespace UTILSLIB;
 //=============================================================================================================
 
 DetectTrigger::DetectTrigger()
+: m_bDetectOffsets(false)
 {
 
 }
 
 
+//*************************************************************************************************************
+
+void DetectTrigger::addTriggerChannel(int iChIdx, double dThreshold, quint32 uiBitMask)
+{
+    TriggerChannel channel;
+    channel.iChIdx = iChIdx;
+    channel.dThreshold = dThreshold;
+    channel.uiBitMask = uiBitMask;
+    channel.iLastValue = 0;
+    channel.bHasState = false;
+
+    m_vecTriggerChannels.append(channel);
+}
+
+
+//*************************************************************************************************************
+
+void DetectTrigger::clearTriggerChannels()
+{
+    m_vecTriggerChannels.clear();
+}
+
+
+//*************************************************************************************************************
+
+void DetectTrigger::resetState()
+{
+    for(int i = 0; i < m_vecTriggerChannels.size(); ++i) {
+        m_vecTriggerChannels[i].bHasState = false;
+    }
+}
+
+
+//*************************************************************************************************************
+
+void DetectTrigger::setDetectOffsets(bool bDetectOffsets)
+{
+    m_bDetectOffsets = bDetectOffsets;
+}
+
+
+//*************************************************************************************************************
+
+const QVector<DetectTrigger::TriggerEvent>& DetectTrigger::detectTriggerEvents(const MatrixXd &data, int iOffsetIndex)
+{
+    //Keeps the capacity, so no memory is allocated once the vector has grown to the usual number of flanks
+    m_vecEvents.resize(0);
+
+    const int iSamples = data.cols();
+
+    if(iSamples == 0) {
+        return m_vecEvents;
+    }
+
+    if(m_vecCodes.size() != iSamples + 1) {
+        m_vecCodes.resize(iSamples + 1);
+    }
+
+    if(m_vecRow.size() != iSamples) {
+        m_vecRow.resize(iSamples);
+    }
+
+    for(int i = 0; i < m_vecTriggerChannels.size(); ++i) {
+        TriggerChannel& channel = m_vecTriggerChannels[i];
+
+        if(channel.iChIdx < 0 || channel.iChIdx >= data.rows()) {
+            continue;
+        }
+
+        //The samples of a row are strided in the column major data block, copy them once before converting them
+        m_vecRow = data.row(channel.iChIdx).transpose();
+
+        //Convert the samples to trigger codes
+        const double* pData = m_vecRow.data();
+        const double dThreshold = channel.dThreshold;
+        const quint32 uiBitMask = channel.uiBitMask;
+        int* pCodes = m_vecCodes.data() + 1;
+
+        for(int j = 0; j < iSamples; ++j) {
+            const double dValue = pData[j];
+            const int iCode = uiBitMask ? int(quint32(qRound64(dValue)) & uiBitMask) : 1;
+            pCodes[j] = dValue >= dThreshold ? iCode : 0;
+        }
+
+        m_vecCodes(0) = channel.bHasState ? channel.iLastValue : m_vecCodes(1);
+        channel.iLastValue = m_vecCodes(iSamples);
+        channel.bHasState = true;
+
+        //Most blocks do not contain any flank
+        if((m_vecCodes.tail(iSamples).array() == m_vecCodes.head(iSamples).array()).all()) {
+            continue;
+        }
+
+        for(int j = 1; j <= iSamples; ++j) {
+            if(m_vecCodes(j) != m_vecCodes(j-1) && (m_vecCodes(j) != 0 || m_bDetectOffsets)) {
+                TriggerEvent event;
+                event.iChIdx = channel.iChIdx;
+                event.iSample = iOffsetIndex + j - 1;
+                event.iValue = m_vecCodes(j);
+                event.iPrevValue = m_vecCodes(j-1);
+
+                m_vecEvents.append(event);
+            }
+        }
+    }
+
+    if(m_vecTriggerChannels.size() > 1) {
+        std::stable_sort(m_vecEvents.begin(), m_vecEvents.end(), [](const TriggerEvent& a, const TriggerEvent& b) {
+            return a.iSample < b.iSample;
+        });
+    }
+
+    return m_vecEvents;
+}
+
+
 //*************************************************************************************************************
 
 QMap<int,QList<QPair<int,double> > > DetectTrigger::detectTriggerFlanksMax(const MatrixXd &data,
@@ -50,6 +50,7 @@
 //=============================================================================================================
 
 #include <QSharedPointer>
+#include <QVector>
 
 
 //*************************************************************************************************************
@@ -97,10 +98,68 @@ public:
 
     //=========================================================================================================
     /**
-    * Destroys the DetectTrigger class.
+    * A trigger flank found by detectTriggerEvents.
+    */
+    struct TriggerEvent {
+        int     iChIdx;         /**< Row of the trigger channel in the data matrix. */
+        int     iSample;        /**< Sample of the flank, including the offset index. */
+        int     iValue;         /**< Trigger code from the flank on. */
+        int     iPrevValue;     /**< Trigger code before the flank. */
+    };
+
+    //=========================================================================================================
+    /**
+    * Constructs a DetectTrigger without trigger channels.
     */
     DetectTrigger();
 
+    //=========================================================================================================
+    /**
+    * Adds a channel to be scanned by detectTriggerEvents. Samples below the threshold have the trigger code 0.
+    * Samples at or above the threshold are rounded and masked to form the trigger code, e.g. to select the bits of
+    * a composite STI101 channel. With a mask of 0 the channel is treated as a binary line with the code 1 above
+    * the threshold. Note that with a mask, samples which round to 0 have the code 0 even if they are above the
+    * threshold. Analog channels with a threshold below 0.5 therefore need a mask of 0.
+    *
+    * @param[in] iChIdx         Row of the trigger channel in the data matrix.
+    * @param[in] dThreshold     The signal threshold value.
+    * @param[in] uiBitMask      The bits of the rounded sample value which form the trigger code.
+    */
+    void addTriggerChannel(int iChIdx, double dThreshold = 0.5, quint32 uiBitMask = 0xFFFFFFFF);
+
+    //=========================================================================================================
+    /**
+    * Removes all trigger channels.
+    */
+    void clearTriggerChannels();
+
+    //=========================================================================================================
+    /**
+    * Forgets the trigger codes carried over from the last block, e.g. after a discontinuity of the data.
+    */
+    void resetState();
+
+    //=========================================================================================================
+    /**
+    * Sets whether flanks back to the code 0 are reported as well. By default only flanks to a non-zero code are.
+    *
+    * @param[in] bDetectOffsets     Whether to report flanks to the code 0.
+    */
+    void setDetectOffsets(bool bDetectOffsets);
+
+    //=========================================================================================================
+    /**
+    * Detects the flanks of all trigger channels in one data block. A flank is a change of the trigger code. The
+    * code of the last sample of each block is kept, so flanks on the first sample of the next block are found and
+    * codes which stay high across blocks are reported only once. The first block only initializes the codes.
+    *
+    * @param[in] data           The data block, channels in rows.
+    * @param[in] iOffsetIndex   The offset index gets added to the sample of each flank.
+    *
+    * @return the flanks of this block sorted by sample. The vector is reused by the next call.
+    */
+    const QVector<TriggerEvent>& detectTriggerEvents(const MatrixXd &data, int iOffsetIndex = 0);
+
     //=========================================================================================================
     /**
     * detectTriggerFlanks detects flanks from a given data matrix in row wise order. This function uses a simple maxCoeff function implemented by eigen to locate the triggers.
@@ -184,6 +243,25 @@ public:
                                                              bool bRemoveOffset,
                                                              const QString& type,
                                                              int iBurstLengthSamp = 100);
+
+private:
+    //=========================================================================================================
+    /**
+    * A trigger channel scanned by detectTriggerEvents.
+    */
+    struct TriggerChannel {
+        int     iChIdx;         /**< Row of the trigger channel in the data matrix. */
+        double  dThreshold;     /**< Samples below the threshold have the code 0. */
+        quint32 uiBitMask;      /**< Bits forming the trigger code, 0 for a binary line. */
+        int     iLastValue;     /**< Trigger code of the last sample of the previous block. */
+        bool    bHasState;      /**< Whether iLastValue is valid. */
+    };
+
+    QVector<TriggerChannel>     m_vecTriggerChannels;   /**< The trigger channels. */
+    QVector<TriggerEvent>       m_vecEvents;            /**< The flanks of the last block, reused between blocks. */
+    VectorXd                    m_vecRow;               /**< Samples of one trigger channel, copied from the data block. */
+    VectorXi                    m_vecCodes;             /**< Trigger codes of one channel, preceded by the code carried over. */
+    bool                        m_bDetectOffsets;       /**< Whether flanks to the code 0 are reported. */
 };
 
 //*************************************************************************************************************
@@ -0,0 +1,301 @@
+//=============================================================================================================
+/**
+* @file     mappedfilereader.cpp
+* @author   agent <agent@local>
+* @version  1.0
+* @date     October, 2026
+*
+* @section  LICENSE
+*
+* Copyright (C) 2026, agent. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+*
+* @brief    MappedFileReader class definition.
+*
+*/
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "mappedfilereader.h"
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QtEndian>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// STL INCLUDES
+//=============================================================================================================
+
+#include <cstring>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// USED NAMESPACES
+//=============================================================================================================
+
+using namespace UTILSLIB;
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE GLOBAL METHODS
+//=============================================================================================================
+
+namespace {
+
+//=============================================================================================================
+/**
+* Converts big-endian 32 bit values to the host byte order. The loop has no dependencies between iterations, so
+* the compiler turns it into vectorized byte shuffles.
+*/
+template<typename T>
+void fromBigEndian32(const uchar* pSrc, T* pDest, qint64 iCount)
+{
+    for(qint64 i = 0; i < iCount; ++i) {
+        quint32 iValue;
+        memcpy(&iValue, pSrc + 4 * i, 4);
+        iValue = qFromBigEndian(iValue);
+        memcpy(pDest + i, &iValue, 4);
+    }
+}
+
+}
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE MEMBER METHODS
+//=============================================================================================================
+
+MappedFileReader::MappedFileReader(const QString& sFileName)
+: m_file(sFileName)
+, m_pMap(Q_NULLPTR)
+, m_pData(Q_NULLPTR)
+, m_iSize(0)
+, m_iPos(0)
+{
+    if(!m_file.open(QIODevice::ReadOnly)) {
+        return;
+    }
+
+    m_iSize = m_file.size();
+
+    if(m_iSize > 0) {
+        m_pMap = m_file.map(0, m_iSize);
+    }
+
+    if(m_pMap) {
+        m_pData = m_pMap;
+    } else {
+        m_arrayData = m_file.readAll();
+        m_iSize = m_arrayData.size();
+        m_pData = reinterpret_cast<const uchar*>(m_arrayData.constData());
+    }
+}
+
+
+//*************************************************************************************************************
+
+MappedFileReader::~MappedFileReader()
+{
+    if(m_pMap) {
+        m_file.unmap(m_pMap);
+    }
+}
+
+
+//*************************************************************************************************************
+
+bool MappedFileReader::isOpen() const
+{
+    return m_file.isOpen();
+}
+
+
+//*************************************************************************************************************
+
+qint64 MappedFileReader::size() const
+{
+    return m_iSize;
+}
+
+
+//*************************************************************************************************************
+
+qint64 MappedFileReader::pos() const
+{
+    return m_iPos;
+}
+
+
+//*************************************************************************************************************
+
+bool MappedFileReader::atEnd() const
+{
+    return m_iPos >= m_iSize;
+}
+
+
+//*************************************************************************************************************
+
+bool MappedFileReader::skip(qint64 iBytes)
+{
+    if(!available(iBytes)) {
+        return false;
+    }
+
+    m_iPos += iBytes;
+
+    return true;
+}
+
+
+//*************************************************************************************************************
+
+bool MappedFileReader::readRaw(void* pDest, qint64 iBytes)
+{
+    if(!available(iBytes)) {
+        return false;
+    }
+
+    memcpy(pDest, m_pData + m_iPos, iBytes);
+    m_iPos += iBytes;
+
+    return true;
+}
+
+
+//*************************************************************************************************************
+
+QByteArray MappedFileReader::readLine()
+{
+    qint64 iEnd = m_iPos;
+
+    while(iEnd < m_iSize && m_pData[iEnd] != '\n') {
+        ++iEnd;
+    }
+
+    if(iEnd < m_iSize) {
+        ++iEnd;
+    }
+
+    QByteArray line(reinterpret_cast<const char*>(m_pData + m_iPos), int(iEnd - m_iPos));
+    m_iPos = iEnd;
+
+    return line;
+}
+
+
+//*************************************************************************************************************
+
+bool MappedFileReader::readInt24(qint32& iValue)
+{
+    return readInt24Array(&iValue, 1);
+}
+
+
+//*************************************************************************************************************
+
+bool MappedFileReader::readInt32(qint32& iValue)
+{
+    return readInt32Array(&iValue, 1);
+}
+
+
+//*************************************************************************************************************
+
+bool MappedFileReader::readInt16Array(qint16* pDest, qint64 iCount)
+{
+    if(!available(2 * iCount)) {
+        return false;
+    }
+
+    const uchar* pSrc = m_pData + m_iPos;
+
+    for(qint64 i = 0; i < iCount; ++i) {
+        pDest[i] = qint16((quint16(pSrc[2 * i]) << 8) | quint16(pSrc[2 * i + 1]));
+    }
+
+    m_iPos += 2 * iCount;
+
+    return true;
+}
+
+
+//*************************************************************************************************************
+
+bool MappedFileReader::readInt24Array(qint32* pDest, qint64 iCount)
+{
+    if(!available(3 * iCount)) {
+        return false;
+    }
+
+    const uchar* pSrc = m_pData + m_iPos;
+
+    for(qint64 i = 0; i < iCount; ++i) {
+        pDest[i] = (qint32(pSrc[3 * i]) << 16) | (qint32(pSrc[3 * i + 1]) << 8) | qint32(pSrc[3 * i + 2]);
+    }
+
+    m_iPos += 3 * iCount;
+
+    return true;
+}
+
+
+//*************************************************************************************************************
+
+bool MappedFileReader::readInt32Array(qint32* pDest, qint64 iCount)
+{
+    if(!available(4 * iCount)) {
+        return false;
+    }
+
+    fromBigEndian32(m_pData + m_iPos, pDest, iCount);
+    m_iPos += 4 * iCount;
+
+    return true;
+}
+
+
+//*************************************************************************************************************
+
+bool MappedFileReader::readFloatArray(float* pDest, qint64 iCount)
+{
+    if(!available(4 * iCount)) {
+        return false;
+    }
+
+    fromBigEndian32(m_pData + m_iPos, pDest, iCount);
+    m_iPos += 4 * iCount;
+
+    return true;
+}
@@ -0,0 +1,257 @@
+//=============================================================================================================
+/**
+* @file     mappedfilereader.h
+* @author   agent <agent@local>
+* @version  1.0
+* @date     October, 2026
+*
+* @section  LICENSE
+*
+* Copyright (C) 2026, agent. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+*
+* @brief    MappedFileReader class declaration.
+*
+*/
+
+#ifndef MAPPEDFILEREADER_H
+#define MAPPEDFILEREADER_H
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "utils_global.h"
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QSharedPointer>
+#include <QByteArray>
+#include <QString>
+#include <QFile>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE NAMESPACE UTILSLIB
+//=============================================================================================================
+
+namespace UTILSLIB
+{
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// FORWARD DECLARATIONS
+//=============================================================================================================
+
+
+//=============================================================================================================
+/**
+* Reads binary files through a memory map, falling back to reading the whole file if it cannot be mapped. Arrays
+* of big-endian values, e.g., the vertices of FreeSurfer surfaces, are converted in one pass over the mapped memory
+* instead of value by value through a QDataStream.
+*
+* @brief Memory-mapped reader for big-endian binary files
+*/
+class UTILSSHARED_EXPORT MappedFileReader
+{
+public:
+    typedef QSharedPointer<MappedFileReader> SPtr;            /**< Shared pointer type for MappedFileReader. */
+    typedef QSharedPointer<const MappedFileReader> ConstSPtr; /**< Const shared pointer type for MappedFileReader. */
+
+    //=========================================================================================================
+    /**
+    * Opens and maps the file.
+    *
+    * @param[in] sFileName      The file to read.
+    */
+    explicit MappedFileReader(const QString& sFileName);
+
+    //=========================================================================================================
+    /**
+    * Unmaps and closes the file.
+    */
+    ~MappedFileReader();
+
+    //=========================================================================================================
+    /**
+    * Returns whether the file could be opened.
+    *
+    * @return true if the file is open, false otherwise.
+    */
+    bool isOpen() const;
+
+    //=========================================================================================================
+    /**
+    * Returns the file size in bytes.
+    *
+    * @return The file size.
+    */
+    qint64 size() const;
+
+    //=========================================================================================================
+    /**
+    * Returns the current read position in bytes.
+    *
+    * @return The read position.
+    */
+    qint64 pos() const;
+
+    //=========================================================================================================
+    /**
+    * Returns whether the read position reached the end of the file.
+    *
+    * @return true if at the end, false otherwise.
+    */
+    bool atEnd() const;
+
+    //=========================================================================================================
+    /**
+    * Advances the read position.
+    *
+    * @param[in] iBytes     The number of bytes to skip.
+    *
+    * @return true if successful, false if the file is too short.
+    */
+    bool skip(qint64 iBytes);
+
+    //=========================================================================================================
+    /**
+    * Reads bytes as they are stored in the file.
+    *
+    * @param[out] pDest     The destination of at least iBytes bytes.
+    * @param[in] iBytes     The number of bytes to read.
+    *
+    * @return true if successful, false if the file is too short.
+    */
+    bool readRaw(void* pDest, qint64 iBytes);
+
+    //=========================================================================================================
+    /**
+    * Reads up to and including the next newline character.
+    *
+    * @return The line including the newline character.
+    */
+    QByteArray readLine();
+
+    //=========================================================================================================
+    /**
+    * Reads a big-endian three byte integer as written by FreeSurfer (fread3).
+    *
+    * @param[out] iValue    The read value.
+    *
+    * @return true if successful, false if the file is too short.
+    */
+    bool readInt24(qint32& iValue);
+
+    //=========================================================================================================
+    /**
+    * Reads a big-endian 32 bit integer.
+    *
+    * @param[out] iValue    The read value.
+    *
+    * @return true if successful, false if the file is too short.
+    */
+    bool readInt32(qint32& iValue);
+
+    //=========================================================================================================
+    /**
+    * Reads an array of big-endian 16 bit integers.
+    *
+    * @param[out] pDest     The destination of at least iCount values.
+    * @param[in] iCount     The number of values to read.
+    *
+    * @return true if successful, false if the file is too short.
+    */
+    bool readInt16Array(qint16* pDest, qint64 iCount);
+
+    //=========================================================================================================
+    /**
+    * Reads an array of big-endian three byte integers (fread3_many).
+    *
+    * @param[out] pDest     The destination of at least iCount values.
+    * @param[in] iCount     The number of values to read.
+    *
+    * @return true if successful, false if the file is too short.
+    */
+    bool readInt24Array(qint32* pDest, qint64 iCount);
+
+    //=========================================================================================================
+    /**
+    * Reads an array of big-endian 32 bit integers.
+    *
+    * @param[out] pDest     The destination of at least iCount values.
+    * @param[in] iCount     The number of values to read.
+    *
+    * @return true if successful, false if the file is too short.
+    */
+    bool readInt32Array(qint32* pDest, qint64 iCount);
+
+    //=========================================================================================================
+    /**
+    * Reads an array of big-endian 32 bit floats.
+    *
+    * @param[out] pDest     The destination of at least iCount values.
+    * @param[in] iCount     The number of values to read.
+    *
+    * @return true if successful, false if the file is too short.
+    */
+    bool readFloatArray(float* pDest, qint64 iCount);
+
+private:
+    //=========================================================================================================
+    /**
+    * Checks whether iBytes can be read from the current position.
+    *
+    * @param[in] iBytes     The number of bytes.
+    *
+    * @return true if available, false otherwise.
+    */
+    inline bool available(qint64 iBytes) const;
+
+    QFile           m_file;             /**< The read file. */
+    uchar*          m_pMap;             /**< The mapped memory, or NULL if the file could not be mapped. */
+    QByteArray      m_arrayData;        /**< The file content if the file could not be mapped. */
+    const uchar*    m_pData;            /**< The file content, either mapped or read. */
+    qint64          m_iSize;            /**< The file size in bytes. */
+    qint64          m_iPos;             /**< The read position in bytes. */
+};
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INLINE DEFINITIONS
+//=============================================================================================================
+
+inline bool MappedFileReader::available(qint64 iBytes) const
+{
+    return iBytes >= 0 && m_iPos + iBytes <= m_iSize;
+}
+
+} // NAMESPACE UTILSLIB
+
+#endif // MAPPEDFILEREADER_H
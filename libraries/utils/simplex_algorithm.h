@@ -51,6 +51,24 @@
 //=============================================================================================================
 
 #include <Eigen/Core>
+#include <Eigen/StdVector>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// Qt INCLUDES
+//=============================================================================================================
+
+#include <QVector>
+#include <QtConcurrent>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// STL INCLUDES
+//=============================================================================================================
+
+#include <vector>
 
 #define ALPHA 1.0
 #define BETA 0.5
@@ -115,6 +133,53 @@ public:
                                     int report,
                                     bool (*report_func)(int loop, const Matrix<T,Dynamic, 1>& fitpar, double fval));
 
+    //=========================================================================================================
+    /**
+    * Minimization with the simplex algorithm for a number of parameters known at compile time, e.g. 3 for a
+    * dipole or sphere center, 4 for a sphere or 6 for a rigid transformation. The simplex lives on the stack and
+    * the cost function is a functor which the compiler can inline, so no heap allocation and no indirect call
+    * happens per iteration. The iterations are the same as in the dynamic version.
+    *
+    * @param[in, out] p         The initial simplex, one vertex per row. The best vertex is returned in row 0.
+    * @param[in, out] y         Function values at the vertices
+    * @param[in] ftol           Relative convergence tolerance
+    * @param[in] func           The cost function, a functor with T operator()(const Matrix<T,N,1>& x) const
+    * @param[in] max_eval       Maximum number of function evaluations
+    * @param[out] neval         Number of function evaluations
+    *
+    * @return True when the minimization converged, false otherwise
+    */
+    template <typename T, int N, typename CostFunction>
+    static bool simplex_minimize(   Matrix<T,N+1,N>& p,
+                                    Matrix<T,N+1,1>& y,
+                                    T ftol,
+                                    const CostFunction& func,
+                                    int max_eval,
+                                    int &neval);
+
+    //=========================================================================================================
+    /**
+    * Runs many independent fixed-size simplex minimizations in parallel, e.g. one dipole fit per time point or one
+    * sphere fit per head shape. Each minimization uses its own cost functor, the functors must be safe to call
+    * from several threads at once.
+    *
+    * @param[in, out] p         The initial simplices, see the fixed-size simplex_minimize.
+    * @param[in, out] y         Function values at the vertices of each simplex.
+    * @param[in] funcs          One cost function for each simplex.
+    * @param[in] ftol           Relative convergence tolerance
+    * @param[in] max_eval       Maximum number of function evaluations per minimization
+    * @param[out] neval         Number of function evaluations of each minimization
+    *
+    * @return For each minimization, whether it converged
+    */
+    template <typename T, int N, typename CostFunction>
+    static QVector<bool> simplex_minimize_batch(std::vector<Matrix<T,N+1,N>, aligned_allocator<Matrix<T,N+1,N> > >& p,
+                                                std::vector<Matrix<T,N+1,1>, aligned_allocator<Matrix<T,N+1,1> > >& y,
+                                                const std::vector<CostFunction>& funcs,
+                                                T ftol,
+                                                int max_eval,
+                                                QVector<int>& neval);
+
 private:
 
     template <typename T>
@@ -127,6 +192,15 @@ private:
                     int   ihi,
                     int &neval,
                     T fac);
+
+    template <typename T, int N, typename CostFunction>
+    static T tryit( Matrix<T,N+1,N> &p,
+                    Matrix<T,N+1,1> &y,
+                    Matrix<T,N,1> &psum,
+                    const CostFunction& func,
+                    int ihi,
+                    int &neval,
+                    T fac);
 };
 
 
@@ -248,6 +322,138 @@ T SimplexAlgorithm::tryit(  Matrix<T,Dynamic,Dynamic> &p,
     return ytry;
 }
 
+
+//*************************************************************************************************************
+
+template <typename T, int N, typename CostFunction>
+bool SimplexAlgorithm::simplex_minimize(   Matrix<T,N+1,N>& p, Matrix<T,N+1,1>& y, T ftol,
+                                            const CostFunction& func, int max_eval, int &neval)
+{
+    int   i,ilo,ihi,inhi;
+    const int mpts = N+1;
+    T ytry,ysave,rtol;
+    Matrix<T,N,1> psum = p.colwise().sum().transpose();
+    bool  result = true;
+
+    neval = 0;
+
+    for (;;) {
+        ilo = 1;
+        ihi  =  y[1]>y[2] ? (inhi = 2,1) : (inhi = 1,2);
+        for (i = 0; i < mpts; i++) {
+            if (y[i]  <  y[ilo])
+                ilo = i;
+            if (y[i] > y[ihi]) {
+                inhi = ihi;
+                ihi = i;
+            } else if (y[i] > y[inhi])
+                if (i !=  ihi)
+                    inhi = i;
+        }
+        rtol = 2.0*std::fabs(y[ihi]-y[ilo])/(std::fabs(y[ihi])+std::fabs(y[ilo]));
+        if (rtol < ftol) {
+            //Move the best vertex to the first row as the dynamic version's callers expect
+            if (ilo != 0) {
+                p.row(0).swap(p.row(ilo));
+                std::swap(y[0], y[ilo]);
+            }
+            break;
+        }
+        if (neval >=  max_eval) {
+            qCritical("Maximum number of evaluations exceeded.");
+            result  =  false;
+            break;
+        }
+        ytry = tryit<T,N>(p,y,psum,func,ihi,neval,-ALPHA);
+        if (ytry <= y[ilo])
+            tryit<T,N>(p,y,psum,func,ihi,neval,GAMMA);
+        else if (ytry >= y[inhi]) {
+            ysave = y[ihi];
+            ytry = tryit<T,N>(p,y,psum,func,ihi,neval,BETA);
+            if (ytry >= ysave) {
+                for (i = 0; i < mpts; i++) {
+                    if (i !=  ilo) {
+                        psum = 0.5 * ( p.row(i) + p.row(ilo) ).transpose();
+                        p.row(i) = psum.transpose();
+                        y[i] = func(psum);
+                    }
+                }
+                neval +=  N;
+                psum = p.colwise().sum().transpose();
+            }
+        }
+    }
+
+    return result;
+}
+
+
+//*************************************************************************************************************
+
+template <typename T, int N, typename CostFunction>
+QVector<bool> SimplexAlgorithm::simplex_minimize_batch(std::vector<Matrix<T,N+1,N>, aligned_allocator<Matrix<T,N+1,N> > >& p,
+                                                       std::vector<Matrix<T,N+1,1>, aligned_allocator<Matrix<T,N+1,1> > >& y,
+                                                       const std::vector<CostFunction>& funcs,
+                                                       T ftol,
+                                                       int max_eval,
+                                                       QVector<int>& neval)
+{
+    const int iNumFits = static_cast<int>(p.size());
+
+    QVector<bool> result(iNumFits, false);
+    neval.fill(0, iNumFits);
+
+    if(y.size() != p.size() || funcs.size() != p.size()) {
+        qCritical("SimplexAlgorithm::simplex_minimize_batch - Number of simplices, function values and cost functions differ.");
+        return result;
+    }
+
+    QVector<int> vecFits(iNumFits);
+    for(int i = 0; i < iNumFits; ++i) {
+        vecFits[i] = i;
+    }
+
+    //Write through raw pointers, so the threads never touch the containers' shared data
+    bool* pResult = result.data();
+    int* pNeval = neval.data();
+
+    QtConcurrent::blockingMap(vecFits, [&](const int& iFit) {
+        pResult[iFit] = simplex_minimize<T,N>(p[iFit], y[iFit], ftol, funcs[iFit], max_eval, pNeval[iFit]);
+    });
+
+    return result;
+}
+
+
+//*************************************************************************************************************
+
+template <typename T, int N, typename CostFunction>
+T SimplexAlgorithm::tryit(  Matrix<T,N+1,N> &p,
+                            Matrix<T,N+1,1> &y,
+                            Matrix<T,N,1> &psum,
+                            const CostFunction& func,
+                            int   ihi,
+                            int &neval,
+                            T fac)
+{
+    const T fac1 = (1.0-fac)/N;
+    const T fac2 = fac1-fac;
+
+    Matrix<T,N,1> ptry = psum * fac1 - p.row(ihi).transpose() * fac2;
+
+    T ytry = func(ptry);
+    ++neval;
+
+    if (ytry < y[ihi]) {
+        y[ihi] = ytry;
+
+        psum += ptry - p.row(ihi).transpose();
+        p.row(ihi) = ptry.transpose();
+    }
+
+    return ytry;
+}
+
 } //NAMESPACE
 
 #undef ALPHA
@@ -58,6 +58,7 @@
 #include <QElapsedTimer>
 #include <QThread>
 #include <QtConcurrent>
+#include <QtMath>
 
 
 //*************************************************************************************************************
@@ -112,6 +113,118 @@ MatrixXd Spectrogram::makeSpectrogram(VectorXd signal, qint32 windowSize = 0)
 }
 
 
+//*************************************************************************************************************
+
+MatrixXd Spectrogram::makeShortTimeSpectrogram(const VectorXd& signal,
+                                               qint32 windowSize,
+                                               qint32 hopSize)
+{
+    qint32 iSamples = signal.rows();
+
+    if(iSamples < 2) {
+        return MatrixXd::Zero(iSamples/2, iSamples);
+    }
+
+    if(windowSize <= 0) {
+        windowSize = qMax(1, iSamples/15);
+    }
+
+    if(hopSize <= 0) {
+        hopSize = qMax(1, windowSize/8);
+    }
+
+    VectorXd vecSignal = signal.array() - signal.mean();
+
+    //The gauss window is below 1e-8 of its maximum 2.5 widths away from its center, so it is truncated there
+    qint32 iHalfSupport = qCeil(2.5 * windowSize);
+    VectorXd vecWindow = gaussWindow(2 * iHalfSupport + 1, windowSize, iHalfSupport);
+
+    //Zero padding to twice the window support keeps the linear interpolation to the signal's frequency bins accurate
+    qint32 iFftSize = 1;
+    while(iFftSize < 2 * vecWindow.rows()) {
+        iFftSize *= 2;
+    }
+
+    //Frames are centered on every hopSize-th sample, the last one on the last sample
+    qint32 iNumFrames = (iSamples - 1 + hopSize - 1) / hopSize + 1;
+    qint32 iNumBins = iFftSize/2 + 1;
+
+    //Split the frames into batches for the threads
+    QList<SpectogramFrameData> lData;
+    int iThreadSize = QThread::idealThreadCount()*2;
+    int iStepsSize = qMax(1, (iNumFrames + iThreadSize - 1) / iThreadSize);
+
+    SpectogramFrameData dataTemp;
+    dataTemp.pVecInputData = &vecSignal;
+    dataTemp.pVecWindow = &vecWindow;
+    dataTemp.iFftSize = iFftSize;
+    dataTemp.iHopSize = hopSize;
+
+    for(int i = 0; i < iNumFrames; i += iStepsSize) {
+        dataTemp.iFrameLow = i;
+        dataTemp.iFrameHigh = qMin(i + iStepsSize, iNumFrames);
+        lData.append(dataTemp);
+    }
+
+    QFuture<MatrixXd> future = QtConcurrent::mapped(lData, computeFrames);
+    future.waitForFinished();
+
+    MatrixXd matFrames(iNumBins, iNumFrames);
+
+    for(int i = 0; i < lData.size(); ++i) {
+        matFrames.middleCols(lData.at(i).iFrameLow, lData.at(i).iFrameHigh - lData.at(i).iFrameLow) = future.resultAt(i);
+    }
+
+    //Linear interpolation from the frame bins to the frequency bins of the whole signal (rows) ...
+    typedef Eigen::Triplet<double> T;
+    std::vector<T> tripletList;
+    tripletList.reserve(2 * (iSamples/2));
+
+    for(qint32 r = 0; r < iSamples/2; ++r) {
+        double dBin = double(r) * iFftSize / iSamples;
+        qint32 iBin = qint32(dBin);
+        double dWeight = dBin - iBin;
+
+        tripletList.push_back(T(r, iBin, 1.0 - dWeight));
+        if(dWeight > 0.0) {
+            tripletList.push_back(T(r, iBin + 1, dWeight));
+        }
+    }
+
+    SparseMatrix<double> matFreqInterp(iSamples/2, iNumBins);
+    matFreqInterp.setFromTriplets(tripletList.begin(), tripletList.end());
+
+    // ... and from the frame centers to every sample (columns)
+    tripletList.clear();
+    tripletList.reserve(2 * iSamples);
+
+    for(qint32 n = 0; n < iSamples; ++n) {
+        qint32 iFrame = n / hopSize;
+
+        if(iFrame >= iNumFrames - 1) {
+            tripletList.push_back(T(iNumFrames - 1, n, 1.0));
+            continue;
+        }
+
+        qint32 iCenter = iFrame * hopSize;
+        qint32 iNextCenter = qMin((iFrame + 1) * hopSize, iSamples - 1);
+        double dWeight = double(n - iCenter) / (iNextCenter - iCenter);
+
+        tripletList.push_back(T(iFrame, n, 1.0 - dWeight));
+        if(dWeight > 0.0) {
+            tripletList.push_back(T(iFrame + 1, n, dWeight));
+        }
+    }
+
+    SparseMatrix<double> matTimeInterp(iNumFrames, iSamples);
+    matTimeInterp.setFromTriplets(tripletList.begin(), tripletList.end());
+
+    MatrixXd matFreqFrames = matFreqInterp * matFrames;
+
+    return matFreqFrames * matTimeInterp;
+}
+
+
 //*************************************************************************************************************
 
 VectorXd Spectrogram::gaussWindow(qint32 sample_count, qreal scale, quint32 translation)
@@ -161,6 +274,47 @@ MatrixXd Spectrogram::compute(const SpectogramInputData& inputData)
 }
 
 
+//*************************************************************************************************************
+
+MatrixXd Spectrogram::computeFrames(const SpectogramFrameData& data)
+{
+    #ifdef EIGEN_FFTW_DEFAULT
+        fftw_make_planner_thread_safe();
+    #endif
+
+    const VectorXd& vecSignal = *data.pVecInputData;
+    const VectorXd& vecWindow = *data.pVecWindow;
+    qint32 iSamples = vecSignal.rows();
+    qint32 iHalfSupport = vecWindow.rows()/2;
+    qint32 iNumFrames = data.iFrameHigh - data.iFrameLow;
+
+    //Window all frames of the batch first, zero padded to the fft size and at the signal borders
+    MatrixXd matFrames = MatrixXd::Zero(data.iFftSize, iNumFrames);
+
+    for(qint32 k = 0; k < iNumFrames; ++k) {
+        qint32 iCenter = qMin((data.iFrameLow + k) * data.iHopSize, iSamples - 1);
+        qint32 iStart = qMax(0, iCenter - iHalfSupport);
+        qint32 iEnd = qMin(iSamples, iCenter + iHalfSupport + 1);
+
+        matFrames.col(k).segment(iStart - (iCenter - iHalfSupport), iEnd - iStart) = vecSignal.segment(iStart, iEnd - iStart).cwiseProduct(vecWindow.segment(iStart - (iCenter - iHalfSupport), iEnd - iStart));
+    }
+
+    //Transform them with one fft object, which keeps its plan for the fft size
+    Eigen::FFT<double> fft;
+    MatrixXd matPower(data.iFftSize/2 + 1, iNumFrames);
+    VectorXd vecFrame;
+    VectorXcd vecFftFrame;
+
+    for(qint32 k = 0; k < iNumFrames; ++k) {
+        vecFrame = matFrames.col(k);
+        fft.fwd(vecFftFrame, vecFrame);
+        matPower.col(k) = vecFftFrame.head(data.iFftSize/2 + 1).cwiseAbs2();
+    }
+
+    return matPower;
+}
+
+
 //*************************************************************************************************************
 
 void Spectrogram::reduce(MatrixXd &resultData,
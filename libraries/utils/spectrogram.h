@@ -66,6 +66,15 @@ struct SpectogramInputData {
     qint32 window_size;
 };
 
+struct SpectogramFrameData {
+    const Eigen::VectorXd* pVecInputData;
+    const Eigen::VectorXd* pVecWindow;
+    qint32 iFftSize;
+    qint32 iHopSize;
+    qint32 iFrameLow;
+    qint32 iFrameHigh;
+};
+
 
 class UTILSSHARED_EXPORT Spectrogram
 {
@@ -83,6 +92,23 @@ public:
     static Eigen::MatrixXd makeSpectrogram(Eigen::VectorXd signal,
                                            qint32 windowSize);
 
+    //=========================================================================================================
+    /**
+    * Calculates the spectrogram (tf-representation) of a given signal with a short-time Fourier transform.
+    * Only every hopSize-th window position is transformed, with an FFT sized to the window support instead of the
+    * whole signal. The result is interpolated to the layout of makeSpectrogram (signal length/2 frequency rows, one
+    * column per sample), so it can be handed to TFplot the same way.
+    *
+    * @param[in] signal         input-signal to calculate spectrogram of
+    * @param[in] windowSize     size of the window which is used (resolution in time an frequency is depending on it)
+    * @param[in] hopSize        number of samples between two transformed windows. An eighth of the window size if <= 0.
+    *
+    * @return spectrogram-matrix (tf-representation of the input signal)
+    */
+    static Eigen::MatrixXd makeShortTimeSpectrogram(const Eigen::VectorXd& signal,
+                                                    qint32 windowSize,
+                                                    qint32 hopSize = 0);
+
 private:
     //=========================================================================================================
     /**
@@ -108,6 +134,17 @@ private:
     */
     static Eigen::MatrixXd compute(const SpectogramInputData& data);
 
+    //=========================================================================================================
+    /**
+    * Calculates the power spectra of a batch of consecutive short-time frames. All frames of the batch are windowed
+    * into one matrix first and then transformed with the same FFT object, so its plan is reused.
+    *
+    * @param[in] data       The input data.
+    *
+    * @return               The power spectra (iFftSize/2+1 rows), one column per frame of the batch.
+    */
+    static Eigen::MatrixXd computeFrames(const SpectogramFrameData& data);
+
     //=========================================================================================================
     /**
     * Sums up (reduces) the in parallel processed spectogram matrix.
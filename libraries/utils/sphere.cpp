@@ -67,6 +67,41 @@ using namespace UTILSLIB;
 using namespace Eigen;
 
 
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE GLOBAL METHODS
+//=============================================================================================================
+
+namespace {
+
+//=============================================================================================================
+/**
+* Cost function of the sphere center fit, see Sphere::fit_eval. Inlined by the fixed-size simplex and free of heap
+* allocations, so it can be evaluated for many fits in parallel. The sums are accumulated in double, since in float
+* sum2 - sum*sum/n cancels to a value too noisy for the relative convergence tolerance.
+*/
+struct SphereFitCost {
+    const MatrixXf* pPoints;    /**< The n x 3 points to fit the sphere to. */
+
+    float operator()(const Vector3f& r0) const
+    {
+        const MatrixXf& rr = *pPoints;
+        double sum = 0.0;
+        double sum2 = 0.0;
+
+        for(int i = 0; i < rr.rows(); ++i) {
+            const double dist = (rr.row(i).transpose() - r0).norm();
+            sum += dist;
+            sum2 += dist * dist;
+        }
+
+        return static_cast<float>(sum2 - sum*sum/rr.rows());
+    }
+};
+
+}
+
+
 //*************************************************************************************************************
 //=============================================================================================================
 // DEFINE MEMBER METHODS
@@ -134,6 +169,52 @@ Sphere Sphere::fit_sphere_simplex(const MatrixX3f& points, double simplex_size)
 }
 
 
+//*************************************************************************************************************
+
+QList<Sphere> Sphere::fit_spheres_simplex(const QList<MatrixX3f>& lPoints, double simplex_size)
+{
+    const int iNumFits = lPoints.size();
+
+    QList<MatrixXf> lPointsDyn;
+    std::vector<Matrix<float,4,3>, aligned_allocator<Matrix<float,4,3> > > vecSimplices(iNumFits);
+    std::vector<Vector4f, aligned_allocator<Vector4f> > vecVals(iNumFits);
+    std::vector<SphereFitCost> vecCosts(iNumFits);
+
+    for(int i = 0; i < iNumFits; ++i) {
+        lPointsDyn.append(lPoints.at(i));
+    }
+
+    for(int i = 0; i < iNumFits; ++i) {
+        VectorXf cm(3);
+        float R0 = 0.1f;
+        calculate_cm_ave_dist(lPointsDyn.at(i), cm, R0);
+
+        vecCosts[i].pPoints = &lPointsDyn.at(i);
+        vecSimplices[i] = make_initial_simplex(cm, simplex_size);
+
+        for (int k = 0; k < 4; k++) {
+            vecVals[i][k] = vecCosts[i](vecSimplices[i].row(k).transpose());
+        }
+    }
+
+    QVector<int> vecNeval;
+    QVector<bool> vecResult = SimplexAlgorithm::simplex_minimize_batch<float,3>(vecSimplices, vecVals, vecCosts, 1e-5f, 500, vecNeval);
+
+    QList<Sphere> lSpheres;
+
+    for(int i = 0; i < iNumFits; ++i) {
+        if(vecResult.at(i)) {
+            Vector3f r0 = vecSimplices[i].row(0).transpose();
+            lSpheres.append(Sphere(r0, (lPointsDyn.at(i).rowwise() - r0.transpose()).rowwise().norm().mean()));
+        } else {
+            lSpheres.append(Sphere(Vector3f::Zero(), 0.0f));
+        }
+    }
+
+    return lSpheres;
+}
+
+
 //*************************************************************************************************************
 
 bool Sphere::fit_sphere_to_points(float **rr, int np, float simplex_size, float *r0, float *R)
@@ -179,10 +260,9 @@ bool Sphere::fit_sphere_to_points(const MatrixXf &rr, float simplex_size, Vector
     fitUserRecNew user;
     float      ftol            = 1e-5f;
     int        max_eval        = 500;
-    int        report_interval = -1;
     int        neval;
-    MatrixXf   init_simplex;
-    VectorXf   init_vals(4);
+    Matrix<float,4,3> init_simplex;
+    Vector4f   init_vals;
 
     VectorXf   cm(3);
     float      R0 = 0.1f;
@@ -195,27 +275,25 @@ bool Sphere::fit_sphere_to_points(const MatrixXf &rr, float simplex_size, Vector
 
     user.report = false;
 
+    SphereFitCost cost;
+    cost.pPoints = &user.rr;
+
     for (int k = 0; k < 4; k++) {
-        init_vals[k] = fit_eval( static_cast<VectorXf>(init_simplex.row(k)), &user );
+        init_vals[k] = cost(init_simplex.row(k).transpose());
     }
 
-    user.report = false;
-
-    //Start the minimization
-    if(!SimplexAlgorithm::simplex_minimize<float>(  init_simplex,   /* The initial simplex */
+    //Start the minimization, fixed-size since the center has three parameters
+    if(!SimplexAlgorithm::simplex_minimize<float,3>(init_simplex,   /* The initial simplex */
                                                     init_vals,      /* Function values at the vertices */
                                                     ftol,           /* Relative convergence tolerance */
-                                                    fit_eval,       /* The function to be evaluated */
-                                                    &user,          /* Data to be passed to the above function in each evaluation */
+                                                    cost,           /* The function to be evaluated */
                                                     max_eval,       /* Maximum number of function evaluations */
-                                                    neval,          /* Number of function evaluations */
-                                                    report_interval,/* How often to report (-1 = no_reporting) */
-                                                    report_func))   /* The function to be called when reporting */
+                                                    neval))         /* Number of function evaluations */
     {
         return false;
     }
 
-    r0 = init_simplex.row(0);
+    r0 = init_simplex.row(0).transpose();
     R = opt_rad(r0, &user);
 
     return true;
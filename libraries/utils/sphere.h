@@ -52,6 +52,14 @@
 #include <Eigen/Core>
 
 
+//*************************************************************************************************************
+//=============================================================================================================
+// Qt INCLUDES
+//=============================================================================================================
+
+#include <QList>
+
+
 //*************************************************************************************************************
 //=============================================================================================================
 // DEFINE NAMESPACE UTILSLIB
@@ -112,6 +120,18 @@ public:
     */
     static Sphere fit_sphere_simplex(const Eigen::MatrixX3f& points, double simplex_size = 2e-2);
 
+    //=========================================================================================================
+    /**
+    * Fits spheres to several point clouds in parallel, e.g. the head shapes of several subjects or of several
+    * digitizer sessions.
+    *
+    * @param[in] lPoints        The n x 3 matrices of cartesian data, one per sphere.
+    * @param[in] simplex_size   The simplex size
+    *
+    * @return the fitted spheres, a sphere with radius 0 where a fit failed.
+    */
+    static QList<Sphere> fit_spheres_simplex(const QList<Eigen::MatrixX3f>& lPoints, double simplex_size = 2e-2);
+
     //=========================================================================================================
     /**
     * The radius of the sphere.
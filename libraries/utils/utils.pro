@@ -64,6 +64,7 @@ SOURCES += \
     kmeans.cpp \
     mnemath.cpp \
     ioutils.cpp \
+    mappedfilereader.cpp \
     layoutloader.cpp \
     layoutmaker.cpp \
     mp/adaptivemp.cpp \
@@ -90,6 +91,7 @@ HEADERS += \
     utils_global.h \
     mnemath.h \
     ioutils.h \
+    mappedfilereader.h \
     layoutloader.h \
     layoutmaker.h \
     mp/adaptivemp.h \
@@ -63,3 +63,7 @@ libraries.depends =
 applications.depends = libraries
 examples.depends = libraries
 testframes.depends = libraries
+
+!contains(MNECPP_CONFIG, noApplications) {
+    testframes.depends += applications
+}
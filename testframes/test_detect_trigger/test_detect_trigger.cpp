@@ -0,0 +1,240 @@
+//=============================================================================================================
+/**
+* @file     test_detect_trigger.cpp
+* @author   agent <agent@local>
+* @version  1.0
+* @date     October, 2026
+*
+* @section  LICENSE
+*
+* Copyright (C) 2026, agent. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+*
+* @brief    The trigger detection unit test
+*
+*/
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include <utils/detecttrigger.h>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QtTest>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// USED NAMESPACES
+//=============================================================================================================
+
+using namespace UTILSLIB;
+using namespace Eigen;
+
+
+//=============================================================================================================
+/**
+* DECLARE CLASS TestDetectTrigger
+*
+* @brief The TestDetectTrigger class verifies the block wise trigger detection over several trigger channels
+*
+*/
+class TestDetectTrigger: public QObject
+{
+    Q_OBJECT
+
+public:
+    TestDetectTrigger();
+
+private slots:
+    void initTestCase();
+    void compareOnsets();
+    void compareOffsets();
+    void compareBlockSizes();
+    void compareLowThreshold();
+    void cleanupTestCase();
+
+private:
+    QVector<DetectTrigger::TriggerEvent> detectInBlocks(DetectTrigger& detector, int iBlockSize);
+
+    MatrixXd m_matData;
+};
+
+
+//*************************************************************************************************************
+
+TestDetectTrigger::TestDetectTrigger()
+{
+}
+
+
+//*************************************************************************************************************
+
+void TestDetectTrigger::initTestCase()
+{
+    //Row 0: a data channel, row 1: a composite STI101 channel, row 2: an analog trigger line
+    m_matData = MatrixXd::Zero(3, 300);
+    m_matData.row(0).setRandom();
+
+    //Code 5 from sample 100 on, then a bit outside of the mask is set, then code 2 from sample 200 on
+    m_matData.block(1, 100, 1, 50).setConstant(5);
+    m_matData.block(1, 150, 1, 10).setConstant(5 + 256);
+    m_matData.block(1, 200, 1, 50).setConstant(2);
+
+    //Analog pulse which is high across the boundary at sample 100
+    m_matData.block(2, 99, 1, 31).setConstant(4.9);
+}
+
+
+//*************************************************************************************************************
+
+void TestDetectTrigger::compareOnsets()
+{
+    DetectTrigger detector;
+    detector.addTriggerChannel(1, 0.5, 0xFF);
+    detector.addTriggerChannel(2, 2.5, 0);
+
+    QVector<DetectTrigger::TriggerEvent> vecEvents = detectInBlocks(detector, 100);
+
+    //Flanks on the first sample of a block are found, pulses across blocks and masked bits are not reported twice
+    QCOMPARE(vecEvents.size(), 3);
+
+    QCOMPARE(vecEvents.at(0).iChIdx, 2);
+    QCOMPARE(vecEvents.at(0).iSample, 99);
+    QCOMPARE(vecEvents.at(0).iValue, 1);
+
+    QCOMPARE(vecEvents.at(1).iChIdx, 1);
+    QCOMPARE(vecEvents.at(1).iSample, 100);
+    QCOMPARE(vecEvents.at(1).iValue, 5);
+
+    QCOMPARE(vecEvents.at(2).iChIdx, 1);
+    QCOMPARE(vecEvents.at(2).iSample, 200);
+    QCOMPARE(vecEvents.at(2).iValue, 2);
+    QCOMPARE(vecEvents.at(2).iPrevValue, 0);
+}
+
+
+//*************************************************************************************************************
+
+void TestDetectTrigger::compareOffsets()
+{
+    DetectTrigger detector;
+    detector.addTriggerChannel(1, 0.5, 0xFF);
+    detector.setDetectOffsets(true);
+
+    QVector<DetectTrigger::TriggerEvent> vecEvents = detectInBlocks(detector, 100);
+
+    QCOMPARE(vecEvents.size(), 4);
+    QCOMPARE(vecEvents.at(1).iSample, 160);
+    QCOMPARE(vecEvents.at(1).iValue, 0);
+    QCOMPARE(vecEvents.at(1).iPrevValue, 5);
+    QCOMPARE(vecEvents.at(3).iSample, 250);
+}
+
+
+//*************************************************************************************************************
+
+void TestDetectTrigger::compareBlockSizes()
+{
+    DetectTrigger detectorFull;
+    detectorFull.addTriggerChannel(1, 0.5, 0xFF);
+    detectorFull.addTriggerChannel(2, 2.5, 0);
+    detectorFull.setDetectOffsets(true);
+
+    QVector<DetectTrigger::TriggerEvent> vecReference = detectInBlocks(detectorFull, 300);
+
+    //The events must not depend on how the data is split into blocks
+    for(int iBlockSize = 1; iBlockSize < 300; iBlockSize += 37) {
+        DetectTrigger detector;
+        detector.addTriggerChannel(1, 0.5, 0xFF);
+        detector.addTriggerChannel(2, 2.5, 0);
+        detector.setDetectOffsets(true);
+
+        QVector<DetectTrigger::TriggerEvent> vecEvents = detectInBlocks(detector, iBlockSize);
+
+        QCOMPARE(vecEvents.size(), vecReference.size());
+        for(int i = 0; i < vecEvents.size(); ++i) {
+            QCOMPARE(vecEvents.at(i).iChIdx, vecReference.at(i).iChIdx);
+            QCOMPARE(vecEvents.at(i).iSample, vecReference.at(i).iSample);
+            QCOMPARE(vecEvents.at(i).iValue, vecReference.at(i).iValue);
+        }
+    }
+}
+
+
+//*************************************************************************************************************
+
+void TestDetectTrigger::compareLowThreshold()
+{
+    //Analog pulse below 0.5, its samples round to 0
+    MatrixXd matData = MatrixXd::Zero(1, 100);
+    matData.block(0, 40, 1, 20).setConstant(0.3);
+
+    DetectTrigger detectorMasked;
+    detectorMasked.addTriggerChannel(0, 0.2);
+    QCOMPARE(detectorMasked.detectTriggerEvents(matData).size(), 0);
+
+    DetectTrigger detectorBinary;
+    detectorBinary.addTriggerChannel(0, 0.2, 0);
+    const QVector<DetectTrigger::TriggerEvent>& vecEvents = detectorBinary.detectTriggerEvents(matData);
+
+    QCOMPARE(vecEvents.size(), 1);
+    QCOMPARE(vecEvents.at(0).iSample, 40);
+    QCOMPARE(vecEvents.at(0).iValue, 1);
+}
+
+
+//*************************************************************************************************************
+
+void TestDetectTrigger::cleanupTestCase()
+{
+}
+
+
+//*************************************************************************************************************
+
+QVector<DetectTrigger::TriggerEvent> TestDetectTrigger::detectInBlocks(DetectTrigger& detector, int iBlockSize)
+{
+    QVector<DetectTrigger::TriggerEvent> vecEvents;
+
+    for(int iStart = 0; iStart < m_matData.cols(); iStart += iBlockSize) {
+        int iCols = qMin(iBlockSize, int(m_matData.cols()) - iStart);
+        vecEvents += detector.detectTriggerEvents(m_matData.middleCols(iStart, iCols), iStart);
+    }
+
+    return vecEvents;
+}
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// MAIN
+//=============================================================================================================
+
+QTEST_APPLESS_MAIN(TestDetectTrigger)
+#include "test_detect_trigger.moc"
@@ -0,0 +1,225 @@
+//=============================================================================================================
+/**
+* @file     test_fiff_channel_index.cpp
+* @author   agent <agent@local>
+* @version  1.0
+* @date     October, 2026
+*
+* @section  LICENSE
+*
+* Copyright (C) 2026, agent. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+*
+* @brief    The channel name index unit test
+*
+*/
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include <fiff/fiff_info.h>
+#include <fiff/fiff_constants.h>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QtTest>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// USED NAMESPACES
+//=============================================================================================================
+
+using namespace FIFFLIB;
+using namespace Eigen;
+
+
+//=============================================================================================================
+/**
+* DECLARE CLASS TestFiffChannelIndex
+*
+* @brief The TestFiffChannelIndex class verifies the cached channel lookups of the measurement info
+*
+*/
+class TestFiffChannelIndex: public QObject
+{
+    Q_OBJECT
+
+public:
+    TestFiffChannelIndex();
+
+private slots:
+    void initTestCase();
+    void compareChannelIndex();
+    void compareModifiedNames();
+    void comparePickTypes();
+    void comparePickChannels();
+    void cleanupTestCase();
+
+private:
+    FiffInfo    m_info;
+};
+
+
+//*************************************************************************************************************
+
+TestFiffChannelIndex::TestFiffChannelIndex()
+{
+}
+
+
+//*************************************************************************************************************
+
+void TestFiffChannelIndex::initTestCase()
+{
+    //Gradiometer, gradiometer, magnetometer triplets followed by EEG and stimulus channels
+    for(int i = 0; i < 306; ++i) {
+        FiffChInfo chInfo;
+        chInfo.kind = FIFFV_MEG_CH;
+        chInfo.unit = (i % 3 == 2) ? FIFF_UNIT_T : FIFF_UNIT_T_M;
+        chInfo.ch_name = QString("MEG %1").arg(i, 4, 10, QChar('0'));
+        m_info.chs.append(chInfo);
+    }
+
+    for(int i = 0; i < 60; ++i) {
+        FiffChInfo chInfo;
+        chInfo.kind = FIFFV_EEG_CH;
+        chInfo.unit = FIFF_UNIT_V;
+        chInfo.ch_name = QString("EEG %1").arg(i, 3, 10, QChar('0'));
+        m_info.chs.append(chInfo);
+    }
+
+    FiffChInfo chInfo;
+    chInfo.kind = FIFFV_STIM_CH;
+    chInfo.ch_name = "STI 014";
+    m_info.chs.append(chInfo);
+
+    for(int i = 0; i < m_info.chs.size(); ++i) {
+        m_info.ch_names.append(m_info.chs.at(i).ch_name);
+    }
+
+    m_info.nchan = m_info.chs.size();
+    m_info.bads << "MEG 0001" << "EEG 010";
+}
+
+
+//*************************************************************************************************************
+
+void TestFiffChannelIndex::compareChannelIndex()
+{
+    for(int i = 0; i < m_info.ch_names.size(); ++i) {
+        QCOMPARE(m_info.channelIndex(m_info.ch_names.at(i)), m_info.ch_names.indexOf(m_info.ch_names.at(i)));
+    }
+
+    QCOMPARE(m_info.channelIndex("MEG 9999"), -1);
+    QCOMPARE(m_info.channelTypeFlags(0), int(FiffInfoBase::MegChannel | FiffInfoBase::GradChannel));
+    QCOMPARE(m_info.channelTypeFlags(2), int(FiffInfoBase::MegChannel | FiffInfoBase::MagChannel));
+    QCOMPARE(m_info.channelTypeFlags(306), int(FiffInfoBase::EegChannel));
+}
+
+
+//*************************************************************************************************************
+
+void TestFiffChannelIndex::compareModifiedNames()
+{
+    //Modifying ch_names or chs in place after a lookup requires an invalidation
+    FiffInfo info = m_info;
+    QCOMPARE(info.channelIndex("MEG 0000"), 0);
+
+    info.ch_names[0] = "MEG RENAMED";
+    info.invalidateChannelIndex();
+    QCOMPARE(info.channelIndex("MEG RENAMED"), 0);
+    QCOMPARE(info.channelIndex("MEG 0000"), -1);
+
+    //A changed number of channels is detected without it
+    info.ch_names.prepend("MEG 0001");
+    QCOMPARE(info.channelIndex("MEG 0001"), 0);
+
+    info.chs[0].kind = FIFFV_EEG_CH;
+    info.invalidateChannelIndex();
+    QCOMPARE(info.channelTypeFlags(0), int(FiffInfoBase::EegChannel));
+
+    //The original info is not affected
+    QCOMPARE(m_info.channelIndex("MEG 0000"), 0);
+    QCOMPARE(m_info.channelIndex("MEG RENAMED"), -1);
+
+    //Assigned infos start with their own lookup tables
+    info = m_info;
+    QCOMPARE(info.channelIndex("MEG 0000"), 0);
+    QCOMPARE(info.channelIndex("MEG RENAMED"), -1);
+
+    info.clear();
+    QCOMPARE(info.channelIndex("MEG 0000"), -1);
+}
+
+
+//*************************************************************************************************************
+
+void TestFiffChannelIndex::comparePickTypes()
+{
+    QVERIFY(m_info.pick_types(true, false, false).size() == 306);
+    QVERIFY(m_info.pick_types(QString("grad"), false, false).size() == 204);
+    QVERIFY(m_info.pick_types(QString("mag"), false, false).size() == 102);
+    QVERIFY(m_info.pick_types(false, true, true).size() == 61);
+
+    RowVectorXi sel = m_info.pick_types(true, true, false, defaultQStringList, m_info.bads);
+    QVERIFY(sel.size() == 364);
+    QCOMPARE(sel(0), 0);
+    QCOMPARE(sel(1), 2);
+}
+
+
+//*************************************************************************************************************
+
+void TestFiffChannelIndex::comparePickChannels()
+{
+    QStringList include;
+    include << "EEG 005" << "MEG 0010" << "MEG 0010" << "STI 014";
+
+    RowVectorXi sel = FiffInfo::pick_channels(m_info.ch_names, include, QStringList() << "STI 014");
+
+    //Selected in channel order, duplicates and excluded channels removed
+    QVERIFY(sel.size() == 2);
+    QCOMPARE(sel(0), 10);
+    QCOMPARE(sel(1), 311);
+}
+
+
+//*************************************************************************************************************
+
+void TestFiffChannelIndex::cleanupTestCase()
+{
+}
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// MAIN
+//=============================================================================================================
+
+QTEST_APPLESS_MAIN(TestFiffChannelIndex)
+#include "test_fiff_channel_index.moc"
@@ -0,0 +1,243 @@
+//=============================================================================================================
+/**
+* @file     test_fiff_raw_writer.cpp
+* @author   agent <agent@local>
+* @version  1.0
+* @date     October, 2026
+*
+* @section  LICENSE
+*
+* Copyright (C) 2026, agent. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+*
+* @brief    The test_fiff_raw_writer unit test writes raw data with FiffRawWriter and reads it back.
+*
+*/
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include <fiff/fiff.h>
+#include <fiff/fiff_raw_writer.h>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QtTest>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// USED NAMESPACES
+//=============================================================================================================
+
+using namespace FIFFLIB;
+using namespace Eigen;
+
+
+//=============================================================================================================
+/**
+* DECLARE CLASS TestFiffRawWriter
+*
+* @brief The TestFiffRawWriter class writes raw data with FiffRawWriter and reads it back with FiffRawData
+*
+*/
+class TestFiffRawWriter: public QObject
+{
+    Q_OBJECT
+
+public:
+    TestFiffRawWriter();
+
+private slots:
+    void initTestCase();
+    void compareSplitFiles();
+    void compareSamples();
+    void compareFirstLastSamples();
+    void compareStatistics();
+    void cleanupTestCase();
+
+private:
+    double                      epsilon;
+
+    int                         m_iNumBlocks;
+    int                         m_iBlockSize;
+    int                         m_iBlocksPerFile;
+
+    FiffRawData                 m_rawIn;
+    MatrixXd                    m_matDataIn;
+    QString                     m_sFileOut;
+    FiffRawWriter::Statistics   m_statistics;
+    bool                        m_bClosed;
+};
+
+
+//*************************************************************************************************************
+
+TestFiffRawWriter::TestFiffRawWriter()
+: epsilon(0.000001)
+, m_iNumBlocks(5)
+, m_iBlockSize(600)
+, m_iBlocksPerFile(2)
+, m_statistics(FiffRawWriter::Statistics())
+, m_bClosed(false)
+{
+}
+
+
+//*************************************************************************************************************
+
+void TestFiffRawWriter::initTestCase()
+{
+    QFile t_fileIn(QDir::currentPath()+"/mne-cpp-test-data/MEG/sample/sample_audvis_raw_short.fif");
+    m_sFileOut = QDir::currentPath()+"/mne-cpp-test-data/MEG/sample/test_fiff_raw_writer_raw.fif";
+
+    m_rawIn = FiffRawData(t_fileIn);
+
+    MatrixXd times;
+    QVERIFY(m_rawIn.read_raw_segment(m_matDataIn,
+                                     times,
+                                     m_rawIn.first_samp,
+                                     m_rawIn.first_samp + m_iNumBlocks * m_iBlockSize - 1));
+
+    //Only a few blocks fit into one file, so the recording is split
+    FiffRawWriter writer;
+    qint64 iBlockBytes = 16 + (qint64)m_matDataIn.rows() * m_iBlockSize * 4;
+    writer.setMaxFileSize(m_iBlocksPerFile * iBlockBytes + 1);
+
+    //Divide by the calibrations, so the samples read back as they were
+    QVERIFY(writer.open(m_sFileOut, m_rawIn.info, m_rawIn.first_samp, true));
+
+    //A queue smaller than a block lets write() wait for the worker thread instead of dropping
+    writer.setMaxQueueSize(iBlockBytes / 2);
+
+    for(int i = 0; i < m_iNumBlocks; ++i) {
+        QVERIFY(writer.write(MatrixXd(m_matDataIn.middleCols(i * m_iBlockSize, m_iBlockSize))));
+    }
+
+    m_bClosed = writer.close();
+    m_statistics = writer.statistics();
+}
+
+
+//*************************************************************************************************************
+
+void TestFiffRawWriter::compareSplitFiles()
+{
+    QVERIFY(m_bClosed);
+
+    int iNumFiles = (m_iNumBlocks + m_iBlocksPerFile - 1) / m_iBlocksPerFile;
+
+    QCOMPARE(m_statistics.iFileCount, iNumFiles);
+
+    for(int i = 0; i < iNumFiles; ++i) {
+        QVERIFY(QFile::exists(FiffRawWriter::splitFileName(m_sFileOut, i)));
+    }
+
+    QVERIFY(!QFile::exists(FiffRawWriter::splitFileName(m_sFileOut, iNumFiles)));
+    QCOMPARE(FiffRawWriter::splitFileName(m_sFileOut, 1), m_sFileOut.left(m_sFileOut.size() - 8) + "-1_raw.fif");
+}
+
+
+//*************************************************************************************************************
+
+void TestFiffRawWriter::compareSamples()
+{
+    int iNumFiles = (m_iNumBlocks + m_iBlocksPerFile - 1) / m_iBlocksPerFile;
+    MatrixXd matDataOut(m_matDataIn.rows(), 0);
+
+    for(int i = 0; i < iNumFiles; ++i) {
+        QFile t_fileOut(FiffRawWriter::splitFileName(m_sFileOut, i));
+        FiffRawData rawOut(t_fileOut);
+
+        MatrixXd data, times;
+        QVERIFY(rawOut.read_raw_segment(data, times, rawOut.first_samp, rawOut.last_samp));
+
+        matDataOut.conservativeResize(data.rows(), matDataOut.cols() + data.cols());
+        matDataOut.rightCols(data.cols()) = data;
+    }
+
+    QCOMPARE(matDataOut.rows(), m_matDataIn.rows());
+    QCOMPARE(matDataOut.cols(), m_matDataIn.cols());
+
+    //The samples are stored in single precision
+    QVERIFY(((matDataOut - m_matDataIn).array().abs() <= epsilon * m_matDataIn.array().abs()).all());
+}
+
+
+//*************************************************************************************************************
+
+void TestFiffRawWriter::compareFirstLastSamples()
+{
+    int iNumFiles = (m_iNumBlocks + m_iBlocksPerFile - 1) / m_iBlocksPerFile;
+    fiff_int_t iNextSample = m_rawIn.first_samp;
+
+    //Every split continues where the previous one ended
+    for(int i = 0; i < iNumFiles; ++i) {
+        QFile t_fileOut(FiffRawWriter::splitFileName(m_sFileOut, i));
+        FiffRawData rawOut(t_fileOut);
+
+        int iBlocks = qMin(m_iBlocksPerFile, m_iNumBlocks - i * m_iBlocksPerFile);
+
+        QCOMPARE(rawOut.first_samp, iNextSample);
+        QCOMPARE(rawOut.last_samp, iNextSample + iBlocks * m_iBlockSize - 1);
+
+        iNextSample = rawOut.last_samp + 1;
+    }
+
+    QCOMPARE(iNextSample, m_rawIn.first_samp + m_iNumBlocks * m_iBlockSize);
+}
+
+
+//*************************************************************************************************************
+
+void TestFiffRawWriter::compareStatistics()
+{
+    QCOMPARE(m_statistics.iBlocksWritten, (qint64)m_iNumBlocks);
+    QCOMPARE(m_statistics.iBlocksDropped, (qint64)0);
+    QCOMPARE(m_statistics.iSamplesWritten, (qint64)m_iNumBlocks * m_iBlockSize);
+    QCOMPARE(m_statistics.iQueuedBlocks, 0);
+    QVERIFY(!m_statistics.bError);
+}
+
+
+//*************************************************************************************************************
+
+void TestFiffRawWriter::cleanupTestCase()
+{
+    for(int i = 0; i <= m_statistics.iFileCount; ++i) {
+        QFile::remove(FiffRawWriter::splitFileName(m_sFileOut, i));
+    }
+}
+
+
+//=============================================================================================================
+// MAIN
+//=============================================================================================================
+
+QTEST_APPLESS_MAIN(TestFiffRawWriter)
+#include "test_fiff_raw_writer.moc"
@@ -0,0 +1,274 @@
+//=============================================================================================================
+/**
+* @file     test_fs_surface_cache.cpp
+* @author   agent <agent@local>
+* @version  1.0
+* @date     October, 2026
+*
+* @section  LICENSE
+*
+* Copyright (C) 2026, agent. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+*
+* @brief    The FreeSurfer surface reader and surface cache unit test
+*
+*/
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include <fs/surface.h>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QtTest>
+#include <QTemporaryDir>
+#include <QDataStream>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// USED NAMESPACES
+//=============================================================================================================
+
+using namespace FSLIB;
+using namespace Eigen;
+
+
+//=============================================================================================================
+/**
+* DECLARE CLASS TestFsSurfaceCache
+*
+* @brief The TestFsSurfaceCache class verifies the mapped FreeSurfer surface reader and the native surface cache
+*
+*/
+class TestFsSurfaceCache: public QObject
+{
+    Q_OBJECT
+
+public:
+    TestFsSurfaceCache();
+
+private slots:
+    void initTestCase();
+    void compareTriangleFile();
+    void compareCurvature();
+    void compareCachedSurface();
+    void compareInvalidatedCache();
+    void cleanupTestCase();
+
+private:
+    void writeTriangleFile(const QString &sFileName, const MatrixX3f &matVerts, const MatrixX3i &matTris);
+
+    QTemporaryDir   m_tempDir;
+    MatrixX3f       m_matVerts;
+    MatrixX3i       m_matTris;
+};
+
+
+//*************************************************************************************************************
+
+TestFsSurfaceCache::TestFsSurfaceCache()
+{
+}
+
+
+//*************************************************************************************************************
+
+void TestFsSurfaceCache::initTestCase()
+{
+    QVERIFY(m_tempDir.isValid());
+
+    //Octahedron in mm
+    m_matVerts.resize(6,3);
+    m_matVerts << 10, 0, 0,
+                  -10, 0, 0,
+                  0, 10, 0,
+                  0, -10, 0,
+                  0, 0, 10,
+                  0, 0, -10;
+
+    m_matTris.resize(8,3);
+    m_matTris << 0, 2, 4,
+                 2, 1, 4,
+                 1, 3, 4,
+                 3, 0, 4,
+                 2, 0, 5,
+                 1, 2, 5,
+                 3, 1, 5,
+                 0, 3, 5;
+
+    writeTriangleFile(m_tempDir.path() + "/lh.white", m_matVerts, m_matTris);
+}
+
+
+//*************************************************************************************************************
+
+void TestFsSurfaceCache::compareTriangleFile()
+{
+    Surface::setCacheDir(QString());
+
+    Surface surf;
+    QVERIFY(Surface::read(m_tempDir.path() + "/lh.white", surf, false));
+
+    QVERIFY(surf.rr().rows() == 6);
+    QVERIFY(surf.tris().rows() == 8);
+    QCOMPARE(surf.hemi(), 0);
+    QVERIFY(surf.rr().isApprox(m_matVerts * 0.001f));
+    QVERIFY(surf.tris() == m_matTris);
+
+    //Unit normals pointing outward of the octahedron
+    QVERIFY(surf.nn().rows() == 6);
+    for(int i = 0; i < surf.nn().rows(); ++i) {
+        QVERIFY(qAbs(surf.nn().row(i).norm() - 1.0f) < 1e-5f);
+        QVERIFY(surf.nn().row(i).dot(surf.rr().row(i)) > 0.0f);
+    }
+}
+
+
+//*************************************************************************************************************
+
+void TestFsSurfaceCache::compareCurvature()
+{
+    VectorXf vecCurv(6);
+    vecCurv << -0.5f, 0.25f, 1.0f, -1.0f, 0.0f, 2.5f;
+
+    QFile file(m_tempDir.path() + "/lh.curv");
+    QVERIFY(file.open(QIODevice::WriteOnly));
+
+    QDataStream stream(&file);
+    stream.setByteOrder(QDataStream::BigEndian);
+    stream.setFloatingPointPrecision(QDataStream::SinglePrecision);
+
+    //New version magic number as 3 byte integer
+    stream << quint8(0xff) << quint8(0xff) << quint8(0xff);
+    stream << qint32(6) << qint32(8) << qint32(1);
+    for(int i = 0; i < vecCurv.size(); ++i) {
+        stream << vecCurv(i);
+    }
+    file.close();
+
+    VectorXf vecRead = Surface::read_curv(m_tempDir.path() + "/lh.curv");
+
+    QVERIFY(vecRead.size() == 6);
+    QVERIFY(vecRead == vecCurv);
+}
+
+
+//*************************************************************************************************************
+
+void TestFsSurfaceCache::compareCachedSurface()
+{
+    QString sCacheDir = m_tempDir.path() + "/cache";
+    Surface::setCacheDir(sCacheDir);
+
+    Surface surfFirst;
+    QVERIFY(Surface::read(m_tempDir.path() + "/lh.white", surfFirst, false));
+    QCOMPARE(QDir(sCacheDir).entryList(QStringList() << "*.surfcache", QDir::Files).size(), 1);
+
+    Surface surfCached;
+    QVERIFY(Surface::read(m_tempDir.path() + "/lh.white", surfCached, false));
+
+    QVERIFY(surfCached.rr() == surfFirst.rr());
+    QVERIFY(surfCached.tris() == surfFirst.tris());
+    QVERIFY(surfCached.nn() == surfFirst.nn());
+    QCOMPARE(surfCached.hemi(), 0);
+
+    Surface::setCacheDir(QString());
+}
+
+
+//*************************************************************************************************************
+
+void TestFsSurfaceCache::compareInvalidatedCache()
+{
+    QString sCacheDir = m_tempDir.path() + "/cache";
+    Surface::setCacheDir(sCacheDir);
+
+    Surface surf;
+    QVERIFY(Surface::read(m_tempDir.path() + "/lh.white", surf, false));
+
+    //Replace the surface by a larger one, the cache must not be used anymore
+    MatrixX3f matVerts(7,3);
+    matVerts << m_matVerts * 2.0f, RowVector3f(0, 0, 0);
+    writeTriangleFile(m_tempDir.path() + "/lh.white", matVerts, m_matTris);
+
+    QVERIFY(Surface::read(m_tempDir.path() + "/lh.white", surf, false));
+    QVERIFY(surf.rr().rows() == 7);
+    QVERIFY(surf.rr().isApprox(matVerts * 0.001f));
+
+    Surface::setCacheDir(QString());
+}
+
+
+//*************************************************************************************************************
+
+void TestFsSurfaceCache::cleanupTestCase()
+{
+}
+
+
+//*************************************************************************************************************
+
+void TestFsSurfaceCache::writeTriangleFile(const QString &sFileName, const MatrixX3f &matVerts, const MatrixX3i &matTris)
+{
+    QFile file(sFileName);
+    QVERIFY(file.open(QIODevice::WriteOnly));
+
+    QDataStream stream(&file);
+    stream.setByteOrder(QDataStream::BigEndian);
+    stream.setFloatingPointPrecision(QDataStream::SinglePrecision);
+
+    //Triangle file magic number as 3 byte integer, followed by two lines of text
+    stream << quint8(0xff) << quint8(0xff) << quint8(0xfe);
+    file.write("created by test_fs_surface_cache\n\n");
+
+    stream << qint32(matVerts.rows()) << qint32(matTris.rows());
+
+    for(int i = 0; i < matVerts.rows(); ++i) {
+        for(int j = 0; j < 3; ++j) {
+            stream << matVerts(i,j);
+        }
+    }
+
+    for(int i = 0; i < matTris.rows(); ++i) {
+        for(int j = 0; j < 3; ++j) {
+            stream << qint32(matTris(i,j));
+        }
+    }
+
+    file.close();
+}
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// MAIN
+//=============================================================================================================
+
+QTEST_APPLESS_MAIN(TestFsSurfaceCache)
+#include "test_fs_surface_cache.moc"
@@ -0,0 +1,260 @@
+//=============================================================================================================
+/**
+* @file     test_hpi_lockin.cpp
+* @author   agent <agent@local>
+* @version  1.0
+* @date     October, 2026
+*
+* @section  LICENSE
+*
+* Copyright (C) 2026, agent. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+*
+* @brief    The test_hpi_lockin unit test verifies the streaming HPI lock-in amplitudes against HPIFit.
+*
+*/
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include <inverse/hpiFit/hpifit.h>
+#include <inverse/hpiFit/hpilockin.h>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QtTest>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// Eigen INCLUDES
+//=============================================================================================================
+
+#include <Eigen/Dense>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// USED NAMESPACES
+//=============================================================================================================
+
+using namespace INVERSELIB;
+using namespace Eigen;
+
+
+//=============================================================================================================
+/**
+* DECLARE CLASS TestHpiLockIn
+*
+* @brief The TestHpiLockIn class compares the streaming lock-in amplitudes with the amplitudes of HPIFit
+*
+*/
+class TestHpiLockIn: public QObject
+{
+    Q_OBJECT
+
+public:
+    TestHpiLockIn();
+
+private slots:
+    void initTestCase();
+    void compareQuadratureAmplitudes();
+    void compareAmplitudes();
+    void compareAfterReset();
+    void cleanupTestCase();
+
+private:
+    double relativeError(const MatrixXd& matActual, const MatrixXd& matExpected);
+
+    double          epsilon;
+    double          m_dSFreq;
+    int             m_iWindowSize;
+    int             m_iBlockSize;
+    QVector<int>    m_vFreqs;
+    QVector<int>    m_vChannels;
+    MatrixXd        m_matData;
+};
+
+
+//*************************************************************************************************************
+
+TestHpiLockIn::TestHpiLockIn()
+: epsilon(0.000001)
+, m_dSFreq(1000.0)
+, m_iWindowSize(200)
+, m_iBlockSize(37)
+{
+}
+
+
+//*************************************************************************************************************
+
+void TestHpiLockIn::initTestCase()
+{
+    qsrand(42);
+
+    m_vFreqs << 154 << 158 << 162 << 166;
+
+    int iNumChannels = 20;
+    int iNumSamples = 2000;
+
+    for(int i = 0; i < iNumChannels; ++i) {
+        m_vChannels << i;
+    }
+
+    //Coil signals with random topographies and phases plus a small amount of noise
+    MatrixXd matSinTopo = MatrixXd::Random(iNumChannels, m_vFreqs.size());
+    MatrixXd matCosTopo = MatrixXd::Random(iNumChannels, m_vFreqs.size());
+
+    m_matData = 0.01 * MatrixXd::Random(iNumChannels, iNumSamples);
+
+    for(int j = 0; j < m_vFreqs.size(); ++j) {
+        for(int s = 0; s < iNumSamples; ++s) {
+            double dPhase = 2.0 * M_PI * m_vFreqs.at(j) * s / m_dSFreq;
+            m_matData.col(s) += matSinTopo.col(j) * sin(dPhase) + matCosTopo.col(j) * cos(dPhase);
+        }
+    }
+}
+
+
+//*************************************************************************************************************
+
+void TestHpiLockIn::compareQuadratureAmplitudes()
+{
+    HPILockIn lockIn(m_vFreqs, m_dSFreq, m_vChannels, m_iWindowSize);
+
+    int iChecked = 0;
+
+    //Odd block sizes let the window start at arbitrary oscillator phases
+    for(int n = 0; n + m_iBlockSize <= m_matData.cols(); n += m_iBlockSize) {
+        lockIn.append(m_matData, n, m_iBlockSize);
+
+        int iEnd = n + m_iBlockSize;
+
+        if(!lockIn.isReady()) {
+            continue;
+        }
+
+        MatrixXd matSine, matCosine;
+        lockIn.getQuadratureAmplitudes(matSine, matCosine);
+
+        //Least squares fit of sines and cosines which start with phase zero at the first sample of the window
+        MatrixXd matRef(m_iWindowSize, 2 * m_vFreqs.size());
+
+        for(int j = 0; j < m_vFreqs.size(); ++j) {
+            for(int s = 0; s < m_iWindowSize; ++s) {
+                matRef(s, j) = sin(2.0 * M_PI * m_vFreqs.at(j) * s / m_dSFreq);
+                matRef(s, m_vFreqs.size() + j) = cos(2.0 * M_PI * m_vFreqs.at(j) * s / m_dSFreq);
+            }
+        }
+
+        MatrixXd matWindow = m_matData.middleCols(iEnd - m_iWindowSize, m_iWindowSize);
+        MatrixXd matTopo = matRef.colPivHouseholderQr().solve(matWindow.transpose()).transpose();
+
+        QVERIFY(relativeError(matSine, matTopo.leftCols(m_vFreqs.size())) < epsilon);
+        QVERIFY(relativeError(matCosine, matTopo.rightCols(m_vFreqs.size())) < epsilon);
+
+        ++iChecked;
+    }
+
+    QVERIFY(iChecked > 10);
+}
+
+
+//*************************************************************************************************************
+
+void TestHpiLockIn::compareAmplitudes()
+{
+    HPILockIn lockIn(m_vFreqs, m_dSFreq, m_vChannels, m_iWindowSize);
+
+    int iChecked = 0;
+
+    for(int n = 0; n + m_iBlockSize <= m_matData.cols(); n += m_iBlockSize) {
+        lockIn.append(m_matData, n, m_iBlockSize);
+
+        int iEnd = n + m_iBlockSize;
+
+        if(!lockIn.isReady()) {
+            continue;
+        }
+
+        MatrixXd matExpected = HPIFit::computeCoilAmplitudes(m_matData.middleCols(iEnd - m_iWindowSize, m_iWindowSize),
+                                                             m_vFreqs,
+                                                             m_dSFreq);
+
+        QVERIFY(relativeError(lockIn.getAmplitudes(), matExpected) < epsilon);
+
+        ++iChecked;
+    }
+
+    QVERIFY(iChecked > 10);
+}
+
+
+//*************************************************************************************************************
+
+void TestHpiLockIn::compareAfterReset()
+{
+    HPILockIn lockIn(m_vFreqs, m_dSFreq, m_vChannels, m_iWindowSize);
+
+    lockIn.append(m_matData, 0, 500);
+    lockIn.reset();
+    QVERIFY(!lockIn.isReady());
+
+    //The amplitudes only depend on the samples after the reset
+    lockIn.append(m_matData, 700, m_iWindowSize + 13);
+
+    MatrixXd matExpected = HPIFit::computeCoilAmplitudes(m_matData.middleCols(713, m_iWindowSize),
+                                                         m_vFreqs,
+                                                         m_dSFreq);
+
+    QVERIFY(relativeError(lockIn.getAmplitudes(), matExpected) < epsilon);
+}
+
+
+//*************************************************************************************************************
+
+void TestHpiLockIn::cleanupTestCase()
+{
+}
+
+
+//*************************************************************************************************************
+
+double TestHpiLockIn::relativeError(const MatrixXd& matActual, const MatrixXd& matExpected)
+{
+    return (matActual - matExpected).norm() / matExpected.norm();
+}
+
+
+//=============================================================================================================
+// MAIN
+//=============================================================================================================
+
+QTEST_APPLESS_MAIN(TestHpiLockIn)
+#include "test_hpi_lockin.moc"
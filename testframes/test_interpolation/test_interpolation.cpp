@@ -81,6 +81,7 @@ private slots:
     void testDimensionsForInterpolation();
     void testSumOfRow();
     void testEmptyInputsForWeightMatrix();
+    void testBlockInterpolation();
     void cleanupTestCase();
 
 private:
@@ -244,6 +245,52 @@ void TestInterpolation::testEmptyInputsForWeightMatrix()
     QVERIFY((resultMat->rows() == 0) && (resultMat->cols() == 0));
 }
 
+//*************************************************************************************************************
+
+void TestInterpolation::testBlockInterpolation()
+{
+    // create weight matrix from distance table
+    QSharedPointer<MatrixXd> distTable = GeometryInfo::scdc(smallSurface.rr, smallSurface.neighbor_vert, smallSubset);
+    QSharedPointer<SparseMatrix<float> > testWeightMatrix = Interpolation::createInterpolationMat(smallSubset,
+                                                                                 distTable,
+                                                                                 Interpolation::linear);
+
+    // random block of samples
+    MatrixXf testSignals = MatrixXf::Random(smallSubset.size(), 20);
+    MatrixXf testInterpolatedSignals = Interpolation::interpolateSignals(*testWeightMatrix, testSignals);
+
+    QVERIFY(testInterpolatedSignals.rows() == smallSurface.rr.rows());
+    QVERIFY(testInterpolatedSignals.cols() == testSignals.cols());
+
+    for(int i = 0; i < testSignals.cols(); ++i) {
+        VectorXf testInterpolatedSignal = Interpolation::interpolateSignal(*testWeightMatrix, VectorXf(testSignals.col(i)));
+        QVERIFY((testInterpolatedSignals.col(i) - testInterpolatedSignal).norm() <= 1e-5f * (1.0f + testInterpolatedSignal.norm()));
+    }
+
+    // a weight matrix large enough to be split into ranges for the parallel row-major product
+    QVector<Triplet<float> > triplets;
+    for(int i = 0; i < 20000; ++i) {
+        for(int j = 0; j < 3; ++j) {
+            triplets.push_back(Triplet<float>(i, rand() % 50, 1.0f / 3.0f));
+        }
+    }
+    SparseMatrix<float> largeWeightMatrix(20000, 50);
+    largeWeightMatrix.setFromTriplets(triplets.begin(), triplets.end());
+    SparseMatrix<float, RowMajor> largeWeightMatrixCsr = largeWeightMatrix;
+
+    MatrixXf largeSignals = MatrixXf::Random(50, 16);
+    MatrixXf reference = Interpolation::interpolateSignals(largeWeightMatrix, largeSignals);
+    MatrixXf result = Interpolation::interpolateSignals(largeWeightMatrixCsr, largeSignals);
+
+    QVERIFY(result.rows() == reference.rows());
+    QVERIFY(result.cols() == reference.cols());
+    QVERIFY((result - reference).norm() <= 1e-5f * reference.norm());
+
+    // dimension mismatch
+    QVERIFY(Interpolation::interpolateSignals(largeWeightMatrixCsr, MatrixXf::Random(10, 4)).size() == 0);
+}
+
+
 //*************************************************************************************************************
 
 void TestInterpolation::cleanupTestCase()
@@ -0,0 +1,362 @@
+//=============================================================================================================
+/**
+* @file     test_minimum_norm_roi.cpp
+* @author   agent <agent@local>
+* @version  1.0
+* @date     October, 2026
+*
+* @section  LICENSE
+*
+* Copyright (C) 2026, agent. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+*
+* @brief    Test for the region of interest evaluation of MinimumNorm.
+*
+*/
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include <inverse/minimumNorm/minimumnorm.h>
+
+#include <fiff/fiff_cov.h>
+#include <fiff/fiff_evoked.h>
+#include <fiff/fiff_info.h>
+
+#include <fs/annotationset.h>
+#include <fs/label.h>
+
+#include <mne/mne_forwardsolution.h>
+#include <mne/mne_inverse_operator.h>
+#include <mne/mne_sourceestimate.h>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QtTest>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// Eigen INCLUDES
+//=============================================================================================================
+
+#include <Eigen/Core>
+#include <Eigen/SparseCore>
+#include <Eigen/SVD>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// USED NAMESPACES
+//=============================================================================================================
+
+using namespace INVERSELIB;
+using namespace FIFFLIB;
+using namespace FSLIB;
+using namespace MNELIB;
+using namespace Eigen;
+
+
+//=============================================================================================================
+/**
+* DECLARE CLASS TestMinimumNormRoi
+*
+* @brief The TestMinimumNormRoi class compares the region of interest evaluation of MinimumNorm with the rows of
+* the full kernel.
+*
+*/
+class TestMinimumNormRoi: public QObject
+{
+    Q_OBJECT
+
+public:
+    TestMinimumNormRoi();
+
+private slots:
+    void initTestCase();
+    void compareKernelRows();
+    void compareParcelMeans_data();
+    void compareParcelMeans();
+    void compareParcelSelection();
+    void comparePcaFlip();
+    void cleanupTestCase();
+
+private:
+    QList<VectorXi> parcelSources(const QStringList& lRoiNames) const;
+
+    double epsilon;
+    float m_fLambda2;
+
+    MNEInverseOperator  m_invOp;
+    AnnotationSet       m_annotationSet;
+    MatrixXd            m_matData;
+};
+
+
+//*************************************************************************************************************
+
+TestMinimumNormRoi::TestMinimumNormRoi()
+: epsilon(0.000001)
+, m_fLambda2(1.0f / 9.0f)
+{
+}
+
+
+//*************************************************************************************************************
+
+void TestMinimumNormRoi::initTestCase()
+{
+    qDebug() << "Epsilon" << epsilon;
+
+    QFile t_fileEvoked(QDir::currentPath()+"/mne-cpp-test-data/MEG/sample/sample_audvis-ave.fif");
+    QFile t_fileCov(QDir::currentPath()+"/mne-cpp-test-data/MEG/sample/sample_audvis-cov.fif");
+    QFile t_fileFwd(QDir::currentPath()+"/mne-cpp-test-data/Result/ref-sample_audvis-meg-eeg-oct-6-fwd.fif");
+    QVERIFY(t_fileEvoked.exists());
+    QVERIFY(t_fileCov.exists());
+    QVERIFY(t_fileFwd.exists());
+
+    FiffEvoked evoked(t_fileEvoked, 0);
+    FiffCov noiseCov(t_fileCov);
+    MNEForwardSolution fwd(t_fileFwd, false, true);
+    MNEForwardSolution fwdMeg = fwd.pick_types(true, false);
+
+    // Loose orientation, the parcels use the normal components
+    m_invOp = MNEInverseOperator(evoked.info, fwdMeg, noiseCov, 0.2f, 0.8f);
+    QVERIFY(m_invOp.eigen_fields->data.cols() > 0);
+
+    m_annotationSet = AnnotationSet("sample", 2, "aparc.a2009s", QDir::currentPath()+"/mne-cpp-test-data/subjects");
+    QVERIFY(m_annotationSet.size() == 2);
+
+    std::srand(42);
+    m_matData = MatrixXd::Random(m_invOp.eigen_fields->data.cols(), 25);
+}
+
+
+//*************************************************************************************************************
+
+void TestMinimumNormRoi::compareKernelRows()
+{
+    MNEInverseOperator t_invFull = m_invOp.prepare_inverse_operator(1, m_fLambda2, true, false);
+    MatrixXd matKernel;
+    SparseMatrix<double> matNoiseNorm;
+    QList<VectorXi> lVertno;
+    QVERIFY(t_invFull.assemble_kernel(Label(), "dSPM", true, matKernel, matNoiseNorm, lVertno));
+
+    // The region of interest path prepares without noise normalization and computes it per source
+    MNEInverseOperator t_inv = m_invOp.prepare_inverse_operator(1, m_fLambda2, false, false);
+
+    qint32 iNumSources = matKernel.rows();
+    VectorXi vecSources(5);
+    vecSources << 0, 17, iNumSources / 3, iNumSources / 2 + 1, iNumSources - 1;
+
+    // Normal components of the free orientation operator
+    VectorXi vecRows = 3 * vecSources.array() + 2;
+    MatrixXd matKernelRows;
+    QVERIFY(t_inv.assemble_kernel_rows(vecRows, matKernelRows));
+    QCOMPARE(static_cast<int>(matKernelRows.rows()), static_cast<int>(vecSources.size()));
+
+    // The precomputed channel transformation gives the same rows
+    MatrixXd matKernelRowsTrans;
+    QVERIFY(t_inv.assemble_kernel_rows(vecRows, t_inv.compute_kernel_trans(), matKernelRowsTrans));
+    QVERIFY(matKernelRowsTrans.isApprox(matKernelRows));
+
+    VectorXd vecNoiseNorm = t_inv.compute_noise_norm(vecSources, m_fLambda2, true);
+
+    for(int i = 0; i < vecSources.size(); ++i) {
+        RowVectorXd vecFull = matKernel.row(vecSources[i]);
+        QVERIFY((matKernelRows.row(i) - vecFull).norm() <= epsilon * vecFull.norm());
+        QVERIFY(std::fabs(vecNoiseNorm[i] - matNoiseNorm.coeff(vecSources[i], vecSources[i])) <= epsilon * vecNoiseNorm[i]);
+    }
+}
+
+
+//*************************************************************************************************************
+
+void TestMinimumNormRoi::compareParcelMeans_data()
+{
+    QTest::addColumn<QString>("method");
+
+    QTest::newRow("MNE") << QString("MNE");
+    QTest::newRow("dSPM") << QString("dSPM");
+    QTest::newRow("sLORETA") << QString("sLORETA");
+}
+
+
+//*************************************************************************************************************
+
+void TestMinimumNormRoi::compareParcelMeans()
+{
+    QFETCH(QString, method);
+
+    MinimumNorm minimumNorm(m_invOp, m_fLambda2, method);
+    minimumNorm.doInverseSetup(1, true);
+    MNESourceEstimate sourceEstimate = minimumNorm.calculateInverse(m_matData, 0.0f, 0.001f, true);
+    QVERIFY(!sourceEstimate.isEmpty());
+
+    QStringList lRoiNames;
+    MatrixXd matRoiData = minimumNorm.calculateInverseRoi(m_matData, 1, m_annotationSet, QStringList(), "mean", lRoiNames);
+    QCOMPARE(static_cast<int>(matRoiData.rows()), lRoiNames.size());
+    QVERIFY(lRoiNames.size() > 0);
+
+    // Each parcel time course is the mean of the full kernel rows of its sources applied to the data
+    QList<VectorXi> lSources = parcelSources(lRoiNames);
+
+    for(int r = 0; r < lRoiNames.size(); ++r) {
+        QVERIFY(lSources[r].size() > 0);
+
+        RowVectorXd vecMean = RowVectorXd::Zero(m_matData.cols());
+        for(int j = 0; j < lSources[r].size(); ++j) {
+            vecMean += sourceEstimate.data.row(lSources[r][j]);
+        }
+        vecMean /= lSources[r].size();
+
+        QVERIFY((matRoiData.row(r) - vecMean).norm() <= epsilon * vecMean.norm());
+    }
+}
+
+
+//*************************************************************************************************************
+
+void TestMinimumNormRoi::compareParcelSelection()
+{
+    MinimumNorm minimumNorm(m_invOp, m_fLambda2, QString("dSPM"));
+
+    QStringList lAllNames;
+    MatrixXd matAll = minimumNorm.calculateInverseRoi(m_matData, 1, m_annotationSet, QStringList(), "mean_flip", lAllNames);
+    QVERIFY(lAllNames.size() > 2);
+
+    // Only the requested parcels are evaluated and they equal the rows of the evaluation of all parcels
+    QStringList lPicked;
+    lPicked << lAllNames.first() << lAllNames.last();
+
+    QStringList lNames;
+    MatrixXd matPicked = minimumNorm.calculateInverseRoi(m_matData, 1, m_annotationSet, lPicked, "mean_flip", lNames);
+    QVERIFY(lNames == lPicked);
+    QVERIFY(matPicked.row(0).isApprox(matAll.row(0)));
+    QVERIFY(matPicked.row(1).isApprox(matAll.row(matAll.rows() - 1)));
+}
+
+
+//*************************************************************************************************************
+
+void TestMinimumNormRoi::comparePcaFlip()
+{
+    MinimumNorm minimumNorm(m_invOp, m_fLambda2, QString("dSPM"));
+    minimumNorm.doInverseSetup(1, true);
+    MNESourceEstimate sourceEstimate = minimumNorm.calculateInverse(m_matData, 0.0f, 0.001f, true);
+    QVERIFY(!sourceEstimate.isEmpty());
+
+    QStringList lRoiNames;
+    MatrixXd matRoiData = minimumNorm.calculateInverseRoi(m_matData, 1, m_annotationSet, QStringList(), "pca_flip", lRoiNames);
+    QCOMPARE(static_cast<int>(matRoiData.rows()), lRoiNames.size());
+    QVERIFY(lRoiNames.size() > 0);
+
+    QStringList lMeanFlipNames;
+    MatrixXd matMeanFlip = minimumNorm.calculateInverseRoi(m_matData, 1, m_annotationSet, QStringList(), "mean_flip", lMeanFlipNames);
+    QVERIFY(lMeanFlipNames == lRoiNames);
+
+    QList<VectorXi> lSources = parcelSources(lRoiNames);
+
+    for(int r = 0; r < lRoiNames.size(); ++r) {
+        QVERIFY(lSources[r].size() > 0);
+
+        // First right singular vector of the parcel source time courses, scaled by the singular values
+        MatrixXd matSourceData(lSources[r].size(), m_matData.cols());
+        for(int j = 0; j < lSources[r].size(); ++j) {
+            matSourceData.row(j) = sourceEstimate.data.row(lSources[r][j]);
+        }
+
+        JacobiSVD<MatrixXd> svd(matSourceData, ComputeThinU | ComputeThinV);
+        RowVectorXd vecPca = svd.singularValues().norm() / std::sqrt((double)lSources[r].size()) * svd.matrixV().col(0).transpose();
+
+        double dError = std::min((matRoiData.row(r) - vecPca).norm(), (matRoiData.row(r) + vecPca).norm());
+        QVERIFY(dError <= epsilon * vecPca.norm());
+
+        // The sign follows the flipped sources, so the time course does not point against their mean
+        QVERIFY(matRoiData.row(r).dot(matMeanFlip.row(r)) >= -epsilon * vecPca.norm() * matMeanFlip.row(r).norm());
+    }
+}
+
+
+//*************************************************************************************************************
+
+void TestMinimumNormRoi::cleanupTestCase()
+{
+}
+
+
+//*************************************************************************************************************
+
+QList<VectorXi> TestMinimumNormRoi::parcelSources(const QStringList& lRoiNames) const
+{
+    QList<VectorXi> lSources;
+    for(int r = 0; r < lRoiNames.size(); ++r) {
+        lSources.append(VectorXi());
+    }
+
+    qint32 iOffset = 0;
+    for(qint32 h = 0; h < m_invOp.src.size(); ++h) {
+        const VectorXi &vecVertno = m_invOp.src[h].vertno;
+        const VectorXi vecVertexLabelIds = m_annotationSet[h].getLabelIds();
+        const Colortable colortable = m_annotationSet[h].getColortable();
+        const VectorXi vecLabelIds = colortable.getLabelIds();
+        QString sHemi = h == 0 ? "lh" : "rh";
+
+        for(int l = 0; l < vecLabelIds.size() && l < colortable.struct_names.size(); ++l) {
+            int r = lRoiNames.indexOf(QString("%1-%2").arg(colortable.struct_names[l]).arg(sHemi));
+            if(r < 0) {
+                continue;
+            }
+
+            QList<int> lIdx;
+            for(int i = 0; i < vecVertno.size(); ++i) {
+                if(vecVertno[i] < vecVertexLabelIds.size() && vecVertexLabelIds[vecVertno[i]] == vecLabelIds[l]) {
+                    lIdx.append(iOffset + i);
+                }
+            }
+
+            lSources[r].resize(lIdx.size());
+            for(int j = 0; j < lIdx.size(); ++j) {
+                lSources[r][j] = lIdx[j];
+            }
+        }
+
+        iOffset += vecVertno.size();
+    }
+
+    return lSources;
+}
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// MAIN
+//=============================================================================================================
+
+QTEST_APPLESS_MAIN(TestMinimumNormRoi)
+#include "test_minimum_norm_roi.moc"
@@ -0,0 +1,322 @@
+//=============================================================================================================
+/**
+* @file     test_mne_chunked_stc.cpp
+* @author   agent <agent@local>
+* @version  1.0
+* @date     October, 2026
+*
+* @section  LICENSE
+*
+* Copyright (C) 2026, agent. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+*
+* @brief    The chunked source estimate file unit test
+*
+*/
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include <mne/mne_sourceestimate.h>
+#include <mne/mne_chunked_stc_reader.h>
+#include <mne/mne_chunked_stc_writer.h>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QtTest>
+#include <QTemporaryDir>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// USED NAMESPACES
+//=============================================================================================================
+
+using namespace MNELIB;
+using namespace Eigen;
+
+
+//=============================================================================================================
+/**
+* DECLARE CLASS TestMneChunkedStc
+*
+* @brief The TestMneChunkedStc class verifies writing, random access reading and lazy source estimates of chunked
+* source estimate files
+*
+*/
+class TestMneChunkedStc: public QObject
+{
+    Q_OBJECT
+
+public:
+    TestMneChunkedStc();
+
+private slots:
+    void initTestCase();
+    void compareWindows_data();
+    void compareWindows();
+    void compareVertexSubset();
+    void compareAppendWhileReading();
+    void compareLazySourceEstimate();
+    void compareLazyWrite();
+    void compareLazyRefresh();
+    void cleanupTestCase();
+
+private:
+    QTemporaryDir       m_tempDir;
+    MNESourceEstimate   m_stc;
+};
+
+
+//*************************************************************************************************************
+
+TestMneChunkedStc::TestMneChunkedStc()
+{
+}
+
+
+//*************************************************************************************************************
+
+void TestMneChunkedStc::initTestCase()
+{
+    QVERIFY(m_tempDir.isValid());
+
+    VectorXi vecVertices(50);
+    for(int i = 0; i < vecVertices.size(); ++i) {
+        vecVertices(i) = 3 * i + 1;
+    }
+
+    //Values representable in single precision, so the round trip is exact
+    MatrixXd matData = (MatrixXd::Random(50, 1037) * 1000).array().round() / 8;
+
+    m_stc = MNESourceEstimate(matData, vecVertices, -0.1f, 0.001f);
+}
+
+
+//*************************************************************************************************************
+
+void TestMneChunkedStc::compareWindows_data()
+{
+    QTest::addColumn<bool>("compress");
+
+    QTest::newRow("raw") << false;
+    QTest::newRow("compressed") << true;
+}
+
+
+//*************************************************************************************************************
+
+void TestMneChunkedStc::compareWindows()
+{
+    QFETCH(bool, compress);
+
+    QString sFileName = m_tempDir.path() + (compress ? "/windows_z.stcc" : "/windows.stcc");
+
+    //Append in pieces which do not align with the chunks
+    {
+        MNEChunkedStcWriter writer(sFileName, m_stc.vertices, m_stc.tmin, m_stc.tstep, 100, compress);
+        QVERIFY(writer.isOpen());
+
+        for(int i = 0; i < m_stc.data.cols(); i += 77) {
+            int n = qMin(77, int(m_stc.data.cols()) - i);
+            QVERIFY(writer.append(m_stc.data.middleCols(i, n)));
+        }
+
+        QCOMPARE(writer.samples(), qint64(m_stc.data.cols()));
+    }
+
+    MNEChunkedStcReader reader(sFileName);
+    QVERIFY(reader.isOpen());
+    QCOMPARE(reader.samples(), qint64(m_stc.data.cols()));
+    QVERIFY(reader.vertices() == m_stc.vertices);
+    QCOMPARE(reader.tmin(), m_stc.tmin);
+    QCOMPARE(reader.tstep(), m_stc.tstep);
+
+    //Whole file, window inside one chunk, window across several chunks including the short last one
+    QVERIFY(reader.readWindow(0, m_stc.data.cols()) == m_stc.data);
+    QVERIFY(reader.readWindow(210, 30) == m_stc.data.middleCols(210, 30));
+    QVERIFY(reader.readWindow(150, 887) == m_stc.data.middleCols(150, 887));
+
+    //Windows beyond the end are rejected
+    QVERIFY(reader.readWindow(1000, 100).size() == 0);
+}
+
+
+//*************************************************************************************************************
+
+void TestMneChunkedStc::compareVertexSubset()
+{
+    QString sFileName = m_tempDir.path() + "/subset.stcc";
+    QVERIFY(m_stc.writeChunked(sFileName, 128));
+
+    MNEChunkedStcReader reader(sFileName);
+    QVERIFY(reader.isOpen());
+
+    VectorXi vecRows(3);
+    vecRows << 42, 0, 7;
+
+    MatrixXd matWindow = reader.readWindow(100, 300, vecRows);
+
+    QVERIFY(matWindow.rows() == 3);
+    QVERIFY(matWindow.cols() == 300);
+    for(int i = 0; i < vecRows.size(); ++i) {
+        QVERIFY(matWindow.row(i) == m_stc.data.row(vecRows(i)).segment(100, 300));
+    }
+}
+
+
+//*************************************************************************************************************
+
+void TestMneChunkedStc::compareAppendWhileReading()
+{
+    QString sFileName = m_tempDir.path() + "/growing.stcc";
+
+    MNEChunkedStcWriter writer(sFileName, m_stc.vertices, m_stc.tmin, m_stc.tstep, 64);
+    QVERIFY(writer.append(m_stc.data.leftCols(300)));
+    QVERIFY(writer.flush());
+
+    MNEChunkedStcReader reader(sFileName);
+    QVERIFY(reader.isOpen());
+    QCOMPARE(reader.samples(), qint64(300));
+
+    QVERIFY(writer.append(m_stc.data.middleCols(300, 400)));
+    QVERIFY(writer.flush());
+
+    QVERIFY(reader.refresh());
+    QCOMPARE(reader.samples(), qint64(700));
+    QVERIFY(reader.readWindow(250, 100) == m_stc.data.middleCols(250, 100));
+
+    writer.close();
+}
+
+
+//*************************************************************************************************************
+
+void TestMneChunkedStc::compareLazySourceEstimate()
+{
+    QString sFileName = m_tempDir.path() + "/lazy.stcc";
+    QVERIFY(m_stc.writeChunked(sFileName, 200, true));
+
+    MNESourceEstimate stcLazy;
+    QVERIFY(MNESourceEstimate::readChunked(sFileName, stcLazy));
+
+    QVERIFY(stcLazy.isLazy());
+    QVERIFY(stcLazy.data.size() == 0);
+    QCOMPARE(stcLazy.samples(), m_stc.samples());
+    QVERIFY(stcLazy.times.isApprox(m_stc.times));
+
+    MNESourceEstimate stcReduced = stcLazy.reduce(390, 20);
+    QVERIFY(!stcReduced.isLazy());
+    QVERIFY(stcReduced.data == m_stc.data.middleCols(390, 20));
+    QCOMPARE(stcReduced.tmin, m_stc.times(390));
+
+    //Copies share the file
+    MNESourceEstimate stcCopy = stcLazy;
+    QVERIFY(stcCopy.getData(0, 10) == m_stc.getData(0, 10));
+}
+
+
+//*************************************************************************************************************
+
+void TestMneChunkedStc::compareLazyWrite()
+{
+    QString sFileName = m_tempDir.path() + "/lazy_write.stcc";
+    QVERIFY(m_stc.writeChunked(sFileName, 300));
+
+    MNESourceEstimate stcLazy;
+    QVERIFY(MNESourceEstimate::readChunked(sFileName, stcLazy));
+
+    //The lazy estimate is streamed into a regular stc file
+    QFile t_fileStc(m_tempDir.path() + "/lazy_write-lh.stc");
+    QVERIFY(stcLazy.write(t_fileStc));
+
+    MNESourceEstimate stcRead;
+    QVERIFY(MNESourceEstimate::read(t_fileStc, stcRead));
+
+    QVERIFY(!stcRead.isLazy());
+    QCOMPARE(stcRead.samples(), m_stc.samples());
+    QVERIFY(stcRead.vertices == m_stc.vertices);
+    QVERIFY(stcRead.data == m_stc.data);
+    QVERIFY(stcRead.times.isApprox(m_stc.times));
+}
+
+
+//*************************************************************************************************************
+
+void TestMneChunkedStc::compareLazyRefresh()
+{
+    QString sFileName = m_tempDir.path() + "/lazy_growing.stcc";
+
+    MNEChunkedStcWriter writer(sFileName, m_stc.vertices, m_stc.tmin, m_stc.tstep, 64);
+    QVERIFY(writer.append(m_stc.data.leftCols(300)));
+    QVERIFY(writer.flush());
+
+    MNESourceEstimate stcLazy;
+    QVERIFY(MNESourceEstimate::readChunked(sFileName, stcLazy));
+    QCOMPARE(stcLazy.samples(), 300);
+
+    QVERIFY(writer.append(m_stc.data.middleCols(300, 400)));
+    QVERIFY(writer.flush());
+
+    //Appended samples are not visible until the estimate is refreshed
+    MNESourceEstimate stcCopy = stcLazy;
+    QCOMPARE(stcLazy.samples(), 300);
+    QCOMPARE(stcLazy.times.size(), 300);
+
+    QVERIFY(stcLazy.refresh());
+    QCOMPARE(stcLazy.samples(), 700);
+    QCOMPARE(stcLazy.times.size(), 700);
+    QVERIFY(stcLazy.times.isApprox(m_stc.times.leftCols(700)));
+    QVERIFY(stcLazy.getData(600, 100) == m_stc.data.middleCols(600, 100));
+
+    //The copy keeps its length until it is refreshed itself
+    QCOMPARE(stcCopy.samples(), 300);
+    QVERIFY(stcCopy.refresh());
+    QCOMPARE(stcCopy.samples(), 700);
+
+    //Regular estimates have nothing to refresh
+    MNESourceEstimate stcRegular = m_stc;
+    QVERIFY(!stcRegular.refresh());
+
+    writer.close();
+}
+
+
+//*************************************************************************************************************
+
+void TestMneChunkedStc::cleanupTestCase()
+{
+}
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// MAIN
+//=============================================================================================================
+
+QTEST_APPLESS_MAIN(TestMneChunkedStc)
+#include "test_mne_chunked_stc.moc"
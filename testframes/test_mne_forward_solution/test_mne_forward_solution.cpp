@@ -43,6 +43,8 @@
 #include <fwd/computeFwd/compute_fwd.h>
 #include <mne/mne.h>
 
+#include <fs/annotationset.h>
+
 
 //*************************************************************************************************************
 //=============================================================================================================
@@ -50,6 +52,7 @@
 //=============================================================================================================
 
 #include <QtTest>
+#include <QTemporaryDir>
 
 
 //*************************************************************************************************************
@@ -59,6 +62,8 @@
 
 using namespace FWDLIB;
 using namespace MNELIB;
+using namespace FSLIB;
+using namespace Eigen;
 
 
 //=============================================================================================================
@@ -79,6 +84,7 @@ private slots:
     void initTestCase();
     void computeForward();
     void compareForward();
+    void clusterForward();
     void cleanupTestCase();
 
 private:
@@ -181,6 +187,45 @@ void TestMneForwardSolution::compareForward()
 }
 
 
+//*************************************************************************************************************
+
+void TestMneForwardSolution::clusterForward()
+{
+    printf(">>>>>>>>>>>>>>>>>>>>>>>>> Cluster MEG/EEG Forward Solution >>>>>>>>>>>>>>>>>>>>>>>>>\n");
+
+    AnnotationSet t_annotationSet("sample", 2, "aparc.a2009s", "./mne-cpp-test-data/subjects");
+    QVERIFY(!t_annotationSet.isEmpty());
+
+    QTemporaryDir t_cacheDir;
+    QVERIFY(t_cacheDir.isValid());
+    MNEForwardSolution::setClusterCacheDir(t_cacheDir.path());
+
+    // The first run clusters and fills the cache, the second one reads the clusters from the cache
+    SparseMatrix<double> t_DSparse;
+    MNEForwardSolution t_clusteredFwd = m_pFwdMEGEEGRef->cluster_forward_solution(t_annotationSet, 40, t_DSparse);
+    QCOMPARE(QDir(t_cacheDir.path()).entryList(QStringList("*.clustercache")).size(), 1);
+
+    MatrixXd t_D;
+    MNEForwardSolution t_clusteredFwdCached = m_pFwdMEGEEGRef->cluster_forward_solution(t_annotationSet, 40, t_D);
+
+    MNEForwardSolution::setClusterCacheDir(QString());
+
+    QVERIFY(t_clusteredFwd.isClustered());
+    QVERIFY(t_clusteredFwd.sol->data == t_clusteredFwdCached.sol->data);
+    QVERIFY(t_clusteredFwd.src == t_clusteredFwdCached.src);
+    QVERIFY(MatrixXd(t_DSparse) == t_D);
+
+    // The cluster operator maps all sources to the clusters, each cluster averages its sources
+    QCOMPARE(t_DSparse.rows(), m_pFwdMEGEEGRef->sol->data.cols());
+    QCOMPARE(t_DSparse.cols(), t_clusteredFwd.sol->data.cols());
+    QCOMPARE(t_clusteredFwd.nsource * 3, int(t_clusteredFwd.sol->data.cols()));
+    QVERIFY((t_D.colwise().sum().array() - 1.0).abs().maxCoeff() < epsilon);
+    QVERIFY(t_DSparse.nonZeros() <= m_pFwdMEGEEGRef->sol->data.cols());
+
+    printf("<<<<<<<<<<<<<<<<<<<<<<<<< Cluster MEG/EEG Forward Solution Finished <<<<<<<<<<<<<<<<<<<<<<<<<\n");
+}
+
+
 //*************************************************************************************************************
 
 void TestMneForwardSolution::cleanupTestCase()
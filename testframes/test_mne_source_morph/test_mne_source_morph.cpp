@@ -0,0 +1,380 @@
+//=============================================================================================================
+/**
+* @file     test_mne_source_morph.cpp
+* @author   agent <agent@local>
+* @version  1.0
+* @date     October, 2026
+*
+* @section  LICENSE
+*
+* Copyright (C) 2026, agent. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+*
+* @brief    Test for morphing source estimates between subjects.
+*
+*/
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include <mne/mne_source_morph.h>
+#include <mne/mne_sourceestimate.h>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QtTest>
+#include <QTemporaryDir>
+#include <QDataStream>
+#include <QMap>
+#include <QPair>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// Eigen INCLUDES
+//=============================================================================================================
+
+#include <Eigen/Geometry>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// USED NAMESPACES
+//=============================================================================================================
+
+using namespace MNELIB;
+using namespace Eigen;
+
+
+//=============================================================================================================
+/**
+* DECLARE CLASS TestMneSourceMorph
+*
+* @brief The TestMneSourceMorph class verifies the morph maps, the combined morph operator and the morphing of
+* source estimates on subdivided icosahedra
+*
+*/
+class TestMneSourceMorph: public QObject
+{
+    Q_OBJECT
+
+public:
+    TestMneSourceMorph();
+
+private slots:
+    void initTestCase();
+    void compareMorphMap();
+    void compareMorphOperator();
+    void compareSourceEstimate();
+    void cleanupTestCase();
+
+private:
+    void makeIcosahedron(int iSubdivisions, MatrixX3f &matVerts, MatrixX3i &matTris);
+    void writeTriangleFile(const QString &sFileName, const MatrixX3f &matVerts, const MatrixX3i &matTris);
+
+    QTemporaryDir   m_tempDir;
+    MatrixX3f       m_matVertsFrom;     /**< Rotated ico-4 sphere of the subject to morph from. */
+    MatrixX3i       m_matTrisFrom;
+    MatrixX3f       m_matVertsTo;       /**< ico-4 sphere of the subject to morph to. */
+    MatrixX3i       m_matTrisTo;
+    VectorXi        m_vecVerticesIco3;  /**< The ico-3 vertices, which come first in both spheres. */
+};
+
+
+//*************************************************************************************************************
+
+TestMneSourceMorph::TestMneSourceMorph()
+{
+}
+
+
+//*************************************************************************************************************
+
+void TestMneSourceMorph::initTestCase()
+{
+    QVERIFY(m_tempDir.isValid());
+
+    makeIcosahedron(4, m_matVertsTo, m_matTrisTo);
+
+    //Registered spheres have a radius of 100 mm
+    Matrix3f matRot = AngleAxisf(0.3f, Vector3f(1.0f, 2.0f, 3.0f).normalized()).toRotationMatrix();
+    m_matVertsFrom = m_matVertsTo * matRot.transpose() * 100.0f;
+    m_matTrisFrom = m_matTrisTo;
+    m_matVertsTo *= 100.0f;
+
+    m_vecVerticesIco3.resize(642);
+    for(int i = 0; i < m_vecVerticesIco3.size(); ++i) {
+        m_vecVerticesIco3(i) = i;
+    }
+
+    for(int h = 0; h < 2; ++h) {
+        QString sHemi = h == 0 ? "lh" : "rh";
+        QVERIFY(QDir().mkpath(m_tempDir.path() + "/subject_from/surf"));
+        QVERIFY(QDir().mkpath(m_tempDir.path() + "/subject_to/surf"));
+        writeTriangleFile(m_tempDir.path() + "/subject_from/surf/" + sHemi + ".sphere.reg", m_matVertsFrom, m_matTrisFrom);
+        writeTriangleFile(m_tempDir.path() + "/subject_to/surf/" + sHemi + ".sphere.reg", m_matVertsTo, m_matTrisTo);
+    }
+}
+
+
+//*************************************************************************************************************
+
+void TestMneSourceMorph::compareMorphMap()
+{
+    //Morphing a sphere onto itself maps every vertex onto itself
+    SparseMatrix<double> matIdentity = MNESourceMorph::makeMorphMap(m_matVertsTo, m_matTrisTo, m_matVertsTo);
+    QCOMPARE(int(matIdentity.nonZeros()), int(m_matVertsTo.rows()));
+    QVERIFY(MatrixXd(matIdentity).isIdentity());
+
+    //Each vertex is interpolated from one triangle, so linear functions are reproduced up to the curvature
+    SparseMatrix<double> matMorphMap = MNESourceMorph::makeMorphMap(m_matVertsFrom, m_matTrisFrom, m_matVertsTo);
+    QCOMPARE(int(matMorphMap.rows()), int(m_matVertsTo.rows()));
+    QCOMPARE(int(matMorphMap.cols()), int(m_matVertsFrom.rows()));
+
+    VectorXd vecRowSums = matMorphMap * VectorXd::Ones(matMorphMap.cols());
+    QVERIFY((vecRowSums.array() - 1.0).abs().maxCoeff() < 1e-6);
+
+    VectorXd vecFrom = m_matVertsFrom.col(0).cast<double>() / 100.0;
+    VectorXd vecTo = m_matVertsTo.col(0).cast<double>() / 100.0;
+    QVERIFY((matMorphMap * vecFrom - vecTo).cwiseAbs().maxCoeff() < 5e-3);
+}
+
+
+//*************************************************************************************************************
+
+void TestMneSourceMorph::compareMorphOperator()
+{
+    SparseMatrix<double> matMorphMap = MNESourceMorph::makeMorphMap(m_matVertsFrom, m_matTrisFrom, m_matVertsTo);
+
+    //Once the smoothing reached every vertex, the operator averages and constant data stays constant
+    for(int iSmoothSteps : {5, 0}) {
+        SparseMatrix<double, RowMajor> matOperator = MNESourceMorph::makeMorphOperator(matMorphMap,
+                                                                                       m_matTrisFrom,
+                                                                                       m_vecVerticesIco3,
+                                                                                       m_vecVerticesIco3,
+                                                                                       iSmoothSteps);
+        QCOMPARE(int(matOperator.rows()), int(m_vecVerticesIco3.size()));
+        QCOMPARE(int(matOperator.cols()), int(m_vecVerticesIco3.size()));
+
+        VectorXd vecRowSums = matOperator * VectorXd::Ones(matOperator.cols());
+        QVERIFY((vecRowSums.array() - 1.0).abs().maxCoeff() < 1e-6);
+        QVERIFY(MatrixXd(matOperator).minCoeff() >= 0.0);
+    }
+
+    //Without smoothing the sources are interpolated directly, so data at identical positions is kept
+    SparseMatrix<double> matIdentity(m_matVertsTo.rows(), m_matVertsTo.rows());
+    matIdentity.setIdentity();
+    SparseMatrix<double, RowMajor> matOperator = MNESourceMorph::makeMorphOperator(matIdentity,
+                                                                                   m_matTrisTo,
+                                                                                   m_vecVerticesIco3,
+                                                                                   m_vecVerticesIco3,
+                                                                                   1);
+    QVERIFY(MatrixXd(matOperator).isIdentity());
+
+    //Invalid vertices
+    VectorXi vecInvalid = VectorXi::Constant(1, int(m_matVertsTo.rows()));
+    QCOMPARE(int(MNESourceMorph::makeMorphOperator(matMorphMap, m_matTrisFrom, vecInvalid, m_vecVerticesIco3, 5).rows()), 0);
+}
+
+
+//*************************************************************************************************************
+
+void TestMneSourceMorph::compareSourceEstimate()
+{
+    QList<VectorXi> lVertices;
+    lVertices << m_vecVerticesIco3 << m_vecVerticesIco3.head(100);
+
+    //The morph maps are created and written to the morph-maps directory
+    MNESourceMorph::clearCache();
+    MNESourceMorph morph;
+    QVERIFY(morph.isEmpty());
+    QVERIFY(morph.compute("subject_from", "subject_to", m_tempDir.path(), lVertices, lVertices, 5));
+    QVERIFY(QFile::exists(m_tempDir.path() + "/morph-maps/subject_from-subject_to-morph.fif"));
+
+    MatrixXd matOperator = MatrixXd(morph.morphOperator());
+    QCOMPARE(int(matOperator.rows()), 742);
+    QCOMPARE(int(matOperator.cols()), 742);
+    QVERIFY(morph.verticesFrom().tail(100) == m_vecVerticesIco3.head(100));
+
+    //The hemispheres are independent
+    QVERIFY(matOperator.topRightCorner(642, 100).isZero(0.0));
+    QVERIFY(matOperator.bottomLeftCorner(100, 642).isZero(0.0));
+
+    //Read the written morph maps, which are stored in single precision
+    QList<SparseMatrix<double> > lMorphMaps;
+    QVERIFY(MNESourceMorph::readMorphMaps(m_tempDir.path() + "/morph-maps/subject_from-subject_to-morph.fif",
+                                          "subject_from", "subject_to", lMorphMaps));
+    QCOMPARE(lMorphMaps.size(), 2);
+    SparseMatrix<double> matMorphMap = MNESourceMorph::makeMorphMap(m_matVertsFrom, m_matTrisFrom, m_matVertsTo);
+    QVERIFY(MatrixXd(lMorphMaps.at(0) - matMorphMap).cwiseAbs().maxCoeff() < 1e-6);
+
+    //The file holds the reverse direction as well
+    QVERIFY(MNESourceMorph::readMorphMaps(m_tempDir.path() + "/morph-maps/subject_from-subject_to-morph.fif",
+                                          "subject_to", "subject_from", lMorphMaps));
+    QCOMPARE(lMorphMaps.size(), 2);
+    SparseMatrix<double> matMorphMapReverse = MNESourceMorph::makeMorphMap(m_matVertsTo, m_matTrisTo, m_matVertsFrom);
+    QCOMPARE(int(lMorphMaps.at(1).rows()), int(m_matVertsFrom.rows()));
+    QVERIFY(MatrixXd(lMorphMaps.at(1) - matMorphMapReverse).cwiseAbs().maxCoeff() < 1e-6);
+    QVERIFY(!MNESourceMorph::readMorphMaps(m_tempDir.path() + "/morph-maps/subject_from-subject_to-morph.fif",
+                                           "subject_to", "subject_to", lMorphMaps));
+
+    MNESourceMorph::clearCache();
+    MNESourceMorph morphRead;
+    QVERIFY(morphRead.compute("subject_from", "subject_to", m_tempDir.path(), lVertices, lVertices, 5));
+    QVERIFY((MatrixXd(morphRead.morphOperator()) - matOperator).cwiseAbs().maxCoeff() < 1e-6);
+
+    //Values representable in single precision, so the chunked file round trip is exact
+    MatrixXd matData = (MatrixXd::Random(742, 123) * 1000).array().round() / 8;
+    MNESourceEstimate stc(matData, morph.verticesFrom(), -0.1f, 0.001f);
+
+    MNESourceEstimate stcMorphed = morph.apply(stc);
+    QVERIFY(stcMorphed.vertices == morph.verticesTo());
+    QCOMPARE(stcMorphed.tmin, stc.tmin);
+    QCOMPARE(stcMorphed.tstep, stc.tstep);
+    MatrixXd matReference = matOperator * matData;
+    QVERIFY(stcMorphed.data.isApprox(matReference));
+
+    //Lazy source estimates are morphed window by window
+    QString sFileName = m_tempDir.path() + "/data.stcc";
+    QVERIFY(stc.writeChunked(sFileName, 50));
+    MNESourceEstimate stcLazy;
+    QVERIFY(MNESourceEstimate::readChunked(sFileName, stcLazy));
+    MNESourceEstimate stcLazyMorphed = morph.apply(stcLazy, 17);
+    QVERIFY(stcLazyMorphed.data.isApprox(matReference));
+
+    //Mismatching vertices
+    MNESourceEstimate stcOther(matData.topRows(642), m_vecVerticesIco3, -0.1f, 0.001f);
+    QVERIFY(morph.apply(stcOther).isEmpty());
+}
+
+
+//*************************************************************************************************************
+
+void TestMneSourceMorph::cleanupTestCase()
+{
+    MNESourceMorph::clearCache();
+}
+
+
+//*************************************************************************************************************
+
+void TestMneSourceMorph::makeIcosahedron(int iSubdivisions, MatrixX3f &matVerts, MatrixX3i &matTris)
+{
+    const float t = (1.0f + std::sqrt(5.0f)) / 2.0f;
+
+    QList<Vector3f> lVerts;
+    lVerts << Vector3f(-1, t, 0) << Vector3f(1, t, 0) << Vector3f(-1, -t, 0) << Vector3f(1, -t, 0)
+           << Vector3f(0, -1, t) << Vector3f(0, 1, t) << Vector3f(0, -1, -t) << Vector3f(0, 1, -t)
+           << Vector3f(t, 0, -1) << Vector3f(t, 0, 1) << Vector3f(-t, 0, -1) << Vector3f(-t, 0, 1);
+    for(int i = 0; i < lVerts.size(); ++i) {
+        lVerts[i].normalize();
+    }
+
+    QList<Vector3i> lTris;
+    lTris << Vector3i(0, 11, 5) << Vector3i(0, 5, 1) << Vector3i(0, 1, 7) << Vector3i(0, 7, 10) << Vector3i(0, 10, 11)
+          << Vector3i(1, 5, 9) << Vector3i(5, 11, 4) << Vector3i(11, 10, 2) << Vector3i(10, 7, 6) << Vector3i(7, 1, 8)
+          << Vector3i(3, 9, 4) << Vector3i(3, 4, 2) << Vector3i(3, 2, 6) << Vector3i(3, 6, 8) << Vector3i(3, 8, 9)
+          << Vector3i(4, 9, 5) << Vector3i(2, 4, 11) << Vector3i(6, 2, 10) << Vector3i(8, 6, 7) << Vector3i(9, 8, 1);
+
+    //New vertices are appended, so the vertices of coarser subdivisions come first as in fsaverage
+    for(int s = 0; s < iSubdivisions; ++s) {
+        QMap<QPair<int,int>, int> mapMidpoints;
+        QList<Vector3i> lTrisNew;
+
+        auto midpoint = [&](int a, int b) {
+            QPair<int,int> pairEdge(qMin(a, b), qMax(a, b));
+            if(!mapMidpoints.contains(pairEdge)) {
+                lVerts << ((lVerts[a] + lVerts[b]) / 2.0f).normalized();
+                mapMidpoints.insert(pairEdge, lVerts.size() - 1);
+            }
+            return mapMidpoints.value(pairEdge);
+        };
+
+        for(int i = 0; i < lTris.size(); ++i) {
+            const Vector3i tri = lTris[i];
+            int a = midpoint(tri(0), tri(1));
+            int b = midpoint(tri(1), tri(2));
+            int c = midpoint(tri(2), tri(0));
+            lTrisNew << Vector3i(tri(0), a, c) << Vector3i(tri(1), b, a) << Vector3i(tri(2), c, b) << Vector3i(a, b, c);
+        }
+
+        lTris = lTrisNew;
+    }
+
+    matVerts.resize(lVerts.size(), 3);
+    for(int i = 0; i < lVerts.size(); ++i) {
+        matVerts.row(i) = lVerts[i].transpose();
+    }
+
+    matTris.resize(lTris.size(), 3);
+    for(int i = 0; i < lTris.size(); ++i) {
+        matTris.row(i) = lTris[i].transpose();
+    }
+}
+
+
+//*************************************************************************************************************
+
+void TestMneSourceMorph::writeTriangleFile(const QString &sFileName, const MatrixX3f &matVerts, const MatrixX3i &matTris)
+{
+    QFile file(sFileName);
+    QVERIFY(file.open(QIODevice::WriteOnly));
+
+    QDataStream stream(&file);
+    stream.setByteOrder(QDataStream::BigEndian);
+    stream.setFloatingPointPrecision(QDataStream::SinglePrecision);
+
+    //Triangle file magic number as 3 byte integer, followed by two lines of text. Vertices are stored in mm.
+    stream << quint8(0xff) << quint8(0xff) << quint8(0xfe);
+    file.write("created by test_mne_source_morph\n\n");
+
+    stream << qint32(matVerts.rows()) << qint32(matTris.rows());
+
+    for(int i = 0; i < matVerts.rows(); ++i) {
+        for(int j = 0; j < 3; ++j) {
+            stream << matVerts(i,j);
+        }
+    }
+
+    for(int i = 0; i < matTris.rows(); ++i) {
+        for(int j = 0; j < 3; ++j) {
+            stream << qint32(matTris(i,j));
+        }
+    }
+
+    file.close();
+}
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// MAIN
+//=============================================================================================================
+
+QTEST_APPLESS_MAIN(TestMneSourceMorph)
+#include "test_mne_source_morph.moc"
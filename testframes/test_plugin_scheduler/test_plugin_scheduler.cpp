@@ -0,0 +1,464 @@
+//=============================================================================================================
+/**
+* @file     test_plugin_scheduler.cpp
+* @author   agent <agent@local>
+* @version  1.0
+* @date     October, 2026
+*
+* @section  LICENSE
+*
+* Copyright (C) 2026, agent. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+*
+* @brief    Test for the block ordering and backpressure of the mne_scan PluginScheduler
+*
+*/
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include <scShared/Management/pluginscheduler.h>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QtTest>
+#include <QThread>
+#include <QSemaphore>
+#include <QMutex>
+#include <QVector>
+#include <QAtomicInt>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// STL INCLUDES
+//=============================================================================================================
+
+#include <functional>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// USED NAMESPACES
+//=============================================================================================================
+
+using namespace SCSHAREDLIB;
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE GLOBAL METHODS
+//=============================================================================================================
+
+namespace
+{
+
+//=============================================================================================================
+/**
+* Runs a function on its own thread, used to post from a producer thread which is not a scheduler worker.
+*/
+class ProducerThread : public QThread
+{
+public:
+    explicit ProducerThread(const std::function<void()>& func)
+    : m_func(func)
+    {
+    }
+
+protected:
+    virtual void run()
+    {
+        m_func();
+    }
+
+private:
+    std::function<void()> m_func;   /**< The function to run. */
+};
+
+//=============================================================================================================
+/**
+* Records the executed blocks of one handler and checks that they never overlap.
+*/
+struct BlockLog
+{
+    BlockLog()
+    : iActive(0)
+    , bOverlap(false)
+    {
+    }
+
+    void append(int iBlock)
+    {
+        if(iActive.fetchAndAddOrdered(1) != 0) {
+            bOverlap = true;
+        }
+
+        {
+            QMutexLocker locker(&mutex);
+            vecBlocks.append(iBlock);
+        }
+
+        iActive.fetchAndAddOrdered(-1);
+    }
+
+    QVector<int> blocks()
+    {
+        QMutexLocker locker(&mutex);
+        return vecBlocks;
+    }
+
+    QMutex          mutex;      /**< Guards vecBlocks. */
+    QVector<int>    vecBlocks;  /**< The executed blocks in execution order. */
+    QAtomicInt      iActive;    /**< The number of blocks currently executing. */
+    bool            bOverlap;   /**< Whether two blocks were executing at the same time. */
+};
+
+//=============================================================================================================
+/**
+* Returns whether the blocks are 0, 1, ..., iNumBlocks - 1.
+*/
+bool isSequence(const QVector<int>& vecBlocks, int iNumBlocks)
+{
+    if(vecBlocks.size() != iNumBlocks) {
+        return false;
+    }
+
+    for(int i = 0; i < iNumBlocks; ++i) {
+        if(vecBlocks[i] != i) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+} // NAMESPACE
+
+
+//=============================================================================================================
+/**
+* DECLARE CLASS TestPluginScheduler
+*
+* @brief The TestPluginScheduler class provides tests for the block ordering, the backpressure and the
+* unregistering of handlers of the PluginScheduler.
+*
+*/
+class TestPluginScheduler: public QObject
+{
+    Q_OBJECT
+
+public:
+    TestPluginScheduler();
+
+private slots:
+    void initTestCase();
+    void compareOrdering();
+    void compareWorkerPostToFullQueue();
+    void compareBackpressure();
+    void compareTryPost();
+    void compareDropOldest();
+    void compareUnregisterWhilePosting();
+    void cleanupTestCase();
+
+private:
+    int m_iNumBlocks;
+};
+
+
+//*************************************************************************************************************
+
+TestPluginScheduler::TestPluginScheduler()
+: m_iNumBlocks(2000)
+{
+}
+
+
+//*************************************************************************************************************
+
+void TestPluginScheduler::initTestCase()
+{
+}
+
+
+//*************************************************************************************************************
+
+void TestPluginScheduler::compareOrdering()
+{
+    PluginScheduler scheduler(4);
+    scheduler.start();
+    QVERIFY(scheduler.isRunning());
+
+    const int iNumHandlers = 3;
+    QList<PluginBlockHandler::SPtr> lHandlers;
+    BlockLog logs[iNumHandlers];
+
+    for(int h = 0; h < iNumHandlers; ++h) {
+        lHandlers.append(scheduler.registerHandler(QString("Ordering%1").arg(h), 8));
+    }
+
+    // Interleave the handlers, each one has to execute its own blocks in order and one at a time
+    for(int i = 0; i < m_iNumBlocks; ++i) {
+        for(int h = 0; h < iNumHandlers; ++h) {
+            BlockLog* pLog = &logs[h];
+            QVERIFY(lHandlers[h]->post([pLog, i]() { pLog->append(i); }));
+        }
+    }
+
+    for(int h = 0; h < iNumHandlers; ++h) {
+        scheduler.unregisterHandler(lHandlers[h]);
+
+        QVERIFY(isSequence(logs[h].blocks(), m_iNumBlocks));
+        QVERIFY(!logs[h].bOverlap);
+        QCOMPARE(lHandlers[h]->getNumDroppedBlocks(), 0);
+    }
+
+    scheduler.stop();
+    QVERIFY(!scheduler.isRunning());
+}
+
+
+//*************************************************************************************************************
+
+void TestPluginScheduler::compareWorkerPostToFullQueue()
+{
+    // A single worker posting to a full queue has to execute the queued blocks itself instead of waiting
+    PluginScheduler scheduler(1);
+    scheduler.start();
+
+    PluginBlockHandler::SPtr pUpstream = scheduler.registerHandler("Upstream", 4);
+    PluginBlockHandler::SPtr pDownstream = scheduler.registerHandler("Downstream", 1);
+    BlockLog log;
+    BlockLog* pLog = &log;
+
+    for(int i = 0; i < m_iNumBlocks / 10; ++i) {
+        pUpstream->post([pDownstream, pLog, i]() {
+            for(int j = 0; j < 10; ++j) {
+                int iBlock = 10 * i + j;
+                pDownstream->post([pLog, iBlock]() { pLog->append(iBlock); });
+            }
+        });
+    }
+
+    scheduler.unregisterHandler(pUpstream);
+    scheduler.unregisterHandler(pDownstream);
+
+    QVERIFY(isSequence(log.blocks(), m_iNumBlocks));
+    QVERIFY(!log.bOverlap);
+
+    scheduler.stop();
+}
+
+
+//*************************************************************************************************************
+
+void TestPluginScheduler::compareBackpressure()
+{
+    PluginScheduler scheduler(2);
+    scheduler.start();
+
+    const int iCapacity = 4;
+    const int iNumPosts = 10;
+    PluginBlockHandler::SPtr pHandler = scheduler.registerHandler("Backpressure", iCapacity, PluginBlockHandler::WaitForSpace);
+
+    QSemaphore gate(0);
+    QSemaphore* pGate = &gate;
+    BlockLog log;
+    BlockLog* pLog = &log;
+    QAtomicInt iPosted(0);
+
+    ProducerThread producer([&]() {
+        for(int i = 0; i < iNumPosts; ++i) {
+            pHandler->post([pGate, pLog, i]() {
+                pGate->acquire();
+                pLog->append(i);
+            });
+            iPosted.ref();
+        }
+    });
+    producer.start();
+
+    // The first block blocks its worker, the queue fills up and the producer has to wait
+    QThread::msleep(200);
+    QCOMPARE(iPosted.load(), iCapacity + 1);
+    QCOMPARE(pHandler->getQueueSize(), iCapacity);
+    QVERIFY(!producer.isFinished());
+
+    gate.release(iNumPosts);
+    QVERIFY(producer.wait(5000));
+
+    scheduler.unregisterHandler(pHandler);
+
+    QVERIFY(isSequence(log.blocks(), iNumPosts));
+    QCOMPARE(pHandler->getNumDroppedBlocks(), 0);
+
+    scheduler.stop();
+}
+
+
+//*************************************************************************************************************
+
+void TestPluginScheduler::compareTryPost()
+{
+    PluginScheduler scheduler(2);
+    scheduler.start();
+
+    const int iCapacity = 2;
+    PluginBlockHandler::SPtr pHandler = scheduler.registerHandler("TryPost", iCapacity, PluginBlockHandler::WaitForSpace);
+
+    QSemaphore started(0);
+    QSemaphore gate(0);
+    QSemaphore* pStarted = &started;
+    QSemaphore* pGate = &gate;
+    BlockLog log;
+    BlockLog* pLog = &log;
+
+    QVERIFY(pHandler->tryPost([pStarted, pGate, pLog]() {
+        pStarted->release();
+        pGate->acquire();
+        pLog->append(0);
+    }));
+    started.acquire();
+
+    // A full queue discards the block instead of blocking the caller
+    for(int i = 1; i <= iCapacity; ++i) {
+        QVERIFY(pHandler->tryPost([pLog, i]() { pLog->append(i); }));
+    }
+    QVERIFY(!pHandler->tryPost([pLog]() { pLog->append(-1); }));
+    QCOMPARE(pHandler->getNumDroppedBlocks(), 1);
+    QVERIFY(!pHandler->isClosed());
+
+    gate.release();
+    scheduler.unregisterHandler(pHandler);
+
+    QVERIFY(isSequence(log.blocks(), iCapacity + 1));
+
+    // Closed handlers discard all blocks
+    QVERIFY(pHandler->isClosed());
+    QVERIFY(!pHandler->tryPost([pLog]() { pLog->append(-1); }));
+    QVERIFY(!pHandler->post([pLog]() { pLog->append(-1); }));
+    QCOMPARE(log.blocks().size(), iCapacity + 1);
+
+    scheduler.stop();
+}
+
+
+//*************************************************************************************************************
+
+void TestPluginScheduler::compareDropOldest()
+{
+    PluginScheduler scheduler(2);
+    scheduler.start();
+
+    PluginBlockHandler::SPtr pHandler = scheduler.registerHandler("DropOldest", 2, PluginBlockHandler::DropOldest);
+
+    QSemaphore started(0);
+    QSemaphore gate(0);
+    QSemaphore* pStarted = &started;
+    QSemaphore* pGate = &gate;
+    BlockLog log;
+    BlockLog* pLog = &log;
+
+    pHandler->post([pStarted, pGate, pLog]() {
+        pStarted->release();
+        pGate->acquire();
+        pLog->append(0);
+    });
+    started.acquire();
+
+    // Block 0 is running, of the blocks 1 to 4 only the newest two are kept
+    for(int i = 1; i <= 4; ++i) {
+        QVERIFY(pHandler->post([pLog, i]() { pLog->append(i); }));
+    }
+
+    gate.release();
+    scheduler.unregisterHandler(pHandler);
+
+    QVector<int> vecExpected;
+    vecExpected << 0 << 3 << 4;
+    QVERIFY(log.blocks() == vecExpected);
+    QCOMPARE(pHandler->getNumDroppedBlocks(), 2);
+
+    scheduler.stop();
+}
+
+
+//*************************************************************************************************************
+
+void TestPluginScheduler::compareUnregisterWhilePosting()
+{
+    PluginScheduler scheduler(2);
+    scheduler.start();
+
+    PluginBlockHandler::SPtr pHandler = scheduler.registerHandler("Unregister", 4, PluginBlockHandler::WaitForSpace);
+
+    BlockLog log;
+    BlockLog* pLog = &log;
+    QAtomicInt iAccepted(0);
+
+    ProducerThread producer([&]() {
+        for(int i = 0; ; ++i) {
+            if(!pHandler->post([pLog, i]() {
+                QThread::usleep(100);
+                pLog->append(i);
+            })) {
+                break;
+            }
+            iAccepted.ref();
+        }
+    });
+    producer.start();
+
+    QThread::msleep(100);
+
+    // All accepted blocks are executed before unregisterHandler returns, all later posts are discarded
+    scheduler.unregisterHandler(pHandler);
+    QVERIFY(producer.wait(5000));
+
+    QVERIFY(iAccepted.load() > 0);
+    QVERIFY(isSequence(log.blocks(), iAccepted.load()));
+    QVERIFY(!log.bOverlap);
+    QCOMPARE(pHandler->getQueueSize(), 0);
+
+    scheduler.stop();
+}
+
+
+//*************************************************************************************************************
+
+void TestPluginScheduler::cleanupTestCase()
+{
+}
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// MAIN
+//=============================================================================================================
+
+QTEST_APPLESS_MAIN(TestPluginScheduler)
+#include "test_plugin_scheduler.moc"
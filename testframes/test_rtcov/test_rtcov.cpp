@@ -0,0 +1,227 @@
+//=============================================================================================================
+/**
+* @file     test_rtcov.cpp
+* @author   agent <agent@local>
+* @version  1.0
+* @date     October, 2026
+*
+* @section  LICENSE
+*
+* Copyright (C) 2026, agent. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+*
+* @brief    Test for the streaming covariance accumulator of RtCov
+*
+*/
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include <rtprocessing/rtcov.h>
+
+#include <fiff/fiff_cov.h>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QtTest>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// Eigen INCLUDES
+//=============================================================================================================
+
+#include <Eigen/Core>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// USED NAMESPACES
+//=============================================================================================================
+
+using namespace RTPROCESSINGLIB;
+using namespace FIFFLIB;
+using namespace Eigen;
+
+
+//=============================================================================================================
+/**
+* DECLARE CLASS TestRtCov
+*
+* @brief The TestRtCov class provides tests for the streaming covariance accumulator.
+*
+*/
+class TestRtCov: public QObject
+{
+    Q_OBJECT
+
+public:
+    TestRtCov();
+
+private slots:
+    void initTestCase();
+    void compareBatchCovariance();
+    void compareOffsetData();
+    void compareForgetting();
+    void compareReset();
+    void cleanupTestCase();
+
+private:
+    MatrixXd batchCovariance(const MatrixXd& matData) const;
+
+    double epsilon;
+
+    MatrixXd m_matData;
+};
+
+
+//*************************************************************************************************************
+
+TestRtCov::TestRtCov()
+: epsilon(0.000001)
+{
+}
+
+
+//*************************************************************************************************************
+
+void TestRtCov::initTestCase()
+{
+    qDebug() << "Epsilon" << epsilon;
+
+    std::srand(42);
+    m_matData = MatrixXd::Random(20, 3000);
+}
+
+
+//*************************************************************************************************************
+
+void TestRtCov::compareBatchCovariance()
+{
+    RtCovAccumulator accumulator;
+
+    // Uneven block sizes on purpose
+    qint32 iStart = 0;
+    qint32 iBlockSize = 1;
+    while(iStart < m_matData.cols()) {
+        qint32 iCols = std::min(iBlockSize, static_cast<qint32>(m_matData.cols()) - iStart);
+        accumulator.append(m_matData.middleCols(iStart, iCols));
+        iStart += iCols;
+        iBlockSize = (iBlockSize * 3) % 257 + 1;
+    }
+
+    QVERIFY(accumulator.getNumSamples() == m_matData.cols());
+
+    MatrixXd matDiff = accumulator.getCovariance() - batchCovariance(m_matData);
+    QVERIFY(matDiff.cwiseAbs().maxCoeff() < epsilon);
+
+    FiffCov cov = accumulator.getFiffCov(FiffInfo());
+    QVERIFY(cov.dim == m_matData.rows());
+    QVERIFY(cov.nfree == m_matData.cols());
+}
+
+
+//*************************************************************************************************************
+
+void TestRtCov::compareOffsetData()
+{
+    // A large DC offset must not destroy the estimate (sum of squares formulation would)
+    MatrixXd matOffsetData = m_matData.array() + 1e7;
+
+    RtCovAccumulator accumulator;
+    for(qint32 i = 0; i < matOffsetData.cols(); i += 100) {
+        accumulator.append(matOffsetData.middleCols(i, 100));
+    }
+
+    MatrixXd matDiff = accumulator.getCovariance() - batchCovariance(m_matData);
+    QVERIFY(matDiff.cwiseAbs().maxCoeff() < epsilon);
+}
+
+
+//*************************************************************************************************************
+
+void TestRtCov::compareForgetting()
+{
+    // With a forgetting factor, the estimate must follow a change in the noise level
+    RtCovAccumulator accumulator(0.99);
+
+    for(qint32 i = 0; i < m_matData.cols(); i += 100) {
+        accumulator.append(m_matData.middleCols(i, 100));
+    }
+    for(qint32 i = 0; i < m_matData.cols(); i += 100) {
+        accumulator.append(10.0 * m_matData.middleCols(i, 100));
+    }
+
+    QVERIFY(accumulator.getEffectiveSamples() < 1.0 / (1.0 - 0.99) + 100.0);
+
+    MatrixXd matRef = batchCovariance(10.0 * m_matData);
+    QVERIFY((accumulator.getCovariance().diagonal() - matRef.diagonal()).cwiseAbs().maxCoeff() < 0.25 * matRef.diagonal().maxCoeff());
+}
+
+
+//*************************************************************************************************************
+
+void TestRtCov::compareReset()
+{
+    RtCovAccumulator accumulator;
+    accumulator.append(m_matData.leftCols(100));
+    accumulator.reset();
+
+    QVERIFY(accumulator.getNumSamples() == 0);
+    QVERIFY(accumulator.getCovariance().size() == 0);
+
+    accumulator.append(m_matData);
+
+    MatrixXd matDiff = accumulator.getCovariance() - batchCovariance(m_matData);
+    QVERIFY(matDiff.cwiseAbs().maxCoeff() < epsilon);
+}
+
+
+//*************************************************************************************************************
+
+void TestRtCov::cleanupTestCase()
+{
+}
+
+
+//*************************************************************************************************************
+
+MatrixXd TestRtCov::batchCovariance(const MatrixXd& matData) const
+{
+    MatrixXd matCentered = matData.colwise() - matData.rowwise().mean();
+    return matCentered * matCentered.transpose() / (matData.cols() - 1);
+}
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// MAIN
+//=============================================================================================================
+
+QTEST_APPLESS_MAIN(TestRtCov)
+#include "test_rtcov.moc"
@@ -0,0 +1,346 @@
+//=============================================================================================================
+/**
+* @file     test_rtinvop.cpp
+* @author   agent <agent@local>
+* @version  1.0
+* @date     October, 2026
+*
+* @section  LICENSE
+*
+* Copyright (C) 2026, agent. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+*
+* @brief    Test for the incremental noise covariance update of RtInvOp.
+*
+*/
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include <rtprocessing/rtinvop.h>
+
+#include <fiff/fiff_cov.h>
+#include <fiff/fiff_evoked.h>
+#include <fiff/fiff_info.h>
+
+#include <mne/mne_forwardsolution.h>
+#include <mne/mne_inverse_operator.h>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QtTest>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// Eigen INCLUDES
+//=============================================================================================================
+
+#include <Eigen/Core>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// USED NAMESPACES
+//=============================================================================================================
+
+using namespace RTPROCESSINGLIB;
+using namespace FIFFLIB;
+using namespace MNELIB;
+using namespace Eigen;
+
+
+//=============================================================================================================
+/**
+* Exposes the update path of the worker.
+*/
+class RtInvOpWorkerTest : public RtInvOpWorker
+{
+public:
+    using RtInvOpWorker::updateInverseOperator;
+};
+
+
+//=============================================================================================================
+/**
+* DECLARE CLASS TestRtInvOp
+*
+* @brief The TestRtInvOp class compares inverse operators updated for a new noise covariance with freshly computed
+* ones.
+*
+*/
+class TestRtInvOp: public QObject
+{
+    Q_OBJECT
+
+public:
+    TestRtInvOp();
+
+private slots:
+    void initTestCase();
+    void compareFullRank();
+    void compareTruncated();
+    void compareChannelSelectionChange();
+    void compareChannelMarkedGood();
+    void cleanupTestCase();
+
+private:
+    MatrixXd whitenedGain(const MNEInverseOperator& invOp, qint32 iRank) const;
+    FiffInfo::SPtr infoWithBadChannel(QString& sBadChName) const;
+
+    double epsilon;
+
+    FiffInfo::SPtr              m_pFiffInfo;
+    MNEForwardSolution::SPtr    m_pFwd;
+    FiffCov                     m_noiseCov;
+    FiffCov                     m_noiseCovUpdated;
+};
+
+
+//*************************************************************************************************************
+
+TestRtInvOp::TestRtInvOp()
+: epsilon(0.000001)
+{
+}
+
+
+//*************************************************************************************************************
+
+void TestRtInvOp::initTestCase()
+{
+    qDebug() << "Epsilon" << epsilon;
+
+    QFile t_fileEvoked(QDir::currentPath()+"/mne-cpp-test-data/MEG/sample/sample_audvis-ave.fif");
+    QFile t_fileCov(QDir::currentPath()+"/mne-cpp-test-data/MEG/sample/sample_audvis-cov.fif");
+    QFile t_fileFwd(QDir::currentPath()+"/mne-cpp-test-data/Result/ref-sample_audvis-meg-eeg-oct-6-fwd.fif");
+    QVERIFY(t_fileEvoked.exists());
+    QVERIFY(t_fileCov.exists());
+    QVERIFY(t_fileFwd.exists());
+
+    FiffEvoked evoked(t_fileEvoked, 0);
+    m_pFiffInfo = FiffInfo::SPtr(new FiffInfo(evoked.info));
+    m_pFwd = MNEForwardSolution::SPtr(new MNEForwardSolution(t_fileFwd, false, true));
+    m_noiseCov = FiffCov(t_fileCov);
+    QVERIFY(!m_pFwd->isEmpty());
+    QVERIFY(!m_noiseCov.isEmpty());
+
+    // A different noise covariance with the same channels, e.g., a later estimate of RtCov
+    m_noiseCovUpdated = m_noiseCov;
+    m_noiseCovUpdated.data += 0.5 * MatrixXd(m_noiseCov.data.diagonal().asDiagonal());
+    m_noiseCovUpdated.data *= 1.7;
+}
+
+
+//*************************************************************************************************************
+
+void TestRtInvOp::compareFullRank()
+{
+    RtInvOpWorkerTest worker;
+
+    MNEInverseOperator invOpFirst;
+    connect(&worker, &RtInvOpWorker::resultReady, [&invOpFirst](const MNEInverseOperator& invOp) {
+        invOpFirst = invOp;
+    });
+
+    RtInvOpInput inputData;
+    inputData.pFiffInfo = m_pFiffInfo;
+    inputData.pFwd = m_pFwd;
+    inputData.noiseCov = m_noiseCov;
+    inputData.iRank = -1;
+
+    // The first noise covariance takes the full path and caches the noise independent factors
+    worker.doWork(inputData);
+    QVERIFY(invOpFirst.sing.size() > 0);
+
+    inputData.noiseCov = m_noiseCovUpdated;
+    MNEInverseOperator invOpUpdated;
+    QVERIFY(worker.updateInverseOperator(inputData, invOpUpdated));
+
+    MNEForwardSolution forwardMeg = m_pFwd->pick_types(true, false);
+    MNEInverseOperator invOpFresh(*m_pFiffInfo, forwardMeg, m_noiseCovUpdated, 0.2f, 0.8f);
+
+    QVERIFY(invOpUpdated.eigen_fields->col_names == invOpFresh.eigen_fields->col_names);
+
+    // The source covariance scaling depends on the noise covariance
+    double dSourceCovError = (invOpUpdated.source_cov->data - invOpFresh.source_cov->data).norm() / invOpFresh.source_cov->data.norm();
+    QVERIFY(dSourceCovError < epsilon);
+
+    // The decomposition is unique up to the signs of the components, compare the singular values and U*S*V'
+    qint32 iRank = invOpUpdated.sing.size();
+    QVERIFY(iRank <= invOpFresh.sing.size());
+    QVERIFY((invOpUpdated.sing - invOpFresh.sing.head(iRank)).norm() / invOpFresh.sing.norm() < epsilon);
+    QVERIFY(invOpFresh.sing.tail(invOpFresh.sing.size() - iRank).norm() / invOpFresh.sing.norm() < epsilon);
+
+    MatrixXd matFresh = whitenedGain(invOpFresh, iRank);
+    MatrixXd matUpdated = whitenedGain(invOpUpdated, iRank);
+    QVERIFY((matUpdated - matFresh).norm() / matFresh.norm() < epsilon);
+
+    // The noise covariance is updated as well, so the kernels agree
+    QVERIFY(invOpUpdated.noise_cov->data.isApprox(invOpFresh.noise_cov->data));
+}
+
+
+//*************************************************************************************************************
+
+void TestRtInvOp::compareTruncated()
+{
+    RtInvOpWorkerTest worker;
+
+    RtInvOpInput inputData;
+    inputData.pFiffInfo = m_pFiffInfo;
+    inputData.pFwd = m_pFwd;
+    inputData.noiseCov = m_noiseCov;
+    inputData.iRank = 40;
+
+    worker.doWork(inputData);
+
+    inputData.noiseCov = m_noiseCovUpdated;
+    MNEInverseOperator invOpUpdated;
+    QVERIFY(worker.updateInverseOperator(inputData, invOpUpdated));
+    QCOMPARE(static_cast<int>(invOpUpdated.sing.size()), 40);
+
+    // The truncated operator equals the leading components of the full decomposition
+    MNEForwardSolution forwardMeg = m_pFwd->pick_types(true, false);
+    MNEInverseOperator invOpFresh(*m_pFiffInfo, forwardMeg, m_noiseCovUpdated, 0.2f, 0.8f);
+
+    QVERIFY((invOpUpdated.sing - invOpFresh.sing.head(40)).norm() / invOpFresh.sing.head(40).norm() < epsilon);
+
+    MatrixXd matFresh = whitenedGain(invOpFresh, 40);
+    MatrixXd matUpdated = whitenedGain(invOpUpdated, 40);
+    QVERIFY((matUpdated - matFresh).norm() / matFresh.norm() < epsilon);
+}
+
+
+//*************************************************************************************************************
+
+void TestRtInvOp::compareChannelSelectionChange()
+{
+    RtInvOpWorkerTest worker;
+
+    RtInvOpInput inputData;
+    inputData.pFiffInfo = m_pFiffInfo;
+    inputData.pFwd = m_pFwd;
+    inputData.noiseCov = m_noiseCov;
+    inputData.iRank = -1;
+
+    worker.doWork(inputData);
+
+    // A new bad channel requires the full computation
+    QString sBadChName;
+    inputData.pFiffInfo = infoWithBadChannel(sBadChName);
+    inputData.noiseCov = m_noiseCovUpdated;
+    MNEInverseOperator invOpUpdated;
+    QVERIFY(!worker.updateInverseOperator(inputData, invOpUpdated));
+}
+
+
+//*************************************************************************************************************
+
+void TestRtInvOp::compareChannelMarkedGood()
+{
+    RtInvOpWorkerTest worker;
+
+    MNEInverseOperator invOpResult;
+    connect(&worker, &RtInvOpWorker::resultReady, [&invOpResult](const MNEInverseOperator& invOp) {
+        invOpResult = invOp;
+    });
+
+    RtInvOpInput inputData;
+    QString sBadChName;
+    inputData.pFiffInfo = infoWithBadChannel(sBadChName);
+    inputData.pFwd = m_pFwd;
+    inputData.noiseCov = m_noiseCov;
+    inputData.iRank = -1;
+
+    worker.doWork(inputData);
+    QVERIFY(!invOpResult.eigen_fields->col_names.contains(sBadChName));
+
+    // The channel is good again, the cached factors do not cover it
+    inputData.pFiffInfo = m_pFiffInfo;
+    inputData.noiseCov = m_noiseCovUpdated;
+    MNEInverseOperator invOpUpdated;
+    QVERIFY(!worker.updateInverseOperator(inputData, invOpUpdated));
+
+    // The full computation brings the channel back into the operator
+    worker.doWork(inputData);
+    QVERIFY(invOpResult.eigen_fields->col_names.contains(sBadChName));
+
+    MNEForwardSolution forwardMeg = m_pFwd->pick_types(true, false);
+    MNEInverseOperator invOpFresh(*m_pFiffInfo, forwardMeg, m_noiseCovUpdated, 0.2f, 0.8f);
+    QVERIFY(invOpResult.eigen_fields->col_names == invOpFresh.eigen_fields->col_names);
+
+    // From now on the update path covers the channel as well
+    QVERIFY(worker.updateInverseOperator(inputData, invOpUpdated));
+    QVERIFY(invOpUpdated.eigen_fields->col_names.contains(sBadChName));
+}
+
+
+//*************************************************************************************************************
+
+void TestRtInvOp::cleanupTestCase()
+{
+}
+
+
+//*************************************************************************************************************
+
+MatrixXd TestRtInvOp::whitenedGain(const MNEInverseOperator& invOp, qint32 iRank) const
+{
+    // eigen_fields holds U', eigen_leads holds V
+    return invOp.eigen_fields->data.topRows(iRank).transpose()
+           * invOp.sing.head(iRank).asDiagonal()
+           * invOp.eigen_leads->data.leftCols(iRank).transpose();
+}
+
+
+//*************************************************************************************************************
+
+FiffInfo::SPtr TestRtInvOp::infoWithBadChannel(QString& sBadChName) const
+{
+    // Marks the first good MEG channel as bad
+    FiffInfo::SPtr pFiffInfoBad(new FiffInfo(*m_pFiffInfo));
+    for(int i = 0; i < pFiffInfoBad->chs.size(); ++i) {
+        if(pFiffInfoBad->chs[i].kind == FIFFV_MEG_CH && !pFiffInfoBad->bads.contains(pFiffInfoBad->ch_names[i])) {
+            sBadChName = pFiffInfoBad->ch_names[i];
+            pFiffInfoBad->bads << sBadChName;
+            break;
+        }
+    }
+
+    return pFiffInfoBad;
+}
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// MAIN
+//=============================================================================================================
+
+QTEST_APPLESS_MAIN(TestRtInvOp)
+#include "test_rtinvop.moc"
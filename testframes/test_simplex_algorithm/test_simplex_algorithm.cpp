@@ -0,0 +1,287 @@
+//=============================================================================================================
+/**
+* @file     test_simplex_algorithm.cpp
+* @author   agent <agent@local>
+* @version  1.0
+* @date     October, 2026
+*
+* @section  LICENSE
+*
+* Copyright (C) 2026, agent. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+*
+* @brief    The fixed-size and batched simplex minimization unit test
+*
+*/
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include <utils/simplex_algorithm.h>
+#include <utils/sphere.h>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QtTest>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// USED NAMESPACES
+//=============================================================================================================
+
+using namespace UTILSLIB;
+using namespace Eigen;
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE GLOBAL METHODS
+//=============================================================================================================
+
+namespace {
+
+//=============================================================================================================
+/**
+* Anisotropic quadratic bowl with its minimum at a given point.
+*/
+struct BowlCost {
+    Vector3d vecMin;    /**< The location of the minimum. */
+
+    double operator()(const Vector3d& x) const
+    {
+        Vector3d d = x - vecMin;
+        return 1.0 + d(0)*d(0) + 4.0*d(1)*d(1) + 9.0*d(2)*d(2);
+    }
+};
+
+//=============================================================================================================
+/**
+* The bowl cost as function pointer for the dynamic simplex.
+*/
+double bowlEval(const VectorXd& x, const void* user_data)
+{
+    const BowlCost* pCost = static_cast<const BowlCost*>(user_data);
+    return (*pCost)(Vector3d(x));
+}
+
+}
+
+
+//=============================================================================================================
+/**
+* DECLARE CLASS TestSimplexAlgorithm
+*
+* @brief The TestSimplexAlgorithm class verifies the fixed-size and the batched simplex minimization against the
+* dynamic one
+*
+*/
+class TestSimplexAlgorithm: public QObject
+{
+    Q_OBJECT
+
+public:
+    TestSimplexAlgorithm();
+
+private slots:
+    void initTestCase();
+    void compareFixedDynamic();
+    void compareBatchSerial();
+    void compareSphereFits();
+    void cleanupTestCase();
+
+private:
+    Matrix<double,4,3> initialSimplex(const Vector3d& vecStart) const;
+
+    QList<MatrixX3f>    m_lPoints;      /**< Noisy points on partial spheres. */
+    QList<Vector3f>     m_lCenters;     /**< The true sphere centers. */
+    QList<float>        m_lRadii;       /**< The true sphere radii. */
+};
+
+
+//*************************************************************************************************************
+
+TestSimplexAlgorithm::TestSimplexAlgorithm()
+{
+}
+
+
+//*************************************************************************************************************
+
+void TestSimplexAlgorithm::initTestCase()
+{
+    std::srand(42);
+
+    //Upper half spheres like digitized head shapes with 1 mm noise
+    for(int s = 0; s < 16; ++s) {
+        Vector3f vecCenter(0.002f * s, -0.01f, 0.04f);
+        float fRadius = 0.085f + 0.001f * s;
+        MatrixX3f matPoints(300, 3);
+
+        for(int i = 0; i < matPoints.rows(); ++i) {
+            Vector3f vecDir = Vector3f::Random();
+            vecDir(2) = std::fabs(vecDir(2));
+            vecDir.normalize();
+
+            matPoints.row(i) = (vecCenter + (fRadius + 0.001f * Vector3f::Random()(0)) * vecDir).transpose();
+        }
+
+        m_lPoints.append(matPoints);
+        m_lCenters.append(vecCenter);
+        m_lRadii.append(fRadius);
+    }
+}
+
+
+//*************************************************************************************************************
+
+void TestSimplexAlgorithm::compareFixedDynamic()
+{
+    BowlCost cost;
+    cost.vecMin = Vector3d(0.3, -0.2, 0.1);
+
+    Matrix<double,4,3> matSimplexFixed = initialSimplex(Vector3d::Zero());
+    Vector4d vecValsFixed;
+    MatrixXd matSimplexDyn = matSimplexFixed;
+    VectorXd vecValsDyn(4);
+
+    for(int k = 0; k < 4; ++k) {
+        vecValsFixed(k) = cost(matSimplexFixed.row(k).transpose());
+        vecValsDyn(k) = vecValsFixed(k);
+    }
+
+    int iNevalFixed = 0;
+    int iNevalDyn = 0;
+
+    bool bResultFixed = SimplexAlgorithm::simplex_minimize<double,3>(matSimplexFixed, vecValsFixed, 1e-10, cost, 2000, iNevalFixed);
+    bool bResultDyn = SimplexAlgorithm::simplex_minimize<double>(matSimplexDyn, vecValsDyn, 1e-10, bowlEval, &cost, 2000, iNevalDyn, -1, NULL);
+
+    QVERIFY(bResultFixed);
+    QVERIFY(bResultDyn);
+
+    //Both run the same iterations, the fixed-size version returns the best vertex in the first row
+    VectorXd::Index iBest;
+    vecValsDyn.minCoeff(&iBest);
+
+    QCOMPARE(iNevalFixed, iNevalDyn);
+    QVERIFY((matSimplexFixed.row(0) - matSimplexDyn.row(iBest)).norm() < 1e-9);
+    QVERIFY((matSimplexFixed.row(0).transpose() - cost.vecMin).norm() < 1e-4);
+    QCOMPARE(vecValsFixed(0), vecValsFixed.minCoeff());
+}
+
+
+//*************************************************************************************************************
+
+void TestSimplexAlgorithm::compareBatchSerial()
+{
+    const int iNumFits = 32;
+
+    std::vector<Matrix<double,4,3>, aligned_allocator<Matrix<double,4,3> > > vecSimplices(iNumFits);
+    std::vector<Vector4d, aligned_allocator<Vector4d> > vecVals(iNumFits);
+    std::vector<BowlCost> vecCosts(iNumFits);
+
+    for(int i = 0; i < iNumFits; ++i) {
+        vecCosts[i].vecMin = Vector3d(0.1 * i, -0.05 * i, 0.02 * i);
+        vecSimplices[i] = initialSimplex(Vector3d::Zero());
+
+        for(int k = 0; k < 4; ++k) {
+            vecVals[i](k) = vecCosts[i](vecSimplices[i].row(k).transpose());
+        }
+    }
+
+    std::vector<Matrix<double,4,3>, aligned_allocator<Matrix<double,4,3> > > vecSimplicesSerial = vecSimplices;
+    std::vector<Vector4d, aligned_allocator<Vector4d> > vecValsSerial = vecVals;
+
+    QVector<int> vecNeval;
+    QVector<bool> vecResult = SimplexAlgorithm::simplex_minimize_batch<double,3>(vecSimplices, vecVals, vecCosts, 1e-10, 2000, vecNeval);
+
+    QCOMPARE(vecResult.size(), iNumFits);
+    QCOMPARE(vecNeval.size(), iNumFits);
+
+    //Each fit of the batch must give exactly the serial result
+    for(int i = 0; i < iNumFits; ++i) {
+        int iNeval = 0;
+        bool bResult = SimplexAlgorithm::simplex_minimize<double,3>(vecSimplicesSerial[i], vecValsSerial[i], 1e-10, vecCosts[i], 2000, iNeval);
+
+        QCOMPARE(vecResult.at(i), bResult);
+        QCOMPARE(vecNeval.at(i), iNeval);
+        QVERIFY(vecSimplices[i] == vecSimplicesSerial[i]);
+    }
+}
+
+
+//*************************************************************************************************************
+
+void TestSimplexAlgorithm::compareSphereFits()
+{
+    QList<Sphere> lSpheres = Sphere::fit_spheres_simplex(m_lPoints);
+
+    QCOMPARE(lSpheres.size(), m_lPoints.size());
+
+    for(int i = 0; i < m_lPoints.size(); ++i) {
+        Sphere sphereBatch = lSpheres.at(i);
+        Sphere sphere = Sphere::fit_sphere_simplex(m_lPoints.at(i));
+
+        //Same fit as the single sphere fit and within a millimeter of the true sphere
+        QVERIFY((sphereBatch.center() - sphere.center()).norm() < 1e-6f);
+        QVERIFY(std::fabs(sphereBatch.radius() - sphere.radius()) < 1e-6f);
+        QVERIFY((sphereBatch.center() - m_lCenters.at(i)).norm() < 1e-3f);
+        QVERIFY(std::fabs(sphereBatch.radius() - m_lRadii.at(i)) < 1e-3f);
+    }
+}
+
+
+//*************************************************************************************************************
+
+void TestSimplexAlgorithm::cleanupTestCase()
+{
+}
+
+
+//*************************************************************************************************************
+
+Matrix<double,4,3> TestSimplexAlgorithm::initialSimplex(const Vector3d& vecStart) const
+{
+    Matrix<double,4,3> matSimplex;
+
+    matSimplex.row(0) = vecStart.transpose();
+    for(int k = 1; k < 4; ++k) {
+        matSimplex.row(k) = vecStart.transpose();
+        matSimplex(k, k - 1) += 0.5;
+    }
+
+    return matSimplex;
+}
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// MAIN
+//=============================================================================================================
+
+QTEST_APPLESS_MAIN(TestSimplexAlgorithm)
+#include "test_simplex_algorithm.moc"
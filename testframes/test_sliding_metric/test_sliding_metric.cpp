@@ -0,0 +1,288 @@
+//=============================================================================================================
+/**
+* @file     test_sliding_metric.cpp
+* @author   agent <agent@local>
+* @version  1.0
+* @date     October, 2026
+*
+* @section  LICENSE
+*
+* Copyright (C) 2026, agent. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+*
+* @brief    The test_sliding_metric unit test verifies the incremental Fuzzy Entropy of the EpiDetect plugin.
+*
+*/
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "slidingmetric.h"
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QtTest>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// Eigen INCLUDES
+//=============================================================================================================
+
+#include <Eigen/Dense>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// STL INCLUDES
+//=============================================================================================================
+
+#include <cmath>
+#include <limits>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// USED NAMESPACES
+//=============================================================================================================
+
+using namespace Eigen;
+
+
+//=============================================================================================================
+/**
+* DECLARE CLASS TestSlidingMetric
+*
+* @brief The TestSlidingMetric class compares the incremental Fuzzy Entropy with the block wise computation
+*
+*/
+class TestSlidingMetric: public QObject
+{
+    Q_OBJECT
+
+public:
+    TestSlidingMetric();
+
+private slots:
+    void initTestCase();
+    void compareExact();
+    void compareWithTolerance();
+    void cleanupTestCase();
+
+private:
+    double fuzzyEn(const VectorXd& vecData, double dStdDev) const;
+    double stdDev(const VectorXd& vecData) const;
+
+    double      epsilon;
+    int         m_iWindowSize;
+    int         m_iBlockSize;
+    int         m_iDim;
+    double      m_dR;
+    double      m_dN;
+    double      m_dSigmaTolerance;
+    MatrixXd    m_matData;
+};
+
+
+//*************************************************************************************************************
+
+TestSlidingMetric::TestSlidingMetric()
+: epsilon(0.000001)
+, m_iWindowSize(150)
+, m_iBlockSize(17)
+, m_iDim(2)
+, m_dR(0.2)
+, m_dN(2.0)
+, m_dSigmaTolerance(0.05)
+{
+}
+
+
+//*************************************************************************************************************
+
+void TestSlidingMetric::initTestCase()
+{
+    qsrand(7);
+
+    int iNumSamples = 2000;
+
+    //Row 0: noise with a growing amplitude, row 1: a sine with noise on a drifting offset
+    m_matData = MatrixXd::Random(2, iNumSamples);
+
+    for(int s = 0; s < iNumSamples; ++s) {
+        m_matData(0, s) *= 1.0 + 2.0 * s / iNumSamples;
+        m_matData(1, s) = 0.3 * m_matData(1, s) + sin(2.0 * M_PI * s / 40.0) + 0.002 * s;
+    }
+}
+
+
+//*************************************************************************************************************
+
+void TestSlidingMetric::compareExact()
+{
+    //Without a tolerance the match sums are recomputed after every append
+    SlidingMetric metric(m_matData.rows(), m_iWindowSize, m_iDim, m_dR, m_dN, 0.0);
+
+    int iChecked = 0;
+
+    for(int n = 0; n + m_iBlockSize <= m_matData.cols(); n += m_iBlockSize) {
+        metric.append(m_matData.middleCols(n, m_iBlockSize));
+
+        int iEnd = n + m_iBlockSize;
+
+        if(!metric.isReady()) {
+            continue;
+        }
+
+        VectorXd vecFuzzyEn = metric.getFuzzyEn();
+        VectorXd vecStdDev = metric.getStdDev();
+
+        for(int i = 0; i < m_matData.rows(); ++i) {
+            VectorXd vecWindow = m_matData.row(i).segment(iEnd - m_iWindowSize, m_iWindowSize).transpose();
+            double dStdDev = stdDev(vecWindow);
+
+            QVERIFY(std::fabs(vecStdDev(i) - dStdDev) < epsilon * dStdDev);
+            QVERIFY(std::fabs(vecFuzzyEn(i) - fuzzyEn(vecWindow, dStdDev)) < epsilon);
+        }
+
+        ++iChecked;
+    }
+
+    QVERIFY(iChecked > 50);
+}
+
+
+//*************************************************************************************************************
+
+void TestSlidingMetric::compareWithTolerance()
+{
+    SlidingMetric metric(m_matData.rows(), m_iWindowSize, m_iDim, m_dR, m_dN, m_dSigmaTolerance);
+
+    int iChecked = 0;
+    int iNumSteps = 20;
+
+    for(int n = 0; n + m_iBlockSize <= m_matData.cols(); n += m_iBlockSize) {
+        metric.append(m_matData.middleCols(n, m_iBlockSize));
+
+        int iEnd = n + m_iBlockSize;
+
+        //The block wise reference is expensive, check every third append
+        if(!metric.isReady() || (n / m_iBlockSize) % 3 != 0) {
+            continue;
+        }
+
+        VectorXd vecFuzzyEn = metric.getFuzzyEn();
+
+        for(int i = 0; i < m_matData.rows(); ++i) {
+            VectorXd vecWindow = m_matData.row(i).segment(iEnd - m_iWindowSize, m_iWindowSize).transpose();
+            double dStdDev = stdDev(vecWindow);
+
+            //The frozen standard deviation deviates at most by the tolerance, the value has to be one that the
+            //block wise computation yields for a standard deviation in that range
+            double dMin = std::numeric_limits<double>::max();
+            double dMax = -std::numeric_limits<double>::max();
+
+            for(int j = 0; j <= iNumSteps; ++j) {
+                double dFrozen = dStdDev / (1.0 + m_dSigmaTolerance)
+                                 + j * (dStdDev / (1.0 - m_dSigmaTolerance) - dStdDev / (1.0 + m_dSigmaTolerance)) / iNumSteps;
+                double dValue = fuzzyEn(vecWindow, dFrozen);
+
+                dMin = qMin(dMin, dValue);
+                dMax = qMax(dMax, dValue);
+            }
+
+            QVERIFY(vecFuzzyEn(i) > dMin - 0.001);
+            QVERIFY(vecFuzzyEn(i) < dMax + 0.001);
+        }
+
+        ++iChecked;
+    }
+
+    QVERIFY(iChecked > 15);
+}
+
+
+//*************************************************************************************************************
+
+void TestSlidingMetric::cleanupTestCase()
+{
+}
+
+
+//*************************************************************************************************************
+
+double TestSlidingMetric::fuzzyEn(const VectorXd& vecData, double dStdDev) const
+{
+    int iLength = vecData.size();
+    double dPhi[2];
+
+    for(int k = 0; k < 2; ++k) {
+        int m = m_iDim + k;
+        int iNumTemplates = iLength - m + 1;
+
+        //Baseline corrected templates in units of the standard deviation
+        MatrixXd matTemplates(m, iNumTemplates);
+
+        for(int l = 0; l < m; ++l) {
+            matTemplates.row(l) = vecData.segment(l, iNumTemplates).transpose() / dStdDev;
+        }
+
+        matTemplates.rowwise() -= matTemplates.colwise().mean();
+
+        double dSum = 0.0;
+
+        for(int a = 0; a < iNumTemplates; ++a) {
+            for(int b = 0; b < iNumTemplates; ++b) {
+                if(a != b) {
+                    double dDistance = (matTemplates.col(a) - matTemplates.col(b)).cwiseAbs().maxCoeff();
+                    dSum += std::exp(-std::pow(dDistance, m_dN) / m_dR);
+                }
+            }
+        }
+
+        dPhi[k] = dSum / (double(iLength - m - 1) * double(iLength - m));
+    }
+
+    return std::log(dPhi[0]) - std::log(dPhi[1]);
+}
+
+
+//*************************************************************************************************************
+
+double TestSlidingMetric::stdDev(const VectorXd& vecData) const
+{
+    return std::sqrt((vecData.array() - vecData.mean()).square().sum() / (vecData.size() - 1));
+}
+
+
+//=============================================================================================================
+// MAIN
+//=============================================================================================================
+
+QTEST_APPLESS_MAIN(TestSlidingMetric)
+#include "test_sliding_metric.moc"
@@ -0,0 +1,193 @@
+//=============================================================================================================
+/**
+* @file     test_spectrogram.cpp
+* @author   agent <agent@local>
+* @version  1.0
+* @date     October, 2026
+*
+* @section  LICENSE
+*
+* Copyright (C) 2026, agent. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+*
+* @brief    The spectrogram unit test
+*
+*/
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include <math.h>
+
+#include <utils/spectrogram.h>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QtTest>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// Eigen INCLUDES
+//=============================================================================================================
+
+#include <Eigen/Core>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// USED NAMESPACES
+//=============================================================================================================
+
+using namespace UTILSLIB;
+using namespace Eigen;
+
+
+//=============================================================================================================
+/**
+* DECLARE CLASS TestSpectrogram
+*
+* @brief The TestSpectrogram class verifies the short-time spectrogram against the full-length spectrogram
+*
+*/
+class TestSpectrogram: public QObject
+{
+    Q_OBJECT
+
+public:
+    TestSpectrogram();
+
+private slots:
+    void initTestCase();
+    void compareLayout();
+    void compareSpectrogram();
+    void compareSingleHop();
+    void comparePeakFrequency();
+    void cleanupTestCase();
+
+private:
+    double      m_dEpsilon;
+    double      m_dSFreq;
+    int         m_iWindowSize;
+
+    Eigen::VectorXd     m_vecSignal;
+    Eigen::MatrixXd     m_matReference;
+    Eigen::MatrixXd     m_matShortTime;
+};
+
+
+//*************************************************************************************************************
+
+TestSpectrogram::TestSpectrogram()
+: m_dEpsilon(0.02)
+, m_dSFreq(500.0)
+, m_iWindowSize(40)
+{
+}
+
+
+//*************************************************************************************************************
+
+void TestSpectrogram::initTestCase()
+{
+    //Chirp from 20 Hz to 80 Hz plus a constant 150 Hz line
+    int iSamples = 600;
+    m_vecSignal.resize(iSamples);
+
+    for(int i = 0; i < iSamples; ++i) {
+        double t = i / m_dSFreq;
+        m_vecSignal(i) = sin(2.0 * M_PI * (20.0 + 25.0 * t) * t) + 0.5 * sin(2.0 * M_PI * 150.0 * t);
+    }
+
+    m_matReference = Spectrogram::makeSpectrogram(m_vecSignal, m_iWindowSize);
+    m_matShortTime = Spectrogram::makeShortTimeSpectrogram(m_vecSignal, m_iWindowSize);
+}
+
+
+//*************************************************************************************************************
+
+void TestSpectrogram::compareLayout()
+{
+    QCOMPARE(m_matShortTime.rows(), m_matReference.rows());
+    QCOMPARE(m_matShortTime.cols(), m_matReference.cols());
+}
+
+
+//*************************************************************************************************************
+
+void TestSpectrogram::compareSpectrogram()
+{
+    double dError = (m_matShortTime - m_matReference).norm() / m_matReference.norm();
+
+    QVERIFY(dError < m_dEpsilon);
+}
+
+
+//*************************************************************************************************************
+
+void TestSpectrogram::compareSingleHop()
+{
+    //Without hopping only the frequency interpolation differs from the full-length transform
+    MatrixXd matSingleHop = Spectrogram::makeShortTimeSpectrogram(m_vecSignal, m_iWindowSize, 1);
+    double dError = (matSingleHop - m_matReference).norm() / m_matReference.norm();
+
+    QVERIFY(dError < m_dEpsilon);
+}
+
+
+//*************************************************************************************************************
+
+void TestSpectrogram::comparePeakFrequency()
+{
+    //The 150 Hz line dominates the upper half of the spectrum in every column
+    int iRows = m_matShortTime.rows();
+    int iLowerRow = iRows / 2;
+    double dHzPerRow = m_dSFreq / 2.0 / iRows;
+
+    for(int c = m_iWindowSize; c < m_matShortTime.cols() - m_iWindowSize; c += m_iWindowSize) {
+        int iPeak;
+        m_matShortTime.col(c).segment(iLowerRow, iRows - iLowerRow).maxCoeff(&iPeak);
+
+        QVERIFY(qAbs((iLowerRow + iPeak) * dHzPerRow - 150.0) < 2.0 * dHzPerRow);
+    }
+}
+
+
+//*************************************************************************************************************
+
+void TestSpectrogram::cleanupTestCase()
+{
+}
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// MAIN
+//=============================================================================================================
+
+QTEST_APPLESS_MAIN(TestSpectrogram)
+#include "test_spectrogram.moc"
@@ -40,12 +40,30 @@ TEMPLATE = subdirs
 SUBDIRS += \
     test_codecov \
     test_dipole_fit \
+    test_hpi_lockin \
     test_fiff_rwr \
+    test_fiff_raw_writer \
     test_fiff_mne_types_io \
     test_mne_forward_solution \
     test_fiff_cov \
     test_fiff_digitizer \
+    test_fiff_channel_index \
+    test_fs_surface_cache \
+    test_mne_chunked_stc \
+    test_mne_source_morph \
     test_mne_msh_display_surface_set \
+    test_rtcov \
+    test_rtinvop \
+    test_minimum_norm_roi \
+    test_simplex_algorithm \
+    test_spectrogram \
+    test_detect_trigger \
+    test_sliding_metric \
+
+# The scheduler test links the mne_scan libraries
+!contains(MNECPP_CONFIG, noApplications) {
+    SUBDIRS += test_plugin_scheduler
+}
 
 !contains(MNECPP_CONFIG, minimalVersion) {
     qtHaveModule(charts) {